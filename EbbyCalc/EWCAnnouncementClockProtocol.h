@@ -0,0 +1,55 @@
+//
+//  EWCAnnouncementClockProtocol.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCAnnouncementClockProtocol` is the source of time and delayed work for `EWCAnnouncementScheduler`.  The app uses the main queue, and tests supply a simulated clock, so that bursts of input can be played out without waiting.
+ */
+@protocol EWCAnnouncementClockProtocol <NSObject>
+
+/**
+  The current time in seconds.  Only differences between times are used.
+ */
+@property (nonatomic, readonly) NSTimeInterval now;
+
+/**
+  Schedules a block to run after a delay.
+
+  @param block The block to run.
+  @param delay The delay in seconds.
+
+  @return A token that can be passed to `cancelScheduledBlock:`.
+ */
+- (id)scheduleBlock:(dispatch_block_t)block afterDelay:(NSTimeInterval)delay;
+
+/**
+  Cancels a scheduled block, if it hasn't run yet.
+
+  @param token The token returned when the block was scheduled.
+ */
+- (void)cancelScheduledBlock:(id)token;
+
+@end
+
+NS_ASSUME_NONNULL_END
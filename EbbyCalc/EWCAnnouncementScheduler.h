@@ -0,0 +1,146 @@
+//
+//  EWCAnnouncementScheduler.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import "EWCAnnouncementClockProtocol.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCAnnouncementChannel` identifies the kind of announcement.  Each channel holds at most one pending announcement.
+ */
+typedef NS_ENUM(NSInteger, EWCAnnouncementChannel) {
+  EWCAnnouncementDisplayChannel = 0,
+  EWCAnnouncementStatusChannel,
+};
+
+/**
+  The number of announcement channels.
+ */
+#define EWCAnnouncementChannelCount 2
+
+/**
+  `EWCAnnouncementPriority` orders pending announcements.  A pending announcement is only replaced by one of the same or higher priority.
+ */
+typedef NS_ENUM(NSInteger, EWCAnnouncementPriority) {
+  EWCAnnouncementNormalPriority = 0,
+  EWCAnnouncementErrorPriority,
+};
+
+/**
+  `EWCAnnouncementPoster` delivers an announcement, typically by posting it to VoiceOver.
+
+  @param message The message, either an `NSString` or an `NSAttributedString`.
+ */
+typedef void (^EWCAnnouncementPoster)(id message);
+
+/**
+  `EWCAnnouncementScheduler` delays VoiceOver announcements briefly (so that they aren't cut off by the system reannouncing the key that was pressed), while keeping only the latest announcement of each channel.
+
+  Each announcement waits until no newer announcement has arrived on its channel for the delay, but no longer than the maximum delay after the first one that it replaced, so a fast typist hears the result of a burst of keys rather than every intermediate display, and continuous input still gets read out.  When several channels are due at once, error announcements go first, then status, then the display.  Only one block is ever scheduled on the clock, no matter how many announcements are made.
+
+  The scheduler must only be used from the thread the clock runs its blocks on.
+ */
+@interface EWCAnnouncementScheduler : NSObject
+
+/**
+  How long an announcement waits for a newer one before it is delivered.  Defaults to 0.75 seconds.
+ */
+@property (nonatomic) NSTimeInterval delay;
+
+/**
+  The longest an announcement can be held back by newer ones.  Defaults to 2 seconds.
+ */
+@property (nonatomic) NSTimeInterval maximumDelay;
+
+/**
+  The number of announcements made.
+ */
+@property (nonatomic, readonly) NSUInteger submittedCount;
+
+/**
+  The number of announcements delivered.
+ */
+@property (nonatomic, readonly) NSUInteger deliveredCount;
+
+/**
+  The number of announcements dropped without being delivered, because a newer (or higher priority) one took their place.
+ */
+@property (nonatomic, readonly) NSUInteger supersededCount;
+
+/**
+  The number of blocks scheduled on the clock.
+ */
+@property (nonatomic, readonly) NSUInteger scheduledCount;
+
+/**
+  Whether any announcement is waiting to be delivered.
+ */
+@property (nonatomic, readonly) BOOL hasPendingAnnouncements;
+
+/**
+  Creates a new scheduler.
+
+  @param clock The clock to time announcements with.
+  @param poster Delivers each announcement when it is due.
+
+  @return The new scheduler.
+ */
++ (instancetype)schedulerWithClock:(id<EWCAnnouncementClockProtocol>)clock
+  poster:(EWCAnnouncementPoster)poster;
+
+/**
+  Initializes a scheduler.
+
+  @param clock The clock to time announcements with.
+  @param poster Delivers each announcement when it is due.
+
+  @return The initialized instance.
+ */
+- (instancetype)initWithClock:(id<EWCAnnouncementClockProtocol>)clock
+  poster:(EWCAnnouncementPoster)poster;
+
+/**
+  Makes an announcement, replacing the one pending on the channel unless that one has a higher priority.
+
+  @param message The message, either an `NSString` or an `NSAttributedString`.
+  @param channel The channel to announce on.
+  @param priority The priority of the message.
+ */
+- (void)announce:(id)message
+  onChannel:(EWCAnnouncementChannel)channel
+  priority:(EWCAnnouncementPriority)priority;
+
+/**
+  Drops the announcement pending on a channel, such as an error announcement once the error has been cleared, so that it no longer holds off newer announcements.
+
+  @param channel The channel.
+ */
+- (void)cancelChannel:(EWCAnnouncementChannel)channel;
+
+/**
+  Drops all pending announcements and cancels the scheduled delivery.
+ */
+- (void)cancelAll;
+
+@end
+
+NS_ASSUME_NONNULL_END
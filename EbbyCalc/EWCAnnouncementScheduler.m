@@ -0,0 +1,202 @@
+//
+//  EWCAnnouncementScheduler.m
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCAnnouncementScheduler.h"
+
+// how early a scheduled delivery may run and still deliver what is due
+static const NSTimeInterval s_dueTolerance = 0.001;
+
+@interface EWCAnnouncementScheduler() {
+  id<EWCAnnouncementClockProtocol> _clock;  // times the announcements
+  EWCAnnouncementPoster _poster;  // delivers the announcements
+  id _messages[EWCAnnouncementChannelCount];  // the pending message of each channel, or nil
+  EWCAnnouncementPriority _priorities[EWCAnnouncementChannelCount];  // the priority of each pending message
+  NSTimeInterval _firstTimes[EWCAnnouncementChannelCount];  // when the first message replaced by each pending one was made
+  NSTimeInterval _dueTimes[EWCAnnouncementChannelCount];  // when each pending message should be delivered
+  id _token;  // the scheduled delivery, or nil
+  NSTimeInterval _scheduledTime;  // when the scheduled delivery will run
+}
+
+@end
+
+@implementation EWCAnnouncementScheduler
+
+///----------------------------------------------
+/// @name Construction and Initialization Methods
+///----------------------------------------------
+
++ (instancetype)schedulerWithClock:(id<EWCAnnouncementClockProtocol>)clock
+  poster:(EWCAnnouncementPoster)poster {
+  return [[EWCAnnouncementScheduler alloc] initWithClock:clock poster:poster];
+}
+
+- (instancetype)initWithClock:(id<EWCAnnouncementClockProtocol>)clock
+  poster:(EWCAnnouncementPoster)poster {
+  self = [super init];
+  if (self) {
+    _clock = clock;
+    _poster = [poster copy];
+    _delay = 0.75;
+    _maximumDelay = 2.0;
+  }
+
+  return self;
+}
+
+- (void)dealloc {
+  if (_token) {
+    [_clock cancelScheduledBlock:_token];
+  }
+}
+
+///------------------------------
+/// @name Custom Property Methods
+///------------------------------
+
+- (BOOL)hasPendingAnnouncements {
+  for (NSInteger c = 0; c < EWCAnnouncementChannelCount; ++c) {
+    if (_messages[c]) {
+      return YES;
+    }
+  }
+
+  return NO;
+}
+
+///---------------------------
+/// @name Announcement Methods
+///---------------------------
+
+- (void)announce:(id)message
+  onChannel:(EWCAnnouncementChannel)channel
+  priority:(EWCAnnouncementPriority)priority {
+
+  ++_submittedCount;
+  NSTimeInterval now = _clock.now;
+
+  if (_messages[channel]) {
+    // a pending error isn't replaced by anything less important
+    ++_supersededCount;
+    if (priority < _priorities[channel]) {
+      return;
+    }
+  } else {
+    _firstTimes[channel] = now;
+  }
+
+  // wait for the input to settle, but not forever
+  _messages[channel] = message;
+  _priorities[channel] = priority;
+  _dueTimes[channel] = MIN(now + _delay, _firstTimes[channel] + _maximumDelay);
+
+  [self scheduleDelivery];
+}
+
+- (void)cancelChannel:(EWCAnnouncementChannel)channel {
+  _messages[channel] = nil;
+
+  // the scheduled delivery is only kept while something is waiting for it
+  if (_token && ! self.hasPendingAnnouncements) {
+    [_clock cancelScheduledBlock:_token];
+    _token = nil;
+  }
+}
+
+- (void)cancelAll {
+  for (NSInteger c = 0; c < EWCAnnouncementChannelCount; ++c) {
+    _messages[c] = nil;
+  }
+
+  if (_token) {
+    [_clock cancelScheduledBlock:_token];
+    _token = nil;
+  }
+}
+
+///---------------------
+/// @name Helper Methods
+///---------------------
+
+/**
+  Makes sure a delivery is scheduled for the earliest pending announcement.
+
+  A delivery that is already scheduled no later than that is left alone (if it runs before anything is due, it just schedules again), so that a burst of announcements doesn't cancel and schedule a block for each one.
+ */
+- (void)scheduleDelivery {
+  BOOL pending = NO;
+  NSTimeInterval earliest = 0;
+  for (NSInteger c = 0; c < EWCAnnouncementChannelCount; ++c) {
+    if (_messages[c] && (! pending || _dueTimes[c] < earliest)) {
+      earliest = _dueTimes[c];
+      pending = YES;
+    }
+  }
+
+  if (! pending) {
+    return;
+  }
+
+  if (_token) {
+    if (_scheduledTime <= earliest) {
+      return;
+    }
+
+    [_clock cancelScheduledBlock:_token];
+  }
+
+  __weak EWCAnnouncementScheduler *weakSelf = self;
+  NSTimeInterval delay = MAX(0, earliest - _clock.now);
+  _token = [_clock scheduleBlock:^{
+    [weakSelf deliverDueAnnouncements];
+  } afterDelay:delay];
+  _scheduledTime = earliest;
+  ++_scheduledCount;
+}
+
+/**
+  Delivers the announcements that are due, errors first, then status, then the display, and schedules delivery of any that remain.
+ */
+- (void)deliverDueAnnouncements {
+  _token = nil;
+  NSTimeInterval now = _clock.now + s_dueTolerance;
+
+  static const EWCAnnouncementChannel order[] = {
+    EWCAnnouncementStatusChannel,
+    EWCAnnouncementDisplayChannel,
+  };
+
+  for (NSInteger priority = EWCAnnouncementErrorPriority; priority >= EWCAnnouncementNormalPriority; --priority) {
+    for (NSUInteger i = 0; i < sizeof(order) / sizeof(order[0]); ++i) {
+      EWCAnnouncementChannel channel = order[i];
+      if (_messages[channel] && _priorities[channel] == priority && _dueTimes[channel] <= now) {
+        // clear the slot first, in case delivering makes a new announcement
+        id message = _messages[channel];
+        _messages[channel] = nil;
+        ++_deliveredCount;
+        _poster(message);
+      }
+    }
+  }
+
+  [self scheduleDelivery];
+}
+
+@end
@@ -0,0 +1,41 @@
+//
+//  EWCAudioEngineKeySoundBackend.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import "EWCKeySoundBackendProtocol.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCAudioEngineKeySoundBackend` plays key sounds through an `AVAudioEngine` source node, which pulls each buffer of output from the render block on the audio thread.
+ */
+@interface EWCAudioEngineKeySoundBackend : NSObject<EWCKeySoundBackendProtocol>
+
+/**
+  Creates a new backend.  Output doesn't start until a render block is supplied.
+
+  @return The new backend.
+ */
++ (instancetype)backend;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,100 @@
+//
+//  EWCAudioEngineKeySoundBackend.m
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <AVFoundation/AVFoundation.h>
+
+#import "EWCAudioEngineKeySoundBackend.h"
+
+@interface EWCAudioEngineKeySoundBackend() {
+  AVAudioEngine *_engine;  // the running audio engine, or nil
+  AVAudioSourceNode *_source;  // pulls frames from the render block
+}
+
+@end
+
+@implementation EWCAudioEngineKeySoundBackend
+
+///----------------------------------------------
+/// @name Construction and Initialization Methods
+///----------------------------------------------
+
++ (instancetype)backend {
+  return [EWCAudioEngineKeySoundBackend new];
+}
+
+- (void)dealloc {
+  [self stop];
+}
+
+///------------------------------
+/// @name Custom Property Methods
+///------------------------------
+
+- (BOOL)isRunning {
+  return _engine.isRunning;
+}
+
+///-----------------------------------------
+/// @name EWCKeySoundBackendProtocol Methods
+///-----------------------------------------
+
+- (BOOL)startWithSampleRate:(double)sampleRate renderBlock:(EWCKeySoundRenderBlock)renderBlock {
+  [self stop];
+
+  // render in the same layout as the voice pool, and let the mixer convert
+  // to whatever the hardware wants
+  AVAudioFormat *format = [[AVAudioFormat alloc]
+    initWithCommonFormat:AVAudioPCMFormatFloat32
+    sampleRate:sampleRate
+    channels:2
+    interleaved:YES];
+
+  _source = [[AVAudioSourceNode alloc] initWithFormat:format
+    renderBlock:^OSStatus(BOOL *isSilence, const AudioTimeStamp *timestamp,
+      AVAudioFrameCount frameCount, AudioBufferList *outputData) {
+
+    float *frames = (float *)outputData->mBuffers[0].mData;
+    *isSilence = ! renderBlock(frames, frameCount);
+    return noErr;
+  }];
+
+  _engine = [AVAudioEngine new];
+  [_engine attachNode:_source];
+  [_engine connect:_source to:_engine.mainMixerNode format:format];
+  [_engine prepare];
+
+  NSError *error = nil;
+  if (! [_engine startAndReturnError:&error]) {
+    [self stop];
+    return NO;
+  }
+
+  return YES;
+}
+
+- (void)stop {
+  // stopping the engine waits for any render in progress
+  [_engine stop];
+  _engine = nil;
+  _source = nil;
+}
+
+@end
@@ -0,0 +1,1071 @@
+//
+//  EWCBigDecimal.c
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "EWCBigDecimal.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// the extra digits a quotient or root is found to before it is corrected and
+// rounded, so that the rounding sees the digit after the last one kept
+#define EWCBigDecimalGuardDigits 2
+
+// the digits the starting estimate of a Newton iteration is correct to
+#define EWCBigDecimalEstimateDigits 14
+
+// the most corrections made to a quotient or root, which is only ever a step
+// or two from the estimate
+#define EWCBigDecimalMaxCorrections 64
+
+static const uint32_t s_powersOf10[EWCBigDecimalLimbDigits + 1] = {
+  1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000,
+};
+
+///-------------------------
+/// @name Limb Array Helpers
+///-------------------------
+
+/**
+  Gets the number of bytes in a run of limbs.
+
+  Limb counts are never negative, but the compiler can't always see that through the arithmetic on them, and a plain `size_t` conversion lets it imagine sizes beyond any object (which gcc warns about for the memory functions).  Converting through `unsigned` bounds the size instead.
+
+  @param count The number of limbs.
+
+  @return The number of bytes.
+ */
+static inline size_t EWCBigDecimalLimbBytes(int count) {
+  return sizeof(uint32_t) * (unsigned)count;
+}
+
+/**
+  Makes room for a number of limbs, keeping the limbs in use.
+
+  @param value The value to grow.
+  @param capacity The number of limbs needed.
+ */
+static void EWCBigDecimalReserve(EWCBigDecimal *value, int capacity) {
+  if (capacity <= value->capacity) {
+    return;
+  }
+
+  int grown = value->capacity * 2;
+  if (grown < capacity) {
+    grown = capacity;
+  }
+  if (grown < 4) {
+    grown = 4;
+  }
+
+  uint32_t *limbs = realloc(value->limbs, EWCBigDecimalLimbBytes(grown));
+  if (! limbs) {
+    abort();
+  }
+
+  value->limbs = limbs;
+  value->capacity = grown;
+}
+
+/**
+  Drops high zero limbs, and moves low zero limbs into the exponent, so that a value has only one representation per power of 10^9.
+
+  @param value The value to normalize.
+ */
+static void EWCBigDecimalNormalize(EWCBigDecimal *value) {
+  while (value->length > 0 && value->limbs[value->length - 1] == 0) {
+    --value->length;
+  }
+
+  int low = 0;
+  while (low < value->length && value->limbs[low] == 0) {
+    ++low;
+  }
+
+  if (low > 0) {
+    memmove(value->limbs, value->limbs + low, EWCBigDecimalLimbBytes(value->length - low));
+    value->length -= low;
+    value->exponent += low * EWCBigDecimalLimbDigits;
+  }
+
+  if (value->length == 0) {
+    value->negative = false;
+    value->exponent = 0;
+  }
+}
+
+/**
+  Replaces a value with another, taking its limbs and leaving the other zero.
+
+  @param result The value to replace.
+  @param value The value to take.
+ */
+static void EWCBigDecimalMove(EWCBigDecimal *result, EWCBigDecimal *value) {
+  if (result == value) {
+    return;
+  }
+
+  free(result->limbs);
+  *result = *value;
+  EWCBigDecimalInit(value);
+}
+
+/**
+  Counts the decimal digits of a limb.
+
+  @param limb The limb.
+
+  @return The number of digits, at least 1.
+ */
+static inline int EWCBigDecimalLimbDigitCount(uint32_t limb) {
+  int count = 1;
+  while (count < EWCBigDecimalLimbDigits && limb >= s_powersOf10[count]) {
+    ++count;
+  }
+
+  return count;
+}
+
+/**
+  Trims the high zero limbs from the length of a limb array.
+
+  @param limbs The limbs.
+  @param length The number of limbs.
+
+  @return The number of limbs without the high zeros.
+ */
+static inline int EWCBigDecimalTrimmedLength(const uint32_t *limbs, int length) {
+  while (length > 0 && limbs[length - 1] == 0) {
+    --length;
+  }
+
+  return length;
+}
+
+/**
+  Compares two limb arrays.
+
+  @param a The first array.
+  @param aLength The length of the first array.
+  @param b The second array.
+  @param bLength The length of the second array.
+
+  @return -1, 0, or 1 as the first is less than, equal to, or greater than the second.
+ */
+static int EWCBigDecimalCompareLimbs(const uint32_t *a, int aLength, const uint32_t *b, int bLength) {
+  aLength = EWCBigDecimalTrimmedLength(a, aLength);
+  bLength = EWCBigDecimalTrimmedLength(b, bLength);
+
+  if (aLength != bLength) {
+    return (aLength < bLength) ? -1 : 1;
+  }
+
+  for (int i = aLength - 1; i >= 0; --i) {
+    if (a[i] != b[i]) {
+      return (a[i] < b[i]) ? -1 : 1;
+    }
+  }
+
+  return 0;
+}
+
+/**
+  Adds one limb array into another.
+
+  @param result The array added to.
+  @param resultLength The length of the array added to.
+  @param value The array to add, no longer than the array added to.
+  @param length The length of the array to add.
+
+  @return The carry out of the array added to.
+ */
+static uint32_t EWCBigDecimalAddLimbs(uint32_t *result, int resultLength, const uint32_t *value, int length) {
+  uint32_t carry = 0;
+  int i = 0;
+  for (; i < length; ++i) {
+    uint32_t sum = result[i] + value[i] + carry;
+    carry = (sum >= EWCBigDecimalLimbBase);
+    result[i] = carry ? sum - EWCBigDecimalLimbBase : sum;
+  }
+
+  for (; carry && i < resultLength; ++i) {
+    uint32_t sum = result[i] + carry;
+    carry = (sum >= EWCBigDecimalLimbBase);
+    result[i] = carry ? sum - EWCBigDecimalLimbBase : sum;
+  }
+
+  return carry;
+}
+
+/**
+  Subtracts one limb array from another, which must be at least as large.
+
+  @param result The array subtracted from.
+  @param resultLength The length of the array subtracted from.
+  @param value The array to subtract.
+  @param length The length of the array to subtract.
+ */
+static void EWCBigDecimalSubtractLimbs(uint32_t *result, int resultLength, const uint32_t *value, int length) {
+  uint32_t borrow = 0;
+  int i = 0;
+  for (; i < length; ++i) {
+    uint32_t subtrahend = value[i] + borrow;
+    borrow = (result[i] < subtrahend);
+    result[i] = borrow ? result[i] + EWCBigDecimalLimbBase - subtrahend : result[i] - subtrahend;
+  }
+
+  for (; borrow && i < resultLength; ++i) {
+    borrow = (result[i] == 0);
+    result[i] = borrow ? EWCBigDecimalLimbBase - 1 : result[i] - 1;
+  }
+}
+
+/**
+  Multiplies two limb arrays the schoolbook way.
+
+  @param a The first array.
+  @param aLength The length of the first array.
+  @param b The second array.
+  @param bLength The length of the second array.
+  @param result Receives the product, `aLength + bLength` limbs.  Must not overlap either array.
+ */
+static void EWCBigDecimalSchoolbookLimbs(const uint32_t *a, int aLength,
+  const uint32_t *b, int bLength,
+  uint32_t *result) {
+
+  memset(result, 0, EWCBigDecimalLimbBytes(aLength + bLength));
+
+  for (int i = 0; i < aLength; ++i) {
+    uint64_t digit = a[i];
+    if (digit == 0) {
+      continue;
+    }
+
+    // each step is below 10^18 + 2 × 10^9, so it can't overflow
+    uint64_t carry = 0;
+    for (int j = 0; j < bLength; ++j) {
+      uint64_t step = result[i + j] + digit * b[j] + carry;
+      result[i + j] = (uint32_t)(step % EWCBigDecimalLimbBase);
+      carry = step / EWCBigDecimalLimbBase;
+    }
+    result[i + bLength] = (uint32_t)carry;
+  }
+}
+
+/**
+  Multiplies two limb arrays, splitting them in half and recombining three half size products (Karatsuba's method) while they are large enough.
+
+  @param a The first array.
+  @param aLength The length of the first array.
+  @param b The second array.
+  @param bLength The length of the second array.
+  @param result Receives the product, `aLength + bLength` limbs.  Must not overlap either array.
+  @param karatsuba Whether to use Karatsuba's method, rather than always using the schoolbook method.
+ */
+static void EWCBigDecimalMultiplyLimbs(const uint32_t *a, int aLength,
+  const uint32_t *b, int bLength,
+  uint32_t *result, bool karatsuba) {
+
+  int resultLength = aLength + bLength;
+
+  // the sums of halves can leave high zero limbs
+  aLength = EWCBigDecimalTrimmedLength(a, aLength);
+  bLength = EWCBigDecimalTrimmedLength(b, bLength);
+  if (aLength < bLength) {
+    const uint32_t *swap = a; a = b; b = swap;
+    int swapLength = aLength; aLength = bLength; bLength = swapLength;
+  }
+
+  if (bLength == 0) {
+    memset(result, 0, EWCBigDecimalLimbBytes(resultLength));
+    return;
+  }
+
+  if (! karatsuba || bLength < EWCBigDecimalKaratsubaThreshold) {
+    EWCBigDecimalSchoolbookLimbs(a, aLength, b, bLength, result);
+    memset(result + aLength + bLength, 0, EWCBigDecimalLimbBytes(resultLength - aLength - bLength));
+    return;
+  }
+
+  memset(result, 0, EWCBigDecimalLimbBytes(resultLength));
+
+  if (bLength <= aLength / 2) {
+    // too lopsided to split evenly, so multiply by each piece of the longer
+    // array that is as long as the shorter one
+    uint32_t *piece = malloc(EWCBigDecimalLimbBytes(2 * bLength));
+    for (int offset = 0; offset < aLength; offset += bLength) {
+      int length = (aLength - offset < bLength) ? aLength - offset : bLength;
+      EWCBigDecimalMultiplyLimbs(a + offset, length, b, bLength, piece, true);
+      EWCBigDecimalAddLimbs(result + offset, resultLength - offset, piece, length + bLength);
+    }
+    free(piece);
+    return;
+  }
+
+  // a = a1 × B^half + a0, b = b1 × B^half + b0, and b1 isn't empty
+  int half = aLength / 2;
+  int aHighLength = aLength - half;
+  int bHighLength = bLength - half;
+
+  // z0 = a0 × b0 and z2 = a1 × b1 go straight into their places
+  EWCBigDecimalMultiplyLimbs(a, half, b, half, result, true);
+  EWCBigDecimalMultiplyLimbs(a + half, aHighLength, b + half, bHighLength, result + 2 * half, true);
+
+  // z1 = (a0 + a1)(b0 + b1) - z0 - z2
+  int aSumLength = aHighLength + 1;
+  int bSumLength = ((bHighLength > half) ? bHighLength : half) + 1;
+  uint32_t *aSum = calloc((size_t)aSumLength, sizeof(uint32_t));
+  uint32_t *bSum = calloc((size_t)bSumLength, sizeof(uint32_t));
+  memcpy(aSum, a + half, EWCBigDecimalLimbBytes(aHighLength));
+  EWCBigDecimalAddLimbs(aSum, aSumLength, a, half);
+  memcpy(bSum, b + half, EWCBigDecimalLimbBytes(bHighLength));
+  EWCBigDecimalAddLimbs(bSum, bSumLength, b, half);
+
+  int middleLength = aSumLength + bSumLength;
+  uint32_t *middle = malloc(EWCBigDecimalLimbBytes(middleLength));
+  EWCBigDecimalMultiplyLimbs(aSum, aSumLength, bSum, bSumLength, middle, true);
+  EWCBigDecimalSubtractLimbs(middle, middleLength, result, 2 * half);
+  EWCBigDecimalSubtractLimbs(middle, middleLength, result + 2 * half, aHighLength + bHighLength);
+
+  middleLength = EWCBigDecimalTrimmedLength(middle, middleLength);
+  EWCBigDecimalAddLimbs(result + half, resultLength - half, middle, middleLength);
+
+  free(aSum);
+  free(bSum);
+  free(middle);
+}
+
+/**
+  Builds the mantissa of a value rescaled to a lower exponent, so that it can be combined limb by limb with another value at that exponent.
+
+  @param value The value.
+  @param exponent The exponent to rescale to, no more than the value's own.
+  @param length Receives the number of limbs.
+
+  @return The limbs, which the caller must free.
+ */
+static uint32_t *EWCBigDecimalAlignedLimbs(const EWCBigDecimal *value, int exponent, int *length) {
+  int shift = value->exponent - exponent;
+  int limbShift = shift / EWCBigDecimalLimbDigits;
+  uint32_t multiplier = s_powersOf10[shift % EWCBigDecimalLimbDigits];
+
+  int count = value->length + limbShift + 1;
+  uint32_t *limbs = calloc((size_t)count, sizeof(uint32_t));
+
+  uint64_t carry = 0;
+  for (int i = 0; i < value->length; ++i) {
+    uint64_t step = (uint64_t)value->limbs[i] * multiplier + carry;
+    limbs[i + limbShift] = (uint32_t)(step % EWCBigDecimalLimbBase);
+    carry = step / EWCBigDecimalLimbBase;
+  }
+  limbs[value->length + limbShift] = (uint32_t)carry;
+
+  *length = count;
+  return limbs;
+}
+
+/**
+  Finds the leading digits of a non-zero value as a double, for the starting estimate of a Newton iteration.
+
+  @param value The value.
+  @param power Receives the power of ten the result is scaled by.
+
+  @return The leading digits, from 1 to 10, so that the value is about the result × 10^power.
+ */
+static double EWCBigDecimalLeadingDouble(const EWCBigDecimal *value, int *power) {
+  double leading = 0;
+  for (int i = value->length - 1; i >= 0 && i >= value->length - 3; --i) {
+    leading = leading * EWCBigDecimalLimbBase + value->limbs[i];
+  }
+
+  // scale the limbs read down to a single whole digit
+  int limbsRead = (value->length < 3) ? value->length : 3;
+  int digitsRead = (limbsRead - 1) * EWCBigDecimalLimbDigits
+    + EWCBigDecimalLimbDigitCount(value->limbs[value->length - 1]);
+  leading /= pow(10, digitsRead - 1);
+
+  *power = EWCBigDecimalMagnitude(value) - 1;
+  return leading;
+}
+
+/**
+  Sets a value to a double times a power of ten, keeping about 17 significant digits.
+
+  @param result Receives the value.
+  @param value The double.
+  @param power The power of ten.
+ */
+static void EWCBigDecimalSetScaledDouble(EWCBigDecimal *result, double value, int power) {
+  char text[64];
+  snprintf(text, sizeof(text), "%.17e", value);
+
+  // fold the power into the exponent of the text
+  char *mark = strchr(text, 'e');
+  int exponent = atoi(mark + 1) + power;
+  snprintf(mark, sizeof(text) - (size_t)(mark - text), "e%d", exponent);
+
+  EWCBigDecimalSetString(result, text);
+}
+
+/**
+  Rounds or truncates a value at a power of ten.
+
+  @param result Receives the value.
+  @param value The value.
+  @param exponent The power of ten of the last digit to keep, which must be more than the value's exponent.
+  @param roundHalfUp Whether to round up when the first digit dropped is 5 or more, rather than truncating.
+ */
+static void EWCBigDecimalQuantize(EWCBigDecimal *result, const EWCBigDecimal *value, int exponent, bool roundHalfUp) {
+  int drop = exponent - value->exponent;
+  int digitCount = EWCBigDecimalDigitCount(value);
+
+  EWCBigDecimal quantized;
+  EWCBigDecimalInit(&quantized);
+  quantized.negative = value->negative;
+  quantized.exponent = exponent;
+
+  if (drop > digitCount) {
+    // every digit is dropped, and the first one dropped is a leading zero
+    EWCBigDecimalMove(result, &quantized);
+    return;
+  }
+
+  int limbShift = drop / EWCBigDecimalLimbDigits;
+  int digitShift = drop % EWCBigDecimalLimbDigits;
+
+  // the first digit dropped decides the rounding
+  uint32_t firstDropped = (digitShift == 0)
+    ? value->limbs[limbShift - 1] / s_powersOf10[EWCBigDecimalLimbDigits - 1]
+    : (value->limbs[limbShift] / s_powersOf10[digitShift - 1]) % 10;
+
+  int length = value->length - limbShift;
+  EWCBigDecimalReserve(&quantized, length + 1);
+  for (int i = 0; i < length; ++i) {
+    uint32_t low = value->limbs[i + limbShift];
+    if (digitShift == 0) {
+      quantized.limbs[i] = low;
+    } else {
+      uint32_t high = (i + limbShift + 1 < value->length) ? value->limbs[i + limbShift + 1] : 0;
+      quantized.limbs[i] = low / s_powersOf10[digitShift]
+        + (high % s_powersOf10[digitShift]) * s_powersOf10[EWCBigDecimalLimbDigits - digitShift];
+    }
+  }
+  quantized.length = length;
+
+  if (roundHalfUp && firstDropped >= 5) {
+    quantized.limbs[length] = 0;
+    quantized.length = length + 1;
+    uint32_t one = 1;
+    EWCBigDecimalAddLimbs(quantized.limbs, quantized.length, &one, 1);
+  }
+
+  EWCBigDecimalNormalize(&quantized);
+  EWCBigDecimalMove(result, &quantized);
+}
+
+///-------------------------
+/// @name Lifetime Functions
+///-------------------------
+
+void EWCBigDecimalInit(EWCBigDecimal *value) {
+  memset(value, 0, sizeof(*value));
+}
+
+void EWCBigDecimalFree(EWCBigDecimal *value) {
+  free(value->limbs);
+  EWCBigDecimalInit(value);
+}
+
+void EWCBigDecimalCopy(EWCBigDecimal *result, const EWCBigDecimal *value) {
+  if (result == value) {
+    return;
+  }
+
+  EWCBigDecimalReserve(result, value->length);
+  memcpy(result->limbs, value->limbs, EWCBigDecimalLimbBytes(value->length));
+  result->length = value->length;
+  result->exponent = value->exponent;
+  result->negative = value->negative;
+}
+
+///---------------------------
+/// @name Conversion Functions
+///---------------------------
+
+void EWCBigDecimalSetInteger(EWCBigDecimal *result, int64_t value) {
+  uint64_t magnitude = (value < 0) ? (uint64_t)0 - (uint64_t)value : (uint64_t)value;
+
+  EWCBigDecimalReserve(result, 3);
+  result->length = 0;
+  while (magnitude > 0) {
+    result->limbs[result->length++] = (uint32_t)(magnitude % EWCBigDecimalLimbBase);
+    magnitude /= EWCBigDecimalLimbBase;
+  }
+  result->exponent = 0;
+  result->negative = (value < 0);
+
+  EWCBigDecimalNormalize(result);
+}
+
+void EWCBigDecimalSetDigits(EWCBigDecimal *result, const uint8_t *digits, int count, int exponent, bool negative) {
+  // leading zeros add nothing
+  while (count > 0 && digits[0] == 0) {
+    ++digits;
+    --count;
+  }
+
+  int length = (count + EWCBigDecimalLimbDigits - 1) / EWCBigDecimalLimbDigits;
+  EWCBigDecimalReserve(result, length);
+
+  // fill the limbs from the least significant digit up
+  for (int i = 0; i < length; ++i) {
+    int end = count - i * EWCBigDecimalLimbDigits;
+    int start = (end > EWCBigDecimalLimbDigits) ? end - EWCBigDecimalLimbDigits : 0;
+    uint32_t limb = 0;
+    for (int d = start; d < end; ++d) {
+      limb = limb * 10 + digits[d];
+    }
+    result->limbs[i] = limb;
+  }
+
+  result->length = length;
+  result->exponent = exponent;
+  result->negative = negative;
+
+  EWCBigDecimalNormalize(result);
+}
+
+bool EWCBigDecimalSetString(EWCBigDecimal *result, const char *text) {
+  const char *p = text;
+  bool negative = false;
+  if (*p == '-' || *p == '+') {
+    negative = (*p == '-');
+    ++p;
+  }
+
+  size_t length = strlen(p);
+  uint8_t *digits = malloc(length + 1);
+  int count = 0;
+  int fractionDigits = 0;
+  bool fraction = false;
+  for (; *p; ++p) {
+    if (*p >= '0' && *p <= '9') {
+      digits[count++] = (uint8_t)(*p - '0');
+      if (fraction) {
+        ++fractionDigits;
+      }
+    } else if (*p == '.' && ! fraction) {
+      fraction = true;
+    } else {
+      break;
+    }
+  }
+
+  long exponent = 0;
+  if (*p == 'e' || *p == 'E') {
+    char *end;
+    exponent = strtol(p + 1, &end, 10);
+    if (end == p + 1) {
+      free(digits);
+      return false;
+    }
+    p = end;
+  }
+
+  if (count == 0 || *p != '\0') {
+    free(digits);
+    return false;
+  }
+
+  EWCBigDecimalSetDigits(result, digits, count, (int)(exponent - fractionDigits), negative);
+  free(digits);
+
+  return true;
+}
+
+size_t EWCBigDecimalToString(const EWCBigDecimal *value, char *buffer, size_t size) {
+  size_t position = 0;
+
+  // write while there is room, but keep counting
+#define EWCBigDecimalEmit(c) do { \
+    if (position + 1 < size) { buffer[position] = (c); } \
+    ++position; \
+  } while (0)
+
+  if (value->length == 0) {
+    EWCBigDecimalEmit('0');
+  } else {
+    int count = EWCBigDecimalDigitCount(value);
+    char *digits = malloc((size_t)count + 1);
+    int written = snprintf(digits, (size_t)count + 1, "%u", value->limbs[value->length - 1]);
+    for (int i = value->length - 2; i >= 0; --i) {
+      written += snprintf(digits + written, (size_t)(count + 1 - written), "%09u", value->limbs[i]);
+    }
+
+    // trailing zeros are moved into the exponent, so none are written after a decimal
+    int exponent = value->exponent;
+    while (count > 1 && digits[count - 1] == '0') {
+      --count;
+      ++exponent;
+    }
+
+    if (value->negative) {
+      EWCBigDecimalEmit('-');
+    }
+
+    if (exponent >= 0) {
+      for (int i = 0; i < count; ++i) {
+        EWCBigDecimalEmit(digits[i]);
+      }
+      for (int i = 0; i < exponent; ++i) {
+        EWCBigDecimalEmit('0');
+      }
+    } else {
+      int whole = count + exponent;
+      if (whole <= 0) {
+        EWCBigDecimalEmit('0');
+        EWCBigDecimalEmit('.');
+        for (int i = whole; i < 0; ++i) {
+          EWCBigDecimalEmit('0');
+        }
+        for (int i = 0; i < count; ++i) {
+          EWCBigDecimalEmit(digits[i]);
+        }
+      } else {
+        for (int i = 0; i < count; ++i) {
+          if (i == whole) {
+            EWCBigDecimalEmit('.');
+          }
+          EWCBigDecimalEmit(digits[i]);
+        }
+      }
+    }
+
+    free(digits);
+  }
+
+#undef EWCBigDecimalEmit
+
+  if (size > 0) {
+    buffer[(position < size) ? position : size - 1] = '\0';
+  }
+
+  return position;
+}
+
+///---------------------------
+/// @name Inspection Functions
+///---------------------------
+
+bool EWCBigDecimalIsZero(const EWCBigDecimal *value) {
+  return value->length == 0;
+}
+
+int EWCBigDecimalDigitCount(const EWCBigDecimal *value) {
+  if (value->length == 0) {
+    return 0;
+  }
+
+  return (value->length - 1) * EWCBigDecimalLimbDigits
+    + EWCBigDecimalLimbDigitCount(value->limbs[value->length - 1]);
+}
+
+int EWCBigDecimalMagnitude(const EWCBigDecimal *value) {
+  return EWCBigDecimalDigitCount(value) + value->exponent;
+}
+
+int EWCBigDecimalCompareMagnitude(const EWCBigDecimal *a, const EWCBigDecimal *b) {
+  if (a->length == 0 || b->length == 0) {
+    return (a->length == 0) ? ((b->length == 0) ? 0 : -1) : 1;
+  }
+
+  int aMagnitude = EWCBigDecimalMagnitude(a);
+  int bMagnitude = EWCBigDecimalMagnitude(b);
+  if (aMagnitude != bMagnitude) {
+    return (aMagnitude < bMagnitude) ? -1 : 1;
+  }
+
+  int exponent = (a->exponent < b->exponent) ? a->exponent : b->exponent;
+  int aLength, bLength;
+  uint32_t *aLimbs = EWCBigDecimalAlignedLimbs(a, exponent, &aLength);
+  uint32_t *bLimbs = EWCBigDecimalAlignedLimbs(b, exponent, &bLength);
+  int comparison = EWCBigDecimalCompareLimbs(aLimbs, aLength, bLimbs, bLength);
+  free(aLimbs);
+  free(bLimbs);
+
+  return comparison;
+}
+
+int EWCBigDecimalCompare(const EWCBigDecimal *a, const EWCBigDecimal *b) {
+  if (a->negative != b->negative) {
+    return a->negative ? -1 : 1;
+  }
+
+  int comparison = EWCBigDecimalCompareMagnitude(a, b);
+  return a->negative ? -comparison : comparison;
+}
+
+///---------------------------
+/// @name Arithmetic Functions
+///---------------------------
+
+void EWCBigDecimalNegate(EWCBigDecimal *result, const EWCBigDecimal *value) {
+  EWCBigDecimalCopy(result, value);
+  result->negative = (result->length > 0) && ! value->negative;
+}
+
+void EWCBigDecimalShift(EWCBigDecimal *result, const EWCBigDecimal *value, int power) {
+  EWCBigDecimalCopy(result, value);
+  if (result->length > 0) {
+    result->exponent += power;
+  }
+}
+
+void EWCBigDecimalAdd(EWCBigDecimal *result, const EWCBigDecimal *a, const EWCBigDecimal *b) {
+  if (b->length == 0) {
+    EWCBigDecimalCopy(result, a);
+    return;
+  }
+  if (a->length == 0) {
+    EWCBigDecimalCopy(result, b);
+    return;
+  }
+
+  int exponent = (a->exponent < b->exponent) ? a->exponent : b->exponent;
+  int aLength, bLength;
+  uint32_t *aLimbs = EWCBigDecimalAlignedLimbs(a, exponent, &aLength);
+  uint32_t *bLimbs = EWCBigDecimalAlignedLimbs(b, exponent, &bLength);
+
+  EWCBigDecimal sum;
+  EWCBigDecimalInit(&sum);
+  sum.exponent = exponent;
+
+  // put the larger magnitude first, so that a difference can't go negative
+  bool swapped = false;
+  if (a->negative != b->negative && EWCBigDecimalCompareLimbs(aLimbs, aLength, bLimbs, bLength) < 0) {
+    uint32_t *limbs = aLimbs; aLimbs = bLimbs; bLimbs = limbs;
+    int length = aLength; aLength = bLength; bLength = length;
+    swapped = true;
+  }
+
+  int length = ((aLength > bLength) ? aLength : bLength) + 1;
+  EWCBigDecimalReserve(&sum, length);
+  memset(sum.limbs, 0, EWCBigDecimalLimbBytes(length));
+  memcpy(sum.limbs, aLimbs, EWCBigDecimalLimbBytes(aLength));
+  sum.length = length;
+
+  if (a->negative == b->negative) {
+    EWCBigDecimalAddLimbs(sum.limbs, length, bLimbs, bLength);
+    sum.negative = a->negative;
+  } else {
+    EWCBigDecimalSubtractLimbs(sum.limbs, length, bLimbs, EWCBigDecimalTrimmedLength(bLimbs, bLength));
+    sum.negative = swapped ? b->negative : a->negative;
+  }
+
+  free(aLimbs);
+  free(bLimbs);
+
+  EWCBigDecimalNormalize(&sum);
+  EWCBigDecimalMove(result, &sum);
+}
+
+void EWCBigDecimalSubtract(EWCBigDecimal *result, const EWCBigDecimal *a, const EWCBigDecimal *b) {
+  // a view of b with the sign flipped, sharing its limbs
+  EWCBigDecimal negated = *b;
+  negated.negative = (b->length > 0) && ! b->negative;
+
+  EWCBigDecimalAdd(result, a, &negated);
+}
+
+/**
+  Multiplies two values exactly.
+
+  @param result Receives the product.
+  @param a The first value.
+  @param b The second value.
+  @param karatsuba Whether to use Karatsuba multiplication for large mantissas.
+ */
+static void EWCBigDecimalMultiplyUsing(EWCBigDecimal *result,
+  const EWCBigDecimal *a, const EWCBigDecimal *b, bool karatsuba) {
+
+  EWCBigDecimal product;
+  EWCBigDecimalInit(&product);
+
+  if (a->length > 0 && b->length > 0) {
+    int length = a->length + b->length;
+    EWCBigDecimalReserve(&product, length);
+    EWCBigDecimalMultiplyLimbs(a->limbs, a->length, b->limbs, b->length, product.limbs, karatsuba);
+    product.length = length;
+    product.exponent = a->exponent + b->exponent;
+    product.negative = (a->negative != b->negative);
+    EWCBigDecimalNormalize(&product);
+  }
+
+  EWCBigDecimalMove(result, &product);
+}
+
+void EWCBigDecimalMultiply(EWCBigDecimal *result, const EWCBigDecimal *a, const EWCBigDecimal *b) {
+  EWCBigDecimalMultiplyUsing(result, a, b, true);
+}
+
+void EWCBigDecimalMultiplySchoolbook(EWCBigDecimal *result, const EWCBigDecimal *a, const EWCBigDecimal *b) {
+  EWCBigDecimalMultiplyUsing(result, a, b, false);
+}
+
+void EWCBigDecimalRound(EWCBigDecimal *result, const EWCBigDecimal *value, int precision) {
+  int drop = EWCBigDecimalDigitCount(value) - precision;
+  if (drop <= 0) {
+    EWCBigDecimalCopy(result, value);
+    return;
+  }
+
+  EWCBigDecimalQuantize(result, value, value->exponent + drop, true);
+}
+
+void EWCBigDecimalRoundToScale(EWCBigDecimal *result, const EWCBigDecimal *value, int scale) {
+  if (value->length == 0 || value->exponent >= -scale) {
+    EWCBigDecimalCopy(result, value);
+    return;
+  }
+
+  EWCBigDecimalQuantize(result, value, -scale, true);
+}
+
+void EWCBigDecimalTruncateToScale(EWCBigDecimal *result, const EWCBigDecimal *value, int scale) {
+  if (value->length == 0 || value->exponent >= -scale) {
+    EWCBigDecimalCopy(result, value);
+    return;
+  }
+
+  EWCBigDecimalQuantize(result, value, -scale, false);
+}
+
+/**
+  Finds the reciprocal of a positive value by Newton's method, x' = x + x(1 - vx), doubling the digits found with each step.
+
+  @param result Receives the reciprocal.
+  @param value The value, which must be positive.
+  @param precision The significant digits to find.
+ */
+static void EWCBigDecimalReciprocal(EWCBigDecimal *result, const EWCBigDecimal *value, int precision) {
+  int power;
+  double leading = EWCBigDecimalLeadingDouble(value, &power);
+
+  EWCBigDecimal x, rounded, step, one;
+  EWCBigDecimalInit(&x);
+  EWCBigDecimalInit(&rounded);
+  EWCBigDecimalInit(&step);
+  EWCBigDecimalInit(&one);
+  EWCBigDecimalSetInteger(&one, 1);
+  EWCBigDecimalSetScaledDouble(&x, 1 / leading, -power);
+
+  int digits = EWCBigDecimalEstimateDigits;
+  bool finished = false;
+  while (! finished) {
+    // one more step at full precision mops up the estimate's own error
+    finished = (digits >= precision);
+    digits = (digits * 2 < precision) ? digits * 2 : precision;
+    int working = digits + EWCBigDecimalGuardDigits;
+
+    EWCBigDecimalRound(&rounded, value, working);
+    EWCBigDecimalMultiply(&step, &rounded, &x);
+    EWCBigDecimalSubtract(&step, &one, &step);
+    EWCBigDecimalMultiply(&step, &step, &x);
+    EWCBigDecimalRound(&step, &step, working);
+    EWCBigDecimalAdd(&x, &x, &step);
+    EWCBigDecimalRound(&x, &x, working);
+  }
+
+  EWCBigDecimalMove(result, &x);
+  EWCBigDecimalFree(&rounded);
+  EWCBigDecimalFree(&step);
+  EWCBigDecimalFree(&one);
+}
+
+/**
+  Finds the reciprocal square root of a positive value by Newton's method, y' = y + y(1 - vy²) / 2, doubling the digits found with each step.
+
+  @param result Receives the reciprocal square root.
+  @param value The value, which must be positive.
+  @param precision The significant digits to find.
+ */
+static void EWCBigDecimalReciprocalSqrt(EWCBigDecimal *result, const EWCBigDecimal *value, int precision) {
+  int power;
+  double leading = EWCBigDecimalLeadingDouble(value, &power);
+
+  // take the root of an even power of ten
+  if (power % 2 != 0) {
+    leading *= 10;
+    power -= 1;
+  }
+
+  EWCBigDecimal y, rounded, step, one, half;
+  EWCBigDecimalInit(&y);
+  EWCBigDecimalInit(&rounded);
+  EWCBigDecimalInit(&step);
+  EWCBigDecimalInit(&one);
+  EWCBigDecimalInit(&half);
+  EWCBigDecimalSetInteger(&one, 1);
+  EWCBigDecimalSetInteger(&half, 5);
+  half.exponent = -1;
+  EWCBigDecimalSetScaledDouble(&y, 1 / sqrt(leading), -power / 2);
+
+  int digits = EWCBigDecimalEstimateDigits;
+  bool finished = false;
+  while (! finished) {
+    finished = (digits >= precision);
+    digits = (digits * 2 < precision) ? digits * 2 : precision;
+    int working = digits + EWCBigDecimalGuardDigits;
+
+    EWCBigDecimalRound(&rounded, value, working);
+    EWCBigDecimalMultiply(&step, &y, &y);
+    EWCBigDecimalRound(&step, &step, working);
+    EWCBigDecimalMultiply(&step, &rounded, &step);
+    EWCBigDecimalSubtract(&step, &one, &step);
+    EWCBigDecimalMultiply(&step, &step, &y);
+    EWCBigDecimalMultiply(&step, &step, &half);
+    EWCBigDecimalRound(&step, &step, working);
+    EWCBigDecimalAdd(&y, &y, &step);
+    EWCBigDecimalRound(&y, &y, working);
+  }
+
+  EWCBigDecimalMove(result, &y);
+  EWCBigDecimalFree(&rounded);
+  EWCBigDecimalFree(&step);
+  EWCBigDecimalFree(&one);
+  EWCBigDecimalFree(&half);
+}
+
+bool EWCBigDecimalDivide(EWCBigDecimal *result, const EWCBigDecimal *a, const EWCBigDecimal *b, int precision) {
+  if (b->length == 0) {
+    return false;
+  }
+
+  if (a->length == 0) {
+    EWCBigDecimalSetInteger(result, 0);
+    return true;
+  }
+
+  bool negative = (a->negative != b->negative);
+  int working = precision + EWCBigDecimalGuardDigits;
+
+  // work with the magnitudes, as views sharing the limbs
+  EWCBigDecimal dividend = *a;
+  EWCBigDecimal divisor = *b;
+  dividend.negative = false;
+  divisor.negative = false;
+
+  EWCBigDecimal quotient, remainder, product, unit, scaled;
+  EWCBigDecimalInit(&quotient);
+  EWCBigDecimalInit(&remainder);
+  EWCBigDecimalInit(&product);
+  EWCBigDecimalInit(&unit);
+  EWCBigDecimalInit(&scaled);
+
+  EWCBigDecimalReciprocal(&quotient, &divisor, working + EWCBigDecimalGuardDigits);
+  EWCBigDecimalMultiply(&quotient, &dividend, &quotient);
+
+  // cut the estimate off at the working digits, then step it to the exact
+  // truncated quotient, where 0 <= dividend - quotient × divisor < unit × divisor
+  int unitExponent = EWCBigDecimalMagnitude(&quotient) - working;
+  EWCBigDecimalTruncateToScale(&quotient, &quotient, -unitExponent);
+  EWCBigDecimalSetInteger(&unit, 1);
+  unit.exponent = unitExponent;
+  EWCBigDecimalShift(&scaled, &divisor, unitExponent);
+
+  EWCBigDecimalMultiply(&product, &quotient, &divisor);
+  EWCBigDecimalSubtract(&remainder, &dividend, &product);
+  for (int i = 0; i < EWCBigDecimalMaxCorrections && remainder.negative; ++i) {
+    EWCBigDecimalSubtract(&quotient, &quotient, &unit);
+    EWCBigDecimalAdd(&remainder, &remainder, &scaled);
+  }
+  for (int i = 0; i < EWCBigDecimalMaxCorrections && EWCBigDecimalCompare(&remainder, &scaled) >= 0; ++i) {
+    EWCBigDecimalAdd(&quotient, &quotient, &unit);
+    EWCBigDecimalSubtract(&remainder, &remainder, &scaled);
+  }
+
+  // with the truncated digits exact, rounding half up on them rounds the true
+  // quotient correctly
+  EWCBigDecimalRound(&quotient, &quotient, precision);
+  quotient.negative = negative && quotient.length > 0;
+  EWCBigDecimalMove(result, &quotient);
+
+  EWCBigDecimalFree(&remainder);
+  EWCBigDecimalFree(&product);
+  EWCBigDecimalFree(&unit);
+  EWCBigDecimalFree(&scaled);
+
+  return true;
+}
+
+bool EWCBigDecimalSqrt(EWCBigDecimal *result, const EWCBigDecimal *value, int precision) {
+  if (value->negative) {
+    return false;
+  }
+
+  if (value->length == 0) {
+    EWCBigDecimalSetInteger(result, 0);
+    return true;
+  }
+
+  int working = precision + EWCBigDecimalGuardDigits;
+
+  EWCBigDecimal root, square, unit, next;
+  EWCBigDecimalInit(&root);
+  EWCBigDecimalInit(&square);
+  EWCBigDecimalInit(&unit);
+  EWCBigDecimalInit(&next);
+
+  EWCBigDecimalReciprocalSqrt(&root, value, working + EWCBigDecimalGuardDigits);
+  EWCBigDecimalMultiply(&root, value, &root);
+
+  // cut the estimate off at the working digits, then step it to the exact
+  // truncated root, where root² <= value < (root + unit)²
+  int unitExponent = EWCBigDecimalMagnitude(&root) - working;
+  EWCBigDecimalTruncateToScale(&root, &root, -unitExponent);
+  EWCBigDecimalSetInteger(&unit, 1);
+  unit.exponent = unitExponent;
+
+  for (int i = 0; i < EWCBigDecimalMaxCorrections; ++i) {
+    EWCBigDecimalMultiply(&square, &root, &root);
+    if (EWCBigDecimalCompare(&square, value) <= 0) {
+      break;
+    }
+    EWCBigDecimalSubtract(&root, &root, &unit);
+  }
+  for (int i = 0; i < EWCBigDecimalMaxCorrections; ++i) {
+    EWCBigDecimalAdd(&next, &root, &unit);
+    EWCBigDecimalMultiply(&square, &next, &next);
+    if (EWCBigDecimalCompare(&square, value) > 0) {
+      break;
+    }
+    EWCBigDecimalMove(&root, &next);
+  }
+
+  EWCBigDecimalRound(&root, &root, precision);
+  EWCBigDecimalMove(result, &root);
+
+  EWCBigDecimalFree(&square);
+  EWCBigDecimalFree(&unit);
+  EWCBigDecimalFree(&next);
+
+  return true;
+}
@@ -0,0 +1,269 @@
+//
+//  EWCBigDecimal.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef EWCBigDecimal_h
+#define EWCBigDecimal_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// the most significant digits an NSDecimal holds.  Calculations that need
+// more digits than this use EWCBigDecimal instead.
+#define EWCBigDecimalNativeDigits 38
+
+// the decimal digits held in each limb
+#define EWCBigDecimalLimbDigits 9
+
+// the value of each limb position
+#define EWCBigDecimalLimbBase 1000000000u
+
+// the limb count at which multiplication switches from schoolbook to Karatsuba
+#define EWCBigDecimalKaratsubaThreshold 32
+
+/**
+  `EWCBigDecimal` is a decimal value of any precision, held as a mantissa of base 10^9 limbs scaled by a power of ten.
+
+  The value represented is (-1)^negative × mantissa × 10^exponent.  Zero has no limbs, and is never negative.  Operations allocate the limbs they need, so a value must be set up with `EWCBigDecimalInit` and released with `EWCBigDecimalFree`.  The result of an operation may be the same value as any of its operands.
+
+  Addition, subtraction, and multiplication are exact.  Division and square roots are rounded to a requested number of significant digits, as is `EWCBigDecimalRound`, with halves rounded away from zero (as `NSRoundPlain` does).
+ */
+typedef struct {
+  uint32_t *limbs;  // the mantissa, least significant limb first, with no high zero limbs
+  int length;  // the number of limbs in use
+  int capacity;  // the number of limbs allocated
+  int exponent;  // the power of ten of the least significant mantissa digit
+  bool negative;  // whether the value is negative
+} EWCBigDecimal;
+
+/**
+  Sets up a value as zero.
+
+  @param value The value to set up.
+ */
+void EWCBigDecimalInit(EWCBigDecimal *value);
+
+/**
+  Releases the limbs of a value, leaving it zero.
+
+  @param value The value to release.
+ */
+void EWCBigDecimalFree(EWCBigDecimal *value);
+
+/**
+  Copies a value.
+
+  @param result Receives the copy.
+  @param value The value to copy.
+ */
+void EWCBigDecimalCopy(EWCBigDecimal *result, const EWCBigDecimal *value);
+
+/**
+  Sets a value from an integer.
+
+  @param result Receives the value.
+  @param value The integer.
+ */
+void EWCBigDecimalSetInteger(EWCBigDecimal *result, int64_t value);
+
+/**
+  Sets a value from its decimal digits.
+
+  @param result Receives the value.
+  @param digits The digits, most significant first, each from 0 to 9.
+  @param count The number of digits.
+  @param exponent The power of ten of the final digit.
+  @param negative Whether the value is negative.
+ */
+void EWCBigDecimalSetDigits(EWCBigDecimal *result, const uint8_t *digits, int count, int exponent, bool negative);
+
+/**
+  Parses a value from plain or scientific notation, such as "-12.5" or "1.25e-3".
+
+  @param result Receives the value.  Left unchanged if the text can't be parsed.
+  @param text The text to parse.
+
+  @return Whether the text was parsed.
+ */
+bool EWCBigDecimalSetString(EWCBigDecimal *result, const char *text);
+
+/**
+  Writes a value in plain notation, with no exponent and no trailing fraction zeros.
+
+  @param value The value to write.
+  @param buffer Receives the text, which is always terminated if the size isn't zero.
+  @param size The size of the buffer.
+
+  @return The length of the whole text, not counting the terminator.  If this isn't less than the size, the text was cut short.
+ */
+size_t EWCBigDecimalToString(const EWCBigDecimal *value, char *buffer, size_t size);
+
+/**
+  Checks whether a value is zero.
+
+  @param value The value.
+
+  @return Whether it is zero.
+ */
+bool EWCBigDecimalIsZero(const EWCBigDecimal *value);
+
+/**
+  Counts the digits of a value's mantissa.
+
+  @param value The value.
+
+  @return The number of digits, or 0 for zero.
+ */
+int EWCBigDecimalDigitCount(const EWCBigDecimal *value);
+
+/**
+  Finds the position of a value's most significant digit, which for a value of at least one is the number of whole digits.
+
+  @param value The value.
+
+  @return One more than the power of ten of the most significant digit.  Not meaningful for zero.
+ */
+int EWCBigDecimalMagnitude(const EWCBigDecimal *value);
+
+/**
+  Compares two values.
+
+  @param a The first value.
+  @param b The second value.
+
+  @return -1, 0, or 1 as the first value is less than, equal to, or greater than the second.
+ */
+int EWCBigDecimalCompare(const EWCBigDecimal *a, const EWCBigDecimal *b);
+
+/**
+  Compares the absolute values of two values.
+
+  @param a The first value.
+  @param b The second value.
+
+  @return -1, 0, or 1 as the first magnitude is less than, equal to, or greater than the second.
+ */
+int EWCBigDecimalCompareMagnitude(const EWCBigDecimal *a, const EWCBigDecimal *b);
+
+/**
+  Negates a value.
+
+  @param result Receives the negated value.
+  @param value The value.
+ */
+void EWCBigDecimalNegate(EWCBigDecimal *result, const EWCBigDecimal *value);
+
+/**
+  Multiplies a value by a power of ten.
+
+  @param result Receives the shifted value.
+  @param value The value.
+  @param power The power of ten.
+ */
+void EWCBigDecimalShift(EWCBigDecimal *result, const EWCBigDecimal *value, int power);
+
+/**
+  Adds two values exactly.
+
+  @param result Receives the sum.
+  @param a The first value.
+  @param b The second value.
+ */
+void EWCBigDecimalAdd(EWCBigDecimal *result, const EWCBigDecimal *a, const EWCBigDecimal *b);
+
+/**
+  Subtracts two values exactly.
+
+  @param result Receives the difference.
+  @param a The value subtracted from.
+  @param b The value to subtract.
+ */
+void EWCBigDecimalSubtract(EWCBigDecimal *result, const EWCBigDecimal *a, const EWCBigDecimal *b);
+
+/**
+  Multiplies two values exactly, using Karatsuba multiplication once both mantissas reach `EWCBigDecimalKaratsubaThreshold` limbs.
+
+  @param result Receives the product.
+  @param a The first value.
+  @param b The second value.
+ */
+void EWCBigDecimalMultiply(EWCBigDecimal *result, const EWCBigDecimal *a, const EWCBigDecimal *b);
+
+/**
+  Multiplies two values exactly, always using schoolbook multiplication.  This is the reference the Karatsuba multiplication must agree with.
+
+  @param result Receives the product.
+  @param a The first value.
+  @param b The second value.
+ */
+void EWCBigDecimalMultiplySchoolbook(EWCBigDecimal *result, const EWCBigDecimal *a, const EWCBigDecimal *b);
+
+/**
+  Divides two values, by multiplying by a reciprocal found with Newton's method, then correcting the quotient so it is rounded exactly.
+
+  @param result Receives the quotient.  Left unchanged when dividing by zero.
+  @param a The dividend.
+  @param b The divisor.
+  @param precision The significant digits of the quotient.
+
+  @return NO if the divisor is zero.
+ */
+bool EWCBigDecimalDivide(EWCBigDecimal *result, const EWCBigDecimal *a, const EWCBigDecimal *b, int precision);
+
+/**
+  Finds a square root, by multiplying by a reciprocal square root found with Newton's method, then correcting the root so it is rounded exactly.
+
+  @param result Receives the root.  Left unchanged for a negative value.
+  @param value The value.
+  @param precision The significant digits of the root.
+
+  @return NO if the value is negative.
+ */
+bool EWCBigDecimalSqrt(EWCBigDecimal *result, const EWCBigDecimal *value, int precision);
+
+/**
+  Rounds a value to a number of significant digits.
+
+  @param result Receives the rounded value.
+  @param value The value.
+  @param precision The significant digits to keep.  Must be at least 1.
+ */
+void EWCBigDecimalRound(EWCBigDecimal *result, const EWCBigDecimal *value, int precision);
+
+/**
+  Rounds a value to a number of fraction digits.
+
+  @param result Receives the rounded value.
+  @param value The value.
+  @param scale The fraction digits to keep.  A negative scale rounds to tens, hundreds, and so on.
+ */
+void EWCBigDecimalRoundToScale(EWCBigDecimal *result, const EWCBigDecimal *value, int scale);
+
+/**
+  Drops the digits of a value beyond a number of fraction digits, without rounding.
+
+  @param result Receives the truncated value.
+  @param value The value.
+  @param scale The fraction digits to keep.  A negative scale truncates to tens, hundreds, and so on.
+ */
+void EWCBigDecimalTruncateToScale(EWCBigDecimal *result, const EWCBigDecimal *value, int scale);
+
+#endif /* EWCBigDecimal_h */
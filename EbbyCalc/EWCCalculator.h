@@ -21,8 +21,12 @@
 
 #import <Foundation/Foundation.h>
 #import "EWCCalculatorKey.h"
+#import "EWCCalculatorChange.h"
+#import "EWCCalculatorState.h"
+#import "EWCTraceBuffer.h"
 
 @protocol EWCCalculatorDataProtocol;
+@protocol EWCCalculatorRecorderProtocol;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -77,7 +81,12 @@ typedef void(^EWCCalculatorUpdatedCallback)(void);
 @property (nonatomic, readonly) BOOL shouldMemoryClear;
 
 /**
-  The calculator display formatted as a string.
+  The outputs that were changed by the most recent input (key press, `setInput:`, or data provider assignment).  Clients can use this from the update callback to refresh only the affected parts of their interface.
+ */
+@property (nonatomic, readonly) EWCCalculatorChange lastChanges;
+
+/**
+  The calculator display formatted as a string.  The string is computed on first access and reused until the display value, fractional digit count, locale, or digit limit changes.
  */
 @property (nonatomic, readonly) NSString *displayContent;
 
@@ -87,12 +96,24 @@ typedef void(^EWCCalculatorUpdatedCallback)(void);
 @property (nonatomic, readonly) NSDecimalNumber *displayValue;
 
 /**
- The calculator display formatted for accessibility VoiceOver (effectively a spelled out locale-specific reading).
+  The value stored in memory as a raw NSDecimalNumber (zero if there is no stored memory).
+ */
+@property (nonatomic, readonly) NSDecimalNumber *memoryValue;
+
+/**
+  The tax rate used for tax calculations as a raw NSDecimalNumber.
+ */
+@property (nonatomic, readonly) NSDecimalNumber *taxRateValue;
+
+/**
+ The calculator display formatted for accessibility VoiceOver (effectively a spelled out locale-specific reading).  Like `displayContent`, this is only computed when read, and is reused until the display changes.
  */
 @property (nonatomic, readonly) NSString *displayAccessibleContent;
 
 /**
-  The number of digits to which to restrict calculations.
+  The number of digits to which to restrict calculations, or 0 for no restriction.
+
+  The calculator computes with `NSDecimal`, which holds at most `EWCBigDecimalNativeDigits` (38) digits, so a larger value is clamped to that, and a negative value to 0.  Tapes needing more digits than that are run with `EWCTapeProgram`, which computes them with `EWCBigDecimal`.
  */
 @property (nonatomic) NSInteger maximumDigits;
 
@@ -101,6 +122,16 @@ typedef void(^EWCCalculatorUpdatedCallback)(void);
  */
 @property (nonatomic, copy) id<EWCCalculatorDataProtocol> dataProvider;
 
+/**
+  An `EWCCalculatorRecorderProtocol` instance that is told of every input after it has been processed.  It is not retained, so the recorder must detach itself (by setting this to nil) before it goes away.
+ */
+@property (nonatomic, unsafe_unretained, nullable) id<EWCCalculatorRecorderProtocol> recorder;
+
+/**
+  A buffer that receives the timeline of the stages of each input, or NULL (the default) to not trace.  The buffer is not owned by the calculator, so must outlive it, or be detached (by setting this to NULL) first.
+ */
+@property (nonatomic, nullable) EWCTraceBuffer *traceBuffer;
+
 /**
   Explicitly provides a locale to use for the calculator.  If not supplied, it will default to the locale set at the time the calculator is created.
 */
@@ -116,6 +147,35 @@ typedef void(^EWCCalculatorUpdatedCallback)(void);
  */
 - (void)registerUpdateCallbackWithBlock:(EWCCalculatorUpdatedCallback)callback;
 
+/**
+  Subscribes to changes in a set of calculator outputs.  Any number of subscribers can be registered, and each is only told about the outputs it asked for.
+
+  Subscribers are notified after every key press, `setInput:`, or data provider assignment that changes one of their outputs.  Within `performBatchUpdates:`, a single notification describing the net change is delivered when the batch ends.
+
+  @param changes The outputs of interest.
+  @param block The block to run with the changed outputs (restricted to `changes`).
+
+  @return An opaque token that can be passed to `removeObserver:` to unsubscribe.
+ */
+- (id<NSObject>)addObserverForChanges:(EWCCalculatorChange)changes
+  usingBlock:(EWCCalculatorChangeObserver)block;
+
+/**
+  Unsubscribes a previously registered change observer.  It is safe to call this from within an observer block.
+
+  @param observer The token returned from `addObserverForChanges:usingBlock:`.
+ */
+- (void)removeObserver:(id<NSObject>)observer;
+
+/**
+  Performs a group of inputs, coalescing their notifications.
+
+  Change observers receive one notification with the net change across the whole batch, and the update callback is run once if any keys were pressed.  `lastChanges` reports the net change once the batch ends.  Batches may be nested, in which case notifications are delivered when the outermost batch ends.
+
+  @param updates A block that performs the inputs.
+ */
+- (void)performBatchUpdates:(NS_NOESCAPE void(^)(void))updates;
+
 /**
   Explicitly sets the current display input to a supplied numeric value rather than performing key inputs.
 
@@ -123,11 +183,43 @@ typedef void(^EWCCalculatorUpdatedCallback)(void);
  */
 - (void)setInput:(NSDecimalNumber *)value;
 
+/**
+  Rereads the tax rate and memory from the data provider if another calculator sharing it has changed them, notifying as for an input if anything was reread.
+
+  Inputs do this on their own before they are processed, so this is only needed to show changes made elsewhere while the calculator is idle (for instance, on an `EWCCalculatorSharedDataDidChangeNotification`).
+
+  @return YES if the values were reread, in which case `lastChanges` reports what changed.
+ */
+- (BOOL)refreshFromDataProvider;
+
 /**
   Perform a key press on the calculator.  This is the primary way a client should provide input to the calculator.
  */
 - (void)pressKey:(EWCCalculatorKey)key;
 
+/**
+  Returns the calculator to the state of a newly created calculator, including clearing the memory and tax rate, so that the instance can be reused.
+
+  Settings (locale, digit limit, callback, and observers) are kept.  The data provider, if any, is not updated, so that a reset doesn't erase persisted values.
+ */
+- (void)reset;
+
+/**
+  Copies out the complete engine state: the fields, the pending operation queue, the input being built, and the status flags.
+
+  @param state Receives the state.
+ */
+- (void)getState:(EWCCalculatorState *)state;
+
+/**
+  Replaces the complete engine state with one previously copied out with `getState:` (possibly by another calculator, or another process with the same state layout), notifying as for an input.
+
+  As with `reset`, settings are kept and the data provider, if any, is not updated.
+
+  @param state The state to restore.
+ */
+- (void)restoreState:(const EWCCalculatorState *)state;
+
 @end
 
 NS_ASSUME_NONNULL_END
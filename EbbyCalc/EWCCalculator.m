@@ -21,31 +21,49 @@
 
 #import "EWCCalculator.h"
 #import "NSDecimalNumber+EWCMathCategory.h"
-#import "EWCNumericField.h"
+#import "EWCDecimalArithmetic.h"
+#import "EWCBigDecimal.h"
 #import "EWCCalculatorOpcode.h"
-#import "EWCCalculatorToken.h"
 #import "EWCCalculatorDataProtocol.h"
-#import "EWCTokenQueue.h"
-#import "EWCDecimalInputBuilder.h"
+#import "EWCCalculatorRecorderProtocol.h"
+#import "EWCCalculatorState.h"
+#import "EWCDisplayFormatter.h"
+#import "EWCSpellOutFormatter.h"
+#import "EWCLocaleDescriptor.h"
+#import "EWCCalculatorObservation.h"
+
+/**
+  `EWCCalculatorOutputState` captures the client visible outputs of the calculator, so that the outputs changed by an input can be determined by comparing the state before and after.
+ */
+typedef struct {
+  NSDecimal display;  // the display value
+  short fractionDigits;  // the number of fractional digits input
+  NSDecimal memory;  // the memory value
+  BOOL error;  // the error status
+  BOOL memoryClear;  // whether mrc will clear
+  BOOL tax;  // the tax status
+  BOOL taxPlus;  // the tax plus status
+  BOOL taxMinus;  // the tax minus status
+  BOOL taxPercent;  // the tax percent status
+  BOOL rateShifted;  // the rate shift status
+} EWCCalculatorOutputState;
 
 @interface EWCCalculator() {
   EWCCalculatorUpdatedCallback _callback;  // callback used to notify a listener of state changes in the calculator
-  EWCNumericField *_accumulator;  // stores the results of the last calculation
-  EWCNumericField *_display;  // stores the value displayed to the client
-  EWCNumericField *_taxRate;  // stores the tax rate
-  EWCNumericField *_memory;  // stores the general memory value
-  EWCNumericField *_operand;  // stores the last operand for binary operations
-  EWCCalculatorOpcode _operation;  // stores the last operation
-  EWCCalculatorKey _lastKey;  // the last key pressed
-  BOOL _showingJustTax;  // whether the display is showing the tax portion of a tax calculation
-
-  BOOL _displayAvailable;  // whether the value held in the display should be considered available for a calculation
-
-  NSDecimalNumber *_taxResultWithTax;  // cache the last tax calculation that includes tax
-  NSDecimalNumber *_taxResultJustTax;  // cache the tax from the last tax calculation
-
-  EWCTokenQueue *_tokenQueue;  // queue of tokens the calculator will use to detect valid calculations
-  EWCDecimalInputBuilder *_inputBuilder;  // helper class to build up a decimal value from input keys
+  EWCCalculatorState _state;  // all of the calculation state, held inline so that a calculator is a single allocation
+  EWCLocaleDescriptor *_localeDescriptor;  // the shared description of the locale, nil until first used
+  EWCDisplayFormatter *_displayFormatter;  // renders the display value for the current locale and digit settings
+  EWCSpellOutFormatter *_accessibleFormatter;  // spells out the display value for the current locale and digit settings
+  BOOL _dataVersioned;  // whether the data provider reports a version, so it may be shared with other calculators
+  uint64_t _dataVersion;  // the data provider version the tax rate and memory were last read at
+
+  NSString *_displayContent;  // memoized display content, nil when it must be recomputed
+  NSString *_displayAccessibleContent;  // memoized accessible display content, nil when it must be recomputed
+
+  NSMutableArray<EWCCalculatorObservation *> *_observers;  // subscribers to output changes, created on first subscription
+  NSInteger _batchDepth;  // the nesting level of batch updates in progress
+  EWCCalculatorOutputState _batchState;  // the outputs at the start of the outermost batch
+  BOOL _batchKeyPressed;  // whether a key was pressed during the current batch
 }
 
 @end
@@ -53,6 +71,17 @@
 // the default number of rounding fractional digits
 const static int s_maximumFractionDigits = 20;
 
+/**
+  Wraps a held value as a number for calculation.
+
+  @param value The value to wrap.
+
+  @return The wrapped value.
+ */
+static inline NSDecimalNumber *EWCNumber(NSDecimal value) {
+  return [NSDecimalNumber decimalNumberWithDecimal:value];
+}
+
 @implementation EWCCalculator
 
 ///----------------------------------------------
@@ -81,39 +110,22 @@ const static int s_maximumFractionDigits = 20;
   Initialization helper method.  Sets state to reasonable defaults and initializes token queue.
  */
 - (void)sharedInit {
-  _taxStatusVisible = NO;
-  _taxPlusStatusVisible = NO;
-  _taxMinusStatusVisible = NO;
-  _taxPercentStatusVisible = NO;
-
   _maximumDigits = 0;
 
-  _error = NO;
-
-  _display = [EWCNumericField new];
-  _displayAvailable = NO;
-
-  // this property should *not* be read directly from anywhere else but the
-  // public property after this, so that it can get a default value if not set
-  _locale = nil;
-
-  _operation = EWCCalculatorNoOpcode;
-  _operand = [EWCNumericField new];
+  // the descriptor should *not* be read directly from anywhere else but
+  // getLocaleDescriptor after this, so that it can get a default value if not set
+  _localeDescriptor = nil;
 
-  _accumulator = [EWCNumericField new];
-
-  _rateShifted = NO;
-  _taxRate = [EWCNumericField new];
-  _memory = [EWCNumericField new];
-
-  _lastKey = EWCCalculatorNoKey;
-
-  _tokenQueue = [EWCTokenQueue new];
-  _inputBuilder = [EWCDecimalInputBuilder new];
-  _inputBuilder.maximumDigits = _maximumDigits;
+  // observers are only allocated once something subscribes
+  _observers = nil;
+  _batchDepth = 0;
+  _batchKeyPressed = NO;
 
   // clear out all input and calculation status to be ready for user input
-  [self fullClear];
+  EWCCalculatorStateReset(&_state);
+
+  // nothing has been shown to a client yet, so everything is new
+  _lastChanges = EWCCalculatorAllChanges;
 }
 
 ///------------------------------
@@ -127,67 +139,242 @@ const static int s_maximumFractionDigits = 20;
  */
 - (void)setDataProvider:(id<EWCCalculatorDataProtocol>)dataProvider {
   _dataProvider = dataProvider;
+  _dataVersioned = [dataProvider respondsToSelector:@selector(version)];
 
   if (_dataProvider) {
-    _taxRate.value = _dataProvider.taxRate;
+    if (_dataVersioned) {
+      _dataVersion = _dataProvider.version;
+    }
+
+    EWCCalculatorOutputState before;
+    [self captureOutputState:&before];
+
+    EWCCalculatorFieldSet(&_state.taxRate, _dataProvider.taxRate.decimalValue);
     [self setMemory:_dataProvider.memory];
+
+    [self recordChangesFromState:&before];
+    [self notifyOfInputFromKeyPress:NO];
   }
 }
 
 /**
   Returns the set locale, using the current locale if it hasn't been set.
 
-  @note The locale value must only be accessed through this property (no direct ivar access) so that it can be given a default value on first access if not set.
-
   @return The set locale, or the current locale if not already set.
  */
 - (NSLocale *)locale {
-  if (! _locale) {
-    _locale = [[NSLocale currentLocale] copy];
-  }
+  return [self getLocaleDescriptor].locale;
+}
 
-  return _locale;
+- (void)setLocale:(NSLocale *)locale {
+  _localeDescriptor = [EWCLocaleDescriptor descriptorForLocale:locale];
+
+  // the formatters are specific to the locale
+  _displayFormatter = nil;
+  _accessibleFormatter = nil;
+  [self invalidateDisplayContent];
 }
 
 - (NSDecimalNumber *)displayValue {
   // instead of a backing property, return from the display field
-  return _display.value;
+  return EWCNumber(_state.display.value);
+}
+
+- (NSDecimalNumber *)memoryValue {
+  // instead of a backing property, return from the memory field
+  return EWCNumber(_state.memory.value);
+}
+
+- (NSDecimalNumber *)taxRateValue {
+  // instead of a backing property, return from the tax rate field
+  return EWCNumber(_state.taxRate.value);
 }
 
 - (BOOL)hasMemory {
   // instead of a backing property, returns based on the content state of the
   // memory field
-  return ! _memory.isEmpty;
+  return ! _state.memory.empty;
+}
+
+- (BOOL)hasError {
+  return _state.error;
+}
+
+- (BOOL)isTaxStatusVisible {
+  return _state.taxStatusVisible;
+}
+
+- (BOOL)isTaxPlusStatusVisible {
+  return _state.taxPlusStatusVisible;
+}
+
+- (BOOL)isTaxMinusStatusVisible {
+  return _state.taxMinusStatusVisible;
+}
+
+- (BOOL)isTaxPercentStatusVisible {
+  return _state.taxPercentStatusVisible;
+}
+
+- (BOOL)isRateShifted {
+  return _state.rateShifted;
 }
 
 - (BOOL)shouldMemoryClear {
   // if the last key was mrc, then if it is pressed it will be clear
-  return (_lastKey == EWCCalculatorMemoryKey);
+  return (_state.lastKey == EWCCalculatorMemoryKey);
 }
 
 - (void)setMaximumDigits:(NSInteger)value {
-  _maximumDigits = value;
-  _inputBuilder.maximumDigits = value;
+  // an NSDecimal can't hold more digits than this, so neither can the display
+  _maximumDigits = MAX(0, MIN(value, EWCBigDecimalNativeDigits));
+
+  // the formatters depend on the number of fraction digits
+  _displayFormatter = nil;
+  _accessibleFormatter = nil;
+  [self invalidateDisplayContent];
 }
 
 - (NSString *)displayContent {
+  if (! _displayContent) {
+    uint64_t start = EWCTraceBufferStart(_traceBuffer);
 
-  NSDecimalNumber *value = _display.value;
-  NSString *display = [[self getFormatter] stringFromNumber:value];
+    NSDecimal value = _state.display.value;
+    _displayContent = [[self getDisplayFormatter] stringFromDecimal:value
+      minimumFractionDigits:EWCCalculatorInputFractionalDigitCount(&_state.input)];
 
-  display = [self postProcessDisplay:display];
+    EWCTraceBufferFinish(_traceBuffer, EWCTraceFormatStage, start);
+  }
 
-  return display;
+  return _displayContent;
 }
 
 - (NSString *)displayAccessibleContent {
+  if (! _displayAccessibleContent) {
+    uint64_t start = EWCTraceBufferStart(_traceBuffer);
 
-  NSDecimalNumber *value = _display.value;
-  NSNumberFormatter * formatter = [self getAccessibleFormatter];
+    // force at least the number of input fractional digits so that trailing
+    // zeros aren't hidden
+    NSDecimal value = _state.display.value;
+    _displayAccessibleContent = [[self getAccessibleFormatter] stringFromDecimal:value
+      minimumFractionDigits:EWCCalculatorInputFractionalDigitCount(&_state.input)];
 
-  NSString *display = [formatter stringFromNumber:value];
+    EWCTraceBufferFinish(_traceBuffer, EWCTraceFormatStage, start);
+  }
 
-  return display;
+  return _displayAccessibleContent;
+}
+
+///------------------------------
+/// @name Change Tracking Methods
+///------------------------------
+
+/**
+  Compares two possibly NaN decimal values.
+
+  @param a The first value.
+  @param b The second value.
+
+  @return YES if the values are equal, or are both NaN.
+ */
+static BOOL EWCDecimalIsSame(const NSDecimal *a, const NSDecimal *b) {
+  BOOL aNaN = NSDecimalIsNotANumber(a);
+  BOOL bNaN = NSDecimalIsNotANumber(b);
+  if (aNaN || bNaN) {
+    return aNaN == bNaN;
+  }
+
+  return NSDecimalCompare(a, b) == NSOrderedSame;
+}
+
+/**
+  Captures the current client visible outputs.
+
+  @param state Receives the current outputs.
+ */
+- (void)captureOutputState:(EWCCalculatorOutputState *)state {
+  state->display = _state.display.value;
+  state->fractionDigits = EWCCalculatorInputFractionalDigitCount(&_state.input);
+  state->memory = _state.memory.value;
+  state->error = _state.error;
+  state->memoryClear = self.shouldMemoryClear;
+  state->tax = _state.taxStatusVisible;
+  state->taxPlus = _state.taxPlusStatusVisible;
+  state->taxMinus = _state.taxMinusStatusVisible;
+  state->taxPercent = _state.taxPercentStatusVisible;
+  state->rateShifted = _state.rateShifted;
+}
+
+/**
+  Determines the outputs that differ between two captured states.
+
+  @param before The earlier state.
+  @param after The later state.
+
+  @return The set of outputs that changed.
+ */
+static EWCCalculatorChange EWCCalculatorChangesBetweenStates(
+  const EWCCalculatorOutputState *before,
+  const EWCCalculatorOutputState *after) {
+
+  EWCCalculatorChange changes = EWCCalculatorNoChange;
+
+  if (! EWCDecimalIsSame(&before->display, &after->display)) {
+    changes |= EWCCalculatorDisplayValueChange;
+  }
+  if (before->fractionDigits != after->fractionDigits) {
+    changes |= EWCCalculatorFractionDigitsChange;
+  }
+  if (! EWCDecimalIsSame(&before->memory, &after->memory)) {
+    changes |= EWCCalculatorMemoryChange;
+  }
+  if (before->error != after->error) {
+    changes |= EWCCalculatorErrorChange;
+  }
+  if (before->memoryClear != after->memoryClear) {
+    changes |= EWCCalculatorMemoryClearChange;
+  }
+  if (before->tax != after->tax) {
+    changes |= EWCCalculatorTaxStatusChange;
+  }
+  if (before->taxPlus != after->taxPlus) {
+    changes |= EWCCalculatorTaxPlusStatusChange;
+  }
+  if (before->taxMinus != after->taxMinus) {
+    changes |= EWCCalculatorTaxMinusStatusChange;
+  }
+  if (before->taxPercent != after->taxPercent) {
+    changes |= EWCCalculatorTaxPercentStatusChange;
+  }
+  if (before->rateShifted != after->rateShifted) {
+    changes |= EWCCalculatorRateShiftChange;
+  }
+
+  return changes;
+}
+
+/**
+  Records the outputs that have changed since a previously captured state, dropping any memoized display content that depended on them.
+
+  @param before The state captured before the input was processed.
+ */
+- (void)recordChangesFromState:(const EWCCalculatorOutputState *)before {
+  EWCCalculatorOutputState after;
+  [self captureOutputState:&after];
+
+  _lastChanges = EWCCalculatorChangesBetweenStates(before, &after);
+
+  if (_lastChanges & EWCCalculatorDisplayContentChanges) {
+    [self invalidateDisplayContent];
+  }
+}
+
+/**
+  Drops the memoized display strings so that they are recomputed on next access.
+ */
+- (void)invalidateDisplayContent {
+  _displayContent = nil;
+  _displayAccessibleContent = nil;
 }
 
 ///--------------------------------
@@ -195,44 +382,59 @@ const static int s_maximumFractionDigits = 20;
 ///--------------------------------
 
 /**
-  Gets a formatter suitable for displaying numbers in the display.
+  Gets the maximum number of fractional digits to show in the display.
 
-  @return A formatter to be used to format the display value.
+  @return The configured maximum number of digits, or the default rounding digits if there is no maximum.
  */
-- (NSNumberFormatter *)getFormatter {
-  NSNumberFormatter *formatter = [NSNumberFormatter new];
-
-  formatter.maximumFractionDigits = (_maximumDigits > 0)
+- (NSInteger)maximumFractionDigits {
+  return (_maximumDigits > 0)
     ? _maximumDigits
     : s_maximumFractionDigits;
+}
 
-  // force at least the number of input fractional digits so that trailing
-  // zeros aren't hidden
-  formatter.minimumFractionDigits = _inputBuilder.fractionalDigitCount;
-
-  // apply the locale
-  formatter.locale = self.locale;
+/**
+  Gets the renderer used for the display content, creating it if the locale or digit settings have changed since it was last used.
 
-  // This is to be a decimal number display
-  [formatter setNumberStyle:NSNumberFormatterDecimalStyle];
+  @return The display renderer for the current settings.
+ */
+- (EWCDisplayFormatter *)getDisplayFormatter {
+  if (! _displayFormatter) {
+    _displayFormatter = [EWCDisplayFormatter formatterWithDescriptor:[self getLocaleDescriptor]
+      maximumFractionDigits:[self maximumFractionDigits]];
+  }
 
-  return formatter;
+  return _displayFormatter;
 }
 
 /**
-  Gets a formatter suitable for generating the accessibility label for the display
+  Gets the description of the locale, using the current locale if one hasn't been set.
 
-  @return A formatter to be used to format the display accessibility label.
+  @note The descriptor must only be accessed through this method (no direct ivar access) so that it can be given a default value on first access if not set.
+
+  @return The shared descriptor for the locale.
  */
-- (NSNumberFormatter *)getAccessibleFormatter {
-  // start with our per-locale decimal formatter
-  NSNumberFormatter *formatter = [self getFormatter];
+- (EWCLocaleDescriptor *)getLocaleDescriptor {
+  if (! _localeDescriptor) {
+    _localeDescriptor = [EWCLocaleDescriptor currentDescriptor];
+  }
+
+  return _localeDescriptor;
+}
+
+/**
+  Gets the spell out formatter used for the accessibility label of the display, creating it if the locale or digit settings have changed since it was last used.
+
+  It spells numbers out in full, so long numbers are read as the full number and not just a long string of digits.
 
-  // use a number spell out style so the generated text reads long numbers as
-  // the full number and not just a long string of digits
-  [formatter setNumberStyle:NSNumberFormatterSpellOutStyle];
+  @return The accessibility label formatter for the current settings.
+ */
+- (EWCSpellOutFormatter *)getAccessibleFormatter {
+  if (! _accessibleFormatter) {
+    _accessibleFormatter = [EWCSpellOutFormatter formatterWithDescriptor:[self getLocaleDescriptor]
+      maximumFractionDigits:[self maximumFractionDigits]];
+  }
 
-  return formatter;
+  return _accessibleFormatter;
 }
 
 ///---------------------------------------------------------------
@@ -250,49 +452,117 @@ const static int s_maximumFractionDigits = 20;
   @note This is not intended to be used within the calculator itself.  Setting this does raise a change notification, but the caller knows that it has made this call, and hence can also perform its update logic.
  */
 - (void)setInput:(NSDecimalNumber *)value {
+  EWCTraceBuffer *trace = _traceBuffer;
+  if (trace) {
+    EWCTraceBufferBeginKey(trace, EWCTraceInputKey, 0);
+  }
+
+  EWCCalculatorOutputState before;
+  [self captureOutputState:&before];
+
+  [self synchronizeWithDataProvider];
   [self setDisplay:value];
-  _displayAvailable = YES;
+  _state.displayAvailable = YES;
+
+  [self recordChangesFromState:&before];
+  [self notifyOfInputFromKeyPress:NO];
+
+  [_recorder calculator:self didSetInput:value];
+
+  if (trace) {
+    EWCTraceBufferEndKey(trace);
+  }
 }
 
 - (void)pressKey:(EWCCalculatorKey)key {
+  // hold on to the buffer, in case a callback detaches it part way through
+  EWCTraceBuffer *trace = _traceBuffer;
+  if (trace) {
+    EWCTraceBufferBeginKey(trace, (int32_t)key, (char)EWCCalculatorCharacterFromKey(key));
+  }
 
+  EWCCalculatorOutputState before;
+  [self captureOutputState:&before];
+
+  [self synchronizeWithDataProvider];
   [self processKey:key];
 
-  _lastKey = key;
+  _state.lastKey = key;
+
+  [self recordChangesFromState:&before];
+  [self notifyOfInputFromKeyPress:YES];
+
+  [_recorder calculator:self didPressKey:key];
 
-  [self safeCallback];
+  if (trace) {
+    EWCTraceBufferEndKey(trace);
+  }
 }
 
-///---------------------------------
-/// @name Display Processing Methods
-///---------------------------------
+- (BOOL)refreshFromDataProvider {
+  EWCCalculatorOutputState before;
+  [self captureOutputState:&before];
 
-/**
-  Performs final formatting of the diplay string as it is read out by a client.
+  if (! [self synchronizeWithDataProvider]) {
+    return NO;
+  }
 
-  The string passed in has already been decimal formatted for the appropriate locale.  This step ensures that it always contains a decimal separator, even if there are no trailing fractional digits.
+  [self recordChangesFromState:&before];
+  [self notifyOfInputFromKeyPress:NO];
 
-  @param display The decimal formatted string value of the display.
+  return YES;
+}
 
-  @return The display string with a decimal separator if needed.
- */
-- (NSString *)postProcessDisplay:(NSString *)display {
-  NSString *separator = [self.locale decimalSeparator];
+- (id<NSObject>)addObserverForChanges:(EWCCalculatorChange)changes
+  usingBlock:(EWCCalculatorChangeObserver)block {
+  EWCCalculatorObservation *observation = [EWCCalculatorObservation
+    observationForChanges:changes
+    usingBlock:block];
+
+  if (! _observers) {
+    _observers = [NSMutableArray new];
+  }
+
+  [_observers addObject:observation];
+
+  return observation;
+}
 
-  // append decimal separator if needed
-  if (! [display containsString:separator]) {
-    display = [display stringByAppendingString:separator];
+- (void)removeObserver:(id<NSObject>)observer {
+  [_observers removeObjectIdenticalTo:(EWCCalculatorObservation *)observer];
+}
+
+- (void)performBatchUpdates:(NS_NOESCAPE void (^)(void))updates {
+  if (_batchDepth == 0) {
+    [self captureOutputState:&_batchState];
+    _batchKeyPressed = NO;
   }
 
-  return display;
+  ++_batchDepth;
+  updates();
+  --_batchDepth;
+
+  if (_batchDepth == 0) {
+    // report the net change across the batch.  the memoized display content
+    // was already invalidated by the individual inputs.
+    EWCCalculatorOutputState after;
+    [self captureOutputState:&after];
+    _lastChanges = EWCCalculatorChangesBetweenStates(&_batchState, &after);
+
+    [self notifyOfInputFromKeyPress:_batchKeyPressed];
+  }
 }
 
+///---------------------------------
+/// @name Display Processing Methods
+///---------------------------------
+
 /**
   Clears the display and input builder state.
  */
 - (void)clearDisplay {
-  [_display clear];
-  [_inputBuilder clear];
+  EWCCalculatorFieldClear(&_state.display);
+  EWCCalculatorInputClear(&_state.input);
 }
 
 /**
@@ -305,6 +575,8 @@ const static int s_maximumFractionDigits = 20;
   @param number The number to show in the display.
 */
 - (void)setDisplay:(NSDecimalNumber *)number {
+  uint64_t start = EWCTraceBufferStart(_traceBuffer);
+
   [self clearDisplay];
 
   // restrict number to the registered number of digits
@@ -316,11 +588,13 @@ const static int s_maximumFractionDigits = 20;
     [self setError];
   }
 
-  _display.value = clamped;
+  EWCCalculatorFieldSet(&_state.display, clamped.decimalValue);
 
   // the input builder needs to get set along with the display in case
   // there is a sign change after a previous calculation
-  _inputBuilder.value = clamped;
+  EWCCalculatorInputSetValue(&_state.input, clamped.decimalValue);
+
+  EWCTraceBufferFinish(_traceBuffer, EWCTraceDisplayStage, start);
 }
 
 ///-------------------------------------
@@ -331,7 +605,7 @@ const static int s_maximumFractionDigits = 20;
   Clears the value in the accumulator.
 */
 - (void)clearAccumulator {
-  [_accumulator clear];
+  EWCCalculatorFieldClear(&_state.accumulator);
 }
 
 /**
@@ -340,7 +614,7 @@ const static int s_maximumFractionDigits = 20;
   @param number The number to store in the accumulator.
 */
 - (void)setAccumulator:(NSDecimalNumber *)number {
-  _accumulator.value = number;
+  EWCCalculatorFieldSet(&_state.accumulator, number.decimalValue);
 }
 
 ///---------------------------------
@@ -351,7 +625,7 @@ const static int s_maximumFractionDigits = 20;
   Clears the saved operand.
 */
 - (void)clearOperand {
-  [_operand clear];
+  EWCCalculatorFieldClear(&_state.operand);
 }
 
 /**
@@ -360,18 +634,18 @@ const static int s_maximumFractionDigits = 20;
   @param number The number to store as the operand.
  */
 - (void)setOperand:(NSDecimalNumber *)number {
-  _operand.value = number;
+  EWCCalculatorFieldSet(&_state.operand, number.decimalValue);
 }
 
-///---------------------------------
+///----------------------------------
 /// @name Tax Rate Processing Methods
-///---------------------------------
+///----------------------------------
 
 /**
   Clears the stored tax rate.
  */
 - (void)clearTaxRate {
-  [_taxRate clear];
+  EWCCalculatorFieldClear(&_state.taxRate);
 }
 
 /**
@@ -382,25 +656,25 @@ const static int s_maximumFractionDigits = 20;
   @param number The number to store as the tax rate.
  */
 - (void)setTaxRate:(NSDecimalNumber *)number {
-  _taxRate.value = number;
+  EWCCalculatorFieldSet(&_state.taxRate, number.decimalValue);
 
   if (_dataProvider) {
     _dataProvider.taxRate = number;
   }
 }
 
-///---------------------------------
+///--------------------------------
 /// @name Memory Processing Methods
-///---------------------------------
+///--------------------------------
 
 /**
   Clears the general memory.
  */
 - (void)clearMemory {
-  [_memory clear];
+  EWCCalculatorFieldClear(&_state.memory);
 
   if (_dataProvider) {
-    _dataProvider.memory = _memory.value;
+    _dataProvider.memory = EWCNumber(_state.memory.value);
   }
 }
 
@@ -420,7 +694,7 @@ const static int s_maximumFractionDigits = 20;
     if ([clamped compare:[NSDecimalNumber zero]] == NSOrderedSame) {
       [self clearMemory];
     } else {
-      _memory.value = clamped;
+      EWCCalculatorFieldSet(&_state.memory, clamped.decimalValue);
 
       if (_dataProvider) {
         _dataProvider.memory = clamped;
@@ -432,17 +706,80 @@ const static int s_maximumFractionDigits = 20;
   }
 }
 
+/**
+  Rereads the tax rate and memory if another calculator sharing the data provider has changed them since they were last read.
+
+  The values are taken as they are, without writing them back to the provider.  A memory value that doesn't fit within the maximum digits is ignored.
+
+  @return YES if the values were reread.
+ */
+- (BOOL)synchronizeWithDataProvider {
+  if (! _dataVersioned) {
+    return NO;
+  }
+
+  uint64_t version = _dataProvider.version;
+  if (version == _dataVersion) {
+    return NO;
+  }
+
+  _dataVersion = version;
+
+  EWCCalculatorFieldSet(&_state.taxRate, _dataProvider.taxRate.decimalValue);
+
+  NSDecimalNumber *clamped = [_dataProvider.memory ewc_decimalNumberByRestrictingToDigits:_maximumDigits];
+  if (clamped) {
+    if ([clamped compare:[NSDecimalNumber zero]] == NSOrderedSame) {
+      EWCCalculatorFieldClear(&_state.memory);
+    } else {
+      EWCCalculatorFieldSet(&_state.memory, clamped.decimalValue);
+    }
+  }
+
+  return YES;
+}
+
 ///-------------------------------------------------
 /// @name Other Methods for Clearing/Resetting State
 ///-------------------------------------------------
 
+- (void)reset {
+  EWCCalculatorOutputState before;
+  [self captureOutputState:&before];
+
+  // reinitialize the state in place rather than going through the setters, so
+  // that the data provider isn't updated
+  EWCCalculatorStateReset(&_state);
+
+  [self recordChangesFromState:&before];
+  [self notifyOfInputFromKeyPress:NO];
+}
+
+- (void)getState:(EWCCalculatorState *)state {
+  *state = _state;
+}
+
+- (void)restoreState:(const EWCCalculatorState *)state {
+  EWCCalculatorOutputState before;
+  [self captureOutputState:&before];
+
+  _state = *state;
+
+  // the input digit count shapes the display without being an output of its
+  // own, so the memoized content can't be trusted
+  [self invalidateDisplayContent];
+
+  [self recordChangesFromState:&before];
+  [self notifyOfInputFromKeyPress:NO];
+}
+
 /**
   Clears all user input and state related to ongoing calculation.
  */
 - (void)fullClear {
   [self clearDisplay];
   [self clearCalculation];
-  _rateShifted = NO;
+  _state.rateShifted = NO;
 }
 
 /**
@@ -452,19 +789,19 @@ const static int s_maximumFractionDigits = 20;
   [self clearAccumulator];
   [self clearOperand];
 
-  _operation = EWCCalculatorNoOpcode;
+  _state.operation = EWCCalculatorNoOpcode;
 
-  [_tokenQueue clear];
+  EWCCalculatorTokenQueueClear(&_state.queue);
 }
 
 /**
   Turns of all of the status indicators related to tax calculations.
  */
 - (void)clearAllTaxStatus {
-  _taxStatusVisible = NO;
-  _taxPlusStatusVisible = NO;
-  _taxMinusStatusVisible = NO;
-  _taxPercentStatusVisible = NO;
+  _state.taxStatusVisible = NO;
+  _state.taxPlusStatusVisible = NO;
+  _state.taxMinusStatusVisible = NO;
+  _state.taxPercentStatusVisible = NO;
 }
 
 
@@ -481,11 +818,11 @@ const static int s_maximumFractionDigits = 20;
  */
 - (void)sqrtPressed {
   // no action if in error state
-  if (_error) { return; }
+  if (_state.error) { return; }
 
   BOOL shouldSetError = NO;
 
-  NSDecimalNumber *tmp = _display.value;
+  NSDecimalNumber *tmp = EWCNumber(_state.display.value);
   if ([tmp compare:[NSDecimalNumber zero]] == NSOrderedAscending) {
     // negative
     // treat as positive for the sqrt, but riase an error
@@ -493,8 +830,12 @@ const static int s_maximumFractionDigits = 20;
     shouldSetError = YES;
   }
 
-  [self setDisplay:[tmp ewc_decimalNumberBySqrt]];
-  _displayAvailable = YES;
+  uint64_t start = EWCTraceBufferStart(_traceBuffer);
+  NSDecimalNumber *root = [tmp ewc_decimalNumberBySqrt];
+  EWCTraceBufferFinish(_traceBuffer, EWCTraceArithmeticStage, start);
+
+  [self setDisplay:root];
+  _state.displayAvailable = YES;
 
   if (shouldSetError) {
     [self setError];
@@ -505,6 +846,52 @@ const static int s_maximumFractionDigits = 20;
 /// @name Math Operation Methods
 ///-----------------------------
 
+/**
+  Multiplies two numbers at full precision, taking the direct arithmetic of `EWCDecimalMultiply` when the product is exact.
+
+  @note Errors that `EWCDecimalMultiply` reports (overflow and the like) are left to `NSDecimalNumber`, so that they raise as they always have.
+
+  @param left The multiplicand.
+  @param right The multiplier.
+
+  @return The product, as `NSDecimalNumber` computes it.
+ */
+- (NSDecimalNumber *)multiplyNumber:(NSDecimalNumber *)left by:(NSDecimalNumber *)right {
+  NSDecimal a = left.decimalValue;
+  NSDecimal b = right.decimalValue;
+  NSDecimal product;
+
+  NSCalculationError error = EWCDecimalMultiply(&product, &a, &b);
+  if (error != NSCalculationNoError && error != NSCalculationLossOfPrecision) {
+    return [left decimalNumberByMultiplyingBy:right];
+  }
+
+  return EWCNumber(product);
+}
+
+/**
+  Divides two numbers at full precision, taking the direct arithmetic of `EWCDecimalDivide` when the quotient is exact.
+
+  @note As for multiplication, errors are left to `NSDecimalNumber`.  Callers check for a zero divisor first.
+
+  @param dividend The dividend.
+  @param divisor The divisor.
+
+  @return The quotient, as `NSDecimalNumber` computes it.
+ */
+- (NSDecimalNumber *)divideNumber:(NSDecimalNumber *)dividend by:(NSDecimalNumber *)divisor {
+  NSDecimal a = dividend.decimalValue;
+  NSDecimal b = divisor.decimalValue;
+  NSDecimal quotient;
+
+  NSCalculationError error = EWCDecimalDivide(&quotient, &a, &b);
+  if (error != NSCalculationNoError && error != NSCalculationLossOfPrecision) {
+    return [dividend decimalNumberByDividingBy:divisor];
+  }
+
+  return EWCNumber(quotient);
+}
+
 /**
   Converts the input operation to an opcode.
 
@@ -546,9 +933,9 @@ const static int s_maximumFractionDigits = 20;
   Used when the user inputs a bare equal key to repeat the last operation.
  */
 - (void)performLastOperation {
-  NSDecimalNumber *acc = _accumulator.value;
-  NSDecimalNumber *opd = _operand.value;
-  EWCCalculatorOpcode op = _operation;
+  NSDecimalNumber *acc = EWCNumber(_state.accumulator.value);
+  NSDecimalNumber *opd = EWCNumber(_state.operand.value);
+  EWCCalculatorOpcode op = _state.operation;
 
   [self performBinaryOperation:op withData:acc andOperand:opd];
 }
@@ -579,6 +966,8 @@ const static int s_maximumFractionDigits = 20;
     return;
   }
 
+  uint64_t start = EWCTraceBufferStart(_traceBuffer);
+
   switch (op) {
     case EWCCalculatorAddOpcode:
       data = [data decimalNumberByAdding:operand];
@@ -589,30 +978,30 @@ const static int s_maximumFractionDigits = 20;
       break;
 
     case EWCCalculatorMultiplyOpcode:
-      data = [data decimalNumberByMultiplyingBy:operand];
+      data = [self multiplyNumber:data by:operand];
       break;
 
     case EWCCalculatorDivideOpcode:
-      data = [data decimalNumberByDividingBy:operand];
+      data = [self divideNumber:data by:operand];
       break;
 
     case EWCCalculatorAddPercentOpcode:
       tmp = data;
-      percent = [[operand decimalNumberByMultiplyingBy:hundredth] decimalNumberByMultiplyingBy:data];
+      percent = [self multiplyNumber:[self multiplyNumber:operand by:hundredth] by:data];
       data = [data decimalNumberByAdding:percent];
       break;
 
     case EWCCalculatorSubtractPercentOpcode:
-      percent = [[operand decimalNumberByMultiplyingBy:hundredth] decimalNumberByMultiplyingBy:data];
+      percent = [self multiplyNumber:[self multiplyNumber:operand by:hundredth] by:data];
       data = [data decimalNumberBySubtracting:percent];
       break;
 
     case EWCCalculatorMultiplyPercentOpcode:
-      data = [[operand decimalNumberByMultiplyingBy:hundredth] decimalNumberByMultiplyingBy:data];
+      data = [self multiplyNumber:[self multiplyNumber:operand by:hundredth] by:data];
       break;
 
     case EWCCalculatorDividePercentOpcode:
-      data = [data decimalNumberByDividingBy:[operand decimalNumberByMultiplyingBy:hundredth]];
+      data = [self divideNumber:data by:[self multiplyNumber:operand by:hundredth]];
       break;
 
     case EWCCalculatorNoOpcode:
@@ -624,10 +1013,12 @@ const static int s_maximumFractionDigits = 20;
       return;
   }
 
-  _operation = op;
+  EWCTraceBufferFinish(_traceBuffer, EWCTraceArithmeticStage, start);
+
+  _state.operation = op;
   [self setAccumulator:data];
   [self setOperand:operand];
-  [self setDisplay:_accumulator.value];
+  [self setDisplay:EWCNumber(_state.accumulator.value)];
 }
 
 /**
@@ -684,17 +1075,17 @@ const static int s_maximumFractionDigits = 20;
   In an error state, this clears the error.  If the user just edited a value (resulting in that value being the final data item in the queue), just clear out the data value.  Otherwise, clear the entire calculator state back to defaults.
  */
 - (void)processClearKey {
-  if (_error) {
-    _error = NO;
+  if (_state.error) {
+    _state.error = NO;
     [self clearAllTaxStatus];
     return;
   }
 
   // if we are in the middle of a calculation (last token is number)
   // just remove it
-  EWCCalculatorToken *lastToken = [_tokenQueue getLastToken];
-  if (lastToken && lastToken.tokenType == EWCCalculatorDataTokenType) {
-    [_tokenQueue removeLastToken];
+  const EWCCalculatorToken *lastToken = EWCCalculatorTokenQueueLastToken(&_state.queue);
+  if (lastToken && lastToken->tokenType == EWCCalculatorDataTokenType) {
+    EWCCalculatorTokenQueueRemoveLastToken(&_state.queue);
     [self clearDisplay];
     return;
   }
@@ -709,13 +1100,40 @@ const static int s_maximumFractionDigits = 20;
   In isolation, this acts as a memory recall function, but if the last button pressed was the memory key, pressing it again will clear the stored memory value.
  */
 - (void)processMemoryKey {
-  if (_lastKey == EWCCalculatorMemoryKey) {
+  if (_state.lastKey == EWCCalculatorMemoryKey) {
     // clear memory
     [self clearMemory];
   } else {
     // recall memory
-    [self setDisplay:_memory.value];
-    _displayAvailable = YES;
+    [self setDisplay:EWCNumber(_state.memory.value)];
+    _state.displayAvailable = YES;
+  }
+}
+
+/**
+  Adds a value to the stored memory value.  A data provider that can add to its memory in one step does the addition, so that the additions of calculators sharing it aren't lost.
+
+  @note The calculator can enter an error state if the sum would be too large to fit in the maximum allowed digits.
+
+  @param value The value to add.
+ */
+- (void)addToMemory:(NSDecimalNumber *)value {
+  if (! [_dataProvider respondsToSelector:@selector(addToMemory:restrictedToDigits:)]) {
+    [self setMemory:[EWCNumber(_state.memory.value) decimalNumberByAdding:value]];
+    return;
+  }
+
+  NSDecimalNumber *memory = [_dataProvider addToMemory:value restrictedToDigits:_maximumDigits];
+  if (! memory) {
+    // precision error, set the sum to display, which will trigger error automatically
+    [self setDisplay:[_dataProvider.memory decimalNumberByAdding:value]];
+    return;
+  }
+
+  if ([memory compare:[NSDecimalNumber zero]] == NSOrderedSame) {
+    EWCCalculatorFieldClear(&_state.memory);
+  } else {
+    EWCCalculatorFieldSet(&_state.memory, memory.decimalValue);
   }
 }
 
@@ -723,11 +1141,7 @@ const static int s_maximumFractionDigits = 20;
   Adds the current value to the stored memory value.
  */
 - (void)processMemoryPlusKey {
-  NSDecimalNumber *mem = _memory.value;
-  NSDecimalNumber *opd = _display.value;
-  mem = [mem decimalNumberByAdding:opd];
-
-  [self setMemory:mem];
+  [self addToMemory:EWCNumber(_state.display.value)];
 }
 
 /**
@@ -736,18 +1150,15 @@ const static int s_maximumFractionDigits = 20;
   @note The calculator can enter an error state if the subtraction would result in a value to large to fit in the maximum allowed digits.
  */
 - (void)processMemoryMinusKey {
-  NSDecimalNumber *mem = _memory.value;
-  NSDecimalNumber *opd = _display.value;
-  mem = [mem decimalNumberBySubtracting:opd];
-
-  [self setMemory:mem];
+  NSDecimalNumber *opd = EWCNumber(_state.display.value);
+  [self addToMemory:[[NSDecimalNumber zero] decimalNumberBySubtracting:opd]];
 }
 
 /**
   Toggles the rate shifted state for setting or recalling the tax rate.
  */
 - (void)processRateKey {
-  _rateShifted = ! _rateShifted;
+  _state.rateShifted = ! _state.rateShifted;
 }
 
 /**
@@ -758,14 +1169,14 @@ const static int s_maximumFractionDigits = 20;
 - (void)displayTaxResult {
   NSDecimalNumber *value;
 
-  if (_showingJustTax) {
-    value = _taxResultJustTax;
+  if (_state.showingJustTax) {
+    value = EWCNumber(_state.taxResultJustTax);
   } else {
-    value = _taxResultWithTax;
+    value = EWCNumber(_state.taxResultWithTax);
   }
 
   [self setDisplay:value];
-  _displayAvailable = YES;
+  _state.displayAvailable = YES;
 }
 
 /**
@@ -774,34 +1185,38 @@ const static int s_maximumFractionDigits = 20;
   The key has several possible actions.  In the shifted state, it is used to set the saved tax rate.  When not shifted, it will calculate the tax adjusted value.  Subsequent presses will toggle between showing the adjusted result, and showing the amount of tax that was added.
  */
 - (void)processTaxPlusKey {
-  if (_rateShifted) {
+  if (_state.rateShifted) {
     // treat as store
-    [self setTaxRate:_display.value];
-    _taxPercentStatusVisible = YES;
+    [self setTaxRate:EWCNumber(_state.display.value)];
+    _state.taxPercentStatusVisible = YES;
     [self clearCalculation];
   } else {
     // treat as tax plus
-    if (_lastKey != EWCCalculatorTaxPlusKey) {
+    if (_state.lastKey != EWCCalculatorTaxPlusKey) {
       // first press, so do the calculation and show the summed result
-      _showingJustTax = NO;
-      _taxPlusStatusVisible = YES;
+      _state.showingJustTax = NO;
+      _state.taxPlusStatusVisible = YES;
+
+      uint64_t start = EWCTraceBufferStart(_traceBuffer);
 
       NSDecimalNumber *hundredth = [NSDecimalNumber decimalNumberWithMantissa:1 exponent:-2 isNegative:NO];
-      NSDecimalNumber *mult = [_taxRate.value decimalNumberByMultiplyingBy:hundredth];
-      NSDecimalNumber *tax = [_display.value decimalNumberByMultiplyingBy:mult];
-      NSDecimalNumber *tmp = [_display.value decimalNumberByAdding:tax];
+      NSDecimalNumber *mult = [self multiplyNumber:EWCNumber(_state.taxRate.value) by:hundredth];
+      NSDecimalNumber *tax = [self multiplyNumber:EWCNumber(_state.display.value) by:mult];
+      NSDecimalNumber *tmp = [EWCNumber(_state.display.value) decimalNumberByAdding:tax];
 
-      _taxResultWithTax = tmp;
-      _taxResultJustTax = tax;
+      _state.taxResultWithTax = tmp.decimalValue;
+      _state.taxResultJustTax = tax.decimalValue;
+
+      EWCTraceBufferFinish(_traceBuffer, EWCTraceArithmeticStage, start);
 
     } else {
-      _showingJustTax = ! _showingJustTax;
+      _state.showingJustTax = ! _state.showingJustTax;
 
       // use the cached tax result and show the appropriate part
-      if (_showingJustTax) {
-        _taxStatusVisible = YES;
+      if (_state.showingJustTax) {
+        _state.taxStatusVisible = YES;
       } else {
-        _taxPlusStatusVisible = YES;
+        _state.taxPlusStatusVisible = YES;
       }
     }
 
@@ -815,45 +1230,49 @@ const static int s_maximumFractionDigits = 20;
   The key has several possible actions.  In the shifted state, it is used to recall the saved tax rate.  When not shifted, it will deduct tax from the current value.  Subsequent presses will toggle between showing the deducted result, and showing the amount of tax that was deducted.
  */
 - (void)processTaxMinusKey {
-  if (_rateShifted) {
+  if (_state.rateShifted) {
     // treat as recall
-    [self setDisplay:_taxRate.value];
-    _taxPercentStatusVisible = YES;
+    [self setDisplay:EWCNumber(_state.taxRate.value)];
+    _state.taxPercentStatusVisible = YES;
     [self clearCalculation];
   } else {
     // treat as tax minus
-    if (_lastKey != EWCCalculatorTaxMinusKey) {
+    if (_state.lastKey != EWCCalculatorTaxMinusKey) {
       // first press, so do the calculation and show the difference result
-      _showingJustTax = NO;
-      _taxMinusStatusVisible = YES;
+      _state.showingJustTax = NO;
+      _state.taxMinusStatusVisible = YES;
+
+      uint64_t start = EWCTraceBufferStart(_traceBuffer);
 
       NSDecimalNumber *hundredth = [NSDecimalNumber decimalNumberWithMantissa:1 exponent:-2 isNegative:NO];
-      NSDecimalNumber *mult = [_taxRate.value decimalNumberByMultiplyingBy:hundredth];
+      NSDecimalNumber *mult = [self multiplyNumber:EWCNumber(_state.taxRate.value) by:hundredth];
       mult = [mult decimalNumberByAdding:[NSDecimalNumber one]];
 
       if ([mult compare:[NSDecimalNumber zero]] != NSOrderedSame) {
-        NSDecimalNumber *tmp = [_display.value decimalNumberByDividingBy:mult];
-        NSDecimalNumber *tax = [_display.value decimalNumberBySubtracting:tmp];
+        NSDecimalNumber *tmp = [self divideNumber:EWCNumber(_state.display.value) by:mult];
+        NSDecimalNumber *tax = [EWCNumber(_state.display.value) decimalNumberBySubtracting:tmp];
 
-        _taxResultWithTax = tmp;
-        _taxResultJustTax = tax;
+        _state.taxResultWithTax = tmp.decimalValue;
+        _state.taxResultJustTax = tax.decimalValue;
 
       } else {
         [self setError];
       }
 
+      EWCTraceBufferFinish(_traceBuffer, EWCTraceArithmeticStage, start);
+
     } else {
-      _showingJustTax = ! _showingJustTax;
+      _state.showingJustTax = ! _state.showingJustTax;
 
       // use the cached tax result and show the appropriate part
-      if (_showingJustTax) {
-        _taxStatusVisible = YES;
+      if (_state.showingJustTax) {
+        _state.taxStatusVisible = YES;
       } else {
-        _taxMinusStatusVisible = YES;
+        _state.taxMinusStatusVisible = YES;
       }
     }
 
-    if (! _error) {
+    if (! _state.error) {
       [self displayTaxResult];
     }
   }
@@ -879,7 +1298,7 @@ const static int s_maximumFractionDigits = 20;
   BOOL handled = NO;
   BOOL isRateKey = EWCCalculatorKeyIsRateKey(key);
 
-  if (_error) {
+  if (_state.error) {
     [self processInputForErrorState:key];
     return;
   }
@@ -889,15 +1308,17 @@ const static int s_maximumFractionDigits = 20;
 
   // if not a tax rate-related key, unshift
   if (! isRateKey) {
-    _rateShifted = NO;
+    _state.rateShifted = NO;
   }
 
   // keys that contribute to building up a number
-  handled = [_inputBuilder processKey:key];
+  uint64_t start = EWCTraceBufferStart(_traceBuffer);
+  handled = EWCCalculatorInputProcessKey(&_state.input, key, _maximumDigits);
+  EWCTraceBufferFinish(_traceBuffer, EWCTraceInputStage, start);
   if (handled) {
     // update the display with the current input
-    _display.value = _inputBuilder.value;
-    _displayAvailable = YES;
+    EWCCalculatorFieldSet(&_state.display, _state.input.value);
+    _state.displayAvailable = YES;
     return;
   }
 
@@ -928,30 +1349,36 @@ const static int s_maximumFractionDigits = 20;
   // we pressed a key that doesn't contribute to editing the display
   // so the input is complete
 
-  if (_displayAvailable) {
-    _displayAvailable = NO;
-    [_tokenQueue enqueueData:_display.value];
+  start = EWCTraceBufferStart(_traceBuffer);
+
+  if (_state.displayAvailable) {
+    _state.displayAvailable = NO;
+    EWCCalculatorTokenQueueEnqueueData(&_state.queue, _state.display.value);
   }
 
   if (key == EWCCalculatorClearKey) {
     [self processClearKey];
   } else if (EWCCalculatorKeyIsBinaryOp(key)) {
-    [_tokenQueue enqueueBinOp:[self getOpcodeFromKey:key]];
+    EWCCalculatorTokenQueueEnqueueBinOp(&_state.queue, [self getOpcodeFromKey:key]);
   } else if (key == EWCCalculatorEqualKey) {
-    [_tokenQueue enqueueEqual:EWCCalculatorEqualOpcode];
+    EWCCalculatorTokenQueueEnqueueEqual(&_state.queue, EWCCalculatorEqualOpcode);
   } else if (key == EWCCalculatorPercentKey) {
-    [_tokenQueue enqueueEqual:EWCCalculatorPercentOpcode];
+    EWCCalculatorTokenQueueEnqueueEqual(&_state.queue, EWCCalculatorPercentOpcode);
   }
 
+  EWCTraceBufferFinish(_traceBuffer, EWCTraceEnqueueStage, start);
+
   // check whether one of the previous possible enqueue statements was invalid
-  if (_tokenQueue.hasError) {
+  if (_state.queue.hasError) {
     [self setError];
     return;
   }
 
   // if there was a change to the queue, try to parse it
-  if (_tokenQueue.didChange) {
+  if (EWCCalculatorTokenQueueTakeDidChange(&_state.queue)) {
+    start = EWCTraceBufferStart(_traceBuffer);
     [self parseQueue];
+    EWCTraceBufferFinish(_traceBuffer, EWCTraceParseStage, start);
   }
 }
 
@@ -966,23 +1393,23 @@ const static int s_maximumFractionDigits = 20;
 
   @return YES if the tokens processed during parsing should be removed from the queue (they have been applied to the calculation), otherwise NO (there wasn't yet a complete operation).
  */
-- (BOOL)parseStartingWithOp:(EWCCalculatorToken *)aToken {
+- (BOOL)parseStartingWithOp:(const EWCCalculatorToken *)aToken {
 
   // must be one of
   // o= - change the operator used for last operation (and execute it)
   // od= - binary operation
   // odo - binary operation with a continuation
 
-  EWCCalculatorToken *o1 = nil, *d1 = nil, *o2 = nil, *eq = nil;
+  const EWCCalculatorToken *o1 = NULL, *d1 = NULL, *o2 = NULL, *eq = NULL;
   o1 = aToken;
 
-  d1 = [_tokenQueue nextTokenAs:EWCCalculatorDataTokenType];
+  d1 = EWCCalculatorTokenQueueNextTokenAs(&_state.queue, EWCCalculatorDataTokenType);
   if (! d1) {
-    eq = [_tokenQueue nextTokenAs:EWCCalculatorEqualTokenType];
+    eq = EWCCalculatorTokenQueueNextTokenAs(&_state.queue, EWCCalculatorEqualTokenType);
     if (eq) {
       // o= - change the operator used for last operation (and execute it)
-      EWCCalculatorOpcode op = EWCCalculatorOpcodeModifyForEqualMode(o1.opcode, eq.opcode);
-      _operation = op;
+      EWCCalculatorOpcode op = EWCCalculatorOpcodeModifyForEqualMode(o1->opcode, eq->opcode);
+      _state.operation = op;
       [self performLastOperation];
       return YES;
     }
@@ -990,14 +1417,14 @@ const static int s_maximumFractionDigits = 20;
     return NO;
   }
 
-  o2 = [_tokenQueue nextTokenAs:EWCCalculatorBinOpTokenType];
+  o2 = EWCCalculatorTokenQueueNextTokenAs(&_state.queue, EWCCalculatorBinOpTokenType);
   if (! o2) {
-    eq = [_tokenQueue nextTokenAs:EWCCalculatorEqualTokenType];
+    eq = EWCCalculatorTokenQueueNextTokenAs(&_state.queue, EWCCalculatorEqualTokenType);
     if (eq) {
       // od= - binary operation
-      NSDecimalNumber *acc = _accumulator.value;
-      EWCCalculatorOpcode op = EWCCalculatorOpcodeModifyForEqualMode(o1.opcode, eq.opcode);
-      [self performBinaryOperation:op withData:acc andOperand:d1.data];
+      NSDecimalNumber *acc = EWCNumber(_state.accumulator.value);
+      EWCCalculatorOpcode op = EWCCalculatorOpcodeModifyForEqualMode(o1->opcode, eq->opcode);
+      [self performBinaryOperation:op withData:acc andOperand:EWCNumber(d1->data)];
       return YES;
     }
 
@@ -1005,9 +1432,9 @@ const static int s_maximumFractionDigits = 20;
   }
 
   // odo - binary operation with a continuation
-  NSDecimalNumber *acc = _accumulator.value;
-  [_tokenQueue pushbackToken];
-  [self performBinaryOperation:o1.opcode withData:acc andOperand:d1.data];
+  NSDecimalNumber *acc = EWCNumber(_state.accumulator.value);
+  EWCCalculatorTokenQueuePushbackToken(&_state.queue);
+  [self performBinaryOperation:o1->opcode withData:acc andOperand:EWCNumber(d1->data)];
 
   return YES;
 }
@@ -1019,7 +1446,7 @@ const static int s_maximumFractionDigits = 20;
 
   @return YES if the tokens processed during parsing should be removed from the queue (they have been applied to the calculation), otherwise NO (there wasn't yet a complete operation).
  */
-- (BOOL)parseStartingWithData:(EWCCalculatorToken *)aToken {
+- (BOOL)parseStartingWithData:(const EWCCalculatorToken *)aToken {
 
   // must be one of
   // d= - if there was a last operation, assign d to acc and execute, if not this has no real impact on the state, so just consume
@@ -1027,22 +1454,22 @@ const static int s_maximumFractionDigits = 20;
   // dod= - binary operation
   // dodo - binary operation with a continuation
 
-  EWCCalculatorToken *d1 = nil, *o1 = nil, *d2 = nil, *o2 = nil, *eq = nil;
+  const EWCCalculatorToken *d1 = NULL, *o1 = NULL, *d2 = NULL, *o2 = NULL, *eq = NULL;
   d1 = aToken;
 
-  o1 = [_tokenQueue nextTokenAs:EWCCalculatorBinOpTokenType];
+  o1 = EWCCalculatorTokenQueueNextTokenAs(&_state.queue, EWCCalculatorBinOpTokenType);
   if (! o1) {
-    eq = [_tokenQueue nextTokenAs:EWCCalculatorEqualTokenType];
+    eq = EWCCalculatorTokenQueueNextTokenAs(&_state.queue, EWCCalculatorEqualTokenType);
     if (eq) {
       // d= - if there is a last op, assign d to acc, and perform it (not if percent!)
-      if (_operation != EWCCalculatorNoOpcode && eq.opcode == EWCCalculatorEqualOpcode) {
-        [self setAccumulator:d1.data];
+      if (_state.operation != EWCCalculatorNoOpcode && eq->opcode == EWCCalculatorEqualOpcode) {
+        [self setAccumulator:EWCNumber(d1->data)];
         [self performLastOperation];
       } else {
         // there was no operation, user just entered a number and hit enter
         // just don't clear the display, mark the that it is available, and let
         // the queue be cleared
-        _displayAvailable = YES;
+        _state.displayAvailable = YES;
       }
       return YES;
     }
@@ -1050,32 +1477,32 @@ const static int s_maximumFractionDigits = 20;
     return NO;
   }
 
-  d2 = [_tokenQueue nextTokenAs:EWCCalculatorDataTokenType];
+  d2 = EWCCalculatorTokenQueueNextTokenAs(&_state.queue, EWCCalculatorDataTokenType);
   if (! d2) {
-    eq = [_tokenQueue nextTokenAs:EWCCalculatorEqualTokenType];
+    eq = EWCCalculatorTokenQueueNextTokenAs(&_state.queue, EWCCalculatorEqualTokenType);
     if (eq) {
       // do= - unary operation on d
-      if (eq.opcode == EWCCalculatorEqualOpcode) {
-        [self performUnaryOperation:o1.opcode withData:d1.data];
+      if (eq->opcode == EWCCalculatorEqualOpcode) {
+        [self performUnaryOperation:o1->opcode withData:EWCNumber(d1->data)];
         return YES;
       } else {
         // the equal was a percent, which has no effect
         // leave the queue alone, but excise the percent token
-        [_tokenQueue pushbackToken];  // percent is top of queue
-        [_tokenQueue popToken];
+        EWCCalculatorTokenQueuePushbackToken(&_state.queue);  // percent is top of queue
+        EWCCalculatorTokenQueuePopToken(&_state.queue);
       }
     }
 
     return NO;
   }
 
-  o2 = [_tokenQueue nextTokenAs:EWCCalculatorBinOpTokenType];
+  o2 = EWCCalculatorTokenQueueNextTokenAs(&_state.queue, EWCCalculatorBinOpTokenType);
   if (! o2) {
-    eq = [_tokenQueue nextTokenAs:EWCCalculatorEqualTokenType];
+    eq = EWCCalculatorTokenQueueNextTokenAs(&_state.queue, EWCCalculatorEqualTokenType);
     if (eq) {
       // dod= - binary operation
-      EWCCalculatorOpcode op = EWCCalculatorOpcodeModifyForEqualMode(o1.opcode, eq.opcode);
-      [self performBinaryOperation:op withData:d1.data andOperand:d2.data];
+      EWCCalculatorOpcode op = EWCCalculatorOpcodeModifyForEqualMode(o1->opcode, eq->opcode);
+      [self performBinaryOperation:op withData:EWCNumber(d1->data) andOperand:EWCNumber(d2->data)];
       return YES;
     }
 
@@ -1083,8 +1510,8 @@ const static int s_maximumFractionDigits = 20;
   }
 
   // dodo - binary operation with a continuation
-  [_tokenQueue pushbackToken];
-  [self performBinaryOperation:o1.opcode withData:d1.data andOperand:d2.data];
+  EWCCalculatorTokenQueuePushbackToken(&_state.queue);
+  [self performBinaryOperation:o1->opcode withData:EWCNumber(d1->data) andOperand:EWCNumber(d2->data)];
 
   return YES;
 }
@@ -1101,11 +1528,11 @@ const static int s_maximumFractionDigits = 20;
   // assume that we won't find anything
   BOOL shouldCommit = NO;
 
-  [_tokenQueue moveToFirst];
+  EWCCalculatorTokenQueueMoveToFirst(&_state.queue);
 
   // read tokens until either we get passed any empty tokens, or we run out of
   // tokens to process
-  EWCCalculatorToken *token = [_tokenQueue nextToken];
+  const EWCCalculatorToken *token = EWCCalculatorTokenQueueNextToken(&_state.queue);
 
   // check whether anything is queued
   if (! token) {
@@ -1113,7 +1540,7 @@ const static int s_maximumFractionDigits = 20;
     return;
   }
 
-  switch (token.tokenType) {
+  switch (token->tokenType) {
     case EWCCalculatorBinOpTokenType:
       // could be continuation op or unary
       shouldCommit = [self parseStartingWithOp:token];
@@ -1121,7 +1548,7 @@ const static int s_maximumFractionDigits = 20;
 
     case EWCCalculatorEqualTokenType:
       // perform last operation (only if normal equal)
-      if (token.opcode == EWCCalculatorEqualOpcode) {
+      if (token->opcode == EWCCalculatorEqualOpcode) {
         [self performLastOperation];
       }
 
@@ -1143,7 +1570,7 @@ const static int s_maximumFractionDigits = 20;
   // we handled an operation, so commit the portion of the queue that we used.
   if (shouldCommit) {
     // clear processed items
-    [_tokenQueue commit];
+    EWCCalculatorTokenQueueCommit(&_state.queue);
   }
 }
 
@@ -1193,15 +1620,15 @@ const static int s_maximumFractionDigits = 20;
  */
 - (void)setError {
   // mark the rror
-  _error = YES;
+  _state.error = YES;
 
   // clear the operation queue
-  [_tokenQueue clear];
+  EWCCalculatorTokenQueueClear(&_state.queue);
 
   // clear other state related to the calculation history
   [self clearAccumulator];
   [self clearOperand];
-  _operation = EWCCalculatorNoOpcode;
+  _state.operation = EWCCalculatorNoOpcode;
 }
 
 ///----------------------------
@@ -1217,4 +1644,32 @@ const static int s_maximumFractionDigits = 20;
   }
 }
 
+/**
+  Notifies the update callback and change observers that an input has been processed, unless a batch is in progress, in which case notification is deferred to the end of the batch.
+
+  @param keyPressed Whether the input was a key press.  The update callback is only run for key presses.
+ */
+- (void)notifyOfInputFromKeyPress:(BOOL)keyPressed {
+  if (_batchDepth > 0) {
+    _batchKeyPressed = _batchKeyPressed || keyPressed;
+    return;
+  }
+
+  // the clients may change the trace buffer, so finish on the one we started
+  EWCTraceBuffer *trace = _traceBuffer;
+  uint64_t start = EWCTraceBufferStart(trace);
+
+  if (keyPressed) {
+    [self safeCallback];
+  }
+
+  // iterate over a copy so that observers can unsubscribe while being notified
+  EWCCalculatorChange changes = _lastChanges;
+  for (EWCCalculatorObservation *observation in [_observers copy]) {
+    [observation notifyChanges:changes];
+  }
+
+  EWCTraceBufferFinish(trace, EWCTraceCallbackStage, start);
+}
+
 @end
@@ -0,0 +1,63 @@
+//
+//  EWCCalculatorChange.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+
+/**
+  `EWCCalculatorChange` identifies the client visible outputs of an `EWCCalculator` that were changed by an input, so that a client only needs to refresh the parts of its interface that depend on them.
+ */
+typedef NS_OPTIONS(NSUInteger, EWCCalculatorChange) {
+  EWCCalculatorNoChange = 0,
+  EWCCalculatorDisplayValueChange = 1 << 0,
+  EWCCalculatorFractionDigitsChange = 1 << 1,
+  EWCCalculatorErrorChange = 1 << 2,
+  EWCCalculatorMemoryChange = 1 << 3,
+  EWCCalculatorMemoryClearChange = 1 << 4,
+  EWCCalculatorTaxStatusChange = 1 << 5,
+  EWCCalculatorTaxPlusStatusChange = 1 << 6,
+  EWCCalculatorTaxMinusStatusChange = 1 << 7,
+  EWCCalculatorTaxPercentStatusChange = 1 << 8,
+  EWCCalculatorRateShiftChange = 1 << 9,
+
+  // the changes that affect the formatted display content
+  EWCCalculatorDisplayContentChanges = EWCCalculatorDisplayValueChange
+    | EWCCalculatorFractionDigitsChange,
+
+  // the changes to the status indicators
+  EWCCalculatorStatusChanges = EWCCalculatorErrorChange
+    | EWCCalculatorMemoryChange
+    | EWCCalculatorTaxStatusChange
+    | EWCCalculatorTaxPlusStatusChange
+    | EWCCalculatorTaxMinusStatusChange
+    | EWCCalculatorTaxPercentStatusChange,
+
+  EWCCalculatorAllChanges = EWCCalculatorDisplayContentChanges
+    | EWCCalculatorStatusChanges
+    | EWCCalculatorMemoryClearChange
+    | EWCCalculatorRateShiftChange,
+};
+
+/**
+  `EWCCalculatorChangeObserver` defines the notification signature used to tell a subscriber which calculator outputs have changed.
+
+  @param changes The changed outputs, restricted to those the subscriber registered for.
+ */
+typedef void(^EWCCalculatorChangeObserver)(EWCCalculatorChange changes);
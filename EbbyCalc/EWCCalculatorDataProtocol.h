@@ -38,6 +38,23 @@ NS_ASSUME_NONNULL_BEGIN
 */
 @property (nonatomic) NSDecimalNumber *memory;
 
+@optional
+
+/**
+  A count that advances whenever the stored values change.  Providers shared between calculators implement this, so that a calculator can tell that another instance has changed the values, and reread them before its next input.
+ */
+@property (nonatomic, readonly) uint64_t version;
+
+/**
+  Adds to the memory as a single update.  Providers shared between calculators implement this, so that memory add and subtract keys pressed at the same time on different calculators are all counted, rather than one replacing the other.
+
+  @param value The value to add (negative to subtract).
+  @param maximumDigits The number of digits the sum is restricted to, or 0 for no restriction.
+
+  @return The new memory, or nil if the sum doesn't fit within the maximum digits, in which case the memory is unchanged.
+ */
+- (nullable NSDecimalNumber *)addToMemory:(NSDecimalNumber *)value restrictedToDigits:(NSInteger)maximumDigits;
+
 @end
 
 NS_ASSUME_NONNULL_END
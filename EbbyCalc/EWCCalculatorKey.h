@@ -20,6 +20,7 @@
 //  along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #import <Foundation/Foundation.h>
+#import "EWCKeyMap.h"
 
 /**
   `EWCCalculatorKey` represents each of the keys of the `EWCCalculator`.
@@ -90,3 +91,30 @@ BOOL EWCCalculatorKeyIsDigit(EWCCalculatorKey key);
   @return The numeric value of the key, or -1 if the key is not a numeric key.
 */
 short EWCCalculatorDigitFromKey(EWCCalculatorKey key);
+
+/**
+  Gets the key represented by a character in the plain text key notation used by the command line tools.
+
+  The notation follows the hardware keyboard mappings (digits, `.`, `+`, `-`, `*`, `/`, `=`, `%`, `\` for sign, `y` for square root, `q` for rate, `w` for tax+, `e` for tax-, `a` for mrc, `s` for m+, `d` for m-), with `c` for clear and `<` for backspace, since those keys have no printable keyboard character.  Letters are not case sensitive.
+
+  @param c The character to interpret.
+
+  @return The key represented by the character, or `EWCCalculatorNoKey` if the character has no meaning.
+ */
+EWCCalculatorKey EWCCalculatorKeyFromCharacter(unichar c);
+
+/**
+  Gets the compiled map of the plain text key notation, for translating whole runs of text (such as pasted text or a tape) without going a character at a time.
+
+  @return The map, which is shared, and must not be modified.
+ */
+const EWCKeyMap *EWCCalculatorKeyNotationMap(void);
+
+/**
+  Gets the character that represents a key in the plain text key notation.
+
+  @param key The key to represent.
+
+  @return The character for the key, or 0 for `EWCCalculatorNoKey`.
+ */
+unichar EWCCalculatorCharacterFromKey(EWCCalculatorKey key);
@@ -77,3 +77,62 @@ short EWCCalculatorDigitFromKey(EWCCalculatorKey key) {
   return (key - EWCCalculatorZeroKey);
 }
 
+const EWCKeyMap *EWCCalculatorKeyNotationMap(void) {
+  static EWCKeyMap s_notation;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    // the notation is the inverse of the character for each key, with
+    // letters in either case
+    EWCKeyMapInit(&s_notation);
+    for (EWCCalculatorKey key = EWCCalculatorZeroKey; key <= EWCCalculatorBackspaceKey; ++key) {
+      unichar c = EWCCalculatorCharacterFromKey(key);
+      EWCKeyMapAdd(&s_notation, c, (int)key);
+      if (c >= 'a' && c <= 'z') {
+        EWCKeyMapAdd(&s_notation, c - 'a' + 'A', (int)key);
+      }
+    }
+
+    EWCKeyMapCompile(&s_notation);
+  });
+
+  return &s_notation;
+}
+
+EWCCalculatorKey EWCCalculatorKeyFromCharacter(unichar c) {
+  return (EWCCalculatorKey)EWCKeyMapLookup(EWCCalculatorKeyNotationMap(), c);
+}
+
+unichar EWCCalculatorCharacterFromKey(EWCCalculatorKey key) {
+  switch (key) {
+    case EWCCalculatorZeroKey: return '0';
+    case EWCCalculatorOneKey: return '1';
+    case EWCCalculatorTwoKey: return '2';
+    case EWCCalculatorThreeKey: return '3';
+    case EWCCalculatorFourKey: return '4';
+    case EWCCalculatorFiveKey: return '5';
+    case EWCCalculatorSixKey: return '6';
+    case EWCCalculatorSevenKey: return '7';
+    case EWCCalculatorEightKey: return '8';
+    case EWCCalculatorNineKey: return '9';
+    case EWCCalculatorClearKey: return 'c';
+    case EWCCalculatorRateKey: return 'q';
+    case EWCCalculatorTaxPlusKey: return 'w';
+    case EWCCalculatorTaxMinusKey: return 'e';
+    case EWCCalculatorMemoryKey: return 'a';
+    case EWCCalculatorMemoryPlusKey: return 's';
+    case EWCCalculatorMemoryMinusKey: return 'd';
+    case EWCCalculatorAddKey: return '+';
+    case EWCCalculatorSubtractKey: return '-';
+    case EWCCalculatorMultiplyKey: return '*';
+    case EWCCalculatorDivideKey: return '/';
+    case EWCCalculatorSignKey: return '\\';
+    case EWCCalculatorDecimalKey: return '.';
+    case EWCCalculatorPercentKey: return '%';
+    case EWCCalculatorSqrtKey: return 'y';
+    case EWCCalculatorEqualKey: return '=';
+    case EWCCalculatorBackspaceKey: return '<';
+
+    default:
+      return 0;
+  }
+}
@@ -0,0 +1,54 @@
+//
+//  EWCCalculatorMemoryData.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import "EWCCalculatorDataProtocol.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCCalculatorMemoryData` implements the `EWCCalculatorDataProtocol` protocol by simply holding the values, so that a calculator can be given starting memory and tax rate values without persisting them.
+ */
+@interface EWCCalculatorMemoryData : NSObject<EWCCalculatorDataProtocol>
+
+/**
+  Stores or reads the tax rate used for tax+ and tax- operations.
+ */
+@property (nonatomic) NSDecimalNumber *taxRate;
+
+/**
+  Stores or reads the single general purpose memory location.
+ */
+@property (nonatomic) NSDecimalNumber *memory;
+
+/**
+  Creates a new data instance holding the supplied values.
+
+  @param taxRate The starting tax rate.
+  @param memory The starting memory value.
+
+  @return The new instance.
+ */
++ (instancetype)dataWithTaxRate:(NSDecimalNumber *)taxRate memory:(NSDecimalNumber *)memory;
+
+@end
+
+NS_ASSUME_NONNULL_END
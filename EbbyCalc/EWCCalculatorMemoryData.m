@@ -0,0 +1,49 @@
+//
+//  EWCCalculatorMemoryData.m
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCCalculatorMemoryData.h"
+
+@implementation EWCCalculatorMemoryData
+
++ (instancetype)dataWithTaxRate:(NSDecimalNumber *)taxRate memory:(NSDecimalNumber *)memory {
+  EWCCalculatorMemoryData *data = [EWCCalculatorMemoryData new];
+  data.taxRate = taxRate;
+  data.memory = memory;
+
+  return data;
+}
+
+/**
+  Implementation of the empty init method.  Starts with no tax rate or memory.
+
+  @return The initialized instance.
+ */
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _taxRate = [NSDecimalNumber zero];
+    _memory = [NSDecimalNumber zero];
+  }
+
+  return self;
+}
+
+@end
@@ -0,0 +1,73 @@
+//
+//  EWCCalculatorObservation.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import "EWCCalculatorChange.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCCalculatorObservation` records a single subscription to calculator changes.  Instances are handed back to the subscriber as the token used to unsubscribe.
+ */
+@interface EWCCalculatorObservation : NSObject
+
+/**
+  The outputs the subscriber wants to be told about.
+ */
+@property (nonatomic, readonly) EWCCalculatorChange changes;
+
+/**
+  The block to run when any of the subscribed outputs change.
+ */
+@property (nonatomic, readonly) EWCCalculatorChangeObserver block;
+
+/**
+  Creates a new observation record.
+
+  @param changes The outputs to observe.
+  @param block The block to run when the outputs change.
+
+  @return The new observation record.
+ */
++ (instancetype)observationForChanges:(EWCCalculatorChange)changes
+  usingBlock:(EWCCalculatorChangeObserver)block;
+
+/**
+  Initializes a new observation record.
+
+  @param changes The outputs to observe.
+  @param block The block to run when the outputs change.
+
+  @return The initialized observation record.
+ */
+- (instancetype)initWithChanges:(EWCCalculatorChange)changes
+  block:(EWCCalculatorChangeObserver)block;
+
+/**
+  Runs the observer block if any of the supplied changes are of interest.
+
+  @param changes The outputs that changed.
+ */
+- (void)notifyChanges:(EWCCalculatorChange)changes;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,59 @@
+//
+//  EWCCalculatorObservation.m
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCCalculatorObservation.h"
+
+@implementation EWCCalculatorObservation
+
+///-------------------------------------
+/// @name Constructors and Initializers.
+///-------------------------------------
+
++ (instancetype)observationForChanges:(EWCCalculatorChange)changes
+  usingBlock:(EWCCalculatorChangeObserver)block {
+  return [[EWCCalculatorObservation alloc] initWithChanges:changes block:block];
+}
+
+- (instancetype)initWithChanges:(EWCCalculatorChange)changes
+  block:(EWCCalculatorChangeObserver)block {
+  self = [super init];
+  if (self) {
+    _changes = changes;
+
+    // copy the block, in case it was stack allocated
+    _block = [block copy];
+  }
+
+  return self;
+}
+
+///---------------------------------------------------------------
+/// @name Public Properties and Methods (documented in the header)
+///---------------------------------------------------------------
+
+- (void)notifyChanges:(EWCCalculatorChange)changes {
+  EWCCalculatorChange relevant = changes & _changes;
+  if (relevant) {
+    _block(relevant);
+  }
+}
+
+@end
@@ -0,0 +1,112 @@
+//
+//  EWCCalculatorPool.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+
+@class EWCCalculator;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCCalculatorPool` hands out calculators in their initial state, reusing calculators that have been returned to it rather than allocating new ones.
+
+  Every calculator from a pool is configured with the same locale and digit limit, so a reused calculator keeps its display formatter.  Returned calculators are reset in place, which only reinitializes their inline state.  The pool is not thread safe.
+ */
+@interface EWCCalculatorPool : NSObject
+
+///-----------------
+/// @name Properties
+///-----------------
+
+/**
+  The locale that the pooled calculators format their display for.
+ */
+@property (nonatomic, readonly) NSLocale *locale;
+
+/**
+  The digit limit of the pooled calculators.
+ */
+@property (nonatomic, readonly) NSInteger maximumDigits;
+
+/**
+  The maximum number of idle calculators kept in the pool.  Calculators returned beyond this are discarded.
+ */
+@property (nonatomic) NSUInteger maximumSize;
+
+/**
+  The number of idle calculators in the pool.
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+///------------------------------------------
+/// @name Creation and Initialization Methods
+///------------------------------------------
+
+/**
+  Creates a new empty pool.
+
+  @param locale The locale that calculators from the pool format their display for.
+  @param maximumDigits The digit limit of calculators from the pool.
+
+  @return The new pool.
+ */
++ (instancetype)poolWithLocale:(NSLocale *)locale maximumDigits:(NSInteger)maximumDigits;
+
+/**
+  Initializes a new empty pool.
+
+  @param locale The locale that calculators from the pool format their display for.
+  @param maximumDigits The digit limit of calculators from the pool.
+
+  @return The initialized pool.
+ */
+- (instancetype)initWithLocale:(NSLocale *)locale maximumDigits:(NSInteger)maximumDigits;
+
+///----------------------
+/// @name Pooling Methods
+///----------------------
+
+/**
+  Takes a calculator from the pool, or creates a new one if the pool is empty.
+
+  @return A calculator in its initial state.
+ */
+- (EWCCalculator *)acquireCalculator;
+
+/**
+  Resets a calculator and returns it to the pool, if there is room.
+
+  @note The caller should not keep using the calculator, and should remove any observers or callback it registered before returning it.
+
+  @param calculator The calculator no longer in use.  It must have come from this pool.
+ */
+- (void)releaseCalculator:(EWCCalculator *)calculator;
+
+/**
+  Creates calculators until the pool holds the requested number, so that they don't need to be created later.
+
+  @param count The number of idle calculators to hold, limited to the maximum size.
+ */
+- (void)preallocate:(NSUInteger)count;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,118 @@
+//
+//  EWCCalculatorPool.m
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCCalculatorPool.h"
+#import "EWCCalculator.h"
+
+// the default number of idle calculators to keep for reuse
+static const NSUInteger s_defaultMaximumSize = 1024;
+
+@interface EWCCalculatorPool () {
+  NSMutableArray<EWCCalculator *> *_pool;  // idle calculators ready for reuse
+}
+
+@end
+
+@implementation EWCCalculatorPool
+
+///----------------------------------------------
+/// @name Construction and Initialization Methods
+///----------------------------------------------
+
++ (instancetype)poolWithLocale:(NSLocale *)locale maximumDigits:(NSInteger)maximumDigits {
+  return [[EWCCalculatorPool alloc] initWithLocale:locale maximumDigits:maximumDigits];
+}
+
+- (instancetype)initWithLocale:(NSLocale *)locale maximumDigits:(NSInteger)maximumDigits {
+  self = [super init];
+  if (self) {
+    _locale = [locale copy];
+    _maximumDigits = maximumDigits;
+    _maximumSize = s_defaultMaximumSize;
+    _pool = [NSMutableArray new];
+  }
+
+  return self;
+}
+
+///------------------------------
+/// @name Custom Property Methods
+///------------------------------
+
+- (NSUInteger)count {
+  return _pool.count;
+}
+
+- (void)setMaximumSize:(NSUInteger)maximumSize {
+  _maximumSize = maximumSize;
+
+  // drop any idle calculators that no longer fit
+  if (_pool.count > maximumSize) {
+    [_pool removeObjectsInRange:NSMakeRange(maximumSize, _pool.count - maximumSize)];
+  }
+}
+
+///---------------------------------------------------------------
+/// @name Public Properties and Methods (documented in the header)
+///---------------------------------------------------------------
+
+- (EWCCalculator *)acquireCalculator {
+  EWCCalculator *calculator = _pool.lastObject;
+  if (calculator) {
+    [_pool removeLastObject];
+    return calculator;
+  }
+
+  return [self newCalculator];
+}
+
+- (void)releaseCalculator:(EWCCalculator *)calculator {
+  if (_pool.count < _maximumSize) {
+    [calculator reset];
+    [_pool addObject:calculator];
+  }
+}
+
+- (void)preallocate:(NSUInteger)count {
+  count = MIN(count, _maximumSize);
+  while (_pool.count < count) {
+    [_pool addObject:[self newCalculator]];
+  }
+}
+
+///----------------------------
+/// @name Other Utility Methods
+///----------------------------
+
+/**
+  Creates a calculator configured for the pool.
+
+  @return The new calculator.
+ */
+- (EWCCalculator *)newCalculator {
+  EWCCalculator *calculator = [EWCCalculator calculator];
+  calculator.locale = _locale;
+  calculator.maximumDigits = _maximumDigits;
+
+  return calculator;
+}
+
+@end
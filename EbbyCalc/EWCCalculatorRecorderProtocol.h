@@ -0,0 +1,52 @@
+//
+//  EWCCalculatorRecorderProtocol.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import "EWCCalculatorKey.h"
+
+@class EWCCalculator;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCCalculatorRecorderProtocol` provides methods the `EWCCalculator` uses to report each input it has processed, so that the inputs can be recorded.
+ */
+@protocol EWCCalculatorRecorderProtocol <NSObject>
+
+/**
+  Reports that a key has been pressed and processed.
+
+  @param calculator The calculator that processed the key.
+  @param key The key that was pressed.
+ */
+- (void)calculator:(EWCCalculator *)calculator didPressKey:(EWCCalculatorKey)key;
+
+/**
+  Reports that the input has been explicitly set.
+
+  @param calculator The calculator whose input was set.
+  @param value The value that was set.
+ */
+- (void)calculator:(EWCCalculator *)calculator didSetInput:(NSDecimalNumber *)value;
+
+@end
+
+NS_ASSUME_NONNULL_END
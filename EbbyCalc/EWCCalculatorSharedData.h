@@ -0,0 +1,114 @@
+//
+//  EWCCalculatorSharedData.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import "EWCCalculatorDataProtocol.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  Posted on the main queue after the values held by an `EWCCalculatorSharedData` change.  The object is the shared data, and the user info holds the new version under `EWCCalculatorSharedDataVersionKey`.
+ */
+extern NSNotificationName const EWCCalculatorSharedDataDidChangeNotification;
+
+/**
+  The user info key of the version (an `NSNumber`) in an `EWCCalculatorSharedDataDidChangeNotification`.
+ */
+extern NSString * const EWCCalculatorSharedDataVersionKey;
+
+/**
+  `EWCCalculatorSharedData` holds the tax rate and memory once for every calculator in the process, so that calculators in separate windows (or sessions) stay coherent.
+
+  The values are published with a sequence counter, so they can be read from any thread without taking a lock.  A reader that overlaps with a write retries.  Writes are serialized on a private queue, advance the version, and post `EWCCalculatorSharedDataDidChangeNotification`.  Setting a value that is already held changes nothing.  Memory add and subtract go through `addToMemory:restrictedToDigits:`, which reads and writes the memory in one step on the queue, so that none are lost when calculators press them at the same time.
+
+  Changes are written to a backing store in batches: the first change after a flush schedules the next one, after a delay, and only the values that changed are written.
+ */
+@interface EWCCalculatorSharedData : NSObject<EWCCalculatorDataProtocol>
+
+/**
+  The tax rate for tax add and deduct calculations.
+ */
+@property (nonatomic) NSDecimalNumber *taxRate;
+
+/**
+  The single general-purpose memory value.
+ */
+@property (nonatomic) NSDecimalNumber *memory;
+
+/**
+  The number of changes made to the values.
+ */
+@property (nonatomic, readonly) uint64_t version;
+
+/**
+  Adds to the memory on the write queue, so that the read and the write can't be split by another change.
+
+  @param value The value to add (negative to subtract).
+  @param maximumDigits The number of digits the sum is restricted to, or 0 for no restriction.
+
+  @return The new memory, or nil if the sum doesn't fit within the maximum digits, in which case the memory is unchanged.
+ */
+- (nullable NSDecimalNumber *)addToMemory:(NSDecimalNumber *)value restrictedToDigits:(NSInteger)maximumDigits;
+
+/**
+  The data shared by the app's calculators, backed by the user defaults.
+
+  @return The shared instance.
+ */
++ (instancetype)sharedData;
+
+/**
+  Creates shared data over a backing store.
+
+  @param store The store to read the starting values from, and to write changes to.
+  @param flushDelay How long after a change the batched changes are written to the store.
+
+  @return The new shared data.
+ */
++ (instancetype)dataWithBackingStore:(id<EWCCalculatorDataProtocol>)store
+  flushDelay:(NSTimeInterval)flushDelay;
+
+/**
+  Initializes shared data over a backing store.  The store is read once, here.
+
+  @param store The store to read the starting values from, and to write changes to.
+  @param flushDelay How long after a change the batched changes are written to the store.
+
+  @return The initialized shared data.
+ */
+- (instancetype)initWithBackingStore:(id<EWCCalculatorDataProtocol>)store
+  flushDelay:(NSTimeInterval)flushDelay NS_DESIGNATED_INITIALIZER;
+
+/**
+  Initializes shared data over an in-memory store, starting with no tax rate or memory.
+
+  @return The initialized shared data.
+ */
+- (instancetype)init;
+
+/**
+  Writes any changes not yet written to the backing store, without waiting for the scheduled flush.
+ */
+- (void)flush;
+
+@end
+
+NS_ASSUME_NONNULL_END
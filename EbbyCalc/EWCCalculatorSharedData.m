@@ -0,0 +1,292 @@
+//
+//  EWCCalculatorSharedData.m
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCCalculatorSharedData.h"
+#import "EWCCalculatorMemoryData.h"
+#import "EWCCalculatorUserDefaultsData.h"
+#import "NSDecimalNumber+EWCMathCategory.h"
+#import <stdatomic.h>
+
+NSNotificationName const EWCCalculatorSharedDataDidChangeNotification = @"EWCCalculatorSharedDataDidChangeNotification";
+NSString * const EWCCalculatorSharedDataVersionKey = @"EWCCalculatorSharedDataVersionKey";
+
+// how long the app's shared data waits to write changes to the user defaults
+static const NSTimeInterval s_defaultFlushDelay = 1.0;
+
+/**
+  `EWCSharedDataValues` holds the published values, along with the sequence counter that lets a reader detect that they were rewritten while being copied.  The counter is odd while a write is in progress, and half of it is the version.
+ */
+typedef struct {
+  _Atomic(uint64_t) sequence;  // incremented before and after each write
+  NSDecimal taxRate;  // the published tax rate
+  NSDecimal memory;  // the published memory
+} EWCSharedDataValues;
+
+@interface EWCCalculatorSharedData () {
+  id<EWCCalculatorDataProtocol> _store;  // the backing store, only accessed on the queue
+  NSTimeInterval _flushDelay;  // how long after a change the store is written
+  dispatch_queue_t _queue;  // serializes writes, and the writes to the store
+
+  EWCSharedDataValues _values;  // the published values
+  BOOL _taxRateDirty;  // whether the tax rate changed since the last flush, only accessed on the queue
+  BOOL _memoryDirty;  // whether the memory changed since the last flush, only accessed on the queue
+  BOOL _flushScheduled;  // whether a flush is pending, only accessed on the queue
+}
+
+@end
+
+@implementation EWCCalculatorSharedData
+
+///----------------------------------------------
+/// @name Construction and Initialization Methods
+///----------------------------------------------
+
++ (instancetype)sharedData {
+  static EWCCalculatorSharedData *s_sharedData;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    s_sharedData = [[EWCCalculatorSharedData alloc]
+      initWithBackingStore:[EWCCalculatorUserDefaultsData new]
+      flushDelay:s_defaultFlushDelay];
+  });
+
+  return s_sharedData;
+}
+
++ (instancetype)dataWithBackingStore:(id<EWCCalculatorDataProtocol>)store
+  flushDelay:(NSTimeInterval)flushDelay {
+  return [[EWCCalculatorSharedData alloc] initWithBackingStore:store flushDelay:flushDelay];
+}
+
+- (instancetype)init {
+  return [self initWithBackingStore:[EWCCalculatorMemoryData new] flushDelay:s_defaultFlushDelay];
+}
+
+- (instancetype)initWithBackingStore:(id<EWCCalculatorDataProtocol>)store
+  flushDelay:(NSTimeInterval)flushDelay {
+  self = [super init];
+  if (self) {
+    _store = store;
+    _flushDelay = flushDelay;
+    _queue = dispatch_queue_create("com.anselrognlie.EbbyCalc.shareddata", DISPATCH_QUEUE_SERIAL);
+
+    // nothing else can see the instance yet, so publish directly
+    atomic_init(&_values.sequence, 0);
+    _values.taxRate = store.taxRate.decimalValue;
+    _values.memory = store.memory.decimalValue;
+  }
+
+  return self;
+}
+
+- (void)dealloc {
+  // nothing else can reach the instance now, so write what's pending directly
+  [self writeStore];
+}
+
+///------------------------------
+/// @name Custom Property Methods
+///------------------------------
+
+- (NSDecimalNumber *)taxRate {
+  NSDecimal taxRate, memory;
+  [self readTaxRate:&taxRate memory:&memory];
+
+  return [NSDecimalNumber decimalNumberWithDecimal:taxRate];
+}
+
+- (void)setTaxRate:(NSDecimalNumber *)value {
+  NSDecimal taxRate = value.decimalValue;
+  [self writeValues:^BOOL(EWCSharedDataValues *values) {
+    if (NSDecimalCompare(&values->taxRate, &taxRate) == NSOrderedSame) {
+      return NO;
+    }
+    values->taxRate = taxRate;
+    self->_taxRateDirty = YES;
+    return YES;
+  }];
+}
+
+- (NSDecimalNumber *)memory {
+  NSDecimal taxRate, memory;
+  [self readTaxRate:&taxRate memory:&memory];
+
+  return [NSDecimalNumber decimalNumberWithDecimal:memory];
+}
+
+- (void)setMemory:(NSDecimalNumber *)value {
+  NSDecimal memory = value.decimalValue;
+  [self writeValues:^BOOL(EWCSharedDataValues *values) {
+    if (NSDecimalCompare(&values->memory, &memory) == NSOrderedSame) {
+      return NO;
+    }
+    values->memory = memory;
+    self->_memoryDirty = YES;
+    return YES;
+  }];
+}
+
+- (uint64_t)version {
+  return atomic_load_explicit(&_values.sequence, memory_order_acquire) / 2;
+}
+
+///---------------------------------------------------------------
+/// @name Public Properties and Methods (documented in the header)
+///---------------------------------------------------------------
+
+- (NSDecimalNumber *)addToMemory:(NSDecimalNumber *)value restrictedToDigits:(NSInteger)maximumDigits {
+  __block NSDecimalNumber *result = nil;
+  [self writeValues:^BOOL(EWCSharedDataValues *values) {
+    NSDecimalNumber *sum = [[NSDecimalNumber decimalNumberWithDecimal:values->memory] decimalNumberByAdding:value];
+    result = [sum ewc_decimalNumberByRestrictingToDigits:(unsigned short)maximumDigits];
+    if (! result) {
+      return NO;
+    }
+
+    NSDecimal memory = result.decimalValue;
+    if (NSDecimalCompare(&values->memory, &memory) == NSOrderedSame) {
+      return NO;
+    }
+    values->memory = memory;
+    self->_memoryDirty = YES;
+    return YES;
+  }];
+
+  return result;
+}
+
+- (void)flush {
+  dispatch_sync(_queue, ^{
+    [self writeStore];
+  });
+}
+
+///-------------------------------
+/// @name Value Publishing Methods
+///-------------------------------
+
+/**
+  Copies the published values.  This never blocks, and may be called from any thread.
+
+  @param taxRate Receives the tax rate.
+  @param memory Receives the memory.
+ */
+- (void)readTaxRate:(NSDecimal *)taxRate memory:(NSDecimal *)memory {
+  for (;;) {
+    uint64_t before = atomic_load_explicit(&_values.sequence, memory_order_acquire);
+    if (before & 1) {
+      // a write is in progress
+      continue;
+    }
+
+    *taxRate = _values.taxRate;
+    *memory = _values.memory;
+
+    atomic_thread_fence(memory_order_acquire);
+    uint64_t after = atomic_load_explicit(&_values.sequence, memory_order_relaxed);
+    if (before == after) {
+      return;
+    }
+  }
+}
+
+/**
+  Changes the published values on the queue, and if they changed, advances the version, schedules a flush, and posts the change notification.
+
+  @param update A block that changes the values (it has exclusive access to them), and returns whether anything changed.
+ */
+- (void)writeValues:(BOOL (^)(EWCSharedDataValues *values))update {
+  __block uint64_t version = 0;
+
+  dispatch_sync(_queue, ^{
+    // work on a copy, so that readers never see a change that turns out to
+    // be a no-op
+    EWCSharedDataValues *values = &self->_values;
+    EWCSharedDataValues changed;
+    changed.taxRate = values->taxRate;
+    changed.memory = values->memory;
+    if (! update(&changed)) {
+      return;
+    }
+
+    uint64_t sequence = atomic_load_explicit(&values->sequence, memory_order_relaxed);
+    atomic_store_explicit(&values->sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    values->taxRate = changed.taxRate;
+    values->memory = changed.memory;
+
+    atomic_store_explicit(&values->sequence, sequence + 2, memory_order_release);
+    version = (sequence + 2) / 2;
+
+    [self scheduleFlush];
+  });
+
+  if (version == 0) {
+    return;
+  }
+
+  dispatch_async(dispatch_get_main_queue(), ^{
+    [[NSNotificationCenter defaultCenter]
+      postNotificationName:EWCCalculatorSharedDataDidChangeNotification
+      object:self
+      userInfo:@{ EWCCalculatorSharedDataVersionKey: @(version) }];
+  });
+}
+
+///----------------------------
+/// @name Backing Store Methods
+///----------------------------
+
+/**
+  Schedules a write of the changes to the store, unless one is already pending.  Must be called on the queue.
+ */
+- (void)scheduleFlush {
+  if (_flushScheduled) {
+    return;
+  }
+
+  _flushScheduled = YES;
+
+  __weak EWCCalculatorSharedData *weakSelf = self;
+  dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(_flushDelay * NSEC_PER_SEC)), _queue, ^{
+    [weakSelf writeStore];
+  });
+}
+
+/**
+  Writes the values that changed since the last write to the store.  Must be called on the queue (or once nothing else can reach the instance).
+ */
+- (void)writeStore {
+  _flushScheduled = NO;
+
+  if (_taxRateDirty) {
+    _store.taxRate = [NSDecimalNumber decimalNumberWithDecimal:_values.taxRate];
+    _taxRateDirty = NO;
+  }
+
+  if (_memoryDirty) {
+    _store.memory = [NSDecimalNumber decimalNumberWithDecimal:_values.memory];
+    _memoryDirty = NO;
+  }
+}
+
+@end
@@ -0,0 +1,314 @@
+//
+//  EWCCalculatorState.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import "EWCCalculatorKey.h"
+#import "EWCCalculatorOpcode.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  The most tokens the operation queue can hold.  The queue is parsed after every enqueue, and back to back operators or data replace each other, so a pending operation never needs more than a few tokens.
+ */
+#define EWCCalculatorTokenQueueCapacity 8
+
+/**
+  The layout version of `EWCCalculatorState`, for states saved outside of the process (as in a session slab).  Increase it whenever the layout of the state changes.
+ */
+#define EWCCalculatorStateVersion 1
+
+/**
+  `EWCCalculatorTokenType` categorizes the type of data stored in a `EWCCalculatorToken`.
+ */
+typedef NS_ENUM(NSInteger, EWCCalculatorTokenType) {
+  EWCCalculatorEmptyTokenType = 0,
+  EWCCalculatorBinOpTokenType,
+  EWCCalculatorDataTokenType,
+  EWCCalculatorEqualTokenType,
+};
+
+/**
+  `EWCCalculatorInputMode` tracks whether the input state is receiving digits that are part of the whole number, or the fraction.
+ */
+typedef NS_ENUM(NSInteger, EWCCalculatorInputMode) {
+  EWCCalculatorInputModeWhole = 1,
+  EWCCalculatorInputModeFraction,
+};
+
+/**
+  `EWCCalculatorField` represents a storage area in the calculator for a numeric value.  If the field is empty, the value must be ignored (it is held at zero).
+ */
+typedef struct {
+  NSDecimal value;  // the data value stored in the field
+  BOOL empty;  // whether the field is empty
+} EWCCalculatorField;
+
+/**
+  `EWCCalculatorToken` represents an input in the calculator's operation queue.
+ */
+typedef struct {
+  NSDecimal data;  // the numeric value for a token holding data
+  EWCCalculatorOpcode opcode;  // the opcode for a token holding a binary or equal operation
+  EWCCalculatorTokenType tokenType;  // the type of token content
+} EWCCalculatorToken;
+
+/**
+  `EWCCalculatorTokenQueue` is the queue of tokens the calculator uses to detect valid calculations, held inline as a fixed size array.
+ */
+typedef struct {
+  EWCCalculatorToken tokens[EWCCalculatorTokenQueueCapacity];  // the queued tokens, front first
+  short count;  // the number of tokens in the queue
+  short ip;  // an instruction pointer for looking into the queue.  used for cleaning up tokens we have used
+  BOOL didChange;  // whether the queue has changed since it was last inspected for tokens
+  BOOL hasError;  // whether an enqueue operation has put the queue into an error state
+} EWCCalculatorTokenQueue;
+
+/**
+  `EWCCalculatorInput` holds the state of a decimal value being built up from input keys.
+ */
+typedef struct {
+  NSDecimal value;  // the decimal value being built up through user interactions
+  EWCCalculatorInputMode inputMode;  // track whether input digits are for the whole or fractional part of a number
+  short fractionPower;  // power of the fractional digit being added.  ranges from 0 to more negative values
+  short sign;  // the sign of the number being built up
+  short numDigits;  // the number of digits accumulated in the input
+  BOOL editing;  // NO when user hasn't contributed to input yet
+} EWCCalculatorInput;
+
+/**
+  `EWCCalculatorState` is the complete engine state of a calculator, as one contiguous plain struct with its values held inline, so that a calculator needs no allocations beyond itself and can be reset by reinitializing the struct.
+ */
+typedef struct {
+  EWCCalculatorField accumulator;  // stores the results of the last calculation
+  EWCCalculatorField display;  // stores the value displayed to the client
+  EWCCalculatorField taxRate;  // stores the tax rate
+  EWCCalculatorField memory;  // stores the general memory value
+  EWCCalculatorField operand;  // stores the last operand for binary operations
+  NSDecimal taxResultWithTax;  // cache the last tax calculation that includes tax
+  NSDecimal taxResultJustTax;  // cache the tax from the last tax calculation
+  EWCCalculatorInput input;  // builds up a decimal value from input keys
+  EWCCalculatorTokenQueue queue;  // queue of tokens to be interpreted as calculator operations
+  EWCCalculatorOpcode operation;  // stores the last operation
+  EWCCalculatorKey lastKey;  // the last key pressed
+  BOOL error;  // whether the calculator is in an error state
+  BOOL rateShifted;  // whether the rate key has shifted the tax keys
+  BOOL showingJustTax;  // whether the display is showing the tax portion of a tax calculation
+  BOOL displayAvailable;  // whether the value held in the display should be considered available for a calculation
+  BOOL taxStatusVisible;  // whether the tax status indicator is on
+  BOOL taxPlusStatusVisible;  // whether the tax plus status indicator is on
+  BOOL taxMinusStatusVisible;  // whether the tax minus status indicator is on
+  BOOL taxPercentStatusVisible;  // whether the tax percent status indicator is on
+} EWCCalculatorState;
+
+///--------------------------
+/// @name Whole State Methods
+///--------------------------
+
+/**
+  Puts the state into its initial configuration, with every field empty, no pending operation, and no status.
+
+  @param state The state to reset.
+ */
+void EWCCalculatorStateReset(EWCCalculatorState *state);
+
+/**
+  Gets a zero value.  Unlike a zero filled `NSDecimal`, this is zero on every Foundation implementation.
+
+  @return A zero value.
+ */
+NSDecimal EWCCalculatorDecimalZero(void);
+
+///--------------------
+/// @name Field Methods
+///--------------------
+
+/**
+  Clears the field, rendering it empty.
+
+  @param field The field to clear.
+ */
+void EWCCalculatorFieldClear(EWCCalculatorField *field);
+
+/**
+  Stores a value in the field.
+
+  @param field The field to store into.
+  @param value The value to store.
+ */
+void EWCCalculatorFieldSet(EWCCalculatorField *field, NSDecimal value);
+
+///--------------------------
+/// @name Token Queue Methods
+///--------------------------
+
+/**
+  Resets the queue to an empty state.
+
+  @param queue The queue to clear.
+ */
+void EWCCalculatorTokenQueueClear(EWCCalculatorTokenQueue *queue);
+
+/**
+  Commits the token parsing that has occurred.
+
+  This fully removes the tokens that have been traversed by the instruction pointer from the queue, and resets the instruction pointer to zero.
+
+  @note After calling this method, any token that was used in the last parse can no longer be pushed back into the queue, and pointers to tokens returned during the parse are no longer valid.
+
+  @param queue The queue to commit.
+ */
+void EWCCalculatorTokenQueueCommit(EWCCalculatorTokenQueue *queue);
+
+/**
+  Ensures that the queue is configured with the next token being the front of the queue.
+
+  @param queue The queue to rewind.
+ */
+void EWCCalculatorTokenQueueMoveToFirst(EWCCalculatorTokenQueue *queue);
+
+/**
+  Gets whether there was a change to the queue since the last time this was checked.
+
+  @param queue The queue to check.
+
+  @return YES if the queue changed since the last check.
+ */
+BOOL EWCCalculatorTokenQueueTakeDidChange(EWCCalculatorTokenQueue *queue);
+
+/**
+  Gets the next token in the queue as long as it matches the requested type.
+
+  If a token is returned, as with `EWCCalculatorTokenQueueNextToken`, the instruction pointer is advanced.  The token may still be pushed back into the queue until the parse is committed.
+
+  @param queue The queue to read.
+  @param tokenType The type of the token to retrieve, if present.
+
+  @return The next token in the queue, if it matches the requested type.  Returns NULL if there is no token, or the type does not match.
+ */
+const EWCCalculatorToken * _Nullable EWCCalculatorTokenQueueNextTokenAs(EWCCalculatorTokenQueue *queue, EWCCalculatorTokenType tokenType);
+
+/**
+  Returns the next token in the queue, auto-advancing the instruction pointer to the next token in the process.
+
+  @param queue The queue to read.
+
+  @return The token at the current instruction pointer, or NULL if there are no more tokens.
+ */
+const EWCCalculatorToken * _Nullable EWCCalculatorTokenQueueNextToken(EWCCalculatorTokenQueue *queue);
+
+/**
+  Removes the token at the current instruction pointer from the queue entirely.
+
+  Primarily useful when removing part of a parse that is effectively a no-op, or a non-error invalid operation, while leaving the operators alone.
+
+  @param queue The queue to remove from.
+
+  @return YES if a token was removed, or NO if the instruction pointer is at the end of the queue.
+ */
+BOOL EWCCalculatorTokenQueuePopToken(EWCCalculatorTokenQueue *queue);
+
+/**
+  Prior to committing a parse, this will "pushback" the last read by moving the instruction pointer towards the front of the queue.
+
+  @param queue The queue to push back into.
+ */
+void EWCCalculatorTokenQueuePushbackToken(EWCCalculatorTokenQueue *queue);
+
+/**
+  Adds a binary operator to the queue.  If the last item in the queue is already a binary operator, it is overwritten.
+
+  @param queue The queue to add to.
+  @param op The type of binary operator to add.
+ */
+void EWCCalculatorTokenQueueEnqueueBinOp(EWCCalculatorTokenQueue *queue, EWCCalculatorOpcode op);
+
+/**
+  Adds an equal operator to the queue.  Adding an equal operator when the last item is already one puts the queue into an error state.
+
+  @param queue The queue to add to.
+  @param op The type of equal operation (equal or percent) to add.
+ */
+void EWCCalculatorTokenQueueEnqueueEqual(EWCCalculatorTokenQueue *queue, EWCCalculatorOpcode op);
+
+/**
+  Adds data to the queue.  If the last item in the queue is already data, it is overwritten.
+
+  @param queue The queue to add to.
+  @param data The data value to add.
+ */
+void EWCCalculatorTokenQueueEnqueueData(EWCCalculatorTokenQueue *queue, NSDecimal data);
+
+/**
+  Gets the final token from the end of the queue.
+
+  @param queue The queue to read.
+
+  @return The token at the end of the queue, or NULL if empty.
+ */
+const EWCCalculatorToken * _Nullable EWCCalculatorTokenQueueLastToken(const EWCCalculatorTokenQueue *queue);
+
+/**
+  Removes the final token from the end of the queue.
+
+  @param queue The queue to remove from.
+ */
+void EWCCalculatorTokenQueueRemoveLastToken(EWCCalculatorTokenQueue *queue);
+
+///--------------------
+/// @name Input Methods
+///--------------------
+
+/**
+  Clears the input to an empty state holding zero.
+
+  @param input The input to clear.
+ */
+void EWCCalculatorInputClear(EWCCalculatorInput *input);
+
+/**
+  Sets the value of the input, so that a subsequent sign change applies to it.  This also clears the edit state.
+
+  @param input The input to set.
+  @param value The value to hold.
+ */
+void EWCCalculatorInputSetValue(EWCCalculatorInput *input, NSDecimal value);
+
+/**
+  Gets the number of fractional digits that have been input.
+
+  @param input The input to inspect.
+
+  @return The number of fractional digits input.
+ */
+short EWCCalculatorInputFractionalDigitCount(const EWCCalculatorInput *input);
+
+/**
+  Processes a key that contributes to building up a number (digits, sign, decimal, and backspace).
+
+  @param input The input to update.
+  @param key The key to process.
+  @param maximumDigits The maximum digits allowed to be input, or 0 for no limit.
+
+  @return YES if the key was handled, otherwise NO, in which case the input is no longer being edited.
+ */
+BOOL EWCCalculatorInputProcessKey(EWCCalculatorInput *input, EWCCalculatorKey key, NSInteger maximumDigits);
+
+NS_ASSUME_NONNULL_END
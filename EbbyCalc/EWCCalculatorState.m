@@ -0,0 +1,439 @@
+//
+//  EWCCalculatorState.m
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCCalculatorState.h"
+
+NSDecimal EWCCalculatorDecimalZero(void) {
+  // the zero singleton, so this doesn't allocate
+  return [NSDecimalNumber zero].decimalValue;
+}
+
+/**
+  Gets the value of a single decimal digit.
+
+  @param digit The digit, from 0 to 9.
+
+  @return The digit value.
+ */
+static NSDecimal EWCCalculatorDecimalDigit(short digit) {
+  static NSDecimal s_digits[10];
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    for (short i = 0; i < 10; ++i) {
+      s_digits[i] = [NSNumber numberWithShort:i].decimalValue;
+    }
+  });
+
+  return s_digits[digit];
+}
+
+///--------------------------
+/// @name Whole State Methods
+///--------------------------
+
+void EWCCalculatorStateReset(EWCCalculatorState *state) {
+  NSDecimal zero = EWCCalculatorDecimalZero();
+
+  EWCCalculatorFieldClear(&state->accumulator);
+  EWCCalculatorFieldClear(&state->display);
+  EWCCalculatorFieldClear(&state->taxRate);
+  EWCCalculatorFieldClear(&state->memory);
+  EWCCalculatorFieldClear(&state->operand);
+  state->taxResultWithTax = zero;
+  state->taxResultJustTax = zero;
+
+  EWCCalculatorInputClear(&state->input);
+  EWCCalculatorTokenQueueClear(&state->queue);
+  state->queue.didChange = NO;
+
+  state->operation = EWCCalculatorNoOpcode;
+  state->lastKey = EWCCalculatorNoKey;
+
+  state->error = NO;
+  state->rateShifted = NO;
+  state->showingJustTax = NO;
+  state->displayAvailable = NO;
+  state->taxStatusVisible = NO;
+  state->taxPlusStatusVisible = NO;
+  state->taxMinusStatusVisible = NO;
+  state->taxPercentStatusVisible = NO;
+}
+
+///--------------------
+/// @name Field Methods
+///--------------------
+
+void EWCCalculatorFieldClear(EWCCalculatorField *field) {
+  field->value = EWCCalculatorDecimalZero();
+  field->empty = YES;
+}
+
+void EWCCalculatorFieldSet(EWCCalculatorField *field, NSDecimal value) {
+  field->value = value;
+  field->empty = NO;
+}
+
+///--------------------------
+/// @name Token Queue Methods
+///--------------------------
+
+void EWCCalculatorTokenQueueClear(EWCCalculatorTokenQueue *queue) {
+  queue->count = 0;
+  queue->ip = 0;
+  queue->hasError = NO;
+}
+
+void EWCCalculatorTokenQueueCommit(EWCCalculatorTokenQueue *queue) {
+  short remaining = queue->count - queue->ip;
+  memmove(&queue->tokens[0], &queue->tokens[queue->ip], remaining * sizeof(EWCCalculatorToken));
+  queue->count = remaining;
+  queue->ip = 0;
+}
+
+void EWCCalculatorTokenQueueMoveToFirst(EWCCalculatorTokenQueue *queue) {
+  queue->ip = 0;
+}
+
+BOOL EWCCalculatorTokenQueueTakeDidChange(EWCCalculatorTokenQueue *queue) {
+  BOOL value = queue->didChange;
+  queue->didChange = NO;
+  return value;
+}
+
+const EWCCalculatorToken *EWCCalculatorTokenQueueNextTokenAs(EWCCalculatorTokenQueue *queue, EWCCalculatorTokenType tokenType) {
+  if (queue->ip >= queue->count) { return NULL; }
+
+  const EWCCalculatorToken *token = &queue->tokens[queue->ip];
+  if (token->tokenType != tokenType) { return NULL; }
+
+  ++queue->ip;
+
+  return token;
+}
+
+const EWCCalculatorToken *EWCCalculatorTokenQueueNextToken(EWCCalculatorTokenQueue *queue) {
+  if (queue->ip >= queue->count) { return NULL; }
+
+  return &queue->tokens[queue->ip++];
+}
+
+BOOL EWCCalculatorTokenQueuePopToken(EWCCalculatorTokenQueue *queue) {
+  if (queue->ip >= queue->count) { return NO; }
+
+  // remove the token *without* advancing the ip
+  short following = queue->count - queue->ip - 1;
+  memmove(&queue->tokens[queue->ip], &queue->tokens[queue->ip + 1], following * sizeof(EWCCalculatorToken));
+  --queue->count;
+
+  return YES;
+}
+
+void EWCCalculatorTokenQueuePushbackToken(EWCCalculatorTokenQueue *queue) {
+  --queue->ip;
+}
+
+/**
+  Gets the slot for a token being added to the end of the queue, reusing the last slot if it holds a token of the same type.
+
+  @param queue The queue to add to.
+  @param tokenType The type of token being added.
+  @param replace Whether a last token of the same type should be overwritten.
+
+  @return The slot to fill, or NULL if the queue is full, in which case it is put into the error state.
+ */
+static EWCCalculatorToken *EWCCalculatorTokenQueueSlotForToken(EWCCalculatorTokenQueue *queue,
+  EWCCalculatorTokenType tokenType,
+  BOOL replace) {
+
+  if (replace && queue->count > 0 && queue->tokens[queue->count - 1].tokenType == tokenType) {
+    return &queue->tokens[queue->count - 1];
+  }
+
+  // the queue is parsed after every addition, so this really shouldn't happen
+  if (queue->count >= EWCCalculatorTokenQueueCapacity) {
+    queue->hasError = YES;
+    return NULL;
+  }
+
+  return &queue->tokens[queue->count++];
+}
+
+void EWCCalculatorTokenQueueEnqueueBinOp(EWCCalculatorTokenQueue *queue, EWCCalculatorOpcode op) {
+  // if the last item in queue is a binary op, and we are adding a binary op,
+  // just replace it (user changed mind about operator)
+  EWCCalculatorToken *token = EWCCalculatorTokenQueueSlotForToken(queue, EWCCalculatorBinOpTokenType, YES);
+  if (! token) { return; }
+
+  token->tokenType = EWCCalculatorBinOpTokenType;
+  token->opcode = op;
+  token->data = EWCCalculatorDecimalZero();
+
+  queue->didChange = YES;
+}
+
+void EWCCalculatorTokenQueueEnqueueEqual(EWCCalculatorTokenQueue *queue, EWCCalculatorOpcode op) {
+  // should not allow back to back equal tokens
+  // they get removed due to processing, so a back to back equal is strange
+  if (queue->count > 0 && queue->tokens[queue->count - 1].tokenType == EWCCalculatorEqualTokenType) {
+    queue->hasError = YES;
+    return;
+  }
+
+  EWCCalculatorToken *token = EWCCalculatorTokenQueueSlotForToken(queue, EWCCalculatorEqualTokenType, NO);
+  if (! token) { return; }
+
+  token->tokenType = EWCCalculatorEqualTokenType;
+  token->opcode = op;
+  token->data = EWCCalculatorDecimalZero();
+
+  queue->didChange = YES;
+}
+
+void EWCCalculatorTokenQueueEnqueueData(EWCCalculatorTokenQueue *queue, NSDecimal data) {
+  // if the last item in queue is data, and we are adding data,
+  // just replace it (user could have been working with memory or rate)
+  EWCCalculatorToken *token = EWCCalculatorTokenQueueSlotForToken(queue, EWCCalculatorDataTokenType, YES);
+  if (! token) { return; }
+
+  token->tokenType = EWCCalculatorDataTokenType;
+  token->opcode = EWCCalculatorNoOpcode;
+  token->data = data;
+
+  queue->didChange = YES;
+}
+
+const EWCCalculatorToken *EWCCalculatorTokenQueueLastToken(const EWCCalculatorTokenQueue *queue) {
+  if (queue->count > 0) {
+    return &queue->tokens[queue->count - 1];
+  }
+
+  return NULL;
+}
+
+void EWCCalculatorTokenQueueRemoveLastToken(EWCCalculatorTokenQueue *queue) {
+  if (queue->count > 0) {
+    --queue->count;
+  }
+}
+
+///--------------------
+/// @name Input Methods
+///--------------------
+
+void EWCCalculatorInputClear(EWCCalculatorInput *input) {
+  input->value = EWCCalculatorDecimalZero();
+  input->inputMode = EWCCalculatorInputModeWhole;
+  input->fractionPower = 0;
+  input->sign = 1;
+  input->numDigits = 0;
+  input->editing = NO;
+}
+
+void EWCCalculatorInputSetValue(EWCCalculatorInput *input, NSDecimal value) {
+  EWCCalculatorInputClear(input);
+  input->value = value;
+}
+
+short EWCCalculatorInputFractionalDigitCount(const EWCCalculatorInput *input) {
+  return -input->fractionPower;
+}
+
+/**
+  Appends a supplied digit to the number being built up.  If the key is the first in a series of keys we can handle, make sure we start in a fresh state.
+
+  @param input The input to update.
+  @param digit The digit to append to the in-progress number.
+  @param maximumDigits The maximum digits allowed, or 0 for no limit.
+ */
+static void EWCCalculatorInputDigitPressed(EWCCalculatorInput *input, short digit, NSInteger maximumDigits) {
+  if (! input->editing) {
+    EWCCalculatorInputClear(input);
+    input->editing = YES;
+  }
+
+  // don't allow input of more than maximum digits
+  if (maximumDigits && (input->numDigits + 1 > maximumDigits)) {
+    return;
+  }
+
+  NSDecimal decimalDigit = EWCCalculatorDecimalDigit(digit);
+  NSDecimal shifted;
+
+  switch (input->inputMode) {
+    case EWCCalculatorInputModeWhole:
+      // add to the whole number part by decimal left shifting the number we have so far
+      NSDecimalMultiplyByPowerOf10(&shifted, &input->value, 1, NSRoundPlain);
+      break;
+
+    case EWCCalculatorInputModeFraction:
+      // if we had no digits, then this is the first, so increment again, as we
+      // must have a leading zero
+      if (! input->numDigits) {
+        input->numDigits = 1;
+      }
+
+      // add to the fraction part by decimal right shifting to the appropriate power of 10
+      input->fractionPower--;
+      shifted = input->value;
+      NSDecimalMultiplyByPowerOf10(&decimalDigit, &decimalDigit, input->fractionPower, NSRoundPlain);
+      break;
+  }
+
+  // the digit carries the sign of the number being built
+  if (input->sign < 0) {
+    NSDecimalSubtract(&input->value, &shifted, &decimalDigit, NSRoundPlain);
+  } else {
+    NSDecimalAdd(&input->value, &shifted, &decimalDigit, NSRoundPlain);
+  }
+
+  ++input->numDigits;
+}
+
+/**
+  Toggle the sign of the number.
+
+  @param input The input to update.
+ */
+static void EWCCalculatorInputSignPressed(EWCCalculatorInput *input) {
+  NSDecimal zero = EWCCalculatorDecimalZero();
+  if (NSDecimalCompare(&input->value, &zero) == NSOrderedSame) { return; }
+
+  input->sign = -input->sign;
+
+  NSDecimal value = input->value;
+  NSDecimalSubtract(&input->value, &zero, &value, NSRoundPlain);
+}
+
+/**
+  Insert an explicit decimal point.  Any digits after this will start being added to the fractional part of the number.
+
+  @param input The input to update.
+ */
+static void EWCCalculatorInputDecimalPressed(EWCCalculatorInput *input) {
+  if (! input->editing) {
+    EWCCalculatorInputClear(input);
+    input->editing = YES;
+  }
+
+  // do we already have a decimal
+  if (input->inputMode != EWCCalculatorInputModeWhole) { return; }
+
+  input->inputMode = EWCCalculatorInputModeFraction;
+  input->fractionPower = 0;
+}
+
+/**
+  Remove the terminal character if editing.
+
+  @param input The input to update.
+ */
+static void EWCCalculatorInputBackspacePressed(EWCCalculatorInput *input) {
+  if (! input->editing) {
+    return;
+  }
+
+  if (input->numDigits == 0) {
+    // nothing to do
+    return;
+  }
+
+  NSDecimal zero = EWCCalculatorDecimalZero();
+
+  if (input->numDigits == 1) {
+    // just replace with 0
+    input->value = zero;
+    input->numDigits = 0;
+    input->sign = 1;
+    return;
+  }
+
+  // if the number is negative, note that and flip it positive
+  NSDecimal value = input->value;
+  BOOL negative = NO;
+  if (NSDecimalCompare(&value, &zero) == NSOrderedAscending) {
+    negative = YES;
+    NSDecimalSubtract(&value, &zero, &input->value, NSRoundPlain);
+  }
+
+  NSDecimal shifted;
+  switch (input->inputMode) {
+    case EWCCalculatorInputModeWhole:
+      // shift down by a power of ten then round away the decimal
+      NSDecimalMultiplyByPowerOf10(&shifted, &value, -1, NSRoundPlain);
+      NSDecimalRound(&value, &shifted, 0, NSRoundDown);
+      break;
+
+    case EWCCalculatorInputModeFraction:
+      input->fractionPower++;
+
+      // remove the final digit by rounding down the final power
+      shifted = value;
+      NSDecimalRound(&value, &shifted, -input->fractionPower, NSRoundDown);
+
+      if (input->fractionPower == 0) {
+        input->inputMode = EWCCalculatorInputModeWhole;
+
+        // numDigits can be off if there was no whole part, so do a hard check for zero here
+        if (NSDecimalCompare(&value, &zero) == NSOrderedSame) {
+          input->numDigits = 0;
+          input->sign = 1;
+        }
+      }
+      break;
+  }
+
+  --input->numDigits;
+
+  // restore the sign
+  if (negative) {
+    NSDecimalSubtract(&input->value, &zero, &value, NSRoundPlain);
+  } else {
+    input->value = value;
+  }
+}
+
+BOOL EWCCalculatorInputProcessKey(EWCCalculatorInput *input, EWCCalculatorKey key, NSInteger maximumDigits) {
+  BOOL ok = NO;
+
+  if (EWCCalculatorKeyIsDigit(key)) {
+    short digit = EWCCalculatorDigitFromKey(key);
+    if (digit != -1) {
+      ok = YES;
+      EWCCalculatorInputDigitPressed(input, digit, maximumDigits);
+    }
+  } else if (key == EWCCalculatorSignKey) {
+    ok = YES;
+    EWCCalculatorInputSignPressed(input);
+  } else if (key == EWCCalculatorDecimalKey) {
+    ok = YES;
+    EWCCalculatorInputDecimalPressed(input);
+  } else if (key == EWCCalculatorBackspaceKey) {
+    ok = YES;
+    EWCCalculatorInputBackspacePressed(input);
+  }
+
+  // this isn't a key we handle, then no longer editing
+  if (! ok) {
+    input->editing = NO;
+  }
+
+  return ok;
+}
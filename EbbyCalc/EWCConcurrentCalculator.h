@@ -0,0 +1,159 @@
+//
+//  EWCConcurrentCalculator.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import "EWCCalculatorKey.h"
+#import "EWCCalculatorChange.h"
+#import "EWCDisplayFormatter.h"
+
+@class EWCCalculator;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCCalculatorSnapshot` is an immutable copy of the client visible state of a calculator, taken after an input has been fully processed.  It contains no object references, so it can be freely copied between threads.
+
+  The formatted display is held in a fixed buffer of `EWCDisplayFormatterBufferSize` characters, which any display of up to 38 digits fits with room to spare.  A longer display (only possible if a locale's formatter falls back to unusually long symbols) is cut off at the end of the buffer, and `displayContentTruncated` is set.
+ */
+typedef struct {
+  uint64_t inputCount;  // the number of inputs processed when the snapshot was taken
+  EWCCalculatorChange changes;  // the outputs changed by the last input
+  NSDecimal displayValue;  // the raw display value
+  NSDecimal memoryValue;  // the raw memory value
+  unichar displayContent[EWCDisplayFormatterBufferSize];  // the formatted display, not terminated
+  NSUInteger displayContentLength;  // the number of characters in the formatted display
+  BOOL displayContentTruncated;  // whether the formatted display didn't fit, and was cut off
+  BOOL error;  // whether the calculator is in an error state
+  BOOL memory;  // whether the calculator has stored memory
+  BOOL shouldMemoryClear;  // whether the next mrc press will clear memory
+  BOOL tax;  // whether the tax indicator is visible
+  BOOL taxPlus;  // whether the tax plus indicator is visible
+  BOOL taxMinus;  // whether the tax minus indicator is visible
+  BOOL taxPercent;  // whether the tax percent indicator is visible
+  BOOL rateShifted;  // whether the calculator is rate shifted
+} EWCCalculatorSnapshot;
+
+/**
+  Gets the formatted display from a snapshot as a string.
+
+  @param snapshot The snapshot to read.
+
+  @return The formatted display content, which is incomplete if `displayContentTruncated` is set.
+ */
+NSString *EWCCalculatorSnapshotDisplayContent(const EWCCalculatorSnapshot *snapshot);
+
+/**
+  `EWCConcurrentCalculatorCompletion` defines the signature of the block run once an input submitted to an `EWCConcurrentCalculator` has been processed.
+
+  @param snapshot The state published as a result of the input.
+ */
+typedef void(^EWCConcurrentCalculatorCompletion)(EWCCalculatorSnapshot snapshot);
+
+/**
+  `EWCConcurrentCalculator` makes an `EWCCalculator` usable from multiple threads.
+
+  All inputs are performed asynchronously on a private serial queue.  After each input, an `EWCCalculatorSnapshot` of the resulting state is published, and can be read from any thread with `snapshot` without taking a lock, so readers never block the writer, and never see a partially updated state.
+
+  Snapshots are published into a small ring of slots, each guarded by a sequence counter.  A reader that overlaps with the writer rewriting the slot it is copying detects the change in the counter and retries with the newest slot.
+ */
+@interface EWCConcurrentCalculator : NSObject
+
+/**
+  Creates a wrapper around a new calculator.
+
+  @return The new wrapper.
+ */
++ (instancetype)concurrentCalculator;
+
+/**
+  Creates a wrapper around an existing calculator.
+
+  @param calculator The calculator to wrap.  Once wrapped, it must only be accessed through the wrapper.
+
+  @return The new wrapper.
+ */
++ (instancetype)concurrentCalculatorWithCalculator:(EWCCalculator *)calculator;
+
+/**
+  Initializes a wrapper around a new calculator.
+
+  @return The initialized instance.
+ */
+- (instancetype)init;
+
+/**
+  Initializes a wrapper around an existing calculator, publishing its current state as the first snapshot.
+
+  @param calculator The calculator to wrap.  Once wrapped, it must only be accessed through the wrapper.
+
+  @return The initialized instance.
+ */
+- (instancetype)initWithCalculator:(EWCCalculator *)calculator NS_DESIGNATED_INITIALIZER;
+
+/**
+  Reads the most recently published state.  This never blocks, and may be called from any thread.
+
+  @return A copy of the latest snapshot.
+ */
+- (EWCCalculatorSnapshot)snapshot;
+
+/**
+  Queues a key press.
+
+  @param key The key to press.
+ */
+- (void)pressKey:(EWCCalculatorKey)key;
+
+/**
+  Queues a key press, running a block once it has been processed.
+
+  @param key The key to press.
+  @param completion A block to run with the resulting snapshot.  It runs on the private queue, so it should not block, and must not wait on the wrapper.
+ */
+- (void)pressKey:(EWCCalculatorKey)key
+  completion:(nullable EWCConcurrentCalculatorCompletion)completion;
+
+/**
+  Queues setting the display input directly.
+
+  @param value The value to input.
+  @param completion A block to run with the resulting snapshot.  It runs on the private queue.
+ */
+- (void)setInput:(NSDecimalNumber *)value
+  completion:(nullable EWCConcurrentCalculatorCompletion)completion;
+
+/**
+  Queues a block with exclusive access to the wrapped calculator, such as to change its locale or data provider.  A snapshot is published once the block returns.
+
+  @param block The block to run on the private queue.  The calculator must not be retained beyond the block.
+ */
+- (void)performWithCalculator:(void(^)(EWCCalculator *calculator))block;
+
+/**
+  Blocks until all previously queued inputs have been processed.
+
+  @note This must not be called from a completion block.
+ */
+- (void)waitUntilIdle;
+
+@end
+
+NS_ASSUME_NONNULL_END
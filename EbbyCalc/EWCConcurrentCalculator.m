@@ -0,0 +1,227 @@
+//
+//  EWCConcurrentCalculator.m
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCConcurrentCalculator.h"
+#import "EWCCalculator.h"
+#import <stdatomic.h>
+
+/**
+  The number of snapshot slots.  The writer always fills the slot after the current one, so a reader is only forced to retry if the writer publishes this many snapshots while it is copying.
+ */
+#define EWCSnapshotSlotCount 4
+
+/**
+  `EWCSnapshotSlot` holds one published snapshot, along with the sequence counter that lets a reader detect that the slot was rewritten while being copied.  The counter is odd while a write is in progress.
+ */
+typedef struct {
+  _Atomic(uint32_t) sequence;  // incremented before and after each write
+  EWCCalculatorSnapshot snapshot;  // the published state
+} EWCSnapshotSlot;
+
+NSString *EWCCalculatorSnapshotDisplayContent(const EWCCalculatorSnapshot *snapshot) {
+  return [NSString stringWithCharacters:snapshot->displayContent
+    length:snapshot->displayContentLength];
+}
+
+@interface EWCConcurrentCalculator () {
+  EWCCalculator *_calculator;  // the wrapped calculator, only accessed on the queue
+  dispatch_queue_t _queue;  // serializes all access to the calculator
+  uint64_t _inputCount;  // the number of inputs processed, only accessed on the queue
+
+  EWCSnapshotSlot _slots[EWCSnapshotSlotCount];  // the ring of published snapshots
+  _Atomic(EWCSnapshotSlot *) _current;  // the most recently published slot
+}
+
+@end
+
+@implementation EWCConcurrentCalculator
+
+///-------------------------------------
+/// @name Constructors and Initializers.
+///-------------------------------------
+
++ (instancetype)concurrentCalculator {
+  return [EWCConcurrentCalculator new];
+}
+
++ (instancetype)concurrentCalculatorWithCalculator:(EWCCalculator *)calculator {
+  return [[EWCConcurrentCalculator alloc] initWithCalculator:calculator];
+}
+
+- (instancetype)init {
+  return [self initWithCalculator:[EWCCalculator calculator]];
+}
+
+- (instancetype)initWithCalculator:(EWCCalculator *)calculator {
+  self = [super init];
+  if (self) {
+    _calculator = calculator;
+    _queue = dispatch_queue_create("com.anselrognlie.EbbyCalc.calculator", DISPATCH_QUEUE_SERIAL);
+    _inputCount = 0;
+
+    for (int i = 0; i < EWCSnapshotSlotCount; ++i) {
+      atomic_init(&_slots[i].sequence, 0);
+    }
+
+    // publish the initial state directly into the first slot, since nothing
+    // else can see the instance yet
+    [self captureSnapshot:&_slots[0].snapshot];
+    atomic_init(&_current, &_slots[0]);
+  }
+
+  return self;
+}
+
+///----------------------------------
+/// @name Snapshot Publishing Methods
+///----------------------------------
+
+/**
+  Captures the current calculator state.  Must be called on the queue (or during initialization).
+
+  @param snapshot Receives the state.
+ */
+- (void)captureSnapshot:(EWCCalculatorSnapshot *)snapshot {
+  snapshot->inputCount = _inputCount;
+  snapshot->changes = _calculator.lastChanges;
+  snapshot->displayValue = _calculator.displayValue.decimalValue;
+  snapshot->memoryValue = _calculator.memoryValue.decimalValue;
+
+  // the buffer fits any display the formatter renders itself, so only a
+  // formatter fallback could be too long
+  NSString *content = _calculator.displayContent;
+  NSUInteger length = MIN(content.length, (NSUInteger)EWCDisplayFormatterBufferSize);
+  [content getCharacters:snapshot->displayContent range:NSMakeRange(0, length)];
+  snapshot->displayContentLength = length;
+  snapshot->displayContentTruncated = (length < content.length);
+
+  snapshot->error = _calculator.hasError;
+  snapshot->memory = _calculator.hasMemory;
+  snapshot->shouldMemoryClear = _calculator.shouldMemoryClear;
+  snapshot->tax = _calculator.isTaxStatusVisible;
+  snapshot->taxPlus = _calculator.isTaxPlusStatusVisible;
+  snapshot->taxMinus = _calculator.isTaxMinusStatusVisible;
+  snapshot->taxPercent = _calculator.isTaxPercentStatusVisible;
+  snapshot->rateShifted = _calculator.isRateShifted;
+}
+
+/**
+  Publishes the current calculator state for readers.  Must be called on the queue, since only a single writer is supported.
+
+  @return A copy of the published snapshot.
+ */
+- (EWCCalculatorSnapshot)publishSnapshot {
+  EWCCalculatorSnapshot snapshot;
+  [self captureSnapshot:&snapshot];
+
+  // write into the slot after the current one, so that readers of the current
+  // slot are undisturbed
+  EWCSnapshotSlot *current = atomic_load_explicit(&_current, memory_order_relaxed);
+  EWCSnapshotSlot *slot = &_slots[((current - _slots) + 1) % EWCSnapshotSlotCount];
+
+  uint32_t sequence = atomic_load_explicit(&slot->sequence, memory_order_relaxed);
+  atomic_store_explicit(&slot->sequence, sequence + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+
+  slot->snapshot = snapshot;
+
+  atomic_store_explicit(&slot->sequence, sequence + 2, memory_order_release);
+  atomic_store_explicit(&_current, slot, memory_order_release);
+
+  return snapshot;
+}
+
+///---------------------------------------------------------------
+/// @name Public Properties and Methods (documented in the header)
+///---------------------------------------------------------------
+
+- (EWCCalculatorSnapshot)snapshot {
+  EWCCalculatorSnapshot snapshot;
+
+  while (YES) {
+    EWCSnapshotSlot *slot = atomic_load_explicit(&_current, memory_order_acquire);
+
+    uint32_t before = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+    if (before & 1) {
+      // the writer has lapped the ring and is rewriting this slot
+      continue;
+    }
+
+    snapshot = slot->snapshot;
+
+    atomic_thread_fence(memory_order_acquire);
+    uint32_t after = atomic_load_explicit(&slot->sequence, memory_order_relaxed);
+    if (before == after) {
+      return snapshot;
+    }
+  }
+}
+
+- (void)pressKey:(EWCCalculatorKey)key {
+  [self pressKey:key completion:nil];
+}
+
+- (void)pressKey:(EWCCalculatorKey)key
+  completion:(EWCConcurrentCalculatorCompletion)completion {
+  dispatch_async(_queue, ^{
+    [self->_calculator pressKey:key];
+    [self finishInputWithCompletion:completion];
+  });
+}
+
+- (void)setInput:(NSDecimalNumber *)value
+  completion:(EWCConcurrentCalculatorCompletion)completion {
+  dispatch_async(_queue, ^{
+    [self->_calculator setInput:value];
+    [self finishInputWithCompletion:completion];
+  });
+}
+
+- (void)performWithCalculator:(void (^)(EWCCalculator * _Nonnull))block {
+  dispatch_async(_queue, ^{
+    block(self->_calculator);
+    [self finishInputWithCompletion:nil];
+  });
+}
+
+- (void)waitUntilIdle {
+  dispatch_sync(_queue, ^{});
+}
+
+///----------------------------
+/// @name Other Utility Methods
+///----------------------------
+
+/**
+  Publishes the result of an input and runs its completion.  Must be called on the queue.
+
+  @param completion The completion to run, if any.
+ */
+- (void)finishInputWithCompletion:(EWCConcurrentCalculatorCompletion)completion {
+  ++_inputCount;
+  EWCCalculatorSnapshot snapshot = [self publishSnapshot];
+
+  if (completion) {
+    completion(snapshot);
+  }
+}
+
+@end
@@ -0,0 +1,54 @@
+//
+//  EWCDecimalArithmetic.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  Multiplies two values, giving exactly the result of `NSDecimalMultiply` with `NSRoundPlain`.
+
+  Mantissas of up to 64 bits are multiplied directly in 128 bits, and when the product fits in the 38 digits of an `NSDecimal` it is exact, so no rounding is needed.  Anything else is left to `NSDecimalMultiply`.
+
+  @note Bounding products and quotients to the digits of the display isn't safe for the calculator: every result feeds the accumulator (or the operand or tax results), and an error cut off below the display digits is carried along and can be brought into them by a later division.  So the calculator works at full precision, and only the exact cases are made cheaper.
+
+  @param result Receives the product.  It may be the same as either value.
+  @param left The first value.
+  @param right The second value.
+
+  @return The outcome, as `NSDecimalMultiply` reports it.
+ */
+NSCalculationError EWCDecimalMultiply(NSDecimal *result, const NSDecimal *left, const NSDecimal *right);
+
+/**
+  Divides two values, giving exactly the result of `NSDecimalDivide` with `NSRoundPlain`.
+
+  A divisor mantissa of up to 64 bits with no prime factors but 2 and 5 gives a quotient that terminates, which is found directly by long division when it fits in 38 digits.  Anything else (including every quotient that repeats) is left to `NSDecimalDivide`.
+
+  @param result Receives the quotient.  It may be the same as either value.
+  @param dividend The value divided.
+  @param divisor The value divided by.
+
+  @return The outcome, as `NSDecimalDivide` reports it.
+ */
+NSCalculationError EWCDecimalDivide(NSDecimal *result, const NSDecimal *dividend, const NSDecimal *divisor);
+
+NS_ASSUME_NONNULL_END
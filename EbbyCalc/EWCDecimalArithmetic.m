@@ -0,0 +1,181 @@
+//
+//  EWCDecimalArithmetic.m
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCDecimalArithmetic.h"
+#import "EWCDecimalDigits.h"
+
+/**
+  The most significant digits an `NSDecimal` mantissa holds.
+ */
+#define EWCDecimalArithmeticMaxDigits 38
+
+/**
+  The most decimal digits the quotient grows by in one step of long division, so that a remainder below 2^64 scaled by that power of ten still fits in a mantissa.
+ */
+#define EWCDecimalArithmeticDivisionStepDigits 18
+
+/**
+  Gets a power of ten as a mantissa.
+
+  @param power The power, from 0 to `EWCDecimalArithmeticMaxDigits`.
+
+  @return The power of ten.
+ */
+static inline EWCDecimalMantissa EWCDecimalArithmeticPowerOf10(int power) {
+  static EWCDecimalMantissa s_powers[EWCDecimalArithmeticMaxDigits + 1];
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    s_powers[0] = 1;
+    for (int i = 1; i <= EWCDecimalArithmeticMaxDigits; ++i) {
+      s_powers[i] = s_powers[i - 1] * 10;
+    }
+  });
+
+  return s_powers[power];
+}
+
+/**
+  Counts the decimal digits of a mantissa.
+
+  @param mantissa The mantissa.
+
+  @return The number of digits, which is 0 for zero, and at most `EWCDecimalArithmeticMaxDigits` + 1.
+ */
+static int EWCDecimalArithmeticDigitCount(EWCDecimalMantissa mantissa) {
+  int count = 0;
+  while (count <= EWCDecimalArithmeticMaxDigits && mantissa >= EWCDecimalArithmeticPowerOf10(count)) {
+    ++count;
+  }
+
+  return count;
+}
+
+/**
+  Checks whether dividing by a mantissa gives a terminating decimal, which it does when the mantissa has no prime factors but 2 and 5.
+
+  @param divisor The mantissa, which must not be zero.
+
+  @return YES if every quotient by the divisor terminates.
+ */
+static BOOL EWCDecimalArithmeticTerminates(uint64_t divisor) {
+  while (divisor % 10 == 0) { divisor /= 10; }
+  while (divisor % 2 == 0) { divisor /= 2; }
+  while (divisor % 5 == 0) { divisor /= 5; }
+
+  return divisor == 1;
+}
+
+/**
+  Builds an exact result from a mantissa.
+
+  @param mantissa The mantissa, which must have at most `EWCDecimalArithmeticMaxDigits` digits.
+  @param exponent The power of ten the mantissa is scaled by.
+  @param negative Whether the result is negative.
+  @param result Receives the result.
+
+  @return NO if the exponent is out of the range an `NSDecimal` can hold, in which case the result is left alone.
+ */
+static BOOL EWCDecimalArithmeticMakeResult(EWCDecimalMantissa mantissa, int exponent, BOOL negative, NSDecimal *result) {
+  if (mantissa == 0) {
+    EWCDecimalFromMantissa(0, 0, NO, result);
+    return YES;
+  }
+
+  // trailing zeros can be traded for exponent
+  while (exponent < SCHAR_MIN && mantissa % 10 == 0) {
+    mantissa /= 10;
+    ++exponent;
+  }
+
+  if (exponent < SCHAR_MIN || exponent > SCHAR_MAX) {
+    return NO;
+  }
+
+  EWCDecimalFromMantissa(mantissa, (short)exponent, negative, result);
+
+  return YES;
+}
+
+NSCalculationError EWCDecimalMultiply(NSDecimal *result, const NSDecimal *left, const NSDecimal *right) {
+  EWCDecimalMantissa a, b;
+  short aExponent, bExponent;
+  BOOL aNegative, bNegative;
+
+  // mantissas of up to 64 bits multiply exactly in 128, and a product that
+  // fits an NSDecimal needs no rounding
+  if (EWCDecimalGetMantissa(left, &a, &aExponent, &aNegative)
+    && EWCDecimalGetMantissa(right, &b, &bExponent, &bNegative)
+    && a <= UINT64_MAX && b <= UINT64_MAX) {
+
+    EWCDecimalMantissa product = a * b;
+    if (EWCDecimalArithmeticDigitCount(product) <= EWCDecimalArithmeticMaxDigits
+      && EWCDecimalArithmeticMakeResult(product, aExponent + bExponent, aNegative != bNegative, result)) {
+      return NSCalculationNoError;
+    }
+  }
+
+  NSDecimal value;
+  NSCalculationError error = NSDecimalMultiply(&value, left, right, NSRoundPlain);
+  *result = value;
+
+  return error;
+}
+
+NSCalculationError EWCDecimalDivide(NSDecimal *result, const NSDecimal *dividend, const NSDecimal *divisor) {
+  EWCDecimalMantissa a, b;
+  short aExponent, bExponent;
+  BOOL aNegative, bNegative;
+
+  // long division by a divisor of up to 64 bits, a chunk of digits at a time,
+  // for the quotients that terminate within the digits of an NSDecimal
+  if (EWCDecimalGetMantissa(dividend, &a, &aExponent, &aNegative)
+    && EWCDecimalGetMantissa(divisor, &b, &bExponent, &bNegative)
+    && b != 0 && b <= UINT64_MAX
+    && EWCDecimalArithmeticTerminates((uint64_t)b)) {
+
+    uint64_t denominator = (uint64_t)b;
+    EWCDecimalMantissa quotient = a / denominator;
+    uint64_t remainder = (uint64_t)(a % denominator);
+    int exponent = aExponent - bExponent;
+    int count = EWCDecimalArithmeticDigitCount(quotient);
+
+    while (remainder != 0 && count < EWCDecimalArithmeticMaxDigits) {
+      int step = MIN(EWCDecimalArithmeticMaxDigits - count, EWCDecimalArithmeticDivisionStepDigits);
+      EWCDecimalMantissa scaled = (EWCDecimalMantissa)remainder * EWCDecimalArithmeticPowerOf10(step);
+      quotient = quotient * EWCDecimalArithmeticPowerOf10(step) + scaled / denominator;
+      remainder = (uint64_t)(scaled % denominator);
+      exponent -= step;
+      count = EWCDecimalArithmeticDigitCount(quotient);
+    }
+
+    if (remainder == 0
+      && count <= EWCDecimalArithmeticMaxDigits
+      && EWCDecimalArithmeticMakeResult(quotient, exponent, aNegative != bNegative, result)) {
+      return NSCalculationNoError;
+    }
+  }
+
+  NSDecimal value;
+  NSCalculationError error = NSDecimalDivide(&value, dividend, divisor, NSRoundPlain);
+  *result = value;
+
+  return error;
+}
@@ -0,0 +1,88 @@
+//
+//  EWCDecimalDigits.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  The most decimal digits an `NSDecimal` mantissa can expand to (a 128-bit mantissa is at most 39 digits, and we extract them four at a time).
+ */
+#define EWCDecimalMaxDigitCount 40
+
+/**
+  `EWCDecimalDigits` holds the decimal digits of an `NSDecimal` value, most significant digit first, so that the value can be rendered or inspected without going through string conversion.
+
+  The value represented is (-1)^negative × digits × 10^exponent.  A zero value is represented as a single 0 digit.
+ */
+typedef struct {
+  uint8_t digits[EWCDecimalMaxDigitCount];  // the mantissa digits, most significant first, with no leading zeros
+  short count;  // the number of digits in use
+  short exponent;  // the power of ten of the final digit
+  BOOL negative;  // whether the value is negative (never set for zero)
+} EWCDecimalDigits;
+
+/**
+  `EWCDecimalMantissa` holds the mantissa of an `NSDecimal`, which is at most 128 bits, as a single integer.
+ */
+typedef unsigned __int128 EWCDecimalMantissa;
+
+/**
+  Expands an `NSDecimal` into its decimal digits.
+
+  @param value The value to expand.
+  @param digits Receives the expanded digits.
+
+  @return YES if the digits were extracted, or NO if the value is NaN (in which case the digits are not modified).
+ */
+BOOL EWCDecimalDigitsFromDecimal(const NSDecimal *value, EWCDecimalDigits *digits);
+
+/**
+  Builds an `NSDecimal` from its decimal digits.
+
+  @param digits The digits to collect.  The count must not exceed 38.
+  @param value Receives the value.
+ */
+void EWCDecimalFromDigits(const EWCDecimalDigits *digits, NSDecimal *value);
+
+/**
+  Gets the mantissa of an `NSDecimal` as a single integer, for arithmetic that doesn't need the generality of the `NSDecimal` functions.
+
+  @param value The value.
+  @param mantissa Receives the mantissa.
+  @param exponent Receives the power of ten the mantissa is scaled by.
+  @param negative Receives whether the value is negative (never set for zero).
+
+  @return YES if the mantissa was extracted, or NO if the value is NaN (in which case nothing is modified).
+ */
+BOOL EWCDecimalGetMantissa(const NSDecimal *value, EWCDecimalMantissa *mantissa, short *exponent, BOOL *negative);
+
+/**
+  Builds an `NSDecimal` from a mantissa.
+
+  @param mantissa The mantissa, which must be less than 10^38.
+  @param exponent The power of ten the mantissa is scaled by, from -128 to 127.
+  @param negative Whether the value is negative.
+  @param value Receives the value.
+ */
+void EWCDecimalFromMantissa(EWCDecimalMantissa mantissa, short exponent, BOOL negative, NSDecimal *value);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,252 @@
+//
+//  EWCDecimalDigits.m
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCDecimalDigits.h"
+
+#if defined(__APPLE__)
+
+BOOL EWCDecimalDigitsFromDecimal(const NSDecimal *value, EWCDecimalDigits *digits) {
+  // a zero length with the negative flag set is how NSDecimal represents NaN
+  if (value->_length == 0 && value->_isNegative) {
+    return NO;
+  }
+
+  // work on a copy of the mantissa, since we consume it by division
+  unsigned short mantissa[NSDecimalMaxSize];
+  int length = value->_length;
+  for (int i = 0; i < length; ++i) {
+    mantissa[i] = value->_mantissa[i];
+  }
+
+  // repeatedly divide the mantissa by 10000, collecting four digits from each
+  // remainder.  digits are collected least significant first.
+  uint8_t reversed[EWCDecimalMaxDigitCount];
+  short count = 0;
+  while (length > 0) {
+    uint32_t remainder = 0;
+    for (int i = length - 1; i >= 0; --i) {
+      uint32_t current = (remainder << 16) | mantissa[i];
+      mantissa[i] = (unsigned short)(current / 10000);
+      remainder = current % 10000;
+    }
+
+    // drop any high words that have been divided away
+    while (length > 0 && mantissa[length - 1] == 0) {
+      --length;
+    }
+
+    for (int i = 0; i < 4; ++i) {
+      reversed[count++] = remainder % 10;
+      remainder /= 10;
+    }
+  }
+
+  // strip the leading zeros introduced by the four digit chunks
+  while (count > 1 && reversed[count - 1] == 0) {
+    --count;
+  }
+
+  if (count == 0) {
+    // zero mantissa
+    digits->digits[0] = 0;
+    digits->count = 1;
+    digits->exponent = 0;
+    digits->negative = NO;
+    return YES;
+  }
+
+  for (short i = 0; i < count; ++i) {
+    digits->digits[i] = reversed[count - 1 - i];
+  }
+
+  digits->count = count;
+  digits->exponent = value->_exponent;
+  digits->negative = (value->_isNegative && ! (count == 1 && digits->digits[0] == 0));
+
+  return YES;
+}
+
+void EWCDecimalFromDigits(const EWCDecimalDigits *digits, NSDecimal *value) {
+  // accumulate the digits into the mantissa words by repeated multiply-add
+  unsigned short mantissa[NSDecimalMaxSize] = {0};
+  int length = 0;
+  for (short i = 0; i < digits->count; ++i) {
+    uint32_t carry = digits->digits[i];
+    for (int w = 0; w < length; ++w) {
+      uint32_t current = (uint32_t)mantissa[w] * 10 + carry;
+      mantissa[w] = (unsigned short)(current & 0xffff);
+      carry = current >> 16;
+    }
+    if (carry && length < NSDecimalMaxSize) {
+      mantissa[length++] = (unsigned short)carry;
+    }
+  }
+
+  value->_exponent = digits->exponent;
+  value->_length = length;
+  value->_isNegative = (length > 0) && digits->negative;
+  value->_isCompact = NO;
+  value->_reserved = 0;
+  for (int w = 0; w < NSDecimalMaxSize; ++w) {
+    value->_mantissa[w] = mantissa[w];
+  }
+
+  NSDecimalCompact(value);
+}
+
+BOOL EWCDecimalGetMantissa(const NSDecimal *value, EWCDecimalMantissa *mantissa, short *exponent, BOOL *negative) {
+  if (value->_length == 0 && value->_isNegative) {
+    return NO;
+  }
+
+  // the words are least significant first
+  EWCDecimalMantissa accumulated = 0;
+  for (int i = value->_length - 1; i >= 0; --i) {
+    accumulated = (accumulated << 16) | value->_mantissa[i];
+  }
+
+  *mantissa = accumulated;
+  *exponent = value->_exponent;
+  *negative = value->_isNegative && accumulated != 0;
+
+  return YES;
+}
+
+void EWCDecimalFromMantissa(EWCDecimalMantissa mantissa, short exponent, BOOL negative, NSDecimal *value) {
+  int length = 0;
+  for (int w = 0; w < NSDecimalMaxSize; ++w) {
+    value->_mantissa[w] = (unsigned short)(mantissa & 0xffff);
+    mantissa >>= 16;
+    if (value->_mantissa[w] != 0) {
+      length = w + 1;
+    }
+  }
+
+  value->_exponent = exponent;
+  value->_length = length;
+  value->_isNegative = (length > 0) && negative;
+  value->_isCompact = NO;
+  value->_reserved = 0;
+
+  NSDecimalCompact(value);
+}
+
+#else
+
+BOOL EWCDecimalDigitsFromDecimal(const NSDecimal *value, EWCDecimalDigits *digits) {
+  // the NSDecimal layout is private outside of Apple's Foundation, so go
+  // through the plain (locale independent) string representation instead
+  NSString *str = NSDecimalString(value, nil);
+  if ([str isEqualToString:@"NaN"]) {
+    return NO;
+  }
+
+  short count = 0;
+  short fraction = 0;
+  BOOL inFraction = NO;
+  BOOL negative = NO;
+  for (NSUInteger i = 0; i < str.length; ++i) {
+    unichar c = [str characterAtIndex:i];
+    if (c == '-') {
+      negative = YES;
+    } else if (c == '.') {
+      inFraction = YES;
+    } else if (c >= '0' && c <= '9' && count < EWCDecimalMaxDigitCount) {
+      // skip leading zeros
+      if (count == 0 && c == '0') {
+        if (inFraction) { ++fraction; }
+        continue;
+      }
+      digits->digits[count++] = c - '0';
+      if (inFraction) { ++fraction; }
+    }
+  }
+
+  if (count == 0) {
+    digits->digits[0] = 0;
+    digits->count = 1;
+    digits->exponent = 0;
+    digits->negative = NO;
+    return YES;
+  }
+
+  digits->count = count;
+  digits->exponent = -fraction;
+  digits->negative = negative;
+
+  return YES;
+}
+
+void EWCDecimalFromDigits(const EWCDecimalDigits *digits, NSDecimal *value) {
+  // as above, the layout is private, so build the plain string representation
+  char str[EWCDecimalMaxDigitCount + 16];
+  int length = 0;
+  if (digits->negative) {
+    str[length++] = '-';
+  }
+  for (short i = 0; i < digits->count; ++i) {
+    str[length++] = '0' + digits->digits[i];
+  }
+  snprintf(str + length, sizeof(str) - length, "E%d", digits->exponent);
+
+  *value = [NSDecimalNumber decimalNumberWithString:@(str)
+    locale:@{ NSLocaleDecimalSeparator: @"." }].decimalValue;
+}
+
+BOOL EWCDecimalGetMantissa(const NSDecimal *value, EWCDecimalMantissa *mantissa, short *exponent, BOOL *negative) {
+  EWCDecimalDigits digits;
+  if (! EWCDecimalDigitsFromDecimal(value, &digits)) {
+    return NO;
+  }
+
+  EWCDecimalMantissa accumulated = 0;
+  for (short i = 0; i < digits.count; ++i) {
+    accumulated = accumulated * 10 + digits.digits[i];
+  }
+
+  *mantissa = accumulated;
+  *exponent = digits.exponent;
+  *negative = digits.negative;
+
+  return YES;
+}
+
+void EWCDecimalFromMantissa(EWCDecimalMantissa mantissa, short exponent, BOOL negative, NSDecimal *value) {
+  // collect the digits least significant first, then reverse them
+  uint8_t reversed[EWCDecimalMaxDigitCount];
+  short count = 0;
+  do {
+    reversed[count++] = (uint8_t)(mantissa % 10);
+    mantissa /= 10;
+  } while (mantissa > 0);
+
+  EWCDecimalDigits digits;
+  for (short i = 0; i < count; ++i) {
+    digits.digits[i] = reversed[count - 1 - i];
+  }
+  digits.count = count;
+  digits.exponent = exponent;
+  digits.negative = negative && ! (count == 1 && reversed[0] == 0);
+
+  EWCDecimalFromDigits(&digits, value);
+}
+
+#endif
@@ -0,0 +1,41 @@
+//
+//  EWCDispatchAnnouncementClock.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import "EWCAnnouncementClockProtocol.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCDispatchAnnouncementClock` runs scheduled blocks on the main queue, timed by the system uptime.
+ */
+@interface EWCDispatchAnnouncementClock : NSObject<EWCAnnouncementClockProtocol>
+
+/**
+  Creates a new clock.
+
+  @return The new clock.
+ */
++ (instancetype)clock;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,57 @@
+//
+//  EWCDispatchAnnouncementClock.m
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCDispatchAnnouncementClock.h"
+
+@implementation EWCDispatchAnnouncementClock
+
+///----------------------------------------------
+/// @name Construction and Initialization Methods
+///----------------------------------------------
+
++ (instancetype)clock {
+  return [EWCDispatchAnnouncementClock new];
+}
+
+///-----------------------------------
+/// @name EWCAnnouncementClock Methods
+///-----------------------------------
+
+- (NSTimeInterval)now {
+  return [NSProcessInfo processInfo].systemUptime;
+}
+
+- (id)scheduleBlock:(dispatch_block_t)block afterDelay:(NSTimeInterval)delay {
+  // wrap the block so that it can be cancelled before it runs
+  dispatch_block_t cancellable = dispatch_block_create(0, block);
+
+  dispatch_time_t popTime = dispatch_time(DISPATCH_TIME_NOW,
+    (int64_t)(delay * NSEC_PER_SEC));
+  dispatch_after(popTime, dispatch_get_main_queue(), cancellable);
+
+  return cancellable;
+}
+
+- (void)cancelScheduledBlock:(id)token {
+  dispatch_block_cancel((dispatch_block_t)token);
+}
+
+@end
@@ -0,0 +1,145 @@
+//
+//  EWCDisplayFormatter.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import "EWCLocaleDescriptor.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  The size of buffer (in characters) that is always large enough to hold a rendered display value.
+ */
+#define EWCDisplayFormatterBufferSize 256
+
+/**
+  Renders a value under a locale's number rules, as `EWCDisplayFormatter` does, into a caller supplied buffer.
+
+  @param rules The rules of the locale.
+  @param value The value to render.
+  @param maximumFractionDigits The maximum number of fractional digits to render.
+  @param minimumFractionDigits The minimum number of fractional digits to show.
+  @param buffer The buffer to receive the characters.  It is not terminated.
+  @param capacity The number of characters available in the buffer.
+
+  @return The number of characters written, or 0 if the value can't be rendered directly.
+ */
+NSUInteger EWCDisplayRenderDecimal(const EWCLocaleNumberRules *rules,
+  NSDecimal value,
+  NSInteger maximumFractionDigits,
+  NSInteger minimumFractionDigits,
+  unichar *buffer,
+  NSUInteger capacity);
+
+/**
+  `EWCDisplayFormatter` renders calculator display values directly from the `NSDecimal` mantissa and exponent into a reused character buffer.
+
+  It renders with the number rules of an interned `EWCLocaleDescriptor`, which were captured from an `NSNumberFormatter` configured the same way the calculator has always configured its display formatter, so that its output is identical to formatting with that `NSNumberFormatter` and then appending a decimal separator if the result doesn't already contain one.  Any value or locale it can't render directly (NaN, or locale symbols that don't fit the rules) falls back to that formatter, which is only created when first needed.
+ */
+@interface EWCDisplayFormatter : NSObject
+
+/**
+  The locale whose rules are applied.
+ */
+@property (nonatomic, readonly) NSLocale *locale;
+
+/**
+  The descriptor of the locale.
+ */
+@property (nonatomic, readonly) EWCLocaleDescriptor *descriptor;
+
+/**
+  The maximum number of fractional digits to render.  Values with more fractional digits are rounded half-even, as `NSNumberFormatter` would.
+ */
+@property (nonatomic, readonly) NSInteger maximumFractionDigits;
+
+/**
+  Creates a new display formatter.
+
+  @param locale The locale whose formatting rules to apply.
+  @param maximumFractionDigits The maximum number of fractional digits to render.
+
+  @return The new formatter instance.
+ */
++ (instancetype)formatterWithLocale:(NSLocale *)locale
+  maximumFractionDigits:(NSInteger)maximumFractionDigits;
+
+/**
+  Creates a new display formatter for a locale descriptor.
+
+  @param descriptor The descriptor of the locale whose formatting rules to apply.
+  @param maximumFractionDigits The maximum number of fractional digits to render.
+
+  @return The new formatter instance.
+ */
++ (instancetype)formatterWithDescriptor:(EWCLocaleDescriptor *)descriptor
+  maximumFractionDigits:(NSInteger)maximumFractionDigits;
+
+/**
+  Initializes a display formatter with the interned descriptor of a locale.
+
+  @param locale The locale whose formatting rules to apply.
+  @param maximumFractionDigits The maximum number of fractional digits to render.
+
+  @return The initialized instance.
+ */
+- (instancetype)initWithLocale:(NSLocale *)locale
+  maximumFractionDigits:(NSInteger)maximumFractionDigits;
+
+/**
+  Initializes a display formatter.
+
+  @param descriptor The descriptor of the locale whose formatting rules to apply.
+  @param maximumFractionDigits The maximum number of fractional digits to render.
+
+  @return The initialized instance.
+ */
+- (instancetype)initWithDescriptor:(EWCLocaleDescriptor *)descriptor
+  maximumFractionDigits:(NSInteger)maximumFractionDigits;
+
+/**
+  Renders a value as a display string.
+
+  @param value The value to render.
+  @param minimumFractionDigits The minimum number of fractional digits to show, so that trailing zeros being input are not hidden.
+
+  @return The rendered display string, always containing a decimal separator.
+ */
+- (NSString *)stringFromDecimal:(NSDecimal)value
+  minimumFractionDigits:(NSInteger)minimumFractionDigits;
+
+/**
+  Renders a value into a caller supplied buffer without allocating.
+
+  @param value The value to render.
+  @param minimumFractionDigits The minimum number of fractional digits to show.
+  @param buffer The buffer to receive the characters.  It is not terminated.
+  @param capacity The number of characters available in the buffer.  `EWCDisplayFormatterBufferSize` is always sufficient.
+
+  @return The number of characters written, or 0 if the value can't be rendered directly (the caller should then use `stringFromDecimal:minimumFractionDigits:`, which falls back to the formatter).
+ */
+- (NSUInteger)renderDecimal:(NSDecimal)value
+  minimumFractionDigits:(NSInteger)minimumFractionDigits
+  intoBuffer:(unichar *)buffer
+  capacity:(NSUInteger)capacity;
+
+@end
+
+NS_ASSUME_NONNULL_END
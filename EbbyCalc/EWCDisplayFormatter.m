@@ -0,0 +1,330 @@
+//
+//  EWCDisplayFormatter.m
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCDisplayFormatter.h"
+#import "EWCDecimalDigits.h"
+
+/**
+  Appends a symbol to the output buffer.  The caller has already ensured there is room.
+
+  @param symbol The symbol to write.
+  @param buffer The output buffer.
+  @param pos The current write position, which is advanced.
+ */
+static inline void writeSymbol(const EWCLocaleSymbol *symbol, unichar *buffer, NSUInteger *pos) {
+  for (short i = 0; i < symbol->length; ++i) {
+    buffer[(*pos)++] = symbol->chars[i];
+  }
+}
+
+/**
+  Rounds away the least significant digits of a value, using the half-even rule that `NSNumberFormatter` applies by default.
+
+  @param value The digits to round in place.
+  @param drop The number of least significant digits to remove.
+ */
+static void roundHalfEven(EWCDecimalDigits *value, short drop) {
+  short keep = value->count - drop;
+
+  if (keep < 0) {
+    // the first dropped digit is an implied leading zero, so this rounds to zero
+    value->digits[0] = 0;
+    value->count = 0;
+    value->exponent += drop;
+    return;
+  }
+
+  uint8_t first = value->digits[keep];
+  BOOL rest = NO;
+  for (short i = keep + 1; i < value->count; ++i) {
+    if (value->digits[i] != 0) {
+      rest = YES;
+      break;
+    }
+  }
+  BOOL previousOdd = (keep > 0) ? (value->digits[keep - 1] & 1) : NO;
+  BOOL roundUp = (first > 5 || (first == 5 && (rest || previousOdd)));
+
+  value->count = keep;
+  value->exponent += drop;
+
+  if (! roundUp) {
+    return;
+  }
+
+  // propagate the increment up through the kept digits
+  for (short i = keep - 1; i >= 0; --i) {
+    if (value->digits[i] < 9) {
+      value->digits[i]++;
+      return;
+    }
+    value->digits[i] = 0;
+  }
+
+  // carried out of the most significant digit, so insert a new leading 1
+  for (short i = value->count; i > 0; --i) {
+    value->digits[i] = value->digits[i - 1];
+  }
+  value->digits[0] = 1;
+  value->count++;
+}
+
+NSUInteger EWCDisplayRenderDecimal(const EWCLocaleNumberRules *rules,
+  NSDecimal value,
+  NSInteger maximumFractionDigits,
+  NSInteger minimumFractionDigits,
+  unichar *buffer,
+  NSUInteger capacity) {
+
+  if (minimumFractionDigits > maximumFractionDigits) { return 0; }
+
+  EWCDecimalDigits digits;
+  if (! EWCDecimalDigitsFromDecimal(&value, &digits)) {
+    // NaN
+    return 0;
+  }
+
+  // round away any fractional digits beyond the maximum
+  short fractionCount = (digits.exponent < 0) ? -digits.exponent : 0;
+  if (fractionCount > maximumFractionDigits) {
+    roundHalfEven(&digits, fractionCount - (short)maximumFractionDigits);
+
+    if (digits.count == 0 || (digits.count == 1 && digits.digits[0] == 0)) {
+      // rounded to zero.  leave the sign handling of this edge to the formatter.
+      return 0;
+    }
+  }
+
+  // drop trailing fractional zeros, since only the minimum count is forced
+  while (digits.exponent < 0 && digits.count > 1 && digits.digits[digits.count - 1] == 0) {
+    --digits.count;
+    ++digits.exponent;
+  }
+
+  short wholeCount = digits.count + digits.exponent;
+  short significantFraction = (digits.exponent < 0) ? -digits.exponent : 0;
+  short fractionShown = MAX((short)minimumFractionDigits, significantFraction);
+
+  BOOL grouped = (rules->usesGrouping && wholeCount >= rules->groupingSize + rules->minimumGroupingDigits);
+
+  const EWCLocaleSymbol *prefix = digits.negative ? &rules->negativePrefix : &rules->positivePrefix;
+  const EWCLocaleSymbol *suffix = digits.negative ? &rules->negativeSuffix : &rules->positiveSuffix;
+
+  // make sure the worst case fits before writing anything
+  NSUInteger wholeShown = MAX(wholeCount, 1);
+  NSUInteger needed = prefix->length + suffix->length
+    + wholeShown + (grouped ? wholeShown * rules->groupingSeparator.length : 0)
+    + rules->decimalSeparator.length + fractionShown + rules->appendSeparator.length;
+  if (needed > capacity) { return 0; }
+
+  NSUInteger pos = 0;
+  writeSymbol(prefix, buffer, &pos);
+
+  // the digit for a power of ten p is at index (count - 1) - (p - exponent)
+  short lastIndex = digits.count - 1 + digits.exponent;
+
+  if (wholeCount <= 0) {
+    buffer[pos++] = rules->digitGlyphs[0];
+  } else {
+    for (short p = wholeCount - 1; p >= 0; --p) {
+      short index = lastIndex - p;
+      uint8_t digit = (index < digits.count) ? digits.digits[index] : 0;
+      buffer[pos++] = rules->digitGlyphs[digit];
+
+      if (grouped && p >= rules->groupingSize && (p - rules->groupingSize) % rules->secondaryGroupingSize == 0) {
+        writeSymbol(&rules->groupingSeparator, buffer, &pos);
+      }
+    }
+  }
+
+  if (fractionShown > 0) {
+    writeSymbol(&rules->decimalSeparator, buffer, &pos);
+    for (short p = -1; p >= -fractionShown; --p) {
+      short index = lastIndex - p;
+      uint8_t digit = (index >= 0 && index < digits.count) ? digits.digits[index] : 0;
+      buffer[pos++] = rules->digitGlyphs[digit];
+    }
+  }
+
+  writeSymbol(suffix, buffer, &pos);
+
+  // append the decimal separator if the text doesn't already contain one
+  BOOL found = NO;
+  short sepLength = rules->appendSeparator.length;
+  for (NSUInteger i = 0; ! found && i + sepLength <= pos; ++i) {
+    found = YES;
+    for (short j = 0; j < sepLength; ++j) {
+      if (buffer[i + j] != rules->appendSeparator.chars[j]) {
+        found = NO;
+        break;
+      }
+    }
+  }
+
+  if (! found) {
+    writeSymbol(&rules->appendSeparator, buffer, &pos);
+  }
+
+  return pos;
+}
+
+@interface EWCDisplayFormatter () {
+  NSNumberFormatter *_formatter;  // the fallback formatter, created on first use
+  unichar _buffer[EWCDisplayFormatterBufferSize];  // reused output buffer
+}
+
+@end
+
+@implementation EWCDisplayFormatter
+
+///----------------------------------------------
+/// @name Construction and Initialization Methods
+///----------------------------------------------
+
++ (instancetype)formatterWithLocale:(NSLocale *)locale
+  maximumFractionDigits:(NSInteger)maximumFractionDigits {
+  return [[EWCDisplayFormatter alloc] initWithLocale:locale
+    maximumFractionDigits:maximumFractionDigits];
+}
+
++ (instancetype)formatterWithDescriptor:(EWCLocaleDescriptor *)descriptor
+  maximumFractionDigits:(NSInteger)maximumFractionDigits {
+  return [[EWCDisplayFormatter alloc] initWithDescriptor:descriptor
+    maximumFractionDigits:maximumFractionDigits];
+}
+
+- (instancetype)initWithLocale:(NSLocale *)locale
+  maximumFractionDigits:(NSInteger)maximumFractionDigits {
+  return [self initWithDescriptor:[EWCLocaleDescriptor descriptorForLocale:locale]
+    maximumFractionDigits:maximumFractionDigits];
+}
+
+- (instancetype)initWithDescriptor:(EWCLocaleDescriptor *)descriptor
+  maximumFractionDigits:(NSInteger)maximumFractionDigits {
+  self = [super init];
+  if (self) {
+    _descriptor = descriptor;
+    _maximumFractionDigits = maximumFractionDigits;
+  }
+
+  return self;
+}
+
+///------------------------------
+/// @name Custom Property Methods
+///------------------------------
+
+- (NSLocale *)locale {
+  return _descriptor.locale;
+}
+
+///---------------------------------------------------------------
+/// @name Public Properties and Methods (documented in the header)
+///---------------------------------------------------------------
+
+- (NSString *)stringFromDecimal:(NSDecimal)value
+  minimumFractionDigits:(NSInteger)minimumFractionDigits {
+
+  NSString *display = [self directStringFromDecimal:value
+    minimumFractionDigits:minimumFractionDigits];
+
+  if (! display) {
+    display = [self formattedStringFromDecimal:value
+      minimumFractionDigits:minimumFractionDigits];
+  }
+
+  return display;
+}
+
+- (NSUInteger)renderDecimal:(NSDecimal)value
+  minimumFractionDigits:(NSInteger)minimumFractionDigits
+  intoBuffer:(unichar *)buffer
+  capacity:(NSUInteger)capacity {
+
+  const EWCLocaleNumberRules *rules = _descriptor.numberRules;
+  if (! rules) { return 0; }
+
+  return EWCDisplayRenderDecimal(rules, value,
+    _maximumFractionDigits, minimumFractionDigits,
+    buffer, capacity);
+}
+
+///--------------------------------
+/// @name Internal Rendering Methods
+///--------------------------------
+
+/**
+  Renders a value into the reused buffer.
+
+  @param value The value to render.
+  @param minimumFractionDigits The minimum number of fractional digits to show.
+
+  @return The rendered string, or nil if the value couldn't be rendered directly.
+ */
+- (nullable NSString *)directStringFromDecimal:(NSDecimal)value
+  minimumFractionDigits:(NSInteger)minimumFractionDigits {
+
+  NSUInteger length = [self renderDecimal:value
+    minimumFractionDigits:minimumFractionDigits
+    intoBuffer:_buffer
+    capacity:EWCDisplayFormatterBufferSize];
+
+  if (length == 0) {
+    return nil;
+  }
+
+  return [[NSString alloc] initWithCharacters:_buffer length:length];
+}
+
+/**
+  Renders a value using the reference `NSNumberFormatter`.
+
+  The formatted string is then given a decimal separator if it didn't end up with one, since the display always shows one, even if there are no fractional digits.
+
+  @param value The value to render.
+  @param minimumFractionDigits The minimum number of fractional digits to show.
+
+  @return The formatted string.
+ */
+- (NSString *)formattedStringFromDecimal:(NSDecimal)value
+  minimumFractionDigits:(NSInteger)minimumFractionDigits {
+
+  if (! _formatter) {
+    // this is the same configuration the calculator display has always used
+    _formatter = [NSNumberFormatter new];
+    _formatter.maximumFractionDigits = _maximumFractionDigits;
+    _formatter.locale = _descriptor.locale;
+    [_formatter setNumberStyle:NSNumberFormatterDecimalStyle];
+  }
+
+  _formatter.minimumFractionDigits = minimumFractionDigits;
+  NSString *display = [_formatter stringFromNumber:[NSDecimalNumber decimalNumberWithDecimal:value]];
+
+  // append decimal separator if needed
+  NSString *separator = _descriptor.decimalSeparator;
+  if (! [display containsString:separator]) {
+    display = [display stringByAppendingString:separator];
+  }
+
+  return display;
+}
+
+@end
@@ -0,0 +1,192 @@
+//
+//  EWCGridHitMap.c
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "EWCGridHitMap.h"
+#include <math.h>
+#include <string.h>
+
+// cell marker for a cell no item has claimed (the same value as no item)
+#define EWCGridHitMapEmptyCell EWCGridHitMapNoItem
+
+// cell marker for a cell claimed by more than one item
+#define EWCGridHitMapSharedCell (-2)
+
+/**
+  Tests whether a point is in a frame, including the top and left edges but not the bottom and right, as `CGRectContainsPoint` does.
+
+  @param frame The frame.
+  @param x The horizontal position of the point.
+  @param y The vertical position of the point.
+
+  @return Whether the point is in the frame.
+ */
+static inline bool EWCGridHitRectContains(const EWCGridHitRect *frame, double x, double y) {
+  return x >= frame->x && x < frame->x + frame->width
+    && y >= frame->y && y < frame->y + frame->height;
+}
+
+/**
+  Finds the cell a position falls in along one axis, clamped to the grid.
+
+  @param position The position along the axis.
+  @param cellSize The size of a cell along the axis.
+  @param count The number of cells along the axis.
+
+  @return The cell index, from 0 to one less than the count.
+ */
+static inline int EWCGridHitMapCellIndex(double position, double cellSize, int count) {
+  double cell = floor(position / cellSize);
+  if (! (cell >= 0)) {
+    return 0;
+  }
+
+  return (cell >= count) ? count - 1 : (int)cell;
+}
+
+/**
+  Claims a range of cells for an item, marking any cell already claimed by another item as shared.
+
+  @param map The map.
+  @param item The index of the item.
+  @param top The first row.
+  @param left The first column.
+  @param bottom The last row (inclusive).
+  @param right The last column (inclusive).
+ */
+static void EWCGridHitMapClaim(EWCGridHitMap *map, int item,
+  int top, int left, int bottom, int right) {
+
+  for (int r = top; r <= bottom; ++r) {
+    int8_t *row = map->cells + r * map->columns;
+    for (int c = left; c <= right; ++c) {
+      if (row[c] == EWCGridHitMapEmptyCell) {
+        row[c] = (int8_t)item;
+      } else if (row[c] != item) {
+        row[c] = EWCGridHitMapSharedCell;
+      }
+    }
+  }
+}
+
+void EWCGridHitMapReset(EWCGridHitMap *map, int rows, int columns, double width, double height) {
+  map->rows = rows;
+  map->columns = columns;
+  map->width = width;
+  map->height = height;
+  map->itemCount = 0;
+  map->overhangs = false;
+
+  // only index grids with some area, and that fit in the table
+  map->indexed = rows > 0 && columns > 0
+    && width > 0 && height > 0
+    && rows <= EWCGridHitMapMaxCells / columns;
+
+  if (map->indexed) {
+    map->cellWidth = width / columns;
+    map->cellHeight = height / rows;
+    memset(map->cells, EWCGridHitMapEmptyCell, sizeof(map->cells[0]) * (size_t)(rows * columns));
+  } else {
+    map->cellWidth = 0;
+    map->cellHeight = 0;
+  }
+}
+
+int EWCGridHitMapAdd(EWCGridHitMap *map,
+  int startRow, int startColumn, int endRow, int endColumn,
+  EWCGridHitRect frame) {
+
+  if (map->itemCount >= EWCGridHitMapMaxItems) {
+    return EWCGridHitMapNoItem;
+  }
+
+  int item = map->itemCount++;
+  map->frames[item] = frame;
+
+  // an item reaching past the grid can be hit where there are no cells
+  if (! (frame.x >= 0 && frame.y >= 0
+    && frame.x + frame.width <= map->width
+    && frame.y + frame.height <= map->height)) {
+    map->overhangs = true;
+  }
+
+  if (! map->indexed) {
+    return item;
+  }
+
+  // claim the span the item was placed in
+  int top = (startRow < 0) ? 0 : startRow;
+  int left = (startColumn < 0) ? 0 : startColumn;
+  int bottom = (endRow >= map->rows) ? map->rows - 1 : endRow;
+  int right = (endColumn >= map->columns) ? map->columns - 1 : endColumn;
+  if (top <= bottom && left <= right) {
+    EWCGridHitMapClaim(map, item, top, left, bottom, right);
+  }
+
+  // and every cell the frame touches, in case it was laid out beyond its span.
+  // A point in the frame divides to a cell between the cells of the frame's
+  // edges (dividing by the same cell size can't reorder positions), so the
+  // cells found the same way for the edges cover every point that can hit it.
+  if (frame.width > 0 && frame.height > 0) {
+    EWCGridHitMapClaim(map, item,
+      EWCGridHitMapCellIndex(frame.y, map->cellHeight, map->rows),
+      EWCGridHitMapCellIndex(frame.x, map->cellWidth, map->columns),
+      EWCGridHitMapCellIndex(frame.y + frame.height, map->cellHeight, map->rows),
+      EWCGridHitMapCellIndex(frame.x + frame.width, map->cellWidth, map->columns));
+  }
+
+  return item;
+}
+
+int EWCGridHitMapFind(const EWCGridHitMap *map, double x, double y) {
+  if (! map->indexed) {
+    return EWCGridHitMapScan(map, x, y);
+  }
+
+  // outside the grid, only an overhanging frame can be hit
+  if (! (x >= 0 && x < map->width && y >= 0 && y < map->height)) {
+    return map->overhangs ? EWCGridHitMapScan(map, x, y) : EWCGridHitMapNoItem;
+  }
+
+  int row = EWCGridHitMapCellIndex(y, map->cellHeight, map->rows);
+  int column = EWCGridHitMapCellIndex(x, map->cellWidth, map->columns);
+  int item = map->cells[row * map->columns + column];
+
+  if (item == EWCGridHitMapSharedCell) {
+    return EWCGridHitMapScan(map, x, y);
+  }
+
+  // the cell may be empty, or the point may be in the item's gutter
+  if (item == EWCGridHitMapEmptyCell || ! EWCGridHitRectContains(&map->frames[item], x, y)) {
+    return EWCGridHitMapNoItem;
+  }
+
+  return item;
+}
+
+int EWCGridHitMapScan(const EWCGridHitMap *map, double x, double y) {
+  for (int i = 0; i < map->itemCount; ++i) {
+    if (EWCGridHitRectContains(&map->frames[i], x, y)) {
+      return i;
+    }
+  }
+
+  return EWCGridHitMapNoItem;
+}
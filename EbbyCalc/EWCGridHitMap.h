@@ -0,0 +1,120 @@
+//
+//  EWCGridHitMap.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef EWCGridHitMap_h
+#define EWCGridHitMap_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// the most items a hit map can hold
+#define EWCGridHitMapMaxItems 64
+
+// the most cells (rows × columns) a hit map can index.  Larger grids still
+// work, but every lookup scans the items.
+#define EWCGridHitMapMaxCells 1024
+
+// returned by a lookup that doesn't land on an item
+#define EWCGridHitMapNoItem (-1)
+
+/**
+  `EWCGridHitRect` is a rectangle in the coordinates of the grid, with its origin at the top left.
+ */
+typedef struct {
+  double x;  // the left edge
+  double y;  // the top edge
+  double width;  // the width
+  double height;  // the height
+} EWCGridHitRect;
+
+/**
+  `EWCGridHitMap` finds which item of a grid layout is under a point, using a table from each grid cell to the item occupying it.  Finding an item takes a division for each axis, a table read, and a check of that one item's frame.
+
+  Items are added with the cells they span and the frame they were actually given, which may be inset by gutters or adjusted by a custom layout.  The item claims both its span and every cell its frame touches, and its frame is what decides a hit, so a lookup always agrees with testing each frame in turn.  A cell claimed by more than one item falls back to testing the items in the order they were added.
+
+  The map holds no pointers, so it can live inside another object and be rebuilt in place whenever the layout changes.
+ */
+typedef struct {
+  int rows;  // the number of rows in the grid
+  int columns;  // the number of columns in the grid
+  double width;  // the width of the grid
+  double height;  // the height of the grid
+  double cellWidth;  // the width of a single cell
+  double cellHeight;  // the height of a single cell
+  bool indexed;  // whether the cell table is in use (the grid is non-empty and small enough)
+  bool overhangs;  // whether any item frame extends outside the grid
+  int itemCount;  // the number of items added
+  EWCGridHitRect frames[EWCGridHitMapMaxItems];  // the frame of each item
+  int8_t cells[EWCGridHitMapMaxCells];  // the item in each cell, row by row, or one of the marker values
+} EWCGridHitMap;
+
+/**
+  Clears a map and sets the dimensions of the grid it covers.
+
+  @param map The map to reset.
+  @param rows The number of rows in the grid.
+  @param columns The number of columns in the grid.
+  @param width The width of the grid.
+  @param height The height of the grid.
+ */
+void EWCGridHitMapReset(EWCGridHitMap *map, int rows, int columns, double width, double height);
+
+/**
+  Adds an item to a map.
+
+  @param map The map to add to.
+  @param startRow The first row the item spans.
+  @param startColumn The first column the item spans.
+  @param endRow The last row the item spans (inclusive).
+  @param endColumn The last column the item spans (inclusive).
+  @param frame The frame the item was laid out in.
+
+  @return The index of the item (items are numbered from 0 in the order added), or `EWCGridHitMapNoItem` if the map is full.
+ */
+int EWCGridHitMapAdd(EWCGridHitMap *map,
+  int startRow, int startColumn, int endRow, int endColumn,
+  EWCGridHitRect frame);
+
+/**
+  Finds the item under a point.
+
+  A point is in a frame if it is on the top or left edge or inside it, matching `CGRectContainsPoint`.
+
+  @param map The map to search.
+  @param x The horizontal position of the point.
+  @param y The vertical position of the point.
+
+  @return The index of the item, or `EWCGridHitMapNoItem` if the point isn't in any item's frame.
+ */
+int EWCGridHitMapFind(const EWCGridHitMap *map, double x, double y);
+
+/**
+  Finds the item under a point by testing every frame in the order added, without using the cell table.  This is the reference the table lookup must agree with.
+
+  @param map The map to search.
+  @param x The horizontal position of the point.
+  @param y The vertical position of the point.
+
+  @return The index of the item, or `EWCGridHitMapNoItem` if the point isn't in any item's frame.
+ */
+int EWCGridHitMapScan(const EWCGridHitMap *map, double x, double y);
+
+#endif /* EWCGridHitMap_h */
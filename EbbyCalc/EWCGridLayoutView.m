@@ -21,6 +21,8 @@
 
 #import "EWCGridLayoutView.h"
 #import "EWCGridLayoutProps.h"
+#import "EWCGridHitMap.h"
+#import "EWCLayoutSolver.h"
 
 /**
   Static helper to assign the current stroke color
@@ -38,6 +40,16 @@ static void setStrokeColor(CGContextRef context, UIColor *color)
 @interface EWCGridLayoutView() {
   NSMapTable<UIView *, EWCGridLayoutProps *> *_layoutProps;  // track the configurations of the child views
   __weak UIButton *_currentChild;  // track the last child that was the target of a touch event
+  EWCGridHitMap _hitMap;  // finds the button under a touch from the grid cell it lands in
+  NSPointerArray *_hitButtons;  // the buttons in the hit map, by item index (weak)
+  BOOL _hitMapValid;  // whether the hit map reflects the current children and layout
+  BOOL _hitMapComplete;  // whether every button fit in the hit map
+  BOOL _laidOut;  // whether the children are laid out for the grid settings below
+  CGSize _laidOutSize;  // the size the children were last laid out for
+  NSInteger _laidOutRows;  // the number of rows the children were last laid out for
+  NSInteger _laidOutColumns;  // the number of columns the children were last laid out for
+  CGFloat _laidOutRowGutter;  // the row gutter the children were last laid out for
+  CGFloat _laidOutColumnGutter;  // the column gutter the children were last laid out for
 }
 
 @end
@@ -82,6 +94,11 @@ static void setStrokeColor(CGContextRef context, UIColor *color)
   [_layoutProps setObject:[EWCGridLayoutProps propsForView:subView
     withStartingRow:startRow column:startColumn
     endingRow:endRow column:endColumn withLayout:callback] forKey:subView];
+
+  // the children need to be laid out again, and the hit map rebuilt
+  _laidOut = NO;
+  _hitMapValid = NO;
+  [self setNeedsLayout];
 }
 
 ///-------------------
@@ -130,6 +147,10 @@ static void setStrokeColor(CGContextRef context, UIColor *color)
   _columnGutter = 0;
   _layoutProps = [NSMapTable<UIView *, EWCGridLayoutProps *> weakToStrongObjectsMapTable];
   _currentChild = nil;
+  _hitButtons = [NSPointerArray weakObjectsPointerArray];
+  _hitMapValid = NO;
+  _hitMapComplete = NO;
+  _laidOut = NO;
   _showDebugDraw = NO;
 }
 
@@ -146,65 +167,44 @@ static void setStrokeColor(CGContextRef context, UIColor *color)
  */
 - (void)layoutSubviews {
 
-  CGFloat rowTotal = _rows;
-  CGFloat columnTotal = _columns;
   CGFloat gridWidth = self.frame.size.width;
   CGFloat gridHeight = self.frame.size.height;
   CGFloat rowGutter = self.rowGutter;
   CGFloat columnGutter = self.columnGutter;
 
+  // nothing to do if neither the children nor the grid have changed since
+  // the last layout (a layout pass is often requested for other reasons)
+  if (_laidOut && gridWidth == _laidOutSize.width && gridHeight == _laidOutSize.height
+    && _rows == _laidOutRows && _columns == _laidOutColumns
+    && rowGutter == _laidOutRowGutter && columnGutter == _laidOutColumnGutter) {
+    return;
+  }
+
+  _laidOut = YES;
+  _laidOutSize = CGSizeMake(gridWidth, gridHeight);
+  _laidOutRows = _rows;
+  _laidOutColumns = _columns;
+  _laidOutRowGutter = rowGutter;
+  _laidOutColumnGutter = columnGutter;
+
   // determine the minimum width and height in case a control requests
   // custom layout
-  CGFloat minWidth = 0, minHeight = 0;
-  {
-    CGRect minFrame = [self makeChildRectForGridHeight:gridHeight
-      gridWidth:gridWidth
-      rowTop:0
-      rowSpan:1.0
-      rowGutter:rowGutter
-      rowTotal:rowTotal
-      columnLeft:0
-      columnSpan:1.0
-      columnGutter:columnGutter
-      columnTotal:columnTotal];
-
-    minHeight = minFrame.size.height;
-    minWidth = minFrame.size.width;
-  }
+  EWCLayoutRect minFrame = EWCLayoutCellRect(gridWidth, gridHeight,
+    (int)_rows, (int)_columns, rowGutter, columnGutter, 0, 0, 0, 0);
+  CGFloat minWidth = minFrame.width;
+  CGFloat minHeight = minFrame.height;
 
   // layout any child objects based on the props
   for (EWCGridLayoutProps *props in [_layoutProps objectEnumerator]) {
     UIView *view = props.view;
     EWCRowColumnBounds bounds = props.bounds;
 
-    // sum the rows and columns spanned by this view
-    CGFloat rowSpan = 0, rowTop = 0, columnSpan = 0, columnLeft = 0;
-    for (NSInteger r = 0; r <= bounds.endRow; ++r) {
-      if (r < bounds.startRow) {
-        rowTop += 1.0;
-      } else {
-        rowSpan += 1.0;
-      }
-    }
-    for (NSInteger c = 0; c <= bounds.endColumn; ++c) {
-      if (c < bounds.startColumn) {
-        columnLeft += 1.0;
-      } else {
-        columnSpan += 1.0;
-      }
-    }
-
     // Calculate a frame that encompasses the grid area.
-    CGRect childFrame = [self makeChildRectForGridHeight:gridHeight
-      gridWidth:gridWidth
-      rowTop:rowTop
-      rowSpan:rowSpan
-      rowGutter:rowGutter
-      rowTotal:rowTotal
-      columnLeft:columnLeft
-      columnSpan:columnSpan
-      columnGutter:columnGutter
-      columnTotal:columnTotal];
+    EWCLayoutRect rect = EWCLayoutCellRect(gridWidth, gridHeight,
+      (int)_rows, (int)_columns, rowGutter, columnGutter,
+      (int)bounds.startRow, (int)bounds.startColumn,
+      (int)bounds.endRow, (int)bounds.endColumn);
+    CGRect childFrame = CGRectMake(rect.x, rect.y, rect.width, rect.height);
 
     // if the record for the current child has a custom callback, allow that
     // to perform layout.  Otherwise, just use the calculated grid area to set
@@ -219,6 +219,9 @@ static void setStrokeColor(CGContextRef context, UIColor *color)
     // give the view a chance to lay itself out if the frame changes require it
     [view layoutIfNeeded];
   }
+
+  // now that the frames are final, index them for touch tracking
+  [self rebuildHitMap];
 }
 
 /**
@@ -302,57 +305,6 @@ static void setStrokeColor(CGContextRef context, UIColor *color)
   }
 }
 
-///----------------------------
-/// @name Layout Helper Methods
-///----------------------------
-
-/**
-  Creates a frame for a grid region according to the supplied configuration.
-
-  @param gridHeight The total height of the grid.
-  @param gridWidth The total width of the grid.
-  @param rowTop The row where the grid area starts.
-  @param rowSpan The number of rows the grid area spans.
-  @param rowGutter The row gutter setting (a percent of the grid height).
-  @param rowTotal The total number of rows in the grid.
-  @param columnLeft The columns where the grid area starts.
-  @param columnSpan The number of columns the grid area spans.
-  @param columnGutter The column gutter setting (a percent of the grid width).
-  @param columnTotal The total number of columns in the grid.
-
-  @return The frame area of the specified grid region.
- */
-- (CGRect)makeChildRectForGridHeight:(CGFloat)gridHeight
-  gridWidth:(CGFloat)gridWidth
-  rowTop:(CGFloat)rowTop
-  rowSpan:(CGFloat)rowSpan
-  rowGutter:(CGFloat)rowGutter
-  rowTotal:(CGFloat)rowTotal
-  columnLeft:(CGFloat)columnLeft
-  columnSpan:(CGFloat)columnSpan
-  columnGutter:(CGFloat)columnGutter
-  columnTotal:(CGFloat)columnTotal {
-
-  CGFloat top, right, bottom, left, width, height;
-  top = gridHeight * (rowTop / rowTotal);
-  height = gridHeight * (rowSpan / rowTotal);
-  bottom = top + height;
-  left = gridWidth * (columnLeft / columnTotal);
-  width = gridWidth * (columnSpan / columnTotal);
-  right = left + width;
-
-  CGFloat gutterWidth = columnGutter * gridWidth / 2.0;
-  CGFloat gutterHeight = rowGutter * gridHeight / 2.0;
-
-  CGRect frame = CGRectMake(
-    left + gutterWidth,
-    top + gutterHeight,
-    width - (2 * gutterWidth),
-    height - (2 * gutterHeight));
-
-  return frame;
-}
-
 ///---------------------------
 /// @name Touch Helper Methods
 ///---------------------------
@@ -365,32 +317,18 @@ static void setStrokeColor(CGContextRef context, UIColor *color)
   @param touch Information about the touch, including such information as the location.
  */
 - (void)handleTouch:(UITouch *)touch {
-  CGPoint pos = [touch locationInView:self];
-  BOOL buttonFound = NO;
-
-  for (UIView *view in _layoutProps.keyEnumerator) {
-    if ([view isKindOfClass:[UIButton class]]) {
-      UIButton *button = (UIButton *)view;
-
-      // is the touch in the ui element?
-      if (CGRectContainsPoint(button.frame, pos)) {
-        // if not the current button, unhighlight the old and highlight the new
-        if (button != _currentChild) {
-          [self clearCurrentButton];
-          _currentChild = button;
-          [button setHighlighted:YES];
-        }
-
-        // done processing buttons
-        buttonFound = YES;
-        break;
-      }
+  UIButton *button = [self buttonAtPoint:[touch locationInView:self]];
+
+  if (button) {
+    // if not the current button, unhighlight the old and highlight the new
+    if (button != _currentChild) {
+      [self clearCurrentButton];
+      _currentChild = button;
+      [button setHighlighted:YES];
     }
-  }
-
-  // no button found
-  if (! buttonFound) {
-    [ self clearCurrentButton];
+  } else {
+    // no button found
+    [self clearCurrentButton];
   }
 }
 
@@ -402,26 +340,102 @@ static void setStrokeColor(CGContextRef context, UIColor *color)
  @param touch Information about the touch, including such information as the location.
  */
 - (void)handleTouchEnded:(UITouch *)touch {
+  UIButton *button = [self buttonAtPoint:[touch locationInView:self]];
+
+  if (button) {
+    // clear the current (which should be this, but doesn't matter if not)
+    [self clearCurrentButton];
+
+    // handle the current button
+    [button sendActionsForControlEvents:UIControlEventTouchUpInside];
+  }
+}
 
-  CGPoint pos = [touch locationInView:self];
+/**
+  Finds the button under a point.
+
+  Looks the point up in the hit map (rebuilding it first if the children or layout have changed since it was built), so that not every child needs to be tested.
+
+  @param pos The point, in our coordinates.
+
+  @return The button whose frame contains the point, or nil if there isn't one.
+ */
+- (nullable UIButton *)buttonAtPoint:(CGPoint)pos {
+  CGSize size = self.frame.size;
+  if (! _hitMapValid
+    || _hitMap.rows != _rows || _hitMap.columns != _columns
+    || _hitMap.width != size.width || _hitMap.height != size.height) {
+    [self rebuildHitMap];
+  }
+
+  if (! _hitMapComplete) {
+    return [self buttonAtPointByScanning:pos];
+  }
 
+  int item = EWCGridHitMapFind(&_hitMap, pos.x, pos.y);
+  if (item == EWCGridHitMapNoItem) {
+    return nil;
+  }
+
+  return (__bridge UIButton *)[_hitButtons pointerAtIndex:(NSUInteger)item];
+}
+
+/**
+  Finds the button under a point by testing the frame of every child.  Only used when there are more buttons than the hit map can hold.
+
+  @param pos The point, in our coordinates.
+
+  @return The button whose frame contains the point, or nil if there isn't one.
+ */
+- (nullable UIButton *)buttonAtPointByScanning:(CGPoint)pos {
   for (UIView *view in _layoutProps.keyEnumerator) {
     if ([view isKindOfClass:[UIButton class]]) {
       UIButton *button = (UIButton *)view;
 
       // is the touch in the ui element?
       if (CGRectContainsPoint(button.frame, pos)) {
-        // clear the current (which should be this, but doesn't matter if not)
-        [self clearCurrentButton];
+        return button;
+      }
+    }
+  }
+
+  return nil;
+}
 
-        // handle the current button
-        [button sendActionsForControlEvents:UIControlEventTouchUpInside];
+/**
+  Rebuilds the hit map from the grid dimensions and the current frame of each button child.
 
-        // done processing buttons
-        break;
-      }
+  Each button is added with the cells it was placed in and the frame it was actually given (after gutters and any custom layout), so that lookups agree with testing the frames directly.
+ */
+- (void)rebuildHitMap {
+  CGSize size = self.frame.size;
+  EWCGridHitMapReset(&_hitMap, (int)_rows, (int)_columns, size.width, size.height);
+  _hitButtons.count = 0;
+  _hitMapComplete = YES;
+
+  for (EWCGridLayoutProps *props in [_layoutProps objectEnumerator]) {
+    UIView *view = props.view;
+    if (! [view isKindOfClass:[UIButton class]]) {
+      continue;
+    }
+
+    EWCRowColumnBounds bounds = props.bounds;
+    CGRect frame = view.frame;
+    int item = EWCGridHitMapAdd(&_hitMap,
+      (int)bounds.startRow, (int)bounds.startColumn,
+      (int)bounds.endRow, (int)bounds.endColumn,
+      (EWCGridHitRect){ frame.origin.x, frame.origin.y, frame.size.width, frame.size.height });
+
+    if (item == EWCGridHitMapNoItem) {
+      // too many buttons to index, so touches will test every child instead
+      _hitMapComplete = NO;
+      break;
     }
+
+    [_hitButtons addPointer:(__bridge void *)view];
   }
+
+  _hitMapValid = YES;
 }
 
 /**
@@ -0,0 +1,173 @@
+//
+//  EWCKeyMap.c
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "EWCKeyMap.h"
+
+#include <string.h>
+
+// the most multipliers tried for each table size before trying a larger table
+#define EWCKeyMapMaxAttempts 4096
+
+/**
+  Empties the compiled table.  With a multiplier of zero and a shift of 31, every character hashes to the first slot, which is empty, so the map maps nothing.
+
+  @param map The map.
+ */
+static void EWCKeyMapClearTable(EWCKeyMap *map) {
+  for (uint32_t i = 0; i < (1 << EWCKeyMapMaxTableBits); ++i) {
+    map->table[i].character = 0;
+    map->table[i].key = EWCKeyMapNoKey;
+  }
+
+  map->multiplier = 0;
+  map->shift = 31;
+  map->compiled = false;
+}
+
+void EWCKeyMapInit(EWCKeyMap *map) {
+  memset(map->entries, 0, sizeof(map->entries));
+  map->entryCount = 0;
+
+  EWCKeyMapClearTable(map);
+}
+
+bool EWCKeyMapAdd(EWCKeyMap *map, uint16_t character, int key) {
+  if (character == 0) {
+    return false;
+  }
+
+  map->compiled = false;
+
+  for (uint32_t i = 0; i < map->entryCount; ++i) {
+    if (map->entries[i].character == character) {
+      map->entries[i].key = (int8_t)key;
+      return true;
+    }
+  }
+
+  if (map->entryCount >= EWCKeyMapMaxEntries) {
+    return false;
+  }
+
+  map->entries[map->entryCount].character = character;
+  map->entries[map->entryCount].key = (int8_t)key;
+  ++map->entryCount;
+
+  return true;
+}
+
+/**
+  Checks whether a multiplier gives every entry its own slot.
+
+  @param map The map.
+  @param multiplier The multiplier to try.
+  @param shift The shift for the table size.
+  @param stamps Scratch marks, one per slot, holding the attempt that last used each slot.
+  @param attempt The number of this attempt, which must not be 0.
+
+  @return Whether no two entries share a slot.
+ */
+static bool EWCKeyMapIsPerfect(const EWCKeyMap *map, uint32_t multiplier, uint32_t shift,
+  uint32_t *stamps, uint32_t attempt) {
+
+  for (uint32_t i = 0; i < map->entryCount; ++i) {
+    uint32_t slot = (uint32_t)(map->entries[i].character * multiplier) >> shift;
+    if (stamps[slot] == attempt) {
+      return false;
+    }
+    stamps[slot] = attempt;
+  }
+
+  return true;
+}
+
+bool EWCKeyMapCompile(EWCKeyMap *map) {
+  EWCKeyMapClearTable(map);
+
+  // start from the smallest table with some room to spare, since a full table
+  // takes many more tries to find a perfect hash for
+  uint32_t bits = 1;
+  while ((1u << bits) < map->entryCount * 2) {
+    ++bits;
+  }
+
+  uint32_t stamps[1 << EWCKeyMapMaxTableBits];
+  uint32_t attempt = 0;
+
+  for (; bits <= EWCKeyMapMaxTableBits; ++bits) {
+    uint32_t shift = 32 - bits;
+
+    // the multipliers come from a fixed sequence, so a map always compiles
+    // to the same table
+    uint32_t state = 2463534242u;
+    memset(stamps, 0, sizeof(stamps));
+    attempt = 0;
+
+    for (int i = 0; i < EWCKeyMapMaxAttempts; ++i) {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      uint32_t multiplier = state | 1;
+
+      if (EWCKeyMapIsPerfect(map, multiplier, shift, stamps, ++attempt)) {
+        for (uint32_t e = 0; e < map->entryCount; ++e) {
+          uint32_t slot = (uint32_t)(map->entries[e].character * multiplier) >> shift;
+          map->table[slot] = map->entries[e];
+        }
+
+        map->multiplier = multiplier;
+        map->shift = shift;
+        map->compiled = true;
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+uint32_t EWCKeyMapTableSize(const EWCKeyMap *map) {
+  return map->compiled ? (1u << (32 - map->shift)) : 0;
+}
+
+size_t EWCKeyMapTranslate(const EWCKeyMap *map, const uint16_t *characters, size_t length,
+  int *keys, size_t *unmappedCount) {
+
+  size_t count = 0;
+  size_t unmapped = 0;
+  for (size_t i = 0; i < length; ++i) {
+    int key = EWCKeyMapLookup(map, characters[i]);
+    if (key != EWCKeyMapNoKey) {
+      keys[count++] = key;
+    } else {
+      uint16_t c = characters[i];
+      if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+        ++unmapped;
+      }
+    }
+  }
+
+  if (unmappedCount) {
+    *unmappedCount = unmapped;
+  }
+
+  return count;
+}
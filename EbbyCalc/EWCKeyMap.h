@@ -0,0 +1,127 @@
+//
+//  EWCKeyMap.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef EWCKeyMap_h
+#define EWCKeyMap_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// the most characters a map can hold
+#define EWCKeyMapMaxEntries 128
+
+// the most bits of hash a compiled map can use, so the largest table is
+// 2^EWCKeyMapMaxTableBits slots
+#define EWCKeyMapMaxTableBits 10
+
+// the key a character maps to when it has no mapping (`EWCCalculatorNoKey`)
+#define EWCKeyMapNoKey -1
+
+/**
+  `EWCKeyMapSlot` is one entry of a compiled map.
+ */
+typedef struct {
+  uint16_t character;  // the UTF-16 character, or 0 if the slot is empty
+  int8_t key;  // the key the character maps to, or `EWCKeyMapNoKey` if the slot is empty
+} EWCKeyMapSlot;
+
+/**
+  `EWCKeyMap` maps single characters to calculator keys (`EWCCalculatorKey` values), for hardware keyboard commands, pasted text, and the plain text key notation of the command line tools.
+
+  A map is built by adding characters, then compiled into a perfect hash: a table with a slot for every character, found by one multiply and shift, with no two characters sharing a slot.  Looking up a character then takes a single probe, and never allocates.
+
+  The map holds no allocations of its own, so it can live inside another object.
+ */
+typedef struct {
+  EWCKeyMapSlot entries[EWCKeyMapMaxEntries];  // the characters added, in the order they were first added
+  uint32_t entryCount;  // the number of characters added
+  uint32_t multiplier;  // the odd multiplier of the hash
+  uint32_t shift;  // how far the product is shifted down to give the slot
+  bool compiled;  // whether the table matches the entries
+  EWCKeyMapSlot table[1 << EWCKeyMapMaxTableBits];  // the compiled slots, indexed by the hash
+} EWCKeyMap;
+
+/**
+  Sets up an empty map.
+
+  @param map The map.
+ */
+void EWCKeyMapInit(EWCKeyMap *map);
+
+/**
+  Maps a character to a key, replacing any earlier mapping of the character.  The map must be compiled again before use.
+
+  @param map The map.
+  @param character The UTF-16 character.  0 can't be mapped.
+  @param key The key.
+
+  @return Whether the character was mapped.  It isn't if it is 0, or the map is full.
+ */
+bool EWCKeyMapAdd(EWCKeyMap *map, uint16_t character, int key);
+
+/**
+  Compiles the characters added into the lookup table.
+
+  @param map The map.
+
+  @return Whether a perfect hash was found.  If not (which needs a map far larger than the keypad), the map is left uncompiled, and maps nothing.
+ */
+bool EWCKeyMapCompile(EWCKeyMap *map);
+
+/**
+  Gets the number of slots in the compiled table.
+
+  @param map The map.
+
+  @return The slot count, or 0 if the map isn't compiled.
+ */
+uint32_t EWCKeyMapTableSize(const EWCKeyMap *map);
+
+/**
+  Translates a run of characters to keys, as for pasted text.
+
+  @param map The compiled map.
+  @param characters The UTF-16 characters.
+  @param length The number of characters.
+  @param keys Receives the keys, in order, skipping characters that aren't mapped.  Must have room for `length` keys.
+  @param unmappedCount Receives the number of characters skipped, other than spaces, tabs, and line breaks.  May be NULL.
+
+  @return The number of keys written.
+ */
+size_t EWCKeyMapTranslate(const EWCKeyMap *map, const uint16_t *characters, size_t length,
+  int *keys, size_t *unmappedCount);
+
+/**
+  Looks up the key a character maps to.
+
+  @param map The compiled map.
+  @param character The UTF-16 character.
+
+  @return The key, or `EWCKeyMapNoKey` if the character isn't mapped.
+ */
+static inline int EWCKeyMapLookup(const EWCKeyMap *map, uint16_t character) {
+  const EWCKeyMapSlot *slot = &map->table[(uint32_t)(character * map->multiplier) >> map->shift];
+
+  return (slot->character == character) ? slot->key : EWCKeyMapNoKey;
+}
+
+#endif /* EWCKeyMap_h */
@@ -0,0 +1,97 @@
+//
+//  EWCKeyRing.c
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "EWCKeyRing.h"
+
+void EWCKeyRingInit(EWCKeyRing *ring) {
+  for (int i = 0; i < EWCKeyRingCapacity; ++i) {
+    ring->keys[i] = 0;
+  }
+
+  atomic_init(&ring->head, 0);
+  atomic_init(&ring->droppedCount, 0);
+  atomic_init(&ring->tail, 0);
+  atomic_init(&ring->drainRequested, false);
+}
+
+bool EWCKeyRingPush(EWCKeyRing *ring, int32_t key) {
+  // only we write the head, and the consumer only moves the tail forward, so
+  // a stale tail can only make the ring look fuller than it is
+  uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+  if (head - tail >= EWCKeyRingCapacity) {
+    atomic_fetch_add_explicit(&ring->droppedCount, 1, memory_order_relaxed);
+    return false;
+  }
+
+  ring->keys[head & (EWCKeyRingCapacity - 1)] = key;
+
+  // publish the key only once it is written
+  atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+
+  return true;
+}
+
+bool EWCKeyRingRequestDrain(EWCKeyRing *ring) {
+  // whoever changes the flag from clear to set owns scheduling the drain.  the
+  // ordering pairs with the exchange in EWCKeyRingFinishDrain, so that either
+  // the consumer sees our key, or we see the flag cleared.
+  return ! atomic_exchange_explicit(&ring->drainRequested, true, memory_order_acq_rel);
+}
+
+uint32_t EWCKeyRingConsume(EWCKeyRing *ring, EWCKeyRingConsumer consumer, void *context) {
+  // take everything that was waiting when we started.  anything pushed while
+  // we run is left for the next drain, which FinishDrain will ask for.
+  uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+  uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+  uint32_t count = head - tail;
+  for (; tail != head; ++tail) {
+    consumer(ring->keys[tail & (EWCKeyRingCapacity - 1)], context);
+  }
+
+  // hand the slots back in one store
+  atomic_store_explicit(&ring->tail, tail, memory_order_release);
+
+  return count;
+}
+
+bool EWCKeyRingFinishDrain(EWCKeyRing *ring) {
+  atomic_exchange_explicit(&ring->drainRequested, false, memory_order_acq_rel);
+
+  // a key pushed before the flag was cleared saw it set, and didn't schedule a
+  // drain, so we must pick it up ourselves
+  uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+  uint32_t head = atomic_load_explicit(&ring->head, memory_order_seq_cst);
+  if (head == tail) {
+    return false;
+  }
+
+  // if the producer has since set the flag itself, its drain takes the keys
+  return ! atomic_exchange_explicit(&ring->drainRequested, true, memory_order_acq_rel);
+}
+
+uint32_t EWCKeyRingCount(EWCKeyRing *ring) {
+  uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+  uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+  return head - tail;
+}
@@ -0,0 +1,116 @@
+//
+//  EWCKeyRing.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef EWCKeyRing_h
+#define EWCKeyRing_h
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// the most keys that can wait in a ring (a power of two)
+#define EWCKeyRingCapacity 256
+
+// the size the producer and consumer counters are kept apart by, so that the
+// two threads don't contend for one cache line
+#define EWCKeyRingCacheLineSize 64
+
+/**
+  `EWCKeyRingConsumer` is called for each key taken from a ring.
+
+  @param key The key, in the order it was pushed.
+  @param context The context passed to `EWCKeyRingConsume`.
+ */
+typedef void (*EWCKeyRingConsumer)(int32_t key, void *context);
+
+/**
+  `EWCKeyRing` passes calculator keys (`EWCCalculatorKey` values) from the thread capturing them to the thread evaluating them, without locks.
+
+  There must be a single producer, which pushes keys, and a single consumer, which takes every waiting key in one batch.  So that the consumer only runs when there is work, the producer asks for a drain after pushing, and is told whether it needs to schedule one.  The consumer finishes each drain by checking that nothing arrived while the drain was wrapping up.
+
+  The ring holds no allocations of its own, so it can live inside another object.
+ */
+typedef struct {
+  int32_t keys[EWCKeyRingCapacity];  // the waiting keys
+  _Alignas(EWCKeyRingCacheLineSize) _Atomic uint32_t head;  // the count of keys pushed, only written by the producer
+  _Atomic uint64_t droppedCount;  // the number of keys refused by a full ring
+  _Alignas(EWCKeyRingCacheLineSize) _Atomic uint32_t tail;  // the count of keys taken, only written by the consumer
+  _Atomic bool drainRequested;  // whether a drain is scheduled, or running
+} EWCKeyRing;
+
+/**
+  Sets up an empty ring.
+
+  @param ring The ring.
+ */
+void EWCKeyRingInit(EWCKeyRing *ring);
+
+/**
+  Pushes a key.  This must only be called from the producer.
+
+  @param ring The ring.
+  @param key The key.
+
+  @return Whether the key was accepted.  It is refused if the ring is full.
+ */
+bool EWCKeyRingPush(EWCKeyRing *ring, int32_t key);
+
+/**
+  Asks for the waiting keys to be drained.  This must only be called from the producer, after pushing.
+
+  @param ring The ring.
+
+  @return Whether the caller must schedule the consumer.  If not, a drain is already scheduled (or running) and will take the keys.
+ */
+bool EWCKeyRingRequestDrain(EWCKeyRing *ring);
+
+/**
+  Takes every key waiting in the ring, in order.  This must only be called from the consumer.
+
+  The keys are released back to the producer together, once the last one has been consumed.
+
+  @param ring The ring.
+  @param consumer Called for each key.
+  @param context Passed to the consumer.
+
+  @return The number of keys taken.
+ */
+uint32_t EWCKeyRingConsume(EWCKeyRing *ring, EWCKeyRingConsumer consumer, void *context);
+
+/**
+  Ends a drain.  This must only be called from the consumer, after consuming.
+
+  @param ring The ring.
+
+  @return Whether keys arrived as the drain was ending, in which case the drain is still requested, and the consumer must consume again.
+ */
+bool EWCKeyRingFinishDrain(EWCKeyRing *ring);
+
+/**
+  Counts the waiting keys.  This may be called from either side, though the count may change as soon as it is read.
+
+  @param ring The ring.
+
+  @return The number of keys waiting.
+ */
+uint32_t EWCKeyRingCount(EWCKeyRing *ring);
+
+#endif /* EWCKeyRing_h */
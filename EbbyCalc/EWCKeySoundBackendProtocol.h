@@ -0,0 +1,63 @@
+//
+//  EWCKeySoundBackendProtocol.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCKeySoundRenderBlock` fills the next frames of audio output.  It is called on the audio thread, so must not allocate or block.
+
+  @param frames Receives the interleaved stereo frames, from -1 to 1.
+  @param frameCount The number of frames to fill.
+
+  @return Whether anything is playing.  If not, the frames are silent.
+ */
+typedef BOOL (^EWCKeySoundRenderBlock)(float *frames, uint32_t frameCount);
+
+/**
+  `EWCKeySoundBackendProtocol` is the audio output that `EWCKeySoundEngine` renders key sounds into.  Keeping it behind a protocol lets the sound engine be exercised without audio hardware.
+ */
+@protocol EWCKeySoundBackendProtocol <NSObject>
+
+/**
+  Whether output is running.  Output may stop on its own, for instance if audio is interrupted.
+ */
+@property (nonatomic, readonly, getter=isRunning) BOOL running;
+
+/**
+  Starts pulling frames from a render block, replacing any block already running.
+
+  @param sampleRate The frames per second the block renders.
+  @param renderBlock The block that renders each buffer of output.
+
+  @return YES if output started.
+ */
+- (BOOL)startWithSampleRate:(double)sampleRate renderBlock:(EWCKeySoundRenderBlock)renderBlock;
+
+/**
+  Stops output.  The render block won't be called again once this returns.
+ */
+- (void)stop;
+
+@end
+
+NS_ASSUME_NONNULL_END
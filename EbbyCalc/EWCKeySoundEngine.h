@@ -0,0 +1,136 @@
+//
+//  EWCKeySoundEngine.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import "EWCCalculatorKey.h"
+#import "EWCKeySoundBackendProtocol.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCKeySound` identifies the sound played for a key.
+ */
+typedef NS_ENUM(NSInteger, EWCKeySound) {
+  EWCKeyClickSound = 0,
+  EWCKeyDeleteSound,
+  EWCKeyModifySound,
+};
+
+/**
+  Gets the sound played for a key.
+
+  @param key The key pressed.
+
+  @return The sound for the key.
+ */
+EWCKeySound EWCKeySoundForKey(EWCCalculatorKey key);
+
+/**
+  `EWCKeySoundEngine` plays the key clicks from sounds that are decoded once, on a fixed pool of voices (see `EWCKeyVoicePool`), so that a key press only posts a request to the audio thread rather than creating and starting a player.
+ */
+@interface EWCKeySoundEngine : NSObject
+
+/**
+  The volume sounds are played at.  Defaults to 1.
+ */
+@property (nonatomic) float volume;
+
+/**
+  The frames per second of the sounds.
+ */
+@property (nonatomic, readonly) double sampleRate;
+
+/**
+  Whether the engine has been started (and not stopped).
+ */
+@property (nonatomic, readonly, getter=isStarted) BOOL started;
+
+/**
+  The number of sounds requested.
+ */
+@property (nonatomic, readonly) NSUInteger requestedCount;
+
+/**
+  The number of sound requests dropped because the audio thread had fallen behind.
+ */
+@property (nonatomic, readonly) NSUInteger droppedCount;
+
+/**
+  The number of sounds cut off to start another.  This is updated by the audio thread, so is only exact while the backend is stopped or idle.
+ */
+@property (nonatomic, readonly) NSUInteger stolenCount;
+
+/**
+  The number of voices playing.  Like `stolenCount`, this is only exact while the backend is stopped or idle.
+ */
+@property (nonatomic, readonly) NSUInteger activeVoiceCount;
+
+/**
+  Creates a new engine.
+
+  @param soundData The contents of the WAV file for each `EWCKeySound`, in order.
+  @param backend The audio output to play to.
+
+  @return The new engine, or nil if a sound couldn't be decoded, or the sounds have different sample rates.
+ */
++ (nullable instancetype)engineWithSoundData:(NSArray<NSData *> *)soundData
+  backend:(id<EWCKeySoundBackendProtocol>)backend;
+
+/**
+  Initializes an engine.
+
+  @param soundData The contents of the WAV file for each `EWCKeySound`, in order.
+  @param backend The audio output to play to.
+
+  @return The initialized instance, or nil if a sound couldn't be decoded, or the sounds have different sample rates.
+ */
+- (nullable instancetype)initWithSoundData:(NSArray<NSData *> *)soundData
+  backend:(id<EWCKeySoundBackendProtocol>)backend;
+
+/**
+  Starts the backend, so that sounds can be played.
+
+  @return YES if the backend started.
+ */
+- (BOOL)start;
+
+/**
+  Stops the backend.  Sounds are ignored until the engine is started again.
+ */
+- (void)stop;
+
+/**
+  Plays a sound, restarting the backend if it has stopped on its own.  Does nothing if the engine isn't started.
+
+  @param sound The sound to play.
+ */
+- (void)playSound:(EWCKeySound)sound;
+
+/**
+  Plays the sound for a key.
+
+  @param key The key pressed.
+ */
+- (void)playSoundForKey:(EWCCalculatorKey)key;
+
+@end
+
+NS_ASSUME_NONNULL_END
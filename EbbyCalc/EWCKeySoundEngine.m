@@ -0,0 +1,168 @@
+//
+//  EWCKeySoundEngine.m
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCKeySoundEngine.h"
+#import "EWCKeySoundSample.h"
+#import "EWCKeyVoicePool.h"
+
+EWCKeySound EWCKeySoundForKey(EWCCalculatorKey key) {
+  switch (key) {
+    case EWCCalculatorRateKey:
+      return EWCKeyModifySound;
+
+    case EWCCalculatorClearKey:
+    case EWCCalculatorBackspaceKey:
+      return EWCKeyDeleteSound;
+
+    default:
+      return EWCKeyClickSound;
+  }
+}
+
+@interface EWCKeySoundEngine() {
+  id<EWCKeySoundBackendProtocol> _backend;  // the audio output
+  EWCKeySoundSample _samples[EWCKeyVoicePoolMaxSounds];  // the decoded sounds
+  int _sampleCount;  // the number of decoded sounds
+  EWCKeyVoicePool _pool;  // mixes the sounds, shared with the audio thread
+}
+
+@end
+
+@implementation EWCKeySoundEngine
+
+///----------------------------------------------
+/// @name Construction and Initialization Methods
+///----------------------------------------------
+
++ (instancetype)engineWithSoundData:(NSArray<NSData *> *)soundData
+  backend:(id<EWCKeySoundBackendProtocol>)backend {
+  return [[EWCKeySoundEngine alloc] initWithSoundData:soundData backend:backend];
+}
+
+- (instancetype)initWithSoundData:(NSArray<NSData *> *)soundData
+  backend:(id<EWCKeySoundBackendProtocol>)backend {
+  self = [super init];
+  if (self) {
+    _backend = backend;
+    _volume = 1;
+
+    if (soundData.count == 0 || soundData.count > EWCKeyVoicePoolMaxSounds) {
+      return nil;
+    }
+
+    // decode everything up front, so that playing never has to
+    const EWCKeySoundSample *sounds[EWCKeyVoicePoolMaxSounds];
+    for (NSData *data in soundData) {
+      EWCKeySoundSample *sample = &_samples[_sampleCount];
+      if (! EWCKeySoundSampleDecodeWav(data.bytes, data.length, sample)) {
+        return nil;
+      }
+      sounds[_sampleCount++] = sample;
+
+      // the pool plays every sound at the one output rate
+      if (sample->sampleRate != _samples[0].sampleRate) {
+        return nil;
+      }
+    }
+
+    _sampleRate = _samples[0].sampleRate;
+    EWCKeyVoicePoolInit(&_pool, sounds, _sampleCount);
+  }
+
+  return self;
+}
+
+- (void)dealloc {
+  // the render block points into us, so it must be stopped before we go
+  [_backend stop];
+
+  for (int i = 0; i < _sampleCount; ++i) {
+    EWCKeySoundSampleFree(&_samples[i]);
+  }
+}
+
+///------------------------------
+/// @name Custom Property Methods
+///------------------------------
+
+- (NSUInteger)droppedCount {
+  return (NSUInteger)atomic_load_explicit(&_pool.droppedCount, memory_order_relaxed);
+}
+
+- (NSUInteger)stolenCount {
+  return (NSUInteger)_pool.stolenCount;
+}
+
+- (NSUInteger)activeVoiceCount {
+  return (NSUInteger)EWCKeyVoicePoolActiveCount(&_pool);
+}
+
+///---------------------
+/// @name Output Methods
+///---------------------
+
+- (BOOL)start {
+  _started = YES;
+  return [self startBackend];
+}
+
+- (void)stop {
+  _started = NO;
+  [_backend stop];
+}
+
+/**
+  Starts the backend rendering from the voice pool.
+
+  @return YES if the backend started.
+ */
+- (BOOL)startBackend {
+  // capture the pool rather than ourselves, since the audio thread must not
+  // touch the object
+  EWCKeyVoicePool *pool = &_pool;
+  return [_backend startWithSampleRate:_sampleRate renderBlock:^BOOL(float *frames, uint32_t frameCount) {
+    return EWCKeyVoicePoolRender(pool, frames, frameCount);
+  }];
+}
+
+///--------------------
+/// @name Sound Methods
+///--------------------
+
+- (void)playSound:(EWCKeySound)sound {
+  if (! _started) {
+    return;
+  }
+
+  // output stops on its own when audio is interrupted, so pick it back up
+  if (! _backend.isRunning && ! [self startBackend]) {
+    return;
+  }
+
+  ++_requestedCount;
+  EWCKeyVoicePoolTrigger(&_pool, (int)sound, _volume);
+}
+
+- (void)playSoundForKey:(EWCCalculatorKey)key {
+  [self playSound:EWCKeySoundForKey(key)];
+}
+
+@end
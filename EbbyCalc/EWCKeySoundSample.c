@@ -0,0 +1,150 @@
+//
+//  EWCKeySoundSample.c
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "EWCKeySoundSample.h"
+#include <stdlib.h>
+#include <string.h>
+
+// the WAV sample formats we can decode
+#define EWCWavFormatPCM 1
+#define EWCWavFormatFloat 3
+#define EWCWavFormatExtensible 0xfffe
+
+/**
+  Reads a little endian 16 bit value.
+ */
+static inline uint16_t EWCReadLE16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/**
+  Reads a little endian 32 bit value.
+ */
+static inline uint32_t EWCReadLE32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+  Converts one encoded sample to a float from -1 to 1.
+
+  @param p The encoded sample.
+  @param format Either `EWCWavFormatPCM` or `EWCWavFormatFloat`.
+  @param bits The size of the sample in bits.
+
+  @return The sample value.
+ */
+static inline float EWCWavSampleValue(const uint8_t *p, uint16_t format, uint16_t bits) {
+  if (format == EWCWavFormatFloat) {
+    uint32_t raw = EWCReadLE32(p);
+    float value;
+    memcpy(&value, &raw, sizeof(value));
+    return value;
+  }
+
+  if (bits == 8) {
+    // 8 bit samples are unsigned
+    return ((int)p[0] - 128) / 128.0f;
+  }
+
+  return (int16_t)EWCReadLE16(p) / 32768.0f;
+}
+
+bool EWCKeySoundSampleDecodeWav(const void *bytes, size_t length, EWCKeySoundSample *sample) {
+  memset(sample, 0, sizeof(*sample));
+
+  const uint8_t *data = bytes;
+  if (length < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0) {
+    return false;
+  }
+
+  // walk the chunks looking for the format and the samples
+  const uint8_t *fmt = NULL;
+  const uint8_t *samples = NULL;
+  uint32_t samplesLength = 0;
+  size_t offset = 12;
+  while (offset + 8 <= length) {
+    const uint8_t *chunk = data + offset;
+    uint32_t chunkLength = EWCReadLE32(chunk + 4);
+    size_t available = length - offset - 8;
+
+    if (memcmp(chunk, "fmt ", 4) == 0 && chunkLength >= 16 && chunkLength <= available) {
+      fmt = chunk + 8;
+    } else if (memcmp(chunk, "data", 4) == 0) {
+      // tolerate a truncated final chunk
+      samples = chunk + 8;
+      samplesLength = (chunkLength <= available) ? chunkLength : (uint32_t)available;
+    }
+
+    // chunks are padded to an even length
+    offset += 8 + (size_t)chunkLength + (chunkLength & 1);
+  }
+
+  if (! fmt || ! samples) {
+    return false;
+  }
+
+  uint16_t format = EWCReadLE16(fmt);
+  uint16_t channels = EWCReadLE16(fmt + 2);
+  uint32_t rate = EWCReadLE32(fmt + 4);
+  uint16_t blockAlign = EWCReadLE16(fmt + 12);
+  uint16_t bits = EWCReadLE16(fmt + 14);
+
+  // the extensible format carries the real format at the start of its guid
+  if (format == EWCWavFormatExtensible) {
+    if (EWCReadLE16(fmt + 16) < 22) {
+      return false;
+    }
+    format = EWCReadLE16(fmt + 24);
+  }
+
+  bool supported = (format == EWCWavFormatPCM && (bits == 8 || bits == 16))
+    || (format == EWCWavFormatFloat && bits == 32);
+  if (! supported || channels < 1 || channels > 2 || rate == 0
+    || blockAlign != channels * (bits / 8)) {
+    return false;
+  }
+
+  uint32_t frameCount = samplesLength / blockAlign;
+  float *frames = malloc(sizeof(float) * 2 * (frameCount ? frameCount : 1));
+  if (! frames) {
+    return false;
+  }
+
+  size_t sampleSize = bits / 8;
+  for (uint32_t i = 0; i < frameCount; ++i) {
+    const uint8_t *frame = samples + (size_t)i * blockAlign;
+    float left = EWCWavSampleValue(frame, format, bits);
+    float right = (channels == 2) ? EWCWavSampleValue(frame + sampleSize, format, bits) : left;
+    frames[2 * i] = left;
+    frames[2 * i + 1] = right;
+  }
+
+  sample->frames = frames;
+  sample->frameCount = frameCount;
+  sample->sampleRate = rate;
+
+  return true;
+}
+
+void EWCKeySoundSampleFree(EWCKeySoundSample *sample) {
+  free(sample->frames);
+  memset(sample, 0, sizeof(*sample));
+}
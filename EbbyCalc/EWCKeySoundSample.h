@@ -0,0 +1,56 @@
+//
+//  EWCKeySoundSample.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef EWCKeySoundSample_h
+#define EWCKeySoundSample_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+  `EWCKeySoundSample` is a decoded key sound, ready to be mixed without any further conversion.
+ */
+typedef struct {
+  float *frames;  // the samples, as interleaved stereo pairs from -1 to 1
+  uint32_t frameCount;  // the number of stereo frames
+  double sampleRate;  // the frames per second
+} EWCKeySoundSample;
+
+/**
+  Decodes the contents of a WAV file.  8 and 16 bit integer and 32 bit float samples are supported, in mono (which is played on both channels) or stereo.
+
+  @param bytes The contents of the file.
+  @param length The length of the contents.
+  @param sample Receives the decoded sound, which must later be released with `EWCKeySoundSampleFree`.  Left empty if the file can't be decoded.
+
+  @return Whether the file was decoded.
+ */
+bool EWCKeySoundSampleDecodeWav(const void *bytes, size_t length, EWCKeySoundSample *sample);
+
+/**
+  Releases the frames of a decoded sound, leaving it empty.  Releasing an empty sound does nothing.
+
+  @param sample The sound to release.
+ */
+void EWCKeySoundSampleFree(EWCKeySoundSample *sample);
+
+#endif /* EWCKeySoundSample_h */
@@ -0,0 +1,181 @@
+//
+//  EWCKeyStream.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import "EWCCalculatorKey.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  The key stream format records the inputs to a calculator so that they can be replayed through another calculator later.
+
+  A stream starts with a header of the 4 byte magic "EWCK", a version byte, and the maximum digits of the recorded calculator.  The rest of the stream is a series of blocks, each of which is a varint payload length, the payload, and a 4 byte little endian FNV-1a checksum of the payload.
+
+  The payload is a series of records.  Each record starts with a byte holding a 5 bit code in the low bits, and the milliseconds since the previous record in the high 3 bits.  A time value of 7 means that the actual delta follows as a varint.  Codes below 28 are `EWCCalculatorKey` values, and make up the whole record.  The other codes are followed by inline decimals: an input value, a display checkpoint (followed by a status byte), or the stored memory and tax rate the recording started with.
+
+  An inline decimal is a flags byte (bit 0 negative, bit 1 NaN), the exponent as a signed byte, the digit count, and then the digits packed two per byte, most significant first.
+ */
+
+/**
+  The version of the stream format written.
+ */
+#define EWCKeyStreamVersion 1
+
+/**
+  The size of the stream header.
+ */
+#define EWCKeyStreamHeaderSize 6
+
+/**
+  The largest an encoded inline decimal can be.
+ */
+#define EWCKeyStreamMaxDecimalSize 23
+
+/**
+  The largest an encoded record can be.
+ */
+#define EWCKeyStreamMaxRecordSize (1 + 10 + 2 * EWCKeyStreamMaxDecimalSize + 1)
+
+/**
+  The largest a block header (the payload length varint) can be.
+ */
+#define EWCKeyStreamMaxBlockHeaderSize 10
+
+/**
+  The size of the checksum following each block.
+ */
+#define EWCKeyStreamChecksumSize 4
+
+/**
+  `EWCKeyStreamRecordType` identifies the kind of input in a record.
+ */
+typedef NS_ENUM(NSInteger, EWCKeyStreamRecordType) {
+  EWCKeyStreamKeyRecord = 0,
+  EWCKeyStreamInputRecord,
+  EWCKeyStreamCheckpointRecord,
+  EWCKeyStreamStateRecord,
+};
+
+/**
+  `EWCKeyStreamStatus` is the result of reading from a stream.
+ */
+typedef NS_ENUM(NSInteger, EWCKeyStreamStatus) {
+  EWCKeyStreamRecordRead = 0,
+  EWCKeyStreamEnd,
+  EWCKeyStreamCorrupt,
+};
+
+/**
+  `EWCKeyStreamRecord` holds a single decoded record.  Only the members relevant to the record type are set.
+ */
+typedef struct {
+  EWCKeyStreamRecordType type;  // the kind of record
+  EWCCalculatorKey key;  // the key pressed, for key records
+  uint64_t delta;  // milliseconds since the previous record
+  NSDecimal value;  // the input value, the checkpoint display value, or the starting memory
+  NSDecimal taxRate;  // the starting tax rate, for state records
+  BOOL error;  // the error status, for checkpoint records
+} EWCKeyStreamRecord;
+
+/**
+  `EWCKeyStreamDecoder` reads records from an in-memory stream, verifying each block checksum as the block is entered.
+ */
+typedef struct {
+  const uint8_t *bytes;  // the stream
+  size_t length;  // the length of the stream
+  size_t position;  // the read position
+  size_t blockEnd;  // the end of the payload of the current block
+  size_t nextBlock;  // the start of the next block
+  BOOL corrupt;  // whether a bad block or record has been found
+  NSInteger maximumDigits;  // the maximum digits of the recorded calculator, from the header
+  NSUInteger blockCount;  // the number of blocks entered
+} EWCKeyStreamDecoder;
+
+///-----------------------
+/// @name Encoding Methods
+///-----------------------
+
+/**
+  Writes a stream header.
+
+  @param buffer Receives the header.  It must hold `EWCKeyStreamHeaderSize` bytes.
+  @param maximumDigits The maximum digits of the recorded calculator.
+
+  @return The number of bytes written.
+ */
+size_t EWCKeyStreamEncodeHeader(uint8_t *buffer, NSInteger maximumDigits);
+
+/**
+  Writes a varint.
+
+  @param value The value to write.
+  @param buffer Receives the varint.  It must hold 10 bytes.
+
+  @return The number of bytes written.
+ */
+size_t EWCKeyStreamEncodeVarint(uint64_t value, uint8_t *buffer);
+
+/**
+  Writes a record.
+
+  @param record The record to write.
+  @param buffer Receives the record.  It must hold `EWCKeyStreamMaxRecordSize` bytes.
+
+  @return The number of bytes written.
+ */
+size_t EWCKeyStreamEncodeRecord(const EWCKeyStreamRecord *record, uint8_t *buffer);
+
+/**
+  Computes the checksum of a block payload.
+
+  @param bytes The payload.
+  @param length The length of the payload.
+
+  @return The checksum.
+ */
+uint32_t EWCKeyStreamChecksum(const uint8_t *bytes, size_t length);
+
+///-----------------------
+/// @name Decoding Methods
+///-----------------------
+
+/**
+  Prepares to decode a stream, reading its header.
+
+  @param decoder The decoder to prepare.
+  @param bytes The stream.  It must stay valid while the decoder is in use.
+  @param length The length of the stream.
+
+  @return YES if the header is valid.
+ */
+BOOL EWCKeyStreamDecoderInit(EWCKeyStreamDecoder *decoder, const uint8_t *bytes, size_t length);
+
+/**
+  Reads the next record.
+
+  @param decoder The decoder to read from.
+  @param record Receives the record.
+
+  @return `EWCKeyStreamRecordRead` if a record was read, `EWCKeyStreamEnd` at the end of the stream, or `EWCKeyStreamCorrupt` if a checksum doesn't match or a record is malformed.
+ */
+EWCKeyStreamStatus EWCKeyStreamDecoderNext(EWCKeyStreamDecoder *decoder, EWCKeyStreamRecord *record);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,350 @@
+//
+//  EWCKeyStream.m
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCKeyStream.h"
+#import "EWCDecimalDigits.h"
+
+// the record codes that follow the key codes
+#define EWCKeyStreamInputCode 28
+#define EWCKeyStreamCheckpointCode 29
+#define EWCKeyStreamStateCode 30
+
+// the time value meaning that the delta follows as a varint
+#define EWCKeyStreamDeltaFollows 7
+
+// the inline decimal flags
+#define EWCKeyStreamNegativeFlag 0x01
+#define EWCKeyStreamNaNFlag 0x02
+
+// the checkpoint status flags
+#define EWCKeyStreamErrorFlag 0x01
+
+static const uint8_t s_magic[4] = { 'E', 'W', 'C', 'K' };
+
+///-----------------------
+/// @name Encoding Methods
+///-----------------------
+
+size_t EWCKeyStreamEncodeHeader(uint8_t *buffer, NSInteger maximumDigits) {
+  memcpy(buffer, s_magic, sizeof(s_magic));
+  buffer[4] = EWCKeyStreamVersion;
+  buffer[5] = (uint8_t)maximumDigits;
+
+  return EWCKeyStreamHeaderSize;
+}
+
+size_t EWCKeyStreamEncodeVarint(uint64_t value, uint8_t *buffer) {
+  size_t length = 0;
+  while (value >= 0x80) {
+    buffer[length++] = (uint8_t)(value | 0x80);
+    value >>= 7;
+  }
+  buffer[length++] = (uint8_t)value;
+
+  return length;
+}
+
+/**
+  Writes an inline decimal.
+
+  @param value The value to write.
+  @param buffer Receives the decimal.  It must hold `EWCKeyStreamMaxDecimalSize` bytes.
+
+  @return The number of bytes written.
+ */
+static size_t EWCKeyStreamEncodeDecimal(const NSDecimal *value, uint8_t *buffer) {
+  EWCDecimalDigits digits;
+  if (! EWCDecimalDigitsFromDecimal(value, &digits)) {
+    buffer[0] = EWCKeyStreamNaNFlag;
+    buffer[1] = 0;
+    buffer[2] = 0;
+    return 3;
+  }
+
+  buffer[0] = digits.negative ? EWCKeyStreamNegativeFlag : 0;
+  buffer[1] = (uint8_t)(int8_t)digits.exponent;
+  buffer[2] = (uint8_t)digits.count;
+
+  size_t length = 3;
+  for (short i = 0; i < digits.count; i += 2) {
+    uint8_t high = digits.digits[i];
+    uint8_t low = (i + 1 < digits.count) ? digits.digits[i + 1] : 0;
+    buffer[length++] = (uint8_t)((high << 4) | low);
+  }
+
+  return length;
+}
+
+size_t EWCKeyStreamEncodeRecord(const EWCKeyStreamRecord *record, uint8_t *buffer) {
+  uint8_t code;
+  switch (record->type) {
+    case EWCKeyStreamKeyRecord: code = (uint8_t)record->key; break;
+    case EWCKeyStreamInputRecord: code = EWCKeyStreamInputCode; break;
+    case EWCKeyStreamCheckpointRecord: code = EWCKeyStreamCheckpointCode; break;
+    case EWCKeyStreamStateRecord: code = EWCKeyStreamStateCode; break;
+  }
+
+  size_t length = 0;
+  if (record->delta < EWCKeyStreamDeltaFollows) {
+    buffer[length++] = (uint8_t)(code | (record->delta << 5));
+  } else {
+    buffer[length++] = (uint8_t)(code | (EWCKeyStreamDeltaFollows << 5));
+    length += EWCKeyStreamEncodeVarint(record->delta, buffer + length);
+  }
+
+  switch (record->type) {
+    case EWCKeyStreamKeyRecord:
+      break;
+
+    case EWCKeyStreamInputRecord:
+      length += EWCKeyStreamEncodeDecimal(&record->value, buffer + length);
+      break;
+
+    case EWCKeyStreamCheckpointRecord:
+      length += EWCKeyStreamEncodeDecimal(&record->value, buffer + length);
+      buffer[length++] = record->error ? EWCKeyStreamErrorFlag : 0;
+      break;
+
+    case EWCKeyStreamStateRecord:
+      length += EWCKeyStreamEncodeDecimal(&record->value, buffer + length);
+      length += EWCKeyStreamEncodeDecimal(&record->taxRate, buffer + length);
+      break;
+  }
+
+  return length;
+}
+
+uint32_t EWCKeyStreamChecksum(const uint8_t *bytes, size_t length) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < length; ++i) {
+    hash ^= bytes[i];
+    hash *= 16777619u;
+  }
+
+  return hash;
+}
+
+///-----------------------
+/// @name Decoding Methods
+///-----------------------
+
+BOOL EWCKeyStreamDecoderInit(EWCKeyStreamDecoder *decoder, const uint8_t *bytes, size_t length) {
+  if (length < EWCKeyStreamHeaderSize
+    || memcmp(bytes, s_magic, sizeof(s_magic)) != 0
+    || bytes[4] != EWCKeyStreamVersion) {
+    return NO;
+  }
+
+  decoder->bytes = bytes;
+  decoder->length = length;
+  decoder->position = EWCKeyStreamHeaderSize;
+  decoder->blockEnd = EWCKeyStreamHeaderSize;
+  decoder->nextBlock = EWCKeyStreamHeaderSize;
+  decoder->corrupt = NO;
+  decoder->maximumDigits = bytes[5];
+  decoder->blockCount = 0;
+
+  return YES;
+}
+
+/**
+  Reads a varint.
+
+  @param decoder The decoder to read from.
+  @param end The position the varint must end by.
+  @param value Receives the value.
+
+  @return YES if the varint was read.
+ */
+static BOOL EWCKeyStreamDecodeVarint(EWCKeyStreamDecoder *decoder, size_t end, uint64_t *value) {
+  uint64_t result = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (decoder->position >= end) { return NO; }
+
+    uint8_t byte = decoder->bytes[decoder->position++];
+    result |= (uint64_t)(byte & 0x7f) << shift;
+    if (! (byte & 0x80)) {
+      *value = result;
+      return YES;
+    }
+  }
+
+  return NO;
+}
+
+/**
+  Reads an inline decimal from the current block.
+
+  @param decoder The decoder to read from.
+  @param value Receives the value.
+
+  @return YES if the decimal was read.
+ */
+static BOOL EWCKeyStreamDecodeDecimal(EWCKeyStreamDecoder *decoder, NSDecimal *value) {
+  const uint8_t *bytes = decoder->bytes + decoder->position;
+  if (decoder->position + 3 > decoder->blockEnd) { return NO; }
+
+  uint8_t flags = bytes[0];
+  EWCDecimalDigits digits;
+  digits.exponent = (int8_t)bytes[1];
+  digits.count = bytes[2];
+  digits.negative = (flags & EWCKeyStreamNegativeFlag) != 0;
+
+  size_t packed = (digits.count + 1) / 2;
+  if (digits.count > EWCDecimalMaxDigitCount || decoder->position + 3 + packed > decoder->blockEnd) { return NO; }
+  decoder->position += 3 + packed;
+
+  if (flags & EWCKeyStreamNaNFlag) {
+    *value = [NSDecimalNumber notANumber].decimalValue;
+    return YES;
+  }
+
+  for (short i = 0; i < digits.count; ++i) {
+    uint8_t pair = bytes[3 + i / 2];
+    uint8_t digit = (i % 2) ? (pair & 0x0f) : (pair >> 4);
+    if (digit > 9) { return NO; }
+    digits.digits[i] = digit;
+  }
+
+  EWCDecimalFromDigits(&digits, value);
+
+  return YES;
+}
+
+/**
+  Enters the block at the read position, verifying its checksum.
+
+  @param decoder The decoder to advance.
+
+  @return `EWCKeyStreamRecordRead` if a block was entered, `EWCKeyStreamEnd` if there are no more blocks, or `EWCKeyStreamCorrupt`.
+ */
+static EWCKeyStreamStatus EWCKeyStreamEnterBlock(EWCKeyStreamDecoder *decoder) {
+  if (decoder->position == decoder->length) {
+    return EWCKeyStreamEnd;
+  }
+
+  uint64_t payloadLength;
+  if (! EWCKeyStreamDecodeVarint(decoder, decoder->length, &payloadLength)
+    || payloadLength > decoder->length - decoder->position
+    || decoder->length - decoder->position - payloadLength < EWCKeyStreamChecksumSize) {
+    return EWCKeyStreamCorrupt;
+  }
+
+  const uint8_t *payload = decoder->bytes + decoder->position;
+  const uint8_t *stored = payload + payloadLength;
+  uint32_t checksum = (uint32_t)stored[0]
+    | ((uint32_t)stored[1] << 8)
+    | ((uint32_t)stored[2] << 16)
+    | ((uint32_t)stored[3] << 24);
+  if (EWCKeyStreamChecksum(payload, (size_t)payloadLength) != checksum) {
+    return EWCKeyStreamCorrupt;
+  }
+
+  decoder->blockEnd = decoder->position + (size_t)payloadLength;
+  decoder->nextBlock = decoder->blockEnd + EWCKeyStreamChecksumSize;
+  ++decoder->blockCount;
+
+  return EWCKeyStreamRecordRead;
+}
+
+/**
+  Reads the next record, without checking for a previous failure.
+
+  @param decoder The decoder to read from.
+  @param record Receives the record.
+
+  @return The read status.
+ */
+static EWCKeyStreamStatus EWCKeyStreamDecodeRecord(EWCKeyStreamDecoder *decoder, EWCKeyStreamRecord *record) {
+  // move on to the next block with records in it
+  while (decoder->position == decoder->blockEnd) {
+    decoder->position = decoder->nextBlock;
+
+    EWCKeyStreamStatus status = EWCKeyStreamEnterBlock(decoder);
+    if (status != EWCKeyStreamRecordRead) {
+      // stay at the end
+      decoder->blockEnd = decoder->position;
+      decoder->nextBlock = decoder->position;
+      return status;
+    }
+  }
+
+  uint8_t byte = decoder->bytes[decoder->position++];
+  uint8_t code = byte & 0x1f;
+  uint64_t delta = byte >> 5;
+
+  if (delta == EWCKeyStreamDeltaFollows
+    && ! EWCKeyStreamDecodeVarint(decoder, decoder->blockEnd, &delta)) {
+    return EWCKeyStreamCorrupt;
+  }
+
+  record->delta = delta;
+
+  // the common case, a bare key
+  if (code <= EWCCalculatorBackspaceKey) {
+    record->type = EWCKeyStreamKeyRecord;
+    record->key = (EWCCalculatorKey)code;
+    return EWCKeyStreamRecordRead;
+  }
+
+  record->key = EWCCalculatorNoKey;
+
+  switch (code) {
+    case EWCKeyStreamInputCode:
+      record->type = EWCKeyStreamInputRecord;
+      return EWCKeyStreamDecodeDecimal(decoder, &record->value)
+        ? EWCKeyStreamRecordRead
+        : EWCKeyStreamCorrupt;
+
+    case EWCKeyStreamCheckpointCode:
+      record->type = EWCKeyStreamCheckpointRecord;
+      if (! EWCKeyStreamDecodeDecimal(decoder, &record->value)
+        || decoder->position >= decoder->blockEnd) {
+        return EWCKeyStreamCorrupt;
+      }
+      record->error = (decoder->bytes[decoder->position++] & EWCKeyStreamErrorFlag) != 0;
+      return EWCKeyStreamRecordRead;
+
+    case EWCKeyStreamStateCode:
+      record->type = EWCKeyStreamStateRecord;
+      return (EWCKeyStreamDecodeDecimal(decoder, &record->value)
+        && EWCKeyStreamDecodeDecimal(decoder, &record->taxRate))
+        ? EWCKeyStreamRecordRead
+        : EWCKeyStreamCorrupt;
+
+    default:
+      return EWCKeyStreamCorrupt;
+  }
+}
+
+EWCKeyStreamStatus EWCKeyStreamDecoderNext(EWCKeyStreamDecoder *decoder, EWCKeyStreamRecord *record) {
+  if (decoder->corrupt) {
+    return EWCKeyStreamCorrupt;
+  }
+
+  EWCKeyStreamStatus status = EWCKeyStreamDecodeRecord(decoder, record);
+  if (status == EWCKeyStreamCorrupt) {
+    // nothing past a bad record can be trusted
+    decoder->corrupt = YES;
+  }
+
+  return status;
+}
@@ -0,0 +1,109 @@
+//
+//  EWCKeyStreamRecorder.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import "EWCCalculatorRecorderProtocol.h"
+
+@class EWCCalculator;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCKeyStreamClock` returns the current time in milliseconds, from any fixed origin.
+ */
+typedef uint64_t(^EWCKeyStreamClock)(void);
+
+/**
+  `EWCKeyStreamRecorder` records the inputs to a calculator into the packed key stream format described in `EWCKeyStream.h`, so that they can later be replayed by `EWCKeyStreamReplayer`.
+
+  Records are gathered into a block in memory, and each block is written to the output stream (with its checksum) once it fills.  A display checkpoint is recorded every `checkpointInterval` keys, and when recording finishes, so that a replay can verify that it arrived at the same results.
+ */
+@interface EWCKeyStreamRecorder : NSObject<EWCCalculatorRecorderProtocol>
+
+/**
+  The number of keys between display checkpoints.  Defaults to 64.  A value of 0 only records the final checkpoint.
+ */
+@property (nonatomic) NSUInteger checkpointInterval;
+
+/**
+  The payload size at which a block is written.  Defaults to 4096 bytes.
+ */
+@property (nonatomic) NSUInteger blockSize;
+
+/**
+  The clock used to timestamp records.  Defaults to the system uptime.  It can be replaced so that recordings are repeatable.
+ */
+@property (nonatomic, copy) EWCKeyStreamClock clock;
+
+/**
+  The number of keys recorded.
+ */
+@property (nonatomic, readonly) NSUInteger keyCount;
+
+/**
+  The number of bytes written to the output stream.
+ */
+@property (nonatomic, readonly) NSUInteger bytesWritten;
+
+/**
+  Creates a new recorder.
+
+  @param stream The stream to receive the recording.  It is opened when recording starts, and closed when recording finishes.
+
+  @return The new recorder.
+ */
++ (instancetype)recorderWithOutputStream:(NSOutputStream *)stream;
+
+/**
+  Initializes a recorder.
+
+  @param stream The stream to receive the recording.
+
+  @return The initialized instance.
+ */
+- (instancetype)initWithOutputStream:(NSOutputStream *)stream;
+
+/**
+  Starts recording the inputs to a calculator.  The header and the starting memory and tax rate are recorded, and the recorder attaches itself as the calculator's `recorder`.
+
+  @param calculator The calculator to record.  It is not retained.
+
+  @return NO if the output stream couldn't be written.
+ */
+- (BOOL)startRecordingCalculator:(EWCCalculator *)calculator;
+
+/**
+  Writes out the records gathered so far as a block, even if the block isn't full.
+
+  @return NO if the output stream couldn't be written.
+ */
+- (BOOL)flush;
+
+/**
+  Records a final checkpoint, writes any remaining records, detaches from the calculator, and closes the output stream.
+
+  @return NO if the output stream couldn't be written.
+ */
+- (BOOL)finish;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,242 @@
+//
+//  EWCKeyStreamRecorder.m
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCKeyStreamRecorder.h"
+#import "EWCKeyStream.h"
+#import "EWCCalculator.h"
+
+@interface EWCKeyStreamRecorder() {
+  NSOutputStream *_stream;  // receives the recording
+  __weak EWCCalculator *_calculator;  // the calculator being recorded
+  NSMutableData *_block;  // the payload of the block being gathered
+  size_t _blockLength;  // the length of the gathered payload
+  uint64_t _lastTime;  // the time of the last record
+  NSUInteger _keysSinceCheckpoint;  // the keys recorded since the last checkpoint
+  BOOL _failed;  // whether a write to the stream has failed
+}
+
+@end
+
+@implementation EWCKeyStreamRecorder
+
+///----------------------------------------------
+/// @name Construction and Initialization Methods
+///----------------------------------------------
+
++ (instancetype)recorderWithOutputStream:(NSOutputStream *)stream {
+  return [[EWCKeyStreamRecorder alloc] initWithOutputStream:stream];
+}
+
+- (instancetype)initWithOutputStream:(NSOutputStream *)stream {
+  self = [super init];
+  if (self) {
+    _stream = stream;
+    _checkpointInterval = 64;
+    _blockSize = 4096;
+    _clock = ^{
+      return (uint64_t)([NSProcessInfo processInfo].systemUptime * 1000);
+    };
+  }
+
+  return self;
+}
+
+///------------------------
+/// @name Recording Methods
+///------------------------
+
+- (BOOL)startRecordingCalculator:(EWCCalculator *)calculator {
+  _calculator = calculator;
+  _keyCount = 0;
+  _bytesWritten = 0;
+  _keysSinceCheckpoint = 0;
+  _failed = NO;
+
+  // leave room for one more record past the block size, so a record never
+  // has to be split between blocks
+  _block = [NSMutableData dataWithLength:_blockSize + EWCKeyStreamMaxRecordSize];
+  _blockLength = 0;
+
+  [_stream open];
+
+  uint8_t header[EWCKeyStreamHeaderSize];
+  [self writeBytes:header length:EWCKeyStreamEncodeHeader(header, calculator.maximumDigits)];
+
+  // the calculator may have restored its memory and tax rate from a data
+  // provider, and a replay needs to start from the same values
+  _lastTime = _clock();
+
+  EWCKeyStreamRecord record;
+  record.type = EWCKeyStreamStateRecord;
+  record.delta = 0;
+  record.value = calculator.memoryValue.decimalValue;
+  record.taxRate = calculator.taxRateValue.decimalValue;
+  [self appendRecord:&record];
+
+  calculator.recorder = self;
+
+  return ! _failed;
+}
+
+- (BOOL)flush {
+  if (_blockLength == 0 || _failed) {
+    return ! _failed;
+  }
+
+  uint8_t header[EWCKeyStreamMaxBlockHeaderSize];
+  [self writeBytes:header length:EWCKeyStreamEncodeVarint(_blockLength, header)];
+
+  const uint8_t *payload = _block.bytes;
+  [self writeBytes:payload length:_blockLength];
+
+  uint32_t checksum = EWCKeyStreamChecksum(payload, _blockLength);
+  uint8_t trailer[EWCKeyStreamChecksumSize] = {
+    (uint8_t)checksum,
+    (uint8_t)(checksum >> 8),
+    (uint8_t)(checksum >> 16),
+    (uint8_t)(checksum >> 24),
+  };
+  [self writeBytes:trailer length:EWCKeyStreamChecksumSize];
+
+  _blockLength = 0;
+
+  return ! _failed;
+}
+
+- (BOOL)finish {
+  EWCCalculator *calculator = _calculator;
+  if (calculator) {
+    [self appendCheckpointForCalculator:calculator];
+
+    if (calculator.recorder == self) {
+      calculator.recorder = nil;
+    }
+  }
+
+  _calculator = nil;
+
+  [self flush];
+  [_stream close];
+
+  return ! _failed;
+}
+
+///--------------------------------------------
+/// @name EWCCalculatorRecorderProtocol Methods
+///--------------------------------------------
+
+- (void)calculator:(EWCCalculator *)calculator didPressKey:(EWCCalculatorKey)key {
+  // pressing no key (or an unknown one) has no effect, and has no code
+  if (key < EWCCalculatorZeroKey || key > EWCCalculatorBackspaceKey) {
+    return;
+  }
+
+  EWCKeyStreamRecord record;
+  record.type = EWCKeyStreamKeyRecord;
+  record.key = key;
+  record.delta = [self nextDelta];
+  [self appendRecord:&record];
+
+  ++_keyCount;
+
+  if (_checkpointInterval && ++_keysSinceCheckpoint >= _checkpointInterval) {
+    [self appendCheckpointForCalculator:calculator];
+  }
+}
+
+- (void)calculator:(EWCCalculator *)calculator didSetInput:(NSDecimalNumber *)value {
+  EWCKeyStreamRecord record;
+  record.type = EWCKeyStreamInputRecord;
+  record.delta = [self nextDelta];
+  record.value = value.decimalValue;
+  [self appendRecord:&record];
+}
+
+///------------------------------
+/// @name Internal helper methods
+///------------------------------
+
+/**
+  Gets the time since the previous record, and marks the current time as the time of the latest record.
+
+  @return The elapsed milliseconds.
+ */
+- (uint64_t)nextDelta {
+  uint64_t now = _clock();
+
+  // a replaced clock running backwards is treated as no time passing
+  uint64_t delta = (now > _lastTime) ? now - _lastTime : 0;
+  _lastTime = now;
+
+  return delta;
+}
+
+/**
+  Records the calculator display and error state.
+
+  @param calculator The calculator whose results to record.
+ */
+- (void)appendCheckpointForCalculator:(EWCCalculator *)calculator {
+  EWCKeyStreamRecord record;
+  record.type = EWCKeyStreamCheckpointRecord;
+  record.delta = 0;
+  record.value = calculator.displayValue.decimalValue;
+  record.error = calculator.hasError;
+  [self appendRecord:&record];
+
+  _keysSinceCheckpoint = 0;
+}
+
+/**
+  Adds a record to the gathered block, writing out the block once it is full.
+
+  @param record The record to add.
+ */
+- (void)appendRecord:(const EWCKeyStreamRecord *)record {
+  uint8_t *payload = _block.mutableBytes;
+  _blockLength += EWCKeyStreamEncodeRecord(record, payload + _blockLength);
+
+  if (_blockLength >= _blockSize) {
+    [self flush];
+  }
+}
+
+/**
+  Writes bytes to the output stream, noting any failure.
+
+  @param bytes The bytes to write.
+  @param length The number of bytes to write.
+ */
+- (void)writeBytes:(const uint8_t *)bytes length:(size_t)length {
+  while (length > 0 && ! _failed) {
+    NSInteger written = [_stream write:bytes maxLength:length];
+    if (written <= 0) {
+      _failed = YES;
+      return;
+    }
+
+    bytes += written;
+    length -= (size_t)written;
+    _bytesWritten += (NSUInteger)written;
+  }
+}
+
+@end
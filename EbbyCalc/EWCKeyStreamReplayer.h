@@ -0,0 +1,120 @@
+//
+//  EWCKeyStreamReplayer.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import "EWCTraceBuffer.h"
+
+@class EWCCalculator;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCKeyStreamReplayer` plays a recording made by `EWCKeyStreamRecorder` back through a new calculator as fast as it can be decoded, ignoring the recorded timing, and verifies that the calculator reaches the same results at each recorded checkpoint.
+ */
+@interface EWCKeyStreamReplayer : NSObject
+
+/**
+  The calculator the recording was last replayed through, or nil if it hasn't been replayed.
+ */
+@property (nonatomic, readonly, nullable) EWCCalculator *calculator;
+
+/**
+  A buffer that receives the timeline of each input replayed, or NULL (the default) to not trace.  The buffer is not owned by the replayer, so must outlive it.
+
+  While tracing, the display is formatted after every key, as the app's display would be, so that formatting is part of the timeline.
+ */
+@property (nonatomic, nullable) EWCTraceBuffer *traceBuffer;
+
+/**
+  The maximum digits of the recorded calculator, or 0 if the recording has no valid header.
+ */
+@property (nonatomic, readonly) NSInteger maximumDigits;
+
+/**
+  The number of keys read.
+ */
+@property (nonatomic, readonly) NSUInteger keyCount;
+
+/**
+  The number of explicit inputs read.
+ */
+@property (nonatomic, readonly) NSUInteger inputCount;
+
+/**
+  The number of checkpoints read.
+ */
+@property (nonatomic, readonly) NSUInteger checkpointCount;
+
+/**
+  The number of checkpoints whose results didn't match during a replay.
+ */
+@property (nonatomic, readonly) NSUInteger failedCheckpointCount;
+
+/**
+  The number of keys that had been replayed when the first checkpoint failed, or `NSNotFound` if none have failed.
+ */
+@property (nonatomic, readonly) NSUInteger firstFailedKeyIndex;
+
+/**
+  The total of the recorded time between inputs, in milliseconds.
+ */
+@property (nonatomic, readonly) uint64_t recordedDuration;
+
+/**
+  Whether the recording was found to be damaged.  Records before the damaged block are still read.
+ */
+@property (nonatomic, readonly, getter=isCorrupt) BOOL corrupt;
+
+/**
+  Creates a new replayer.
+
+  @param data The recording.
+
+  @return The new replayer.
+ */
++ (instancetype)replayerWithData:(NSData *)data;
+
+/**
+  Initializes a replayer.
+
+  @param data The recording.
+
+  @return The initialized instance.
+ */
+- (instancetype)initWithData:(NSData *)data;
+
+/**
+  Reads through the recording without replaying it, only counting its records.  This measures the decoding speed alone.
+
+  @return YES if the whole recording was read.
+ */
+- (BOOL)decode;
+
+/**
+  Replays the recording through a new calculator.
+
+  @return YES if the whole recording was read, and every checkpoint matched.
+ */
+- (BOOL)replay;
+
+@end
+
+NS_ASSUME_NONNULL_END
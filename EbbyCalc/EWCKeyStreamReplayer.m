@@ -0,0 +1,201 @@
+//
+//  EWCKeyStreamReplayer.m
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCKeyStreamReplayer.h"
+#import "EWCKeyStream.h"
+#import "EWCCalculator.h"
+#import "EWCCalculatorMemoryData.h"
+
+@interface EWCKeyStreamReplayer() {
+  NSData *_data;  // the recording
+}
+
+@end
+
+/**
+  Checks whether two values are the same, treating NaN as matching NaN.
+
+  @param a The first value.
+  @param b The second value.
+
+  @return YES if the values match.
+ */
+static BOOL EWCKeyStreamValuesMatch(NSDecimal *a, NSDecimal *b) {
+  BOOL aNaN = NSDecimalIsNotANumber(a);
+  BOOL bNaN = NSDecimalIsNotANumber(b);
+  if (aNaN || bNaN) {
+    return aNaN && bNaN;
+  }
+
+  return NSDecimalCompare(a, b) == NSOrderedSame;
+}
+
+@implementation EWCKeyStreamReplayer
+
+///----------------------------------------------
+/// @name Construction and Initialization Methods
+///----------------------------------------------
+
++ (instancetype)replayerWithData:(NSData *)data {
+  return [[EWCKeyStreamReplayer alloc] initWithData:data];
+}
+
+- (instancetype)initWithData:(NSData *)data {
+  self = [super init];
+  if (self) {
+    _data = [data copy];
+    _firstFailedKeyIndex = NSNotFound;
+  }
+
+  return self;
+}
+
+///---------------------
+/// @name Replay Methods
+///---------------------
+
+- (BOOL)decode {
+  EWCKeyStreamDecoder decoder;
+  if (! [self beginDecoding:&decoder]) {
+    return NO;
+  }
+
+  EWCKeyStreamRecord record;
+  EWCKeyStreamStatus status;
+  while ((status = EWCKeyStreamDecoderNext(&decoder, &record)) == EWCKeyStreamRecordRead) {
+    [self countRecord:&record];
+  }
+
+  _corrupt = (status == EWCKeyStreamCorrupt);
+
+  return ! _corrupt;
+}
+
+- (BOOL)replay {
+  _calculator = nil;
+
+  EWCKeyStreamDecoder decoder;
+  if (! [self beginDecoding:&decoder]) {
+    return NO;
+  }
+
+  EWCCalculator *calculator = [EWCCalculator calculator];
+  calculator.maximumDigits = _maximumDigits;
+  _calculator = calculator;
+
+  if (_traceBuffer) {
+    calculator.traceBuffer = _traceBuffer;
+
+    // read the display as the app does on every update
+    __weak EWCCalculator *weakCalculator = calculator;
+    [calculator registerUpdateCallbackWithBlock:^{
+      (void)weakCalculator.displayContent;
+    }];
+  }
+
+  EWCKeyStreamRecord record;
+  EWCKeyStreamStatus status;
+  while ((status = EWCKeyStreamDecoderNext(&decoder, &record)) == EWCKeyStreamRecordRead) {
+    [self countRecord:&record];
+
+    switch (record.type) {
+      case EWCKeyStreamKeyRecord:
+        [calculator pressKey:record.key];
+        break;
+
+      case EWCKeyStreamInputRecord:
+        [calculator setInput:[NSDecimalNumber decimalNumberWithDecimal:record.value]];
+        break;
+
+      case EWCKeyStreamStateRecord:
+        // start from the memory and tax rate the recorded calculator had
+        calculator.dataProvider = [EWCCalculatorMemoryData
+          dataWithTaxRate:[NSDecimalNumber decimalNumberWithDecimal:record.taxRate]
+          memory:[NSDecimalNumber decimalNumberWithDecimal:record.value]];
+        break;
+
+      case EWCKeyStreamCheckpointRecord: {
+        NSDecimal display = calculator.displayValue.decimalValue;
+        if (! EWCKeyStreamValuesMatch(&display, &record.value)
+          || calculator.hasError != record.error) {
+          if (_failedCheckpointCount == 0) {
+            _firstFailedKeyIndex = _keyCount;
+          }
+          ++_failedCheckpointCount;
+        }
+        break;
+      }
+    }
+  }
+
+  _corrupt = (status == EWCKeyStreamCorrupt);
+
+  return ! _corrupt && _failedCheckpointCount == 0;
+}
+
+///------------------------------
+/// @name Internal helper methods
+///------------------------------
+
+/**
+  Clears the counts from any earlier pass, and prepares to read the recording.
+
+  @param decoder The decoder to prepare.
+
+  @return NO if the recording has no valid header.
+ */
+- (BOOL)beginDecoding:(EWCKeyStreamDecoder *)decoder {
+  _keyCount = 0;
+  _inputCount = 0;
+  _checkpointCount = 0;
+  _failedCheckpointCount = 0;
+  _firstFailedKeyIndex = NSNotFound;
+  _recordedDuration = 0;
+  _corrupt = NO;
+
+  if (! EWCKeyStreamDecoderInit(decoder, _data.bytes, _data.length)) {
+    _maximumDigits = 0;
+    _corrupt = YES;
+    return NO;
+  }
+
+  _maximumDigits = decoder->maximumDigits;
+
+  return YES;
+}
+
+/**
+  Counts a record read from the recording.
+
+  @param record The record read.
+ */
+- (void)countRecord:(const EWCKeyStreamRecord *)record {
+  _recordedDuration += record->delta;
+
+  switch (record->type) {
+    case EWCKeyStreamKeyRecord: ++_keyCount; break;
+    case EWCKeyStreamInputRecord: ++_inputCount; break;
+    case EWCKeyStreamCheckpointRecord: ++_checkpointCount; break;
+    case EWCKeyStreamStateRecord: break;
+  }
+}
+
+@end
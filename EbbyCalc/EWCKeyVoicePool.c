@@ -0,0 +1,162 @@
+//
+//  EWCKeyVoicePool.c
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "EWCKeyVoicePool.h"
+#include <string.h>
+
+// marks a voice that isn't playing
+#define EWCKeyVoiceFree (-1)
+
+void EWCKeyVoicePoolInit(EWCKeyVoicePool *pool, const EWCKeySoundSample *const *sounds, int soundCount) {
+  memset(pool, 0, sizeof(*pool));
+
+  if (soundCount > EWCKeyVoicePoolMaxSounds) {
+    soundCount = EWCKeyVoicePoolMaxSounds;
+  }
+
+  for (int i = 0; i < soundCount; ++i) {
+    pool->sounds[i] = sounds[i];
+  }
+  pool->soundCount = soundCount;
+
+  for (int v = 0; v < EWCKeyVoicePoolVoiceCount; ++v) {
+    pool->voices[v].sound = EWCKeyVoiceFree;
+  }
+
+  atomic_init(&pool->triggerHead, 0);
+  atomic_init(&pool->triggerTail, 0);
+  atomic_init(&pool->droppedCount, 0);
+}
+
+bool EWCKeyVoicePoolTrigger(EWCKeyVoicePool *pool, int sound, float gain) {
+  if (sound < 0 || sound >= pool->soundCount || ! pool->sounds[sound]) {
+    atomic_fetch_add_explicit(&pool->droppedCount, 1, memory_order_relaxed);
+    return false;
+  }
+
+  // only we write the head, and the renderer only moves the tail forward, so
+  // a stale tail can only make the ring look fuller than it is
+  uint32_t head = atomic_load_explicit(&pool->triggerHead, memory_order_relaxed);
+  uint32_t tail = atomic_load_explicit(&pool->triggerTail, memory_order_acquire);
+  if (head - tail >= EWCKeyVoicePoolTriggerCapacity) {
+    atomic_fetch_add_explicit(&pool->droppedCount, 1, memory_order_relaxed);
+    return false;
+  }
+
+  EWCKeyVoiceTrigger *trigger = &pool->triggers[head & (EWCKeyVoicePoolTriggerCapacity - 1)];
+  trigger->sound = sound;
+  trigger->gain = gain;
+
+  // publish the request only once it is written
+  atomic_store_explicit(&pool->triggerHead, head + 1, memory_order_release);
+
+  return true;
+}
+
+/**
+  Starts a sound on a free voice, or steals the next voice in turn if none are free.
+
+  @param pool The pool.
+  @param trigger The request to start the sound.
+ */
+static void EWCKeyVoicePoolStart(EWCKeyVoicePool *pool, const EWCKeyVoiceTrigger *trigger) {
+  int chosen = pool->nextVoice;
+  for (int i = 0; i < EWCKeyVoicePoolVoiceCount; ++i) {
+    int v = (pool->nextVoice + i) % EWCKeyVoicePoolVoiceCount;
+    if (pool->voices[v].sound == EWCKeyVoiceFree) {
+      chosen = v;
+      break;
+    }
+  }
+
+  EWCKeyVoice *voice = &pool->voices[chosen];
+  if (voice->sound != EWCKeyVoiceFree) {
+    ++pool->stolenCount;
+  }
+
+  voice->sound = trigger->sound;
+  voice->position = 0;
+  voice->gain = trigger->gain;
+
+  pool->nextVoice = (chosen + 1) % EWCKeyVoicePoolVoiceCount;
+  ++pool->startedCount;
+}
+
+bool EWCKeyVoicePoolRender(EWCKeyVoicePool *pool, float *frames, uint32_t frameCount) {
+  // take all the waiting requests
+  uint32_t tail = atomic_load_explicit(&pool->triggerTail, memory_order_relaxed);
+  uint32_t head = atomic_load_explicit(&pool->triggerHead, memory_order_acquire);
+  for (; tail != head; ++tail) {
+    EWCKeyVoicePoolStart(pool, &pool->triggers[tail & (EWCKeyVoicePoolTriggerCapacity - 1)]);
+  }
+  atomic_store_explicit(&pool->triggerTail, tail, memory_order_release);
+
+  memset(frames, 0, sizeof(float) * 2 * frameCount);
+
+  bool playing = false;
+  for (int v = 0; v < EWCKeyVoicePoolVoiceCount; ++v) {
+    EWCKeyVoice *voice = &pool->voices[v];
+    if (voice->sound == EWCKeyVoiceFree) {
+      continue;
+    }
+
+    const EWCKeySoundSample *sound = pool->sounds[voice->sound];
+    uint32_t remaining = sound->frameCount - voice->position;
+    uint32_t count = (remaining < frameCount) ? remaining : frameCount;
+
+    const float *source = sound->frames + 2 * (size_t)voice->position;
+    float gain = voice->gain;
+    for (uint32_t i = 0; i < 2 * count; ++i) {
+      frames[i] += source[i] * gain;
+    }
+
+    voice->position += count;
+    if (voice->position >= sound->frameCount) {
+      voice->sound = EWCKeyVoiceFree;
+    }
+
+    playing = true;
+  }
+
+  if (playing) {
+    // overlapping sounds may sum past full scale
+    for (uint32_t i = 0; i < 2 * frameCount; ++i) {
+      if (frames[i] > 1) {
+        frames[i] = 1;
+      } else if (frames[i] < -1) {
+        frames[i] = -1;
+      }
+    }
+  }
+
+  return playing;
+}
+
+int EWCKeyVoicePoolActiveCount(const EWCKeyVoicePool *pool) {
+  int count = 0;
+  for (int v = 0; v < EWCKeyVoicePoolVoiceCount; ++v) {
+    if (pool->voices[v].sound != EWCKeyVoiceFree) {
+      ++count;
+    }
+  }
+
+  return count;
+}
@@ -0,0 +1,117 @@
+//
+//  EWCKeyVoicePool.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef EWCKeyVoicePool_h
+#define EWCKeyVoicePool_h
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "EWCKeySoundSample.h"
+
+// the number of sounds that can play at once.  Starting another steals a voice.
+#define EWCKeyVoicePoolVoiceCount 8
+
+// the most distinct sounds a pool can play
+#define EWCKeyVoicePoolMaxSounds 4
+
+// the most sounds that can be started between renders (a power of two).
+// Starting more drops the extras.
+#define EWCKeyVoicePoolTriggerCapacity 16
+
+/**
+  `EWCKeyVoice` is one sound playing in a pool.
+ */
+typedef struct {
+  int sound;  // the index of the sound playing, or -1 if the voice is free
+  uint32_t position;  // the next frame of the sound to play
+  float gain;  // the volume the sound is played at
+} EWCKeyVoice;
+
+/**
+  `EWCKeyVoiceTrigger` is a request to start a sound, waiting for the next render.
+ */
+typedef struct {
+  int sound;  // the index of the sound to start
+  float gain;  // the volume to play it at
+} EWCKeyVoiceTrigger;
+
+/**
+  `EWCKeyVoicePool` mixes key sounds on a fixed set of voices, so that playing a sound never allocates.
+
+  Sounds are started from one thread (the interface) and rendered on another (the audio output), with the start requests passed between them through a lock free ring.  When every voice is busy, the voices are stolen in turn, so the oldest sound is the one cut off.
+
+  The pool holds no allocations of its own, so it can live inside another object.  The sounds it plays are borrowed, and must outlive it.
+ */
+typedef struct {
+  const EWCKeySoundSample *sounds[EWCKeyVoicePoolMaxSounds];  // the sounds that can be played
+  int soundCount;  // the number of sounds
+  EWCKeyVoice voices[EWCKeyVoicePoolVoiceCount];  // the voices, only touched while rendering
+  int nextVoice;  // the voice to try first (and steal, if none are free) for the next sound
+  EWCKeyVoiceTrigger triggers[EWCKeyVoicePoolTriggerCapacity];  // the ring of start requests
+  _Atomic uint32_t triggerHead;  // the count of start requests written to the ring
+  _Atomic uint32_t triggerTail;  // the count of start requests taken from the ring
+  uint64_t startedCount;  // the number of sounds started by renders
+  uint64_t stolenCount;  // the number of sounds cut off to start another
+  _Atomic uint64_t droppedCount;  // the number of start requests lost to a full ring
+} EWCKeyVoicePool;
+
+/**
+  Sets up a pool to play some sounds, with all of its voices free.
+
+  @param pool The pool to set up.
+  @param sounds The sounds to play, which are referred to by their index.  All should have the same sample rate.
+  @param soundCount The number of sounds.  Any beyond `EWCKeyVoicePoolMaxSounds` are ignored.
+ */
+void EWCKeyVoicePoolInit(EWCKeyVoicePool *pool, const EWCKeySoundSample *const *sounds, int soundCount);
+
+/**
+  Requests that a sound be started by the next render.  This must only be called from one thread at a time.
+
+  @param pool The pool.
+  @param sound The index of the sound.
+  @param gain The volume to play the sound at.
+
+  @return Whether the request was accepted.  It is dropped if the sound doesn't exist or too many requests are waiting.
+ */
+bool EWCKeyVoicePoolTrigger(EWCKeyVoicePool *pool, int sound, float gain);
+
+/**
+  Starts the requested sounds, and mixes the playing sounds into the next frames of output, replacing what was there.  This must only be called from one thread at a time.
+
+  @param pool The pool.
+  @param frames Receives the interleaved stereo frames.
+  @param frameCount The number of frames to render.
+
+  @return Whether any sound was playing.  If not, the frames are silent.
+ */
+bool EWCKeyVoicePoolRender(EWCKeyVoicePool *pool, float *frames, uint32_t frameCount);
+
+/**
+  Counts the voices in use.  This must only be called from the rendering thread, or while no render is running.
+
+  @param pool The pool.
+
+  @return The number of voices playing.
+ */
+int EWCKeyVoicePoolActiveCount(const EWCKeyVoicePool *pool);
+
+#endif /* EWCKeyVoicePool_h */
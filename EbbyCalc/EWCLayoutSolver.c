@@ -0,0 +1,337 @@
+//
+//  EWCLayoutSolver.c
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "EWCLayoutSolver.h"
+#include <string.h>
+
+// key values, matching `EWCCalculatorKey` (which plain C can't include)
+enum {
+  EWCLayoutZeroKey = 0,
+  EWCLayoutOneKey,
+  EWCLayoutTwoKey,
+  EWCLayoutThreeKey,
+  EWCLayoutFourKey,
+  EWCLayoutFiveKey,
+  EWCLayoutSixKey,
+  EWCLayoutSevenKey,
+  EWCLayoutEightKey,
+  EWCLayoutNineKey,
+  EWCLayoutClearKey,
+  EWCLayoutRateKey,
+  EWCLayoutTaxPlusKey,
+  EWCLayoutTaxMinusKey,
+  EWCLayoutMemoryKey,
+  EWCLayoutMemoryPlusKey,
+  EWCLayoutMemoryMinusKey,
+  EWCLayoutAddKey,
+  EWCLayoutSubtractKey,
+  EWCLayoutMultiplyKey,
+  EWCLayoutDivideKey,
+  EWCLayoutSignKey,
+  EWCLayoutDecimalKey,
+  EWCLayoutPercentKey,
+  EWCLayoutSqrtKey,
+  EWCLayoutEqualKey,
+};
+
+///-----------------------
+/// @name Layout Constants
+///-----------------------
+
+static const float s_tallGridHeightWidthRatio = 1.700;  // the aspect ratio that determines whether to layout the buttons in tall or wide mode
+
+static const float s_narrowLayoutBase = 0.037;  // base layout value for narrow layout
+static const float s_wideLayoutBase = 0.045;  // base layout value for wide layout
+static const float s_tallLayoutBase = 0.030;  // base layout value for tall layout
+
+/**
+  Layout constants for the narrow layout (wide layout, but width is smaller than height).
+ */
+static const EWCLayoutConstants s_narrowLayoutConstants = {
+  s_narrowLayoutBase,  // textSizeAsPercentOfHeight
+  s_narrowLayoutBase * 0.5,  // statusSizeAsPercentOfHeight
+  s_narrowLayoutBase * 2,  // digitSizeAsPercentOfHeight
+  s_narrowLayoutBase * 2,  // operatorSizeAsPercentOfHeight
+  s_narrowLayoutBase * 3.7,  // displaySizeAsPercentOfHeight
+  1.500,  // displayHeightFromFontSize
+  0.020,  // minimumRowGutter
+  0.020,  // minimumColumnGutter
+};
+
+/**
+ Layout constants for the wide layout (wide layout, and width is larger than height).
+*/
+static const EWCLayoutConstants s_wideLayoutConstants = {
+  s_wideLayoutBase,  // textSizeAsPercentOfHeight
+  s_wideLayoutBase * 0.5,  // statusSizeAsPercentOfHeight
+  s_wideLayoutBase * 2,  // digitSizeAsPercentOfHeight
+  s_wideLayoutBase * 2,  // operatorSizeAsPercentOfHeight
+  s_wideLayoutBase * 2.6,  // displaySizeAsPercentOfHeight
+  1.500,  // displayHeightFromFontSize
+  0.030,  // minimumRowGutter
+  0.010,  // minimumColumnGutter
+};
+
+/**
+ Layout constants for the tall layout (greater than tall aspect ratio).
+*/
+static const EWCLayoutConstants s_tallLayoutConstants = {
+  s_tallLayoutBase,  // textSizeAsPercentOfHeight
+  s_tallLayoutBase * 0.5,  // statusSizeAsPercentOfHeight
+  s_tallLayoutBase * 1.8,  // digitSizeAsPercentOfHeight
+  s_tallLayoutBase * 1.7,  // operatorSizeAsPercentOfHeight
+  s_tallLayoutBase * 2.8,  // displaySizeAsPercentOfHeight
+  1.500,  // displayHeightFromFontSize
+  0.020,  // minimumRowGutter
+  0.030,  // minimumColumnGutter
+};
+
+///-------------------
+/// @name Grid Layouts
+///-------------------
+
+/**
+  Key placements for the tall grid (9 rows, 3 columns).  The add key is double tall.
+ */
+static const EWCLayoutPlacement s_tallPlacements[] = {
+  { EWCLayoutZeroKey, 8, 0, 8, 0 },
+  { EWCLayoutOneKey, 7, 0, 7, 0 },
+  { EWCLayoutTwoKey, 7, 1, 7, 1 },
+  { EWCLayoutThreeKey, 7, 2, 7, 2 },
+  { EWCLayoutFourKey, 6, 0, 6, 0 },
+  { EWCLayoutFiveKey, 6, 1, 6, 1 },
+  { EWCLayoutSixKey, 6, 2, 6, 2 },
+  { EWCLayoutSevenKey, 5, 0, 5, 0 },
+  { EWCLayoutEightKey, 5, 1, 5, 1 },
+  { EWCLayoutNineKey, 5, 2, 5, 2 },
+  { EWCLayoutClearKey, 2, 0, 2, 0 },
+  { EWCLayoutRateKey, 0, 0, 0, 0 },
+  { EWCLayoutTaxPlusKey, 0, 1, 0, 1 },
+  { EWCLayoutTaxMinusKey, 0, 2, 0, 2 },
+  { EWCLayoutMemoryKey, 1, 0, 1, 0 },
+  { EWCLayoutMemoryPlusKey, 1, 1, 1, 1 },
+  { EWCLayoutMemoryMinusKey, 1, 2, 1, 2 },
+  { EWCLayoutAddKey, 3, 2, 4, 2 },
+  { EWCLayoutSubtractKey, 4, 1, 4, 1 },
+  { EWCLayoutMultiplyKey, 3, 1, 3, 1 },
+  { EWCLayoutDivideKey, 3, 0, 3, 0 },
+  { EWCLayoutSignKey, 4, 0, 4, 0 },
+  { EWCLayoutDecimalKey, 8, 1, 8, 1 },
+  { EWCLayoutPercentKey, 2, 1, 2, 1 },
+  { EWCLayoutSqrtKey, 2, 2, 2, 2 },
+  { EWCLayoutEqualKey, 8, 2, 8, 2 },
+};
+
+/**
+  Key placements for the wide grid (5 rows, 6 columns).  The add key is double tall.
+ */
+static const EWCLayoutPlacement s_widePlacements[] = {
+  { EWCLayoutZeroKey, 4, 1, 4, 1 },
+  { EWCLayoutOneKey, 3, 1, 3, 1 },
+  { EWCLayoutTwoKey, 3, 2, 3, 2 },
+  { EWCLayoutThreeKey, 3, 3, 3, 3 },
+  { EWCLayoutFourKey, 2, 1, 2, 1 },
+  { EWCLayoutFiveKey, 2, 2, 2, 2 },
+  { EWCLayoutSixKey, 2, 3, 2, 3 },
+  { EWCLayoutSevenKey, 1, 1, 1, 1 },
+  { EWCLayoutEightKey, 1, 2, 1, 2 },
+  { EWCLayoutNineKey, 1, 3, 1, 3 },
+  { EWCLayoutClearKey, 1, 0, 1, 0 },
+  { EWCLayoutRateKey, 0, 3, 0, 3 },
+  { EWCLayoutTaxPlusKey, 0, 4, 0, 4 },
+  { EWCLayoutTaxMinusKey, 0, 5, 0, 5 },
+  { EWCLayoutMemoryKey, 2, 5, 2, 5 },
+  { EWCLayoutMemoryPlusKey, 4, 5, 4, 5 },
+  { EWCLayoutMemoryMinusKey, 3, 5, 3, 5 },
+  { EWCLayoutAddKey, 3, 4, 4, 4 },
+  { EWCLayoutSubtractKey, 2, 4, 2, 4 },
+  { EWCLayoutMultiplyKey, 1, 4, 1, 4 },
+  { EWCLayoutDivideKey, 1, 5, 1, 5 },
+  { EWCLayoutSignKey, 2, 0, 2, 0 },
+  { EWCLayoutDecimalKey, 4, 2, 4, 2 },
+  { EWCLayoutPercentKey, 3, 0, 3, 0 },
+  { EWCLayoutSqrtKey, 4, 0, 4, 0 },
+  { EWCLayoutEqualKey, 4, 3, 4, 3 },
+};
+
+static const EWCLayoutGrid s_tallGrid = {
+  9, 3, s_tallPlacements, sizeof(s_tallPlacements) / sizeof(s_tallPlacements[0]),
+};
+
+static const EWCLayoutGrid s_wideGrid = {
+  5, 6, s_widePlacements, sizeof(s_widePlacements) / sizeof(s_widePlacements[0]),
+};
+
+///--------------
+/// @name Solving
+///--------------
+
+const EWCLayoutConstants *EWCLayoutConstantsForMode(EWCLayoutMode mode) {
+  switch (mode) {
+    case EWCLayoutNarrowMode: return &s_narrowLayoutConstants;
+    case EWCLayoutTallMode: return &s_tallLayoutConstants;
+    default: return &s_wideLayoutConstants;
+  }
+}
+
+const EWCLayoutGrid *EWCLayoutGridForMode(EWCLayoutMode mode) {
+  return (mode == EWCLayoutTallMode) ? &s_tallGrid : &s_wideGrid;
+}
+
+/**
+  Finds the cells before and within a span along one axis.
+
+  @param start The first cell of the span.
+  @param end The last cell of the span (inclusive).
+  @param before Receives the number of cells before the span.
+  @param span Receives the number of cells in the span.
+ */
+static inline void EWCLayoutSpan(int start, int end, double *before, double *span) {
+  // counts as though walking the cells up to the end of the span, so that
+  // the result is the same for out of order or negative spans
+  int limit = (end < 0) ? 0 : end + 1;
+  int first = (start < 0) ? 0 : (start > limit) ? limit : start;
+
+  *before = first;
+  *span = limit - first;
+}
+
+EWCLayoutRect EWCLayoutCellRect(double gridWidth, double gridHeight,
+  int rows, int columns, double rowGutter, double columnGutter,
+  int startRow, int startColumn, int endRow, int endColumn) {
+
+  double rowTop, rowSpan, columnLeft, columnSpan;
+  EWCLayoutSpan(startRow, endRow, &rowTop, &rowSpan);
+  EWCLayoutSpan(startColumn, endColumn, &columnLeft, &columnSpan);
+
+  double rowTotal = rows;
+  double columnTotal = columns;
+
+  double top = gridHeight * (rowTop / rowTotal);
+  double height = gridHeight * (rowSpan / rowTotal);
+  double left = gridWidth * (columnLeft / columnTotal);
+  double width = gridWidth * (columnSpan / columnTotal);
+
+  double gutterWidth = columnGutter * gridWidth / 2.0;
+  double gutterHeight = rowGutter * gridHeight / 2.0;
+
+  return (EWCLayoutRect){
+    left + gutterWidth,
+    top + gutterHeight,
+    width - (2 * gutterWidth),
+    height - (2 * gutterHeight),
+  };
+}
+
+void EWCLayoutSolve(EWCLayoutSolution *solution, double width, double height, double margin) {
+  solution->width = width;
+  solution->height = height;
+  solution->margin = margin;
+
+  // determine whether we are in a tall or wide scenario
+  float aspectRatio = height / width;
+  if (aspectRatio >= s_tallGridHeightWidthRatio) {
+    solution->mode = EWCLayoutTallMode;
+  } else {
+    solution->mode = (width < height) ? EWCLayoutNarrowMode : EWCLayoutWideMode;
+  }
+
+  const EWCLayoutConstants *constants = EWCLayoutConstantsForMode(solution->mode);
+  const EWCLayoutGrid *grid = EWCLayoutGridForMode(solution->mode);
+  solution->constants = constants;
+  solution->grid = grid;
+  solution->rowGutter = constants->minimumRowGutter;
+  solution->columnGutter = constants->minimumColumnGutter;
+
+  // use the height as the dimension to base our font sizes on, starting with
+  // the display, which determines how much room is left for the grid
+  double fontDim = height;
+  solution->displayFontSize = fontDim * constants->displaySizeAsPercentOfHeight;
+  solution->displayHeight = solution->displayFontSize * constants->displayHeightFromFontSize;
+  solution->gridTopConstant = -height + solution->displayHeight + margin;
+
+  solution->textFontSize = fontDim * constants->textSizeAsPercentOfHeight;
+  solution->digitFontSize = fontDim * constants->digitSizeAsPercentOfHeight;
+  solution->operatorFontSize = fontDim * constants->operatorSizeAsPercentOfHeight;
+  solution->statusFontSize = fontDim * constants->statusSizeAsPercentOfHeight;
+
+  // operators aren't vertically centered within their font height, so their
+  // labels are moved up slightly
+  solution->operatorTitleInset = solution->operatorFontSize * 0.200;
+
+  solution->statusInset = margin + width * solution->columnGutter;
+
+  // the grid fills the space below the display, within the margins
+  solution->gridWidth = width - 2 * margin;
+  solution->gridHeight = height - solution->displayHeight - 2 * margin;
+
+  EWCLayoutRect cell = EWCLayoutCellRect(solution->gridWidth, solution->gridHeight,
+    grid->rows, grid->columns, solution->rowGutter, solution->columnGutter,
+    0, 0, 0, 0);
+  solution->cellWidth = cell.width;
+  solution->cellHeight = cell.height;
+
+  for (int i = 0; i < grid->placementCount; ++i) {
+    const EWCLayoutPlacement *placement = &grid->placements[i];
+    solution->frames[i] = EWCLayoutCellRect(solution->gridWidth, solution->gridHeight,
+      grid->rows, grid->columns, solution->rowGutter, solution->columnGutter,
+      placement->startRow, placement->startColumn,
+      placement->endRow, placement->endColumn);
+  }
+}
+
+///------------
+/// @name Cache
+///------------
+
+void EWCLayoutCacheClear(EWCLayoutCache *cache) {
+  cache->count = 0;
+  cache->lookups = 0;
+  cache->hits = 0;
+}
+
+const EWCLayoutSolution *EWCLayoutCacheSolve(EWCLayoutCache *cache, double width, double height, double margin) {
+  ++cache->lookups;
+
+  // find the dimensions, or the least recently used entry to replace
+  int replace = 0;
+  for (int i = 0; i < cache->count; ++i) {
+    EWCLayoutSolution *entry = &cache->entries[i];
+    if (entry->width == width && entry->height == height && entry->margin == margin) {
+      ++cache->hits;
+      cache->lastUsed[i] = cache->lookups;
+      return entry;
+    }
+
+    if (cache->lastUsed[i] < cache->lastUsed[replace]) {
+      replace = i;
+    }
+  }
+
+  if (cache->count < EWCLayoutCacheSize) {
+    replace = cache->count++;
+  }
+
+  EWCLayoutSolve(&cache->entries[replace], width, height, margin);
+  cache->lastUsed[replace] = cache->lookups;
+
+  return &cache->entries[replace];
+}
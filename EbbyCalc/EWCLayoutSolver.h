@@ -0,0 +1,225 @@
+//
+//  EWCLayoutSolver.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef EWCLayoutSolver_h
+#define EWCLayoutSolver_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// the most keys a grid layout can place
+#define EWCLayoutMaxPlacements 32
+
+// the number of solutions an `EWCLayoutCache` remembers
+#define EWCLayoutCacheSize 8
+
+/**
+  `EWCLayoutMode` represents the arrangement of the application layout.
+ */
+typedef enum {
+  EWCLayoutNarrowMode = 0,  // the wide grid, but the width is smaller than the height
+  EWCLayoutWideMode,  // the wide grid, and the width is larger than the height
+  EWCLayoutTallMode,  // the tall grid (greater than the tall aspect ratio)
+} EWCLayoutMode;
+
+/**
+  `EWCLayoutConstants` groups several values used for UI layout that can change according to the layout
+ */
+typedef struct {
+  /**
+    Used to calculate the text button font size using the current minimum dimension.
+   */
+  const float textSizeAsPercentOfHeight;
+
+  /**
+    Used to calculate the status indicator font size using the current minimum dimension.
+   */
+  const float statusSizeAsPercentOfHeight;
+
+  /**
+    Used to calculate the digit button font size using the current minimum dimension.
+   */
+  const float digitSizeAsPercentOfHeight;
+
+  /**
+    Used to calculate the text button font size using the current minimum dimension.
+   */
+  const float operatorSizeAsPercentOfHeight;
+
+  /**
+    Used to calculate the display font size using the current minimum dimension.
+   */
+  const float displaySizeAsPercentOfHeight;
+
+  /**
+    Used to calculate the display height from the font size it will need to display.
+   */
+  const float displayHeightFromFontSize;
+
+  /**
+    The minimum spacing between button rows as a percentage of height.
+   */
+  const float minimumRowGutter;
+
+  /**
+    The minimum spacing between button columns as a percentage of width.
+   */
+  const float minimumColumnGutter;
+} EWCLayoutConstants;
+
+/**
+  `EWCLayoutPlacement` places a key in a grid layout.
+ */
+typedef struct {
+  int key;  // the `EWCCalculatorKey` being placed
+  int startRow;  // the first row occupied by the key
+  int startColumn;  // the first column occupied by the key
+  int endRow;  // the last row occupied by the key
+  int endColumn;  // the last column occupied by the key
+} EWCLayoutPlacement;
+
+/**
+  `EWCLayoutGrid` describes an arrangement of the keys on the button grid.
+ */
+typedef struct {
+  int rows;  // the number of rows
+  int columns;  // the number of columns
+  const EWCLayoutPlacement *placements;  // where each key goes
+  int placementCount;  // the number of keys placed
+} EWCLayoutGrid;
+
+/**
+  `EWCLayoutRect` is a rectangle with its origin at the top left.
+ */
+typedef struct {
+  double x;  // the left edge
+  double y;  // the top edge
+  double width;  // the width
+  double height;  // the height
+} EWCLayoutRect;
+
+/**
+  `EWCLayoutSolution` holds everything about the layout that follows from the dimensions of the app: the arrangement, the font sizes, the constraint constants, and the frame of every key.
+ */
+typedef struct {
+  double width;  // the width laid out (within the safe area)
+  double height;  // the height laid out (within the safe area)
+  double margin;  // the margin at the sides and bottom of the grid
+  EWCLayoutMode mode;  // the arrangement chosen for the dimensions
+  const EWCLayoutConstants *constants;  // the constants of the arrangement
+  const EWCLayoutGrid *grid;  // the key grid of the arrangement
+  double rowGutter;  // the grid row gutter, as a fraction of the grid height
+  double columnGutter;  // the grid column gutter, as a fraction of the grid width
+  double displayFontSize;  // the display font size
+  double displayHeight;  // the height of the display area
+  double gridTopConstant;  // the constant of the constraint between the grid top and the safe area bottom
+  double textFontSize;  // the font size of the text and sub operator buttons
+  double digitFontSize;  // the font size of the digit buttons
+  double operatorFontSize;  // the font size of the main operator buttons
+  double operatorTitleInset;  // the bottom title inset of the main operator buttons
+  double statusFontSize;  // the font size of the status indicators
+  double statusInset;  // the leading and trailing spacing of the status indicators
+  double gridWidth;  // the width of the key grid
+  double gridHeight;  // the height of the key grid
+  double cellWidth;  // the width of a key occupying a single cell
+  double cellHeight;  // the height of a key occupying a single cell
+  EWCLayoutRect frames[EWCLayoutMaxPlacements];  // the frame of each key, in the order of the grid placements
+} EWCLayoutSolution;
+
+/**
+  `EWCLayoutCache` remembers the most recently used layout solutions, so that returning to dimensions that were laid out recently (as happens while resizing in Split View or Slide Over) doesn't need to solve them again.
+ */
+typedef struct {
+  EWCLayoutSolution entries[EWCLayoutCacheSize];  // the remembered solutions
+  uint64_t lastUsed[EWCLayoutCacheSize];  // when each entry was last used (by lookup count)
+  int count;  // the number of entries in use
+  uint64_t lookups;  // the number of lookups
+  uint64_t hits;  // the number of lookups answered from an entry
+} EWCLayoutCache;
+
+/**
+  Gets the layout constants of an arrangement.
+
+  @param mode The arrangement.
+
+  @return The constants.
+ */
+const EWCLayoutConstants *EWCLayoutConstantsForMode(EWCLayoutMode mode);
+
+/**
+  Gets the key grid of an arrangement.  The narrow and wide arrangements share a grid.
+
+  @param mode The arrangement.
+
+  @return The grid.
+ */
+const EWCLayoutGrid *EWCLayoutGridForMode(EWCLayoutMode mode);
+
+/**
+  Calculates the frame of a grid region, inset by half a gutter on each side.
+
+  @param gridWidth The total width of the grid.
+  @param gridHeight The total height of the grid.
+  @param rows The total number of rows in the grid.
+  @param columns The total number of columns in the grid.
+  @param rowGutter The row gutter setting (a percent of the grid height).
+  @param columnGutter The column gutter setting (a percent of the grid width).
+  @param startRow The first row of the region.
+  @param startColumn The first column of the region.
+  @param endRow The last row of the region (inclusive).
+  @param endColumn The last column of the region (inclusive).
+
+  @return The frame of the region.
+ */
+EWCLayoutRect EWCLayoutCellRect(double gridWidth, double gridHeight,
+  int rows, int columns, double rowGutter, double columnGutter,
+  int startRow, int startColumn, int endRow, int endColumn);
+
+/**
+  Solves the layout for the dimensions of the app.
+
+  @param solution Receives the solution.
+  @param width The width available (within the safe area).
+  @param height The height available (within the safe area).
+  @param margin The margin at the sides and bottom of the grid.
+ */
+void EWCLayoutSolve(EWCLayoutSolution *solution, double width, double height, double margin);
+
+/**
+  Empties a layout cache.
+
+  @param cache The cache to clear.
+ */
+void EWCLayoutCacheClear(EWCLayoutCache *cache);
+
+/**
+  Gets the layout solution for the dimensions of the app, solving it only if it isn't remembered.  When the cache is full, the least recently used solution is replaced.
+
+  @param cache The cache.
+  @param width The width available (within the safe area).
+  @param height The height available (within the safe area).
+  @param margin The margin at the sides and bottom of the grid.
+
+  @return The solution, which stays valid until a later lookup replaces it.
+ */
+const EWCLayoutSolution *EWCLayoutCacheSolve(EWCLayoutCache *cache, double width, double height, double margin);
+
+#endif /* EWCLayoutSolver_h */
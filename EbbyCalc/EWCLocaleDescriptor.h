@@ -0,0 +1,128 @@
+//
+//  EWCLocaleDescriptor.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import "EWCSpellOut.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  The longest locale symbol (sign affix or separator) a descriptor stores inline.
+ */
+#define EWCLocaleSymbolMaxLength 8
+
+/**
+  `EWCLocaleSymbol` holds a short locale symbol, such as a separator or sign prefix, inline.
+ */
+typedef struct {
+  unichar chars[EWCLocaleSymbolMaxLength];  // the symbol characters
+  short length;  // the number of characters used
+} EWCLocaleSymbol;
+
+/**
+  `EWCLocaleNumberRules` holds everything needed to render a decimal number the way a locale's decimal style `NSNumberFormatter` would, as plain data.
+ */
+typedef struct {
+  EWCLocaleSymbol positivePrefix;  // sign affixes
+  EWCLocaleSymbol positiveSuffix;
+  EWCLocaleSymbol negativePrefix;
+  EWCLocaleSymbol negativeSuffix;
+  EWCLocaleSymbol decimalSeparator;  // separator between the whole and fractional digits
+  EWCLocaleSymbol groupingSeparator;  // separator between groups of whole digits
+  EWCLocaleSymbol appendSeparator;  // the locale decimal separator, appended to a display that has none
+  unichar digitGlyphs[10];  // the native digit characters for 0-9
+  BOOL usesGrouping;  // whether whole digits are grouped at all
+  short groupingSize;  // size of the least significant group
+  short secondaryGroupingSize;  // size of each subsequent group
+  short minimumGroupingDigits;  // how many digits must precede the first separator for grouping to be applied
+} EWCLocaleNumberRules;
+
+/**
+  `EWCLocaleDescriptor` holds the number formatting facts about a locale that the calculator needs: its separators, grouping rules, digit glyphs, and the words used to spell numbers out.
+
+  Descriptors are interned: there is one per locale identifier for the life of the process, computed the first time it is asked for, and shared by every calculator and formatter using that locale.  They are immutable once created, so they can be used from any thread.
+ */
+@interface EWCLocaleDescriptor : NSObject
+
+/**
+  The locale described.
+ */
+@property (nonatomic, readonly) NSLocale *locale;
+
+/**
+  The identifier of the locale, which the descriptor is interned under.
+ */
+@property (nonatomic, readonly) NSString *localeIdentifier;
+
+/**
+  The locale decimal separator.
+ */
+@property (nonatomic, readonly) NSString *decimalSeparator;
+
+/**
+  The separator the locale places between groups of whole digits.
+ */
+@property (nonatomic, readonly) NSString *groupingSeparator;
+
+/**
+  The rules for rendering numbers directly, or NULL if some rule of the locale can't be represented (in which case numbers must go through `NSNumberFormatter`).  The rules have been checked against the formatter.
+ */
+@property (nonatomic, readonly, nullable) const EWCLocaleNumberRules *numberRules;
+
+/**
+  The spelled out words for the digits 0-9.
+ */
+@property (nonatomic, readonly) NSArray<NSString *> *spelledOutDigits;
+
+/**
+  The spelled out word that precedes a negative number (as in "minus one"), or nil if the locale doesn't spell negatives with a plain leading word.
+ */
+@property (nonatomic, readonly, nullable) NSString *spelledOutNegative;
+
+/**
+  The spelled out word between the whole and fractional parts of a number (as in "one point five"), or nil if the locale doesn't spell fractions with a plain separating word.
+ */
+@property (nonatomic, readonly, nullable) NSString *spelledOutDecimal;
+
+/**
+  The rules for spelling numbers out directly, or NULL if the locale's language has no native word tables or they don't match the locale's spell out style `NSNumberFormatter` (in which case numbers must be spelled out through the formatter).  The rules have been checked against the formatter.
+ */
+@property (nonatomic, readonly, nullable) const EWCSpellOutRules *spellOutRules;
+
+/**
+  Gets the descriptor for a locale, creating it if this is the first request for the locale's identifier.
+
+  @param locale The locale.
+
+  @return The shared descriptor.
+ */
++ (instancetype)descriptorForLocale:(NSLocale *)locale;
+
+/**
+  Gets the descriptor for the current locale.
+
+  @return The shared descriptor.
+ */
++ (instancetype)currentDescriptor;
+
+@end
+
+NS_ASSUME_NONNULL_END
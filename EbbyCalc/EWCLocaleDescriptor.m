@@ -0,0 +1,394 @@
+//
+//  EWCLocaleDescriptor.m
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCLocaleDescriptor.h"
+#import "EWCDisplayFormatter.h"
+#import "EWCSpellOutFormatter.h"
+
+// the fraction digits the number rules are checked with, enough for every probe
+static const NSInteger s_probeFractionDigits = 20;
+
+/**
+  Copies a string into a symbol.
+
+  @param str The string to store.
+  @param symbol Receives the string characters.
+
+  @return YES if the string fits in the symbol, otherwise NO.
+ */
+static BOOL setSymbol(NSString *str, EWCLocaleSymbol *symbol) {
+  if (str.length > EWCLocaleSymbolMaxLength) {
+    return NO;
+  }
+
+  [str getCharacters:symbol->chars range:NSMakeRange(0, str.length)];
+  symbol->length = (short)str.length;
+  return YES;
+}
+
+@interface EWCLocaleDescriptor () {
+  EWCLocaleNumberRules _rules;  // the captured number rules
+  BOOL _rulesSupported;  // whether the rules were captured and verified
+  EWCSpellOutRules _spellOutRules;  // the captured spell out rules
+  BOOL _spellOutSupported;  // whether the spell out rules were captured and verified
+}
+
+@end
+
+@implementation EWCLocaleDescriptor
+
+///----------------------------------------------
+/// @name Construction and Initialization Methods
+///----------------------------------------------
+
++ (instancetype)descriptorForLocale:(NSLocale *)locale {
+  static NSMutableDictionary<NSString *, EWCLocaleDescriptor *> *s_descriptors;
+  static dispatch_queue_t s_queue;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    s_descriptors = [NSMutableDictionary new];
+    s_queue = dispatch_queue_create("com.anselrognlie.EbbyCalc.localedescriptors", DISPATCH_QUEUE_SERIAL);
+  });
+
+  NSString *identifier = locale.localeIdentifier;
+  __block EWCLocaleDescriptor *descriptor;
+  dispatch_sync(s_queue, ^{
+    descriptor = s_descriptors[identifier];
+    if (! descriptor) {
+      descriptor = [[EWCLocaleDescriptor alloc] initWithLocale:locale];
+      s_descriptors[identifier] = descriptor;
+    }
+  });
+
+  return descriptor;
+}
+
++ (instancetype)currentDescriptor {
+  return [EWCLocaleDescriptor descriptorForLocale:[NSLocale currentLocale]];
+}
+
+/**
+  Initializes a descriptor, computing everything it describes.  Only used while interning.
+
+  @param locale The locale to describe.
+
+  @return The initialized descriptor.
+ */
+- (instancetype)initWithLocale:(NSLocale *)locale {
+  self = [super init];
+  if (self) {
+    _locale = [locale copy];
+    _localeIdentifier = [locale.localeIdentifier copy];
+    _decimalSeparator = [_locale decimalSeparator];
+
+    // this is the same configuration the calculator display has always used
+    NSNumberFormatter *formatter = [NSNumberFormatter new];
+    formatter.maximumFractionDigits = s_probeFractionDigits;
+    formatter.minimumFractionDigits = 0;
+    formatter.locale = _locale;
+    [formatter setNumberStyle:NSNumberFormatterDecimalStyle];
+
+    _groupingSeparator = formatter.groupingSeparator;
+    _rulesSupported = [self captureRulesFromFormatter:formatter]
+      && [self verifyRulesWithFormatter:formatter];
+
+    [self captureSpellOut];
+  }
+
+  return self;
+}
+
+///------------------------------
+/// @name Custom Property Methods
+///------------------------------
+
+- (const EWCLocaleNumberRules *)numberRules {
+  return _rulesSupported ? &_rules : NULL;
+}
+
+- (const EWCSpellOutRules *)spellOutRules {
+  return _spellOutSupported ? &_spellOutRules : NULL;
+}
+
+///---------------------------------
+/// @name Locale Table Setup Methods
+///---------------------------------
+
+/**
+  Reads the symbols and grouping rules from a decimal style formatter into the rules.
+
+  @param formatter The formatter for the locale.
+
+  @return YES if everything the renderer needs could be represented, otherwise NO.
+ */
+- (BOOL)captureRulesFromFormatter:(NSNumberFormatter *)formatter {
+  BOOL ok = setSymbol(formatter.positivePrefix, &_rules.positivePrefix)
+    && setSymbol(formatter.positiveSuffix, &_rules.positiveSuffix)
+    && setSymbol(formatter.negativePrefix, &_rules.negativePrefix)
+    && setSymbol(formatter.negativeSuffix, &_rules.negativeSuffix)
+    && setSymbol(formatter.decimalSeparator, &_rules.decimalSeparator)
+    && setSymbol(formatter.groupingSeparator, &_rules.groupingSeparator)
+    && setSymbol(_decimalSeparator, &_rules.appendSeparator);
+
+  if (! ok) { return NO; }
+
+  _rules.usesGrouping = formatter.usesGroupingSeparator && formatter.groupingSize > 0;
+  _rules.groupingSize = (short)formatter.groupingSize;
+  _rules.secondaryGroupingSize = (formatter.secondaryGroupingSize > 0)
+    ? (short)formatter.secondaryGroupingSize
+    : _rules.groupingSize;
+
+  // read the native digits by formatting each one, then stripping the affixes
+  NSString *prefix = formatter.positivePrefix;
+  NSString *suffix = formatter.positiveSuffix;
+  for (int i = 0; i < 10; ++i) {
+    NSString *str = [formatter stringFromNumber:@(i)];
+    if (str.length != prefix.length + suffix.length + 1) {
+      return NO;
+    }
+
+    _rules.digitGlyphs[i] = [str characterAtIndex:prefix.length];
+  }
+
+  // some locales only group once there are enough whole digits (e.g. 1234 but
+  // 12.345), which the formatter doesn't expose, so probe for it
+  _rules.minimumGroupingDigits = 1;
+  if (_rules.usesGrouping) {
+    NSDecimalNumber *probe = [NSDecimalNumber one];
+    for (short i = 0; i < _rules.groupingSize; ++i) {
+      probe = [probe decimalNumberByMultiplyingByPowerOf10:1];
+    }
+
+    // probe is now the smallest number with groupingSize + 1 whole digits
+    while (_rules.minimumGroupingDigits < 4) {
+      NSString *str = [formatter stringFromNumber:probe];
+      if ([str containsString:formatter.groupingSeparator]) {
+        break;
+      }
+
+      ++_rules.minimumGroupingDigits;
+      probe = [probe decimalNumberByMultiplyingByPowerOf10:1];
+    }
+  }
+
+  return YES;
+}
+
+/**
+  Renders a set of representative values both directly and through the formatter, to catch any locale rule the captured rules miss.
+
+  @param formatter The formatter for the locale.
+
+  @return YES if the direct rendering matched for every probe value.
+ */
+- (BOOL)verifyRulesWithFormatter:(NSNumberFormatter *)formatter {
+  NSArray<NSString *> *probes = @[
+    @"0", @"7", @"-7", @"0.5", @"-0.25", @"1234", @"12345", @"-123456",
+    @"1234567890.125", @"-9876543210987654", @"0.000123",
+  ];
+
+  unichar buffer[EWCDisplayFormatterBufferSize];
+  for (NSString *probe in probes) {
+    NSDecimalNumber *number = [NSDecimalNumber decimalNumberWithString:probe];
+    for (NSInteger minimum = 0; minimum <= 2; ++minimum) {
+      NSUInteger length = EWCDisplayRenderDecimal(&_rules, number.decimalValue,
+        s_probeFractionDigits, minimum,
+        buffer, EWCDisplayFormatterBufferSize);
+      if (length == 0) {
+        return NO;
+      }
+
+      formatter.minimumFractionDigits = minimum;
+      NSString *reference = [formatter stringFromNumber:number];
+      if (! [reference containsString:_decimalSeparator]) {
+        reference = [reference stringByAppendingString:_decimalSeparator];
+      }
+
+      if (! [[NSString stringWithCharacters:buffer length:length] isEqualToString:reference]) {
+        return NO;
+      }
+    }
+  }
+
+  return YES;
+}
+
+/**
+  Reads the words the locale uses to spell out digits, negatives, and fractions.
+ */
+- (void)captureSpellOut {
+  NSNumberFormatter *formatter = [NSNumberFormatter new];
+  formatter.locale = _locale;
+  [formatter setNumberStyle:NSNumberFormatterSpellOutStyle];
+
+  NSMutableArray<NSString *> *digits = [NSMutableArray arrayWithCapacity:10];
+  for (int i = 0; i < 10; ++i) {
+    [digits addObject:[formatter stringFromNumber:@(i)] ?: @""];
+  }
+  _spelledOutDigits = [digits copy];
+
+  NSCharacterSet *whitespace = [NSCharacterSet whitespaceCharacterSet];
+  NSString *one = digits[1];
+  NSString *five = digits[5];
+
+  // a negative is a plain leading word when "-1" spells as that word and "one"
+  NSString *negative = [formatter stringFromNumber:@(-1)];
+  if ([negative hasSuffix:one] && negative.length > one.length) {
+    NSString *word = [[negative substringToIndex:negative.length - one.length]
+      stringByTrimmingCharactersInSet:whitespace];
+    _spelledOutNegative = (word.length > 0) ? word : nil;
+  }
+
+  // likewise, a fraction is separated by a plain word when "1.5" spells as
+  // "one", that word, and "five"
+  NSString *fraction = [formatter stringFromNumber:[NSDecimalNumber decimalNumberWithString:@"1.5"]];
+  if ([fraction hasPrefix:one] && [fraction hasSuffix:five]
+    && fraction.length > one.length + five.length) {
+    NSString *word = [[fraction substringWithRange:NSMakeRange(one.length,
+      fraction.length - one.length - five.length)]
+      stringByTrimmingCharactersInSet:whitespace];
+    _spelledOutDecimal = (word.length > 0) ? word : nil;
+  }
+
+  _spellOutSupported = [self captureSpellOutRulesFromFormatter:formatter]
+    && [self verifySpellOutRulesWithFormatter:formatter];
+}
+
+/**
+  Spells out a value directly under the spell out rules.
+
+  @param value The value to spell out.
+  @param maximumFractionDigits The maximum number of fractional digits to spell out.
+  @param minimumFractionDigits The minimum number of fractional digits to spell out.
+
+  @return The spelled out value, or nil if it couldn't be spelled out directly.
+ */
+- (nullable NSString *)spellOutDecimal:(NSDecimalNumber *)value
+  maximumFractionDigits:(NSInteger)maximumFractionDigits
+  minimumFractionDigits:(NSInteger)minimumFractionDigits {
+
+  char buffer[EWCSpellOutBufferSize];
+  NSUInteger length = EWCSpellOutRenderDecimal(&_spellOutRules, value.decimalValue,
+    maximumFractionDigits, minimumFractionDigits,
+    buffer, EWCSpellOutBufferSize);
+
+  if (length == 0) {
+    return nil;
+  }
+
+  return [[NSString alloc] initWithBytes:buffer length:length encoding:NSUTF8StringEncoding];
+}
+
+/**
+  Finds the native word tables for the locale's language, checks that they use the words the spell out formatter does, and probes how the formatter treats the fraction digit limits.
+
+  @param formatter The spell out style formatter for the locale.
+
+  @return YES if the language can be spelled out directly, otherwise NO.
+ */
+- (BOOL)captureSpellOutRulesFromFormatter:(NSNumberFormatter *)formatter {
+  NSString *code = [_locale objectForKey:NSLocaleLanguageCode];
+  _spellOutRules.language = code ? EWCSpellOutLanguageForCode(code.UTF8String) : NULL;
+
+  const EWCSpellOutLanguage *language = _spellOutRules.language;
+  if (! language) { return NO; }
+
+  for (int i = 0; i < 10; ++i) {
+    if (! [_spelledOutDigits[i] isEqualToString:@(language->ones[i])]) {
+      return NO;
+    }
+  }
+
+  if (! [_spelledOutNegative isEqualToString:@(language->negative)]
+    || ! [_spelledOutDecimal isEqualToString:@(language->point)]) {
+    return NO;
+  }
+
+  // whether the minimum fraction digits are spelled as trailing zeros, and
+  // whether digits beyond the maximum are rounded away, are each taken from
+  // whichever choice reproduces the formatter
+  NSDecimalNumber *padded = [NSDecimalNumber decimalNumberWithString:@"1.5"];
+  formatter.maximumFractionDigits = s_probeFractionDigits;
+  formatter.minimumFractionDigits = 2;
+  NSString *reference = [formatter stringFromNumber:padded];
+
+  _spellOutRules.padsFraction = YES;
+  if (! [[self spellOutDecimal:padded maximumFractionDigits:s_probeFractionDigits minimumFractionDigits:2]
+    isEqualToString:reference]) {
+    _spellOutRules.padsFraction = NO;
+    if (! [[self spellOutDecimal:padded maximumFractionDigits:s_probeFractionDigits minimumFractionDigits:2]
+      isEqualToString:reference]) {
+      return NO;
+    }
+  }
+
+  NSDecimalNumber *rounded = [NSDecimalNumber decimalNumberWithString:@"1.125"];
+  formatter.maximumFractionDigits = 2;
+  formatter.minimumFractionDigits = 0;
+  reference = [formatter stringFromNumber:rounded];
+
+  _spellOutRules.roundsFraction = YES;
+  if (! [[self spellOutDecimal:rounded maximumFractionDigits:2 minimumFractionDigits:0]
+    isEqualToString:reference]) {
+    _spellOutRules.roundsFraction = NO;
+    if (! [[self spellOutDecimal:rounded maximumFractionDigits:2 minimumFractionDigits:0]
+      isEqualToString:reference]) {
+      return NO;
+    }
+  }
+
+  return YES;
+}
+
+/**
+  Spells out a set of representative values both directly and through the formatter, to catch any rule of the language the word tables miss.
+
+  @param formatter The spell out style formatter for the locale.
+
+  @return YES if the direct spelling matched for every probe value.
+ */
+- (BOOL)verifySpellOutRulesWithFormatter:(NSNumberFormatter *)formatter {
+  NSArray<NSString *> *probes = @[
+    @"0", @"7", @"-7", @"13", @"21", @"-40", @"100", @"101", @"115", @"999",
+    @"1000", @"1001", @"12345", @"100000", @"1000010", @"0.5", @"-0.25",
+    @"0.05", @"1234567890.125", @"-9876543210987654", @"120000000000000000",
+  ];
+
+  formatter.maximumFractionDigits = s_probeFractionDigits;
+  for (NSString *probe in probes) {
+    NSDecimalNumber *number = [NSDecimalNumber decimalNumberWithString:probe];
+    for (NSInteger minimum = 0; minimum <= 2; ++minimum) {
+      formatter.minimumFractionDigits = minimum;
+      NSString *reference = [formatter stringFromNumber:number];
+      NSString *spelled = [self spellOutDecimal:number
+        maximumFractionDigits:s_probeFractionDigits
+        minimumFractionDigits:minimum];
+
+      if (! [spelled isEqualToString:reference]) {
+        return NO;
+      }
+    }
+  }
+
+  return YES;
+}
+
+@end
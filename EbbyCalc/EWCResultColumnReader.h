@@ -0,0 +1,130 @@
+//
+//  EWCResultColumnReader.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import "EWCResultColumns.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCResultColumnReader` reads the results written by `EWCResultColumnWriter`.
+
+  A file is mapped into memory rather than read, so that a tool can scan a single column of a large batch (the error flags, say) without the rest of the file being paged in.  Each block is checked against its checksum the first time it is used, and the rows of a damaged block can't be read.  A file without a footer, because it is still being written or its writer stopped, reads as its whole blocks, with the index entries worked out from the blocks themselves.
+ */
+@interface EWCResultColumnReader : NSObject
+
+/**
+  The rows held by each block.
+ */
+@property (nonatomic, readonly) uint32_t rowsPerBlock;
+
+/**
+  The number of blocks.
+ */
+@property (nonatomic, readonly) NSUInteger blockCount;
+
+/**
+  The number of rows.
+ */
+@property (nonatomic, readonly) NSUInteger rowCount;
+
+/**
+  The number of rows with the error flag set.
+ */
+@property (nonatomic, readonly) NSUInteger errorCount;
+
+/**
+  Whether the file ends with a footer, so that its writer finished.
+ */
+@property (nonatomic, readonly, getter=isFinished) BOOL finished;
+
+/**
+  Creates a reader of a file, mapping it into memory.
+
+  @param path The path of the file.
+
+  @return The new reader, or nil if the file couldn't be mapped or doesn't start with a valid header.
+ */
++ (nullable instancetype)readerWithContentsOfFile:(NSString *)path;
+
+/**
+  Creates a reader of results already in memory.
+
+  @param data The results.
+
+  @return The new reader, or nil if the data doesn't start with a valid header.
+ */
++ (nullable instancetype)readerWithData:(NSData *)data;
+
+/**
+  Initializes a reader.
+
+  @param data The results.
+
+  @return The initialized instance, or nil if the data doesn't start with a valid header.
+ */
+- (nullable instancetype)initWithData:(NSData *)data;
+
+/**
+  Reads a row.
+
+  @param row Receives the row.
+  @param index The index of the row, in the order the rows were appended.
+
+  @return NO if the index is past the last row, or the row's block is damaged.
+ */
+- (BOOL)getRow:(EWCResultRow *)row atIndex:(NSUInteger)index;
+
+/**
+  Finds the first row of a session, skipping the blocks whose index entries show they can't hold it.
+
+  @param sessionID The session to find.
+
+  @return The index of the row, or `NSNotFound` if no row has that session id.
+ */
+- (NSUInteger)indexOfRowWithSessionID:(uint64_t)sessionID;
+
+/**
+  Gets the index entry of a block.
+
+  @param entry Receives the entry.
+  @param block The block.
+
+  @return NO if the block is past the last one.
+ */
+- (BOOL)getIndexEntry:(EWCResultColumnsIndexEntry *)entry forBlock:(NSUInteger)block;
+
+/**
+  Gets the mapped bytes of a column of a block, for scanning a column directly.  The entries are `EWCResultColumnsWidth` bytes each, and stay valid as long as the reader.
+
+  @param column The column.
+  @param block The block.
+  @param rowCount Receives the number of rows in the block.
+
+  @return The first entry of the column, or NULL if the block is past the last one or is damaged.
+ */
+- (nullable const uint8_t *)bytesOfColumn:(EWCResultColumn)column
+  inBlock:(NSUInteger)block
+  rowCount:(uint32_t *)rowCount;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,225 @@
+//
+//  EWCResultColumnReader.m
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCResultColumnReader.h"
+
+// the states of the checks of each block
+#define EWCResultColumnReaderUnchecked 0
+#define EWCResultColumnReaderIntact 1
+#define EWCResultColumnReaderDamaged 2
+
+@interface EWCResultColumnReader() {
+  NSData *_data;  // the results, usually mapped from a file
+  size_t _blockSize;  // the size of each block
+  const uint8_t *_index;  // the index entries of the footer, or NULL if the file has no footer
+  NSMutableData *_checks;  // the state of the check of each block
+}
+
+@end
+
+@implementation EWCResultColumnReader
+
+///----------------------------------------------
+/// @name Construction and Initialization Methods
+///----------------------------------------------
+
++ (instancetype)readerWithContentsOfFile:(NSString *)path {
+  NSData *data = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedAlways error:NULL];
+  if (! data) {
+    return nil;
+  }
+
+  return [[EWCResultColumnReader alloc] initWithData:data];
+}
+
++ (instancetype)readerWithData:(NSData *)data {
+  return [[EWCResultColumnReader alloc] initWithData:data];
+}
+
+- (instancetype)initWithData:(NSData *)data {
+  uint32_t rowsPerBlock;
+  if (! EWCResultColumnsDecodeHeader(data.bytes, data.length, &rowsPerBlock)) {
+    return nil;
+  }
+
+  self = [super init];
+  if (self) {
+    _data = data;
+    _rowsPerBlock = rowsPerBlock;
+    _blockSize = EWCResultColumnsBlockSize(rowsPerBlock);
+
+    const uint8_t *bytes = data.bytes;
+    uint32_t blockCount;
+    const uint8_t *index;
+    if (EWCResultColumnsDecodeFooter(bytes, data.length, rowsPerBlock, &blockCount, &index)) {
+      _finished = YES;
+      _index = index;
+      _blockCount = blockCount;
+    } else {
+      // an unfinished file is read as far as its whole blocks
+      _blockCount = (data.length - EWCResultColumnsHeaderSize) / _blockSize;
+    }
+
+    _checks = [NSMutableData dataWithLength:_blockCount];
+
+    // every block but the last is full, which is what lets a row be found
+    // from its index alone
+    for (NSUInteger b = 0; b < _blockCount; ++b) {
+      EWCResultColumnsIndexEntry entry;
+      [self getIndexEntry:&entry forBlock:b];
+
+      _rowCount += entry.rowCount;
+      _errorCount += entry.errorCount;
+
+      if (entry.rowCount < _rowsPerBlock) {
+        _blockCount = b + 1;
+        break;
+      }
+    }
+  }
+
+  return self;
+}
+
+///----------------------
+/// @name Reading Methods
+///----------------------
+
+- (BOOL)getRow:(EWCResultRow *)row atIndex:(NSUInteger)index {
+  if (index >= _rowCount) {
+    return NO;
+  }
+
+  const uint8_t *block = [self intactBlock:index / _rowsPerBlock];
+  if (! block) {
+    return NO;
+  }
+
+  EWCResultColumnsDecodeRow(block, _rowsPerBlock, (uint32_t)(index % _rowsPerBlock), row);
+
+  return YES;
+}
+
+- (NSUInteger)indexOfRowWithSessionID:(uint64_t)sessionID {
+  for (NSUInteger b = 0; b < _blockCount; ++b) {
+    EWCResultColumnsIndexEntry entry;
+    [self getIndexEntry:&entry forBlock:b];
+    if (entry.rowCount == 0 || sessionID < entry.minimumSessionID || sessionID > entry.maximumSessionID) {
+      continue;
+    }
+
+    uint32_t rowCount;
+    const uint8_t *ids = [self bytesOfColumn:EWCResultSessionIDColumn inBlock:b rowCount:&rowCount];
+    if (! ids) {
+      continue;
+    }
+
+    for (uint32_t i = 0; i < rowCount; ++i) {
+      if (EWCResultColumnsReadUInt64(ids + 8 * i) == sessionID) {
+        return b * _rowsPerBlock + i;
+      }
+    }
+  }
+
+  return NSNotFound;
+}
+
+- (BOOL)getIndexEntry:(EWCResultColumnsIndexEntry *)entry forBlock:(NSUInteger)block {
+  if (block >= _blockCount) {
+    return NO;
+  }
+
+  if (_index) {
+    EWCResultColumnsDecodeIndexEntry(_index + block * EWCResultColumnsIndexEntrySize, entry);
+    return YES;
+  }
+
+  // without a footer, work the entry out from the block
+  *entry = (EWCResultColumnsIndexEntry){ 0 };
+
+  uint32_t rowCount;
+  const uint8_t *ids = [self bytesOfColumn:EWCResultSessionIDColumn inBlock:block rowCount:&rowCount];
+  const uint8_t *errors = [self bytesOfColumn:EWCResultErrorColumn inBlock:block rowCount:&rowCount];
+  if (! ids) {
+    return YES;
+  }
+
+  entry->rowCount = rowCount;
+  for (uint32_t i = 0; i < rowCount; ++i) {
+    uint64_t sessionID = EWCResultColumnsReadUInt64(ids + 8 * i);
+    if (i == 0 || sessionID < entry->minimumSessionID) {
+      entry->minimumSessionID = sessionID;
+    }
+    if (i == 0 || sessionID > entry->maximumSessionID) {
+      entry->maximumSessionID = sessionID;
+    }
+    if (errors[i]) {
+      ++entry->errorCount;
+    }
+  }
+
+  return YES;
+}
+
+- (const uint8_t *)bytesOfColumn:(EWCResultColumn)column
+  inBlock:(NSUInteger)block
+  rowCount:(uint32_t *)rowCount {
+
+  const uint8_t *bytes = [self intactBlock:block];
+  if (! bytes) {
+    *rowCount = 0;
+    return NULL;
+  }
+
+  *rowCount = EWCResultColumnsBlockRowCount(bytes);
+
+  return bytes + EWCResultColumnsOffset(column, _rowsPerBlock);
+}
+
+///------------------------------
+/// @name Internal helper methods
+///------------------------------
+
+/**
+  Gets a block, checking it against its checksum the first time.
+
+  @param block The block.
+
+  @return The start of the block, or NULL if the block is past the last one or is damaged.
+ */
+- (const uint8_t *)intactBlock:(NSUInteger)block {
+  if (block >= _blockCount) {
+    return NULL;
+  }
+
+  const uint8_t *bytes = (const uint8_t *)_data.bytes + EWCResultColumnsHeaderSize + block * _blockSize;
+
+  uint8_t *checks = _checks.mutableBytes;
+  if (checks[block] == EWCResultColumnReaderUnchecked) {
+    checks[block] = EWCResultColumnsBlockIsValid(bytes, _rowsPerBlock)
+      ? EWCResultColumnReaderIntact
+      : EWCResultColumnReaderDamaged;
+  }
+
+  return (checks[block] == EWCResultColumnReaderIntact) ? bytes : NULL;
+}
+
+@end
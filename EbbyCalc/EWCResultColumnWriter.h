@@ -0,0 +1,117 @@
+//
+//  EWCResultColumnWriter.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import "EWCResultColumns.h"
+
+@class EWCCalculator;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  Gathers the results a calculator holds at the end of a session into a row.
+
+  @param row Receives the results.
+  @param sessionID Identifies the session.
+  @param keyCount The number of keys the session processed.
+  @param calculator The calculator the session ran on.
+ */
+void EWCResultRowFromCalculator(EWCResultRow *row, uint64_t sessionID, uint64_t keyCount, EWCCalculator *calculator);
+
+/**
+  `EWCResultColumnWriter` writes the results of many sessions in the result columns format described in `EWCResultColumns.h`, for reading back with `EWCResultColumnReader`.
+
+  Rows are written into their columns of a block in memory, and each block is written to the output stream (with its checksum) once it fills, so rows can be appended for as long as a batch runs without the whole file being held.  Finishing writes the last block and the footer index.
+ */
+@interface EWCResultColumnWriter : NSObject
+
+/**
+  The rows held by each block.
+ */
+@property (nonatomic, readonly) uint32_t rowsPerBlock;
+
+/**
+  The number of rows appended.
+ */
+@property (nonatomic, readonly) NSUInteger rowCount;
+
+/**
+  The number of blocks written to the output stream.
+ */
+@property (nonatomic, readonly) NSUInteger blockCount;
+
+/**
+  The number of bytes written to the output stream.
+ */
+@property (nonatomic, readonly) NSUInteger bytesWritten;
+
+/**
+  Creates a new writer.
+
+  @param stream The stream to receive the results.  It is opened when the first row is appended, and closed when the writer finishes.
+  @param rowsPerBlock The rows to hold in each block, rounded up to a multiple of `EWCResultColumnsRowAlignment`.
+
+  @return The new writer.
+ */
++ (instancetype)writerWithOutputStream:(NSOutputStream *)stream rowsPerBlock:(uint32_t)rowsPerBlock;
+
+/**
+  Initializes a writer.
+
+  @param stream The stream to receive the results.
+  @param rowsPerBlock The rows to hold in each block.
+
+  @return The initialized instance.
+ */
+- (instancetype)initWithOutputStream:(NSOutputStream *)stream rowsPerBlock:(uint32_t)rowsPerBlock;
+
+/**
+  Appends the results of a session.
+
+  @param row The results.
+
+  @return NO if the output stream couldn't be written, or the writer has finished.
+ */
+- (BOOL)appendRow:(const EWCResultRow *)row;
+
+/**
+  Appends the results a calculator holds at the end of a session.
+
+  @param sessionID Identifies the session.
+  @param keyCount The number of keys the session processed.
+  @param calculator The calculator the session ran on.
+
+  @return NO if the output stream couldn't be written.
+ */
+- (BOOL)appendSessionID:(uint64_t)sessionID
+  keyCount:(uint64_t)keyCount
+  calculator:(EWCCalculator *)calculator;
+
+/**
+  Writes the last block and the footer, and closes the output stream.  Nothing more can be appended afterwards.
+
+  @return NO if the output stream couldn't be written.
+ */
+- (BOOL)finish;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,198 @@
+//
+//  EWCResultColumnWriter.m
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCResultColumnWriter.h"
+#import "EWCCalculator.h"
+
+@interface EWCResultColumnWriter() {
+  NSOutputStream *_stream;  // receives the results
+  NSMutableData *_block;  // the block being filled
+  uint32_t _blockRowCount;  // the rows in the block being filled
+  EWCResultColumnsIndexEntry _entry;  // the index entry of the block being filled
+  NSMutableData *_index;  // the encoded index entries of the blocks written
+  BOOL _started;  // whether the stream has been opened and the header written
+  BOOL _finished;  // whether the footer has been written and the stream closed
+  BOOL _failed;  // whether a write to the stream has failed
+}
+
+@end
+
+void EWCResultRowFromCalculator(EWCResultRow *row, uint64_t sessionID, uint64_t keyCount, EWCCalculator *calculator) {
+  row->sessionID = sessionID;
+  row->keyCount = keyCount;
+  row->display = calculator.displayValue.decimalValue;
+  row->memory = calculator.memoryValue.decimalValue;
+  row->error = calculator.hasError;
+  row->status = (calculator.hasMemory ? EWCResultMemoryStatus : 0)
+    | (calculator.isTaxStatusVisible ? EWCResultTaxStatus : 0)
+    | (calculator.isTaxPlusStatusVisible ? EWCResultTaxPlusStatus : 0)
+    | (calculator.isTaxMinusStatusVisible ? EWCResultTaxMinusStatus : 0)
+    | (calculator.isTaxPercentStatusVisible ? EWCResultTaxPercentStatus : 0)
+    | (calculator.isRateShifted ? EWCResultRateShiftedStatus : 0);
+}
+
+@implementation EWCResultColumnWriter
+
+///----------------------------------------------
+/// @name Construction and Initialization Methods
+///----------------------------------------------
+
++ (instancetype)writerWithOutputStream:(NSOutputStream *)stream rowsPerBlock:(uint32_t)rowsPerBlock {
+  return [[EWCResultColumnWriter alloc] initWithOutputStream:stream rowsPerBlock:rowsPerBlock];
+}
+
+- (instancetype)initWithOutputStream:(NSOutputStream *)stream rowsPerBlock:(uint32_t)rowsPerBlock {
+  self = [super init];
+  if (self) {
+    _stream = stream;
+
+    uint32_t alignment = EWCResultColumnsRowAlignment;
+    _rowsPerBlock = MAX((rowsPerBlock + alignment - 1) / alignment * alignment, alignment);
+
+    _block = [NSMutableData dataWithLength:EWCResultColumnsBlockSize(_rowsPerBlock)];
+    _index = [NSMutableData new];
+  }
+
+  return self;
+}
+
+///----------------------
+/// @name Writing Methods
+///----------------------
+
+- (BOOL)appendRow:(const EWCResultRow *)row {
+  if (_finished) {
+    return NO;
+  }
+
+  [self start];
+
+  EWCResultColumnsEncodeRow(_block.mutableBytes, _rowsPerBlock, _blockRowCount, row);
+
+  if (_blockRowCount == 0 || row->sessionID < _entry.minimumSessionID) {
+    _entry.minimumSessionID = row->sessionID;
+  }
+  if (_blockRowCount == 0 || row->sessionID > _entry.maximumSessionID) {
+    _entry.maximumSessionID = row->sessionID;
+  }
+  if (row->error) {
+    ++_entry.errorCount;
+  }
+
+  ++_rowCount;
+  if (++_blockRowCount == _rowsPerBlock) {
+    [self writeBlock];
+  }
+
+  return ! _failed;
+}
+
+- (BOOL)appendSessionID:(uint64_t)sessionID
+  keyCount:(uint64_t)keyCount
+  calculator:(EWCCalculator *)calculator {
+
+  EWCResultRow row;
+  EWCResultRowFromCalculator(&row, sessionID, keyCount, calculator);
+
+  return [self appendRow:&row];
+}
+
+- (BOOL)finish {
+  if (_finished) {
+    return ! _failed;
+  }
+
+  [self start];
+  _finished = YES;
+
+  if (_blockRowCount > 0) {
+    [self writeBlock];
+  }
+
+  uint8_t trailer[EWCResultColumnsTrailerSize];
+  EWCResultColumnsEncodeTrailer((uint32_t)_blockCount, _index.bytes, trailer);
+  [self writeBytes:_index.bytes length:_index.length];
+  [self writeBytes:trailer length:EWCResultColumnsTrailerSize];
+
+  [_stream close];
+
+  return ! _failed;
+}
+
+///------------------------------
+/// @name Internal helper methods
+///------------------------------
+
+/**
+  Opens the output stream and writes the header, if that hasn't been done yet.
+ */
+- (void)start {
+  if (_started) {
+    return;
+  }
+
+  _started = YES;
+  [_stream open];
+
+  uint8_t header[EWCResultColumnsHeaderSize];
+  [self writeBytes:header length:EWCResultColumnsEncodeHeader(header, _rowsPerBlock)];
+}
+
+/**
+  Seals the block being filled, writes it out with its index entry, and starts an empty block.
+ */
+- (void)writeBlock {
+  uint8_t *block = _block.mutableBytes;
+  EWCResultColumnsSealBlock(block, _rowsPerBlock, _blockRowCount);
+  [self writeBytes:block length:_block.length];
+
+  _entry.rowCount = _blockRowCount;
+  uint8_t entry[EWCResultColumnsIndexEntrySize];
+  [_index appendBytes:entry length:EWCResultColumnsEncodeIndexEntry(&_entry, entry)];
+
+  // the rows past the count of the next block must be zero
+  memset(block, 0, _block.length);
+  _blockRowCount = 0;
+  _entry = (EWCResultColumnsIndexEntry){ 0 };
+  ++_blockCount;
+}
+
+/**
+  Writes bytes to the output stream, noting any failure.
+
+  @param bytes The bytes to write.
+  @param length The number of bytes to write.
+ */
+- (void)writeBytes:(const uint8_t *)bytes length:(size_t)length {
+  while (length > 0 && ! _failed) {
+    NSInteger written = [_stream write:bytes maxLength:length];
+    if (written <= 0) {
+      _failed = YES;
+      return;
+    }
+
+    bytes += written;
+    length -= (size_t)written;
+    _bytesWritten += (NSUInteger)written;
+  }
+}
+
+@end
@@ -0,0 +1,325 @@
+//
+//  EWCResultColumns.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  The result columns format holds the final results of many calculator sessions in fixed-size blocks of typed columns, so that batches can write results without formatting text, and downstream tools can map a file and scan one column without parsing the others.
+
+  A file starts with a 16 byte header: the 4 byte magic "EWCR", a version byte, the column count, two zero bytes, the rows per block as a 4 byte little endian value, and four zero bytes.
+
+  The header is followed by the blocks, each `EWCResultColumnsBlockSize` bytes, so block n is found at a fixed offset.  A block starts with a 4 byte little endian FNV-1a checksum of the rest of the block, and the 4 byte little endian count of the rows it holds.  Then each column follows in turn, sized for the full rows per block, with the rows past the count zero filled:
+
+  - the session id, 8 bytes little endian
+  - the keys processed, 8 bytes little endian
+  - the display value, as a column decimal
+  - the memory value, as a column decimal
+  - the error flag, 1 byte
+  - the status flags (`EWCResultStatus`), 1 byte
+
+  A column decimal is 20 bytes: the mantissa as a 16 byte little endian integer, the exponent as a signed byte, a flags byte (bit 0 negative, bit 1 NaN), and two zero bytes.  This holds an `NSDecimal` exactly, without depending on the layout of the `NSDecimal` struct, which differs between Foundation implementations.
+
+  Every block but the last is full.  Once the last block is written, a footer follows, with an index entry for each block (`EWCResultColumnsIndexEntrySize` bytes: the smallest and largest session ids as 8 byte values, then the row count and error count as 4 byte values, all little endian), and a 12 byte trailer: the block count and a checksum of the index, as 4 byte little endian values, then the magic "EWCR" again.  A file without a footer is one still being written (or whose writer stopped), and its whole blocks can still be read.
+ */
+
+/**
+  The version of the result columns format written.
+ */
+#define EWCResultColumnsVersion 1
+
+/**
+  The size of the file header.
+ */
+#define EWCResultColumnsHeaderSize 16
+
+/**
+  The size of the header at the start of each block.
+ */
+#define EWCResultColumnsBlockHeaderSize 8
+
+/**
+  The size of a column decimal.
+ */
+#define EWCResultColumnsDecimalSize 20
+
+/**
+  The size of each block index entry in the footer.
+ */
+#define EWCResultColumnsIndexEntrySize 24
+
+/**
+  The size of the trailer at the end of the footer.
+ */
+#define EWCResultColumnsTrailerSize 12
+
+/**
+  The rows per block must be a multiple of this, so that the 8 byte columns of every block stay aligned in a mapped file.
+ */
+#define EWCResultColumnsRowAlignment 8
+
+/**
+  `EWCResultColumn` identifies each column of a block, in the order they are laid out.
+ */
+typedef NS_ENUM(NSInteger, EWCResultColumn) {
+  EWCResultSessionIDColumn = 0,
+  EWCResultKeyCountColumn,
+  EWCResultDisplayColumn,
+  EWCResultMemoryColumn,
+  EWCResultErrorColumn,
+  EWCResultStatusColumn,
+  EWCResultColumnCount,
+};
+
+/**
+  `EWCResultStatus` holds the status indicators of a session's calculator.
+ */
+typedef NS_OPTIONS(uint8_t, EWCResultStatus) {
+  EWCResultNoStatus = 0,
+  EWCResultMemoryStatus = 1 << 0,
+  EWCResultTaxStatus = 1 << 1,
+  EWCResultTaxPlusStatus = 1 << 2,
+  EWCResultTaxMinusStatus = 1 << 3,
+  EWCResultTaxPercentStatus = 1 << 4,
+  EWCResultRateShiftedStatus = 1 << 5,
+};
+
+/**
+  `EWCResultRow` holds the results of one session, one value for each column.
+ */
+typedef struct {
+  uint64_t sessionID;  // identifies the session
+  uint64_t keyCount;  // the number of keys the session processed
+  NSDecimal display;  // the value in the display
+  NSDecimal memory;  // the value in memory
+  BOOL error;  // whether the calculator ended in the error state
+  EWCResultStatus status;  // the status indicators
+} EWCResultRow;
+
+/**
+  `EWCResultColumnsIndexEntry` describes one block, so that a reader can skip the blocks that can't hold what it is looking for.
+ */
+typedef struct {
+  uint64_t minimumSessionID;  // the smallest session id in the block
+  uint64_t maximumSessionID;  // the largest session id in the block
+  uint32_t rowCount;  // the number of rows in the block
+  uint32_t errorCount;  // the number of rows with the error flag set
+} EWCResultColumnsIndexEntry;
+
+/**
+  Reads a little endian 8 byte value, as held in the 8 byte columns.
+
+  @param bytes The value.
+
+  @return The value.
+ */
+static inline uint64_t EWCResultColumnsReadUInt64(const uint8_t *bytes) {
+  uint64_t value = 0;
+  for (int i = 7; i >= 0; --i) {
+    value = (value << 8) | bytes[i];
+  }
+
+  return value;
+}
+
+/**
+  Reads a little endian 4 byte value.
+
+  @param bytes The value.
+
+  @return The value.
+ */
+static inline uint32_t EWCResultColumnsReadUInt32(const uint8_t *bytes) {
+  return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+///---------------------
+/// @name Layout Methods
+///---------------------
+
+/**
+  Gets the size of each entry of a column.
+
+  @param column The column.
+
+  @return The size in bytes.
+ */
+size_t EWCResultColumnsWidth(EWCResultColumn column);
+
+/**
+  Gets where a column starts within a block.
+
+  @param column The column.
+  @param rowsPerBlock The rows per block of the file.
+
+  @return The offset from the start of the block.
+ */
+size_t EWCResultColumnsOffset(EWCResultColumn column, uint32_t rowsPerBlock);
+
+/**
+  Gets the size of each block.
+
+  @param rowsPerBlock The rows per block of the file.
+
+  @return The size in bytes.
+ */
+size_t EWCResultColumnsBlockSize(uint32_t rowsPerBlock);
+
+///-----------------------
+/// @name Encoding Methods
+///-----------------------
+
+/**
+  Writes a file header.
+
+  @param buffer Receives the header.  It must hold `EWCResultColumnsHeaderSize` bytes.
+  @param rowsPerBlock The rows per block, a multiple of `EWCResultColumnsRowAlignment`.
+
+  @return The number of bytes written.
+ */
+size_t EWCResultColumnsEncodeHeader(uint8_t *buffer, uint32_t rowsPerBlock);
+
+/**
+  Writes the values of a row into their places in each column of a block.
+
+  @param block The block.  It must hold `EWCResultColumnsBlockSize` bytes.
+  @param rowsPerBlock The rows per block of the file.
+  @param index The row's place in the block.
+  @param row The row to write.
+ */
+void EWCResultColumnsEncodeRow(uint8_t *block, uint32_t rowsPerBlock, uint32_t index, const EWCResultRow *row);
+
+/**
+  Writes the block header, once the rows of a block have been written.  The rows past the count must be zero.
+
+  @param block The block.
+  @param rowsPerBlock The rows per block of the file.
+  @param rowCount The number of rows in the block.
+ */
+void EWCResultColumnsSealBlock(uint8_t *block, uint32_t rowsPerBlock, uint32_t rowCount);
+
+/**
+  Writes a block index entry.
+
+  @param entry The entry to write.
+  @param buffer Receives the entry.  It must hold `EWCResultColumnsIndexEntrySize` bytes.
+
+  @return The number of bytes written.
+ */
+size_t EWCResultColumnsEncodeIndexEntry(const EWCResultColumnsIndexEntry *entry, uint8_t *buffer);
+
+/**
+  Writes the trailer that ends the footer.
+
+  @param blockCount The number of blocks.
+  @param index The encoded index entries, one for each block.
+  @param buffer Receives the trailer.  It must hold `EWCResultColumnsTrailerSize` bytes.
+
+  @return The number of bytes written.
+ */
+size_t EWCResultColumnsEncodeTrailer(uint32_t blockCount, const uint8_t *index, uint8_t *buffer);
+
+/**
+  Computes the checksum of a block or of the index.
+
+  @param bytes The bytes to check.
+  @param length The number of bytes.
+
+  @return The checksum.
+ */
+uint32_t EWCResultColumnsChecksum(const uint8_t *bytes, size_t length);
+
+///-----------------------
+/// @name Decoding Methods
+///-----------------------
+
+/**
+  Reads the rows per block from a file header.
+
+  @param bytes The start of the file.
+  @param length The length of the file.
+  @param rowsPerBlock Receives the rows per block.
+
+  @return YES if the header is valid.
+ */
+BOOL EWCResultColumnsDecodeHeader(const uint8_t *bytes, size_t length, uint32_t *rowsPerBlock);
+
+/**
+  Checks a block against its checksum.
+
+  @param block The block.
+  @param rowsPerBlock The rows per block of the file.
+
+  @return YES if the block is intact, and its row count fits.
+ */
+BOOL EWCResultColumnsBlockIsValid(const uint8_t *block, uint32_t rowsPerBlock);
+
+/**
+  Reads the number of rows in a block.
+
+  @param block The block.
+
+  @return The row count.
+ */
+uint32_t EWCResultColumnsBlockRowCount(const uint8_t *block);
+
+/**
+  Reads a row from a block.
+
+  @param block The block.
+  @param rowsPerBlock The rows per block of the file.
+  @param index The row's place in the block.
+  @param row Receives the row.
+ */
+void EWCResultColumnsDecodeRow(const uint8_t *block, uint32_t rowsPerBlock, uint32_t index, EWCResultRow *row);
+
+/**
+  Reads a column decimal.
+
+  @param bytes The column decimal.
+  @param value Receives the value.
+ */
+void EWCResultColumnsDecodeDecimal(const uint8_t *bytes, NSDecimal *value);
+
+/**
+  Reads a block index entry.
+
+  @param bytes The entry.
+  @param entry Receives the entry.
+ */
+void EWCResultColumnsDecodeIndexEntry(const uint8_t *bytes, EWCResultColumnsIndexEntry *entry);
+
+/**
+  Finds the footer at the end of a file.
+
+  @param bytes The file.
+  @param length The length of the file.
+  @param rowsPerBlock The rows per block of the file.
+  @param blockCount Receives the number of blocks.
+  @param index Receives the start of the index entries.
+
+  @return YES if the file ends with an intact footer that matches the blocks before it.
+ */
+BOOL EWCResultColumnsDecodeFooter(const uint8_t *bytes, size_t length, uint32_t rowsPerBlock,
+  uint32_t *blockCount, const uint8_t * _Nullable * _Nonnull index);
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,271 @@
+//
+//  EWCResultColumns.m
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCResultColumns.h"
+#import "EWCDecimalDigits.h"
+
+// the column decimal flags
+#define EWCResultColumnsNegativeFlag 0x01
+#define EWCResultColumnsNaNFlag 0x02
+
+static const uint8_t s_magic[4] = { 'E', 'W', 'C', 'R' };
+
+/**
+  Writes a little endian 8 byte value.
+
+  @param value The value.
+  @param bytes Receives the value.
+ */
+static void EWCResultColumnsWriteUInt64(uint64_t value, uint8_t *bytes) {
+  for (int i = 0; i < 8; ++i) {
+    bytes[i] = (uint8_t)(value >> (8 * i));
+  }
+}
+
+/**
+  Writes a little endian 4 byte value.
+
+  @param value The value.
+  @param bytes Receives the value.
+ */
+static void EWCResultColumnsWriteUInt32(uint32_t value, uint8_t *bytes) {
+  for (int i = 0; i < 4; ++i) {
+    bytes[i] = (uint8_t)(value >> (8 * i));
+  }
+}
+
+///---------------------
+/// @name Layout Methods
+///---------------------
+
+size_t EWCResultColumnsWidth(EWCResultColumn column) {
+  switch (column) {
+    case EWCResultSessionIDColumn: return 8;
+    case EWCResultKeyCountColumn: return 8;
+    case EWCResultDisplayColumn: return EWCResultColumnsDecimalSize;
+    case EWCResultMemoryColumn: return EWCResultColumnsDecimalSize;
+    case EWCResultErrorColumn: return 1;
+    case EWCResultStatusColumn: return 1;
+
+    default:
+      return 0;
+  }
+}
+
+size_t EWCResultColumnsOffset(EWCResultColumn column, uint32_t rowsPerBlock) {
+  size_t offset = EWCResultColumnsBlockHeaderSize;
+  for (EWCResultColumn c = 0; c < column; ++c) {
+    offset += EWCResultColumnsWidth(c) * rowsPerBlock;
+  }
+
+  return offset;
+}
+
+size_t EWCResultColumnsBlockSize(uint32_t rowsPerBlock) {
+  return EWCResultColumnsOffset(EWCResultColumnCount, rowsPerBlock);
+}
+
+///-----------------------
+/// @name Encoding Methods
+///-----------------------
+
+size_t EWCResultColumnsEncodeHeader(uint8_t *buffer, uint32_t rowsPerBlock) {
+  memset(buffer, 0, EWCResultColumnsHeaderSize);
+  memcpy(buffer, s_magic, sizeof(s_magic));
+  buffer[4] = EWCResultColumnsVersion;
+  buffer[5] = EWCResultColumnCount;
+  EWCResultColumnsWriteUInt32(rowsPerBlock, buffer + 8);
+
+  return EWCResultColumnsHeaderSize;
+}
+
+/**
+  Writes a column decimal.
+
+  @param value The value to write.
+  @param buffer Receives the decimal.  It must hold `EWCResultColumnsDecimalSize` bytes.
+ */
+static void EWCResultColumnsEncodeDecimal(const NSDecimal *value, uint8_t *buffer) {
+  memset(buffer, 0, EWCResultColumnsDecimalSize);
+
+  EWCDecimalMantissa mantissa;
+  short exponent;
+  BOOL negative;
+  if (! EWCDecimalGetMantissa(value, &mantissa, &exponent, &negative)) {
+    buffer[17] = EWCResultColumnsNaNFlag;
+    return;
+  }
+
+  for (int i = 0; i < 16; ++i) {
+    buffer[i] = (uint8_t)(mantissa >> (8 * i));
+  }
+  buffer[16] = (uint8_t)(int8_t)exponent;
+  buffer[17] = negative ? EWCResultColumnsNegativeFlag : 0;
+}
+
+void EWCResultColumnsEncodeRow(uint8_t *block, uint32_t rowsPerBlock, uint32_t index, const EWCResultRow *row) {
+  EWCResultColumnsWriteUInt64(row->sessionID,
+    block + EWCResultColumnsOffset(EWCResultSessionIDColumn, rowsPerBlock) + 8 * index);
+  EWCResultColumnsWriteUInt64(row->keyCount,
+    block + EWCResultColumnsOffset(EWCResultKeyCountColumn, rowsPerBlock) + 8 * index);
+  EWCResultColumnsEncodeDecimal(&row->display,
+    block + EWCResultColumnsOffset(EWCResultDisplayColumn, rowsPerBlock) + EWCResultColumnsDecimalSize * index);
+  EWCResultColumnsEncodeDecimal(&row->memory,
+    block + EWCResultColumnsOffset(EWCResultMemoryColumn, rowsPerBlock) + EWCResultColumnsDecimalSize * index);
+  block[EWCResultColumnsOffset(EWCResultErrorColumn, rowsPerBlock) + index] = row->error ? 1 : 0;
+  block[EWCResultColumnsOffset(EWCResultStatusColumn, rowsPerBlock) + index] = row->status;
+}
+
+void EWCResultColumnsSealBlock(uint8_t *block, uint32_t rowsPerBlock, uint32_t rowCount) {
+  EWCResultColumnsWriteUInt32(rowCount, block + 4);
+
+  // the checksum covers everything after itself, the row count included
+  size_t size = EWCResultColumnsBlockSize(rowsPerBlock);
+  EWCResultColumnsWriteUInt32(EWCResultColumnsChecksum(block + 4, size - 4), block);
+}
+
+size_t EWCResultColumnsEncodeIndexEntry(const EWCResultColumnsIndexEntry *entry, uint8_t *buffer) {
+  EWCResultColumnsWriteUInt64(entry->minimumSessionID, buffer);
+  EWCResultColumnsWriteUInt64(entry->maximumSessionID, buffer + 8);
+  EWCResultColumnsWriteUInt32(entry->rowCount, buffer + 16);
+  EWCResultColumnsWriteUInt32(entry->errorCount, buffer + 20);
+
+  return EWCResultColumnsIndexEntrySize;
+}
+
+size_t EWCResultColumnsEncodeTrailer(uint32_t blockCount, const uint8_t *index, uint8_t *buffer) {
+  EWCResultColumnsWriteUInt32(blockCount, buffer);
+  EWCResultColumnsWriteUInt32(EWCResultColumnsChecksum(index, (size_t)blockCount * EWCResultColumnsIndexEntrySize),
+    buffer + 4);
+  memcpy(buffer + 8, s_magic, sizeof(s_magic));
+
+  return EWCResultColumnsTrailerSize;
+}
+
+uint32_t EWCResultColumnsChecksum(const uint8_t *bytes, size_t length) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < length; ++i) {
+    hash ^= bytes[i];
+    hash *= 16777619u;
+  }
+
+  return hash;
+}
+
+///-----------------------
+/// @name Decoding Methods
+///-----------------------
+
+BOOL EWCResultColumnsDecodeHeader(const uint8_t *bytes, size_t length, uint32_t *rowsPerBlock) {
+  if (length < EWCResultColumnsHeaderSize
+    || memcmp(bytes, s_magic, sizeof(s_magic)) != 0
+    || bytes[4] != EWCResultColumnsVersion
+    || bytes[5] != EWCResultColumnCount) {
+    return NO;
+  }
+
+  uint32_t rows = EWCResultColumnsReadUInt32(bytes + 8);
+  if (rows == 0 || rows % EWCResultColumnsRowAlignment != 0) {
+    return NO;
+  }
+
+  *rowsPerBlock = rows;
+
+  return YES;
+}
+
+BOOL EWCResultColumnsBlockIsValid(const uint8_t *block, uint32_t rowsPerBlock) {
+  size_t size = EWCResultColumnsBlockSize(rowsPerBlock);
+
+  return EWCResultColumnsReadUInt32(block) == EWCResultColumnsChecksum(block + 4, size - 4)
+    && EWCResultColumnsBlockRowCount(block) <= rowsPerBlock;
+}
+
+uint32_t EWCResultColumnsBlockRowCount(const uint8_t *block) {
+  return EWCResultColumnsReadUInt32(block + 4);
+}
+
+void EWCResultColumnsDecodeDecimal(const uint8_t *bytes, NSDecimal *value) {
+  if (bytes[17] & EWCResultColumnsNaNFlag) {
+    *value = [NSDecimalNumber notANumber].decimalValue;
+    return;
+  }
+
+  EWCDecimalMantissa mantissa = 0;
+  for (int i = 15; i >= 0; --i) {
+    mantissa = (mantissa << 8) | bytes[i];
+  }
+
+  EWCDecimalFromMantissa(mantissa, (int8_t)bytes[16], (bytes[17] & EWCResultColumnsNegativeFlag) != 0, value);
+}
+
+void EWCResultColumnsDecodeRow(const uint8_t *block, uint32_t rowsPerBlock, uint32_t index, EWCResultRow *row) {
+  row->sessionID = EWCResultColumnsReadUInt64(
+    block + EWCResultColumnsOffset(EWCResultSessionIDColumn, rowsPerBlock) + 8 * index);
+  row->keyCount = EWCResultColumnsReadUInt64(
+    block + EWCResultColumnsOffset(EWCResultKeyCountColumn, rowsPerBlock) + 8 * index);
+  EWCResultColumnsDecodeDecimal(
+    block + EWCResultColumnsOffset(EWCResultDisplayColumn, rowsPerBlock) + EWCResultColumnsDecimalSize * index,
+    &row->display);
+  EWCResultColumnsDecodeDecimal(
+    block + EWCResultColumnsOffset(EWCResultMemoryColumn, rowsPerBlock) + EWCResultColumnsDecimalSize * index,
+    &row->memory);
+  row->error = block[EWCResultColumnsOffset(EWCResultErrorColumn, rowsPerBlock) + index] != 0;
+  row->status = block[EWCResultColumnsOffset(EWCResultStatusColumn, rowsPerBlock) + index];
+}
+
+void EWCResultColumnsDecodeIndexEntry(const uint8_t *bytes, EWCResultColumnsIndexEntry *entry) {
+  entry->minimumSessionID = EWCResultColumnsReadUInt64(bytes);
+  entry->maximumSessionID = EWCResultColumnsReadUInt64(bytes + 8);
+  entry->rowCount = EWCResultColumnsReadUInt32(bytes + 16);
+  entry->errorCount = EWCResultColumnsReadUInt32(bytes + 20);
+}
+
+BOOL EWCResultColumnsDecodeFooter(const uint8_t *bytes, size_t length, uint32_t rowsPerBlock,
+  uint32_t *blockCount, const uint8_t **index) {
+
+  if (length < EWCResultColumnsHeaderSize + EWCResultColumnsTrailerSize) {
+    return NO;
+  }
+
+  const uint8_t *trailer = bytes + length - EWCResultColumnsTrailerSize;
+  if (memcmp(trailer + 8, s_magic, sizeof(s_magic)) != 0) {
+    return NO;
+  }
+
+  // the footer must start right after the last block
+  uint64_t count = EWCResultColumnsReadUInt32(trailer);
+  uint64_t footerStart = EWCResultColumnsHeaderSize + count * EWCResultColumnsBlockSize(rowsPerBlock);
+  if (footerStart + count * EWCResultColumnsIndexEntrySize + EWCResultColumnsTrailerSize != length) {
+    return NO;
+  }
+
+  const uint8_t *entries = bytes + footerStart;
+  if (EWCResultColumnsReadUInt32(trailer + 4)
+    != EWCResultColumnsChecksum(entries, (size_t)count * EWCResultColumnsIndexEntrySize)) {
+    return NO;
+  }
+
+  *blockCount = (uint32_t)count;
+  *index = entries;
+
+  return YES;
+}
@@ -0,0 +1,299 @@
+//
+//  EWCSpellOut.c
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "EWCSpellOut.h"
+
+#include <string.h>
+
+// the most digits spelled out in the whole part (below a quintillion)
+#define EWCSpellOutMaxWholeDigits 18
+
+// the most digits a value can have once rounded and padded
+#define EWCSpellOutMaxDigits 160
+
+static const EWCSpellOutLanguage s_english = {
+  .code = "en",
+  .ones = {
+    "zero", "one", "two", "three", "four", "five", "six", "seven", "eight", "nine",
+    "ten", "eleven", "twelve", "thirteen", "fourteen", "fifteen", "sixteen",
+    "seventeen", "eighteen", "nineteen",
+  },
+  .tens = {
+    NULL, NULL, "twenty", "thirty", "forty", "fifty", "sixty", "seventy", "eighty", "ninety",
+  },
+  .hundred = "hundred",
+  .scales = { "thousand", "million", "billion", "trillion", "quadrillion" },
+  .negative = "minus",
+  .point = "point",
+  .tensSeparator = '-',
+};
+
+// the natively spelled languages, which are those the app is localized for
+static const EWCSpellOutLanguage * const s_languages[] = {
+  &s_english,
+};
+
+const EWCSpellOutLanguage *EWCSpellOutLanguageForCode(const char *code) {
+  for (size_t i = 0; i < sizeof(s_languages) / sizeof(s_languages[0]); ++i) {
+    if (strcmp(s_languages[i]->code, code) == 0) {
+      return s_languages[i];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  `EWCSpellOutWriter` appends words to a buffer, tracking whether they fit.
+ */
+typedef struct {
+  char *buffer;  // the buffer
+  size_t capacity;  // the size of the buffer
+  size_t length;  // the bytes written
+  bool overflowed;  // whether something didn't fit
+} EWCSpellOutWriter;
+
+/**
+  Appends text to the buffer.
+
+  @param writer The writer.
+  @param text The text.
+  @param length The length of the text.
+ */
+static void EWCSpellOutAppend(EWCSpellOutWriter *writer, const char *text, size_t length) {
+  // always leave room for the terminator
+  if (writer->overflowed || writer->length + length >= writer->capacity) {
+    writer->overflowed = true;
+    return;
+  }
+
+  memcpy(writer->buffer + writer->length, text, length);
+  writer->length += length;
+}
+
+/**
+  Appends a word, separated by a space from anything before it.
+
+  @param writer The writer.
+  @param word The word.
+ */
+static void EWCSpellOutAppendWord(EWCSpellOutWriter *writer, const char *word) {
+  if (writer->length > 0) {
+    EWCSpellOutAppend(writer, " ", 1);
+  }
+  EWCSpellOutAppend(writer, word, strlen(word));
+}
+
+/**
+  Appends the words of a number below a thousand.
+
+  @param writer The writer.
+  @param language The language.
+  @param value The number, from 1 to 999.
+ */
+static void EWCSpellOutAppendHundreds(EWCSpellOutWriter *writer,
+  const EWCSpellOutLanguage *language, unsigned value) {
+
+  if (value >= 100) {
+    EWCSpellOutAppendWord(writer, language->ones[value / 100]);
+    EWCSpellOutAppendWord(writer, language->hundred);
+    value %= 100;
+  }
+
+  if (value >= 20) {
+    EWCSpellOutAppendWord(writer, language->tens[value / 10]);
+    if (value % 10) {
+      EWCSpellOutAppend(writer, &language->tensSeparator, 1);
+      const char *ones = language->ones[value % 10];
+      EWCSpellOutAppend(writer, ones, strlen(ones));
+    }
+  } else if (value > 0) {
+    EWCSpellOutAppendWord(writer, language->ones[value]);
+  }
+}
+
+/**
+  Rounds away the least significant digits of a value, half-even, as `NSNumberFormatter` does by default.
+
+  @param digits The digits, most significant first, rounded in place.
+  @param count The number of digits, updated to the count kept (at least one).
+  @param exponent The power of ten of the final digit, updated for the digits dropped.
+  @param drop The number of digits to drop.
+ */
+static void EWCSpellOutRoundHalfEven(uint8_t *digits, int *count, int *exponent, int drop) {
+  int keep = *count - drop;
+  if (keep < 0) {
+    // every digit, and some implied leading zeros, are dropped
+    digits[0] = 0;
+    *count = 1;
+    *exponent += drop;
+    return;
+  }
+
+  uint8_t first = (keep < *count) ? digits[keep] : 0;
+  bool rest = false;
+  for (int i = keep + 1; i < *count; ++i) {
+    rest = rest || digits[i] != 0;
+  }
+  bool previousOdd = (keep > 0) && (digits[keep - 1] & 1);
+  bool roundUp = (first > 5 || (first == 5 && (rest || previousOdd)));
+
+  *count = keep;
+  *exponent += drop;
+
+  if (roundUp) {
+    int i = keep - 1;
+    while (i >= 0 && digits[i] == 9) {
+      digits[i--] = 0;
+    }
+
+    if (i >= 0) {
+      ++digits[i];
+    } else {
+      // carried out of the top, so the value gains a leading one
+      memmove(digits + 1, digits, (size_t)keep);
+      digits[0] = 1;
+      ++*count;
+    }
+  }
+
+  if (*count == 0) {
+    digits[0] = 0;
+    *count = 1;
+  }
+}
+
+size_t EWCSpellOutRender(const EWCSpellOutRules *rules,
+  const uint8_t *digits, int count, int exponent, bool negative,
+  int maximumFractionDigits, int minimumFractionDigits,
+  char *buffer, size_t capacity) {
+
+  const EWCSpellOutLanguage *language = rules->language;
+  if (! language || count < 1 || count > EWCSpellOutMaxDigits / 2 || capacity < 1) {
+    return 0;
+  }
+
+  // work on a copy, which rounding may grow by a digit
+  uint8_t value[EWCSpellOutMaxDigits];
+  memcpy(value, digits, (size_t)count);
+
+  if (rules->roundsFraction && maximumFractionDigits >= 0 && -exponent > maximumFractionDigits) {
+    EWCSpellOutRoundHalfEven(value, &count, &exponent, -exponent - maximumFractionDigits);
+  }
+
+  // the fractional digits are spelled without trailing zeros, unless they are
+  // padded up to the minimum
+  while (count > 1 && exponent < 0 && value[count - 1] == 0) {
+    --count;
+    ++exponent;
+  }
+  if (count == 1 && value[0] == 0) {
+    exponent = 0;
+  }
+
+  int fractionCount = (exponent < 0) ? -exponent : 0;
+  int paddedCount = fractionCount;
+  if (rules->padsFraction && minimumFractionDigits > paddedCount) {
+    paddedCount = minimumFractionDigits;
+  }
+
+  // split into the whole part and the fraction.  with a positive exponent the
+  // whole part has implied trailing zeros, and with a long fraction it has none
+  int wholeCount = count - fractionCount;
+  int wholeDigits = wholeCount + (exponent > 0 ? exponent : 0);
+  if (wholeDigits > EWCSpellOutMaxWholeDigits) {
+    return 0;
+  }
+
+  uint64_t whole = 0;
+  for (int i = 0; i < wholeCount; ++i) {
+    whole = whole * 10 + value[i];
+  }
+  for (int i = 0; i < exponent; ++i) {
+    whole *= 10;
+  }
+
+  bool zero = (whole == 0);
+  for (int i = (wholeCount > 0 ? wholeCount : 0); i < count && zero; ++i) {
+    zero = (value[i] == 0);
+  }
+  if (zero && negative) {
+    // a value that rounds to zero is left to the formatter, as for the display
+    return 0;
+  }
+
+  EWCSpellOutWriter writer = { buffer, capacity, 0, false };
+
+  if (negative) {
+    EWCSpellOutAppendWord(&writer, language->negative);
+  }
+
+  if (whole == 0) {
+    EWCSpellOutAppendWord(&writer, language->ones[0]);
+  } else {
+    // collect the groups of three digits, least significant first
+    unsigned groups[EWCSpellOutScaleCount + 1];
+    int groupCount = 0;
+    while (whole > 0) {
+      groups[groupCount++] = (unsigned)(whole % 1000);
+      whole /= 1000;
+    }
+
+    for (int g = groupCount - 1; g >= 0; --g) {
+      if (groups[g] == 0) {
+        continue;
+      }
+
+      EWCSpellOutAppendHundreds(&writer, language, groups[g]);
+      if (g > 0) {
+        EWCSpellOutAppendWord(&writer, language->scales[g - 1]);
+      }
+    }
+  }
+
+  if (paddedCount > 0) {
+    EWCSpellOutAppendWord(&writer, language->point);
+
+    // the fractional digits that are present, then the padding zeros
+    int firstFraction = count - fractionCount;
+    for (int i = 0; i < paddedCount; ++i) {
+      int index = firstFraction + i;
+      uint8_t digit;
+      if (i >= fractionCount) {
+        digit = 0;
+      } else if (index < 0) {
+        // a leading zero implied by the exponent
+        digit = 0;
+      } else {
+        digit = value[index];
+      }
+      EWCSpellOutAppendWord(&writer, language->ones[digit]);
+    }
+  }
+
+  if (writer.overflowed) {
+    return 0;
+  }
+
+  buffer[writer.length] = '\0';
+
+  return writer.length;
+}
@@ -0,0 +1,90 @@
+//
+//  EWCSpellOut.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef EWCSpellOut_h
+#define EWCSpellOut_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// the number of powers of a thousand (thousand, million, ...) a language names
+#define EWCSpellOutScaleCount 5
+
+// the size of buffer (in bytes) that is always large enough to hold a spelled
+// out display value, including the terminator
+#define EWCSpellOutBufferSize 1024
+
+/**
+  `EWCSpellOutLanguage` holds the words a language spells numbers with, for languages that build numbers the way English does: a word for each number below twenty, one for each multiple of ten, hundreds, and named powers of a thousand, with the fractional digits read out one at a time.
+ */
+typedef struct {
+  const char *code;  // the ISO 639 language code
+  const char *ones[20];  // the numbers below twenty
+  const char *tens[10];  // the multiples of ten, from twenty (the first two are unused)
+  const char *hundred;  // follows the count of hundreds
+  const char *scales[EWCSpellOutScaleCount];  // follow the count of each power of a thousand
+  const char *negative;  // precedes a negative number
+  const char *point;  // separates the whole and fractional parts
+  char tensSeparator;  // joins a multiple of ten to the following digit
+} EWCSpellOutLanguage;
+
+/**
+  `EWCSpellOutRules` describes how a locale spells out numbers, as captured from its `NSNumberFormatter`.
+ */
+typedef struct {
+  const EWCSpellOutLanguage *language;  // the words of the locale's language
+  bool padsFraction;  // whether the minimum fractional digits are spelled out as trailing zeros
+  bool roundsFraction;  // whether fractional digits beyond the maximum are rounded away
+} EWCSpellOutRules;
+
+/**
+  Gets the words of a language, if it is one that can be spelled out natively.
+
+  @param code The ISO 639 language code.
+
+  @return The language, or NULL if it isn't supported.
+ */
+const EWCSpellOutLanguage *EWCSpellOutLanguageForCode(const char *code);
+
+/**
+  Spells out a decimal value.
+
+  The value is (-1)^negative × digits × 10^exponent.
+
+  @param rules The rules of the locale.
+  @param digits The mantissa digits, most significant first.
+  @param count The number of digits.
+  @param exponent The power of ten of the final digit.
+  @param negative Whether the value is negative.
+  @param maximumFractionDigits The most fractional digits to spell out.
+  @param minimumFractionDigits The fewest fractional digits to spell out.
+  @param buffer Receives the words as UTF-8, terminated.
+  @param capacity The size of the buffer.  `EWCSpellOutBufferSize` is always sufficient.
+
+  @return The number of bytes written, not counting the terminator, or 0 if the value can't be spelled out natively (it has a whole part of a quintillion or more, rounds to a negative zero, or doesn't fit).
+ */
+size_t EWCSpellOutRender(const EWCSpellOutRules *rules,
+  const uint8_t *digits, int count, int exponent, bool negative,
+  int maximumFractionDigits, int minimumFractionDigits,
+  char *buffer, size_t capacity);
+
+#endif /* EWCSpellOut_h */
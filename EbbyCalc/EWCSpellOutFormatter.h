@@ -0,0 +1,132 @@
+//
+//  EWCSpellOutFormatter.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import "EWCLocaleDescriptor.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  The number of spelled out values an `EWCSpellOutFormatter` remembers.
+ */
+#define EWCSpellOutFormatterCacheSize 64
+
+/**
+  Spells out a value under a locale's spell out rules, as `EWCSpellOutFormatter` does, into a caller supplied buffer.
+
+  @param rules The rules of the locale.
+  @param value The value to spell out.
+  @param maximumFractionDigits The maximum number of fractional digits to spell out.
+  @param minimumFractionDigits The minimum number of fractional digits to spell out.
+  @param buffer The buffer to receive the words as UTF-8.  It is terminated.
+  @param capacity The size of the buffer.  `EWCSpellOutBufferSize` is always sufficient.
+
+  @return The number of bytes written (not counting the terminator), or 0 if the value can't be spelled out directly.
+ */
+NSUInteger EWCSpellOutRenderDecimal(const EWCSpellOutRules *rules,
+  NSDecimal value,
+  NSInteger maximumFractionDigits,
+  NSInteger minimumFractionDigits,
+  char *buffer,
+  NSUInteger capacity);
+
+/**
+  `EWCSpellOutFormatter` spells out calculator display values for the accessibility label directly from their decimal digits.
+
+  It spells with the spell out rules of an interned `EWCLocaleDescriptor`, which were checked against the spell out style `NSNumberFormatter` the calculator has always used, so that its output is identical to that formatter's.  Locales whose language has no native word tables (only the languages the app is localized for have them), and values it can't spell directly (NaN, or a whole part of a quintillion or more), fall back to that formatter, which is only created when first needed.
+
+  The most recently spelled values are remembered, since the accessibility label is read again whenever the display is announced, and a value is often shown more than once (as when a result becomes the first operand of the next calculation).
+ */
+@interface EWCSpellOutFormatter : NSObject
+
+/**
+  The locale whose words are used.
+ */
+@property (nonatomic, readonly) NSLocale *locale;
+
+/**
+  The descriptor of the locale.
+ */
+@property (nonatomic, readonly) EWCLocaleDescriptor *descriptor;
+
+/**
+  The maximum number of fractional digits to spell out.
+ */
+@property (nonatomic, readonly) NSInteger maximumFractionDigits;
+
+/**
+  Creates a new spell out formatter.
+
+  @param locale The locale whose words to use.
+  @param maximumFractionDigits The maximum number of fractional digits to spell out.
+
+  @return The new formatter instance.
+ */
++ (instancetype)formatterWithLocale:(NSLocale *)locale
+  maximumFractionDigits:(NSInteger)maximumFractionDigits;
+
+/**
+  Creates a new spell out formatter for a locale descriptor.
+
+  @param descriptor The descriptor of the locale whose words to use.
+  @param maximumFractionDigits The maximum number of fractional digits to spell out.
+
+  @return The new formatter instance.
+ */
++ (instancetype)formatterWithDescriptor:(EWCLocaleDescriptor *)descriptor
+  maximumFractionDigits:(NSInteger)maximumFractionDigits;
+
+/**
+  Initializes a spell out formatter with the interned descriptor of a locale.
+
+  @param locale The locale whose words to use.
+  @param maximumFractionDigits The maximum number of fractional digits to spell out.
+
+  @return The initialized instance.
+ */
+- (instancetype)initWithLocale:(NSLocale *)locale
+  maximumFractionDigits:(NSInteger)maximumFractionDigits;
+
+/**
+  Initializes a spell out formatter.
+
+  @param descriptor The descriptor of the locale whose words to use.
+  @param maximumFractionDigits The maximum number of fractional digits to spell out.
+
+  @return The initialized instance.
+ */
+- (instancetype)initWithDescriptor:(EWCLocaleDescriptor *)descriptor
+  maximumFractionDigits:(NSInteger)maximumFractionDigits;
+
+/**
+  Spells out a value.
+
+  @param value The value to spell out.
+  @param minimumFractionDigits The minimum number of fractional digits to spell out, so that trailing zeros being input are not hidden.
+
+  @return The spelled out value.
+ */
+- (NSString *)stringFromDecimal:(NSDecimal)value
+  minimumFractionDigits:(NSInteger)minimumFractionDigits;
+
+@end
+
+NS_ASSUME_NONNULL_END
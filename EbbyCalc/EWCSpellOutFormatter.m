@@ -0,0 +1,258 @@
+//
+//  EWCSpellOutFormatter.m
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCSpellOutFormatter.h"
+#import "EWCDecimalDigits.h"
+
+/**
+  `EWCSpellOutCacheKey` identifies a spelled out value by its digits and the fractional digits it was spelled with.
+ */
+typedef struct {
+  EWCDecimalDigits digits;  // the value
+  NSInteger minimumFractionDigits;  // the forced fractional digits
+  BOOL valid;  // whether the entry holds a value
+} EWCSpellOutCacheKey;
+
+/**
+  Spells out expanded digits under the rules.
+
+  @param rules The rules of the locale.
+  @param digits The digits of the value.
+  @param maximumFractionDigits The maximum number of fractional digits to spell out.
+  @param minimumFractionDigits The minimum number of fractional digits to spell out.
+  @param buffer The buffer to receive the words.
+  @param capacity The size of the buffer.
+
+  @return The number of bytes written, or 0 if they can't be spelled out directly.
+ */
+static NSUInteger renderDigits(const EWCSpellOutRules *rules,
+  const EWCDecimalDigits *digits,
+  NSInteger maximumFractionDigits,
+  NSInteger minimumFractionDigits,
+  char *buffer,
+  NSUInteger capacity) {
+
+  return EWCSpellOutRender(rules, digits->digits, digits->count, digits->exponent, digits->negative,
+    (int)maximumFractionDigits, (int)minimumFractionDigits,
+    buffer, capacity);
+}
+
+/**
+  Picks the cache slot of a value.
+
+  @param key The value and its forced fractional digits.
+
+  @return The slot index.
+ */
+static NSUInteger cacheSlot(const EWCSpellOutCacheKey *key) {
+  // FNV-1a over the digits and the rest of the key
+  uint32_t hash = 2166136261u;
+  for (short i = 0; i < key->digits.count; ++i) {
+    hash = (hash ^ key->digits.digits[i]) * 16777619u;
+  }
+  hash = (hash ^ (uint16_t)key->digits.exponent) * 16777619u;
+  hash = (hash ^ (uint32_t)key->digits.negative) * 16777619u;
+  hash = (hash ^ (uint32_t)key->minimumFractionDigits) * 16777619u;
+
+  return hash % EWCSpellOutFormatterCacheSize;
+}
+
+/**
+  Compares two cache keys.
+
+  @param a The first key.
+  @param b The second key.
+
+  @return YES if they identify the same value spelled the same way.
+ */
+static BOOL cacheKeysEqual(const EWCSpellOutCacheKey *a, const EWCSpellOutCacheKey *b) {
+  return a->valid && b->valid
+    && a->minimumFractionDigits == b->minimumFractionDigits
+    && a->digits.count == b->digits.count
+    && a->digits.exponent == b->digits.exponent
+    && a->digits.negative == b->digits.negative
+    && memcmp(a->digits.digits, b->digits.digits, (size_t)a->digits.count) == 0;
+}
+
+NSUInteger EWCSpellOutRenderDecimal(const EWCSpellOutRules *rules,
+  NSDecimal value,
+  NSInteger maximumFractionDigits,
+  NSInteger minimumFractionDigits,
+  char *buffer,
+  NSUInteger capacity) {
+
+  EWCDecimalDigits digits;
+  if (! EWCDecimalDigitsFromDecimal(&value, &digits)) {
+    // NaN
+    return 0;
+  }
+
+  return renderDigits(rules, &digits, maximumFractionDigits, minimumFractionDigits, buffer, capacity);
+}
+
+@interface EWCSpellOutFormatter () {
+  NSNumberFormatter *_formatter;  // the fallback formatter, created on first use
+  char _buffer[EWCSpellOutBufferSize];  // reused output buffer
+  EWCSpellOutCacheKey _cacheKeys[EWCSpellOutFormatterCacheSize];  // the values remembered in each slot
+  NSMutableArray<NSString *> *_cacheStrings;  // the spelled out value in each slot
+}
+
+@end
+
+@implementation EWCSpellOutFormatter
+
+///----------------------------------------------
+/// @name Construction and Initialization Methods
+///----------------------------------------------
+
++ (instancetype)formatterWithLocale:(NSLocale *)locale
+  maximumFractionDigits:(NSInteger)maximumFractionDigits {
+  return [[EWCSpellOutFormatter alloc] initWithLocale:locale
+    maximumFractionDigits:maximumFractionDigits];
+}
+
++ (instancetype)formatterWithDescriptor:(EWCLocaleDescriptor *)descriptor
+  maximumFractionDigits:(NSInteger)maximumFractionDigits {
+  return [[EWCSpellOutFormatter alloc] initWithDescriptor:descriptor
+    maximumFractionDigits:maximumFractionDigits];
+}
+
+- (instancetype)initWithLocale:(NSLocale *)locale
+  maximumFractionDigits:(NSInteger)maximumFractionDigits {
+  return [self initWithDescriptor:[EWCLocaleDescriptor descriptorForLocale:locale]
+    maximumFractionDigits:maximumFractionDigits];
+}
+
+- (instancetype)initWithDescriptor:(EWCLocaleDescriptor *)descriptor
+  maximumFractionDigits:(NSInteger)maximumFractionDigits {
+  self = [super init];
+  if (self) {
+    _descriptor = descriptor;
+    _maximumFractionDigits = maximumFractionDigits;
+
+    _cacheStrings = [NSMutableArray arrayWithCapacity:EWCSpellOutFormatterCacheSize];
+    for (int i = 0; i < EWCSpellOutFormatterCacheSize; ++i) {
+      [_cacheStrings addObject:@""];
+    }
+  }
+
+  return self;
+}
+
+///------------------------------
+/// @name Custom Property Methods
+///------------------------------
+
+- (NSLocale *)locale {
+  return _descriptor.locale;
+}
+
+///---------------------------------------------------------------
+/// @name Public Properties and Methods (documented in the header)
+///---------------------------------------------------------------
+
+- (NSString *)stringFromDecimal:(NSDecimal)value
+  minimumFractionDigits:(NSInteger)minimumFractionDigits {
+
+  EWCSpellOutCacheKey key;
+  if (! EWCDecimalDigitsFromDecimal(&value, &key.digits)) {
+    // NaN is rare enough not to remember
+    return [self formattedStringFromDecimal:value
+      minimumFractionDigits:minimumFractionDigits];
+  }
+
+  key.minimumFractionDigits = minimumFractionDigits;
+  key.valid = YES;
+
+  NSUInteger slot = cacheSlot(&key);
+  if (cacheKeysEqual(&key, &_cacheKeys[slot])) {
+    return _cacheStrings[slot];
+  }
+
+  NSString *spelled = [self directStringFromDigits:&key.digits
+    minimumFractionDigits:minimumFractionDigits];
+
+  if (! spelled) {
+    spelled = [self formattedStringFromDecimal:value
+      minimumFractionDigits:minimumFractionDigits];
+  }
+
+  _cacheKeys[slot] = key;
+  _cacheStrings[slot] = spelled;
+
+  return spelled;
+}
+
+///--------------------------------
+/// @name Internal Rendering Methods
+///--------------------------------
+
+/**
+  Spells out a value into the reused buffer.
+
+  @param digits The digits of the value.
+  @param minimumFractionDigits The minimum number of fractional digits to spell out.
+
+  @return The spelled out string, or nil if the value couldn't be spelled out directly.
+ */
+- (nullable NSString *)directStringFromDigits:(const EWCDecimalDigits *)digits
+  minimumFractionDigits:(NSInteger)minimumFractionDigits {
+
+  const EWCSpellOutRules *rules = _descriptor.spellOutRules;
+  if (! rules) { return nil; }
+
+  NSUInteger length = renderDigits(rules, digits,
+    _maximumFractionDigits, minimumFractionDigits,
+    _buffer, EWCSpellOutBufferSize);
+
+  if (length == 0) {
+    return nil;
+  }
+
+  return [[NSString alloc] initWithBytes:_buffer length:length encoding:NSUTF8StringEncoding];
+}
+
+/**
+  Spells out a value using the reference `NSNumberFormatter`.
+
+  @param value The value to spell out.
+  @param minimumFractionDigits The minimum number of fractional digits to spell out.
+
+  @return The spelled out string.
+ */
+- (NSString *)formattedStringFromDecimal:(NSDecimal)value
+  minimumFractionDigits:(NSInteger)minimumFractionDigits {
+
+  if (! _formatter) {
+    // this is the same configuration the calculator has always used for the
+    // accessibility label
+    _formatter = [NSNumberFormatter new];
+    _formatter.maximumFractionDigits = _maximumFractionDigits;
+    _formatter.locale = _descriptor.locale;
+    [_formatter setNumberStyle:NSNumberFormatterSpellOutStyle];
+  }
+
+  _formatter.minimumFractionDigits = minimumFractionDigits;
+
+  return [_formatter stringFromNumber:[NSDecimalNumber decimalNumberWithDecimal:value]] ?: @"";
+}
+
+@end
@@ -0,0 +1,123 @@
+//
+//  EWCTapeBatchEvaluator.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import "EWCCalculatorKey.h"
+#import "EWCTapeProgram.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCTapeBatchEvaluator` gets the results of a batch of key tapes, pressing each key that tapes have in common only once.
+
+  Audit batches hold many tapes that are identical, or that share their opening keys (a tax rate stored with `Rate` and `Tax+`, then the same first items).  The evaluator hashes each whole tape so that duplicates are evaluated once, then builds a trie over the keys of the remaining tapes, so that each shared prefix becomes a single path.  Walking the trie presses each of its keys once on one calculator, saving the calculator's state wherever the path branches, and restoring it before following each later branch.  A tape's results are read when the walk reaches the node its last key leads to.
+
+  Every tape starts from a calculator that was just reset, holding the starting tax rate and memory, so the results are those of pressing each tape's keys on a calculator of its own.  The results are marked as replayed, since they come from pressing keys rather than from compiled instructions.
+
+  An evaluator reuses a calculator and its buffers between batches, so it must not be used from more than one thread at a time.
+ */
+@interface EWCTapeBatchEvaluator : NSObject
+
+/**
+  The maximum digits of the calculator the tapes are evaluated on.
+ */
+@property (nonatomic, readonly) NSInteger maximumDigits;
+
+/**
+  The tax rate the calculator holds when each tape starts.  Defaults to 0.
+ */
+@property (nonatomic) NSDecimalNumber *startingTaxRate;
+
+/**
+  The memory value the calculator holds when each tape starts.  Defaults to 0.
+ */
+@property (nonatomic) NSDecimalNumber *startingMemory;
+
+/**
+  The number of tapes in the last batch.
+ */
+@property (nonatomic, readonly) NSUInteger tapeCount;
+
+/**
+  The number of different tapes in the last batch, after duplicates were removed.
+ */
+@property (nonatomic, readonly) NSUInteger uniqueTapeCount;
+
+/**
+  The number of keys on all of the tapes of the last batch, which is how many evaluating each tape on its own would press.
+ */
+@property (nonatomic, readonly) NSUInteger keyCount;
+
+/**
+  The number of keys the last batch pressed, one for each node of its trie.
+ */
+@property (nonatomic, readonly) NSUInteger pressedKeyCount;
+
+/**
+  The number of places in the trie of the last batch where tapes went different ways, each of which saved the calculator's state.
+ */
+@property (nonatomic, readonly) NSUInteger branchCount;
+
+/**
+  Creates a new evaluator.
+
+  @param maximumDigits The maximum digits of the calculator to evaluate on.
+
+  @return The new evaluator.
+ */
++ (instancetype)evaluatorWithMaximumDigits:(NSInteger)maximumDigits;
+
+/**
+  Initializes an evaluator.
+
+  @param maximumDigits The maximum digits of the calculator to evaluate on.
+
+  @return The initialized instance.
+ */
+- (instancetype)initWithMaximumDigits:(NSInteger)maximumDigits;
+
+/**
+  Evaluates a batch of tapes, sharing the keys they have in common.
+
+  @param tapes The keys of each tape, `count` of them.
+  @param counts The number of keys on each tape, `count` of them.
+  @param count The number of tapes.
+  @param results Receives the results of each tape, `count` of them.
+ */
+- (void)evaluateTapes:(const EWCCalculatorKey * _Nonnull const * _Nonnull)tapes
+  counts:(const NSUInteger *)counts
+  count:(NSUInteger)count
+  results:(EWCTapeResult *)results;
+
+/**
+  Evaluates one tape by pressing its keys on a calculator that was just reset, sharing nothing with other tapes.  This is the baseline a batch is measured against.
+
+  @param keys The keys of the tape.
+  @param count The number of keys.
+  @param result Receives the results.
+ */
+- (void)evaluateKeys:(const EWCCalculatorKey *)keys
+  count:(NSUInteger)count
+  result:(EWCTapeResult *)result;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,362 @@
+//
+//  EWCTapeBatchEvaluator.m
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCTapeBatchEvaluator.h"
+#import "EWCCalculator.h"
+#import "EWCCalculatorMemoryData.h"
+#import "EWCCalculatorState.h"
+
+/**
+  Marks the absence of a node, for a node with no children or no later sibling.
+ */
+#define EWCTapeBatchNoNode NSUIntegerMax
+
+/**
+  Marks a node that no tape ends at.
+ */
+#define EWCTapeBatchNoTape NSUIntegerMax
+
+/**
+  `EWCTapeBatchNode` is a node of the trie over the tapes of a batch, standing for the keys on the path from the root to it.
+ */
+typedef struct {
+  NSUInteger firstChild;  // the first node one key further on, or EWCTapeBatchNoNode
+  NSUInteger nextSibling;  // the next node with the same parent, or EWCTapeBatchNoNode
+  NSUInteger tape;  // the tape whose keys end at the node, or EWCTapeBatchNoTape
+  EWCCalculatorKey key;  // the key pressed to reach the node from its parent
+} EWCTapeBatchNode;
+
+/**
+  `EWCTapeBatchBranch` is a node on the path of the walk where tapes go different ways, holding the calculator state to return to for each of its later children.
+ */
+typedef struct {
+  EWCCalculatorState state;  // the calculator state at the node
+  NSUInteger nextChild;  // the next child to follow
+} EWCTapeBatchBranch;
+
+@interface EWCTapeBatchEvaluator() {
+  EWCCalculator *_calculator;  // reused calculator the keys are pressed on, created on first use
+  NSMutableData *_nodes;  // the trie of the current batch, with the root first
+  NSUInteger _nodeCount;  // the number of nodes in use
+  NSMutableData *_buckets;  // open addressed table of the unique tapes, each entry a tape index plus one, or zero if empty
+  NSMutableData *_hashes;  // the hash of each tape of the current batch
+  NSMutableData *_representatives;  // for each tape of the current batch, the first tape with the same keys
+  NSMutableData *_branches;  // the branches on the path of the walk, outermost first
+}
+
+@end
+
+/**
+  Hashes the keys of a tape, so that identical tapes can be found without comparing every pair.
+
+  @param keys The keys of the tape.
+  @param count The number of keys.
+
+  @return The hash.
+ */
+static uint64_t EWCTapeBatchHash(const EWCCalculatorKey *keys, NSUInteger count) {
+  // FNV-1a over the keys, each of which fits in a byte
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (NSUInteger i = 0; i < count; ++i) {
+    hash ^= (uint8_t)keys[i];
+    hash *= 0x100000001b3ULL;
+  }
+
+  return hash;
+}
+
+@implementation EWCTapeBatchEvaluator
+
+///----------------------------------------------
+/// @name Construction and Initialization Methods
+///----------------------------------------------
+
++ (instancetype)evaluatorWithMaximumDigits:(NSInteger)maximumDigits {
+  return [[EWCTapeBatchEvaluator alloc] initWithMaximumDigits:maximumDigits];
+}
+
+- (instancetype)initWithMaximumDigits:(NSInteger)maximumDigits {
+  self = [super init];
+  if (self) {
+    _maximumDigits = maximumDigits;
+    _startingTaxRate = [NSDecimalNumber zero];
+    _startingMemory = [NSDecimalNumber zero];
+    _nodes = [NSMutableData new];
+    _buckets = [NSMutableData new];
+    _hashes = [NSMutableData new];
+    _representatives = [NSMutableData new];
+    _branches = [NSMutableData new];
+  }
+
+  return self;
+}
+
+///-------------------------
+/// @name Evaluation Methods
+///-------------------------
+
+- (void)evaluateTapes:(const EWCCalculatorKey * const *)tapes
+  counts:(const NSUInteger *)counts
+  count:(NSUInteger)count
+  results:(EWCTapeResult *)results {
+
+  _tapeCount = count;
+  _keyCount = 0;
+  for (NSUInteger t = 0; t < count; ++t) {
+    _keyCount += counts[t];
+  }
+
+  [self findDuplicatesOfTapes:tapes counts:counts count:count];
+  [self buildTrieOfTapes:tapes counts:counts count:count];
+  [self walkTrieWithResults:results];
+
+  // the duplicates share the results of the first of their tapes
+  const NSUInteger *representatives = _representatives.bytes;
+  for (NSUInteger t = 0; t < count; ++t) {
+    if (representatives[t] != t) {
+      results[t] = results[representatives[t]];
+    }
+  }
+}
+
+- (void)evaluateKeys:(const EWCCalculatorKey *)keys
+  count:(NSUInteger)count
+  result:(EWCTapeResult *)result {
+
+  [self resetCalculator];
+
+  for (NSUInteger i = 0; i < count; ++i) {
+    [_calculator pressKey:keys[i]];
+  }
+
+  [self getResult:result];
+}
+
+/**
+  Finds the tapes with the same keys as an earlier tape, filling in the representative of each tape and the unique tape count.
+
+  @param tapes The keys of each tape.
+  @param counts The number of keys on each tape.
+  @param count The number of tapes.
+ */
+- (void)findDuplicatesOfTapes:(const EWCCalculatorKey * const *)tapes
+  counts:(const NSUInteger *)counts
+  count:(NSUInteger)count {
+
+  // keep the table at most half full, so that probes stay short
+  NSUInteger bucketCount = 16;
+  while (bucketCount < count * 2) {
+    bucketCount <<= 1;
+  }
+  NSUInteger mask = bucketCount - 1;
+
+  _buckets.length = 0;
+  _buckets.length = bucketCount * sizeof(NSUInteger);
+  _hashes.length = count * sizeof(uint64_t);
+  _representatives.length = count * sizeof(NSUInteger);
+
+  NSUInteger *buckets = _buckets.mutableBytes;
+  uint64_t *hashes = _hashes.mutableBytes;
+  NSUInteger *representatives = _representatives.mutableBytes;
+
+  _uniqueTapeCount = 0;
+  for (NSUInteger t = 0; t < count; ++t) {
+    uint64_t hash = EWCTapeBatchHash(tapes[t], counts[t]);
+    hashes[t] = hash;
+
+    NSUInteger b = (NSUInteger)hash & mask;
+    while (buckets[b]) {
+      NSUInteger other = buckets[b] - 1;
+      if (hashes[other] == hash
+        && counts[other] == counts[t]
+        && memcmp(tapes[other], tapes[t], counts[t] * sizeof(EWCCalculatorKey)) == 0) {
+        break;
+      }
+
+      b = (b + 1) & mask;
+    }
+
+    if (buckets[b]) {
+      representatives[t] = buckets[b] - 1;
+    } else {
+      buckets[b] = t + 1;
+      representatives[t] = t;
+      ++_uniqueTapeCount;
+    }
+  }
+}
+
+/**
+  Builds the trie over the keys of the unique tapes, so that each prefix shared by several tapes is a single path from the root.
+
+  @param tapes The keys of each tape.
+  @param counts The number of keys on each tape.
+  @param count The number of tapes.
+ */
+- (void)buildTrieOfTapes:(const EWCCalculatorKey * const *)tapes
+  counts:(const NSUInteger *)counts
+  count:(NSUInteger)count {
+
+  const NSUInteger *representatives = _representatives.bytes;
+
+  [self reserveNodes:1];
+  EWCTapeBatchNode *nodes = _nodes.mutableBytes;
+  nodes[0] = (EWCTapeBatchNode){ EWCTapeBatchNoNode, EWCTapeBatchNoNode, EWCTapeBatchNoTape, EWCCalculatorNoKey };
+  _nodeCount = 1;
+
+  for (NSUInteger t = 0; t < count; ++t) {
+    if (representatives[t] != t) {
+      continue;
+    }
+
+    const EWCCalculatorKey *keys = tapes[t];
+    NSUInteger node = 0;
+    for (NSUInteger i = 0; i < counts[t]; ++i) {
+      // a node has at most one child per key, so the siblings are few enough
+      // to search in order
+      NSUInteger child = nodes[node].firstChild;
+      while (child != EWCTapeBatchNoNode && nodes[child].key != keys[i]) {
+        child = nodes[child].nextSibling;
+      }
+
+      if (child == EWCTapeBatchNoNode) {
+        [self reserveNodes:_nodeCount + 1];
+        nodes = _nodes.mutableBytes;
+
+        child = _nodeCount++;
+        nodes[child] = (EWCTapeBatchNode){ EWCTapeBatchNoNode, nodes[node].firstChild, EWCTapeBatchNoTape, keys[i] };
+        nodes[node].firstChild = child;
+      }
+
+      node = child;
+    }
+
+    nodes[node].tape = t;
+  }
+
+  _pressedKeyCount = _nodeCount - 1;
+}
+
+/**
+  Ensures the trie has room for a number of nodes, keeping the nodes already in use.
+
+  @param capacity The number of nodes needed.
+ */
+- (void)reserveNodes:(NSUInteger)capacity {
+  NSUInteger length = _nodes.length / sizeof(EWCTapeBatchNode);
+  if (length >= capacity) {
+    return;
+  }
+
+  while (length < capacity) {
+    length = length ? length * 2 : 1024;
+  }
+
+  _nodes.length = length * sizeof(EWCTapeBatchNode);
+}
+
+/**
+  Walks the trie depth first, pressing the key of each node once, and reading the results of each tape at the node its last key leads to.
+
+  @param results Receives the results of the unique tapes.
+ */
+- (void)walkTrieWithResults:(EWCTapeResult *)results {
+  [self resetCalculator];
+
+  const EWCTapeBatchNode *nodes = _nodes.bytes;
+  EWCTapeBatchBranch *branches = _branches.mutableBytes;
+  NSUInteger depth = 0;
+  NSUInteger node = 0;
+
+  _branchCount = 0;
+  while (YES) {
+    @autoreleasepool {
+      if (nodes[node].tape != EWCTapeBatchNoTape) {
+        [self getResult:&results[nodes[node].tape]];
+      }
+
+      NSUInteger child = nodes[node].firstChild;
+      if (child != EWCTapeBatchNoNode) {
+        // save the state to come back to for the later children, and carry
+        // on down the first
+        if (nodes[child].nextSibling != EWCTapeBatchNoNode) {
+          if ((depth + 1) * sizeof(EWCTapeBatchBranch) > _branches.length) {
+            _branches.length = (depth + 1) * 2 * sizeof(EWCTapeBatchBranch);
+            branches = _branches.mutableBytes;
+          }
+
+          EWCTapeBatchBranch *branch = &branches[depth++];
+          [_calculator getState:&branch->state];
+          branch->nextChild = nodes[child].nextSibling;
+          ++_branchCount;
+        }
+      } else {
+        // a leaf, so go back to the innermost branch with children left
+        if (depth == 0) {
+          break;
+        }
+
+        EWCTapeBatchBranch *branch = &branches[depth - 1];
+        child = branch->nextChild;
+        [_calculator restoreState:&branch->state];
+
+        // the last child doesn't need the state again
+        branch->nextChild = nodes[child].nextSibling;
+        if (branch->nextChild == EWCTapeBatchNoNode) {
+          --depth;
+        }
+      }
+
+      [_calculator pressKey:nodes[child].key];
+      node = child;
+    }
+  }
+}
+
+/**
+  Resets the calculator to the state each tape starts from, creating it if needed.
+ */
+- (void)resetCalculator {
+  if (! _calculator) {
+    _calculator = [EWCCalculator calculator];
+    _calculator.maximumDigits = _maximumDigits;
+  }
+
+  [_calculator reset];
+  _calculator.dataProvider = [EWCCalculatorMemoryData dataWithTaxRate:_startingTaxRate
+    memory:_startingMemory];
+}
+
+/**
+  Reads the results the calculator holds.
+
+  @param result Receives the results.
+ */
+- (void)getResult:(EWCTapeResult *)result {
+  result->display = _calculator.displayValue.decimalValue;
+  result->memory = _calculator.memoryValue.decimalValue;
+  result->taxRate = _calculator.taxRateValue.decimalValue;
+  result->hasMemory = _calculator.hasMemory;
+  result->error = _calculator.hasError;
+  result->replayed = YES;
+}
+
+@end
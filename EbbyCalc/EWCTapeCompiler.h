@@ -0,0 +1,71 @@
+//
+//  EWCTapeCompiler.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import "EWCCalculatorKey.h"
+
+@class EWCTapeProgram;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCTapeCompiler` compiles a tape of calculator keys into an `EWCTapeProgram`.
+
+  The compiler walks the tape the way `EWCCalculator` processes keys, tracking everything that doesn't depend on the numbers entered (the pending operation, the operation queue with its token types, the last key, the rate shift, and whether a number is being entered), so that each step of the calculator's grammar is decided once.  Each number entered becomes an input slot, and each calculation the keys would perform becomes an instruction.
+ */
+@interface EWCTapeCompiler : NSObject
+
+/**
+  The maximum digits of the calculator being compiled for.
+ */
+@property (nonatomic, readonly) NSInteger maximumDigits;
+
+/**
+  Creates a new compiler.
+
+  @param maximumDigits The maximum digits of the calculator being compiled for, or 0 for no limit.
+
+  @return The new compiler.
+ */
++ (instancetype)compilerWithMaximumDigits:(NSInteger)maximumDigits;
+
+/**
+  Initializes a compiler.
+
+  @param maximumDigits The maximum digits of the calculator being compiled for, or 0 for no limit.
+
+  @return The initialized instance.
+ */
+- (instancetype)initWithMaximumDigits:(NSInteger)maximumDigits;
+
+/**
+  Compiles a tape.
+
+  @param keys The keys of the tape, as they would be pressed on a calculator that was just reset.
+  @param count The number of keys.
+
+  @return The compiled program.
+ */
+- (EWCTapeProgram *)compileKeys:(const EWCCalculatorKey *)keys count:(NSUInteger)count;
+
+@end
+
+NS_ASSUME_NONNULL_END
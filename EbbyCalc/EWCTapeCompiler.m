@@ -0,0 +1,630 @@
+//
+//  EWCTapeCompiler.m
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCTapeCompiler.h"
+#import "EWCTapeProgram.h"
+#import "EWCCalculatorState.h"
+
+@interface EWCTapeCompiler() {
+  NSMutableData *_instructions;  // the instructions emitted so far
+  NSMutableData *_slots;  // the numbers entered so far
+  EWCCalculatorInput _input;  // builds the number being entered, for its template value
+  EWCCalculatorTokenQueue _queue;  // the operation queue, with each data token holding the register its value is in
+  EWCCalculatorOpcode _operation;  // the last operation performed
+  EWCCalculatorKey _lastKey;  // the last key compiled
+  BOOL _rateShifted;  // whether the rate key has shifted the tax keys
+  BOOL _showingJustTax;  // whether the display is showing the tax portion of a tax calculation
+  BOOL _displayAvailable;  // whether the display value should be queued by the next operation key
+  BOOL _failed;  // whether the tape has reached the error state regardless of its numbers
+}
+
+@end
+
+/**
+  Makes the data of a queued token, which names the register holding the value rather than holding the value itself.
+
+  @param reg The register.
+
+  @return The token data.
+ */
+static NSDecimal EWCTapeCompilerTokenData(NSInteger reg) {
+  return [NSNumber numberWithInteger:reg].decimalValue;
+}
+
+/**
+  Gets the register named by a queued token.
+
+  @param token The data token.
+
+  @return The register holding the token's value.
+ */
+static NSInteger EWCTapeCompilerTokenRegister(const EWCCalculatorToken *token) {
+  return [NSDecimalNumber decimalNumberWithDecimal:token->data].integerValue;
+}
+
+/**
+  Converts an operation key to an opcode, as `EWCCalculator` does.
+
+  @param key The operation key.
+
+  @return The corresponding opcode.
+ */
+static EWCCalculatorOpcode EWCTapeCompilerOpcodeFromKey(EWCCalculatorKey key) {
+  switch (key) {
+    case EWCCalculatorAddKey: return EWCCalculatorAddOpcode;
+    case EWCCalculatorSubtractKey: return EWCCalculatorSubtractOpcode;
+    case EWCCalculatorMultiplyKey: return EWCCalculatorMultiplyOpcode;
+    case EWCCalculatorDivideKey: return EWCCalculatorDivideOpcode;
+    default: return EWCCalculatorNoOpcode;
+  }
+}
+
+@implementation EWCTapeCompiler
+
+///----------------------------------------------
+/// @name Construction and Initialization Methods
+///----------------------------------------------
+
++ (instancetype)compilerWithMaximumDigits:(NSInteger)maximumDigits {
+  return [[EWCTapeCompiler alloc] initWithMaximumDigits:maximumDigits];
+}
+
+- (instancetype)initWithMaximumDigits:(NSInteger)maximumDigits {
+  self = [super init];
+  if (self) {
+    _maximumDigits = maximumDigits;
+  }
+
+  return self;
+}
+
+///----------------------
+/// @name Compile Methods
+///----------------------
+
+- (EWCTapeProgram *)compileKeys:(const EWCCalculatorKey *)keys count:(NSUInteger)count {
+  // start from the state of a calculator that was just reset
+  _instructions = [NSMutableData new];
+  _slots = [NSMutableData new];
+  EWCCalculatorInputClear(&_input);
+  EWCCalculatorTokenQueueClear(&_queue);
+  _queue.didChange = NO;
+  _operation = EWCCalculatorNoOpcode;
+  _lastKey = EWCCalculatorNoKey;
+  _rateShifted = NO;
+  _showingJustTax = NO;
+  _displayAvailable = NO;
+  _failed = NO;
+
+  for (NSUInteger i = 0; i < count && ! _failed; ++i) {
+    [self compileKey:keys[i] atIndex:i];
+    _lastKey = keys[i];
+  }
+
+  EWCTapeProgram *program = [[EWCTapeProgram alloc] initWithKeys:keys
+    keyCount:count
+    maximumDigits:_maximumDigits
+    instructions:_instructions.bytes
+    instructionCount:_instructions.length / sizeof(EWCTapeInstruction)
+    slots:_slots.bytes
+    slotCount:_slots.length / sizeof(EWCTapeSlot)];
+
+  _instructions = nil;
+  _slots = nil;
+
+  return program;
+}
+
+/**
+  Adds an instruction to the program.
+
+  @param operation The operation to perform.
+  @param destination The register written.
+  @param source The register (or input slot) read.
+ */
+- (void)emitOperation:(EWCTapeOperation)operation
+  destination:(NSInteger)destination
+  source:(NSInteger)source {
+
+  EWCTapeInstruction instruction = {
+    .operation = operation,
+    .opcode = EWCCalculatorNoOpcode,
+    .destination = destination,
+    .source = source,
+    .operand = 0,
+  };
+
+  [_instructions appendBytes:&instruction length:sizeof(instruction)];
+}
+
+/**
+  Adds an arithmetic instruction to the program, which stores its result in the accumulator.
+
+  @param opcode The calculation.
+  @param data The register holding the first value.
+  @param operand The register holding the second value.
+ */
+- (void)emitArithmetic:(EWCCalculatorOpcode)opcode
+  data:(NSInteger)data
+  operand:(NSInteger)operand {
+
+  EWCTapeInstruction instruction = {
+    .operation = EWCTapeArithmeticOperation,
+    .opcode = opcode,
+    .destination = EWCTapeAccumulatorRegister,
+    .source = data,
+    .operand = operand,
+  };
+
+  [_instructions appendBytes:&instruction length:sizeof(instruction)];
+}
+
+/**
+  Marks the tape as reaching the error state whatever its numbers, so that every run replays the keys.  Nothing after this point is compiled.
+ */
+- (void)fail {
+  [self emitOperation:EWCTapeBailOperation destination:0 source:0];
+  _failed = YES;
+}
+
+/**
+  Finds a temporary register that no queued token is using.
+
+  @return The free register.
+ */
+- (NSInteger)allocateTemporary {
+  BOOL used[EWCTapeTemporaryRegisterCount] = { NO };
+  for (short i = 0; i < _queue.count; ++i) {
+    if (_queue.tokens[i].tokenType == EWCCalculatorDataTokenType) {
+      used[EWCTapeCompilerTokenRegister(&_queue.tokens[i]) - EWCTapeFirstTemporaryRegister] = YES;
+    }
+  }
+
+  NSInteger temporary = 0;
+  while (used[temporary]) {
+    ++temporary;
+  }
+
+  return EWCTapeFirstTemporaryRegister + temporary;
+}
+
+/**
+  Compiles a single key, following `-[EWCCalculator processKey:]`.
+
+  @param key The key.
+  @param index The position of the key on the tape.
+ */
+- (void)compileKey:(EWCCalculatorKey)key atIndex:(NSUInteger)index {
+  // if not a tax rate-related key, unshift
+  if (! EWCCalculatorKeyIsRateKey(key)) {
+    _rateShifted = NO;
+  }
+
+  // keys that contribute to building up a number
+  if ([self compileInputKey:key atIndex:index]) {
+    _displayAvailable = YES;
+    return;
+  }
+
+  // keys that operate on the display value
+  if (key == EWCCalculatorSqrtKey) {
+    [self emitOperation:EWCTapeSqrtOperation destination:EWCTapeDisplayRegister source:EWCTapeDisplayRegister];
+    _displayAvailable = YES;
+  } else if (key == EWCCalculatorRateKey) {
+    _rateShifted = ! _rateShifted;
+  } else if (key == EWCCalculatorTaxPlusKey || key == EWCCalculatorTaxMinusKey) {
+    [self compileTaxKey:key];
+  } else if (key == EWCCalculatorMemoryKey) {
+    if (_lastKey == EWCCalculatorMemoryKey) {
+      [self emitOperation:EWCTapeMemoryClearOperation destination:EWCTapeMemoryRegister source:EWCTapeMemoryRegister];
+    } else {
+      [self emitOperation:EWCTapeDisplayOperation destination:EWCTapeDisplayRegister source:EWCTapeMemoryRegister];
+      _displayAvailable = YES;
+    }
+  } else if (key == EWCCalculatorMemoryPlusKey) {
+    [self emitOperation:EWCTapeMemoryAddOperation destination:EWCTapeMemoryRegister source:EWCTapeDisplayRegister];
+  } else if (key == EWCCalculatorMemoryMinusKey) {
+    [self emitOperation:EWCTapeMemorySubtractOperation destination:EWCTapeMemoryRegister source:EWCTapeDisplayRegister];
+  } else {
+    [self compileQueueKey:key];
+  }
+}
+
+/**
+  Compiles a key that builds up a number.  The first digit or decimal of a number starts a new input slot, and the keys that follow while the number is being entered become part of it.
+
+  @param key The key.
+  @param index The position of the key on the tape.
+
+  @return NO if the key doesn't build up a number.
+ */
+- (BOOL)compileInputKey:(EWCCalculatorKey)key atIndex:(NSUInteger)index {
+  BOOL editing = _input.editing;
+
+  if (! EWCCalculatorInputProcessKey(&_input, key, _maximumDigits)) {
+    return NO;
+  }
+
+  if (editing) {
+    // continues the number being entered
+    EWCTapeSlot *slot = (EWCTapeSlot *)_slots.mutableBytes + (_slots.length / sizeof(EWCTapeSlot) - 1);
+    ++slot->keyCount;
+    slot->templateValue = _input.value;
+  } else if (_input.editing) {
+    // starts a new number
+    EWCTapeSlot slot = {
+      .keyIndex = index,
+      .keyCount = 1,
+      .templateValue = _input.value,
+    };
+
+    NSInteger slotIndex = (NSInteger)(_slots.length / sizeof(EWCTapeSlot));
+    [_slots appendBytes:&slot length:sizeof(slot)];
+    [self emitOperation:EWCTapeLoadSlotOperation destination:EWCTapeDisplayRegister source:slotIndex];
+  } else if (key == EWCCalculatorSignKey) {
+    // changes the sign of a result
+    [self emitOperation:EWCTapeNegateOperation destination:EWCTapeDisplayRegister source:EWCTapeDisplayRegister];
+  }
+
+  // a backspace with no number being entered leaves the display alone
+
+  return YES;
+}
+
+/**
+  Compiles the tax plus or tax minus key, following `-[EWCCalculator processTaxPlusKey]` and `-[EWCCalculator processTaxMinusKey]`.
+
+  @param key The tax key.
+ */
+- (void)compileTaxKey:(EWCCalculatorKey)key {
+  if (_rateShifted) {
+    if (key == EWCCalculatorTaxPlusKey) {
+      // store the rate
+      [self emitOperation:EWCTapeMoveOperation destination:EWCTapeTaxRateRegister source:EWCTapeDisplayRegister];
+    } else {
+      // recall the rate
+      [self emitOperation:EWCTapeDisplayOperation destination:EWCTapeDisplayRegister source:EWCTapeTaxRateRegister];
+    }
+
+    [self compileClearCalculation];
+    return;
+  }
+
+  if (_lastKey != key) {
+    // first press, so do the calculation and show the adjusted result
+    _showingJustTax = NO;
+    [self emitOperation:(key == EWCCalculatorTaxPlusKey) ? EWCTapeTaxPlusOperation : EWCTapeTaxMinusOperation
+      destination:EWCTapeTaxWithTaxRegister
+      source:EWCTapeDisplayRegister];
+  } else {
+    _showingJustTax = ! _showingJustTax;
+  }
+
+  [self emitOperation:EWCTapeDisplayOperation
+    destination:EWCTapeDisplayRegister
+    source:_showingJustTax ? EWCTapeTaxJustTaxRegister : EWCTapeTaxWithTaxRegister];
+  _displayAvailable = YES;
+}
+
+/**
+  Compiles a key that goes through the operation queue: clear, the binary operations, equal, and percent.
+
+  @param key The key.
+ */
+- (void)compileQueueKey:(EWCCalculatorKey)key {
+  // the input is complete, so queue the display value
+  if (_displayAvailable) {
+    _displayAvailable = NO;
+
+    NSInteger temporary = [self allocateTemporary];
+    [self emitOperation:EWCTapeMoveOperation destination:temporary source:EWCTapeDisplayRegister];
+    EWCCalculatorTokenQueueEnqueueData(&_queue, EWCTapeCompilerTokenData(temporary));
+  }
+
+  if (key == EWCCalculatorClearKey) {
+    [self compileClearKey];
+  } else if (EWCCalculatorKeyIsBinaryOp(key)) {
+    EWCCalculatorTokenQueueEnqueueBinOp(&_queue, EWCTapeCompilerOpcodeFromKey(key));
+  } else if (key == EWCCalculatorEqualKey) {
+    EWCCalculatorTokenQueueEnqueueEqual(&_queue, EWCCalculatorEqualOpcode);
+  } else if (key == EWCCalculatorPercentKey) {
+    EWCCalculatorTokenQueueEnqueueEqual(&_queue, EWCCalculatorPercentOpcode);
+  }
+
+  if (_queue.hasError) {
+    [self fail];
+    return;
+  }
+
+  if (EWCCalculatorTokenQueueTakeDidChange(&_queue)) {
+    [self compileParseQueue];
+  }
+}
+
+/**
+  Compiles the clear key, following `-[EWCCalculator processClearKey]`.
+ */
+- (void)compileClearKey {
+  // if the last token is a number, just remove it
+  const EWCCalculatorToken *lastToken = EWCCalculatorTokenQueueLastToken(&_queue);
+  if (lastToken && lastToken->tokenType == EWCCalculatorDataTokenType) {
+    EWCCalculatorTokenQueueRemoveLastToken(&_queue);
+    [self emitOperation:EWCTapeClearOperation destination:EWCTapeDisplayRegister source:EWCTapeDisplayRegister];
+    return;
+  }
+
+  // otherwise, terminate the operation
+  [self emitOperation:EWCTapeClearOperation destination:EWCTapeDisplayRegister source:EWCTapeDisplayRegister];
+  [self compileClearCalculation];
+  _rateShifted = NO;
+}
+
+/**
+  Compiles clearing the state of an ongoing calculation.
+ */
+- (void)compileClearCalculation {
+  [self emitOperation:EWCTapeClearOperation destination:EWCTapeAccumulatorRegister source:EWCTapeAccumulatorRegister];
+  [self emitOperation:EWCTapeClearOperation destination:EWCTapeOperandRegister source:EWCTapeOperandRegister];
+  _operation = EWCCalculatorNoOpcode;
+  EWCCalculatorTokenQueueClear(&_queue);
+}
+
+///--------------------------------
+/// @name Operation Compile Methods
+///--------------------------------
+
+/**
+  Compiles a binary operation, following `-[EWCCalculator performBinaryOperation:withData:andOperand:]`.
+
+  @param opcode The operation.
+  @param data The register holding the first value.
+  @param operand The register holding the second value.
+ */
+- (void)compileBinaryOperation:(EWCCalculatorOpcode)opcode
+  data:(NSInteger)data
+  operand:(NSInteger)operand {
+
+  switch (opcode) {
+    case EWCCalculatorNoOpcode:
+    case EWCCalculatorAddOpcode:
+    case EWCCalculatorSubtractOpcode:
+    case EWCCalculatorMultiplyOpcode:
+    case EWCCalculatorDivideOpcode:
+    case EWCCalculatorAddPercentOpcode:
+    case EWCCalculatorSubtractPercentOpcode:
+    case EWCCalculatorMultiplyPercentOpcode:
+    case EWCCalculatorDividePercentOpcode:
+      break;
+
+    default:
+      [self fail];
+      return;
+  }
+
+  // the operand is never the accumulator, so it can be saved after the
+  // accumulator is written
+  [self emitArithmetic:opcode data:data operand:operand];
+  if (operand != EWCTapeOperandRegister) {
+    [self emitOperation:EWCTapeMoveOperation destination:EWCTapeOperandRegister source:operand];
+  }
+  [self emitOperation:EWCTapeDisplayOperation destination:EWCTapeDisplayRegister source:EWCTapeAccumulatorRegister];
+
+  _operation = opcode;
+}
+
+/**
+  Compiles repeating the last operation.
+ */
+- (void)compileLastOperation {
+  [self compileBinaryOperation:_operation
+    data:EWCTapeAccumulatorRegister
+    operand:EWCTapeOperandRegister];
+}
+
+/**
+  Compiles a unary operation, following `-[EWCCalculator performUnaryOperation:withData:]`.
+
+  @param opcode The operation.
+  @param data The register holding the value.
+ */
+- (void)compileUnaryOperation:(EWCCalculatorOpcode)opcode data:(NSInteger)data {
+  switch (opcode) {
+    case EWCCalculatorAddOpcode:
+    case EWCCalculatorSubtractOpcode:
+      [self compileBinaryOperation:opcode data:EWCTapeZeroRegister operand:data];
+      break;
+
+    case EWCCalculatorMultiplyOpcode:
+      [self compileBinaryOperation:opcode data:data operand:data];
+      break;
+
+    case EWCCalculatorDivideOpcode:
+      [self compileBinaryOperation:opcode data:EWCTapeOneRegister operand:data];
+      break;
+
+    default:
+      [self fail];
+      break;
+  }
+}
+
+///--------------------------------------
+/// @name Operation Queue Compile Methods
+///--------------------------------------
+
+/**
+  Compiles the parse of a queue starting with an operator, following `-[EWCCalculator parseStartingWithOp:]`.
+
+  @param aToken The operation token that started the operation queue.
+
+  @return YES if the tokens processed should be removed from the queue.
+ */
+- (BOOL)compileParseStartingWithOp:(const EWCCalculatorToken *)aToken {
+  const EWCCalculatorToken *o1 = NULL, *d1 = NULL, *o2 = NULL, *eq = NULL;
+  o1 = aToken;
+
+  d1 = EWCCalculatorTokenQueueNextTokenAs(&_queue, EWCCalculatorDataTokenType);
+  if (! d1) {
+    eq = EWCCalculatorTokenQueueNextTokenAs(&_queue, EWCCalculatorEqualTokenType);
+    if (eq) {
+      // o= - change the operator used for last operation (and execute it)
+      _operation = EWCCalculatorOpcodeModifyForEqualMode(o1->opcode, eq->opcode);
+      [self compileLastOperation];
+      return YES;
+    }
+
+    return NO;
+  }
+
+  o2 = EWCCalculatorTokenQueueNextTokenAs(&_queue, EWCCalculatorBinOpTokenType);
+  if (! o2) {
+    eq = EWCCalculatorTokenQueueNextTokenAs(&_queue, EWCCalculatorEqualTokenType);
+    if (eq) {
+      // od= - binary operation
+      [self compileBinaryOperation:EWCCalculatorOpcodeModifyForEqualMode(o1->opcode, eq->opcode)
+        data:EWCTapeAccumulatorRegister
+        operand:EWCTapeCompilerTokenRegister(d1)];
+      return YES;
+    }
+
+    return NO;
+  }
+
+  // odo - binary operation with a continuation
+  EWCCalculatorTokenQueuePushbackToken(&_queue);
+  [self compileBinaryOperation:o1->opcode
+    data:EWCTapeAccumulatorRegister
+    operand:EWCTapeCompilerTokenRegister(d1)];
+
+  return YES;
+}
+
+/**
+  Compiles the parse of a queue starting with data, following `-[EWCCalculator parseStartingWithData:]`.
+
+  @param aToken The data token that started the operation queue.
+
+  @return YES if the tokens processed should be removed from the queue.
+ */
+- (BOOL)compileParseStartingWithData:(const EWCCalculatorToken *)aToken {
+  const EWCCalculatorToken *d1 = NULL, *o1 = NULL, *d2 = NULL, *o2 = NULL, *eq = NULL;
+  d1 = aToken;
+
+  o1 = EWCCalculatorTokenQueueNextTokenAs(&_queue, EWCCalculatorBinOpTokenType);
+  if (! o1) {
+    eq = EWCCalculatorTokenQueueNextTokenAs(&_queue, EWCCalculatorEqualTokenType);
+    if (eq) {
+      // d= - if there is a last op, assign d to acc, and perform it (not if percent!)
+      if (_operation != EWCCalculatorNoOpcode && eq->opcode == EWCCalculatorEqualOpcode) {
+        [self emitOperation:EWCTapeMoveOperation
+          destination:EWCTapeAccumulatorRegister
+          source:EWCTapeCompilerTokenRegister(d1)];
+        [self compileLastOperation];
+      } else {
+        _displayAvailable = YES;
+      }
+      return YES;
+    }
+
+    return NO;
+  }
+
+  d2 = EWCCalculatorTokenQueueNextTokenAs(&_queue, EWCCalculatorDataTokenType);
+  if (! d2) {
+    eq = EWCCalculatorTokenQueueNextTokenAs(&_queue, EWCCalculatorEqualTokenType);
+    if (eq) {
+      // do= - unary operation on d
+      if (eq->opcode == EWCCalculatorEqualOpcode) {
+        [self compileUnaryOperation:o1->opcode data:EWCTapeCompilerTokenRegister(d1)];
+        return YES;
+      } else {
+        // the percent has no effect, so just excise it
+        EWCCalculatorTokenQueuePushbackToken(&_queue);
+        EWCCalculatorTokenQueuePopToken(&_queue);
+      }
+    }
+
+    return NO;
+  }
+
+  o2 = EWCCalculatorTokenQueueNextTokenAs(&_queue, EWCCalculatorBinOpTokenType);
+  if (! o2) {
+    eq = EWCCalculatorTokenQueueNextTokenAs(&_queue, EWCCalculatorEqualTokenType);
+    if (eq) {
+      // dod= - binary operation
+      [self compileBinaryOperation:EWCCalculatorOpcodeModifyForEqualMode(o1->opcode, eq->opcode)
+        data:EWCTapeCompilerTokenRegister(d1)
+        operand:EWCTapeCompilerTokenRegister(d2)];
+      return YES;
+    }
+
+    return NO;
+  }
+
+  // dodo - binary operation with a continuation
+  EWCCalculatorTokenQueuePushbackToken(&_queue);
+  [self compileBinaryOperation:o1->opcode
+    data:EWCTapeCompilerTokenRegister(d1)
+    operand:EWCTapeCompilerTokenRegister(d2)];
+
+  return YES;
+}
+
+/**
+  Compiles the parse of the operation queue, following `-[EWCCalculator parseQueue]`.
+ */
+- (void)compileParseQueue {
+  BOOL shouldCommit = NO;
+
+  EWCCalculatorTokenQueueMoveToFirst(&_queue);
+
+  const EWCCalculatorToken *token = EWCCalculatorTokenQueueNextToken(&_queue);
+  if (! token) {
+    return;
+  }
+
+  switch (token->tokenType) {
+    case EWCCalculatorBinOpTokenType:
+      shouldCommit = [self compileParseStartingWithOp:token];
+      break;
+
+    case EWCCalculatorEqualTokenType:
+      // perform last operation (only if normal equal)
+      if (token->opcode == EWCCalculatorEqualOpcode) {
+        [self compileLastOperation];
+      }
+      shouldCommit = YES;
+      break;
+
+    case EWCCalculatorDataTokenType:
+      shouldCommit = [self compileParseStartingWithData:token];
+      break;
+
+    case EWCCalculatorEmptyTokenType:
+      return;
+  }
+
+  if (shouldCommit) {
+    EWCCalculatorTokenQueueCommit(&_queue);
+  }
+}
+
+@end
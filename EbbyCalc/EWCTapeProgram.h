@@ -0,0 +1,261 @@
+//
+//  EWCTapeProgram.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import "EWCBigDecimal.h"
+#import "EWCCalculatorKey.h"
+#import "EWCCalculatorOpcode.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCTapeOperation` is the operation performed by a single instruction of an `EWCTapeProgram`.
+ */
+typedef NS_ENUM(NSInteger, EWCTapeOperation) {
+  EWCTapeLoadSlotOperation = 0,  // display = input[source], if typing it would give the same value
+  EWCTapeMoveOperation,  // destination = source
+  EWCTapeClearOperation,  // destination = 0
+  EWCTapeDisplayOperation,  // display = source, restricted to the maximum digits
+  EWCTapeArithmeticOperation,  // destination = source (opcode) operand, as a binary calculator operation
+  EWCTapeNegateOperation,  // display = -display
+  EWCTapeSqrtOperation,  // display = sqrt(display), restricted to the maximum digits
+  EWCTapeTaxPlusOperation,  // tax results = display with tax added, and the tax added
+  EWCTapeTaxMinusOperation,  // tax results = display with tax removed, and the tax removed
+  EWCTapeMemoryAddOperation,  // memory = memory + display
+  EWCTapeMemorySubtractOperation,  // memory = memory - display
+  EWCTapeMemoryClearOperation,  // memory = 0, and no memory is held
+  EWCTapeBailOperation,  // the tape always ends in an error, so always replay the keys
+};
+
+/**
+  `EWCTapeRegister` names the values an `EWCTapeProgram` works on.  They mirror the calculator's fields, followed by constants and temporaries holding the data values that were waiting in the calculator's operation queue.
+ */
+typedef NS_ENUM(NSInteger, EWCTapeRegister) {
+  EWCTapeDisplayRegister = 0,
+  EWCTapeAccumulatorRegister,
+  EWCTapeOperandRegister,
+  EWCTapeMemoryRegister,
+  EWCTapeTaxRateRegister,
+  EWCTapeTaxWithTaxRegister,
+  EWCTapeTaxJustTaxRegister,
+  EWCTapeZeroRegister,
+  EWCTapeOneRegister,
+  EWCTapeFirstTemporaryRegister,
+};
+
+/**
+  The number of temporary registers.  A temporary is only needed while its value is waiting in the operation queue, so there are never more in use than the queue can hold, plus the one being added.
+ */
+#define EWCTapeTemporaryRegisterCount 9
+
+/**
+  The total number of registers.
+ */
+#define EWCTapeRegisterCount (EWCTapeFirstTemporaryRegister + EWCTapeTemporaryRegisterCount)
+
+/**
+  `EWCTapeInstruction` is a single step of an `EWCTapeProgram`.
+ */
+typedef struct {
+  EWCTapeOperation operation;  // what the instruction does
+  EWCCalculatorOpcode opcode;  // the calculation for an arithmetic instruction
+  NSInteger destination;  // the register written
+  NSInteger source;  // the register read, or the input slot for a load
+  NSInteger operand;  // the second register read by an arithmetic instruction
+} EWCTapeInstruction;
+
+/**
+  `EWCTapeSlot` describes a number entered on the tape, which each run replaces with one of its inputs.
+ */
+typedef struct {
+  NSUInteger keyIndex;  // the position of the number's first key on the tape
+  NSUInteger keyCount;  // the number of keys (digits, decimal, sign, and backspace) that entered the number
+  NSDecimal templateValue;  // the value the tape's own keys entered
+} EWCTapeSlot;
+
+/**
+  `EWCTapeResult` holds the results of running an `EWCTapeProgram` over one set of inputs.
+ */
+typedef struct {
+  NSDecimal display;  // the value in the display at the end of the tape
+  NSDecimal memory;  // the value in memory
+  NSDecimal taxRate;  // the tax rate
+  BOOL hasMemory;  // whether a memory value is held
+  BOOL error;  // whether the calculator ended in the error state
+  BOOL replayed;  // whether the run fell back to replaying the keys
+} EWCTapeResult;
+
+/**
+  The digits a wide run carries beyond the maximum digits, so that a value held between calculations keeps more digits than the display shows.
+ */
+#define EWCTapeWideGuardDigits 20
+
+/**
+  `EWCTapeWideResult` holds the results of a wide run of an `EWCTapeProgram`, whose values may have more digits than an `NSDecimal` can hold.  Set it up with `EWCTapeWideResultInit` before its first run, and release it with `EWCTapeWideResultFree` once done.
+ */
+typedef struct {
+  EWCBigDecimal display;  // the value in the display at the end of the tape
+  EWCBigDecimal memory;  // the value in memory
+  EWCBigDecimal taxRate;  // the tax rate
+  BOOL hasMemory;  // whether a memory value is held
+  BOOL error;  // whether the calculator ended in the error state, in which case the values are those held when it did
+} EWCTapeWideResult;
+
+/**
+  Sets up the values of a wide result.
+
+  @param result The result.
+ */
+void EWCTapeWideResultInit(EWCTapeWideResult *result);
+
+/**
+  Releases the values of a wide result.
+
+  @param result The result.
+ */
+void EWCTapeWideResultFree(EWCTapeWideResult *result);
+
+/**
+  `EWCTapeProgram` is a key tape compiled by `EWCTapeCompiler` into straight-line instructions, so that the same keyed procedure can be run over many sets of numbers without the calculator's input building, token queue, or grammar being involved in each run.
+
+  Each number entered on the tape becomes an input slot.  A run supplies a value for every slot, and gets back the results the calculator would have reached had those numbers been typed in place of the tape's own.
+
+  The calculator's grammar is resolved when compiling, but some outcomes depend on the values: dividing by zero, the square root of a negative number, a result too wide for the display, or an input that couldn't be typed within the maximum digits.  Instructions check for these, and a run that meets one falls back to replaying the tape's keys (with the inputs typed in) through a calculator, so the results always match the calculator's own.  Inputs wider than the maximum digits are typed as the calculator would take them, with the excess digits dropped, and NaN inputs are typed as zero.
+
+  A calculator computing with `NSDecimal` can't hold more than `EWCBigDecimalNativeDigits` digits, so a program compiled for more digits than that is run with `-runWithWideInputs:result:`, which works on `EWCBigDecimal` values instead.  A wide run can't replay its keys, so it reports the error state directly, and rounds each calculation to `EWCTapeWideGuardDigits` beyond the maximum digits, as `NSDecimal` rounds to its mantissa.
+
+  A program reuses a calculator for replaying, and registers for wide runs, so it must not be run from more than one thread at a time.
+ */
+@interface EWCTapeProgram : NSObject
+
+/**
+  The maximum digits of the calculator the program computes as.
+ */
+@property (nonatomic, readonly) NSInteger maximumDigits;
+
+/**
+  The number of keys on the compiled tape.
+ */
+@property (nonatomic, readonly) NSUInteger keyCount;
+
+/**
+  The number of inputs each run requires.
+ */
+@property (nonatomic, readonly) NSUInteger slotCount;
+
+/**
+  The number of instructions.
+ */
+@property (nonatomic, readonly) NSUInteger instructionCount;
+
+/**
+  Whether every run will replay the keys, because the tape reaches the error state whatever its inputs.
+ */
+@property (nonatomic, readonly) BOOL alwaysReplays;
+
+/**
+  Whether the maximum digits are more than an `NSDecimal` can hold, so that runs must use `-runWithWideInputs:result:`.
+ */
+@property (nonatomic, readonly) BOOL usesWideArithmetic;
+
+/**
+  The tax rate the calculator holds when each run starts.  Defaults to 0.
+ */
+@property (nonatomic) NSDecimalNumber *startingTaxRate;
+
+/**
+  The memory value the calculator holds when each run starts.  Defaults to 0.
+ */
+@property (nonatomic) NSDecimalNumber *startingMemory;
+
+/**
+  Initializes a program.  Programs are made by `EWCTapeCompiler`, rather than being built by hand.
+
+  @param keys The compiled tape.
+  @param keyCount The number of keys on the tape.
+  @param maximumDigits The maximum digits the tape was compiled for.
+  @param instructions The compiled instructions.
+  @param instructionCount The number of instructions.
+  @param slots The numbers entered on the tape, in order.
+  @param slotCount The number of slots.
+
+  @return The initialized instance.
+ */
+- (instancetype)initWithKeys:(const EWCCalculatorKey *)keys
+  keyCount:(NSUInteger)keyCount
+  maximumDigits:(NSInteger)maximumDigits
+  instructions:(const EWCTapeInstruction *)instructions
+  instructionCount:(NSUInteger)instructionCount
+  slots:(const EWCTapeSlot *)slots
+  slotCount:(NSUInteger)slotCount;
+
+/**
+  Gets the numbers entered by the tape's own keys, so that running with them gives the results of the tape itself.
+
+  @param inputs Receives `slotCount` values.
+ */
+- (void)getTemplateInputs:(NSDecimal *)inputs;
+
+/**
+  Gets the numbers entered by the tape's own keys as big decimals, for a wide run.  Each is as close as the `NSDecimal` the compiler tracked it with.
+
+  @param inputs Receives `slotCount` values, which must have been set up with `EWCBigDecimalInit`.
+ */
+- (void)getWideTemplateInputs:(EWCBigDecimal *)inputs;
+
+/**
+  Runs the program over one set of inputs.
+
+  @param inputs The values for each slot, `slotCount` of them.
+  @param result Receives the results.
+ */
+- (void)runWithInputs:(const NSDecimal *)inputs result:(EWCTapeResult *)result;
+
+/**
+  Runs the program over many sets of inputs.
+
+  @param inputs The sets of inputs, each of `slotCount` values, one after another.
+  @param count The number of sets.
+  @param results Receives the results of each set, `count` of them.
+ */
+- (void)runWithInputVectors:(const NSDecimal *)inputs
+  count:(NSUInteger)count
+  results:(EWCTapeResult *)results;
+
+/**
+  Runs the program over one set of inputs using big decimal arithmetic, for programs compiled for more digits than an `NSDecimal` can hold.  Inputs wider than the maximum digits are typed as the calculator would take them, with the excess digits dropped.
+
+  @param inputs The values for each slot, `slotCount` of them.
+  @param result Receives the results.  Must have been set up with `EWCTapeWideResultInit`.
+ */
+- (void)runWithWideInputs:(const EWCBigDecimal *)inputs result:(EWCTapeWideResult *)result;
+
+/**
+  Gets the results for one set of inputs by typing them in place of the tape's own numbers and pressing the tape's keys on a calculator, without using the compiled instructions.  This is the fallback for runs the instructions can't complete, and the baseline the program is measured against.
+
+  @param inputs The values for each slot, `slotCount` of them.
+  @param result Receives the results.
+ */
+- (void)replayKeysWithInputs:(const NSDecimal *)inputs result:(EWCTapeResult *)result;
+
+@end
+
+NS_ASSUME_NONNULL_END
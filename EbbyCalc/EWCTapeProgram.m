@@ -0,0 +1,914 @@
+//
+//  EWCTapeProgram.m
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCTapeProgram.h"
+#import "EWCDecimalArithmetic.h"
+#import "EWCCalculator.h"
+#import "EWCCalculatorMemoryData.h"
+#import "EWCCalculatorState.h"
+#import "EWCDecimalDigits.h"
+#import "NSDecimalNumber+EWCMathCategory.h"
+
+/**
+  The most keys needed to type a single value.  An `NSDecimal` has at most 39 digits and an exponent from -128 to 127, so the digits, any zeros from the exponent, a leading zero, the decimal, and the sign always fit.
+ */
+#define EWCTapeSpellingCapacity 256
+
+/**
+  The registers a wide run uses beyond the program's own, for the parts of a calculation.
+ */
+typedef NS_ENUM(NSInteger, EWCTapeWideScratchRegister) {
+  EWCTapeWideValueRegister = EWCTapeRegisterCount,
+  EWCTapeWideRateRegister,
+  EWCTapeWidePartRegister,
+  EWCTapeWideRegisterCount,
+};
+
+@interface EWCTapeProgram() {
+  NSData *_keys;  // the compiled tape
+  NSData *_instructions;  // the compiled instructions
+  NSData *_slots;  // the numbers entered on the tape
+  NSMutableData *_replayKeys;  // reused buffer for the keys of a replay
+  EWCCalculator *_calculator;  // reused calculator for replays, created on first use
+  EWCBigDecimal *_wideRegisters;  // reused registers for wide runs, created on first use
+}
+
+@end
+
+/**
+  Gets the value of one hundredth, used to turn percents into multipliers.
+
+  @return One hundredth.
+ */
+static NSDecimal EWCTapeHundredth(void) {
+  static NSDecimal s_hundredth;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    s_hundredth = [NSDecimalNumber decimalNumberWithMantissa:1 exponent:-2 isNegative:NO].decimalValue;
+  });
+
+  return s_hundredth;
+}
+
+/**
+  Checks the outcome of a calculation the way the calculator's `NSDecimalNumber` arithmetic does, which only ignores a loss of precision.
+
+  @param error The outcome.
+
+  @return YES if the result can be used.
+ */
+static inline BOOL EWCTapeCalculationSucceeded(NSCalculationError error) {
+  return error == NSCalculationNoError || error == NSCalculationLossOfPrecision;
+}
+
+/**
+  Checks whether a value already fits in the maximum digits, so that restricting it would leave it unchanged.  This is a conservative check, so a value that fails it may still fit once rounded.
+
+  @param value The value to check.
+  @param maximumDigits The maximum digits.
+
+  @return YES if the value fits as it is.
+ */
+static BOOL EWCTapeValueFits(const NSDecimal *value, NSInteger maximumDigits) {
+  EWCDecimalDigits digits;
+  if (! EWCDecimalDigitsFromDecimal(value, &digits)) {
+    return NO;
+  }
+
+  NSInteger whole = digits.count + digits.exponent;
+  if (digits.exponent >= 0) {
+    return whole <= maximumDigits;
+  }
+
+  NSInteger fraction = -digits.exponent;
+  if (whole <= 0) {
+    // a leading zero is shown before the decimal
+    return fraction <= maximumDigits - 1;
+  }
+
+  return whole + fraction <= maximumDigits;
+}
+
+/**
+  Restricts a value to the maximum digits, as the calculator does for every value it displays.
+
+  @param value The value to restrict, which is updated.
+  @param maximumDigits The maximum digits, or 0 for no limit.
+
+  @return NO if the value can't fit, which puts the calculator in the error state.
+ */
+static BOOL EWCTapeRestrict(NSDecimal *value, NSInteger maximumDigits) {
+  if (NSDecimalIsNotANumber(value)) {
+    return NO;
+  }
+
+  if (maximumDigits == 0 || EWCTapeValueFits(value, maximumDigits)) {
+    return YES;
+  }
+
+  NSDecimalNumber *restricted = [[NSDecimalNumber decimalNumberWithDecimal:*value]
+    ewc_decimalNumberByRestrictingToDigits:maximumDigits];
+  if (! restricted) {
+    return NO;
+  }
+
+  *value = restricted.decimalValue;
+
+  return YES;
+}
+
+/**
+  Performs a binary calculator operation, matching `EWCCalculator`'s arithmetic step for step.
+
+  @param opcode The operation.
+  @param data The first value.
+  @param operand The second value.
+  @param result Receives the result.  It may be the same as either value.
+
+  @return NO if the operation puts the calculator in the error state.
+ */
+static BOOL EWCTapeArithmetic(EWCCalculatorOpcode opcode,
+  const NSDecimal *data,
+  const NSDecimal *operand,
+  NSDecimal *result) {
+
+  NSDecimal zero = EWCCalculatorDecimalZero();
+  NSDecimal hundredth = EWCTapeHundredth();
+
+  if ((opcode == EWCCalculatorDivideOpcode || opcode == EWCCalculatorDividePercentOpcode)
+    && NSDecimalCompare(operand, &zero) == NSOrderedSame) {
+    return NO;
+  }
+
+  NSDecimal value = *data;
+  NSDecimal rate, percent;
+  NSCalculationError error = NSCalculationNoError;
+
+  switch (opcode) {
+    case EWCCalculatorAddOpcode:
+      error = NSDecimalAdd(&value, data, operand, NSRoundPlain);
+      break;
+
+    case EWCCalculatorSubtractOpcode:
+      error = NSDecimalSubtract(&value, data, operand, NSRoundPlain);
+      break;
+
+    case EWCCalculatorMultiplyOpcode:
+      error = EWCDecimalMultiply(&value, data, operand);
+      break;
+
+    case EWCCalculatorDivideOpcode:
+      error = EWCDecimalDivide(&value, data, operand);
+      break;
+
+    case EWCCalculatorAddPercentOpcode:
+    case EWCCalculatorSubtractPercentOpcode:
+    case EWCCalculatorMultiplyPercentOpcode:
+      error = EWCDecimalMultiply(&rate, operand, &hundredth);
+      if (! EWCTapeCalculationSucceeded(error)) { return NO; }
+      error = EWCDecimalMultiply(&percent, &rate, data);
+      if (! EWCTapeCalculationSucceeded(error)) { return NO; }
+
+      if (opcode == EWCCalculatorAddPercentOpcode) {
+        error = NSDecimalAdd(&value, data, &percent, NSRoundPlain);
+      } else if (opcode == EWCCalculatorSubtractPercentOpcode) {
+        error = NSDecimalSubtract(&value, data, &percent, NSRoundPlain);
+      } else {
+        value = percent;
+      }
+      break;
+
+    case EWCCalculatorDividePercentOpcode:
+      error = EWCDecimalMultiply(&rate, operand, &hundredth);
+      if (! EWCTapeCalculationSucceeded(error)) { return NO; }
+      error = EWCDecimalDivide(&value, data, &rate);
+      break;
+
+    case EWCCalculatorNoOpcode:
+      // the value passes through
+      break;
+
+    default:
+      return NO;
+  }
+
+  if (! EWCTapeCalculationSucceeded(error)) {
+    return NO;
+  }
+
+  *result = value;
+
+  return YES;
+}
+
+/**
+  Writes out the keys that type a value, as digits, then the decimal and fraction digits, then the sign.
+
+  @param value The value to type.  NaN is typed as zero.
+  @param keys Receives the keys.  Must hold `EWCTapeSpellingCapacity` keys.
+
+  @return The number of keys written.
+ */
+static NSUInteger EWCTapeSpellValue(const NSDecimal *value, EWCCalculatorKey *keys) {
+  EWCDecimalDigits digits;
+  if (! EWCDecimalDigitsFromDecimal(value, &digits)) {
+    keys[0] = EWCCalculatorZeroKey;
+    return 1;
+  }
+
+  NSUInteger count = 0;
+  NSInteger whole = digits.count + digits.exponent;
+
+  if (whole <= 0) {
+    // a pure fraction, with zeros between the decimal and the first digit
+    keys[count++] = EWCCalculatorZeroKey;
+    keys[count++] = EWCCalculatorDecimalKey;
+    for (NSInteger i = whole; i < 0; ++i) {
+      keys[count++] = EWCCalculatorZeroKey;
+    }
+    for (short i = 0; i < digits.count; ++i) {
+      keys[count++] = (EWCCalculatorKey)(EWCCalculatorZeroKey + digits.digits[i]);
+    }
+  } else {
+    for (short i = 0; i < digits.count && i < whole; ++i) {
+      keys[count++] = (EWCCalculatorKey)(EWCCalculatorZeroKey + digits.digits[i]);
+    }
+    for (short i = 0; i < digits.exponent; ++i) {
+      keys[count++] = EWCCalculatorZeroKey;
+    }
+    if (whole < digits.count) {
+      keys[count++] = EWCCalculatorDecimalKey;
+      for (NSInteger i = whole; i < digits.count; ++i) {
+        keys[count++] = (EWCCalculatorKey)(EWCCalculatorZeroKey + digits.digits[i]);
+      }
+    }
+  }
+
+  if (digits.negative) {
+    keys[count++] = EWCCalculatorSignKey;
+  }
+
+  return count;
+}
+
+void EWCTapeWideResultInit(EWCTapeWideResult *result) {
+  EWCBigDecimalInit(&result->display);
+  EWCBigDecimalInit(&result->memory);
+  EWCBigDecimalInit(&result->taxRate);
+  result->hasMemory = NO;
+  result->error = NO;
+}
+
+void EWCTapeWideResultFree(EWCTapeWideResult *result) {
+  EWCBigDecimalFree(&result->display);
+  EWCBigDecimalFree(&result->memory);
+  EWCBigDecimalFree(&result->taxRate);
+}
+
+/**
+  Converts an `NSDecimal` to a big decimal.  NaN converts to zero.
+
+  @param value The value to convert.
+  @param result Receives the value.
+ */
+static void EWCTapeWideFromDecimal(const NSDecimal *value, EWCBigDecimal *result) {
+  EWCDecimalDigits digits;
+  if (! EWCDecimalDigitsFromDecimal(value, &digits)) {
+    EWCBigDecimalSetInteger(result, 0);
+    return;
+  }
+
+  EWCBigDecimalSetDigits(result, digits.digits, digits.count, digits.exponent, digits.negative);
+}
+
+/**
+  Restricts a big decimal to the maximum digits, following `-[NSDecimalNumber ewc_decimalNumberByRestrictingToDigits:]`.
+
+  @param value The value to restrict, which is updated.
+  @param maximumDigits The maximum digits, or 0 for no limit.
+
+  @return NO if the value can't fit, which puts the calculator in the error state.
+ */
+static BOOL EWCTapeWideRestrict(EWCBigDecimal *value, NSInteger maximumDigits) {
+  if (maximumDigits == 0 || EWCBigDecimalIsZero(value)) {
+    return YES;
+  }
+
+  int digits = (int)maximumDigits;
+  int magnitude = EWCBigDecimalMagnitude(value);
+
+  // below 10^-(digits - 1) underflows to zero
+  if (magnitude <= 1 - digits) {
+    EWCBigDecimalSetInteger(value, 0);
+    return YES;
+  }
+
+  // above 10^digits - 1 is too big
+  if (magnitude > digits) {
+    return NO;
+  }
+  if (magnitude == digits) {
+    EWCBigDecimal maximum, one;
+    EWCBigDecimalInit(&maximum);
+    EWCBigDecimalInit(&one);
+    EWCBigDecimalSetInteger(&one, 1);
+    EWCBigDecimalShift(&maximum, &one, digits);
+    EWCBigDecimalSubtract(&maximum, &maximum, &one);
+    BOOL tooBig = (EWCBigDecimalCompareMagnitude(value, &maximum) > 0);
+    EWCBigDecimalFree(&maximum);
+    EWCBigDecimalFree(&one);
+
+    if (tooBig) {
+      return NO;
+    }
+  }
+
+  // with no whole digits, a zero is shown before the decimal
+  int scale = (magnitude <= 0) ? digits - 1 : digits - magnitude;
+  EWCBigDecimalRoundToScale(value, value, scale);
+
+  return YES;
+}
+
+/**
+  Takes a big decimal as typing it would, keeping as many digits as the calculator accepts and dropping the rest, as the calculator ignores digit keys beyond the maximum digits.
+
+  @param result Receives the typed value.
+  @param value The value to type.
+  @param maximumDigits The maximum digits, or 0 for no limit.
+ */
+static void EWCTapeWideType(EWCBigDecimal *result, const EWCBigDecimal *value, NSInteger maximumDigits) {
+  EWCBigDecimalCopy(result, value);
+  if (maximumDigits == 0 || EWCBigDecimalIsZero(value)) {
+    return;
+  }
+
+  int digits = (int)maximumDigits;
+  int magnitude = EWCBigDecimalMagnitude(value);
+  if (magnitude > digits) {
+    // only the leading digits are typed, as a whole number
+    int dropped = magnitude - digits;
+    EWCBigDecimalTruncateToScale(result, result, -dropped);
+    EWCBigDecimalShift(result, result, -dropped);
+  } else {
+    int scale = (magnitude <= 0) ? digits - 1 : digits - magnitude;
+    EWCBigDecimalTruncateToScale(result, result, scale);
+  }
+}
+
+/**
+  Performs a binary calculator operation on big decimals, following `EWCTapeArithmetic`.
+
+  @param opcode The operation.
+  @param data The first value.
+  @param operand The second value.
+  @param result Receives the result.  It may be the same as either value.
+  @param rate A scratch value for percent operations.
+  @param precision The significant digits each calculation is rounded to.
+
+  @return NO if the operation puts the calculator in the error state.
+ */
+static BOOL EWCTapeWideArithmetic(EWCCalculatorOpcode opcode,
+  const EWCBigDecimal *data,
+  const EWCBigDecimal *operand,
+  EWCBigDecimal *result,
+  EWCBigDecimal *rate,
+  int precision) {
+
+  switch (opcode) {
+    case EWCCalculatorAddOpcode:
+      EWCBigDecimalAdd(result, data, operand);
+      break;
+
+    case EWCCalculatorSubtractOpcode:
+      EWCBigDecimalSubtract(result, data, operand);
+      break;
+
+    case EWCCalculatorMultiplyOpcode:
+      EWCBigDecimalMultiply(result, data, operand);
+      break;
+
+    case EWCCalculatorDivideOpcode:
+      return EWCBigDecimalDivide(result, data, operand, precision);
+
+    case EWCCalculatorAddPercentOpcode:
+    case EWCCalculatorSubtractPercentOpcode:
+    case EWCCalculatorMultiplyPercentOpcode:
+      // a hundredth of the operand, times the data
+      EWCBigDecimalShift(rate, operand, -2);
+      EWCBigDecimalMultiply(rate, rate, data);
+      EWCBigDecimalRound(rate, rate, precision);
+
+      if (opcode == EWCCalculatorAddPercentOpcode) {
+        EWCBigDecimalAdd(result, data, rate);
+      } else if (opcode == EWCCalculatorSubtractPercentOpcode) {
+        EWCBigDecimalSubtract(result, data, rate);
+      } else {
+        EWCBigDecimalCopy(result, rate);
+      }
+      break;
+
+    case EWCCalculatorDividePercentOpcode:
+      EWCBigDecimalShift(rate, operand, -2);
+      return EWCBigDecimalDivide(result, data, rate, precision);
+
+    case EWCCalculatorNoOpcode:
+      // the value passes through
+      EWCBigDecimalCopy(result, data);
+      break;
+
+    default:
+      return NO;
+  }
+
+  EWCBigDecimalRound(result, result, precision);
+
+  return YES;
+}
+
+@implementation EWCTapeProgram
+
+///----------------------------------------------
+/// @name Construction and Initialization Methods
+///----------------------------------------------
+
+- (instancetype)initWithKeys:(const EWCCalculatorKey *)keys
+  keyCount:(NSUInteger)keyCount
+  maximumDigits:(NSInteger)maximumDigits
+  instructions:(const EWCTapeInstruction *)instructions
+  instructionCount:(NSUInteger)instructionCount
+  slots:(const EWCTapeSlot *)slots
+  slotCount:(NSUInteger)slotCount {
+
+  self = [super init];
+  if (self) {
+    _keys = [NSData dataWithBytes:keys length:keyCount * sizeof(EWCCalculatorKey)];
+    _instructions = [NSData dataWithBytes:instructions length:instructionCount * sizeof(EWCTapeInstruction)];
+    _slots = [NSData dataWithBytes:slots length:slotCount * sizeof(EWCTapeSlot)];
+    _keyCount = keyCount;
+    _instructionCount = instructionCount;
+    _slotCount = slotCount;
+    _maximumDigits = maximumDigits;
+    _startingTaxRate = [NSDecimalNumber zero];
+    _startingMemory = [NSDecimalNumber zero];
+    _usesWideArithmetic = (maximumDigits > EWCBigDecimalNativeDigits);
+
+    for (NSUInteger i = 0; i < instructionCount; ++i) {
+      if (instructions[i].operation == EWCTapeBailOperation) {
+        _alwaysReplays = YES;
+      }
+    }
+  }
+
+  return self;
+}
+
+- (void)dealloc {
+  if (_wideRegisters) {
+    for (NSInteger i = 0; i < EWCTapeWideRegisterCount; ++i) {
+      EWCBigDecimalFree(&_wideRegisters[i]);
+    }
+    free(_wideRegisters);
+  }
+}
+
+///--------------------
+/// @name Input Methods
+///--------------------
+
+- (void)getTemplateInputs:(NSDecimal *)inputs {
+  const EWCTapeSlot *slots = _slots.bytes;
+  for (NSUInteger i = 0; i < _slotCount; ++i) {
+    inputs[i] = slots[i].templateValue;
+  }
+}
+
+///------------------
+/// @name Run Methods
+///------------------
+
+- (void)runWithInputs:(const NSDecimal *)inputs result:(EWCTapeResult *)result {
+  if (! [self executeWithInputs:inputs result:result]) {
+    [self replayKeysWithInputs:inputs result:result];
+  }
+}
+
+- (void)runWithInputVectors:(const NSDecimal *)inputs
+  count:(NSUInteger)count
+  results:(EWCTapeResult *)results {
+
+  for (NSUInteger i = 0; i < count; ++i) {
+    @autoreleasepool {
+      [self runWithInputs:inputs + i * _slotCount result:&results[i]];
+    }
+  }
+}
+
+/**
+  Stores a value into memory, as the calculator does.  A value too wide for the display puts the calculator in the error state, and a zero value clears the memory.
+
+  @param value The value to store.
+  @param registers The registers to update.
+  @param empty Receives whether the memory is left empty.
+
+  @return NO if the calculator would enter the error state.
+ */
+- (BOOL)storeMemory:(NSDecimal)value registers:(NSDecimal *)registers empty:(BOOL *)empty {
+  if (! EWCTapeRestrict(&value, _maximumDigits)) {
+    return NO;
+  }
+
+  NSDecimal zero = registers[EWCTapeZeroRegister];
+  if (NSDecimalCompare(&value, &zero) == NSOrderedSame) {
+    registers[EWCTapeMemoryRegister] = zero;
+    *empty = YES;
+  } else {
+    registers[EWCTapeMemoryRegister] = value;
+    *empty = NO;
+  }
+
+  return YES;
+}
+
+/**
+  Runs the instructions over one set of inputs.
+
+  @param inputs The values for each slot.
+  @param result Receives the results, if the run completes.
+
+  @return NO if the run met a case that the instructions don't handle (which means the calculator would be in the error state or the inputs couldn't be typed as given), in which case the keys must be replayed instead.
+ */
+- (BOOL)executeWithInputs:(const NSDecimal *)inputs result:(EWCTapeResult *)result {
+  NSDecimal registers[EWCTapeRegisterCount];
+  NSDecimal zero = EWCCalculatorDecimalZero();
+  NSDecimal one = [NSDecimalNumber one].decimalValue;
+  for (NSInteger i = 0; i < EWCTapeRegisterCount; ++i) {
+    registers[i] = zero;
+  }
+  registers[EWCTapeOneRegister] = one;
+  registers[EWCTapeTaxRateRegister] = _startingTaxRate.decimalValue;
+
+  BOOL memoryEmpty = YES;
+  if (! [self storeMemory:_startingMemory.decimalValue registers:registers empty:&memoryEmpty]) {
+    return NO;
+  }
+
+  NSDecimal *display = &registers[EWCTapeDisplayRegister];
+  NSDecimal hundredth = EWCTapeHundredth();
+
+  const EWCTapeInstruction *instructions = _instructions.bytes;
+  for (NSUInteger i = 0; i < _instructionCount; ++i) {
+    const EWCTapeInstruction *instruction = &instructions[i];
+
+    switch (instruction->operation) {
+      case EWCTapeLoadSlotOperation: {
+        // the input must be exactly what typing it would give
+        NSDecimal value = inputs[instruction->source];
+        NSDecimal restricted = value;
+        if (! EWCTapeRestrict(&restricted, _maximumDigits)
+          || NSDecimalCompare(&restricted, &value) != NSOrderedSame) {
+          return NO;
+        }
+        *display = value;
+        break;
+      }
+
+      case EWCTapeMoveOperation:
+        registers[instruction->destination] = registers[instruction->source];
+        break;
+
+      case EWCTapeClearOperation:
+        registers[instruction->destination] = zero;
+        break;
+
+      case EWCTapeDisplayOperation: {
+        NSDecimal value = registers[instruction->source];
+        if (! EWCTapeRestrict(&value, _maximumDigits)) {
+          return NO;
+        }
+        *display = value;
+        break;
+      }
+
+      case EWCTapeArithmeticOperation:
+        if (! EWCTapeArithmetic(instruction->opcode,
+          &registers[instruction->source],
+          &registers[instruction->operand],
+          &registers[instruction->destination])) {
+          return NO;
+        }
+        break;
+
+      case EWCTapeNegateOperation:
+        if (NSDecimalCompare(display, &zero) != NSOrderedSame) {
+          NSDecimal value = *display;
+          NSDecimalSubtract(display, &zero, &value, NSRoundPlain);
+        }
+        break;
+
+      case EWCTapeSqrtOperation: {
+        if (NSDecimalCompare(display, &zero) == NSOrderedAscending) {
+          return NO;
+        }
+        NSDecimal value = [[NSDecimalNumber decimalNumberWithDecimal:*display]
+          ewc_decimalNumberBySqrt].decimalValue;
+        if (! EWCTapeRestrict(&value, _maximumDigits)) {
+          return NO;
+        }
+        *display = value;
+        break;
+      }
+
+      case EWCTapeTaxPlusOperation: {
+        NSDecimal multiplier, tax, withTax;
+        if (! EWCTapeCalculationSucceeded(EWCDecimalMultiply(&multiplier, &registers[EWCTapeTaxRateRegister], &hundredth))
+          || ! EWCTapeCalculationSucceeded(EWCDecimalMultiply(&tax, display, &multiplier))
+          || ! EWCTapeCalculationSucceeded(NSDecimalAdd(&withTax, display, &tax, NSRoundPlain))) {
+          return NO;
+        }
+        registers[EWCTapeTaxWithTaxRegister] = withTax;
+        registers[EWCTapeTaxJustTaxRegister] = tax;
+        break;
+      }
+
+      case EWCTapeTaxMinusOperation: {
+        NSDecimal rate, multiplier, tax, withTax;
+        if (! EWCTapeCalculationSucceeded(EWCDecimalMultiply(&rate, &registers[EWCTapeTaxRateRegister], &hundredth))
+          || ! EWCTapeCalculationSucceeded(NSDecimalAdd(&multiplier, &rate, &one, NSRoundPlain))
+          || NSDecimalCompare(&multiplier, &zero) == NSOrderedSame
+          || ! EWCTapeCalculationSucceeded(EWCDecimalDivide(&withTax, display, &multiplier))
+          || ! EWCTapeCalculationSucceeded(NSDecimalSubtract(&tax, display, &withTax, NSRoundPlain))) {
+          return NO;
+        }
+        registers[EWCTapeTaxWithTaxRegister] = withTax;
+        registers[EWCTapeTaxJustTaxRegister] = tax;
+        break;
+      }
+
+      case EWCTapeMemoryAddOperation:
+      case EWCTapeMemorySubtractOperation: {
+        NSDecimal value;
+        NSCalculationError error = (instruction->operation == EWCTapeMemoryAddOperation)
+          ? NSDecimalAdd(&value, &registers[EWCTapeMemoryRegister], display, NSRoundPlain)
+          : NSDecimalSubtract(&value, &registers[EWCTapeMemoryRegister], display, NSRoundPlain);
+        if (! EWCTapeCalculationSucceeded(error)
+          || ! [self storeMemory:value registers:registers empty:&memoryEmpty]) {
+          return NO;
+        }
+        break;
+      }
+
+      case EWCTapeMemoryClearOperation:
+        registers[EWCTapeMemoryRegister] = zero;
+        memoryEmpty = YES;
+        break;
+
+      case EWCTapeBailOperation:
+        return NO;
+    }
+  }
+
+  result->display = *display;
+  result->memory = registers[EWCTapeMemoryRegister];
+  result->taxRate = registers[EWCTapeTaxRateRegister];
+  result->hasMemory = ! memoryEmpty;
+  result->error = NO;
+  result->replayed = NO;
+
+  return YES;
+}
+
+- (void)replayKeysWithInputs:(const NSDecimal *)inputs result:(EWCTapeResult *)result {
+  if (! _calculator) {
+    _calculator = [EWCCalculator calculator];
+    _calculator.maximumDigits = _maximumDigits;
+    _replayKeys = [NSMutableData new];
+  }
+
+  // build the keys with the inputs typed in place of the tape's numbers
+  const EWCCalculatorKey *keys = _keys.bytes;
+  const EWCTapeSlot *slots = _slots.bytes;
+  EWCCalculatorKey spelling[EWCTapeSpellingCapacity];
+
+  _replayKeys.length = 0;
+  NSUInteger next = 0;
+  for (NSUInteger i = 0; i < _slotCount; ++i) {
+    [_replayKeys appendBytes:&keys[next] length:(slots[i].keyIndex - next) * sizeof(EWCCalculatorKey)];
+
+    NSUInteger count = EWCTapeSpellValue(&inputs[i], spelling);
+    [_replayKeys appendBytes:spelling length:count * sizeof(EWCCalculatorKey)];
+
+    next = slots[i].keyIndex + slots[i].keyCount;
+  }
+  [_replayKeys appendBytes:&keys[next] length:(_keyCount - next) * sizeof(EWCCalculatorKey)];
+
+  [_calculator reset];
+  _calculator.dataProvider = [EWCCalculatorMemoryData dataWithTaxRate:_startingTaxRate
+    memory:_startingMemory];
+
+  const EWCCalculatorKey *replayKeys = _replayKeys.bytes;
+  NSUInteger replayCount = _replayKeys.length / sizeof(EWCCalculatorKey);
+  for (NSUInteger i = 0; i < replayCount; ++i) {
+    [_calculator pressKey:replayKeys[i]];
+  }
+
+  result->display = _calculator.displayValue.decimalValue;
+  result->memory = _calculator.memoryValue.decimalValue;
+  result->taxRate = _calculator.taxRateValue.decimalValue;
+  result->hasMemory = _calculator.hasMemory;
+  result->error = _calculator.hasError;
+  result->replayed = YES;
+}
+
+
+///-----------------------
+/// @name Wide Run Methods
+///-----------------------
+
+- (void)getWideTemplateInputs:(EWCBigDecimal *)inputs {
+  const EWCTapeSlot *slots = _slots.bytes;
+  for (NSUInteger i = 0; i < _slotCount; ++i) {
+    EWCTapeWideFromDecimal(&slots[i].templateValue, &inputs[i]);
+  }
+}
+
+- (void)runWithWideInputs:(const EWCBigDecimal *)inputs result:(EWCTapeWideResult *)result {
+  if (! _wideRegisters) {
+    _wideRegisters = malloc(sizeof(EWCBigDecimal) * EWCTapeWideRegisterCount);
+    for (NSInteger i = 0; i < EWCTapeWideRegisterCount; ++i) {
+      EWCBigDecimalInit(&_wideRegisters[i]);
+    }
+  }
+
+  EWCBigDecimal *registers = _wideRegisters;
+  for (NSInteger i = 0; i < EWCTapeWideRegisterCount; ++i) {
+    EWCBigDecimalSetInteger(&registers[i], 0);
+  }
+  EWCBigDecimalSetInteger(&registers[EWCTapeOneRegister], 1);
+
+  NSDecimal taxRate = _startingTaxRate.decimalValue;
+  NSDecimal memory = _startingMemory.decimalValue;
+  EWCTapeWideFromDecimal(&taxRate, &registers[EWCTapeTaxRateRegister]);
+  EWCTapeWideFromDecimal(&memory, &registers[EWCTapeWideValueRegister]);
+
+  BOOL memoryEmpty = YES;
+  BOOL completed = [self storeWideMemoryWithRegisters:registers empty:&memoryEmpty]
+    && [self executeWideWithInputs:inputs registers:registers memoryEmpty:&memoryEmpty];
+
+  EWCBigDecimalCopy(&result->display, &registers[EWCTapeDisplayRegister]);
+  EWCBigDecimalCopy(&result->memory, &registers[EWCTapeMemoryRegister]);
+  EWCBigDecimalCopy(&result->taxRate, &registers[EWCTapeTaxRateRegister]);
+  result->hasMemory = ! memoryEmpty;
+  result->error = ! completed;
+}
+
+/**
+  Stores the wide value register into memory, following `-storeMemory:registers:empty:`.
+
+  @param registers The wide registers to update.
+  @param empty Receives whether the memory is left empty.
+
+  @return NO if the calculator would enter the error state.
+ */
+- (BOOL)storeWideMemoryWithRegisters:(EWCBigDecimal *)registers empty:(BOOL *)empty {
+  EWCBigDecimal *value = &registers[EWCTapeWideValueRegister];
+  if (! EWCTapeWideRestrict(value, _maximumDigits)) {
+    return NO;
+  }
+
+  EWCBigDecimalCopy(&registers[EWCTapeMemoryRegister], value);
+  *empty = EWCBigDecimalIsZero(value);
+
+  return YES;
+}
+
+/**
+  Runs the instructions over one set of inputs using big decimals, following `-executeWithInputs:result:`.
+
+  @param inputs The values for each slot.
+  @param registers The wide registers, set up for the start of the run.
+  @param memoryEmpty Tracks whether the memory is empty.
+
+  @return NO if the calculator would enter the error state.
+ */
+- (BOOL)executeWideWithInputs:(const EWCBigDecimal *)inputs
+  registers:(EWCBigDecimal *)registers
+  memoryEmpty:(BOOL *)memoryEmpty {
+
+  int precision = (int)((_maximumDigits > 0) ? _maximumDigits : EWCBigDecimalNativeDigits) + EWCTapeWideGuardDigits;
+  EWCBigDecimal *display = &registers[EWCTapeDisplayRegister];
+  EWCBigDecimal *value = &registers[EWCTapeWideValueRegister];
+  EWCBigDecimal *rate = &registers[EWCTapeWideRateRegister];
+  EWCBigDecimal *part = &registers[EWCTapeWidePartRegister];
+
+  const EWCTapeInstruction *instructions = _instructions.bytes;
+  for (NSUInteger i = 0; i < _instructionCount; ++i) {
+    const EWCTapeInstruction *instruction = &instructions[i];
+
+    switch (instruction->operation) {
+      case EWCTapeLoadSlotOperation:
+        EWCTapeWideType(display, &inputs[instruction->source], _maximumDigits);
+        break;
+
+      case EWCTapeMoveOperation:
+        EWCBigDecimalCopy(&registers[instruction->destination], &registers[instruction->source]);
+        break;
+
+      case EWCTapeClearOperation:
+        EWCBigDecimalSetInteger(&registers[instruction->destination], 0);
+        break;
+
+      case EWCTapeDisplayOperation:
+        EWCBigDecimalCopy(value, &registers[instruction->source]);
+        if (! EWCTapeWideRestrict(value, _maximumDigits)) {
+          return NO;
+        }
+        EWCBigDecimalCopy(display, value);
+        break;
+
+      case EWCTapeArithmeticOperation:
+        if (! EWCTapeWideArithmetic(instruction->opcode,
+          &registers[instruction->source],
+          &registers[instruction->operand],
+          &registers[instruction->destination],
+          rate,
+          precision)) {
+          return NO;
+        }
+        break;
+
+      case EWCTapeNegateOperation:
+        EWCBigDecimalNegate(display, display);
+        break;
+
+      case EWCTapeSqrtOperation:
+        if (! EWCBigDecimalSqrt(display, display, precision)
+          || ! EWCTapeWideRestrict(display, _maximumDigits)) {
+          return NO;
+        }
+        break;
+
+      case EWCTapeTaxPlusOperation:
+        EWCBigDecimalShift(rate, &registers[EWCTapeTaxRateRegister], -2);
+        EWCBigDecimalMultiply(part, display, rate);
+        EWCBigDecimalRound(part, part, precision);
+        EWCBigDecimalAdd(&registers[EWCTapeTaxWithTaxRegister], display, part);
+        EWCBigDecimalRound(&registers[EWCTapeTaxWithTaxRegister], &registers[EWCTapeTaxWithTaxRegister], precision);
+        EWCBigDecimalCopy(&registers[EWCTapeTaxJustTaxRegister], part);
+        break;
+
+      case EWCTapeTaxMinusOperation:
+        EWCBigDecimalShift(rate, &registers[EWCTapeTaxRateRegister], -2);
+        EWCBigDecimalAdd(rate, rate, &registers[EWCTapeOneRegister]);
+        if (! EWCBigDecimalDivide(part, display, rate, precision)) {
+          return NO;
+        }
+        EWCBigDecimalSubtract(&registers[EWCTapeTaxJustTaxRegister], display, part);
+        EWCBigDecimalRound(&registers[EWCTapeTaxJustTaxRegister], &registers[EWCTapeTaxJustTaxRegister], precision);
+        EWCBigDecimalCopy(&registers[EWCTapeTaxWithTaxRegister], part);
+        break;
+
+      case EWCTapeMemoryAddOperation:
+      case EWCTapeMemorySubtractOperation:
+        if (instruction->operation == EWCTapeMemoryAddOperation) {
+          EWCBigDecimalAdd(value, &registers[EWCTapeMemoryRegister], display);
+        } else {
+          EWCBigDecimalSubtract(value, &registers[EWCTapeMemoryRegister], display);
+        }
+        if (! [self storeWideMemoryWithRegisters:registers empty:memoryEmpty]) {
+          return NO;
+        }
+        break;
+
+      case EWCTapeMemoryClearOperation:
+        EWCBigDecimalSetInteger(&registers[EWCTapeMemoryRegister], 0);
+        *memoryEmpty = YES;
+        break;
+
+      case EWCTapeBailOperation:
+        return NO;
+    }
+  }
+
+  return YES;
+}
+
+@end
@@ -0,0 +1,252 @@
+//
+//  EWCTraceBuffer.c
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "EWCTraceBuffer.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// the names of the stages, in the order of the EWCTraceStage values
+static const char * const s_stageNames[EWCTraceStageCount] = {
+  "input",
+  "enqueue",
+  "parseQueue",
+  "arithmetic",
+  "setDisplay",
+  "format",
+  "callback",
+};
+
+bool EWCTraceBufferInit(EWCTraceBuffer *buffer, uint32_t capacity) {
+  memset(buffer, 0, sizeof(*buffer));
+
+  if (capacity < 1) {
+    return false;
+  }
+
+  buffer->records = calloc(capacity, sizeof(EWCTraceKeyRecord));
+  if (! buffer->records) {
+    return false;
+  }
+
+  buffer->capacity = capacity;
+
+  return true;
+}
+
+void EWCTraceBufferFree(EWCTraceBuffer *buffer) {
+  free(buffer->records);
+  buffer->records = NULL;
+  buffer->capacity = 0;
+  buffer->keyCount = 0;
+}
+
+void EWCTraceBufferClear(EWCTraceBuffer *buffer) {
+  buffer->keyCount = 0;
+  buffer->inKey = false;
+  buffer->frozen = false;
+  buffer->slowestDuration = 0;
+  buffer->slowestSequence = 0;
+}
+
+void EWCTraceBufferSetFreezeThreshold(EWCTraceBuffer *buffer, uint64_t nanoseconds) {
+  buffer->freezeThreshold = nanoseconds;
+}
+
+uint64_t EWCTraceBufferNow(void) {
+#if defined(__APPLE__)
+  return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+#endif
+}
+
+/**
+  Gets the record of the latest input.
+
+  @param buffer The buffer, which must have begun an input.
+
+  @return The record.
+ */
+static EWCTraceKeyRecord *EWCTraceBufferLatest(EWCTraceBuffer *buffer) {
+  return &buffer->records[(buffer->keyCount - 1) % buffer->capacity];
+}
+
+void EWCTraceBufferBeginKey(EWCTraceBuffer *buffer, int32_t key, char label) {
+  if (buffer->frozen) {
+    return;
+  }
+
+  if (buffer->inKey) {
+    EWCTraceBufferEndKey(buffer);
+    if (buffer->frozen) {
+      return;
+    }
+  }
+
+  EWCTraceKeyRecord *record = &buffer->records[buffer->keyCount % buffer->capacity];
+  record->sequence = buffer->keyCount;
+  record->key = key;
+  record->label = label;
+  record->duration = 0;
+  record->spanCount = 0;
+  record->droppedSpanCount = 0;
+
+  ++buffer->keyCount;
+  buffer->inKey = true;
+
+  // read the clock last, so that setting up the record isn't counted
+  record->start = EWCTraceBufferNow();
+}
+
+void EWCTraceBufferEndKey(EWCTraceBuffer *buffer) {
+  uint64_t end = EWCTraceBufferNow();
+
+  if (buffer->frozen || ! buffer->inKey) {
+    return;
+  }
+
+  EWCTraceKeyRecord *record = EWCTraceBufferLatest(buffer);
+  record->duration = (end > record->start) ? end - record->start : 1;
+  buffer->inKey = false;
+
+  if (record->duration > buffer->slowestDuration) {
+    buffer->slowestDuration = record->duration;
+    buffer->slowestSequence = record->sequence;
+  }
+
+  if (buffer->freezeThreshold && record->duration >= buffer->freezeThreshold) {
+    buffer->frozen = true;
+  }
+}
+
+void EWCTraceBufferAddSpan(EWCTraceBuffer *buffer, EWCTraceStage stage, uint64_t start, uint64_t end) {
+  if (buffer->frozen || buffer->keyCount == 0) {
+    return;
+  }
+
+  EWCTraceKeyRecord *record = EWCTraceBufferLatest(buffer);
+  if (record->spanCount >= EWCTraceMaxSpansPerKey) {
+    ++record->droppedSpanCount;
+    return;
+  }
+
+  uint64_t duration = (end > start) ? end - start : 0;
+
+  EWCTraceSpan *span = &record->spans[record->spanCount++];
+  span->start = start;
+  span->duration = (duration > UINT32_MAX) ? UINT32_MAX : (uint32_t)duration;
+  span->stage = (uint16_t)stage;
+}
+
+uint32_t EWCTraceBufferKeyCount(const EWCTraceBuffer *buffer) {
+  return (buffer->keyCount < buffer->capacity) ? (uint32_t)buffer->keyCount : buffer->capacity;
+}
+
+const EWCTraceKeyRecord *EWCTraceBufferKeyAtIndex(const EWCTraceBuffer *buffer, uint32_t index) {
+  uint32_t count = EWCTraceBufferKeyCount(buffer);
+  if (index >= count) {
+    return NULL;
+  }
+
+  uint64_t sequence = buffer->keyCount - count + index;
+  return &buffer->records[sequence % buffer->capacity];
+}
+
+const char *EWCTraceStageName(EWCTraceStage stage) {
+  return ((unsigned)stage < EWCTraceStageCount) ? s_stageNames[stage] : "unknown";
+}
+
+/**
+  Writes one complete event.
+
+  @param file The file to write to.
+  @param name The name of the event, which must not need escaping.
+  @param start The start of the event, in nanoseconds from the start of the trace.
+  @param duration The duration of the event, in nanoseconds.
+  @param sequence The sequence number of the input the event belongs to.
+
+  @return Whether the event was written.
+ */
+static bool EWCTraceBufferWriteEvent(FILE *file, const char *name,
+  uint64_t start, uint64_t duration, uint64_t sequence) {
+
+  return fprintf(file,
+    ",\n{\"name\":\"%s\",\"cat\":\"calculator\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+    "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"sequence\":%llu}}",
+    name,
+    start / 1000.0,
+    duration / 1000.0,
+    (unsigned long long)sequence) > 0;
+}
+
+bool EWCTraceBufferWriteJSON(const EWCTraceBuffer *buffer, FILE *file) {
+  bool ok = fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[") > 0;
+
+  uint32_t count = EWCTraceBufferKeyCount(buffer);
+  const EWCTraceKeyRecord *oldest = EWCTraceBufferKeyAtIndex(buffer, 0);
+  uint64_t origin = oldest ? oldest->start : 0;
+
+  // the track name shows in the viewer in place of the thread id
+  ok = ok && fprintf(file,
+    "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"calculator\"}}") > 0;
+
+  for (uint32_t i = 0; i < count && ok; ++i) {
+    const EWCTraceKeyRecord *record = EWCTraceBufferKeyAtIndex(buffer, i);
+
+    // name the input by its key, escaping the characters JSON won't take bare
+    char name[16];
+    if (record->key == EWCTraceInputKey) {
+      snprintf(name, sizeof(name), "input");
+    } else if (record->label == '"' || record->label == '\\') {
+      snprintf(name, sizeof(name), "key \\%c", record->label);
+    } else if (record->label > ' ' && record->label < 127) {
+      snprintf(name, sizeof(name), "key %c", record->label);
+    } else {
+      snprintf(name, sizeof(name), "key %d", (int)record->key);
+    }
+
+    // an input still in progress runs to its last span
+    uint64_t duration = record->duration;
+    if (! duration) {
+      for (uint16_t s = 0; s < record->spanCount; ++s) {
+        uint64_t end = record->spans[s].start + record->spans[s].duration;
+        duration = (end > record->start + duration) ? end - record->start : duration;
+      }
+    }
+
+    ok = EWCTraceBufferWriteEvent(file, name, record->start - origin, duration, record->sequence);
+
+    for (uint16_t s = 0; s < record->spanCount && ok; ++s) {
+      const EWCTraceSpan *span = &record->spans[s];
+      ok = EWCTraceBufferWriteEvent(file, EWCTraceStageName(span->stage),
+        span->start - origin, span->duration, record->sequence);
+    }
+  }
+
+  ok = ok && fprintf(file, "\n]}\n") > 0;
+
+  return ok;
+}
@@ -0,0 +1,222 @@
+//
+//  EWCTraceBuffer.h
+//  EbbyCalc
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef EWCTraceBuffer_h
+#define EWCTraceBuffer_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// the most stage spans recorded for one key.  Further spans are counted, but
+// not kept.
+#define EWCTraceMaxSpansPerKey 32
+
+// the key recorded for an explicitly set input, which has no key of its own
+#define EWCTraceInputKey -1
+
+/**
+  `EWCTraceStage` identifies the stages of processing a calculator input that are timed.
+ */
+typedef enum {
+  EWCTraceInputStage = 0,  // building up a number from digit, decimal, sign, and backspace keys
+  EWCTraceEnqueueStage,  // adding the completed number and the operation to the token queue
+  EWCTraceParseStage,  // parsing the token queue for a complete operation, and performing it
+  EWCTraceArithmeticStage,  // the arithmetic of an operation
+  EWCTraceDisplayStage,  // clamping a result to the display digits
+  EWCTraceFormatStage,  // formatting the display value for the screen or VoiceOver
+  EWCTraceCallbackStage,  // notifying the update callback and change observers
+  EWCTraceStageCount,
+} EWCTraceStage;
+
+/**
+  `EWCTraceSpan` is the time spent in one stage.
+ */
+typedef struct {
+  uint64_t start;  // the monotonic time the stage started, in nanoseconds
+  uint32_t duration;  // the time spent in the stage, in nanoseconds
+  uint16_t stage;  // the `EWCTraceStage`
+} EWCTraceSpan;
+
+/**
+  `EWCTraceKeyRecord` is the timeline of a single input.
+ */
+typedef struct {
+  uint64_t sequence;  // the number of inputs begun before this one
+  int32_t key;  // the key pressed, or `EWCTraceInputKey`
+  char label;  // a printable character naming the key, or 0
+  uint64_t start;  // the monotonic time the input started, in nanoseconds
+  uint64_t duration;  // the time taken by the input, in nanoseconds, or 0 while in progress
+  uint16_t spanCount;  // the number of spans kept
+  uint16_t droppedSpanCount;  // the number of spans not kept, for lack of room
+  EWCTraceSpan spans[EWCTraceMaxSpansPerKey];  // the stage spans, in the order they ended
+} EWCTraceKeyRecord;
+
+/**
+  `EWCTraceBuffer` keeps the stage timelines of the last several inputs to a calculator, so that a slow key can be examined after the fact.
+
+  The records are kept in a ring, overwriting the oldest, so recording never allocates.  Spans that end once an input is finished (such as formatting the display from the update callback of a later batch) are added to the latest input.
+
+  A buffer can be frozen by an input slower than a threshold, after which nothing more is recorded, so that the slow input and the inputs leading up to it are kept until they are written out.
+
+  A buffer must only be used from one thread at a time, as is the calculator it traces.
+ */
+typedef struct {
+  EWCTraceKeyRecord *records;  // the ring of input records
+  uint32_t capacity;  // the number of records in the ring
+  uint64_t keyCount;  // the number of inputs begun
+  bool inKey;  // whether the latest input is in progress
+  uint64_t freezeThreshold;  // the duration of an input that freezes the buffer, in nanoseconds, or 0 to never freeze
+  bool frozen;  // whether recording has stopped
+  uint64_t slowestDuration;  // the longest input recorded, in nanoseconds
+  uint64_t slowestSequence;  // the sequence number of the longest input recorded
+} EWCTraceBuffer;
+
+/**
+  Sets up an empty buffer.
+
+  @param buffer The buffer to set up.
+  @param capacity The number of inputs to keep (at least 1).
+
+  @return Whether the records could be allocated.  If not, the buffer is left empty, and must not be used.
+ */
+bool EWCTraceBufferInit(EWCTraceBuffer *buffer, uint32_t capacity);
+
+/**
+  Releases the records of a buffer.
+
+  @param buffer The buffer.
+ */
+void EWCTraceBufferFree(EWCTraceBuffer *buffer);
+
+/**
+  Discards everything recorded, and thaws a frozen buffer.  The freeze threshold is kept.
+
+  @param buffer The buffer.
+ */
+void EWCTraceBufferClear(EWCTraceBuffer *buffer);
+
+/**
+  Sets how slow an input must be to freeze the buffer.
+
+  @param buffer The buffer.
+  @param nanoseconds The duration, or 0 to never freeze.
+ */
+void EWCTraceBufferSetFreezeThreshold(EWCTraceBuffer *buffer, uint64_t nanoseconds);
+
+/**
+  Reads the monotonic clock the spans are timed by.
+
+  @return The time, in nanoseconds.
+ */
+uint64_t EWCTraceBufferNow(void);
+
+/**
+  Starts recording an input.  An input still in progress is ended first.
+
+  @param buffer The buffer.
+  @param key The key pressed, or `EWCTraceInputKey`.
+  @param label A printable character naming the key, or 0.
+ */
+void EWCTraceBufferBeginKey(EWCTraceBuffer *buffer, int32_t key, char label);
+
+/**
+  Finishes recording the input in progress, freezing the buffer if it was slower than the threshold.
+
+  @param buffer The buffer.
+ */
+void EWCTraceBufferEndKey(EWCTraceBuffer *buffer);
+
+/**
+  Adds a stage span to the latest input.  Spans before any input has begun are ignored.
+
+  @param buffer The buffer.
+  @param stage The stage.
+  @param start The time the stage started, from `EWCTraceBufferNow`.
+  @param end The time the stage ended, from `EWCTraceBufferNow`.
+ */
+void EWCTraceBufferAddSpan(EWCTraceBuffer *buffer, EWCTraceStage stage, uint64_t start, uint64_t end);
+
+/**
+  Gets the number of inputs held.
+
+  @param buffer The buffer.
+
+  @return The number of records, at most the capacity.
+ */
+uint32_t EWCTraceBufferKeyCount(const EWCTraceBuffer *buffer);
+
+/**
+  Gets an input held by a buffer.
+
+  @param buffer The buffer.
+  @param index The index of the input, from 0 for the oldest held.
+
+  @return The record, or NULL if the index is out of range.
+ */
+const EWCTraceKeyRecord *EWCTraceBufferKeyAtIndex(const EWCTraceBuffer *buffer, uint32_t index);
+
+/**
+  Gets the name of a stage, as it appears in a written trace.
+
+  @param stage The stage.
+
+  @return The name.
+ */
+const char *EWCTraceStageName(EWCTraceStage stage);
+
+/**
+  Writes the inputs held as a Chrome trace event JSON document, which can be opened by Perfetto (ui.perfetto.dev) or chrome://tracing.
+
+  Each input, and each stage within it, is written as a complete ("X") event on a single track, with times in microseconds from the oldest input held.
+
+  @param buffer The buffer.
+  @param file The file to write to.
+
+  @return Whether everything was written.
+ */
+bool EWCTraceBufferWriteJSON(const EWCTraceBuffer *buffer, FILE *file);
+
+/**
+  Starts timing a stage, if tracing.
+
+  @param buffer The buffer, or NULL if not tracing.
+
+  @return The start time to pass to `EWCTraceBufferFinish`.
+ */
+static inline uint64_t EWCTraceBufferStart(EWCTraceBuffer *buffer) {
+  return buffer ? EWCTraceBufferNow() : 0;
+}
+
+/**
+  Finishes timing a stage, if tracing.
+
+  @param buffer The buffer, or NULL if not tracing.
+  @param stage The stage.
+  @param start The time from `EWCTraceBufferStart`.
+ */
+static inline void EWCTraceBufferFinish(EWCTraceBuffer *buffer, EWCTraceStage stage, uint64_t start) {
+  if (buffer) {
+    EWCTraceBufferAddSpan(buffer, stage, start, EWCTraceBufferNow());
+  }
+}
+
+#endif /* EWCTraceBuffer_h */
@@ -80,6 +80,10 @@
   // Called as the scene transitions from the foreground to the background.
   // Use this method to save data, release shared resources, and store enough scene-specific state information
   // to restore the scene back to its current state.
+
+  [_viewController flushKeyRecording];
+  [_viewController flushSharedData];
+  [_viewController suspendKeyClicks];
 }
 
 
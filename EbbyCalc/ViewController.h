@@ -58,6 +58,21 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)refreshSettings;
 
+/**
+  Writes out any calculator inputs recorded but not yet saved.  Recording is enabled in the app settings.
+ */
+- (void)flushKeyRecording;
+
+/**
+  Writes out any tax rate or memory changes not yet saved to the user defaults.
+ */
+- (void)flushSharedData;
+
+/**
+  Stops the audio output for the key clicks while the app isn't visible.  It starts again when the settings are next refreshed.
+ */
+- (void)suspendKeyClicks;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -19,80 +19,33 @@
 //  You should have received a copy of the GNU General Public License
 //  along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
-#import <AVFoundation/AVFoundation.h>
 
 #import "ViewController.h"
 
 #import "EWCGridLayoutView.h"
+#import "EWCLayoutSolver.h"
 #import "EWCRoundedCornerButton.h"
 #import "EWCCalculator.h"
-#import "EWCCalculatorUserDefaultsData.h"
+#import "EWCCalculatorSharedData.h"
+#import "EWCKeyStreamRecorder.h"
+#import "EWCKeySoundEngine.h"
+#import "EWCAudioEngineKeySoundBackend.h"
+#import "EWCAnnouncementScheduler.h"
+#import "EWCDispatchAnnouncementClock.h"
 #import "EWCLabelEditManager.h"
 #import "EWCCopyableLabel.h"
 #import "EWCKeyCommandCalculatorRecord.h"
-
-/**
-  `EWCApplicationLayout` represents the orientation of the application layout.
-*/
-typedef NS_ENUM(NSInteger, EWCApplicationLayout) {
-  EWCApplicationDefaultLayout = 0,
-  EWCApplicationWideLayout = 1,
-  EWCApplicationTallLayout,
-};
-
-/**
-  `EWCLayoutConstants` groups several values used for UI layout that can change according to the layout
- */
-typedef struct {
-  /**
-    Used to calculate the text button font size using the current minimum dimension.
-   */
-  const float textSizeAsPercentOfHeight;
-
-  /**
-    Used to calculate the status indicator font size using the current minimum dimension.
-   */
-  const float statusSizeAsPercentOfHeight;
-
-  /**
-    Used to calculate the digit button font size using the current minimum dimension.
-   */
-  const float digitSizeAsPercentOfHeight;
-
-  /**
-    Used to calculate the text button font size using the current minimum dimension.
-   */
-  const float operatorSizeAsPercentOfHeight;
-
-  /**
-    Used to calculate the display font size using the current minimum dimension.
-   */
-  const float displaySizeAsPercentOfHeight;
-
-  /**
-    Used to calculate the display height from the font size it will need to display.
-   */
-  const float displayHeightFromFontSize;
-
-  /**
-    The minimum spacing between button rows as a percentage of height.
-   */
-  const float minimumRowGutter;
-
-  /**
-    The minimum spacing between button columns as a percentage of width.
-   */
-  const float minimumColumnGutter;
-} EWCLayoutConstants;
+#import "EWCKeyMap.h"
+#import "EWCKeyRing.h"
 
 @interface ViewController () {
   IBOutlet EWCGridLayoutView *_grid;  // the control the performs the grid layout logic
   IBOutlet EWCCopyableLabel *_displayArea;  // the control presenting the calculator display, enabled for copy and paste
   IBOutlet NSLayoutConstraint *_gridTopConstraint;  // the constraint used to set the top of the grid
   IBOutlet NSLayoutConstraint *_gridBottomConstraint;  // used to read the constraint constant of the bottom of the grid
-  EWCApplicationLayout _layout;  // tracks the layout orientation
-  CGFloat _layoutWidth;  // stores the last width
-  CGFloat _layoutHeight;  // stores the last height
+  EWCLayoutCache _layoutCache;  // remembers the layouts solved for recent dimensions
+  EWCLayoutSolution _appliedLayout;  // the layout currently applied to the controls
+  BOOL _hasAppliedLayout;  // whether any layout has been applied yet
   IBOutlet UILabel *_memoryIndicator;  // used to control the visibility and font size of the memory indicator
   IBOutlet UILabel *_errorIndicator;  // used to control the visibility and font size of the error indicator
   IBOutlet UILabel *_taxIndicator;  // used to control the visibility and font size of the tax indicator
@@ -107,6 +60,7 @@ typedef struct {
   NSMutableArray<EWCRoundedCornerButton *> *_opButtons;  // iterable collection of all the main operator (e.g. +) buttons
   NSMutableArray<EWCRoundedCornerButton *> *_allButtons;  // iterable collection of all buttons
   EWCCalculator *_calculator;  // our calculator model
+  EWCKeyRing _keyRing;  // the keys captured but not yet evaluated by the calculator
   UIButton *_memoryButton;  // reference to the memory button so the (accessibility) label can be updated
   UIButton *_clearButton;  // reference to the clear button so the labels can be updated
   UIButton *_rateButton;  // reference to the rate button so the (accessibility) label can be updated
@@ -115,15 +69,14 @@ typedef struct {
   EWCLabelEditManager *_labelManager;  // provides the logic for attaching the edit menu to a copy/paste-enabled label
   EWCLayoutConstants const *_currentLayout;  // points to the currently configured layout constants
 
-  NSMutableArray<AVAudioPlayer *> *_players;  // tracks sounds that have been started
+  EWCKeySoundEngine *_soundEngine;  // plays the key sounds from a fixed pool of voices
   BOOL _playKeyClicks;  // preference setting whether to use audible key clicks
-  NSData *_clickData;  // sound data for regular clicks
-  NSData *_deleteData;  // sound data for the clear key click
-  NSData *_modifyData;  // sound data for the rate shift key click
+  EWCKeyStreamRecorder *_keyRecorder;  // records the calculator inputs while enabled in the settings
+  EWCAnnouncementScheduler *_announcer;  // coalesces the VoiceOver announcements so only the latest of each kind is read
 
   NSArray<EWCKeyCommandCalculatorRecord *> *_keyMappings;  // the single authoratative mapping from a hardware key to a calculator key
   NSArray<UIKeyCommand *> *_keyCommands;  // the hardware key commands we are interested in
-  NSDictionary<NSString *, NSNumber *> *_commandToKey;  // mapping of keyboard commands to calculator keys
+  EWCKeyMap _keyMap;  // the compiled mapping of keyboard command characters to calculator keys
 }
 
 ///------------------------------------------------------
@@ -154,68 +107,23 @@ static const float s_soundVolume = 0.8;
 ///-------------------------
 
 static char const * const s_playClicksPref = "play_key_clicks_preference";
+static char const * const s_recordKeysPref = "record_keys_preference";
 
 ///------------------------
 /// @name Mapping Constants
 ///------------------------
 
 static char const * const s_escapeMarker = "ESCAPE";
+static const unichar s_escapeCharacter = 0x1b;  // stands in for the escape key in the key map
+static const NSUInteger s_maximumPastedKeys = 256;  // the most keys pasted text can be typed as
 
 ///-----------------------
 /// @name Layout Constants
 ///-----------------------
 
-static const float s_tallGridHeightWidthRatio = 1.700;  // the aspect ratio that determines whether to layout the buttons in tall or wide mode
-
 static const float s_minimumDisplayScaleFactor = 0.25;  // the minimum scale font that can be applied to the display to fit the contents on screen
 static const int s_maximumDigits = 16;  // the number of digits we will support
 
-static const float s_narrowLayoutBase = 0.037;  // base layout value for narrow layout
-static const float s_wideLayoutBase = 0.045;  // base layout value for wide layout
-static const float s_tallLayoutBase = 0.030;  // base layout value for tall layout
-
-/**
-  Layout constants for the narrow layout (wide layout, but width is smaller than height).
- */
-static const EWCLayoutConstants s_narrowLayoutConstants = {
-  s_narrowLayoutBase,  // textSizeAsPercentOfHeight
-  s_narrowLayoutBase * 0.5,  // statusSizeAsPercentOfHeight
-  s_narrowLayoutBase * 2,  // digitSizeAsPercentOfHeight
-  s_narrowLayoutBase * 2,  // operatorSizeAsPercentOfHeight
-  s_narrowLayoutBase * 3.7,  // displaySizeAsPercentOfHeight
-  1.500,  // displayHeightFromFontSize
-  0.020,  // minimumRowGutter
-  0.020,  // minimumColumnGutter
-};
-
-/**
- Layout constants for the wide layout (wide layout, and width is larger than height).
-*/
-static const EWCLayoutConstants s_wideLayoutConstants = {
-  s_wideLayoutBase,  // textSizeAsPercentOfHeight
-  s_wideLayoutBase * 0.5,  // statusSizeAsPercentOfHeight
-  s_wideLayoutBase * 2,  // digitSizeAsPercentOfHeight
-  s_wideLayoutBase * 2,  // operatorSizeAsPercentOfHeight
-  s_wideLayoutBase * 2.6,  // displaySizeAsPercentOfHeight
-  1.500,  // displayHeightFromFontSize
-  0.030,  // minimumRowGutter
-  0.010,  // minimumColumnGutter
-};
-
-/**
- Layout constants for the tall layout (greater than tall aspect ratio).
-*/
-static const EWCLayoutConstants s_tallLayoutConstants = {
-  s_tallLayoutBase,  // textSizeAsPercentOfHeight
-  s_tallLayoutBase * 0.5,  // statusSizeAsPercentOfHeight
-  s_tallLayoutBase * 1.8,  // digitSizeAsPercentOfHeight
-  s_tallLayoutBase * 1.7,  // operatorSizeAsPercentOfHeight
-  s_tallLayoutBase * 2.8,  // displaySizeAsPercentOfHeight
-  1.500,  // displayHeightFromFontSize
-  0.020,  // minimumRowGutter
-  0.030,  // minimumColumnGutter
-};
-
 
 @implementation ViewController
 
@@ -325,10 +233,9 @@ static const EWCLayoutConstants s_tallLayoutConstants = {
   [super viewDidLoad];
 
   // initialize state that tracks layout to values that will force an initial layout
-  _layout = EWCApplicationDefaultLayout;
-  _layoutWidth = 0;
-  _layoutHeight = 0;
-  _currentLayout = &s_wideLayoutConstants;
+  EWCLayoutCacheClear(&_layoutCache);
+  _hasAppliedLayout = NO;
+  _currentLayout = EWCLayoutConstantsForMode(EWCLayoutWideMode);
 
   _textButtons = [NSMutableArray<EWCRoundedCornerButton *> new];
   _digitButtons = [NSMutableArray<EWCRoundedCornerButton *> new];
@@ -338,6 +245,7 @@ static const EWCLayoutConstants s_tallLayoutConstants = {
   _displayArea.adjustsFontSizeToFitWidth = YES;
   _displayArea.minimumScaleFactor = s_minimumDisplayScaleFactor;
 
+  [self setupAnnouncer];
   [self setupCalculator];
   [self allocateButtons];
 
@@ -372,7 +280,14 @@ static const EWCLayoutConstants s_tallLayoutConstants = {
   [self updateLayoutOnChange];
 
   // perform initial display updated from calculator state
-  [self updateDisplayFromCalculator];
+  [self updateDisplayForChanges:EWCCalculatorAllChanges];
+
+  // the display accessibility label is only maintained while VoiceOver is
+  // running, so catch up when it starts
+  [[NSNotificationCenter defaultCenter] addObserver:self
+    selector:@selector(voiceOverStatusDidChange:)
+    name:UIAccessibilityVoiceOverStatusDidChangeNotification
+    object:nil];
 
   // load the sound data we need for key input
   [self loadSoundData];
@@ -419,6 +334,7 @@ static const EWCLayoutConstants s_tallLayoutConstants = {
  */
 - (void)setupCalculator {
   _calculator = [EWCCalculator new];
+  EWCKeyRingInit(&_keyRing);
 
   __weak ViewController *controller = self;
   [_calculator registerUpdateCallbackWithBlock:^{
@@ -426,10 +342,29 @@ static const EWCLayoutConstants s_tallLayoutConstants = {
   }];
 
   _calculator.maximumDigits = s_maximumDigits;
-  _calculator.dataProvider = [EWCCalculatorUserDefaultsData new];
+  _calculator.dataProvider = [EWCCalculatorSharedData sharedData];
+
+  // other windows share the tax rate and memory, so show their changes
+  [[NSNotificationCenter defaultCenter] addObserver:self
+    selector:@selector(sharedDataDidChange:)
+    name:EWCCalculatorSharedDataDidChangeNotification
+    object:_calculator.dataProvider];
 
   // make sure that we announce the initial displayed valued
-  [self dispatchAnnouncement:_displayArea];
+  [self dispatchAnnouncement:_displayArea onChannel:EWCAnnouncementDisplayChannel];
+}
+
+/**
+  Creates the scheduler that delivers the VoiceOver announcements.
+ */
+- (void)setupAnnouncer {
+  _announcer = [EWCAnnouncementScheduler
+    schedulerWithClock:[EWCDispatchAnnouncementClock clock]
+    poster:^(id message) {
+      UIAccessibilityPostNotification(
+        UIAccessibilityAnnouncementNotification,
+        message);
+    }];
 }
 
 /**
@@ -609,27 +544,31 @@ static const EWCLayoutConstants s_tallLayoutConstants = {
 }
 
 /**
-  Preload the data for the sounds.
+  Preload the data for the sounds, decoding it into the sound engine.
  */
 - (void)loadSoundData {
+  // in the order of the EWCKeySound values
   char const * const names[] = {
     s_keyClickName,
     s_keyDeleteName,
     s_keyModifyName};
   const int soundCount = sizeof(names) / sizeof(char *);
 
-  NSData * __strong *data[] = {
-    &_clickData,
-    &_deleteData,
-    &_modifyData,
-  };
-
+  NSMutableArray<NSData *> *data = [NSMutableArray arrayWithCapacity:soundCount];
   for (int i = 0; i < soundCount; ++i) {
     NSString *path = [[NSBundle mainBundle] pathForResource:@(names[i]) ofType:@(s_soundExt)];
-    *(data[i]) = [NSData dataWithContentsOfFile:path];
+    NSData *sound = [NSData dataWithContentsOfFile:path];
+    if (! sound) {
+      return;
+    }
+    [data addObject:sound];
   }
 
-  _players = [NSMutableArray array];
+  _soundEngine = [EWCKeySoundEngine engineWithSoundData:data
+    backend:[EWCAudioEngineKeySoundBackend backend]];
+  _soundEngine.volume = s_soundVolume;
+
+  [self setKeyClicksEnabled:_playKeyClicks];
 }
 
 ///------------------------------
@@ -716,13 +655,28 @@ static const EWCLayoutConstants s_tallLayoutConstants = {
   // set the commands
   _keyCommands = [commandBuilder copy];
 
-  // build the command to key mappings
-  NSMutableDictionary<NSString *, NSNumber *> *mappingBuilder = [NSMutableDictionary<NSString *, NSNumber *> new];
+  // compile the command to key mappings, so that a key press is a single
+  // table probe
+  EWCKeyMapInit(&_keyMap);
   for (EWCKeyCommandCalculatorRecord *rec in _keyMappings) {
-    mappingBuilder[rec.command.input] = @(rec.calculatorKey);
+    EWCKeyMapAdd(&_keyMap, [self characterFromKeyInput:rec.command.input], (int)rec.calculatorKey);
   }
+  EWCKeyMapCompile(&_keyMap);
+}
+
+/**
+  Gets the character that represents a key command input in the key map.
 
-  _commandToKey = [mappingBuilder copy];
+  @param input The key command input.  Other than the escape key, inputs are single characters.
+
+  @return The character, or 0 if the input can't be mapped.
+ */
+- (unichar)characterFromKeyInput:(NSString *)input {
+  if (input == UIKeyInputEscape || [input isEqualToString:UIKeyInputEscape]) {
+    return s_escapeCharacter;
+  }
+
+  return (input.length == 1) ? [input characterAtIndex:0] : 0;
 }
 
 /**
@@ -768,9 +722,9 @@ static const EWCLayoutConstants s_tallLayoutConstants = {
   @return The calculator key corresponding to the input.
  */
 - (EWCCalculatorKey)calculatorKeyFromKeyboardCommand:(UIKeyCommand *)command {
-  NSString *input = command.input;
+  unichar c = [self characterFromKeyInput:command.input];
 
-  return (EWCCalculatorKey)_commandToKey[input].intValue;
+  return (EWCCalculatorKey)EWCKeyMapLookup(&_keyMap, c);
 }
 
 ///---------------------------
@@ -796,6 +750,9 @@ static const EWCLayoutConstants s_tallLayoutConstants = {
 ///------------------------------------------------
 
 - (nullable NSString *)willCopyText:(NSString *)text withSender:(id)sender {
+  // make sure keys typed before the copy are reflected
+  [self drainKeys];
+
   // ignore the passed text, and just get the raw value
   NSDecimalNumber *num = _calculator.displayValue;
   text = [NSString stringWithFormat:@"%@", num];
@@ -804,11 +761,19 @@ static const EWCLayoutConstants s_tallLayoutConstants = {
 }
 
 - (nullable NSString *)willPasteText:(NSString *)text withSender:(id)sender {
-  // try to interpret the text as a number
+  // a calculation (such as "12*3=") is typed as keys
+  if ([self typePastedKeys:text]) {
+    return nil;
+  }
+
+  // otherwise, try to interpret the text as a number
   NSDecimalNumber *num = [NSDecimalNumber decimalNumberWithString:text
     locale:[NSLocale currentLocale]];
 
   if ([num compare:[NSDecimalNumber notANumber]] != NSOrderedSame) {
+    // the pasted value replaces the result of any keys typed before it
+    [self drainKeys];
+
     // we got some kind of number, so update the display
     [_calculator setInput:num];
     [self updateDisplayFromCalculator];
@@ -818,6 +783,71 @@ static const EWCLayoutConstants s_tallLayoutConstants = {
   return nil;
 }
 
+/**
+  Checks whether a key may be typed by pasted text.  Only digits, the decimal point, the arithmetic operators, and equals are, so that a paste can't clear the calculator or change memory or the tax rate.
+
+  @param key The key.
+
+  @return YES if the key may be pasted.
+ */
+- (BOOL)isPastableKey:(EWCCalculatorKey)key {
+  return EWCCalculatorKeyIsDigit(key)
+    || EWCCalculatorKeyIsBinaryOp(key)
+    || key == EWCCalculatorDecimalKey
+    || key == EWCCalculatorEqualKey;
+}
+
+/**
+  Types pasted text as keys, in the plain text key notation, if it is a calculation: every character of it (other than spaces and line breaks) is a pastable key, and an operator or equals follows the first key.  A plain number, even a negative one, is left to be read as a number in the current locale.
+
+  @param text The pasted text.
+
+  @return YES if the text was typed.
+ */
+- (BOOL)typePastedKeys:(NSString *)text {
+  NSUInteger length = text.length;
+  if (length == 0 || length > s_maximumPastedKeys) {
+    return NO;
+  }
+
+  unichar characters[s_maximumPastedKeys];
+  int keys[s_maximumPastedKeys];
+  [text getCharacters:characters range:NSMakeRange(0, length)];
+
+  size_t unmapped = 0;
+  size_t count = EWCKeyMapTranslate(EWCCalculatorKeyNotationMap(), characters, length, keys, &unmapped);
+  if (count == 0 || unmapped > 0) {
+    return NO;
+  }
+
+  BOOL calculation = NO;
+  for (size_t i = 0; i < count; ++i) {
+    EWCCalculatorKey key = (EWCCalculatorKey)keys[i];
+    if (! [self isPastableKey:key]) {
+      return NO;
+    }
+    if (i > 0 && (EWCCalculatorKeyIsBinaryOp(key) || key == EWCCalculatorEqualKey)) {
+      calculation = YES;
+    }
+  }
+  if (! calculation) {
+    return NO;
+  }
+
+  // the keys follow any still waiting to be evaluated
+  [self drainKeys];
+
+  EWCCalculator *calculator = _calculator;
+  const int *pastedKeys = keys;
+  [calculator performBatchUpdates:^{
+    for (size_t i = 0; i < count; ++i) {
+      [calculator pressKey:(EWCCalculatorKey)pastedKeys[i]];
+    }
+  }];
+
+  return YES;
+}
+
 ///-----------------------
 /// @name Settings Methods
 ///-----------------------
@@ -827,6 +857,65 @@ static const EWCLayoutConstants s_tallLayoutConstants = {
   [settings synchronize];
   _playKeyClicks = [settings
     boolForKey:@"play_key_clicks_preference"];
+  [self setKeyClicksEnabled:_playKeyClicks];
+  [self setKeyRecordingEnabled:[settings boolForKey:@(s_recordKeysPref)]];
+}
+
+- (void)flushKeyRecording {
+  [_keyRecorder flush];
+}
+
+- (void)flushSharedData {
+  [[EWCCalculatorSharedData sharedData] flush];
+}
+
+- (void)suspendKeyClicks {
+  [self setKeyClicksEnabled:NO];
+}
+
+/**
+  Starts or stops the audio output for the key clicks, so that it only runs while the clicks are wanted.
+
+  @param enabled Whether key clicks should be played.
+ */
+- (void)setKeyClicksEnabled:(BOOL)enabled {
+  if (enabled && ! _soundEngine.isStarted) {
+    [_soundEngine start];
+  } else if (! enabled && _soundEngine.isStarted) {
+    [_soundEngine stop];
+  }
+}
+
+/**
+  Starts or stops recording the calculator inputs.  Each recording is written to a new file in the documents directory, where it can be collected through file sharing and replayed by `ebbycalc-replay`.
+
+  @param enabled Whether inputs should be recorded.
+ */
+- (void)setKeyRecordingEnabled:(BOOL)enabled {
+  if (! enabled) {
+    [_keyRecorder finish];
+    _keyRecorder = nil;
+    return;
+  }
+
+  if (_keyRecorder) {
+    return;
+  }
+
+  NSURL *documents = [[NSFileManager defaultManager]
+    URLsForDirectory:NSDocumentDirectory inDomains:NSUserDomainMask].firstObject;
+  // scenes can start recording in the same second, so the time only orders
+  // the files, and the UUID keeps them apart
+  NSString *name = [NSString stringWithFormat:@"keys-%.0f-%@.ewck",
+    [NSDate date].timeIntervalSince1970, [NSUUID UUID].UUIDString];
+  NSURL *url = [documents URLByAppendingPathComponent:name];
+
+  _keyRecorder = [EWCKeyStreamRecorder recorderWithOutputStream:
+    [NSOutputStream outputStreamWithURL:url append:NO]];
+  if (! [_keyRecorder startRecordingCalculator:_calculator]) {
+    [_keyRecorder finish];
+    _keyRecorder = nil;
+  }
 }
 
 /**
@@ -870,8 +959,10 @@ static const EWCLayoutConstants s_tallLayoutConstants = {
 
 /**
   Applies the button grid layout, which requires changing the row, column configuration and where the buttons are placed within them.
+
+  @param solution The layout whose grid to apply.
  */
-- (void)layoutGrid {
+- (void)layoutGridForSolution:(const EWCLayoutSolution *)solution {
 
   // custom callback for laying out the add key, since it it double tall.
   // it uses the same corner radius as the smaller buttons
@@ -891,112 +982,32 @@ static const EWCLayoutConstants s_tallLayoutConstants = {
     button.cornerRadius = radius;
   };
 
-  // set the gutters
-  _grid.rowGutter = _currentLayout->minimumRowGutter;
-  _grid.columnGutter = _currentLayout->minimumColumnGutter;
-
-  if (_layout == EWCApplicationTallLayout) {
-    // tall
-
-    // if VoiceOver is running, announce the layout change
-    if (UIAccessibilityIsVoiceOverRunning()) {
-      UIAccessibilityPostNotification(
-        UIAccessibilityLayoutChangedNotification,
-        NSLocalizedString(@"Tall Layout",
-          @"Description to announce when the calculator is in tall mode"));
-    }
-
-    // configure grid layout
-    _grid.rows = 9;
-    _grid.columns = 3;
-
-    // rehome buttons
-    [_grid addSubView:_allButtons[EWCCalculatorZeroKey] inRow:8 column:0];
-    [_grid addSubView:_allButtons[EWCCalculatorOneKey] inRow:7 column:0];
-    [_grid addSubView:_allButtons[EWCCalculatorTwoKey] inRow:7 column:1];
-    [_grid addSubView:_allButtons[EWCCalculatorThreeKey] inRow:7 column:2];
-    [_grid addSubView:_allButtons[EWCCalculatorFourKey] inRow:6 column:0];
-    [_grid addSubView:_allButtons[EWCCalculatorFiveKey] inRow:6 column:1];
-    [_grid addSubView:_allButtons[EWCCalculatorSixKey] inRow:6 column:2];
-    [_grid addSubView:_allButtons[EWCCalculatorSevenKey] inRow:5 column:0];
-    [_grid addSubView:_allButtons[EWCCalculatorEightKey] inRow:5 column:1];
-    [_grid addSubView:_allButtons[EWCCalculatorNineKey] inRow:5 column:2];
-    [_grid addSubView:_allButtons[EWCCalculatorClearKey] inRow:2 column:0];
-    [_grid addSubView:_allButtons[EWCCalculatorRateKey] inRow:0 column:0];
-    [_grid addSubView:_allButtons[EWCCalculatorTaxPlusKey] inRow:0 column:1];
-    [_grid addSubView:_allButtons[EWCCalculatorTaxMinusKey] inRow:0 column:2];
-    [_grid addSubView:_allButtons[EWCCalculatorMemoryKey] inRow:1 column:0];
-    [_grid addSubView:_allButtons[EWCCalculatorMemoryPlusKey] inRow:1 column:1];
-    [_grid addSubView:_allButtons[EWCCalculatorMemoryMinusKey] inRow:1 column:2];
-    [_grid addSubView:_allButtons[EWCCalculatorAddKey] startingInRow:3 column:2 endingInRow:4 column:2 withLayout:callback];
-    [_grid addSubView:_allButtons[EWCCalculatorSubtractKey] inRow:4 column:1];
-    [_grid addSubView:_allButtons[EWCCalculatorMultiplyKey] inRow:3 column:1];
-    [_grid addSubView:_allButtons[EWCCalculatorDivideKey] inRow:3 column:0];
-    [_grid addSubView:_allButtons[EWCCalculatorSignKey] inRow:4 column:0];
-    [_grid addSubView:_allButtons[EWCCalculatorDecimalKey] inRow:8 column:1];
-    [_grid addSubView:_allButtons[EWCCalculatorPercentKey] inRow:2 column:1];
-    [_grid addSubView:_allButtons[EWCCalculatorSqrtKey] inRow:2 column:2];
-    [_grid addSubView:_allButtons[EWCCalculatorEqualKey] inRow:8 column:2];
-
-  } else {
-    // wide
-
-    // if VoiceOver is running, announce the layout change
-    if (UIAccessibilityIsVoiceOverRunning()) {
-      UIAccessibilityPostNotification(
-        UIAccessibilityLayoutChangedNotification,
-        NSLocalizedString(@"Wide Layout",
-          @"Description to announce when the calculator is in wide mode"));
-    }
-
-    // configure grid layout
-    _grid.rows = 5;
-    _grid.columns = 6;
-
-    // rehome buttons
-    [_grid addSubView:_allButtons[EWCCalculatorZeroKey] inRow:4 column:1];
-    [_grid addSubView:_allButtons[EWCCalculatorOneKey] inRow:3 column:1];
-    [_grid addSubView:_allButtons[EWCCalculatorTwoKey] inRow:3 column:2];
-    [_grid addSubView:_allButtons[EWCCalculatorThreeKey] inRow:3 column:3];
-    [_grid addSubView:_allButtons[EWCCalculatorFourKey] inRow:2 column:1];
-    [_grid addSubView:_allButtons[EWCCalculatorFiveKey] inRow:2 column:2];
-    [_grid addSubView:_allButtons[EWCCalculatorSixKey] inRow:2 column:3];
-    [_grid addSubView:_allButtons[EWCCalculatorSevenKey] inRow:1 column:1];
-    [_grid addSubView:_allButtons[EWCCalculatorEightKey] inRow:1 column:2];
-    [_grid addSubView:_allButtons[EWCCalculatorNineKey] inRow:1 column:3];
-    [_grid addSubView:_allButtons[EWCCalculatorClearKey] inRow:1 column:0];
-    [_grid addSubView:_allButtons[EWCCalculatorRateKey] inRow:0 column:3];
-    [_grid addSubView:_allButtons[EWCCalculatorTaxPlusKey] inRow:0 column:4];
-    [_grid addSubView:_allButtons[EWCCalculatorTaxMinusKey] inRow:0 column:5];
-    [_grid addSubView:_allButtons[EWCCalculatorMemoryKey] inRow:2 column:5];
-    [_grid addSubView:_allButtons[EWCCalculatorMemoryPlusKey] inRow:4 column:5];
-    [_grid addSubView:_allButtons[EWCCalculatorMemoryMinusKey] inRow:3 column:5];
-    [_grid addSubView:_allButtons[EWCCalculatorAddKey] startingInRow:3 column:4 endingInRow:4 column:4 withLayout:callback];
-    [_grid addSubView:_allButtons[EWCCalculatorSubtractKey] inRow:2 column:4];
-    [_grid addSubView:_allButtons[EWCCalculatorMultiplyKey] inRow:1 column:4];
-    [_grid addSubView:_allButtons[EWCCalculatorDivideKey] inRow:1 column:5];
-    [_grid addSubView:_allButtons[EWCCalculatorSignKey] inRow:2 column:0];
-    [_grid addSubView:_allButtons[EWCCalculatorDecimalKey] inRow:4 column:2];
-    [_grid addSubView:_allButtons[EWCCalculatorPercentKey] inRow:3 column:0];
-    [_grid addSubView:_allButtons[EWCCalculatorSqrtKey] inRow:4 column:0];
-    [_grid addSubView:_allButtons[EWCCalculatorEqualKey] inRow:4 column:3];
+  // if VoiceOver is running, announce the layout change
+  if (UIAccessibilityIsVoiceOverRunning()) {
+    NSString *announcement = (solution->mode == EWCLayoutTallMode)
+      ? NSLocalizedString(@"Tall Layout",
+        @"Description to announce when the calculator is in tall mode")
+      : NSLocalizedString(@"Wide Layout",
+        @"Description to announce when the calculator is in wide mode");
+    UIAccessibilityPostNotification(UIAccessibilityLayoutChangedNotification, announcement);
   }
-}
-
-/**
-  Calculates the leading spacing for the status indicators.
- */
-- (float)getLeadingStatusConstant:(CGFloat)width {
-  return 20 + width * _grid.columnGutter;
-}
 
-/**
- Calculates the trailing spacing for the status indicators.
-
- This used to be a different value than the leading, hence the separate function.  However, the current app design has the leading and trailing equal to one another.
-*/
-- (float)getTrailingStatusConstant:(CGFloat)width {
-  return [self getLeadingStatusConstant:width];
+  // configure grid layout
+  const EWCLayoutGrid *grid = solution->grid;
+  _grid.rows = grid->rows;
+  _grid.columns = grid->columns;
+
+  // rehome buttons.  Only keys spanning several cells need the custom layout.
+  for (int i = 0; i < grid->placementCount; ++i) {
+    const EWCLayoutPlacement *placement = &grid->placements[i];
+    BOOL spans = placement->startRow != placement->endRow
+      || placement->startColumn != placement->endColumn;
+
+    [_grid addSubView:_allButtons[placement->key]
+      startingInRow:placement->startRow column:placement->startColumn
+      endingInRow:placement->endRow column:placement->endColumn
+      withLayout:spans ? callback : nil];
+  }
 }
 
 /**
@@ -1013,52 +1024,59 @@ static const EWCLayoutConstants s_tallLayoutConstants = {
   CGFloat height = self.view.bounds.size.height - insets.top - insets.bottom;
 
   // don't do any layout if the width or height hasn't changed
-  if (width == _layoutWidth && height == _layoutHeight) { return; }
-
-  // store the dimensions to prevent relayout
-  _layoutWidth = width;
-  _layoutHeight = height;
-
-  // determine whether we are in a tall or wide scenario
-  EWCApplicationLayout oldLayout = _layout;
-  float aspectRatio = height / width;
-  _layout = (aspectRatio >= s_tallGridHeightWidthRatio)
-    ? EWCApplicationTallLayout
-    : EWCApplicationWideLayout;
+  if (_hasAppliedLayout
+    && width == _appliedLayout.width && height == _appliedLayout.height) { return; }
+
+  // get the layout for these dimensions.  Resizing tends to go back and forth
+  // between a few sizes, so this is usually remembered rather than solved.
+  const EWCLayoutSolution *solution = EWCLayoutCacheSolve(&_layoutCache,
+    width, height, _gridBottomConstraint.constant);
+  const EWCLayoutSolution *applied = _hasAppliedLayout ? &_appliedLayout : NULL;
+  _currentLayout = solution->constants;
+
+  // apply the grid and its spacing if needed
+  if (! applied || solution->grid != applied->grid) {
+    [self layoutGridForSolution:solution];
+  }
 
-  if (_layout == EWCApplicationWideLayout) {
-    _currentLayout = (width < height) ? &s_narrowLayoutConstants : &s_wideLayoutConstants;
-  } else {
-    _currentLayout = &s_tallLayoutConstants;
+  if (! applied || solution->rowGutter != applied->rowGutter
+    || solution->columnGutter != applied->columnGutter) {
+    _grid.rowGutter = solution->rowGutter;
+    _grid.columnGutter = solution->columnGutter;
+    [_grid setNeedsLayout];
   }
 
-  // apply the layout if needed
-  if (_layout != oldLayout) {
-    [self layoutGrid];
+  // the font sizes only depend on the height and arrangement, so a change
+  // in width alone leaves the fonts alone
+  if (! applied || solution->displayFontSize != applied->displayFontSize) {
+    [_displayArea setFont:[_displayArea.font fontWithSize:solution->displayFontSize]];
   }
 
-  // use the height as the dimension to base our font sizes on
-  CGFloat fontDim = height;
+  if (! applied || solution->textFontSize != applied->textFontSize) {
+    [self setTextButtonsFontSize:solution->textFontSize];
+  }
 
-  // get the display font size
-  CGFloat fontHeight = fontDim * _currentLayout->displaySizeAsPercentOfHeight;
+  if (! applied || solution->digitFontSize != applied->digitFontSize) {
+    [self setDigitButtonsFontSize:solution->digitFontSize];
+  }
 
-  // use it to update the display font size
-  [_displayArea setFont:[_displayArea.font fontWithSize:fontHeight]];
+  if (! applied || solution->operatorFontSize != applied->operatorFontSize) {
+    [self setOperatorButtonsFontSize:solution->operatorFontSize
+      titleInset:solution->operatorTitleInset];
+  }
 
-  // calculate the layout properties that depend on the display font height
-  CGFloat displayHeight = fontHeight * _currentLayout->displayHeightFromFontSize;
-  _gridTopConstraint.constant = -height + displayHeight + _gridBottomConstraint.constant;
+  if (! applied || solution->statusFontSize != applied->statusFontSize) {
+    [self setStatusFontSize:solution->statusFontSize];
+  }
 
-  // update the remaining font sizes
-  [self setTextButtonsFontSize:fontDim * _currentLayout->textSizeAsPercentOfHeight];
-  [self setDigitButtonsFontSize:fontDim * _currentLayout->digitSizeAsPercentOfHeight];
-  [self setOperatorButtonsFontSize:fontDim * _currentLayout->operatorSizeAsPercentOfHeight];
-  [self setStatusFontSize:fontDim * _currentLayout->statusSizeAsPercentOfHeight];
+  // the constraints are cheap to set, and only cause layout if they change
+  _gridTopConstraint.constant = solution->gridTopConstant;
+  _statusRightConstraint.constant = solution->statusInset;
+  _statusLeftConstraint.constant = solution->statusInset;
 
-  // adjust the status constraints
-  _statusRightConstraint.constant = [self getTrailingStatusConstant:width];
-  _statusLeftConstraint.constant = [self getLeadingStatusConstant:width];
+  // keep a copy, since the cache may reuse the entry
+  _appliedLayout = *solution;
+  _hasAppliedLayout = YES;
 }
 
 /**
@@ -1103,13 +1121,14 @@ static const EWCLayoutConstants s_tallLayoutConstants = {
   Applies a font size to all of the main operator buttons.
 
   @param points The new font size in points.
+  @param titleInset The bottom title inset to go with the font size.
 */
-- (void)setOperatorButtonsFontSize:(CGFloat)points {
+- (void)setOperatorButtonsFontSize:(CGFloat)points titleInset:(CGFloat)titleInset {
   [self setFontSize:points forButtons:_opButtons];
 
   // apply an inset to compensate for the operators not being vertically
   // centered within its font height.  This inset moves the label up slightly.
-  UIEdgeInsets inset = UIEdgeInsetsMake(0, 0, points * 0.200, 0);
+  UIEdgeInsets inset = UIEdgeInsetsMake(0, 0, titleInset, 0);
 
   for (UIButton *button in _opButtons) {
     [button setTitleEdgeInsets:inset];
@@ -1308,70 +1327,59 @@ static const EWCLayoutConstants s_tallLayoutConstants = {
  */
 - (void)playSoundForKey:(EWCCalculatorKey)key {
   if (_playKeyClicks) {
-    AVAudioPlayer *player = [self ensureSoundIdForKey:key];
-    player.volume = s_soundVolume;
-    [player play];
-    [_players addObject:player];
+    [_soundEngine playSoundForKey:key];
   }
 }
 
 /**
-  Play an appropriate sound for a key, and sends the key to the calculator.
+  Play an appropriate sound for a key, and queues the key for the calculator.
+
+  The key is evaluated on a later pass of the main queue, along with any other keys that arrive before then (such as from hardware key autorepeat), so that the display is only updated once for all of them.
 
   @param key The key to send to the calculator.
  */
 - (void)sendKeyToCalculator:(EWCCalculatorKey)key {
   [self playSoundForKey:key];
-  [_calculator pressKey:key];
-}
-
-/**
-  Gets the audio player for the sound of the pressed key.
 
-  @param key The key that was pressed.
-
-  @return An audio player instance that can be used to play the appropriate key sound.
- */
-- (AVAudioPlayer *)ensureSoundIdForKey:(EWCCalculatorKey)key {
-  // get the file reference for the key
-  NSData *data;
-  AVAudioPlayer * player;
-
-  [self cleanupSounds];
-
-  // figure out the source file and player var
-  switch (key) {
-    case EWCCalculatorRateKey:
-      data = _modifyData;
-      break;
-
-    case EWCCalculatorClearKey:
-    case EWCCalculatorBackspaceKey:
-      data = _deleteData;
-      break;
-
-    default:
-      data = _clickData;
+  if (! EWCKeyRingPush(&_keyRing, key)) {
+    // the calculator has fallen far behind, so catch up now rather than lose
+    // the key
+    [self drainKeys];
+    EWCKeyRingPush(&_keyRing, key);
   }
 
-  player = [[AVAudioPlayer alloc] initWithData:data error:nil];
-
-  return player;
+  if (EWCKeyRingRequestDrain(&_keyRing)) {
+    __weak ViewController *controller = self;
+    dispatch_async(dispatch_get_main_queue(), ^{
+      [controller drainKeys];
+    });
+  }
 }
 
 /**
- Makes sure that we only keep references to sounds that are still active.
+  `EWCKeyRingConsumer` that presses a queued key on the calculator passed as the context.
  */
-- (void)cleanupSounds {
-  NSPredicate *selector = [NSPredicate predicateWithBlock:^ BOOL (id  _Nullable evaluatedObject, NSDictionary<NSString *,id> * _Nullable bindings) {
-    AVAudioPlayer *player = evaluatedObject;
-    return player.playing;
-  }];
+static void EWCPressQueuedKey(int32_t key, void *context) {
+  EWCCalculator *calculator = (__bridge EWCCalculator *)context;
+  [calculator pressKey:(EWCCalculatorKey)key];
+}
 
-  NSMutableArray<AVAudioPlayer *> *playing = [[_players
-    filteredArrayUsingPredicate:selector] mutableCopy];
+/**
+  Presses every queued key on the calculator as a single batch, so that the display is only updated once.
 
-  _players = playing;
+  It is safe to call this when no keys are waiting, or when a drain has already been scheduled.
+ */
+- (void)drainKeys {
+  EWCCalculator *calculator = _calculator;
+  EWCKeyRing *ring = &_keyRing;
+
+  do {
+    if (EWCKeyRingCount(ring) > 0) {
+      [calculator performBatchUpdates:^{
+        EWCKeyRingConsume(ring, EWCPressQueuedKey, (__bridge void *)calculator);
+      }];
+    }
+  } while (EWCKeyRingFinishDrain(ring));
 }
 
 ///---------------------------------
@@ -1384,32 +1392,42 @@ static const EWCLayoutConstants s_tallLayoutConstants = {
   Since we use this for status indicator announcements it won't queue the announcment, since we want it to interrupt reannouncing the current control to draw attention to itself.
 
   @param view The view from which to get the announcement label.  Generally, a status indicator.
+  @param priority The priority of the announcement.  Errors aren't replaced by other status changes.
  */
-- (void)dispatchAnnouncementForView:(UIView *)view {
-  [self dispatchAnnouncement:view.accessibilityLabel];
+- (void)dispatchAnnouncementForView:(UIView *)view priority:(EWCAnnouncementPriority)priority {
+  [self dispatchAnnouncement:view.accessibilityLabel
+    onChannel:EWCAnnouncementStatusChannel
+    priority:priority];
+}
+
+/**
+  Performs a VoiceOver announcement using the supplied message, at normal priority.
+
+  @param message The message to announce.  Either a `NSString` or `NSAttributedString` which can carry information about queuing.
+  @param channel The channel to announce on.  A newer message replaces the one still pending on its channel.
+ */
+- (void)dispatchAnnouncement:(id)message onChannel:(EWCAnnouncementChannel)channel {
+  [self dispatchAnnouncement:message onChannel:channel priority:EWCAnnouncementNormalPriority];
 }
 
 /**
   Performs a VoiceOver announcement using the supplied message.
 
   @param message The message to announce.  Either a `NSString` or `NSAttributedString` which can carry information about queuing.
+  @param channel The channel to announce on.  A newer message replaces the one still pending on its channel.
+  @param priority The priority of the announcement.
  */
-- (void)dispatchAnnouncement:(id)message {
+- (void)dispatchAnnouncement:(id)message
+  onChannel:(EWCAnnouncementChannel)channel
+  priority:(EWCAnnouncementPriority)priority {
 
   // don't do anything is VoiceOver isn't active
   if (! UIAccessibilityIsVoiceOverRunning()) { return; }
 
-  double delayInSeconds = 0.75;
-  dispatch_time_t popTime = dispatch_time(DISPATCH_TIME_NOW,
-    (int64_t)(delayInSeconds * NSEC_PER_SEC));
-
-  // dispatch to announce after a brief delay so that we don't get cut off by
-  // the system reannouncing the currently selected button
-  dispatch_after(popTime, dispatch_get_main_queue(), ^(void) {
-    UIAccessibilityPostNotification(
-    UIAccessibilityAnnouncementNotification,
-    message);
-  });
+  // the announcer waits briefly so that we don't get cut off by the system
+  // reannouncing the currently selected button, and only the latest message
+  // of each channel is read if keys are pressed faster than that
+  [_announcer announce:message onChannel:channel priority:priority];
 }
 
 ///------------------------------------------------------
@@ -1417,14 +1435,64 @@ static const EWCLayoutConstants s_tallLayoutConstants = {
 ///------------------------------------------------------
 
 /**
-  Updates all portions of the interface that can change based on the calculator state.
+  Updates the portions of the interface affected by the calculator's most recent input.
  */
 - (void)updateDisplayFromCalculator {
-  [self updateStatusIndicators];
-  [self updateDisplay];
-  [self updateClearLabels];
-  [self updateTaxLabels];
-  [self updateMemoryLabels];
+  [self updateDisplayForChanges:_calculator.lastChanges];
+}
+
+/**
+  Updates the portions of the interface that depend on the supplied calculator outputs.
+
+  @param changes The calculator outputs that have changed.
+ */
+- (void)updateDisplayForChanges:(EWCCalculatorChange)changes {
+  // the error indicator is announced on every input while it is showing, so
+  // the status must be refreshed even if nothing changed
+  if ((changes & EWCCalculatorStatusChanges) || _calculator.hasError) {
+    [self updateStatusIndicators];
+  }
+
+  if (changes & EWCCalculatorDisplayContentChanges) {
+    [self updateDisplay];
+  }
+
+  if (changes & EWCCalculatorErrorChange) {
+    [self updateClearLabels];
+  }
+
+  if (changes & EWCCalculatorRateShiftChange) {
+    [self updateTaxLabels];
+  }
+
+  if (changes & (EWCCalculatorMemoryChange | EWCCalculatorMemoryClearChange)) {
+    [self updateMemoryLabels];
+  }
+}
+
+/**
+  Shows a tax rate or memory change made by a calculator in another window.
+
+  @param notification The shared data change notification.  Ignored, since the calculator checks the version itself.
+ */
+- (void)sharedDataDidChange:(NSNotification *)notification {
+  if ([_calculator refreshFromDataProvider]) {
+    [self updateDisplayFromCalculator];
+  }
+}
+
+/**
+  Brings the display accessibility label up to date when VoiceOver starts, since it isn't maintained while VoiceOver is off, and drops any pending announcements when it stops.
+
+  @param notification The VoiceOver status notification.  Ignored.
+ */
+- (void)voiceOverStatusDidChange:(NSNotification *)notification {
+  if (UIAccessibilityIsVoiceOverRunning()) {
+    _displayArea.accessibilityLabel = _calculator.displayAccessibleContent;
+  } else {
+    // nothing should be read out once VoiceOver is off
+    [_announcer cancelAll];
+  }
 }
 
 /**
@@ -1498,15 +1566,21 @@ static const EWCLayoutConstants s_tallLayoutConstants = {
   NSString *lastDisplay = _displayArea.text;
   NSString *newDisplay = _calculator.displayContent;
 
-  // update the display and accessibility labels
+  // update the display
   [_displayArea setText:newDisplay];
-  _displayArea.accessibilityLabel = _calculator.displayAccessibleContent;
+
+  // the spelled out reading is only needed by VoiceOver, so don't compute it
+  // otherwise
+  if (! UIAccessibilityIsVoiceOverRunning()) {
+    return;
+  }
+
+  NSString *accesssibleDisplay = _calculator.displayAccessibleContent;
+  _displayArea.accessibilityLabel = accesssibleDisplay;
 
   // if there was a change, make an announcement
   if ([lastDisplay compare:newDisplay] != NSOrderedSame) {
 
-    NSString *accesssibleDisplay = _calculator.displayAccessibleContent;
-
     // add an attribute to the message to not interrupt the current announcement.
     // this doesn't maintain a full queue, it only applies to the current message,
     // so we still have to try to avoid starting another message before this
@@ -1515,7 +1589,7 @@ static const EWCLayoutConstants s_tallLayoutConstants = {
       initWithString:accesssibleDisplay
       attributes:@{ UIAccessibilitySpeechAttributeQueueAnnouncement: @1 }];
 
-    [self dispatchAnnouncement:message];
+    [self dispatchAnnouncement:message onChannel:EWCAnnouncementDisplayChannel];
   }
 }
 
@@ -1524,6 +1598,7 @@ static const EWCLayoutConstants s_tallLayoutConstants = {
  */
 - (void)updateStatusIndicators {
 
+  BOOL oldError = self.isErrorVisible;
   self.errorVisible = _calculator.hasError;
   BOOL oldMemory = self.isMemoryVisible;
   self.memoryVisible = _calculator.hasMemory;
@@ -1542,22 +1617,28 @@ static const EWCLayoutConstants s_tallLayoutConstants = {
   // while error announces whenever it is visibile.
 
   if (_calculator.hasError) {
-    [self dispatchAnnouncementForView:_errorIndicator];
+    [self dispatchAnnouncementForView:_errorIndicator priority:EWCAnnouncementErrorPriority];
   } else {
+    // an error that was cleared before it was read out is stale, and mustn't
+    // hold off the status announcements that follow it
+    if (oldError) {
+      [_announcer cancelChannel:EWCAnnouncementStatusChannel];
+    }
+
     if (self.isMemoryVisible && oldMemory != self.isMemoryVisible) {
-      [self dispatchAnnouncementForView:_memoryIndicator];
+      [self dispatchAnnouncementForView:_memoryIndicator priority:EWCAnnouncementNormalPriority];
     }
     if (self.isTaxVisible && oldTax != self.isTaxVisible) {
-      [self dispatchAnnouncementForView:_taxIndicator];
+      [self dispatchAnnouncementForView:_taxIndicator priority:EWCAnnouncementNormalPriority];
     }
     if (self.isTaxPlusVisible && oldTaxPlus != self.isTaxPlusVisible) {
-      [self dispatchAnnouncementForView:_taxPlusIndicator];
+      [self dispatchAnnouncementForView:_taxPlusIndicator priority:EWCAnnouncementNormalPriority];
     }
     if (self.isTaxMinusVisible && oldTaxMinus != self.isTaxMinusVisible) {
-      [self dispatchAnnouncementForView:_taxMinusIndicator];
+      [self dispatchAnnouncementForView:_taxMinusIndicator priority:EWCAnnouncementNormalPriority];
     }
     if (self.isTaxPercentVisible && oldTaxPercent != self.isTaxPercentVisible) {
-      [self dispatchAnnouncementForView:_taxPercentIndicator];
+      [self dispatchAnnouncementForView:_taxPercentIndicator priority:EWCAnnouncementNormalPriority];
     }
   }
 }
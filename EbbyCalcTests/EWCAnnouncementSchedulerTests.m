@@ -0,0 +1,247 @@
+//
+//  EWCAnnouncementSchedulerTests.m
+//  EbbyCalcTests
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <XCTest/XCTest.h>
+#import "../EbbyCalc/EWCAnnouncementScheduler.h"
+#import "../EbbyCalcTools/EWCSimulatedAnnouncementClock.h"
+
+static const int s_benchmarkIterations = 100000;
+
+@interface EWCAnnouncementSchedulerTests : XCTestCase {
+  EWCSimulatedAnnouncementClock *_clock;
+  EWCAnnouncementScheduler *_announcer;
+  NSMutableArray *_posted;
+}
+
+@end
+
+@implementation EWCAnnouncementSchedulerTests
+
+- (void)setUp {
+  _clock = [EWCSimulatedAnnouncementClock clock];
+  _posted = [NSMutableArray new];
+
+  __weak EWCAnnouncementSchedulerTests *weakSelf = self;
+  _announcer = [EWCAnnouncementScheduler schedulerWithClock:_clock poster:^(id message) {
+    [weakSelf->_posted addObject:message];
+  }];
+  _announcer.delay = 0.75;
+  _announcer.maximumDelay = 2.0;
+}
+
+- (void)announceDisplay:(NSString *)message {
+  [_announcer announce:message
+    onChannel:EWCAnnouncementDisplayChannel
+    priority:EWCAnnouncementNormalPriority];
+}
+
+- (void)testSingleAnnouncementIsDelayed {
+  [self announceDisplay:@"1"];
+
+  [_clock advanceBy:0.7];
+  XCTAssertEqual(_posted.count, 0);
+  XCTAssertTrue(_announcer.hasPendingAnnouncements);
+
+  [_clock advanceBy:0.1];
+  XCTAssertEqualObjects(_posted, @[ @"1" ]);
+  XCTAssertFalse(_announcer.hasPendingAnnouncements);
+  XCTAssertEqual(_clock.pendingCount, 0);
+}
+
+- (void)testBurstCoalescesToLatest {
+  // keys 0.1s apart, faster than the delay
+  for (int i = 1; i <= 5; ++i) {
+    [self announceDisplay:[NSString stringWithFormat:@"%d", i]];
+    [_clock advanceBy:0.1];
+  }
+
+  [_clock advanceBy:1.0];
+  XCTAssertEqualObjects(_posted, @[ @"5" ]);
+  XCTAssertEqual(_announcer.submittedCount, 5);
+  XCTAssertEqual(_announcer.deliveredCount, 1);
+  XCTAssertEqual(_announcer.supersededCount, 4);
+}
+
+- (void)testMaximumDelayCapsContinuousInput {
+  // keys every 0.5s for 5 seconds never leave a 0.75s gap
+  for (int i = 0; i < 10; ++i) {
+    [self announceDisplay:[NSString stringWithFormat:@"%d", i]];
+    [_clock advanceBy:0.5];
+  }
+
+  // the first announcement went out at 2s with the value then showing, and
+  // the next burst was started and capped in turn
+  NSArray *expected = @[ @"3", @"7" ];
+  XCTAssertEqualObjects(_posted, expected);
+
+  [_clock advanceBy:2.0];
+  expected = @[ @"3", @"7", @"9" ];
+  XCTAssertEqualObjects(_posted, expected);
+  XCTAssertEqual(_announcer.deliveredCount + _announcer.supersededCount, 10);
+}
+
+- (void)testErrorIsNotReplacedByNormal {
+  [_announcer announce:@"Error"
+    onChannel:EWCAnnouncementStatusChannel
+    priority:EWCAnnouncementErrorPriority];
+  [_announcer announce:@"Memory"
+    onChannel:EWCAnnouncementStatusChannel
+    priority:EWCAnnouncementNormalPriority];
+
+  [_clock advanceBy:1.0];
+  XCTAssertEqualObjects(_posted, @[ @"Error" ]);
+  XCTAssertEqual(_announcer.supersededCount, 1);
+}
+
+- (void)testErrorReplacesNormal {
+  [_announcer announce:@"Memory"
+    onChannel:EWCAnnouncementStatusChannel
+    priority:EWCAnnouncementNormalPriority];
+  [_announcer announce:@"Error"
+    onChannel:EWCAnnouncementStatusChannel
+    priority:EWCAnnouncementErrorPriority];
+
+  [_clock advanceBy:1.0];
+  XCTAssertEqualObjects(_posted, @[ @"Error" ]);
+}
+
+- (void)testChannelsAreIndependentAndOrdered {
+  [self announceDisplay:@"12"];
+  [_announcer announce:@"Memory"
+    onChannel:EWCAnnouncementStatusChannel
+    priority:EWCAnnouncementNormalPriority];
+
+  [_clock advanceBy:1.0];
+  NSArray *expected = @[ @"Memory", @"12" ];
+  XCTAssertEqualObjects(_posted, expected);
+
+  [_posted removeAllObjects];
+  [self announceDisplay:@"0"];
+  [_announcer announce:@"Error"
+    onChannel:EWCAnnouncementStatusChannel
+    priority:EWCAnnouncementErrorPriority];
+
+  [_clock advanceBy:1.0];
+  expected = @[ @"Error", @"0" ];
+  XCTAssertEqualObjects(_posted, expected);
+}
+
+- (void)testClearedErrorIsReplacedByNormal {
+  [_announcer announce:@"Error"
+    onChannel:EWCAnnouncementStatusChannel
+    priority:EWCAnnouncementErrorPriority];
+  [self announceDisplay:@"0"];
+
+  // the error is cleared before it is read, so the memory status that comes
+  // after it takes its place
+  [_clock advanceBy:0.2];
+  [_announcer cancelChannel:EWCAnnouncementStatusChannel];
+  [_announcer announce:@"Memory"
+    onChannel:EWCAnnouncementStatusChannel
+    priority:EWCAnnouncementNormalPriority];
+
+  [_clock advanceBy:1.0];
+  NSArray *expected = @[ @"Memory", @"0" ];
+  XCTAssertEqualObjects(_posted, expected);
+  XCTAssertEqual(_clock.pendingCount, 0);
+}
+
+- (void)testCancelChannelLeavesOtherChannels {
+  [self announceDisplay:@"1"];
+  [_announcer announce:@"Error"
+    onChannel:EWCAnnouncementStatusChannel
+    priority:EWCAnnouncementErrorPriority];
+
+  [_announcer cancelChannel:EWCAnnouncementStatusChannel];
+  XCTAssertTrue(_announcer.hasPendingAnnouncements);
+
+  [_clock advanceBy:1.0];
+  XCTAssertEqualObjects(_posted, @[ @"1" ]);
+
+  // cancelling the last pending announcement cancels the scheduled delivery
+  [self announceDisplay:@"2"];
+  [_announcer cancelChannel:EWCAnnouncementDisplayChannel];
+  XCTAssertEqual(_clock.pendingCount, 0);
+}
+
+- (void)testCancelAllDropsPending {
+  [self announceDisplay:@"1"];
+  [_announcer announce:@"Error"
+    onChannel:EWCAnnouncementStatusChannel
+    priority:EWCAnnouncementErrorPriority];
+
+  [_announcer cancelAll];
+  XCTAssertFalse(_announcer.hasPendingAnnouncements);
+  XCTAssertEqual(_clock.pendingCount, 0);
+
+  [_clock advanceBy:5.0];
+  XCTAssertEqual(_posted.count, 0);
+
+  // the scheduler is still usable afterwards
+  [self announceDisplay:@"2"];
+  [_clock advanceBy:1.0];
+  XCTAssertEqualObjects(_posted, @[ @"2" ]);
+}
+
+- (void)testAtMostOneBlockIsScheduled {
+  for (int i = 0; i < 1000; ++i) {
+    [self announceDisplay:[NSString stringWithFormat:@"%d", i]];
+    [_announcer announce:@"Memory"
+      onChannel:EWCAnnouncementStatusChannel
+      priority:EWCAnnouncementNormalPriority];
+    [_clock advanceBy:0.01];
+  }
+  [_clock advanceBy:5.0];
+
+  XCTAssertEqual(_clock.peakPendingCount, 1);
+  XCTAssertLessThan(_announcer.scheduledCount, 100);
+  XCTAssertEqualObjects(_posted.lastObject, @"999");
+}
+
+- (void)testDeallocCancelsScheduledBlock {
+  @autoreleasepool {
+    EWCAnnouncementScheduler *announcer = [EWCAnnouncementScheduler
+      schedulerWithClock:_clock
+      poster:^(id message) {}];
+    [announcer announce:@"1" onChannel:EWCAnnouncementDisplayChannel priority:EWCAnnouncementNormalPriority];
+    XCTAssertEqual(_clock.pendingCount, 1);
+  }
+
+  XCTAssertEqual(_clock.pendingCount, 0);
+}
+
+///-------------------------
+/// @name Performance Tests
+///-------------------------
+
+- (void)testPerformanceBurst {
+  [self measureBlock:^{
+    for (int i = 0; i < s_benchmarkIterations; ++i) {
+      [self->_announcer announce:@"1"
+        onChannel:(i & 7) ? EWCAnnouncementDisplayChannel : EWCAnnouncementStatusChannel
+        priority:EWCAnnouncementNormalPriority];
+      [self->_clock advanceBy:0.05];
+    }
+    [self->_clock advanceBy:5.0];
+  }];
+}
+
+@end
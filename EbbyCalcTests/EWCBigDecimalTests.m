@@ -0,0 +1,360 @@
+//
+//  EWCBigDecimalTests.m
+//  EbbyCalcTests
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <XCTest/XCTest.h>
+#import "../EbbyCalc/EWCBigDecimal.h"
+#import "../EbbyCalc/EWCCalculatorKey.h"
+#import "../EbbyCalc/EWCTapeCompiler.h"
+#import "../EbbyCalc/EWCTapeProgram.h"
+
+static NSString * const s_auditTape = @"19.99*2=ws5.25*4=ws100*1=wsa";
+static const int s_benchmarkIterations = 100;
+
+@interface EWCBigDecimalTests : XCTestCase
+
+@end
+
+@implementation EWCBigDecimalTests
+
+/**
+  Parses a value, failing the test if it doesn't parse.
+ */
+- (void)setValue:(EWCBigDecimal *)value fromString:(NSString *)str {
+  XCTAssertTrue(EWCBigDecimalSetString(value, str.UTF8String), @"%@", str);
+}
+
+- (NSString *)stringFromValue:(const EWCBigDecimal *)value {
+  size_t length = EWCBigDecimalToString(value, NULL, 0);
+  char buffer[length + 1];
+  EWCBigDecimalToString(value, buffer, sizeof(buffer));
+
+  return @(buffer);
+}
+
+/**
+  Builds a value with the given number of random digits.
+ */
+- (void)setValue:(EWCBigDecimal *)value randomDigits:(int)count seed:(unsigned)seed {
+  uint8_t digits[count];
+  srandom(seed);
+  for (int i = 0; i < count; ++i) {
+    digits[i] = (uint8_t)(random() % 10);
+  }
+  digits[0] = 1 + digits[0] % 9;
+
+  EWCBigDecimalSetDigits(value, digits, count, -count / 2, NO);
+}
+
+- (EWCTapeProgram *)programForKeys:(NSString *)str maximumDigits:(NSInteger)maximumDigits {
+  EWCCalculatorKey keys[str.length];
+  for (NSUInteger i = 0; i < str.length; ++i) {
+    keys[i] = EWCCalculatorKeyFromCharacter([str characterAtIndex:i]);
+  }
+
+  return [[EWCTapeCompiler compilerWithMaximumDigits:maximumDigits] compileKeys:keys count:str.length];
+}
+
+- (void)testStringRoundTrip {
+  EWCBigDecimal value;
+  EWCBigDecimalInit(&value);
+
+  for (NSString *str in @[ @"0", @"1", @"-1", @"0.5", @"-0.0625", @"1000000000",
+    @"123456789012345678901234567890123456789012345678901234567890",
+    @"0.000000000000000000000000000000000000000000001" ]) {
+    [self setValue:&value fromString:str];
+    XCTAssertEqualObjects([self stringFromValue:&value], str);
+  }
+
+  // trailing fraction zeros and exponents are folded away
+  [self setValue:&value fromString:@"1.2500"];
+  XCTAssertEqualObjects([self stringFromValue:&value], @"1.25");
+  [self setValue:&value fromString:@"-12e-3"];
+  XCTAssertEqualObjects([self stringFromValue:&value], @"-0.012");
+
+  XCTAssertFalse(EWCBigDecimalSetString(&value, "1.2.3"));
+  XCTAssertFalse(EWCBigDecimalSetString(&value, ""));
+
+  EWCBigDecimalFree(&value);
+}
+
+- (void)testAddAndSubtractAlignDigits {
+  EWCBigDecimal a, b, result;
+  EWCBigDecimalInit(&a);
+  EWCBigDecimalInit(&b);
+  EWCBigDecimalInit(&result);
+
+  [self setValue:&a fromString:@"99999999999999999999999999999999999999999.999"];
+  [self setValue:&b fromString:@"0.001"];
+  EWCBigDecimalAdd(&result, &a, &b);
+  XCTAssertEqualObjects([self stringFromValue:&result], @"100000000000000000000000000000000000000000");
+
+  EWCBigDecimalSubtract(&result, &b, &a);
+  XCTAssertEqualObjects([self stringFromValue:&result], @"-99999999999999999999999999999999999999999.998");
+
+  // results may be their own operands
+  EWCBigDecimalSubtract(&a, &a, &a);
+  XCTAssertTrue(EWCBigDecimalIsZero(&a));
+
+  EWCBigDecimalFree(&a);
+  EWCBigDecimalFree(&b);
+  EWCBigDecimalFree(&result);
+}
+
+- (void)testKaratsubaMatchesSchoolbook {
+  EWCBigDecimal a, b, karatsuba, schoolbook;
+  EWCBigDecimalInit(&a);
+  EWCBigDecimalInit(&b);
+  EWCBigDecimalInit(&karatsuba);
+  EWCBigDecimalInit(&schoolbook);
+
+  // both balanced and lopsided operands, either side of the threshold
+  int sizes[][2] = { { 40, 40 }, { 300, 300 }, { 1000, 1000 }, { 2000, 350 }, { 5000, 4000 } };
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+    [self setValue:&a randomDigits:sizes[i][0] seed:(unsigned)i];
+    [self setValue:&b randomDigits:sizes[i][1] seed:(unsigned)i + 100];
+    EWCBigDecimalMultiply(&karatsuba, &a, &b);
+    EWCBigDecimalMultiplySchoolbook(&schoolbook, &a, &b);
+    XCTAssertEqual(EWCBigDecimalCompare(&karatsuba, &schoolbook), 0, @"%d × %d", sizes[i][0], sizes[i][1]);
+  }
+
+  EWCBigDecimalFree(&a);
+  EWCBigDecimalFree(&b);
+  EWCBigDecimalFree(&karatsuba);
+  EWCBigDecimalFree(&schoolbook);
+}
+
+- (void)testDivideRoundsHalfUp {
+  EWCBigDecimal a, b, result;
+  EWCBigDecimalInit(&a);
+  EWCBigDecimalInit(&b);
+  EWCBigDecimalInit(&result);
+
+  EWCBigDecimalSetInteger(&a, 1);
+  EWCBigDecimalSetInteger(&b, 3);
+  XCTAssertTrue(EWCBigDecimalDivide(&result, &a, &b, 50));
+  XCTAssertEqualObjects([self stringFromValue:&result], [@"0." stringByPaddingToLength:52 withString:@"3" startingAtIndex:0]);
+
+  EWCBigDecimalSetInteger(&b, -8);
+  XCTAssertTrue(EWCBigDecimalDivide(&result, &a, &b, 2));
+  XCTAssertEqualObjects([self stringFromValue:&result], @"-0.13");
+
+  EWCBigDecimalSetInteger(&b, 0);
+  XCTAssertFalse(EWCBigDecimalDivide(&result, &a, &b, 10));
+
+  EWCBigDecimalFree(&a);
+  EWCBigDecimalFree(&b);
+  EWCBigDecimalFree(&result);
+}
+
+- (void)testDivideUndoesMultiply {
+  EWCBigDecimal a, b, product, quotient;
+  EWCBigDecimalInit(&a);
+  EWCBigDecimalInit(&b);
+  EWCBigDecimalInit(&product);
+  EWCBigDecimalInit(&quotient);
+
+  for (int digits = 40; digits <= 1000; digits *= 5) {
+    [self setValue:&a randomDigits:digits seed:(unsigned)digits];
+    [self setValue:&b randomDigits:digits seed:(unsigned)digits + 1];
+    EWCBigDecimalMultiply(&product, &a, &b);
+    XCTAssertTrue(EWCBigDecimalDivide(&quotient, &product, &b, digits));
+    XCTAssertEqual(EWCBigDecimalCompare(&quotient, &a), 0, @"%d digits", digits);
+  }
+
+  EWCBigDecimalFree(&a);
+  EWCBigDecimalFree(&b);
+  EWCBigDecimalFree(&product);
+  EWCBigDecimalFree(&quotient);
+}
+
+- (void)testSqrt {
+  EWCBigDecimal value, root;
+  EWCBigDecimalInit(&value);
+  EWCBigDecimalInit(&root);
+
+  EWCBigDecimalSetInteger(&value, 2);
+  XCTAssertTrue(EWCBigDecimalSqrt(&root, &value, 50));
+  XCTAssertEqualObjects([self stringFromValue:&root], @"1.4142135623730950488016887242096980785696718753769");
+
+  [self setValue:&value fromString:@"0.0625"];
+  XCTAssertTrue(EWCBigDecimalSqrt(&root, &value, 100));
+  XCTAssertEqualObjects([self stringFromValue:&root], @"0.25");
+
+  EWCBigDecimalSetInteger(&value, -4);
+  XCTAssertFalse(EWCBigDecimalSqrt(&root, &value, 10));
+
+  EWCBigDecimalFree(&value);
+  EWCBigDecimalFree(&root);
+}
+
+- (void)testRoundAndTruncateToScale {
+  EWCBigDecimal value, result;
+  EWCBigDecimalInit(&value);
+  EWCBigDecimalInit(&result);
+
+  [self setValue:&value fromString:@"-2.675"];
+  EWCBigDecimalRoundToScale(&result, &value, 2);
+  XCTAssertEqualObjects([self stringFromValue:&result], @"-2.68");
+  EWCBigDecimalTruncateToScale(&result, &value, 2);
+  XCTAssertEqualObjects([self stringFromValue:&result], @"-2.67");
+
+  [self setValue:&value fromString:@"999.96"];
+  EWCBigDecimalRound(&result, &value, 4);
+  XCTAssertEqualObjects([self stringFromValue:&result], @"1000");
+
+  EWCBigDecimalFree(&value);
+  EWCBigDecimalFree(&result);
+}
+
+///----------------------
+/// @name Wide Tape Tests
+///----------------------
+
+- (void)testWideRunKeepsDigitsBeyondNative {
+  EWCTapeProgram *program = [self programForKeys:@"1/3=" maximumDigits:60];
+  XCTAssertTrue(program.usesWideArithmetic);
+
+  EWCBigDecimal inputs[2];
+  EWCBigDecimalInit(&inputs[0]);
+  EWCBigDecimalInit(&inputs[1]);
+  EWCBigDecimalSetInteger(&inputs[0], 1);
+  EWCBigDecimalSetInteger(&inputs[1], 3);
+
+  EWCTapeWideResult result;
+  EWCTapeWideResultInit(&result);
+  [program runWithWideInputs:inputs result:&result];
+  XCTAssertFalse(result.error);
+
+  // a leading zero leaves 59 places for the fraction
+  XCTAssertEqualObjects([self stringFromValue:&result.display],
+    [@"0." stringByPaddingToLength:61 withString:@"3" startingAtIndex:0]);
+
+  // dividing by zero is reported rather than replayed
+  EWCBigDecimalSetInteger(&inputs[1], 0);
+  [program runWithWideInputs:inputs result:&result];
+  XCTAssertTrue(result.error);
+
+  EWCTapeWideResultFree(&result);
+  EWCBigDecimalFree(&inputs[0]);
+  EWCBigDecimalFree(&inputs[1]);
+}
+
+- (void)testWideSqrtAndTypedInputs {
+  EWCTapeProgram *program = [self programForKeys:@"2y" maximumDigits:50];
+
+  EWCBigDecimal input;
+  EWCBigDecimalInit(&input);
+  EWCBigDecimalSetInteger(&input, 2);
+
+  EWCTapeWideResult result;
+  EWCTapeWideResultInit(&result);
+  [program runWithWideInputs:&input result:&result];
+  XCTAssertEqualObjects([self stringFromValue:&result.display], @"1.4142135623730950488016887242096980785696718753769");
+
+  // typing drops the digits past the maximum, rather than rounding them
+  program = [self programForKeys:@"1+0=" maximumDigits:40];
+  EWCBigDecimal inputs[2];
+  EWCBigDecimalInit(&inputs[0]);
+  EWCBigDecimalInit(&inputs[1]);
+  [self setValue:&inputs[0] fromString:@"0.99999999999999999999999999999999999999999999"];
+  EWCBigDecimalSetInteger(&inputs[1], 0);
+  [program runWithWideInputs:inputs result:&result];
+  XCTAssertEqualObjects([self stringFromValue:&result.display], @"0.999999999999999999999999999999999999999");
+
+  EWCTapeWideResultFree(&result);
+  EWCBigDecimalFree(&input);
+  EWCBigDecimalFree(&inputs[0]);
+  EWCBigDecimalFree(&inputs[1]);
+}
+
+- (void)testWideRunMatchesNativeRun {
+  EWCTapeProgram *program = [self programForKeys:s_auditTape maximumDigits:16];
+  program.startingTaxRate = [NSDecimalNumber decimalNumberWithString:@"8"];
+  XCTAssertFalse(program.usesWideArithmetic);
+
+  NSDecimal inputs[6];
+  [program getTemplateInputs:inputs];
+  EWCTapeResult expected;
+  [program runWithInputs:inputs result:&expected];
+
+  EWCBigDecimal wideInputs[6];
+  for (int i = 0; i < 6; ++i) {
+    EWCBigDecimalInit(&wideInputs[i]);
+  }
+  [program getWideTemplateInputs:wideInputs];
+
+  EWCTapeWideResult result;
+  EWCTapeWideResultInit(&result);
+  [program runWithWideInputs:wideInputs result:&result];
+
+  XCTAssertFalse(result.error);
+  XCTAssertEqual(result.hasMemory, expected.hasMemory);
+  XCTAssertEqualObjects([NSDecimalNumber decimalNumberWithString:[self stringFromValue:&result.display]],
+    [NSDecimalNumber decimalNumberWithDecimal:expected.display]);
+  XCTAssertEqualObjects([NSDecimalNumber decimalNumberWithString:[self stringFromValue:&result.memory]],
+    [NSDecimalNumber decimalNumberWithDecimal:expected.memory]);
+
+  EWCTapeWideResultFree(&result);
+  for (int i = 0; i < 6; ++i) {
+    EWCBigDecimalFree(&wideInputs[i]);
+  }
+}
+
+///------------------------
+/// @name Performance Tests
+///------------------------
+
+/**
+  Measures multiplying and dividing values of a given number of digits.
+ */
+- (void)measureArithmeticWithDigits:(int)digits {
+  __block EWCBigDecimal a, b, result;
+  EWCBigDecimalInit(&a);
+  EWCBigDecimalInit(&b);
+  EWCBigDecimalInit(&result);
+  [self setValue:&a randomDigits:digits seed:1];
+  [self setValue:&b randomDigits:digits seed:2];
+
+  [self measureBlock:^{
+    for (int i = 0; i < s_benchmarkIterations; ++i) {
+      EWCBigDecimalMultiply(&result, &a, &b);
+      EWCBigDecimalDivide(&result, &a, &b, digits);
+    }
+  }];
+
+  EWCBigDecimalFree(&a);
+  EWCBigDecimalFree(&b);
+  EWCBigDecimalFree(&result);
+}
+
+- (void)testPerformance40Digits {
+  [self measureArithmeticWithDigits:40];
+}
+
+- (void)testPerformance100Digits {
+  [self measureArithmeticWithDigits:100];
+}
+
+- (void)testPerformance1000Digits {
+  [self measureArithmeticWithDigits:1000];
+}
+
+@end
@@ -0,0 +1,237 @@
+//
+//  EWCCalculatorChangeTests.m
+//  EbbyCalcTests
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <XCTest/XCTest.h>
+#import "../EbbyCalc/EWCCalculator.h"
+
+@interface EWCCalculatorChangeTests : XCTestCase {
+  EWCCalculator *_calculator;
+}
+
+@end
+
+@implementation EWCCalculatorChangeTests
+
+- (void)setUp {
+  _calculator = [EWCCalculator new];
+  _calculator.locale = [NSLocale localeWithLocaleIdentifier:@"en_US"];
+}
+
+- (void)testNewCalculatorReportsEverything {
+  XCTAssertEqual(_calculator.lastChanges, EWCCalculatorAllChanges);
+}
+
+- (void)testDigitChangesDisplayValue {
+  [_calculator pressKey:EWCCalculatorThreeKey];
+  XCTAssertEqual(_calculator.lastChanges, EWCCalculatorDisplayValueChange);
+}
+
+- (void)testTrailingZeroChangesOnlyFractionDigits {
+  [_calculator pressKey:EWCCalculatorOneKey];
+  [_calculator pressKey:EWCCalculatorDecimalKey];
+  [_calculator pressKey:EWCCalculatorZeroKey];
+  XCTAssertEqual(_calculator.lastChanges, EWCCalculatorFractionDigitsChange);
+  XCTAssertEqualObjects(_calculator.displayContent, @"1.0");
+}
+
+- (void)testUnchangedInputReportsNoChange {
+  [_calculator pressKey:EWCCalculatorClearKey];
+  XCTAssertEqual(_calculator.lastChanges, EWCCalculatorNoChange);
+
+  [_calculator pressKey:EWCCalculatorThreeKey];
+  [_calculator pressKey:EWCCalculatorAddKey];
+  XCTAssertEqual(_calculator.lastChanges, EWCCalculatorNoChange);
+}
+
+- (void)testMemoryChanges {
+  [_calculator pressKey:EWCCalculatorThreeKey];
+  [_calculator pressKey:EWCCalculatorMemoryPlusKey];
+  XCTAssertTrue(_calculator.lastChanges & EWCCalculatorMemoryChange);
+  XCTAssertFalse(_calculator.lastChanges & EWCCalculatorDisplayValueChange);
+
+  [_calculator pressKey:EWCCalculatorMemoryKey];
+  XCTAssertTrue(_calculator.lastChanges & EWCCalculatorMemoryClearChange);
+  XCTAssertFalse(_calculator.lastChanges & EWCCalculatorMemoryChange);
+
+  [_calculator pressKey:EWCCalculatorMemoryKey];
+  XCTAssertTrue(_calculator.lastChanges & EWCCalculatorMemoryChange);
+  XCTAssertFalse(_calculator.hasMemory);
+}
+
+- (void)testStatusChanges {
+  [_calculator pressKey:EWCCalculatorRateKey];
+  XCTAssertTrue(_calculator.lastChanges & EWCCalculatorRateShiftChange);
+
+  [_calculator pressKey:EWCCalculatorRateKey];
+  XCTAssertTrue(_calculator.lastChanges & EWCCalculatorRateShiftChange);
+
+  [_calculator pressKey:EWCCalculatorTaxPlusKey];
+  XCTAssertTrue(_calculator.lastChanges & EWCCalculatorTaxPlusStatusChange);
+
+  [_calculator pressKey:EWCCalculatorTaxPlusKey];
+  XCTAssertTrue(_calculator.lastChanges & EWCCalculatorTaxPlusStatusChange);
+  XCTAssertTrue(_calculator.lastChanges & EWCCalculatorTaxStatusChange);
+}
+
+- (void)testErrorChanges {
+  [_calculator pressKey:EWCCalculatorFourKey];
+  [_calculator pressKey:EWCCalculatorSignKey];
+  [_calculator pressKey:EWCCalculatorSqrtKey];
+  XCTAssertTrue(_calculator.lastChanges & EWCCalculatorErrorChange);
+
+  [_calculator pressKey:EWCCalculatorClearKey];
+  XCTAssertTrue(_calculator.lastChanges & EWCCalculatorErrorChange);
+}
+
+- (void)testSetInputReportsChanges {
+  [_calculator setInput:[NSDecimalNumber decimalNumberWithString:@"12.5"]];
+  XCTAssertEqual(_calculator.lastChanges, EWCCalculatorDisplayValueChange);
+  XCTAssertEqualObjects(_calculator.displayContent, @"12.5");
+}
+
+- (void)testDisplayContentIsMemoized {
+  [_calculator pressKey:EWCCalculatorThreeKey];
+  NSString *content = _calculator.displayContent;
+  NSString *accessible = _calculator.displayAccessibleContent;
+
+  // an input that doesn't change the display reuses the strings
+  [_calculator pressKey:EWCCalculatorAddKey];
+  XCTAssertEqual(_calculator.displayContent, content);
+  XCTAssertEqual(_calculator.displayAccessibleContent, accessible);
+
+  // a display change recomputes them
+  [_calculator pressKey:EWCCalculatorFourKey];
+  XCTAssertEqualObjects(_calculator.displayContent, @"4.");
+  XCTAssertNotEqualObjects(_calculator.displayAccessibleContent, accessible);
+}
+
+- (void)testLocaleChangeRecomputesDisplayContent {
+  [self applyDigits:@"12345"];
+  XCTAssertEqualObjects(_calculator.displayContent, @"12,345.");
+
+  _calculator.locale = [NSLocale localeWithLocaleIdentifier:@"de_DE"];
+  XCTAssertEqualObjects(_calculator.displayContent, @"12.345,");
+}
+
+- (void)testObserversReceiveOnlyTheirChanges {
+  __block EWCCalculatorChange displayChanges = EWCCalculatorNoChange;
+  __block NSInteger displayCount = 0;
+  [_calculator addObserverForChanges:EWCCalculatorDisplayContentChanges usingBlock:^(EWCCalculatorChange changes) {
+    displayChanges = changes;
+    ++displayCount;
+  }];
+
+  __block NSInteger memoryCount = 0;
+  [_calculator addObserverForChanges:EWCCalculatorMemoryChange usingBlock:^(EWCCalculatorChange changes) {
+    XCTAssertEqual(changes, EWCCalculatorMemoryChange);
+    ++memoryCount;
+  }];
+
+  [_calculator pressKey:EWCCalculatorThreeKey];
+  XCTAssertEqual(displayChanges, EWCCalculatorDisplayValueChange);
+  XCTAssertEqual(displayCount, 1);
+  XCTAssertEqual(memoryCount, 0);
+
+  [_calculator pressKey:EWCCalculatorMemoryPlusKey];
+  XCTAssertEqual(displayCount, 1);
+  XCTAssertEqual(memoryCount, 1);
+}
+
+- (void)testRemovedObserverIsNotNotified {
+  __block NSInteger count = 0;
+  id<NSObject> token = [_calculator addObserverForChanges:EWCCalculatorAllChanges usingBlock:^(EWCCalculatorChange changes) {
+    ++count;
+  }];
+
+  [_calculator pressKey:EWCCalculatorOneKey];
+  XCTAssertEqual(count, 1);
+
+  [_calculator removeObserver:token];
+  [_calculator pressKey:EWCCalculatorTwoKey];
+  XCTAssertEqual(count, 1);
+}
+
+- (void)testObserverCanUnsubscribeWhileNotified {
+  __block NSInteger count = 0;
+  __block id<NSObject> token = nil;
+  EWCCalculator *calculator = _calculator;
+  token = [_calculator addObserverForChanges:EWCCalculatorAllChanges usingBlock:^(EWCCalculatorChange changes) {
+    ++count;
+    [calculator removeObserver:token];
+    token = nil;
+  }];
+
+  [_calculator pressKey:EWCCalculatorOneKey];
+  [_calculator pressKey:EWCCalculatorTwoKey];
+  XCTAssertEqual(count, 1);
+}
+
+- (void)testBatchCoalescesNotifications {
+  __block NSInteger observerCount = 0;
+  __block EWCCalculatorChange observed = EWCCalculatorNoChange;
+  [_calculator addObserverForChanges:EWCCalculatorAllChanges usingBlock:^(EWCCalculatorChange changes) {
+    observed = changes;
+    ++observerCount;
+  }];
+
+  __block NSInteger callbackCount = 0;
+  [_calculator registerUpdateCallbackWithBlock:^{
+    ++callbackCount;
+  }];
+
+  [_calculator performBatchUpdates:^{
+    [self applyDigits:@"123"];
+    [self->_calculator performBatchUpdates:^{
+      [self->_calculator pressKey:EWCCalculatorMemoryPlusKey];
+    }];
+    XCTAssertEqual(observerCount, 0);
+  }];
+
+  XCTAssertEqual(observerCount, 1);
+  XCTAssertEqual(callbackCount, 1);
+  XCTAssertEqual(observed, EWCCalculatorDisplayValueChange | EWCCalculatorMemoryChange);
+  XCTAssertEqual(_calculator.lastChanges, observed);
+}
+
+- (void)testBatchReportsNetChange {
+  __block NSInteger count = 0;
+  [_calculator addObserverForChanges:EWCCalculatorRateShiftChange usingBlock:^(EWCCalculatorChange changes) {
+    ++count;
+  }];
+
+  // shifting and unshifting within a batch is no change at all
+  [_calculator performBatchUpdates:^{
+    [self->_calculator pressKey:EWCCalculatorRateKey];
+    [self->_calculator pressKey:EWCCalculatorRateKey];
+  }];
+
+  XCTAssertEqual(count, 0);
+  XCTAssertFalse(_calculator.lastChanges & EWCCalculatorRateShiftChange);
+}
+
+- (void)applyDigits:(NSString *)digits {
+  for (NSUInteger i = 0; i < digits.length; ++i) {
+    EWCCalculatorKey key = (EWCCalculatorKey)([digits characterAtIndex:i] - '0');
+    [_calculator pressKey:key];
+  }
+}
+
+@end
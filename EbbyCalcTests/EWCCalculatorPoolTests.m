@@ -0,0 +1,132 @@
+//
+//  EWCCalculatorPoolTests.m
+//  EbbyCalcTests
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <XCTest/XCTest.h>
+#import <objc/runtime.h>
+#import "../EbbyCalc/EWCCalculator.h"
+#import "../EbbyCalc/EWCCalculatorPool.h"
+#import "../EbbyCalc/EWCCalculatorState.h"
+
+static const int s_benchmarkIterations = 10000;
+
+@interface EWCCalculatorPoolTests : XCTestCase {
+  EWCCalculatorPool *_pool;
+}
+
+@end
+
+@implementation EWCCalculatorPoolTests
+
+- (void)setUp {
+  _pool = [EWCCalculatorPool poolWithLocale:[NSLocale localeWithLocaleIdentifier:@"en_US"]
+    maximumDigits:16];
+}
+
+- (void)pressKeys:(NSString *)keys on:(EWCCalculator *)calculator {
+  for (NSUInteger i = 0; i < keys.length; ++i) {
+    [calculator pressKey:EWCCalculatorKeyFromCharacter([keys characterAtIndex:i])];
+  }
+}
+
+- (void)testReleasedCalculatorIsReused {
+  EWCCalculator *calculator = [_pool acquireCalculator];
+  [self pressKeys:@"12+3=s5qw" on:calculator];
+  [_pool releaseCalculator:calculator];
+  XCTAssertEqual(_pool.count, 1);
+
+  XCTAssertEqual([_pool acquireCalculator], calculator);
+  XCTAssertEqual(_pool.count, 0);
+}
+
+- (void)testReusedCalculatorMatchesNewCalculator {
+  EWCCalculator *calculator = [_pool acquireCalculator];
+  [self pressKeys:@"9s2qw.5\\*" on:calculator];
+  [_pool releaseCalculator:calculator];
+  calculator = [_pool acquireCalculator];
+
+  EWCCalculator *fresh = [EWCCalculator calculator];
+  fresh.locale = _pool.locale;
+  fresh.maximumDigits = _pool.maximumDigits;
+
+  XCTAssertEqualObjects(calculator.displayContent, fresh.displayContent);
+  XCTAssertFalse(calculator.hasMemory);
+  XCTAssertFalse(calculator.hasError);
+  XCTAssertFalse(calculator.isRateShifted);
+  XCTAssertFalse(calculator.isTaxPercentStatusVisible);
+
+  // and it calculates the same from there, including the cleared tax rate
+  NSString *keys = @"7.25+1.5=w%<3";
+  [self pressKeys:keys on:calculator];
+  [self pressKeys:keys on:fresh];
+  XCTAssertEqualObjects(calculator.displayValue, fresh.displayValue);
+  XCTAssertEqualObjects(calculator.displayContent, fresh.displayContent);
+}
+
+- (void)testPoolIsBounded {
+  _pool.maximumSize = 2;
+  [_pool preallocate:5];
+  XCTAssertEqual(_pool.count, 2);
+
+  EWCCalculator *a = [_pool acquireCalculator];
+  EWCCalculator *b = [_pool acquireCalculator];
+  EWCCalculator *c = [_pool acquireCalculator];
+  [_pool releaseCalculator:a];
+  [_pool releaseCalculator:b];
+  [_pool releaseCalculator:c];
+  XCTAssertEqual(_pool.count, 2);
+
+  _pool.maximumSize = 1;
+  XCTAssertEqual(_pool.count, 1);
+}
+
+- (void)testCalculatorStateIsHeldInline {
+  // the calculation state is part of the calculator instance, rather than
+  // objects of its own
+  XCTAssertGreaterThan(class_getInstanceSize([EWCCalculator class]), sizeof(EWCCalculatorState));
+}
+
+///------------------------
+/// @name Performance Tests
+///------------------------
+
+- (void)testPerformanceConstruction {
+  [self measureBlock:^{
+    for (int i = 0; i < s_benchmarkIterations; ++i) {
+      EWCCalculator *calculator = [EWCCalculator calculator];
+      calculator.maximumDigits = 16;
+      [calculator pressKey:EWCCalculatorOneKey];
+    }
+  }];
+}
+
+- (void)testPerformancePooledReuse {
+  [_pool preallocate:1];
+
+  [self measureBlock:^{
+    for (int i = 0; i < s_benchmarkIterations; ++i) {
+      EWCCalculator *calculator = [self->_pool acquireCalculator];
+      [calculator pressKey:EWCCalculatorOneKey];
+      [self->_pool releaseCalculator:calculator];
+    }
+  }];
+}
+
+@end
@@ -0,0 +1,265 @@
+//
+//  EWCCalculatorSharedDataTests.m
+//  EbbyCalcTests
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <XCTest/XCTest.h>
+#import <stdatomic.h>
+#import "../EbbyCalc/EWCCalculator.h"
+#import "../EbbyCalc/EWCCalculatorSharedData.h"
+
+static const int s_calculatorCount = 64;
+static const int s_keysPerCalculator = 200;
+static const int s_stressWriteCount = 20000;
+static const int s_stressReaderCount = 4;
+
+/**
+  A backing store that counts the writes it receives.
+ */
+@interface EWCCountingDataStore : NSObject<EWCCalculatorDataProtocol>
+
+@property (nonatomic) NSDecimalNumber *taxRate;
+@property (nonatomic) NSDecimalNumber *memory;
+@property (nonatomic) NSInteger taxRateWrites;
+@property (nonatomic) NSInteger memoryWrites;
+
+@end
+
+@implementation EWCCountingDataStore
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _taxRate = [NSDecimalNumber decimalNumberWithString:@"8"];
+    _memory = [NSDecimalNumber zero];
+  }
+
+  return self;
+}
+
+- (void)setTaxRate:(NSDecimalNumber *)taxRate {
+  _taxRate = taxRate;
+  ++_taxRateWrites;
+}
+
+- (void)setMemory:(NSDecimalNumber *)memory {
+  _memory = memory;
+  ++_memoryWrites;
+}
+
+@end
+
+@interface EWCCalculatorSharedDataTests : XCTestCase
+
+@end
+
+@implementation EWCCalculatorSharedDataTests
+
+- (EWCCalculator *)newCalculatorWithData:(EWCCalculatorSharedData *)data {
+  EWCCalculator *calculator = [EWCCalculator new];
+  calculator.locale = [NSLocale localeWithLocaleIdentifier:@"en_US"];
+  calculator.maximumDigits = 16;
+  calculator.dataProvider = data;
+
+  return calculator;
+}
+
+- (void)pressKeys:(NSString *)keys onCalculator:(EWCCalculator *)calculator {
+  for (NSUInteger i = 0; i < keys.length; ++i) {
+    [calculator pressKey:EWCCalculatorKeyFromCharacter([keys characterAtIndex:i])];
+  }
+}
+
+- (void)testReadsBackingStoreOnce {
+  EWCCountingDataStore *store = [EWCCountingDataStore new];
+  EWCCalculatorSharedData *data = [EWCCalculatorSharedData dataWithBackingStore:store flushDelay:60];
+
+  store.taxRate = [NSDecimalNumber decimalNumberWithString:@"5"];
+  XCTAssertEqualObjects(data.taxRate, [NSDecimalNumber decimalNumberWithString:@"8"]);
+  XCTAssertEqual(data.version, 0);
+}
+
+- (void)testVersionAdvancesOnlyOnChange {
+  EWCCalculatorSharedData *data = [EWCCalculatorSharedData new];
+
+  data.memory = [NSDecimalNumber decimalNumberWithString:@"12.5"];
+  XCTAssertEqual(data.version, 1);
+
+  data.memory = [NSDecimalNumber decimalNumberWithString:@"12.50"];
+  XCTAssertEqual(data.version, 1);
+
+  data.taxRate = [NSDecimalNumber decimalNumberWithString:@"7"];
+  XCTAssertEqual(data.version, 2);
+  XCTAssertEqualObjects(data.memory, [NSDecimalNumber decimalNumberWithString:@"12.5"]);
+  XCTAssertEqualObjects(data.taxRate, [NSDecimalNumber decimalNumberWithString:@"7"]);
+}
+
+- (void)testWritesAreBatched {
+  EWCCountingDataStore *store = [EWCCountingDataStore new];
+  EWCCalculatorSharedData *data = [EWCCalculatorSharedData dataWithBackingStore:store flushDelay:60];
+
+  for (int i = 1; i <= 100; ++i) {
+    data.memory = [NSDecimalNumber decimalNumberWithMantissa:i exponent:0 isNegative:NO];
+  }
+  XCTAssertEqual(store.memoryWrites, 0);
+
+  [data flush];
+  XCTAssertEqual(store.memoryWrites, 1);
+  XCTAssertEqual(store.taxRateWrites, 0);
+  XCTAssertEqualObjects(store.memory, [NSDecimalNumber decimalNumberWithString:@"100"]);
+
+  // nothing left to write
+  [data flush];
+  XCTAssertEqual(store.memoryWrites, 1);
+}
+
+- (void)testScheduledFlushWritesChanges {
+  EWCCountingDataStore *store = [EWCCountingDataStore new];
+  EWCCalculatorSharedData *data = [EWCCalculatorSharedData dataWithBackingStore:store flushDelay:0.05];
+
+  data.taxRate = [NSDecimalNumber decimalNumberWithString:@"9.5"];
+  data.taxRate = [NSDecimalNumber decimalNumberWithString:@"10"];
+
+  XCTestExpectation *expectation = [self expectationWithDescription:@"flushed"];
+  dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.5 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+    XCTAssertEqual(store.taxRateWrites, 1);
+    XCTAssertEqualObjects(store.taxRate, [NSDecimalNumber decimalNumberWithString:@"10"]);
+    [expectation fulfill];
+  });
+
+  [self waitForExpectationsWithTimeout:5 handler:nil];
+}
+
+- (void)testPostsVersionedNotification {
+  EWCCalculatorSharedData *data = [EWCCalculatorSharedData new];
+
+  [self expectationForNotification:EWCCalculatorSharedDataDidChangeNotification
+    object:data
+    handler:^BOOL(NSNotification *notification) {
+      return [notification.userInfo[EWCCalculatorSharedDataVersionKey] unsignedLongLongValue] == 1;
+    }];
+
+  data.memory = [NSDecimalNumber decimalNumberWithString:@"3"];
+
+  [self waitForExpectationsWithTimeout:5 handler:nil];
+}
+
+- (void)testCalculatorsSeeEachOthersChanges {
+  EWCCalculatorSharedData *data = [EWCCalculatorSharedData new];
+  EWCCalculator *first = [self newCalculatorWithData:data];
+  EWCCalculator *second = [self newCalculatorWithData:data];
+
+  [self pressKeys:@"25s" onCalculator:first];
+  XCTAssertEqualObjects(data.memory, [NSDecimalNumber decimalNumberWithString:@"25"]);
+
+  // an idle calculator catches up when refreshed
+  XCTAssertFalse(second.hasMemory);
+  XCTAssertTrue([second refreshFromDataProvider]);
+  XCTAssertTrue(second.hasMemory);
+  XCTAssertTrue(second.lastChanges & EWCCalculatorMemoryChange);
+  XCTAssertFalse([second refreshFromDataProvider]);
+
+  // and one that is used catches up before the input
+  [self pressKeys:@"5s" onCalculator:second];
+  [self pressKeys:@"a" onCalculator:first];
+  XCTAssertEqualObjects(first.displayValue, [NSDecimalNumber decimalNumberWithString:@"30"]);
+
+  // the tax rate is shared too
+  [self pressKeys:@"7qw" onCalculator:second];
+  [self pressKeys:@"100w" onCalculator:first];
+  XCTAssertEqualObjects(first.displayValue, [NSDecimalNumber decimalNumberWithString:@"107"]);
+}
+
+- (void)testManyConcurrentCalculators {
+  EWCCountingDataStore *store = [EWCCountingDataStore new];
+  EWCCalculatorSharedData *data = [EWCCalculatorSharedData dataWithBackingStore:store flushDelay:60];
+
+  NSMutableArray<EWCCalculator *> *calculators = [NSMutableArray new];
+  for (int i = 0; i < s_calculatorCount; ++i) {
+    [calculators addObject:[self newCalculatorWithData:data]];
+  }
+
+  // each calculator is only used from one thread at a time, but they all
+  // share the data
+  dispatch_apply(s_calculatorCount, dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^(size_t index) {
+    EWCCalculator *calculator = calculators[index];
+    for (int i = 0; i < s_keysPerCalculator; ++i) {
+      EWCCalculatorKey digit = (EWCCalculatorKey)(EWCCalculatorZeroKey + (index + i) % 10);
+      [calculator pressKey:EWCCalculatorClearKey];
+      [calculator pressKey:digit];
+      [calculator pressKey:(i % 4) ? EWCCalculatorMemoryPlusKey : EWCCalculatorMemoryMinusKey];
+    }
+  });
+
+  // every memory add and subtract is counted
+  NSInteger sum = 0;
+  for (int index = 0; index < s_calculatorCount; ++index) {
+    for (int i = 0; i < s_keysPerCalculator; ++i) {
+      NSInteger digit = (index + i) % 10;
+      sum += (i % 4) ? digit : -digit;
+    }
+  }
+  NSDecimalNumber *memory = data.memory;
+  XCTAssertEqualObjects(memory, [NSDecimalNumber decimalNumberWithMantissa:(unsigned long long)labs(sum)
+    exponent:0
+    isNegative:(sum < 0)]);
+
+  // every calculator agrees with the shared value once it catches up
+  for (EWCCalculator *calculator in calculators) {
+    [calculator refreshFromDataProvider];
+    XCTAssertEqualObjects(calculator.memoryValue, memory);
+  }
+
+  // the store was written once, with the final value
+  [data flush];
+  XCTAssertLessThanOrEqual(store.memoryWrites, 1);
+  XCTAssertEqualObjects(store.memory, memory);
+}
+
+- (void)testReadersNeverSeeTornValues {
+  EWCCalculatorSharedData *data = [EWCCalculatorSharedData new];
+  NSDecimalNumber *small = [NSDecimalNumber decimalNumberWithString:@"1"];
+  NSDecimalNumber *large = [NSDecimalNumber decimalNumberWithString:@"-123456789012345.678901234"];
+  data.memory = small;
+
+  __block atomic_bool done = NO;
+  __block atomic_int torn = 0;
+
+  dispatch_group_t group = dispatch_group_create();
+  for (int r = 0; r < s_stressReaderCount; ++r) {
+    dispatch_group_async(group, dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^{
+      while (! atomic_load(&done)) {
+        NSDecimalNumber *value = data.memory;
+        if (! [value isEqualToNumber:small] && ! [value isEqualToNumber:large]) {
+          atomic_fetch_add(&torn, 1);
+        }
+      }
+    });
+  }
+
+  for (int i = 0; i < s_stressWriteCount; ++i) {
+    data.memory = (i % 2) ? small : large;
+  }
+  atomic_store(&done, YES);
+  dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+
+  XCTAssertEqual(atomic_load(&torn), 0);
+}
+
+@end
@@ -21,6 +21,7 @@
 
 #import <XCTest/XCTest.h>
 #import "../EbbyCalc/EWCCalculator.h"
+#import "../EbbyCalc/EWCBigDecimal.h"
 
 @interface EWCCalculatorTests : XCTestCase {
   EWCCalculator *_calculator;
@@ -728,4 +729,15 @@
   XCTAssertEqualObjects(_calculator.displayContent, @"1.");
 }
 
+- (void)testMaximumDigitsIsClampedToDecimal {
+  _calculator.maximumDigits = 60;
+  XCTAssertEqual(_calculator.maximumDigits, EWCBigDecimalNativeDigits);
+
+  _calculator.maximumDigits = -1;
+  XCTAssertEqual(_calculator.maximumDigits, 0);
+
+  _calculator.maximumDigits = 16;
+  XCTAssertEqual(_calculator.maximumDigits, 16);
+}
+
 @end
@@ -0,0 +1,175 @@
+//
+//  EWCConcurrentCalculatorTests.m
+//  EbbyCalcTests
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <XCTest/XCTest.h>
+#import <stdatomic.h>
+#import "../EbbyCalc/EWCCalculator.h"
+#import "../EbbyCalc/EWCConcurrentCalculator.h"
+
+static const NSInteger s_stressKeyCount = 5000;
+static const int s_stressReaderCount = 4;
+
+@interface EWCConcurrentCalculatorTests : XCTestCase
+
+@end
+
+@implementation EWCConcurrentCalculatorTests
+
+- (EWCCalculator *)newCalculator {
+  EWCCalculator *calculator = [EWCCalculator new];
+  calculator.locale = [NSLocale localeWithLocaleIdentifier:@"en_US"];
+  calculator.maximumDigits = 16;
+
+  return calculator;
+}
+
+/**
+  Gets a key from a repeating sequence that exercises the display, memory, tax, and error states.
+ */
+- (EWCCalculatorKey)keyAtIndex:(NSInteger)index {
+  static const EWCCalculatorKey keys[] = {
+    EWCCalculatorOneKey, EWCCalculatorTwoKey, EWCCalculatorAddKey,
+    EWCCalculatorThreeKey, EWCCalculatorMultiplyKey, EWCCalculatorFourKey,
+    EWCCalculatorEqualKey, EWCCalculatorMemoryPlusKey, EWCCalculatorFiveKey,
+    EWCCalculatorDivideKey, EWCCalculatorSevenKey, EWCCalculatorEqualKey,
+    EWCCalculatorTaxPlusKey, EWCCalculatorSignKey, EWCCalculatorSqrtKey,
+    EWCCalculatorClearKey, EWCCalculatorMemoryKey, EWCCalculatorClearKey,
+  };
+
+  return keys[index % (sizeof(keys) / sizeof(keys[0]))];
+}
+
+- (void)testInitialSnapshot {
+  EWCConcurrentCalculator *calculator = [EWCConcurrentCalculator
+    concurrentCalculatorWithCalculator:[self newCalculator]];
+
+  EWCCalculatorSnapshot snapshot = calculator.snapshot;
+  XCTAssertEqual(snapshot.inputCount, 0);
+  XCTAssertEqualObjects(EWCCalculatorSnapshotDisplayContent(&snapshot), @"0.");
+  XCTAssertFalse(snapshot.displayContentTruncated);
+  XCTAssertFalse(snapshot.error);
+  XCTAssertFalse(snapshot.memory);
+}
+
+- (void)testCompletionReceivesPublishedSnapshot {
+  EWCConcurrentCalculator *calculator = [EWCConcurrentCalculator
+    concurrentCalculatorWithCalculator:[self newCalculator]];
+
+  XCTestExpectation *expectation = [self expectationWithDescription:@"key processed"];
+  [calculator pressKey:EWCCalculatorSevenKey];
+  [calculator pressKey:EWCCalculatorMemoryPlusKey completion:^(EWCCalculatorSnapshot snapshot) {
+    XCTAssertEqual(snapshot.inputCount, 2);
+    XCTAssertEqualObjects(EWCCalculatorSnapshotDisplayContent(&snapshot), @"7.");
+    XCTAssertTrue(snapshot.memory);
+    XCTAssertTrue(snapshot.changes & EWCCalculatorMemoryChange);
+    [expectation fulfill];
+  }];
+
+  [self waitForExpectations:@[expectation] timeout:5];
+
+  [calculator waitUntilIdle];
+  EWCCalculatorSnapshot snapshot = calculator.snapshot;
+  XCTAssertEqual(snapshot.inputCount, 2);
+  XCTAssertEqualObjects([NSDecimalNumber decimalNumberWithDecimal:snapshot.memoryValue],
+    [NSDecimalNumber decimalNumberWithString:@"7"]);
+}
+
+- (void)testPerformWithCalculatorPublishes {
+  EWCConcurrentCalculator *calculator = [EWCConcurrentCalculator
+    concurrentCalculatorWithCalculator:[self newCalculator]];
+
+  [calculator setInput:[NSDecimalNumber decimalNumberWithString:@"1234.5"] completion:nil];
+  [calculator performWithCalculator:^(EWCCalculator *wrapped) {
+    wrapped.locale = [NSLocale localeWithLocaleIdentifier:@"de_DE"];
+  }];
+  [calculator waitUntilIdle];
+
+  EWCCalculatorSnapshot snapshot = calculator.snapshot;
+  XCTAssertEqual(snapshot.inputCount, 2);
+  XCTAssertEqualObjects(EWCCalculatorSnapshotDisplayContent(&snapshot), @"1.234,5");
+}
+
+- (void)testConcurrentReadersSeeConsistentSnapshots {
+  // run the key sequence on a plain calculator to get the display expected
+  // after each input
+  EWCCalculator *reference = [self newCalculator];
+  NSMutableArray<NSString *> *expected = [NSMutableArray arrayWithObject:reference.displayContent];
+  for (NSInteger i = 0; i < s_stressKeyCount; ++i) {
+    [reference pressKey:[self keyAtIndex:i]];
+    [expected addObject:reference.displayContent];
+  }
+
+  EWCConcurrentCalculator *calculator = [EWCConcurrentCalculator
+    concurrentCalculatorWithCalculator:[self newCalculator]];
+
+  // the readers finish before these go out of scope, so they can be shared
+  // by address
+  atomic_bool done = NO;
+  atomic_long failures = 0;
+  atomic_long reads = 0;
+  atomic_bool *donePointer = &done;
+  atomic_long *failuresPointer = &failures;
+  atomic_long *readsPointer = &reads;
+
+  dispatch_group_t readers = dispatch_group_create();
+  dispatch_queue_t queue = dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0);
+  for (int r = 0; r < s_stressReaderCount; ++r) {
+    dispatch_group_async(readers, queue, ^{
+      uint64_t last = 0;
+      while (! atomic_load(donePointer)) {
+        @autoreleasepool {
+          EWCCalculatorSnapshot snapshot = calculator.snapshot;
+          atomic_fetch_add(readsPointer, 1);
+
+          // snapshots must never go backwards, and the display must be the
+          // one that goes with the input count it was published with
+          BOOL consistent = snapshot.inputCount >= last
+            && snapshot.inputCount <= (uint64_t)s_stressKeyCount
+            && [EWCCalculatorSnapshotDisplayContent(&snapshot)
+              isEqualToString:expected[(NSUInteger)snapshot.inputCount]];
+
+          if (! consistent) {
+            atomic_fetch_add(failuresPointer, 1);
+          }
+
+          last = snapshot.inputCount;
+        }
+      }
+    });
+  }
+
+  for (NSInteger i = 0; i < s_stressKeyCount; ++i) {
+    [calculator pressKey:[self keyAtIndex:i]];
+  }
+
+  [calculator waitUntilIdle];
+  atomic_store(&done, YES);
+  dispatch_group_wait(readers, DISPATCH_TIME_FOREVER);
+
+  XCTAssertEqual(atomic_load(&failures), 0);
+  XCTAssertGreaterThan(atomic_load(&reads), 0);
+
+  EWCCalculatorSnapshot snapshot = calculator.snapshot;
+  XCTAssertEqual(snapshot.inputCount, (uint64_t)s_stressKeyCount);
+  XCTAssertEqualObjects(EWCCalculatorSnapshotDisplayContent(&snapshot), expected.lastObject);
+}
+
+@end
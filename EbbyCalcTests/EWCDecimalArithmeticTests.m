@@ -0,0 +1,280 @@
+//
+//  EWCDecimalArithmeticTests.m
+//  EbbyCalcTests
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <XCTest/XCTest.h>
+#import "../EbbyCalc/EWCDecimalArithmetic.h"
+#import "../EbbyCalc/EWCCalculator.h"
+#import "../EbbyCalc/EWCCalculatorKey.h"
+#import "../EbbyCalc/NSDecimalNumber+EWCMathCategory.h"
+
+static const NSInteger s_maximumDigits = 16;
+static const int s_randomCases = 5000;
+static const int s_chainCases = 1000;
+static const int s_chainSteps = 6;
+static const int s_chainDigits = 6;
+static const int s_benchmarkIterations = 100000;
+
+@interface EWCDecimalArithmeticTests : XCTestCase
+
+@end
+
+@implementation EWCDecimalArithmeticTests
+
+/**
+  Builds a random value that fits the display, with a random sign and decimal point.
+ */
+- (NSDecimalNumber *)randomValue {
+  int count = 1 + (int)(random() % s_maximumDigits);
+  unsigned long long mantissa = 0;
+  for (int i = 0; i < count; ++i) {
+    mantissa = mantissa * 10 + (unsigned long long)(random() % 10);
+  }
+  short exponent = -(short)(random() % count);
+
+  return [NSDecimalNumber decimalNumberWithMantissa:mantissa
+    exponent:exponent
+    isNegative:(random() % 2) == 0];
+}
+
+/**
+  Builds a random positive value of a few digits, as typed into a calculator.
+ */
+- (NSDecimalNumber *)randomTypedValue {
+  int count = 1 + (int)(random() % s_chainDigits);
+  unsigned long long mantissa = 0;
+  for (int i = 0; i < count; ++i) {
+    mantissa = mantissa * 10 + (unsigned long long)(random() % 10);
+  }
+  short exponent = -(short)(random() % count);
+
+  return [NSDecimalNumber decimalNumberWithMantissa:mantissa exponent:exponent isNegative:NO];
+}
+
+/**
+  Presses the keys of a tape on a calculator.
+ */
+- (void)pressTape:(NSString *)tape onCalculator:(EWCCalculator *)calculator {
+  for (NSUInteger i = 0; i < tape.length; ++i) {
+    [calculator pressKey:EWCCalculatorKeyFromCharacter([tape characterAtIndex:i])];
+  }
+}
+
+- (void)testExactResults {
+  NSArray<NSString *> *left = @[ @"1", @"3", @"-7.5", @"123456789012345678", @"0.001" ];
+  NSArray<NSString *> *right = @[ @"8", @"0.25", @"-1.25", @"0.0625", @"-40" ];
+
+  for (NSUInteger i = 0; i < left.count; ++i) {
+    NSDecimal a = [NSDecimalNumber decimalNumberWithString:left[i]].decimalValue;
+    NSDecimal b = [NSDecimalNumber decimalNumberWithString:right[i]].decimalValue;
+    NSDecimal actual, expected;
+
+    XCTAssertEqual(EWCDecimalMultiply(&actual, &a, &b), NSDecimalMultiply(&expected, &a, &b, NSRoundPlain), @"%@ * %@", left[i], right[i]);
+    XCTAssertEqual(NSDecimalCompare(&actual, &expected), NSOrderedSame, @"%@ * %@", left[i], right[i]);
+
+    XCTAssertEqual(EWCDecimalDivide(&actual, &a, &b), NSDecimalDivide(&expected, &a, &b, NSRoundPlain), @"%@ / %@", left[i], right[i]);
+    XCTAssertEqual(NSDecimalCompare(&actual, &expected), NSOrderedSame, @"%@ / %@", left[i], right[i]);
+  }
+}
+
+- (void)testRepeatingQuotientIsFullPrecision {
+  NSDecimal one = [NSDecimalNumber one].decimalValue;
+  NSDecimal seven = [NSDecimalNumber decimalNumberWithString:@"7"].decimalValue;
+  NSDecimal actual, expected;
+
+  EWCDecimalDivide(&actual, &one, &seven);
+  NSDecimalDivide(&expected, &one, &seven, NSRoundPlain);
+
+  XCTAssertEqual(NSDecimalCompare(&actual, &expected), NSOrderedSame);
+}
+
+- (void)testMatchesNSDecimalArithmetic {
+  NSDecimal zero = [NSDecimalNumber zero].decimalValue;
+
+  srandom(41);
+  for (int i = 0; i < s_randomCases; ++i) {
+    NSDecimal left = [self randomValue].decimalValue;
+    NSDecimal right = [self randomValue].decimalValue;
+    NSString *description = [NSString stringWithFormat:@"%@ and %@",
+      NSDecimalString(&left, nil), NSDecimalString(&right, nil)];
+    NSDecimal actual, expected;
+
+    XCTAssertEqual(EWCDecimalMultiply(&actual, &left, &right),
+      NSDecimalMultiply(&expected, &left, &right, NSRoundPlain), @"%@", description);
+    XCTAssertEqual(NSDecimalCompare(&actual, &expected), NSOrderedSame, @"%@", description);
+
+    if (NSDecimalCompare(&right, &zero) == NSOrderedSame) {
+      continue;
+    }
+
+    XCTAssertEqual(EWCDecimalDivide(&actual, &left, &right),
+      NSDecimalDivide(&expected, &left, &right, NSRoundPlain), @"%@", description);
+    XCTAssertEqual(NSDecimalCompare(&actual, &expected), NSOrderedSame, @"%@", description);
+  }
+}
+
+- (void)testMatchesChainedNSDecimalArithmetic {
+  NSDecimal zero = [NSDecimalNumber zero].decimalValue;
+
+  // feed each result into the next operation, as the accumulator does, so
+  // that any digit lost along the way would be carried along and show up
+  srandom(141);
+  for (int i = 0; i < s_chainCases; ++i) {
+    NSDecimal actual = [self randomValue].decimalValue;
+    NSDecimal expected = actual;
+
+    for (int step = 0; step < s_chainSteps; ++step) {
+      NSDecimal right = [self randomValue].decimalValue;
+      NSString *description = [NSString stringWithFormat:@"%@ and %@ at step %d",
+        NSDecimalString(&expected, nil), NSDecimalString(&right, nil), step];
+      NSCalculationError actualError, expectedError;
+
+      if ((random() % 2) == 0 || NSDecimalCompare(&right, &zero) == NSOrderedSame) {
+        actualError = EWCDecimalMultiply(&actual, &actual, &right);
+        expectedError = NSDecimalMultiply(&expected, &expected, &right, NSRoundPlain);
+      } else {
+        actualError = EWCDecimalDivide(&actual, &actual, &right);
+        expectedError = NSDecimalDivide(&expected, &expected, &right, NSRoundPlain);
+      }
+
+      XCTAssertEqual(actualError, expectedError, @"%@", description);
+      if (expectedError != NSCalculationNoError && expectedError != NSCalculationLossOfPrecision) {
+        break;
+      }
+
+      XCTAssertEqual(NSDecimalCompare(&actual, &expected), NSOrderedSame, @"%@", description);
+    }
+  }
+}
+
+- (void)testCalculatorMatchesChainedFullPrecisionArithmetic {
+  NSDecimalNumber *limit = [NSDecimalNumber decimalNumberWithMantissa:1 exponent:s_maximumDigits - 1 isNegative:NO];
+
+  srandom(241);
+  for (int i = 0; i < s_chainCases; ++i) {
+    EWCCalculator *calculator = [EWCCalculator new];
+    calculator.locale = [NSLocale localeWithLocaleIdentifier:@"en_US"];
+    calculator.maximumDigits = s_maximumDigits;
+
+    // evaluate the chain left to right with NSDecimalNumber
+    NSDecimalNumber *expected = [self randomTypedValue];
+    NSMutableString *tape = [NSMutableString stringWithString:expected.stringValue];
+    BOOL fits = YES;
+    for (int step = 0; step < s_chainSteps && fits; ++step) {
+      NSDecimalNumber *right = [self randomTypedValue];
+      if ((random() % 2) == 0 || [right compare:[NSDecimalNumber zero]] == NSOrderedSame) {
+        expected = [expected decimalNumberByMultiplyingBy:right];
+        [tape appendFormat:@"*%@", right.stringValue];
+      } else {
+        expected = [expected decimalNumberByDividingBy:right];
+        [tape appendFormat:@"/%@", right.stringValue];
+      }
+
+      // keep to chains whose running results all fit the display
+      fits = ([expected compare:limit] == NSOrderedAscending);
+    }
+    if (! fits) {
+      continue;
+    }
+    [tape appendString:@"="];
+
+    [self pressTape:tape onCalculator:calculator];
+
+    XCTAssertFalse(calculator.hasError, @"%@", tape);
+    XCTAssertEqualObjects(calculator.displayValue,
+      [expected ewc_decimalNumberByRestrictingToDigits:s_maximumDigits], @"%@", tape);
+  }
+}
+
+- (void)testCalculatorShowsCorrectlyRoundedResults {
+  NSArray<NSString *> *tapes = @[
+    @"2/3=", @"1/7=", @"9999999999999999/7=", @"123.456*0.00789=", @"50/8%",
+    @"2/3*2.25/1000000000000000=", @"1/3*3=",
+  ];
+  NSArray<NSString *> *expected = @[
+    @"0.666666666666667", @"0.142857142857143", @"1428571428571428.",
+    @"0.97406784", @"625.",
+    @"0.000000000000002", @"1.",
+  ];
+
+  for (NSUInteger t = 0; t < tapes.count; ++t) {
+    EWCCalculator *calculator = [EWCCalculator new];
+    calculator.locale = [NSLocale localeWithLocaleIdentifier:@"en_US"];
+    calculator.maximumDigits = s_maximumDigits;
+
+    [self pressTape:tapes[t] onCalculator:calculator];
+
+    XCTAssertEqualObjects(calculator.displayContent, expected[t], @"%@", tapes[t]);
+  }
+}
+
+///------------------------
+/// @name Performance Tests
+///------------------------
+
+- (void)testPerformanceNSDecimalDivide {
+  NSDecimal dividend = [NSDecimalNumber decimalNumberWithString:@"1234567.891"].decimalValue;
+  NSDecimal divisor = [NSDecimalNumber decimalNumberWithString:@"1.25"].decimalValue;
+
+  [self measureBlock:^{
+    NSDecimal result;
+    for (int i = 0; i < s_benchmarkIterations; ++i) {
+      NSDecimalDivide(&result, &dividend, &divisor, NSRoundPlain);
+    }
+  }];
+}
+
+- (void)testPerformanceExactDivide {
+  NSDecimal dividend = [NSDecimalNumber decimalNumberWithString:@"1234567.891"].decimalValue;
+  NSDecimal divisor = [NSDecimalNumber decimalNumberWithString:@"1.25"].decimalValue;
+
+  [self measureBlock:^{
+    NSDecimal result;
+    for (int i = 0; i < s_benchmarkIterations; ++i) {
+      EWCDecimalDivide(&result, &dividend, &divisor);
+    }
+  }];
+}
+
+- (void)testPerformanceNSDecimalMultiply {
+  NSDecimal left = [NSDecimalNumber decimalNumberWithString:@"1234567.891"].decimalValue;
+  NSDecimal right = [NSDecimalNumber decimalNumberWithString:@"0.0825"].decimalValue;
+
+  [self measureBlock:^{
+    NSDecimal result;
+    for (int i = 0; i < s_benchmarkIterations; ++i) {
+      NSDecimalMultiply(&result, &left, &right, NSRoundPlain);
+    }
+  }];
+}
+
+- (void)testPerformanceExactMultiply {
+  NSDecimal left = [NSDecimalNumber decimalNumberWithString:@"1234567.891"].decimalValue;
+  NSDecimal right = [NSDecimalNumber decimalNumberWithString:@"0.0825"].decimalValue;
+
+  [self measureBlock:^{
+    NSDecimal result;
+    for (int i = 0; i < s_benchmarkIterations; ++i) {
+      EWCDecimalMultiply(&result, &left, &right);
+    }
+  }];
+}
+
+@end
@@ -0,0 +1,175 @@
+//
+//  EWCDisplayFormatterTests.m
+//  EbbyCalcTests
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <XCTest/XCTest.h>
+#import "../EbbyCalc/EWCDisplayFormatter.h"
+
+static NSArray<NSString *> *s_localeIdentifiers = nil;
+static NSArray<NSString *> *s_values = nil;
+
+static const NSInteger s_maximumDigits = 16;
+static const int s_benchmarkIterations = 10000;
+
+@interface EWCDisplayFormatterTests : XCTestCase
+
+@end
+
+@implementation EWCDisplayFormatterTests
+
++ (void)setUp {
+  s_localeIdentifiers = @[
+    @"en_US", @"en_GB", @"en_IN", @"fr_FR", @"fr_CH", @"de_DE", @"de_CH",
+    @"es_ES", @"es_MX", @"it_IT", @"pt_BR", @"pt_PT", @"nl_NL", @"sv_SE",
+    @"nb_NO", @"pl_PL", @"ru_RU", @"tr_TR", @"ja_JP", @"zh_CN", @"zh_TW",
+    @"ko_KR", @"hi_IN", @"th_TH", @"he_IL", @"ar_EG", @"ar_SA", @"fa_IR",
+  ];
+
+  s_values = @[
+    @"0", @"1", @"-1", @"0.5", @"-0.5", @"12", @"123", @"1234", @"-1234",
+    @"12345", @"123456", @"1234567", @"12345678.9", @"-98765432.1",
+    @"0.001", @"0.000000000000001", @"3.141592653589793", @"100000",
+    @"9999999999999999", @"-9999999999999999", @"0.1234567890123456789",
+    @"1000000000000000", @"5.05", @"-0.0625", @"123456789012.3456",
+  ];
+}
+
+/**
+  Builds the formatter the calculator display used before the direct renderer, as the reference for the expected output.
+ */
+- (NSNumberFormatter *)referenceFormatterForLocale:(NSLocale *)locale
+  minimumFractionDigits:(NSInteger)minimumFractionDigits {
+  NSNumberFormatter *formatter = [NSNumberFormatter new];
+  formatter.maximumFractionDigits = s_maximumDigits;
+  formatter.minimumFractionDigits = minimumFractionDigits;
+  formatter.locale = locale;
+  [formatter setNumberStyle:NSNumberFormatterDecimalStyle];
+
+  return formatter;
+}
+
+- (NSString *)referenceStringForValue:(NSDecimalNumber *)value
+  locale:(NSLocale *)locale
+  minimumFractionDigits:(NSInteger)minimumFractionDigits {
+
+  NSString *display = [[self referenceFormatterForLocale:locale
+    minimumFractionDigits:minimumFractionDigits] stringFromNumber:value];
+
+  NSString *separator = [locale decimalSeparator];
+  if (! [display containsString:separator]) {
+    display = [display stringByAppendingString:separator];
+  }
+
+  return display;
+}
+
+- (void)testMatchesFormatterAcrossLocales {
+  for (NSString *identifier in s_localeIdentifiers) {
+    NSLocale *locale = [NSLocale localeWithLocaleIdentifier:identifier];
+    EWCDisplayFormatter *renderer = [EWCDisplayFormatter formatterWithLocale:locale
+      maximumFractionDigits:s_maximumDigits];
+
+    for (NSString *str in s_values) {
+      NSDecimalNumber *value = [NSDecimalNumber decimalNumberWithString:str];
+      for (NSInteger minimum = 0; minimum <= 4; ++minimum) {
+        NSString *expected = [self referenceStringForValue:value
+          locale:locale
+          minimumFractionDigits:minimum];
+        NSString *actual = [renderer stringFromDecimal:value.decimalValue
+          minimumFractionDigits:minimum];
+
+        XCTAssertEqualObjects(actual, expected, @"%@ in %@ (min %ld)",
+          str, identifier, (long)minimum);
+      }
+    }
+  }
+}
+
+- (void)testRoundsExcessFractionDigits {
+  NSLocale *locale = [NSLocale localeWithLocaleIdentifier:@"en_US"];
+  EWCDisplayFormatter *renderer = [EWCDisplayFormatter formatterWithLocale:locale
+    maximumFractionDigits:2];
+
+  XCTAssertEqualObjects([renderer stringFromDecimal:[NSDecimalNumber decimalNumberWithString:@"1.125"].decimalValue
+    minimumFractionDigits:0], @"1.12");
+  XCTAssertEqualObjects([renderer stringFromDecimal:[NSDecimalNumber decimalNumberWithString:@"1.135"].decimalValue
+    minimumFractionDigits:0], @"1.14");
+  XCTAssertEqualObjects([renderer stringFromDecimal:[NSDecimalNumber decimalNumberWithString:@"999.999"].decimalValue
+    minimumFractionDigits:0], @"1,000.");
+}
+
+- (void)testNotANumberFallsBack {
+  NSLocale *locale = [NSLocale localeWithLocaleIdentifier:@"en_US"];
+  EWCDisplayFormatter *renderer = [EWCDisplayFormatter formatterWithLocale:locale
+    maximumFractionDigits:s_maximumDigits];
+
+  NSDecimalNumber *nan = [NSDecimalNumber notANumber];
+  XCTAssertEqualObjects([renderer stringFromDecimal:nan.decimalValue minimumFractionDigits:0],
+    [self referenceStringForValue:nan locale:locale minimumFractionDigits:0]);
+}
+
+- (void)testRenderIntoBufferDoesNotNeedString {
+  NSLocale *locale = [NSLocale localeWithLocaleIdentifier:@"de_DE"];
+  EWCDisplayFormatter *renderer = [EWCDisplayFormatter formatterWithLocale:locale
+    maximumFractionDigits:s_maximumDigits];
+
+  unichar buffer[EWCDisplayFormatterBufferSize];
+  NSDecimal value = [NSDecimalNumber decimalNumberWithString:@"-1234.5"].decimalValue;
+  NSUInteger length = [renderer renderDecimal:value
+    minimumFractionDigits:0
+    intoBuffer:buffer
+    capacity:EWCDisplayFormatterBufferSize];
+
+  XCTAssertEqualObjects([NSString stringWithCharacters:buffer length:length], @"-1.234,5");
+
+  // too small a buffer reports that it couldn't render
+  XCTAssertEqual([renderer renderDecimal:value minimumFractionDigits:0 intoBuffer:buffer capacity:4], 0);
+}
+
+///-------------------------
+/// @name Performance Tests
+///-------------------------
+
+- (void)testPerformanceFormatterPath {
+  NSLocale *locale = [NSLocale localeWithLocaleIdentifier:@"en_US"];
+  NSDecimalNumber *value = [NSDecimalNumber decimalNumberWithString:@"-12345678.90125"];
+
+  [self measureBlock:^{
+    for (int i = 0; i < s_benchmarkIterations; ++i) {
+      // the calculator built a new formatter for every display read
+      [self referenceStringForValue:value locale:locale minimumFractionDigits:i % 3];
+    }
+  }];
+}
+
+- (void)testPerformanceRendererPath {
+  NSLocale *locale = [NSLocale localeWithLocaleIdentifier:@"en_US"];
+  NSDecimal value = [NSDecimalNumber decimalNumberWithString:@"-12345678.90125"].decimalValue;
+  EWCDisplayFormatter *renderer = [EWCDisplayFormatter formatterWithLocale:locale
+    maximumFractionDigits:s_maximumDigits];
+
+  [self measureBlock:^{
+    for (int i = 0; i < s_benchmarkIterations; ++i) {
+      [renderer stringFromDecimal:value minimumFractionDigits:i % 3];
+    }
+  }];
+}
+
+@end
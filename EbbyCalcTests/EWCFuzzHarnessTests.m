@@ -0,0 +1,150 @@
+//
+//  EWCFuzzHarnessTests.m
+//  EbbyCalcTests
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <XCTest/XCTest.h>
+#import "../EbbyCalcTools/EWCFuzzGenerator.h"
+#import "../EbbyCalcTools/EWCFuzzHarness.h"
+
+static const NSUInteger s_caseLength = 64;
+
+/**
+  A harness that diverges at the first equals following a percent, so that minimizing can be checked without a real divergence.
+ */
+@interface EWCFakeDivergenceHarness : EWCFuzzHarness
+
+@end
+
+@implementation EWCFakeDivergenceHarness
+
+- (NSUInteger)firstDivergenceInKeys:(const EWCCalculatorKey *)keys count:(NSUInteger)count {
+  BOOL percent = NO;
+  for (NSUInteger i = 0; i < count; ++i) {
+    if (keys[i] == EWCCalculatorPercentKey) {
+      percent = YES;
+    } else if (percent && keys[i] == EWCCalculatorEqualKey) {
+      return i;
+    }
+  }
+
+  return NSNotFound;
+}
+
+@end
+
+@interface EWCFuzzHarnessTests : XCTestCase {
+  EWCFuzzHarness *_harness;
+}
+
+@end
+
+@implementation EWCFuzzHarnessTests
+
+- (void)setUp {
+  _harness = [EWCFuzzHarness harnessWithLocale:[NSLocale localeWithLocaleIdentifier:@"en_US"]
+    maximumDigits:16];
+}
+
+- (NSUInteger)fillKeys:(EWCCalculatorKey *)keys fromString:(NSString *)str {
+  for (NSUInteger i = 0; i < str.length; ++i) {
+    keys[i] = EWCCalculatorKeyFromCharacter([str characterAtIndex:i]);
+  }
+
+  return str.length;
+}
+
+- (void)testGeneratorIsRepeatable {
+  EWCCalculatorKey first[s_caseLength];
+  EWCCalculatorKey second[s_caseLength];
+
+  EWCFuzzGenerator generator;
+  EWCFuzzGeneratorInit(&generator, 42, 16);
+  EWCFuzzGeneratorFill(&generator, first, s_caseLength);
+  EWCFuzzGeneratorInit(&generator, 42, 16);
+  EWCFuzzGeneratorFill(&generator, second, s_caseLength);
+
+  XCTAssertEqual(memcmp(first, second, sizeof(first)), 0);
+  for (NSUInteger i = 0; i < s_caseLength; ++i) {
+    XCTAssertTrue(first[i] >= EWCCalculatorZeroKey && first[i] <= EWCCalculatorBackspaceKey);
+  }
+}
+
+- (void)testEnginesAgreeOnKnownSequences {
+  NSArray<NSString *> *sequences = @[
+    @"12+34=", @"5*==", @"9s2qw.5\\*", @"7.25+1.5=w%<3", @"q8.25wc100w", @"2/0=c",
+    @"9999999999999999*9=", @"12.5<<3y", @"50+10%", @"aadsa", @"100ew",
+  ];
+
+  EWCCalculatorKey keys[32];
+  for (NSString *sequence in sequences) {
+    NSUInteger count = [self fillKeys:keys fromString:sequence];
+    XCTAssertEqual([_harness firstDivergenceInKeys:keys count:count], NSNotFound, @"%@",
+      [_harness describeDivergenceInKeys:keys count:count]);
+  }
+}
+
+- (void)testShortFuzzRunAgrees {
+  EWCFuzzGenerator generator;
+  EWCFuzzGeneratorInit(&generator, 1, 16);
+
+  EWCCalculatorKey keys[s_caseLength];
+  for (int i = 0; i < 200; ++i) {
+    EWCFuzzGeneratorFill(&generator, keys, s_caseLength);
+    if ([_harness firstDivergenceInKeys:keys count:s_caseLength] != NSNotFound) {
+      NSUInteger count = [_harness minimizeKeys:keys count:s_caseLength];
+      XCTFail(@"%@", [_harness describeDivergenceInKeys:keys count:count]);
+      return;
+    }
+  }
+}
+
+- (void)testMinimizeFindsShortestReproducer {
+  EWCFuzzHarness *harness = [EWCFakeDivergenceHarness harnessWithLocale:_harness.locale
+    maximumDigits:16];
+
+  EWCCalculatorKey keys[32];
+  NSUInteger count = [self fillKeys:keys fromString:@"12+3s%4*5c6=78="];
+  count = [harness minimizeKeys:keys count:count];
+
+  XCTAssertEqualObjects([EWCFuzzHarness stringFromKeys:keys count:count], @"%=");
+
+  // a sequence that doesn't diverge can't be minimized
+  count = [self fillKeys:keys fromString:@"12+3="];
+  XCTAssertEqual([harness minimizeKeys:keys count:count], 0);
+}
+
+///------------------------
+/// @name Performance Tests
+///------------------------
+
+- (void)testPerformanceDifferentialRun {
+  EWCCalculatorKey keys[s_caseLength];
+
+  [self measureBlock:^{
+    EWCFuzzGenerator generator;
+    EWCFuzzGeneratorInit(&generator, 7, 16);
+    for (int i = 0; i < 100; ++i) {
+      EWCFuzzGeneratorFill(&generator, keys, s_caseLength);
+      [self->_harness firstDivergenceInKeys:keys count:s_caseLength];
+    }
+  }];
+}
+
+@end
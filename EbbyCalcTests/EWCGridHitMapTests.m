@@ -0,0 +1,199 @@
+//
+//  EWCGridHitMapTests.m
+//  EbbyCalcTests
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <XCTest/XCTest.h>
+#import "../EbbyCalc/EWCGridHitMap.h"
+
+static const int s_benchmarkIterations = 1000000;
+
+@interface EWCGridHitMapTests : XCTestCase
+
+@end
+
+@implementation EWCGridHitMapTests
+
+/**
+  Builds a 3 column, 4 row grid (300 × 400, so 100 point cells) with 10 point gutters around each key, and a key spanning the bottom two rows of the last column, as the add key does in the tall layout.
+ */
+- (void)buildKeypad:(EWCGridHitMap *)map {
+  EWCGridHitMapReset(map, 4, 3, 300, 400);
+  for (int r = 0; r < 4; ++r) {
+    for (int c = 0; c < 2; ++c) {
+      EWCGridHitMapAdd(map, r, c, r, c,
+        (EWCGridHitRect){ c * 100 + 10, r * 100 + 10, 80, 80 });
+    }
+  }
+  EWCGridHitMapAdd(map, 0, 2, 1, 2, (EWCGridHitRect){ 210, 10, 80, 80 });
+  EWCGridHitMapAdd(map, 2, 2, 3, 2, (EWCGridHitRect){ 210, 210, 80, 180 });
+}
+
+- (void)testFindsKeyInCell {
+  EWCGridHitMap map;
+  [self buildKeypad:&map];
+
+  XCTAssertEqual(EWCGridHitMapFind(&map, 50, 50), 0);
+  XCTAssertEqual(EWCGridHitMapFind(&map, 150, 50), 1);
+  XCTAssertEqual(EWCGridHitMapFind(&map, 150, 350), 7);
+}
+
+- (void)testSpanningKeyIsFoundInEveryCell {
+  EWCGridHitMap map;
+  [self buildKeypad:&map];
+
+  XCTAssertEqual(EWCGridHitMapFind(&map, 250, 250), 9);
+  XCTAssertEqual(EWCGridHitMapFind(&map, 250, 350), 9);
+
+  // the seam between the spanned cells is inside the key, not a gutter
+  XCTAssertEqual(EWCGridHitMapFind(&map, 250, 300), 9);
+}
+
+- (void)testGuttersAreNotHits {
+  EWCGridHitMap map;
+  [self buildKeypad:&map];
+
+  XCTAssertEqual(EWCGridHitMapFind(&map, 5, 50), EWCGridHitMapNoItem);
+  XCTAssertEqual(EWCGridHitMapFind(&map, 95, 50), EWCGridHitMapNoItem);
+  XCTAssertEqual(EWCGridHitMapFind(&map, 100, 100), EWCGridHitMapNoItem);
+  XCTAssertEqual(EWCGridHitMapFind(&map, 250, 195), EWCGridHitMapNoItem);
+}
+
+- (void)testEdgesMatchContainsPoint {
+  EWCGridHitMap map;
+  [self buildKeypad:&map];
+
+  // the top and left edges are in the frame, the bottom and right are not
+  XCTAssertEqual(EWCGridHitMapFind(&map, 10, 10), 0);
+  XCTAssertEqual(EWCGridHitMapFind(&map, 90, 50), EWCGridHitMapNoItem);
+  XCTAssertEqual(EWCGridHitMapFind(&map, 50, 90), EWCGridHitMapNoItem);
+  XCTAssertEqual(EWCGridHitMapFind(&map, 89.999, 89.999), 0);
+}
+
+- (void)testOutsideTheGrid {
+  EWCGridHitMap map;
+  [self buildKeypad:&map];
+
+  XCTAssertEqual(EWCGridHitMapFind(&map, -1, 50), EWCGridHitMapNoItem);
+  XCTAssertEqual(EWCGridHitMapFind(&map, 50, 400), EWCGridHitMapNoItem);
+  XCTAssertEqual(EWCGridHitMapFind(&map, NAN, 50), EWCGridHitMapNoItem);
+}
+
+- (void)testFrameBeyondItsSpan {
+  EWCGridHitMap map;
+  EWCGridHitMapReset(&map, 2, 2, 200, 200);
+
+  // placed in the first cell, but laid out over the whole top row and past
+  // the left edge of the grid
+  EWCGridHitMapAdd(&map, 0, 0, 0, 0, (EWCGridHitRect){ -20, 0, 220, 100 });
+  EWCGridHitMapAdd(&map, 1, 1, 1, 1, (EWCGridHitRect){ 100, 100, 100, 100 });
+
+  XCTAssertEqual(EWCGridHitMapFind(&map, 150, 50), 0);
+  XCTAssertEqual(EWCGridHitMapFind(&map, -10, 50), 0);
+  XCTAssertEqual(EWCGridHitMapFind(&map, 150, 150), 1);
+  XCTAssertEqual(EWCGridHitMapFind(&map, 50, 150), EWCGridHitMapNoItem);
+}
+
+- (void)testOverlappingFramesPreferTheFirstAdded {
+  EWCGridHitMap map;
+  EWCGridHitMapReset(&map, 1, 2, 200, 100);
+  EWCGridHitMapAdd(&map, 0, 0, 0, 0, (EWCGridHitRect){ 0, 0, 150, 100 });
+  EWCGridHitMapAdd(&map, 0, 1, 0, 1, (EWCGridHitRect){ 100, 0, 100, 100 });
+
+  XCTAssertEqual(EWCGridHitMapFind(&map, 125, 50), 0);
+  XCTAssertEqual(EWCGridHitMapFind(&map, 175, 50), 1);
+}
+
+- (void)testEmptyGridStillFindsFrames {
+  EWCGridHitMap map;
+  EWCGridHitMapReset(&map, 0, 0, 0, 0);
+  EWCGridHitMapAdd(&map, 0, 0, 0, 0, (EWCGridHitRect){ 0, 0, 10, 10 });
+
+  XCTAssertEqual(EWCGridHitMapFind(&map, 5, 5), 0);
+  XCTAssertEqual(EWCGridHitMapFind(&map, 15, 5), EWCGridHitMapNoItem);
+}
+
+- (void)testFullMapRejectsItems {
+  EWCGridHitMap map;
+  EWCGridHitMapReset(&map, 1, 1, 10, 10);
+  for (int i = 0; i < EWCGridHitMapMaxItems; ++i) {
+    XCTAssertEqual(EWCGridHitMapAdd(&map, 0, 0, 0, 0, (EWCGridHitRect){ 0, 0, 1, 1 }), i);
+  }
+
+  XCTAssertEqual(EWCGridHitMapAdd(&map, 0, 0, 0, 0, (EWCGridHitRect){ 0, 0, 1, 1 }), EWCGridHitMapNoItem);
+}
+
+- (void)testAgreesWithScanningOnFractionalCells {
+  // 7 columns of a width that doesn't divide evenly, with keys laid out the
+  // way the grid view does it, and points swept across every edge
+  EWCGridHitMap map;
+  double width = 333.3, height = 217.7;
+  int rows = 5, columns = 7;
+  EWCGridHitMapReset(&map, rows, columns, width, height);
+  for (int r = 0; r < rows; ++r) {
+    for (int c = 0; c < columns; ++c) {
+      double gutterWidth = 0.03 * width / 2.0;
+      double gutterHeight = 0.02 * height / 2.0;
+      EWCGridHitMapAdd(&map, r, c, r, c, (EWCGridHitRect){
+        width * ((double)c / columns) + gutterWidth,
+        height * ((double)r / rows) + gutterHeight,
+        width * (1.0 / columns) - 2 * gutterWidth,
+        height * (1.0 / rows) - 2 * gutterHeight });
+    }
+  }
+
+  for (double y = -1; y <= height + 1; y += 0.25) {
+    for (double x = -1; x <= width + 1; x += 0.25) {
+      XCTAssertEqual(EWCGridHitMapFind(&map, x, y), EWCGridHitMapScan(&map, x, y),
+        @"(%f, %f)", x, y);
+    }
+  }
+}
+
+///------------------------
+/// @name Performance Tests
+///------------------------
+
+- (void)testPerformanceScan {
+  EWCGridHitMap map;
+  [self buildKeypad:&map];
+
+  [self measureBlock:^{
+    long sum = 0;
+    for (int i = 0; i < s_benchmarkIterations; ++i) {
+      sum += EWCGridHitMapScan(&map, (i * 7) % 300, (i * 13) % 400);
+    }
+    XCTAssertNotEqual(sum, 0);
+  }];
+}
+
+- (void)testPerformanceFind {
+  EWCGridHitMap map;
+  [self buildKeypad:&map];
+
+  [self measureBlock:^{
+    long sum = 0;
+    for (int i = 0; i < s_benchmarkIterations; ++i) {
+      sum += EWCGridHitMapFind(&map, (i * 7) % 300, (i * 13) % 400);
+    }
+    XCTAssertNotEqual(sum, 0);
+  }];
+}
+
+@end
@@ -0,0 +1,167 @@
+//
+//  EWCKeyMapTests.m
+//  EbbyCalcTests
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <XCTest/XCTest.h>
+#import "../EbbyCalc/EWCCalculatorKey.h"
+#import "../EbbyCalc/EWCKeyMap.h"
+
+static const int s_benchmarkIterations = 1000000;
+
+@interface EWCKeyMapTests : XCTestCase {
+  EWCKeyMap _map;
+}
+
+@end
+
+@implementation EWCKeyMapTests
+
+- (void)setUp {
+  EWCKeyMapInit(&_map);
+}
+
+- (void)testEmptyMapMapsNothing {
+  XCTAssertEqual(EWCKeyMapLookup(&_map, '1'), EWCKeyMapNoKey);
+  XCTAssertEqual(EWCKeyMapLookup(&_map, 0), EWCKeyMapNoKey);
+
+  XCTAssertTrue(EWCKeyMapCompile(&_map));
+  XCTAssertEqual(EWCKeyMapLookup(&_map, '1'), EWCKeyMapNoKey);
+}
+
+- (void)testCompiledMapFindsEveryCharacter {
+  // the app's localized mappings include characters outside ASCII, such as
+  // the minus sign
+  EWCKeyMapAdd(&_map, 0x2212, EWCCalculatorSubtractKey);
+  EWCKeyMapAdd(&_map, 0x1b, EWCCalculatorClearKey);
+  EWCKeyMapAdd(&_map, '\r', EWCCalculatorEqualKey);
+  for (EWCCalculatorKey key = EWCCalculatorZeroKey; key <= EWCCalculatorNineKey; ++key) {
+    EWCKeyMapAdd(&_map, '0' + key, (int)key);
+  }
+  XCTAssertTrue(EWCKeyMapCompile(&_map));
+
+  XCTAssertEqual(EWCKeyMapLookup(&_map, 0x2212), EWCCalculatorSubtractKey);
+  XCTAssertEqual(EWCKeyMapLookup(&_map, 0x1b), EWCCalculatorClearKey);
+  XCTAssertEqual(EWCKeyMapLookup(&_map, '\r'), EWCCalculatorEqualKey);
+  XCTAssertEqual(EWCKeyMapLookup(&_map, '7'), EWCCalculatorSevenKey);
+
+  // and nothing else
+  int mapped = 0;
+  for (uint32_t c = 0; c <= 0xffff; ++c) {
+    if (EWCKeyMapLookup(&_map, (uint16_t)c) != EWCKeyMapNoKey) {
+      ++mapped;
+    }
+  }
+  XCTAssertEqual(mapped, 13);
+}
+
+- (void)testLaterMappingReplacesEarlier {
+  EWCKeyMapAdd(&_map, '=', EWCCalculatorEqualKey);
+  EWCKeyMapAdd(&_map, '=', EWCCalculatorPercentKey);
+  EWCKeyMapCompile(&_map);
+
+  XCTAssertEqual(_map.entryCount, 1);
+  XCTAssertEqual(EWCKeyMapLookup(&_map, '='), EWCCalculatorPercentKey);
+}
+
+- (void)testFullMapStillCompiles {
+  for (int i = 0; i < EWCKeyMapMaxEntries; ++i) {
+    XCTAssertTrue(EWCKeyMapAdd(&_map, (uint16_t)(0x100 + i * 13), i % 28));
+  }
+  XCTAssertFalse(EWCKeyMapAdd(&_map, 'x', EWCCalculatorAddKey));
+  XCTAssertFalse(EWCKeyMapAdd(&_map, 0, EWCCalculatorAddKey));
+
+  XCTAssertTrue(EWCKeyMapCompile(&_map));
+  XCTAssertTrue(EWCKeyMapTableSize(&_map) <= (1 << EWCKeyMapMaxTableBits));
+  for (int i = 0; i < EWCKeyMapMaxEntries; ++i) {
+    XCTAssertEqual(EWCKeyMapLookup(&_map, (uint16_t)(0x100 + i * 13)), i % 28);
+  }
+}
+
+- (void)testNotationMatchesCharacters {
+  // every key round trips through the notation, in either case
+  for (EWCCalculatorKey key = EWCCalculatorZeroKey; key <= EWCCalculatorBackspaceKey; ++key) {
+    unichar c = EWCCalculatorCharacterFromKey(key);
+    XCTAssertEqual(EWCCalculatorKeyFromCharacter(c), key);
+    if (c >= 'a' && c <= 'z') {
+      XCTAssertEqual(EWCCalculatorKeyFromCharacter(c - 'a' + 'A'), key);
+    }
+  }
+
+  XCTAssertEqual(EWCCalculatorKeyFromCharacter('x'), EWCCalculatorNoKey);
+  XCTAssertEqual(EWCCalculatorKeyFromCharacter(0), EWCCalculatorNoKey);
+}
+
+- (void)testTranslateSkipsSpacesAndCountsOthers {
+  NSString *text = @"12 * 3\n=x";
+  unichar characters[16];
+  int keys[16];
+  [text getCharacters:characters range:NSMakeRange(0, text.length)];
+
+  size_t unmapped = 0;
+  size_t count = EWCKeyMapTranslate(EWCCalculatorKeyNotationMap(), characters, text.length, keys, &unmapped);
+
+  XCTAssertEqual(count, 5);
+  XCTAssertEqual(unmapped, 1);
+  XCTAssertEqual(keys[0], EWCCalculatorOneKey);
+  XCTAssertEqual(keys[2], EWCCalculatorMultiplyKey);
+  XCTAssertEqual(keys[4], EWCCalculatorEqualKey);
+}
+
+///-------------------------
+/// @name Performance Tests
+///-------------------------
+
+- (void)testPerformanceDictionaryLookup {
+  NSMutableDictionary<NSString *, NSNumber *> *dictionary = [NSMutableDictionary new];
+  NSMutableArray<NSString *> *inputs = [NSMutableArray new];
+  for (EWCCalculatorKey key = EWCCalculatorZeroKey; key <= EWCCalculatorBackspaceKey; ++key) {
+    unichar c = EWCCalculatorCharacterFromKey(key);
+    NSString *input = [NSString stringWithCharacters:&c length:1];
+    dictionary[input] = @(key);
+    [inputs addObject:input];
+  }
+
+  [self measureBlock:^{
+    long sum = 0;
+    for (int i = 0; i < s_benchmarkIterations; ++i) {
+      sum += dictionary[inputs[i % inputs.count]].intValue;
+    }
+    XCTAssertTrue(sum > 0);
+  }];
+}
+
+- (void)testPerformanceTableLookup {
+  const EWCKeyMap *map = EWCCalculatorKeyNotationMap();
+  static unichar s_inputs[EWCCalculatorBackspaceKey + 1];
+  for (EWCCalculatorKey key = EWCCalculatorZeroKey; key <= EWCCalculatorBackspaceKey; ++key) {
+    s_inputs[key] = EWCCalculatorCharacterFromKey(key);
+  }
+  const unichar *inputs = s_inputs;
+
+  [self measureBlock:^{
+    long sum = 0;
+    for (int i = 0; i < s_benchmarkIterations; ++i) {
+      sum += EWCKeyMapLookup(map, inputs[i % (EWCCalculatorBackspaceKey + 1)]);
+    }
+    XCTAssertTrue(sum > 0);
+  }];
+}
+
+@end
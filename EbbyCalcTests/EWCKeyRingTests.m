@@ -0,0 +1,196 @@
+//
+//  EWCKeyRingTests.m
+//  EbbyCalcTests
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <XCTest/XCTest.h>
+#import "../EbbyCalc/EWCKeyRing.h"
+
+static const long s_stressKeys = 1000000;
+
+/**
+  Collects consumed keys into an `NSMutableArray` passed as the context.
+ */
+static void EWCKeyRingTestsCollect(int32_t key, void *context) {
+  NSMutableArray<NSNumber *> *keys = (__bridge NSMutableArray<NSNumber *> *)context;
+  [keys addObject:@(key)];
+}
+
+/**
+  `EWCKeyRingTestsStress` holds the consumer's view of a stress run.
+ */
+typedef struct {
+  long consumed;  // the keys taken
+  long outOfOrder;  // the keys that weren't the next one expected
+} EWCKeyRingTestsStress;
+
+/**
+  Checks that keys arrive numbered in order.
+ */
+static void EWCKeyRingTestsCheck(int32_t key, void *context) {
+  EWCKeyRingTestsStress *stress = context;
+  if (key != (int32_t)stress->consumed) {
+    ++stress->outOfOrder;
+  }
+  ++stress->consumed;
+}
+
+@interface EWCKeyRingTests : XCTestCase
+
+@end
+
+@implementation EWCKeyRingTests
+
+- (void)testConsumesInOrder {
+  EWCKeyRing ring;
+  EWCKeyRingInit(&ring);
+
+  for (int32_t key = 0; key < 10; ++key) {
+    XCTAssertTrue(EWCKeyRingPush(&ring, key));
+  }
+  XCTAssertEqual(EWCKeyRingCount(&ring), 10);
+
+  NSMutableArray<NSNumber *> *keys = [NSMutableArray new];
+  XCTAssertEqual(EWCKeyRingConsume(&ring, EWCKeyRingTestsCollect, (__bridge void *)keys), 10);
+  XCTAssertEqualObjects(keys, (@[ @0, @1, @2, @3, @4, @5, @6, @7, @8, @9 ]));
+  XCTAssertEqual(EWCKeyRingCount(&ring), 0);
+
+  // nothing left to take
+  XCTAssertEqual(EWCKeyRingConsume(&ring, EWCKeyRingTestsCollect, (__bridge void *)keys), 0);
+}
+
+- (void)testFullRingRefusesKeys {
+  EWCKeyRing ring;
+  EWCKeyRingInit(&ring);
+
+  for (int32_t key = 0; key < EWCKeyRingCapacity; ++key) {
+    XCTAssertTrue(EWCKeyRingPush(&ring, key));
+  }
+  XCTAssertFalse(EWCKeyRingPush(&ring, -1));
+  XCTAssertEqual(atomic_load(&ring.droppedCount), 1);
+
+  // draining makes room again, and the refused key never arrives
+  NSMutableArray<NSNumber *> *keys = [NSMutableArray new];
+  XCTAssertEqual(EWCKeyRingConsume(&ring, EWCKeyRingTestsCollect, (__bridge void *)keys), EWCKeyRingCapacity);
+  XCTAssertFalse([keys containsObject:@(-1)]);
+  XCTAssertTrue(EWCKeyRingPush(&ring, 1));
+}
+
+- (void)testWrapsAround {
+  EWCKeyRing ring;
+  EWCKeyRingInit(&ring);
+
+  NSMutableArray<NSNumber *> *keys = [NSMutableArray new];
+  int32_t next = 0;
+  for (int round = 0; round < 10; ++round) {
+    for (int i = 0; i < EWCKeyRingCapacity - 3; ++i) {
+      XCTAssertTrue(EWCKeyRingPush(&ring, next++));
+    }
+    EWCKeyRingConsume(&ring, EWCKeyRingTestsCollect, (__bridge void *)keys);
+  }
+
+  XCTAssertEqual(keys.count, (NSUInteger)next);
+  for (int32_t i = 0; i < next; ++i) {
+    XCTAssertEqual(keys[i].intValue, i);
+  }
+}
+
+- (void)testOnlyFirstRequestSchedulesDrain {
+  EWCKeyRing ring;
+  EWCKeyRingInit(&ring);
+
+  EWCKeyRingPush(&ring, 1);
+  XCTAssertTrue(EWCKeyRingRequestDrain(&ring));
+  EWCKeyRingPush(&ring, 2);
+  XCTAssertFalse(EWCKeyRingRequestDrain(&ring));
+
+  NSMutableArray<NSNumber *> *keys = [NSMutableArray new];
+  EWCKeyRingConsume(&ring, EWCKeyRingTestsCollect, (__bridge void *)keys);
+  XCTAssertFalse(EWCKeyRingFinishDrain(&ring));
+
+  // once finished, the next key schedules another drain
+  EWCKeyRingPush(&ring, 3);
+  XCTAssertTrue(EWCKeyRingRequestDrain(&ring));
+}
+
+- (void)testFinishingWithKeysWaitingKeepsDraining {
+  EWCKeyRing ring;
+  EWCKeyRingInit(&ring);
+
+  EWCKeyRingPush(&ring, 1);
+  XCTAssertTrue(EWCKeyRingRequestDrain(&ring));
+
+  NSMutableArray<NSNumber *> *keys = [NSMutableArray new];
+  EWCKeyRingConsume(&ring, EWCKeyRingTestsCollect, (__bridge void *)keys);
+
+  // a key arriving while the drain is running doesn't schedule another
+  EWCKeyRingPush(&ring, 2);
+  XCTAssertFalse(EWCKeyRingRequestDrain(&ring));
+
+  // so the running drain must go around again to take it
+  XCTAssertTrue(EWCKeyRingFinishDrain(&ring));
+  EWCKeyRingConsume(&ring, EWCKeyRingTestsCollect, (__bridge void *)keys);
+  XCTAssertFalse(EWCKeyRingFinishDrain(&ring));
+
+  XCTAssertEqualObjects(keys, (@[ @1, @2 ]));
+}
+
+- (void)testProducerAndConsumerThreads {
+  static EWCKeyRing ring;
+  EWCKeyRingInit(&ring);
+
+  dispatch_semaphore_t scheduled = dispatch_semaphore_create(0);
+  dispatch_queue_t producer = dispatch_queue_create("key ring producer", DISPATCH_QUEUE_SERIAL);
+  dispatch_group_t group = dispatch_group_create();
+
+  dispatch_group_async(group, producer, ^{
+    for (long i = 0; i < s_stressKeys; ++i) {
+      while (! EWCKeyRingPush(&ring, (int32_t)i)) {
+        sched_yield();
+      }
+
+      if (EWCKeyRingRequestDrain(&ring)) {
+        dispatch_semaphore_signal(scheduled);
+      }
+    }
+  });
+
+  // consume here, waiting on the drains the producer schedules, as the main
+  // queue would run them
+  EWCKeyRingTestsStress stress = { 0, 0 };
+  while (stress.consumed < s_stressKeys) {
+    long waited = dispatch_semaphore_wait(scheduled, dispatch_time(DISPATCH_TIME_NOW, 5 * NSEC_PER_SEC));
+    if (waited != 0) {
+      break;
+    }
+
+    do {
+      EWCKeyRingConsume(&ring, EWCKeyRingTestsCheck, &stress);
+    } while (EWCKeyRingFinishDrain(&ring));
+  }
+
+  dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+
+  // every key arrived once, in order, and none was left without a drain
+  XCTAssertEqual(stress.consumed, s_stressKeys);
+  XCTAssertEqual(stress.outOfOrder, 0);
+  XCTAssertEqual(EWCKeyRingCount(&ring), 0);
+}
+
+@end
@@ -0,0 +1,332 @@
+//
+//  EWCKeySoundEngineTests.m
+//  EbbyCalcTests
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <XCTest/XCTest.h>
+#import "../EbbyCalc/EWCKeySoundEngine.h"
+#import "../EbbyCalc/EWCKeySoundSample.h"
+#import "../EbbyCalc/EWCKeyVoicePool.h"
+#import "../EbbyCalcTools/EWCOfflineKeySoundBackend.h"
+
+static const int s_benchmarkIterations = 100000;
+
+@interface EWCKeySoundEngineTests : XCTestCase
+
+@end
+
+@implementation EWCKeySoundEngineTests
+
+/**
+  Builds a WAV file holding a constant 16 bit sample value.
+
+  @param frameCount The number of frames.
+  @param channels The number of channels.
+  @param rate The sample rate.
+  @param value The sample value.
+
+  @return The contents of the file.
+ */
+- (NSData *)wavWithFrameCount:(uint32_t)frameCount
+  channels:(uint16_t)channels
+  rate:(uint32_t)rate
+  value:(int16_t)value {
+
+  uint32_t dataLength = frameCount * channels * 2;
+  NSMutableData *wav = [NSMutableData data];
+
+  void (^append32)(uint32_t) = ^(uint32_t v) {
+    uint8_t bytes[] = { v & 0xff, (v >> 8) & 0xff, (v >> 16) & 0xff, v >> 24 };
+    [wav appendBytes:bytes length:4];
+  };
+  void (^append16)(uint16_t) = ^(uint16_t v) {
+    uint8_t bytes[] = { v & 0xff, v >> 8 };
+    [wav appendBytes:bytes length:2];
+  };
+
+  [wav appendBytes:"RIFF" length:4];
+  append32(36 + dataLength);
+  [wav appendBytes:"WAVEfmt " length:8];
+  append32(16);
+  append16(1);
+  append16(channels);
+  append32(rate);
+  append32(rate * channels * 2);
+  append16(channels * 2);
+  append16(16);
+  [wav appendBytes:"data" length:4];
+  append32(dataLength);
+  for (uint32_t i = 0; i < frameCount * channels; ++i) {
+    append16((uint16_t)value);
+  }
+
+  return wav;
+}
+
+- (NSArray<NSData *> *)soundData {
+  return @[
+    [self wavWithFrameCount:441 channels:2 rate:44100 value:8192],
+    [self wavWithFrameCount:441 channels:1 rate:44100 value:-8192],
+    [self wavWithFrameCount:441 channels:2 rate:44100 value:16384],
+  ];
+}
+
+///-------------------
+/// @name Decode Tests
+///-------------------
+
+- (void)testDecodesStereoAndMono {
+  EWCKeySoundSample sample;
+
+  NSData *stereo = [self wavWithFrameCount:10 channels:2 rate:44100 value:16384];
+  XCTAssertTrue(EWCKeySoundSampleDecodeWav(stereo.bytes, stereo.length, &sample));
+  XCTAssertEqual(sample.frameCount, 10);
+  XCTAssertEqual(sample.sampleRate, 44100);
+  XCTAssertEqual(sample.frames[0], 0.5f);
+  XCTAssertEqual(sample.frames[19], 0.5f);
+  EWCKeySoundSampleFree(&sample);
+  XCTAssertTrue(sample.frames == NULL);
+
+  // mono is played on both channels
+  NSData *mono = [self wavWithFrameCount:10 channels:1 rate:22050 value:-16384];
+  XCTAssertTrue(EWCKeySoundSampleDecodeWav(mono.bytes, mono.length, &sample));
+  XCTAssertEqual(sample.frameCount, 10);
+  XCTAssertEqual(sample.sampleRate, 22050);
+  XCTAssertEqual(sample.frames[0], -0.5f);
+  XCTAssertEqual(sample.frames[1], -0.5f);
+  EWCKeySoundSampleFree(&sample);
+}
+
+- (void)testRejectsMalformedFiles {
+  EWCKeySoundSample sample;
+
+  NSData *wav = [self wavWithFrameCount:10 channels:2 rate:44100 value:1];
+  XCTAssertFalse(EWCKeySoundSampleDecodeWav(wav.bytes, 20, &sample));
+  XCTAssertFalse(EWCKeySoundSampleDecodeWav("RIFF....WAVE", 12, &sample));
+  XCTAssertTrue(sample.frames == NULL);
+
+  // 24 bit samples aren't supported
+  NSMutableData *wide = [wav mutableCopy];
+  uint8_t bits = 24;
+  [wide replaceBytesInRange:NSMakeRange(34, 1) withBytes:&bits];
+  XCTAssertFalse(EWCKeySoundSampleDecodeWav(wide.bytes, wide.length, &sample));
+
+  // a truncated data chunk plays what is there
+  XCTAssertTrue(EWCKeySoundSampleDecodeWav(wav.bytes, wav.length - 8, &sample));
+  XCTAssertEqual(sample.frameCount, 8);
+  EWCKeySoundSampleFree(&sample);
+}
+
+///-----------------------
+/// @name Voice Pool Tests
+///-----------------------
+
+- (void)testPoolMixesAndFreesVoices {
+  EWCKeySoundSample sample;
+  NSData *wav = [self wavWithFrameCount:100 channels:2 rate:44100 value:8192];
+  EWCKeySoundSampleDecodeWav(wav.bytes, wav.length, &sample);
+
+  const EWCKeySoundSample *sounds[] = { &sample };
+  EWCKeyVoicePool pool;
+  EWCKeyVoicePoolInit(&pool, sounds, 1);
+
+  float frames[2 * 64];
+  XCTAssertFalse(EWCKeyVoicePoolRender(&pool, frames, 64));
+  XCTAssertEqual(frames[0], 0);
+
+  XCTAssertTrue(EWCKeyVoicePoolTrigger(&pool, 0, 0.5));
+  XCTAssertTrue(EWCKeyVoicePoolTrigger(&pool, 0, 1));
+  XCTAssertTrue(EWCKeyVoicePoolRender(&pool, frames, 64));
+  XCTAssertEqual(EWCKeyVoicePoolActiveCount(&pool), 2);
+  XCTAssertEqualWithAccuracy(frames[0], 0.25 * 0.5 + 0.25, 1e-6);
+  XCTAssertEqualWithAccuracy(frames[127], 0.375, 1e-6);
+
+  // the sounds end partway through the second buffer
+  XCTAssertTrue(EWCKeyVoicePoolRender(&pool, frames, 64));
+  XCTAssertEqualWithAccuracy(frames[2 * 35], 0.375, 1e-6);
+  XCTAssertEqual(frames[2 * 36], 0);
+  XCTAssertEqual(EWCKeyVoicePoolActiveCount(&pool), 0);
+  XCTAssertFalse(EWCKeyVoicePoolRender(&pool, frames, 64));
+
+  // unknown sounds are refused
+  XCTAssertFalse(EWCKeyVoicePoolTrigger(&pool, 1, 1));
+
+  EWCKeySoundSampleFree(&sample);
+}
+
+- (void)testPoolStealsOldestVoice {
+  EWCKeySoundSample sample;
+  NSData *wav = [self wavWithFrameCount:1000 channels:2 rate:44100 value:100];
+  EWCKeySoundSampleDecodeWav(wav.bytes, wav.length, &sample);
+
+  const EWCKeySoundSample *sounds[] = { &sample };
+  EWCKeyVoicePool pool;
+  EWCKeyVoicePoolInit(&pool, sounds, 1);
+
+  float frames[2 * 16];
+  for (int i = 0; i < EWCKeyVoicePoolVoiceCount; ++i) {
+    EWCKeyVoicePoolTrigger(&pool, 0, 1);
+    EWCKeyVoicePoolRender(&pool, frames, 16);
+  }
+  XCTAssertEqual(EWCKeyVoicePoolActiveCount(&pool), EWCKeyVoicePoolVoiceCount);
+  XCTAssertEqual(pool.stolenCount, 0);
+
+  // the next sound restarts the first voice, which has played the longest
+  EWCKeyVoicePoolTrigger(&pool, 0, 1);
+  EWCKeyVoicePoolRender(&pool, frames, 16);
+  XCTAssertEqual(pool.stolenCount, 1);
+  XCTAssertEqual(pool.voices[0].position, 16);
+  XCTAssertEqual(pool.voices[1].position, 16 * 8);
+  XCTAssertEqual(EWCKeyVoicePoolActiveCount(&pool), EWCKeyVoicePoolVoiceCount);
+
+  EWCKeySoundSampleFree(&sample);
+}
+
+- (void)testPoolDropsWhenRingIsFull {
+  EWCKeySoundSample sample;
+  NSData *wav = [self wavWithFrameCount:10 channels:2 rate:44100 value:100];
+  EWCKeySoundSampleDecodeWav(wav.bytes, wav.length, &sample);
+
+  const EWCKeySoundSample *sounds[] = { &sample };
+  EWCKeyVoicePool pool;
+  EWCKeyVoicePoolInit(&pool, sounds, 1);
+
+  for (int i = 0; i < EWCKeyVoicePoolTriggerCapacity; ++i) {
+    XCTAssertTrue(EWCKeyVoicePoolTrigger(&pool, 0, 1));
+  }
+  XCTAssertFalse(EWCKeyVoicePoolTrigger(&pool, 0, 1));
+  XCTAssertEqual(atomic_load(&pool.droppedCount), 1);
+
+  float frames[2 * 16];
+  EWCKeyVoicePoolRender(&pool, frames, 16);
+  XCTAssertEqual(pool.startedCount, EWCKeyVoicePoolTriggerCapacity);
+  XCTAssertTrue(EWCKeyVoicePoolTrigger(&pool, 0, 1));
+
+  EWCKeySoundSampleFree(&sample);
+}
+
+///-------------------
+/// @name Engine Tests
+///-------------------
+
+- (void)testSoundsMatchKeys {
+  XCTAssertEqual(EWCKeySoundForKey(EWCCalculatorFiveKey), EWCKeyClickSound);
+  XCTAssertEqual(EWCKeySoundForKey(EWCCalculatorRateKey), EWCKeyModifySound);
+  XCTAssertEqual(EWCKeySoundForKey(EWCCalculatorClearKey), EWCKeyDeleteSound);
+  XCTAssertEqual(EWCKeySoundForKey(EWCCalculatorBackspaceKey), EWCKeyDeleteSound);
+  XCTAssertEqual(EWCKeySoundForKey(EWCCalculatorAddKey), EWCKeyClickSound);
+}
+
+- (void)testEnginePlaysOnlyWhileStarted {
+  EWCOfflineKeySoundBackend *backend = [EWCOfflineKeySoundBackend backendWithBufferFrameCount:256];
+  EWCKeySoundEngine *engine = [EWCKeySoundEngine engineWithSoundData:[self soundData] backend:backend];
+  XCTAssertNotNil(engine);
+  XCTAssertEqual(engine.sampleRate, 44100);
+  engine.volume = 0.5;
+
+  // nothing plays before starting
+  [engine playSoundForKey:EWCCalculatorOneKey];
+  XCTAssertFalse(backend.isRunning);
+  XCTAssertEqual(engine.requestedCount, 0);
+
+  XCTAssertTrue([engine start]);
+  [engine playSoundForKey:EWCCalculatorClearKey];
+  [backend renderInterval:0.1];
+  XCTAssertEqual(backend.audibleFrameCount, 512);
+  XCTAssertEqualWithAccuracy(backend.peakLevel, 0.125, 1e-6);
+  XCTAssertEqual(engine.requestedCount, 1);
+
+  // the click and rate sounds are distinct
+  [backend resetStatistics];
+  [engine playSoundForKey:EWCCalculatorRateKey];
+  [backend renderInterval:0.1];
+  XCTAssertEqualWithAccuracy(backend.peakLevel, 0.25, 1e-6);
+
+  [engine stop];
+  XCTAssertFalse(backend.isRunning);
+  [engine playSoundForKey:EWCCalculatorOneKey];
+  XCTAssertEqual(engine.requestedCount, 2);
+}
+
+- (void)testEngineRestartsStoppedOutput {
+  EWCOfflineKeySoundBackend *backend = [EWCOfflineKeySoundBackend backendWithBufferFrameCount:256];
+  EWCKeySoundEngine *engine = [EWCKeySoundEngine engineWithSoundData:[self soundData] backend:backend];
+  [engine start];
+
+  // as if audio had been interrupted
+  [backend stop];
+
+  [engine playSoundForKey:EWCCalculatorOneKey];
+  XCTAssertTrue(backend.isRunning);
+  [backend renderInterval:0.1];
+  XCTAssertGreaterThan(backend.audibleFrameCount, 0);
+}
+
+- (void)testEngineRejectsBadSounds {
+  EWCOfflineKeySoundBackend *backend = [EWCOfflineKeySoundBackend new];
+
+  NSArray<NSData *> *mixedRates = @[
+    [self wavWithFrameCount:10 channels:2 rate:44100 value:1],
+    [self wavWithFrameCount:10 channels:2 rate:48000 value:1],
+  ];
+  XCTAssertNil([EWCKeySoundEngine engineWithSoundData:mixedRates backend:backend]);
+
+  NSArray<NSData *> *garbage = @[ [@"not a wav" dataUsingEncoding:NSUTF8StringEncoding] ];
+  XCTAssertNil([EWCKeySoundEngine engineWithSoundData:garbage backend:backend]);
+}
+
+- (void)testBurstStealsRatherThanGrows {
+  EWCOfflineKeySoundBackend *backend = [EWCOfflineKeySoundBackend backendWithBufferFrameCount:64];
+  EWCKeySoundEngine *engine = [EWCKeySoundEngine engineWithSoundData:[self soundData] backend:backend];
+  [engine start];
+
+  // 20 keys faster than a sound can finish
+  for (int i = 0; i < 20; ++i) {
+    [engine playSoundForKey:EWCCalculatorFiveKey];
+    [backend renderFrames:32];
+  }
+  XCTAssertEqual(engine.activeVoiceCount, EWCKeyVoicePoolVoiceCount);
+  [backend renderInterval:0.1];
+  XCTAssertEqual(engine.activeVoiceCount, 0);
+
+  XCTAssertEqual(engine.requestedCount, 20);
+  XCTAssertEqual(engine.droppedCount, 0);
+  XCTAssertEqual(engine.stolenCount, 20 - EWCKeyVoicePoolVoiceCount);
+}
+
+///------------------------
+/// @name Performance Tests
+///------------------------
+
+- (void)testPerformanceKeyBurst {
+  EWCOfflineKeySoundBackend *backend = [EWCOfflineKeySoundBackend backendWithBufferFrameCount:256];
+  EWCKeySoundEngine *engine = [EWCKeySoundEngine engineWithSoundData:[self soundData] backend:backend];
+  [engine start];
+
+  [self measureBlock:^{
+    for (int i = 0; i < s_benchmarkIterations; ++i) {
+      [engine playSoundForKey:(EWCCalculatorKey)(i % 10)];
+      if ((i & 3) == 3) {
+        [backend renderFrames:256];
+      }
+    }
+  }];
+}
+
+@end
@@ -0,0 +1,210 @@
+//
+//  EWCKeyStreamTests.m
+//  EbbyCalcTests
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <XCTest/XCTest.h>
+#import "../EbbyCalc/EWCCalculator.h"
+#import "../EbbyCalc/EWCCalculatorMemoryData.h"
+#import "../EbbyCalc/EWCKeyStream.h"
+#import "../EbbyCalc/EWCKeyStreamRecorder.h"
+#import "../EbbyCalc/EWCKeyStreamReplayer.h"
+
+static const NSUInteger s_benchmarkKeys = 100000;
+
+@interface EWCKeyStreamTests : XCTestCase {
+  NSString *_path;
+}
+
+@end
+
+@implementation EWCKeyStreamTests
+
+- (void)setUp {
+  _path = [NSTemporaryDirectory() stringByAppendingPathComponent:
+    [NSString stringWithFormat:@"%@.ewck", [NSUUID UUID].UUIDString]];
+}
+
+- (void)tearDown {
+  [[NSFileManager defaultManager] removeItemAtPath:_path error:nil];
+}
+
+- (void)pressKeys:(NSString *)keys on:(EWCCalculator *)calculator {
+  for (NSUInteger i = 0; i < keys.length; ++i) {
+    [calculator pressKey:EWCCalculatorKeyFromCharacter([keys characterAtIndex:i])];
+  }
+}
+
+- (EWCKeyStreamRecorder *)recorderForCalculator:(EWCCalculator *)calculator {
+  EWCKeyStreamRecorder *recorder = [EWCKeyStreamRecorder recorderWithOutputStream:
+    [NSOutputStream outputStreamToFileAtPath:_path append:NO]];
+  recorder.checkpointInterval = 4;
+  recorder.blockSize = 16;
+
+  // each input is recorded 100ms after the last
+  __block uint64_t time = 0;
+  recorder.clock = ^{
+    time += 100;
+    return time;
+  };
+
+  XCTAssertTrue([recorder startRecordingCalculator:calculator]);
+
+  return recorder;
+}
+
+- (void)testReplayReachesSameResults {
+  EWCCalculator *calculator = [EWCCalculator calculator];
+  calculator.maximumDigits = 12;
+  calculator.dataProvider = [EWCCalculatorMemoryData
+    dataWithTaxRate:[NSDecimalNumber decimalNumberWithString:@"8.25"]
+    memory:[NSDecimalNumber decimalNumberWithString:@"3"]];
+
+  EWCKeyStreamRecorder *recorder = [self recorderForCalculator:calculator];
+  [self pressKeys:@"12.5*3=s7/4=w" on:calculator];
+  [calculator setInput:[NSDecimalNumber decimalNumberWithString:@"-0.0625"]];
+  [self pressKeys:@"*a=y<\\" on:calculator];
+  XCTAssertTrue([recorder finish]);
+  XCTAssertNil(calculator.recorder);
+  XCTAssertEqual(recorder.keyCount, 19);
+
+  EWCKeyStreamReplayer *replayer = [EWCKeyStreamReplayer replayerWithData:
+    [NSData dataWithContentsOfFile:_path]];
+  XCTAssertTrue([replayer replay]);
+  XCTAssertEqual(replayer.maximumDigits, 12);
+  XCTAssertEqual(replayer.keyCount, 19);
+  XCTAssertEqual(replayer.inputCount, 1);
+  XCTAssertEqual(replayer.checkpointCount, 5);
+  XCTAssertEqual(replayer.failedCheckpointCount, 0);
+  XCTAssertEqual(replayer.recordedDuration, 2000);
+  XCTAssertFalse(replayer.isCorrupt);
+
+  XCTAssertEqualObjects(replayer.calculator.displayValue, calculator.displayValue);
+  XCTAssertEqualObjects(replayer.calculator.memoryValue, calculator.memoryValue);
+  XCTAssertEqualObjects(replayer.calculator.taxRateValue, calculator.taxRateValue);
+}
+
+- (void)testDamagedBlockIsDetected {
+  EWCCalculator *calculator = [EWCCalculator calculator];
+  EWCKeyStreamRecorder *recorder = [self recorderForCalculator:calculator];
+  [self pressKeys:@"123+456=789*2=" on:calculator];
+  XCTAssertTrue([recorder finish]);
+
+  NSMutableData *data = [NSMutableData dataWithContentsOfFile:_path];
+  uint8_t *bytes = data.mutableBytes;
+  bytes[data.length / 2] ^= 0x10;
+
+  EWCKeyStreamReplayer *replayer = [EWCKeyStreamReplayer replayerWithData:data];
+  XCTAssertFalse([replayer replay]);
+  XCTAssertTrue(replayer.isCorrupt);
+  XCTAssertLessThan(replayer.keyCount, recorder.keyCount);
+
+  XCTAssertFalse([replayer decode]);
+  XCTAssertTrue(replayer.isCorrupt);
+}
+
+- (void)testCheckpointMismatchIsReported {
+  // hand build a stream claiming that 1 2 displays 13
+  NSMutableData *payload = [NSMutableData new];
+  uint8_t buffer[EWCKeyStreamMaxRecordSize];
+
+  EWCKeyStreamRecord record = { 0 };
+  record.type = EWCKeyStreamKeyRecord;
+  record.key = EWCCalculatorOneKey;
+  [payload appendBytes:buffer length:EWCKeyStreamEncodeRecord(&record, buffer)];
+  record.key = EWCCalculatorTwoKey;
+  [payload appendBytes:buffer length:EWCKeyStreamEncodeRecord(&record, buffer)];
+  record.type = EWCKeyStreamCheckpointRecord;
+  record.value = [NSDecimalNumber decimalNumberWithString:@"13"].decimalValue;
+  [payload appendBytes:buffer length:EWCKeyStreamEncodeRecord(&record, buffer)];
+
+  NSMutableData *data = [NSMutableData new];
+  [data appendBytes:buffer length:EWCKeyStreamEncodeHeader(buffer, 16)];
+  [data appendBytes:buffer length:EWCKeyStreamEncodeVarint(payload.length, buffer)];
+  [data appendData:payload];
+  uint32_t checksum = EWCKeyStreamChecksum(payload.bytes, payload.length);
+  uint8_t trailer[EWCKeyStreamChecksumSize] = {
+    (uint8_t)checksum, (uint8_t)(checksum >> 8), (uint8_t)(checksum >> 16), (uint8_t)(checksum >> 24),
+  };
+  [data appendBytes:trailer length:EWCKeyStreamChecksumSize];
+
+  EWCKeyStreamReplayer *replayer = [EWCKeyStreamReplayer replayerWithData:data];
+  XCTAssertFalse([replayer replay]);
+  XCTAssertFalse(replayer.isCorrupt);
+  XCTAssertEqual(replayer.failedCheckpointCount, 1);
+  XCTAssertEqual(replayer.firstFailedKeyIndex, 2);
+  XCTAssertEqualObjects(replayer.calculator.displayValue, [NSDecimalNumber decimalNumberWithString:@"12"]);
+
+  // decoding alone doesn't check the results
+  XCTAssertTrue([replayer decode]);
+  XCTAssertEqual(replayer.firstFailedKeyIndex, NSNotFound);
+}
+
+- (void)testMissingHeaderIsRejected {
+  EWCKeyStreamReplayer *replayer = [EWCKeyStreamReplayer replayerWithData:
+    [@"not a recording" dataUsingEncoding:NSUTF8StringEncoding]];
+  XCTAssertFalse([replayer replay]);
+  XCTAssertTrue(replayer.isCorrupt);
+  XCTAssertNil(replayer.calculator);
+}
+
+///-------------------------
+/// @name Performance Tests
+///-------------------------
+
+/**
+  Records a long stream of keys using the default block and checkpoint settings.
+
+  @return The recording.
+ */
+- (NSData *)benchmarkRecording {
+  EWCCalculator *calculator = [EWCCalculator calculator];
+  EWCKeyStreamRecorder *recorder = [EWCKeyStreamRecorder recorderWithOutputStream:
+    [NSOutputStream outputStreamToFileAtPath:_path append:NO]];
+  [recorder startRecordingCalculator:calculator];
+
+  NSString *keys = @"1234.5+678*9=s<7/3=c";
+  for (NSUInteger i = 0; i < s_benchmarkKeys; ++i) {
+    [calculator pressKey:EWCCalculatorKeyFromCharacter([keys characterAtIndex:i % keys.length])];
+  }
+  [recorder finish];
+
+  return [NSData dataWithContentsOfFile:_path];
+}
+
+- (void)testPerformanceDecode {
+  EWCKeyStreamReplayer *replayer = [EWCKeyStreamReplayer replayerWithData:[self benchmarkRecording]];
+
+  [self measureBlock:^{
+    // 100 passes is 10M keys
+    for (int i = 0; i < 100; ++i) {
+      [replayer decode];
+    }
+  }];
+}
+
+- (void)testPerformanceReplay {
+  EWCKeyStreamReplayer *replayer = [EWCKeyStreamReplayer replayerWithData:[self benchmarkRecording]];
+
+  [self measureBlock:^{
+    [replayer replay];
+  }];
+}
+
+@end
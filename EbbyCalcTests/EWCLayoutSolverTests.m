@@ -0,0 +1,179 @@
+//
+//  EWCLayoutSolverTests.m
+//  EbbyCalcTests
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <XCTest/XCTest.h>
+#import "../EbbyCalc/EWCLayoutSolver.h"
+#import "../EbbyCalc/EWCCalculatorKey.h"
+
+static const int s_benchmarkIterations = 100000;
+
+@interface EWCLayoutSolverTests : XCTestCase
+
+@end
+
+@implementation EWCLayoutSolverTests
+
+- (void)testChoosesModeFromDimensions {
+  EWCLayoutSolution solution;
+
+  EWCLayoutSolve(&solution, 375, 600, 20);
+  XCTAssertEqual(solution.mode, EWCLayoutNarrowMode);
+
+  EWCLayoutSolve(&solution, 375, 700, 20);
+  XCTAssertEqual(solution.mode, EWCLayoutTallMode);
+
+  EWCLayoutSolve(&solution, 800, 400, 20);
+  XCTAssertEqual(solution.mode, EWCLayoutWideMode);
+
+  // the narrow and wide arrangements share a grid
+  XCTAssertEqual(EWCLayoutGridForMode(EWCLayoutNarrowMode), EWCLayoutGridForMode(EWCLayoutWideMode));
+  XCTAssertNotEqual(EWCLayoutGridForMode(EWCLayoutTallMode), EWCLayoutGridForMode(EWCLayoutWideMode));
+}
+
+- (void)testFontSizesFollowHeight {
+  EWCLayoutSolution solution;
+  EWCLayoutSolve(&solution, 375, 700, 20);
+  const EWCLayoutConstants *constants = EWCLayoutConstantsForMode(EWCLayoutTallMode);
+
+  XCTAssertEqual(solution.constants, constants);
+  XCTAssertEqualWithAccuracy(solution.displayFontSize, 700.0 * constants->displaySizeAsPercentOfHeight, 1e-9);
+  XCTAssertEqualWithAccuracy(solution.digitFontSize, 700.0 * constants->digitSizeAsPercentOfHeight, 1e-9);
+  XCTAssertEqualWithAccuracy(solution.operatorTitleInset, solution.operatorFontSize * 0.2, 1e-9);
+  XCTAssertEqualWithAccuracy(solution.displayHeight,
+    solution.displayFontSize * constants->displayHeightFromFontSize, 1e-9);
+  XCTAssertEqualWithAccuracy(solution.gridTopConstant, -700 + solution.displayHeight + 20, 1e-9);
+  XCTAssertEqualWithAccuracy(solution.gridHeight, 700 - solution.displayHeight - 40, 1e-9);
+  XCTAssertEqualWithAccuracy(solution.gridWidth, 335, 1e-9);
+}
+
+- (void)testCellRectAppliesGutters {
+  EWCLayoutRect rect = EWCLayoutCellRect(300, 900, 9, 3, 0.02, 0.03, 0, 0, 0, 0);
+  XCTAssertEqualWithAccuracy(rect.x, 4.5, 1e-9);
+  XCTAssertEqualWithAccuracy(rect.y, 9, 1e-9);
+  XCTAssertEqualWithAccuracy(rect.width, 91, 1e-9);
+  XCTAssertEqualWithAccuracy(rect.height, 82, 1e-9);
+
+  // spanning two rows takes in the gutter between them
+  rect = EWCLayoutCellRect(300, 900, 9, 3, 0.02, 0.03, 3, 2, 4, 2);
+  XCTAssertEqualWithAccuracy(rect.x, 204.5, 1e-9);
+  XCTAssertEqualWithAccuracy(rect.y, 309, 1e-9);
+  XCTAssertEqualWithAccuracy(rect.height, 182, 1e-9);
+}
+
+- (void)testEveryKeyIsPlacedOnceWithoutOverlap {
+  double sizes[][2] = { { 375, 600 }, { 375, 700 }, { 800, 400 } };
+  for (int s = 0; s < 3; ++s) {
+    EWCLayoutSolution solution;
+    EWCLayoutSolve(&solution, sizes[s][0], sizes[s][1], 20);
+    const EWCLayoutGrid *grid = solution.grid;
+
+    BOOL placed[EWCCalculatorEqualKey + 1] = { NO };
+    for (int i = 0; i < grid->placementCount; ++i) {
+      int key = grid->placements[i].key;
+      XCTAssertFalse(placed[key]);
+      placed[key] = YES;
+
+      EWCLayoutRect a = solution.frames[i];
+      XCTAssertGreaterThanOrEqual(a.x, 0);
+      XCTAssertGreaterThanOrEqual(a.y, 0);
+      XCTAssertLessThanOrEqual(a.x + a.width, solution.gridWidth + 1e-9);
+      XCTAssertLessThanOrEqual(a.y + a.height, solution.gridHeight + 1e-9);
+
+      for (int j = 0; j < i; ++j) {
+        EWCLayoutRect b = solution.frames[j];
+        BOOL overlaps = a.x < b.x + b.width && b.x < a.x + a.width
+          && a.y < b.y + b.height && b.y < a.y + a.height;
+        XCTAssertFalse(overlaps, @"keys %d and %d", key, grid->placements[j].key);
+      }
+    }
+
+    for (int key = 0; key <= EWCCalculatorEqualKey; ++key) {
+      XCTAssertTrue(placed[key], @"key %d", key);
+    }
+  }
+}
+
+- (void)testCacheRemembersRecentSizes {
+  EWCLayoutCache cache;
+  EWCLayoutCacheClear(&cache);
+
+  const EWCLayoutSolution *first = EWCLayoutCacheSolve(&cache, 375, 700, 20);
+  const EWCLayoutSolution *second = EWCLayoutCacheSolve(&cache, 320, 700, 20);
+  XCTAssertEqual(EWCLayoutCacheSolve(&cache, 375, 700, 20), first);
+  XCTAssertEqual(EWCLayoutCacheSolve(&cache, 320, 700, 20), second);
+  XCTAssertEqual(cache.lookups, 4);
+  XCTAssertEqual(cache.hits, 2);
+
+  // a different margin is a different layout
+  XCTAssertNotEqual(EWCLayoutCacheSolve(&cache, 375, 700, 16), first);
+
+  EWCLayoutSolution expected;
+  EWCLayoutSolve(&expected, 375, 700, 20);
+  XCTAssertEqual(first->mode, expected.mode);
+  XCTAssertEqual(first->displayFontSize, expected.displayFontSize);
+  XCTAssertEqual(first->frames[3].x, expected.frames[3].x);
+}
+
+- (void)testCacheReplacesLeastRecentlyUsed {
+  EWCLayoutCache cache;
+  EWCLayoutCacheClear(&cache);
+
+  for (int i = 0; i < EWCLayoutCacheSize; ++i) {
+    EWCLayoutCacheSolve(&cache, 300 + i, 700, 20);
+  }
+
+  // use the first again, so that the second is the oldest
+  EWCLayoutCacheSolve(&cache, 300, 700, 20);
+  EWCLayoutCacheSolve(&cache, 1000, 700, 20);
+
+  uint64_t hits = cache.hits;
+  EWCLayoutCacheSolve(&cache, 300, 700, 20);
+  XCTAssertEqual(cache.hits, hits + 1);
+  EWCLayoutCacheSolve(&cache, 301, 700, 20);
+  XCTAssertEqual(cache.hits, hits + 1);
+}
+
+///------------------------
+/// @name Performance Tests
+///------------------------
+
+- (void)testPerformanceSolve {
+  [self measureBlock:^{
+    EWCLayoutSolution solution;
+    for (int i = 0; i < s_benchmarkIterations; ++i) {
+      EWCLayoutSolve(&solution, (i % 2) ? 320 : 694, 768, 20);
+    }
+  }];
+}
+
+- (void)testPerformanceCachedSolve {
+  EWCLayoutCache cache;
+  EWCLayoutCacheClear(&cache);
+
+  [self measureBlock:^{
+    EWCLayoutCache local = cache;
+    for (int i = 0; i < s_benchmarkIterations; ++i) {
+      EWCLayoutCacheSolve(&local, (i % 2) ? 320 : 694, 768, 20);
+    }
+  }];
+}
+
+@end
@@ -0,0 +1,130 @@
+//
+//  EWCLocaleDescriptorTests.m
+//  EbbyCalcTests
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <XCTest/XCTest.h>
+#import "../EbbyCalc/EWCLocaleDescriptor.h"
+#import "../EbbyCalc/EWCDisplayFormatter.h"
+#import "../EbbyCalc/EWCCalculator.h"
+
+static const int s_concurrentLookups = 1000;
+static const int s_benchmarkIterations = 1000;
+
+@interface EWCLocaleDescriptorTests : XCTestCase
+
+@end
+
+@implementation EWCLocaleDescriptorTests
+
+- (void)testDescriptorsAreInterned {
+  EWCLocaleDescriptor *first = [EWCLocaleDescriptor descriptorForLocale:[NSLocale localeWithLocaleIdentifier:@"de_DE"]];
+  EWCLocaleDescriptor *second = [EWCLocaleDescriptor descriptorForLocale:[NSLocale localeWithLocaleIdentifier:@"de_DE"]];
+  EWCLocaleDescriptor *other = [EWCLocaleDescriptor descriptorForLocale:[NSLocale localeWithLocaleIdentifier:@"fr_FR"]];
+
+  XCTAssertEqual(first, second);
+  XCTAssertNotEqual(first, other);
+  XCTAssertEqualObjects(first.localeIdentifier, @"de_DE");
+}
+
+- (void)testConcurrentLookupsShareOneDescriptor {
+  NSArray<NSString *> *identifiers = @[ @"en_US", @"ja_JP", @"ar_EG", @"hi_IN", @"sv_SE" ];
+  NSMutableArray<EWCLocaleDescriptor *> *expected = [NSMutableArray new];
+  for (NSString *identifier in identifiers) {
+    [expected addObject:[EWCLocaleDescriptor descriptorForLocale:[NSLocale localeWithLocaleIdentifier:identifier]]];
+  }
+
+  __block BOOL mismatch = NO;
+  dispatch_apply(s_concurrentLookups, dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^(size_t index) {
+    NSUInteger which = index % identifiers.count;
+    EWCLocaleDescriptor *descriptor = [EWCLocaleDescriptor
+      descriptorForLocale:[NSLocale localeWithLocaleIdentifier:identifiers[which]]];
+    if (descriptor != expected[which]) {
+      mismatch = YES;
+    }
+  });
+
+  XCTAssertFalse(mismatch);
+}
+
+- (void)testCapturesSeparatorsAndGrouping {
+  EWCLocaleDescriptor *descriptor = [EWCLocaleDescriptor descriptorForLocale:[NSLocale localeWithLocaleIdentifier:@"de_DE"]];
+
+  XCTAssertEqualObjects(descriptor.decimalSeparator, @",");
+  XCTAssertEqualObjects(descriptor.groupingSeparator, @".");
+
+  const EWCLocaleNumberRules *rules = descriptor.numberRules;
+  XCTAssertTrue(rules != NULL);
+  XCTAssertTrue(rules->usesGrouping);
+  XCTAssertEqual(rules->groupingSize, 3);
+  XCTAssertEqual(rules->digitGlyphs[7], '7');
+}
+
+- (void)testCapturesNativeDigits {
+  EWCLocaleDescriptor *descriptor = [EWCLocaleDescriptor descriptorForLocale:[NSLocale localeWithLocaleIdentifier:@"ar_EG"]];
+
+  const EWCLocaleNumberRules *rules = descriptor.numberRules;
+  if (rules) {
+    XCTAssertEqual(rules->digitGlyphs[0], 0x0660);
+  }
+}
+
+- (void)testCapturesSpellOut {
+  EWCLocaleDescriptor *descriptor = [EWCLocaleDescriptor descriptorForLocale:[NSLocale localeWithLocaleIdentifier:@"en_US"]];
+
+  XCTAssertEqual(descriptor.spelledOutDigits.count, 10);
+  XCTAssertEqualObjects(descriptor.spelledOutDigits[0], @"zero");
+  XCTAssertEqualObjects(descriptor.spelledOutDigits[9], @"nine");
+  XCTAssertEqualObjects(descriptor.spelledOutNegative, @"minus");
+  XCTAssertEqualObjects(descriptor.spelledOutDecimal, @"point");
+}
+
+- (void)testFormattersAndCalculatorsShareDescriptor {
+  NSLocale *locale = [NSLocale localeWithLocaleIdentifier:@"fr_CH"];
+  EWCLocaleDescriptor *descriptor = [EWCLocaleDescriptor descriptorForLocale:locale];
+
+  EWCDisplayFormatter *formatter = [EWCDisplayFormatter formatterWithLocale:locale maximumFractionDigits:16];
+  XCTAssertEqual(formatter.descriptor, descriptor);
+
+  EWCCalculator *first = [EWCCalculator new];
+  EWCCalculator *second = [EWCCalculator new];
+  first.locale = locale;
+  second.locale = [NSLocale localeWithLocaleIdentifier:@"fr_CH"];
+  XCTAssertEqual(first.locale, descriptor.locale);
+  XCTAssertEqual(second.locale, descriptor.locale);
+}
+
+///------------------------
+/// @name Performance Tests
+///------------------------
+
+- (void)testPerformanceCreateFormatters {
+  NSLocale *locale = [NSLocale localeWithLocaleIdentifier:@"en_US"];
+  NSDecimal value = [NSDecimalNumber decimalNumberWithString:@"-12345678.90125"].decimalValue;
+
+  [self measureBlock:^{
+    for (int i = 0; i < s_benchmarkIterations; ++i) {
+      // as each new session would
+      EWCDisplayFormatter *formatter = [EWCDisplayFormatter formatterWithLocale:locale maximumFractionDigits:16];
+      [formatter stringFromDecimal:value minimumFractionDigits:0];
+    }
+  }];
+}
+
+@end
@@ -0,0 +1,280 @@
+//
+//  EWCResultColumnsTests.m
+//  EbbyCalcTests
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <XCTest/XCTest.h>
+#import "../EbbyCalc/EWCCalculator.h"
+#import "../EbbyCalc/EWCResultColumnReader.h"
+#import "../EbbyCalc/EWCResultColumnWriter.h"
+
+static const NSUInteger s_benchmarkSessions = 20000;
+
+@interface EWCResultColumnsTests : XCTestCase {
+  NSString *_path;
+}
+
+@end
+
+@implementation EWCResultColumnsTests
+
+- (void)setUp {
+  _path = [NSTemporaryDirectory() stringByAppendingPathComponent:
+    [NSString stringWithFormat:@"%@.ewcr", [NSUUID UUID].UUIDString]];
+}
+
+- (void)tearDown {
+  [[NSFileManager defaultManager] removeItemAtPath:_path error:nil];
+}
+
+- (EWCResultColumnWriter *)writerWithRowsPerBlock:(uint32_t)rowsPerBlock {
+  return [EWCResultColumnWriter writerWithOutputStream:[NSOutputStream outputStreamToFileAtPath:_path append:NO]
+    rowsPerBlock:rowsPerBlock];
+}
+
+/**
+  Makes the row for a session of the round trip tests, with values that vary in sign, width, and exponent.
+
+  @param index The session's place in the batch.
+
+  @return The row.
+ */
+- (EWCResultRow)rowAtIndex:(NSUInteger)index {
+  EWCResultRow row;
+  row.sessionID = 5000 + index * 3;
+  row.keyCount = index * 7;
+  row.display = [NSDecimalNumber decimalNumberWithMantissa:index * 1234567891ULL
+    exponent:-(short)(index % 19)
+    isNegative:(index % 2 == 1)].decimalValue;
+  row.memory = (index % 11 == 0)
+    ? [NSDecimalNumber notANumber].decimalValue
+    : [NSDecimalNumber decimalNumberWithMantissa:index exponent:2 isNegative:NO].decimalValue;
+  row.error = (index % 5 == 0);
+  row.status = (EWCResultStatus)(index % 64);
+
+  return row;
+}
+
+- (void)assertRow:(const EWCResultRow *)row matchesRow:(const EWCResultRow *)expected index:(NSUInteger)index {
+  XCTAssertEqual(row->sessionID, expected->sessionID, @"session id of row %lu", (unsigned long)index);
+  XCTAssertEqual(row->keyCount, expected->keyCount, @"key count of row %lu", (unsigned long)index);
+  XCTAssertEqualObjects([NSDecimalNumber decimalNumberWithDecimal:row->display],
+    [NSDecimalNumber decimalNumberWithDecimal:expected->display], @"display of row %lu", (unsigned long)index);
+  XCTAssertEqualObjects([NSDecimalNumber decimalNumberWithDecimal:row->memory],
+    [NSDecimalNumber decimalNumberWithDecimal:expected->memory], @"memory of row %lu", (unsigned long)index);
+  XCTAssertEqual(row->error, expected->error, @"error of row %lu", (unsigned long)index);
+  XCTAssertEqual(row->status, expected->status, @"status of row %lu", (unsigned long)index);
+}
+
+- (void)testRoundTrip {
+  // three full blocks and part of a fourth
+  EWCResultColumnWriter *writer = [self writerWithRowsPerBlock:16];
+  for (NSUInteger i = 0; i < 53; ++i) {
+    EWCResultRow row = [self rowAtIndex:i];
+    XCTAssertTrue([writer appendRow:&row]);
+  }
+  XCTAssertTrue([writer finish]);
+  XCTAssertEqual(writer.rowCount, 53);
+  XCTAssertEqual(writer.blockCount, 4);
+
+  EWCResultColumnReader *reader = [EWCResultColumnReader readerWithContentsOfFile:_path];
+  XCTAssertNotNil(reader);
+  XCTAssertTrue(reader.isFinished);
+  XCTAssertEqual(reader.rowsPerBlock, 16);
+  XCTAssertEqual(reader.blockCount, 4);
+  XCTAssertEqual(reader.rowCount, 53);
+  XCTAssertEqual(reader.errorCount, 11);
+
+  for (NSUInteger i = 0; i < 53; ++i) {
+    EWCResultRow expected = [self rowAtIndex:i];
+    EWCResultRow row;
+    XCTAssertTrue([reader getRow:&row atIndex:i]);
+    [self assertRow:&row matchesRow:&expected index:i];
+  }
+
+  EWCResultRow row;
+  XCTAssertFalse([reader getRow:&row atIndex:53]);
+
+  XCTAssertEqual([reader indexOfRowWithSessionID:5000 + 40 * 3], 40);
+  XCTAssertEqual([reader indexOfRowWithSessionID:5001], NSNotFound);
+
+  EWCResultColumnsIndexEntry entry;
+  XCTAssertTrue([reader getIndexEntry:&entry forBlock:3]);
+  XCTAssertEqual(entry.rowCount, 5);
+  XCTAssertEqual(entry.minimumSessionID, 5000 + 48 * 3);
+  XCTAssertEqual(entry.maximumSessionID, 5000 + 52 * 3);
+}
+
+- (void)testRoundTripFromCalculator {
+  EWCCalculator *calculator = [EWCCalculator calculator];
+  for (NSString *keys in @[ @"8.25qw", @"19.99*2=wsa", @"4\\y" ]) {
+    for (NSUInteger i = 0; i < keys.length; ++i) {
+      [calculator pressKey:EWCCalculatorKeyFromCharacter([keys characterAtIndex:i])];
+    }
+  }
+
+  EWCResultColumnWriter *writer = [self writerWithRowsPerBlock:8];
+  XCTAssertTrue([writer appendSessionID:42 keyCount:20 calculator:calculator]);
+  XCTAssertTrue([writer finish]);
+
+  EWCResultColumnReader *reader = [EWCResultColumnReader readerWithContentsOfFile:_path];
+  EWCResultRow row;
+  XCTAssertTrue([reader getRow:&row atIndex:0]);
+  XCTAssertEqual(row.sessionID, 42);
+  XCTAssertEqual(row.keyCount, 20);
+  XCTAssertEqualObjects([NSDecimalNumber decimalNumberWithDecimal:row.display], calculator.displayValue);
+  XCTAssertEqualObjects([NSDecimalNumber decimalNumberWithDecimal:row.memory], calculator.memoryValue);
+  XCTAssertTrue(row.error);
+  XCTAssertEqual((row.status & EWCResultMemoryStatus) != 0, calculator.hasMemory);
+  XCTAssertEqual((row.status & EWCResultTaxPlusStatus) != 0, calculator.isTaxPlusStatusVisible);
+}
+
+- (void)testColumnScan {
+  EWCResultColumnWriter *writer = [self writerWithRowsPerBlock:16];
+  for (NSUInteger i = 0; i < 40; ++i) {
+    EWCResultRow row = [self rowAtIndex:i];
+    [writer appendRow:&row];
+  }
+  XCTAssertTrue([writer finish]);
+
+  // total the keys column without decoding the rows
+  EWCResultColumnReader *reader = [EWCResultColumnReader readerWithContentsOfFile:_path];
+  uint64_t keys = 0;
+  for (NSUInteger b = 0; b < reader.blockCount; ++b) {
+    uint32_t rowCount;
+    const uint8_t *column = [reader bytesOfColumn:EWCResultKeyCountColumn inBlock:b rowCount:&rowCount];
+    XCTAssertTrue(column != NULL);
+    for (uint32_t i = 0; i < rowCount; ++i) {
+      keys += EWCResultColumnsReadUInt64(column + EWCResultColumnsWidth(EWCResultKeyCountColumn) * i);
+    }
+  }
+
+  XCTAssertEqual(keys, 7 * (39 * 40 / 2));
+}
+
+- (void)testUnfinishedFileReadsWholeBlocks {
+  EWCResultColumnWriter *writer = [self writerWithRowsPerBlock:16];
+  for (NSUInteger i = 0; i < 40; ++i) {
+    EWCResultRow row = [self rowAtIndex:i];
+    [writer appendRow:&row];
+  }
+
+  // the two full blocks have been written, but not the rest or the footer
+  XCTAssertEqual(writer.blockCount, 2);
+
+  EWCResultColumnReader *reader = [EWCResultColumnReader readerWithData:[NSData dataWithContentsOfFile:_path]];
+  XCTAssertNotNil(reader);
+  XCTAssertFalse(reader.isFinished);
+  XCTAssertEqual(reader.blockCount, 2);
+  XCTAssertEqual(reader.rowCount, 32);
+  XCTAssertEqual(reader.errorCount, 7);
+  XCTAssertEqual([reader indexOfRowWithSessionID:5000 + 31 * 3], 31);
+
+  EWCResultRow expected = [self rowAtIndex:20];
+  EWCResultRow row;
+  XCTAssertTrue([reader getRow:&row atIndex:20]);
+  [self assertRow:&row matchesRow:&expected index:20];
+
+  XCTAssertTrue([writer finish]);
+}
+
+- (void)testDamagedBlockIsDetected {
+  EWCResultColumnWriter *writer = [self writerWithRowsPerBlock:16];
+  for (NSUInteger i = 0; i < 40; ++i) {
+    EWCResultRow row = [self rowAtIndex:i];
+    [writer appendRow:&row];
+  }
+  XCTAssertTrue([writer finish]);
+
+  // flip a bit in the display column of the second block
+  NSMutableData *data = [NSMutableData dataWithContentsOfFile:_path];
+  size_t offset = EWCResultColumnsHeaderSize + EWCResultColumnsBlockSize(16)
+    + EWCResultColumnsOffset(EWCResultDisplayColumn, 16);
+  ((uint8_t *)data.mutableBytes)[offset] ^= 0x10;
+
+  EWCResultColumnReader *reader = [EWCResultColumnReader readerWithData:data];
+  XCTAssertTrue(reader.isFinished);
+
+  EWCResultRow row;
+  XCTAssertTrue([reader getRow:&row atIndex:15]);
+  XCTAssertFalse([reader getRow:&row atIndex:16]);
+  XCTAssertTrue([reader getRow:&row atIndex:32]);
+
+  // a file that isn't results is refused
+  XCTAssertNil([EWCResultColumnReader readerWithData:[@"not results" dataUsingEncoding:NSUTF8StringEncoding]]);
+}
+
+///------------------------
+/// @name Performance Tests
+///------------------------
+
+/**
+  Runs a calculator through a short session, different for each index, so the benchmarks have results to write.
+
+  @param calculator The calculator.
+  @param index The session's place in the batch.
+ */
+- (void)runBenchmarkSession:(EWCCalculator *)calculator index:(NSUInteger)index {
+  [calculator reset];
+  [calculator pressKey:(EWCCalculatorKey)(EWCCalculatorOneKey + index % 9)];
+  [calculator pressKey:EWCCalculatorDecimalKey];
+  [calculator pressKey:(EWCCalculatorKey)(EWCCalculatorZeroKey + index % 10)];
+  [calculator pressKey:EWCCalculatorMultiplyKey];
+  [calculator pressKey:(EWCCalculatorKey)(EWCCalculatorOneKey + index % 7)];
+  [calculator pressKey:EWCCalculatorEqualKey];
+  [calculator pressKey:EWCCalculatorMemoryPlusKey];
+}
+
+- (void)testPerformanceTextOutput {
+  EWCCalculator *calculator = [EWCCalculator calculator];
+
+  [self measureBlock:^{
+    NSOutputStream *stream = [NSOutputStream outputStreamToFileAtPath:self->_path append:NO];
+    [stream open];
+    for (NSUInteger i = 0; i < s_benchmarkSessions; ++i) {
+      @autoreleasepool {
+        [self runBenchmarkSession:calculator index:i];
+
+        NSString *line = [NSString stringWithFormat:@"%lu\t%@\t%@\t%d\t%d\t%lu\n",
+          (unsigned long)i, calculator.displayContent, calculator.memoryValue,
+          calculator.hasError, calculator.hasMemory, (unsigned long)7];
+        NSData *bytes = [line dataUsingEncoding:NSUTF8StringEncoding];
+        [stream write:bytes.bytes maxLength:bytes.length];
+      }
+    }
+    [stream close];
+  }];
+}
+
+- (void)testPerformanceColumnarOutput {
+  EWCCalculator *calculator = [EWCCalculator calculator];
+
+  [self measureBlock:^{
+    EWCResultColumnWriter *writer = [self writerWithRowsPerBlock:4096];
+    for (NSUInteger i = 0; i < s_benchmarkSessions; ++i) {
+      @autoreleasepool {
+        [self runBenchmarkSession:calculator index:i];
+        [writer appendSessionID:i keyCount:7 calculator:calculator];
+      }
+    }
+    [writer finish];
+  }];
+}
+
+@end
@@ -0,0 +1,113 @@
+//
+//  EWCServiceConnectionTests.m
+//  EbbyCalcTests
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <XCTest/XCTest.h>
+#import <fcntl.h>
+#import <sys/socket.h>
+#import <unistd.h>
+#import "../EbbyCalcTools/EWCServiceConnection.h"
+#import "../EbbyCalcTools/EWCServiceProtocol.h"
+#import "../EbbyCalcTools/EWCSessionManager.h"
+
+// the bytes of requests the client tries to send each round, a whole number of requests
+#define EWCServiceConnectionTestSendSize 16380
+
+// the bytes of responses the client reads each round, less than the service produces
+#define EWCServiceConnectionTestReceiveSize 4096
+
+static const int s_slowReaderRounds = 800;
+
+// the output backlog at which the connection stops reading, plus what it may
+// have read before noticing, and the written output it keeps before compacting
+static const NSUInteger s_maximumBufferedOutput = 1048576 + 65536 + 65536;
+
+@interface EWCServiceConnectionTests : XCTestCase {
+  int _clientSocket;
+  EWCServiceConnection *_connection;
+}
+
+@end
+
+@implementation EWCServiceConnectionTests
+
+- (void)setUp {
+  int sockets[2];
+  XCTAssertEqual(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets), 0);
+  for (int i = 0; i < 2; ++i) {
+    fcntl(sockets[i], F_SETFL, fcntl(sockets[i], F_GETFL, 0) | O_NONBLOCK);
+  }
+
+  EWCSessionManager *manager = [EWCSessionManager managerWithLocale:[NSLocale localeWithLocaleIdentifier:@"en_US"]
+    maximumDigits:16];
+  _connection = [EWCServiceConnection connectionWithFileDescriptor:sockets[0]
+    protocol:[EWCServiceProtocol protocolWithSessionManager:manager]];
+  _clientSocket = sockets[1];
+}
+
+- (void)tearDown {
+  [_connection close];
+  close(_clientSocket);
+}
+
+- (void)testSlowReaderKeepsOutputBounded {
+  static const char s_request[] = "PING\n";
+  const size_t requestLength = sizeof(s_request) - 1;
+
+  char requests[EWCServiceConnectionTestSendSize];
+  for (size_t i = 0; i < sizeof(requests); ++i) {
+    requests[i] = s_request[i % requestLength];
+  }
+
+  // the client pipelines as fast as the socket takes the requests, but reads
+  // the responses more slowly than they are produced, so the output never
+  // drains completely
+  char responses[EWCServiceConnectionTestReceiveSize];
+  size_t sent = 0;
+  size_t received = 0;
+  NSUInteger largest = 0;
+  for (int round = 0; round < s_slowReaderRounds; ++round) {
+    // the requests repeat, so carrying on from part way through one is fine
+    ssize_t count = write(_clientSocket, requests + sent % requestLength,
+      sizeof(requests) - requestLength);
+    if (count > 0) {
+      sent += (size_t)count;
+    }
+
+    if (_connection.acceptsInput) {
+      XCTAssertTrue([_connection readAvailableAtTime:0]);
+    }
+    XCTAssertTrue([_connection writePending]);
+    largest = MAX(largest, _connection.bufferedOutputLength);
+
+    count = read(_clientSocket, responses, sizeof(responses));
+    if (count > 0) {
+      received += (size_t)count;
+    }
+  }
+
+  // more was written than the buffer may hold, so keeping the written part
+  // would have shown up
+  XCTAssertGreaterThan(received, s_maximumBufferedOutput);
+  XCTAssertTrue(_connection.hasPendingOutput);
+  XCTAssertLessThanOrEqual(largest, s_maximumBufferedOutput);
+}
+
+@end
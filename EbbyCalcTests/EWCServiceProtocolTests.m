@@ -0,0 +1,116 @@
+//
+//  EWCServiceProtocolTests.m
+//  EbbyCalcTests
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <XCTest/XCTest.h>
+#import "../EbbyCalc/EWCCalculator.h"
+#import "../EbbyCalcTools/EWCSessionManager.h"
+#import "../EbbyCalcTools/EWCServiceProtocol.h"
+
+@interface EWCServiceProtocolTests : XCTestCase {
+  EWCSessionManager *_manager;
+  EWCServiceProtocol *_protocol;
+}
+
+@end
+
+@implementation EWCServiceProtocolTests
+
+- (void)setUp {
+  _manager = [EWCSessionManager managerWithLocale:[NSLocale localeWithLocaleIdentifier:@"en_US"]
+    maximumDigits:16];
+  _protocol = [EWCServiceProtocol protocolWithSessionManager:_manager];
+}
+
+- (NSString *)request:(NSString *)request {
+  return [_protocol responseToRequest:request atTime:0];
+}
+
+- (void)testSessionLifecycle {
+  XCTAssertEqualObjects([self request:@"OPEN a"], @"OK");
+  XCTAssertEqualObjects([self request:@"KEYS a 12+3="], @"OK 15.");
+  XCTAssertEqualObjects([self request:@"STATE a"],
+    @"OK display=15. error=0 hasmemory=0 mclear=0 tax=0 taxplus=0 taxminus=0 taxpercent=0 shifted=0");
+  XCTAssertEqualObjects([self request:@"KEYS a s"], @"OK 15.");
+  XCTAssertEqualObjects([self request:@"SNAPSHOT a"],
+    @"OK value=15 memory=15 display=15. error=0 hasmemory=1 mclear=0 tax=0 taxplus=0 taxminus=0 taxpercent=0 shifted=0");
+  XCTAssertEqualObjects([self request:@"CLOSE a"], @"OK");
+  XCTAssertEqualObjects([self request:@"STATE a"], @"ERR no session a");
+}
+
+- (void)testSessionsAreIndependent {
+  [self request:@"OPEN a"];
+  [self request:@"OPEN b"];
+  [self request:@"KEYS a 7"];
+  XCTAssertEqualObjects([self request:@"KEYS b 2*4="], @"OK 8.");
+  XCTAssertEqualObjects([self request:@"KEYS a ="], @"OK 7.");
+
+  // reopening keeps the existing session
+  [self request:@"OPEN b"];
+  XCTAssertEqualObjects([self request:@"KEYS b ="], @"OK 32.");
+}
+
+- (void)testBadRequests {
+  XCTAssertEqualObjects([self request:@""], @"ERR empty request");
+  XCTAssertEqualObjects([self request:@"FROB a"], @"ERR no session a");
+  XCTAssertEqualObjects([self request:@"KEYS"], @"ERR KEYS requires a session");
+
+  [self request:@"OPEN a"];
+  XCTAssertEqualObjects([self request:@"FROB a"], @"ERR unknown command FROB");
+  XCTAssertEqualObjects([self request:@"KEYS a"], @"ERR KEYS requires keys");
+
+  // a bad key rejects the whole request
+  XCTAssertEqualObjects([self request:@"KEYS a 12x"], @"ERR bad key x");
+  XCTAssertEqualObjects([self request:@"STATE a"],
+    @"OK display=0. error=0 hasmemory=0 mclear=0 tax=0 taxplus=0 taxminus=0 taxpercent=0 shifted=0");
+}
+
+- (void)testClosedCalculatorsAreReused {
+  [self request:@"OPEN a"];
+  [self request:@"KEYS a 9s"];
+  EWCCalculator *calculator = [_manager sessionNamed:@"a" atTime:0];
+  [self request:@"CLOSE a"];
+  XCTAssertEqual(_manager.pooledCount, 1);
+
+  // the pooled calculator comes back fully reset
+  [self request:@"OPEN b"];
+  XCTAssertEqual(_manager.pooledCount, 0);
+  XCTAssertEqual([_manager sessionNamed:@"b" atTime:0], calculator);
+  XCTAssertEqualObjects([self request:@"STATE b"],
+    @"OK display=0. error=0 hasmemory=0 mclear=0 tax=0 taxplus=0 taxminus=0 taxpercent=0 shifted=0");
+}
+
+- (void)testIdleSessionsAreEvicted {
+  _manager.idleTimeout = 10;
+
+  [_protocol responseToRequest:@"OPEN old" atTime:0];
+  [_protocol responseToRequest:@"OPEN busy" atTime:0];
+  [_protocol responseToRequest:@"KEYS busy 1" atTime:8];
+
+  XCTAssertEqual([_manager evictIdleSessionsAtTime:5], 0);
+  XCTAssertEqual([_manager evictIdleSessionsAtTime:15], 1);
+  XCTAssertEqual(_manager.sessionCount, 1);
+  XCTAssertEqual(_manager.evictedCount, 1);
+
+  XCTAssertEqualObjects([_protocol responseToRequest:@"STATE old" atTime:15], @"ERR no session old");
+  XCTAssertEqualObjects([_protocol responseToRequest:@"KEYS busy 2" atTime:15], @"OK 12.");
+}
+
+@end
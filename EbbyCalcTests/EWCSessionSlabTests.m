@@ -0,0 +1,309 @@
+//
+//  EWCSessionSlabTests.m
+//  EbbyCalcTests
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <XCTest/XCTest.h>
+#import "../EbbyCalc/EWCCalculator.h"
+#import "../EbbyCalcTools/EWCSessionManager.h"
+#import "../EbbyCalcTools/EWCServiceProtocol.h"
+#import "../EbbyCalcTools/EWCSessionSlab.h"
+
+// the size of the plain test states
+#define EWCSessionSlabTestStateSize 64
+
+static const uint32_t s_testStateVersion = 7;
+static const uint32_t s_benchmarkSessions = 4096;
+
+@interface EWCSessionSlabTests : XCTestCase {
+  NSString *_path;
+}
+
+@end
+
+@implementation EWCSessionSlabTests
+
+- (void)setUp {
+  _path = [NSTemporaryDirectory() stringByAppendingPathComponent:
+    [NSString stringWithFormat:@"slab-%@.bin", [NSUUID UUID].UUIDString]];
+}
+
+- (void)tearDown {
+  [[NSFileManager defaultManager] removeItemAtPath:_path error:nil];
+}
+
+- (EWCSessionManager *)newManager {
+  return [EWCSessionManager managerWithLocale:[NSLocale localeWithLocaleIdentifier:@"en_US"]
+    maximumDigits:16];
+}
+
+/**
+  Fills a test state with a recognizable value.
+ */
+static void fillState(uint8_t *state, uint8_t value) {
+  memset(state, value, EWCSessionSlabTestStateSize);
+}
+
+- (void)testRestartedServiceReattachesSessions {
+  EWCSessionManager *manager = [self newManager];
+  XCTAssertEqual([manager attachSlabAtPath:_path capacity:16 atTime:0], 0);
+
+  EWCServiceProtocol *protocol = [EWCServiceProtocol protocolWithSessionManager:manager];
+  [protocol responseToRequest:@"OPEN a" atTime:0];
+  [protocol responseToRequest:@"OPEN b" atTime:0];
+  [protocol responseToRequest:@"OPEN c" atTime:0];
+  [protocol responseToRequest:@"KEYS a 12+3=s" atTime:0];
+
+  // leave b part way through an operation, with input still being built
+  [protocol responseToRequest:@"KEYS b 2*4.50" atTime:0];
+  [protocol responseToRequest:@"CLOSE c" atTime:0];
+  XCTAssertEqual(manager.persistedCount, 2);
+  [manager detachSlab];
+
+  EWCSessionManager *restarted = [self newManager];
+  XCTAssertEqual([restarted attachSlabAtPath:_path capacity:16 atTime:0], 0);
+  XCTAssertEqual(restarted.sessionCount, 2);
+
+  EWCServiceProtocol *restartedProtocol = [EWCServiceProtocol protocolWithSessionManager:restarted];
+  XCTAssertEqualObjects([restartedProtocol responseToRequest:@"SNAPSHOT a" atTime:0],
+    @"OK value=15 memory=15 display=15. error=0 hasmemory=1 mclear=0 tax=0 taxplus=0 taxminus=0 taxpercent=0 shifted=0");
+  XCTAssertEqualObjects([restartedProtocol responseToRequest:@"STATE b" atTime:0],
+    @"OK display=4.50 error=0 hasmemory=0 mclear=0 tax=0 taxplus=0 taxminus=0 taxpercent=0 shifted=0");
+
+  // the pending operation and the input survived
+  XCTAssertEqualObjects([restartedProtocol responseToRequest:@"KEYS b 5=" atTime:0], @"OK 9.01");
+  XCTAssertEqualObjects([restartedProtocol responseToRequest:@"STATE c" atTime:0], @"ERR no session c");
+}
+
+- (void)testStoredStatesRoundTrip {
+  EWCSessionSlab slab;
+  XCTAssertEqual(EWCSessionSlabOpen(&slab, _path.fileSystemRepresentation, 8,
+    EWCSessionSlabTestStateSize, s_testStateVersion), 0);
+
+  uint8_t state[EWCSessionSlabTestStateSize];
+  fillState(state, 1);
+  uint32_t slot = EWCSessionSlabAllocate(&slab, "one", state);
+  for (uint8_t i = 2; i <= 5; ++i) {
+    fillState(state, i);
+    EWCSessionSlabStore(&slab, slot, state);
+  }
+  EWCSessionSlabClose(&slab);
+
+  XCTAssertEqual(EWCSessionSlabOpen(&slab, _path.fileSystemRepresentation, 8,
+    EWCSessionSlabTestStateSize, s_testStateVersion), 0);
+  XCTAssertEqual(slab.liveCount, 1);
+  XCTAssertEqualObjects(@(EWCSessionSlabName(&slab, slot)), @"one");
+
+  uint8_t loaded[EWCSessionSlabTestStateSize];
+  XCTAssertTrue(EWCSessionSlabLoad(&slab, slot, loaded));
+  XCTAssertEqual(memcmp(loaded, state, EWCSessionSlabTestStateSize), 0);
+  EWCSessionSlabClose(&slab);
+}
+
+- (void)testTornStoreFallsBackToPreviousState {
+  EWCSessionSlab slab;
+  XCTAssertEqual(EWCSessionSlabOpen(&slab, _path.fileSystemRepresentation, 4,
+    EWCSessionSlabTestStateSize, s_testStateVersion), 0);
+
+  uint8_t state[EWCSessionSlabTestStateSize];
+  fillState(state, 0xa0);
+  uint32_t slot = EWCSessionSlabAllocate(&slab, "torn", state);
+  fillState(state, 0xb0);
+  EWCSessionSlabStore(&slab, slot, state);
+
+  // the next store goes to the copy holding the first state
+  uint64_t sequence = slab.sequences[slot] + 1;
+  size_t copyOffset = sizeof(EWCSessionSlabHeader) + (size_t)slot * slab.recordSize
+    + EWCSessionSlabNameSize + (sequence & 1) * slab.copySize;
+  size_t stateOffset = copyOffset + sizeof(EWCSessionSlabCopyHeader);
+  EWCSessionSlabClose(&slab);
+
+  NSData *before = [NSData dataWithContentsOfFile:_path];
+
+  XCTAssertEqual(EWCSessionSlabOpen(&slab, _path.fileSystemRepresentation, 4,
+    EWCSessionSlabTestStateSize, s_testStateVersion), 0);
+  fillState(state, 0xc0);
+  EWCSessionSlabStore(&slab, slot, state);
+  EWCSessionSlabClose(&slab);
+
+  NSData *after = [NSData dataWithContentsOfFile:_path];
+
+  // replay the store up to every point it could have been cut off at: each
+  // byte of the state, then the sequence, then the checksum
+  for (size_t cut = 0; cut <= EWCSessionSlabTestStateSize + 2; ++cut) {
+    NSMutableData *image = [before mutableCopy];
+    size_t stateBytes = MIN(cut, (size_t)EWCSessionSlabTestStateSize);
+    [image replaceBytesInRange:NSMakeRange(stateOffset, stateBytes)
+      withBytes:(const uint8_t *)after.bytes + stateOffset];
+    if (cut > EWCSessionSlabTestStateSize) {
+      size_t offset = copyOffset + offsetof(EWCSessionSlabCopyHeader, sequence);
+      [image replaceBytesInRange:NSMakeRange(offset, sizeof(uint64_t))
+        withBytes:(const uint8_t *)after.bytes + offset];
+    }
+    if (cut > EWCSessionSlabTestStateSize + 1) {
+      size_t offset = copyOffset + offsetof(EWCSessionSlabCopyHeader, checksum);
+      [image replaceBytesInRange:NSMakeRange(offset, sizeof(uint64_t))
+        withBytes:(const uint8_t *)after.bytes + offset];
+    }
+    XCTAssertTrue([image writeToFile:_path atomically:NO]);
+
+    XCTAssertEqual(EWCSessionSlabOpen(&slab, _path.fileSystemRepresentation, 4,
+      EWCSessionSlabTestStateSize, s_testStateVersion), 0);
+
+    uint8_t loaded[EWCSessionSlabTestStateSize];
+    XCTAssertTrue(EWCSessionSlabLoad(&slab, slot, loaded), @"cut at %zu", cut);
+    uint8_t expected = (cut == EWCSessionSlabTestStateSize + 2) ? 0xc0 : 0xb0;
+    uint8_t expectedState[EWCSessionSlabTestStateSize];
+    fillState(expectedState, expected);
+    XCTAssertEqual(memcmp(loaded, expectedState, EWCSessionSlabTestStateSize), 0, @"cut at %zu", cut);
+    EWCSessionSlabClose(&slab);
+  }
+}
+
+- (void)testTornOpenIsFreed {
+  EWCSessionSlab slab;
+  XCTAssertEqual(EWCSessionSlabOpen(&slab, _path.fileSystemRepresentation, 4,
+    EWCSessionSlabTestStateSize, s_testStateVersion), 0);
+
+  uint8_t state[EWCSessionSlabTestStateSize];
+  fillState(state, 0x11);
+  uint32_t slot = EWCSessionSlabAllocate(&slab, "half", state);
+
+  // as if the process died after the name was written, but before the first
+  // state was published
+  EWCSessionSlabCopyHeader *copy = (EWCSessionSlabCopyHeader *)(slab.base + sizeof(EWCSessionSlabHeader)
+    + (size_t)slot * slab.recordSize + EWCSessionSlabNameSize + (slab.sequences[slot] & 1) * slab.copySize);
+  copy->checksum = 0;
+  EWCSessionSlabClose(&slab);
+
+  XCTAssertEqual(EWCSessionSlabOpen(&slab, _path.fileSystemRepresentation, 4,
+    EWCSessionSlabTestStateSize, s_testStateVersion), 0);
+  XCTAssertEqual(slab.liveCount, 0);
+  XCTAssertEqual(slab.repairedCount, 1);
+  XCTAssertEqual(slab.freeCount, 4);
+  XCTAssertTrue(EWCSessionSlabName(&slab, slot) == NULL);
+  EWCSessionSlabClose(&slab);
+}
+
+- (void)testMismatchedLayoutIsRejected {
+  EWCSessionSlab slab;
+  XCTAssertEqual(EWCSessionSlabOpen(&slab, _path.fileSystemRepresentation, 4,
+    EWCSessionSlabTestStateSize, s_testStateVersion), 0);
+  uint8_t state[EWCSessionSlabTestStateSize];
+  fillState(state, 0x22);
+  EWCSessionSlabAllocate(&slab, "kept", state);
+  EWCSessionSlabClose(&slab);
+
+  NSData *original = [NSData dataWithContentsOfFile:_path];
+
+  XCTAssertEqual(EWCSessionSlabOpen(&slab, _path.fileSystemRepresentation, 4,
+    EWCSessionSlabTestStateSize, s_testStateVersion + 1), EINVAL);
+  XCTAssertEqual(EWCSessionSlabOpen(&slab, _path.fileSystemRepresentation, 4,
+    EWCSessionSlabTestStateSize + 8, s_testStateVersion), EINVAL);
+
+  // a rejected file is left alone
+  XCTAssertEqualObjects([NSData dataWithContentsOfFile:_path], original);
+}
+
+- (void)testFileIsOpenInOneSlabAtATime {
+  EWCSessionSlab first;
+  XCTAssertEqual(EWCSessionSlabOpen(&first, _path.fileSystemRepresentation, 4,
+    EWCSessionSlabTestStateSize, s_testStateVersion), 0);
+
+  EWCSessionSlab second;
+  XCTAssertEqual(EWCSessionSlabOpen(&second, _path.fileSystemRepresentation, 4,
+    EWCSessionSlabTestStateSize, s_testStateVersion), EWOULDBLOCK);
+
+  EWCSessionSlabClose(&first);
+}
+
+- (void)testFullSlabStillOpensSessions {
+  EWCSessionManager *manager = [self newManager];
+  XCTAssertEqual([manager attachSlabAtPath:_path capacity:1 atTime:0], 0);
+
+  [manager openSessionNamed:@"a" atTime:0];
+  [manager openSessionNamed:@"b" atTime:0];
+  [manager storeSessionNamed:@"b"];
+
+  XCTAssertEqual(manager.sessionCount, 2);
+  XCTAssertEqual(manager.persistedCount, 1);
+  XCTAssertEqual(manager.unpersistedCount, 1);
+}
+
+- (void)testNamesThatDontFitAreRejected {
+  EWCSessionManager *manager = [self newManager];
+  XCTAssertEqual([manager attachSlabAtPath:_path capacity:4 atTime:0], 0);
+  EWCServiceProtocol *protocol = [EWCServiceProtocol protocolWithSessionManager:manager];
+
+  // two long names sharing their first 63 bytes must not end up as one
+  NSString *prefix = [@"" stringByPaddingToLength:EWCSessionSlabNameSize - 1 withString:@"x" startingAtIndex:0];
+  XCTAssertEqualObjects([protocol responseToRequest:[@"OPEN " stringByAppendingString:prefix] atTime:0], @"OK");
+  XCTAssertTrue([[protocol responseToRequest:[NSString stringWithFormat:@"OPEN %@a", prefix] atTime:0] hasPrefix:@"ERR"]);
+  XCTAssertTrue([[protocol responseToRequest:[NSString stringWithFormat:@"OPEN %@b", prefix] atTime:0] hasPrefix:@"ERR"]);
+
+  // multibyte characters count by their UTF-8 bytes
+  NSString *wide = [@"" stringByPaddingToLength:EWCSessionSlabNameSize / 2 withString:@"\u00e9" startingAtIndex:0];
+  XCTAssertNil([manager openSessionNamed:wide atTime:0]);
+
+  XCTAssertEqual(manager.sessionCount, 1);
+  XCTAssertEqual(manager.persistedCount, 1);
+  XCTAssertEqual(manager.unpersistedCount, 0);
+}
+
+- (void)testUnreadableNamesAreFreedOnReattach {
+  EWCSessionSlab slab;
+  XCTAssertEqual(EWCSessionSlabOpen(&slab, _path.fileSystemRepresentation, 4,
+    sizeof(EWCCalculatorState), EWCCalculatorStateVersion), 0);
+
+  EWCCalculatorState state;
+  EWCCalculator *calculator = [EWCCalculator new];
+  [calculator getState:&state];
+  EWCSessionSlabAllocate(&slab, "good", &state);
+  EWCSessionSlabAllocate(&slab, "\xff\xfe", &state);
+  EWCSessionSlabClose(&slab);
+
+  EWCSessionManager *manager = [self newManager];
+  XCTAssertEqual([manager attachSlabAtPath:_path capacity:4 atTime:0], 0);
+  XCTAssertEqual(manager.sessionCount, 1);
+  XCTAssertEqual(manager.persistedCount, 1);
+  XCTAssertNotNil([manager sessionNamed:@"good" atTime:0]);
+}
+
+///-------------------------
+/// @name Performance Tests
+///-------------------------
+
+- (void)testPerformanceReattach {
+  EWCSessionManager *manager = [self newManager];
+  XCTAssertEqual([manager attachSlabAtPath:_path capacity:s_benchmarkSessions atTime:0], 0);
+  for (uint32_t i = 0; i < s_benchmarkSessions; ++i) {
+    EWCCalculator *calculator = [manager openSessionNamed:[NSString stringWithFormat:@"s%u", i] atTime:0];
+    [calculator pressKey:EWCCalculatorOneKey];
+  }
+  [manager detachSlab];
+
+  [self measureBlock:^{
+    EWCSessionManager *restarted = [self newManager];
+    [restarted attachSlabAtPath:self->_path capacity:s_benchmarkSessions atTime:0];
+    XCTAssertEqual(restarted.sessionCount, s_benchmarkSessions);
+    [restarted detachSlab];
+  }];
+}
+
+@end
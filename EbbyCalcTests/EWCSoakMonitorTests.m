@@ -0,0 +1,117 @@
+//
+//  EWCSoakMonitorTests.m
+//  EbbyCalcTests
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <XCTest/XCTest.h>
+#import "../EbbyCalcTools/EWCLatencyHistogram.h"
+#import "../EbbyCalcTools/EWCSoakMonitor.h"
+
+@interface EWCSoakMonitorTests : XCTestCase
+
+@end
+
+@implementation EWCSoakMonitorTests
+
+/**
+  Adds samples a million keys apart, growing each quantity at a steady rate.
+ */
+- (void)addSamplesTo:(EWCSoakMonitor *)monitor
+  count:(NSUInteger)count
+  residentGrowth:(uint64_t)resident
+  objectGrowth:(NSUInteger)objects
+  latencyGrowth:(uint64_t)latency {
+  for (NSUInteger i = 0; i < count; ++i) {
+    EWCSoakSample sample = {
+      .keyCount = (i + 1) * 1000000,
+      .elapsed = i,
+      .residentBytes = 10000000 + i * resident,
+      .liveObjects = 2 + i * objects,
+      .p50 = 500,
+      .p99 = 2000 + i * latency,
+      .p999 = 9000,
+    };
+    [monitor addSample:&sample];
+  }
+}
+
+- (void)testSteadyRunPasses {
+  EWCSoakMonitor *monitor = [EWCSoakMonitor monitor];
+  [self addSamplesTo:monitor count:20 residentGrowth:0 objectGrowth:0 latencyGrowth:0];
+
+  XCTAssertEqual(monitor.sampleCount, 20);
+  XCTAssertEqualWithAccuracy(monitor.residentSlope, 0, 1e-6);
+  XCTAssertEqual([monitor failures].count, 0);
+}
+
+- (void)testGrowthIsMeasuredPerMillionKeys {
+  EWCSoakMonitor *monitor = [EWCSoakMonitor monitor];
+  [self addSamplesTo:monitor count:20 residentGrowth:1000000 objectGrowth:3 latencyGrowth:500];
+
+  XCTAssertEqualWithAccuracy(monitor.residentSlope, 1000000, 1e-3);
+  XCTAssertEqualWithAccuracy(monitor.objectSlope, 3, 1e-6);
+  XCTAssertEqualWithAccuracy(monitor.latencySlope, 500, 1e-6);
+  XCTAssertEqual([monitor failures].count, 3);
+}
+
+- (void)testWarmupIsIgnored {
+  EWCSoakMonitor *monitor = [EWCSoakMonitor monitor];
+  monitor.warmupSamples = 2;
+
+  // a large jump while filling caches, then flat
+  for (NSUInteger i = 0; i < 10; ++i) {
+    EWCSoakSample sample = {
+      .keyCount = (i + 1) * 1000000,
+      .residentBytes = (i < 2) ? 1000000 * (i + 1) : 50000000,
+    };
+    [monitor addSample:&sample];
+  }
+
+  XCTAssertEqualWithAccuracy(monitor.residentSlope, 0, 1e-6);
+  XCTAssertEqual([monitor failures].count, 0);
+}
+
+- (void)testTooFewSamplesHaveNoSlope {
+  EWCSoakMonitor *monitor = [EWCSoakMonitor monitor];
+  [self addSamplesTo:monitor count:4 residentGrowth:1000000 objectGrowth:3 latencyGrowth:500];
+
+  XCTAssertEqual(monitor.residentSlope, 0);
+}
+
+- (void)testResidentBytesCanBeRead {
+  XCTAssertGreaterThan(EWCSoakResidentBytes(), 0);
+}
+
+- (void)testHistogramPercentiles {
+  EWCLatencyHistogram histogram;
+  EWCLatencyHistogramClear(&histogram);
+  XCTAssertEqual(EWCLatencyHistogramPercentile(&histogram, 50), 0);
+
+  for (uint64_t i = 1; i <= 1000; ++i) {
+    EWCLatencyHistogramRecord(&histogram, i * 100);
+  }
+
+  // buckets are within an eighth of their values
+  uint64_t p50 = EWCLatencyHistogramPercentile(&histogram, 50);
+  XCTAssertGreaterThanOrEqual(p50, 50000);
+  XCTAssertLessThanOrEqual(p50, 50000 * 9 / 8);
+  XCTAssertEqual(EWCLatencyHistogramPercentile(&histogram, 100), 100000);
+}
+
+@end
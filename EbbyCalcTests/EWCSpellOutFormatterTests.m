@@ -0,0 +1,231 @@
+//
+//  EWCSpellOutFormatterTests.m
+//  EbbyCalcTests
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <XCTest/XCTest.h>
+#import "../EbbyCalc/EWCSpellOutFormatter.h"
+
+static NSArray<NSString *> *s_localeIdentifiers = nil;
+static NSArray<NSString *> *s_values = nil;
+
+static const NSInteger s_maximumDigits = 16;
+static const int s_generatedValues = 2000;
+static const int s_benchmarkIterations = 10000;
+
+@interface EWCSpellOutFormatterTests : XCTestCase
+
+@end
+
+@implementation EWCSpellOutFormatterTests
+
++ (void)setUp {
+  s_localeIdentifiers = @[
+    @"en_US", @"en_GB", @"en_IN", @"en_AU", @"fr_FR", @"de_DE", @"es_ES",
+    @"ja_JP", @"zh_CN", @"ar_EG", @"hi_IN",
+  ];
+
+  s_values = @[
+    @"0", @"1", @"-1", @"0.5", @"-0.5", @"12", @"19", @"20", @"21", @"99",
+    @"100", @"101", @"110", @"999", @"1000", @"1001", @"1100", @"-1234",
+    @"12345", @"100000", @"1000000", @"1000001", @"12345678.9",
+    @"-98765432.1", @"0.001", @"0.000000000000001", @"3.141592653589793",
+    @"9999999999999999", @"-9999999999999999", @"0.1234567890123456789",
+    @"1000000000000000", @"5.05", @"-0.0625", @"123456789012.3456",
+    @"999999999999999999", @"1000000000000000000", @"12345678901234567890123",
+  ];
+}
+
+/**
+  Builds the formatter the calculator accessibility label used before the direct speller, as the reference for the expected output.
+ */
+- (NSNumberFormatter *)referenceFormatterForLocale:(NSLocale *)locale
+  minimumFractionDigits:(NSInteger)minimumFractionDigits {
+  NSNumberFormatter *formatter = [NSNumberFormatter new];
+  formatter.maximumFractionDigits = s_maximumDigits;
+  formatter.locale = locale;
+  [formatter setNumberStyle:NSNumberFormatterSpellOutStyle];
+  formatter.minimumFractionDigits = minimumFractionDigits;
+
+  return formatter;
+}
+
+- (void)assertMatchesReference:(NSDecimalNumber *)value
+  locale:(NSLocale *)locale
+  speller:(EWCSpellOutFormatter *)speller {
+
+  for (NSInteger minimum = 0; minimum <= 3; ++minimum) {
+    NSString *expected = [[self referenceFormatterForLocale:locale
+      minimumFractionDigits:minimum] stringFromNumber:value];
+    NSString *actual = [speller stringFromDecimal:value.decimalValue
+      minimumFractionDigits:minimum];
+
+    XCTAssertEqualObjects(actual, expected, @"%@ in %@ (min %ld)",
+      value, locale.localeIdentifier, (long)minimum);
+  }
+}
+
+- (void)testEnglishIsSpelledNatively {
+  for (NSString *identifier in @[ @"en_US", @"en_GB", @"en_AU" ]) {
+    EWCLocaleDescriptor *descriptor = [EWCLocaleDescriptor
+      descriptorForLocale:[NSLocale localeWithLocaleIdentifier:identifier]];
+    XCTAssertTrue(descriptor.spellOutRules != NULL, @"%@", identifier);
+  }
+
+  // languages without word tables go through the formatter
+  EWCLocaleDescriptor *french = [EWCLocaleDescriptor
+    descriptorForLocale:[NSLocale localeWithLocaleIdentifier:@"fr_FR"]];
+  XCTAssertTrue(french.spellOutRules == NULL);
+}
+
+- (void)testMatchesFormatterAcrossLocales {
+  for (NSString *identifier in s_localeIdentifiers) {
+    NSLocale *locale = [NSLocale localeWithLocaleIdentifier:identifier];
+    EWCSpellOutFormatter *speller = [EWCSpellOutFormatter formatterWithLocale:locale
+      maximumFractionDigits:s_maximumDigits];
+
+    for (NSString *str in s_values) {
+      [self assertMatchesReference:[NSDecimalNumber decimalNumberWithString:str]
+        locale:locale
+        speller:speller];
+    }
+  }
+}
+
+- (void)testMatchesFormatterForGeneratedValues {
+  NSLocale *locale = [NSLocale localeWithLocaleIdentifier:@"en_US"];
+  EWCSpellOutFormatter *speller = [EWCSpellOutFormatter formatterWithLocale:locale
+    maximumFractionDigits:s_maximumDigits];
+
+  // a fixed seed keeps failures reproducible
+  uint64_t state = 0x9e3779b97f4a7c15ull;
+  for (int i = 0; i < s_generatedValues; ++i) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    uint64_t random = state * 0x2545f4914f6cdd1dull;
+
+    // spread the magnitudes so every scale word and fraction length is covered
+    unsigned long long mantissa = random % 10000000000000000ull;
+    mantissa >>= (random >> 58);
+    short exponent = -(short)((random >> 54) % 17);
+    BOOL negative = (random >> 53) & 1;
+
+    NSDecimalNumber *value = [NSDecimalNumber decimalNumberWithMantissa:mantissa
+      exponent:exponent
+      isNegative:negative];
+    [self assertMatchesReference:value locale:locale speller:speller];
+  }
+}
+
+- (void)testRoundsExcessFractionDigits {
+  NSLocale *locale = [NSLocale localeWithLocaleIdentifier:@"en_US"];
+  EWCSpellOutFormatter *speller = [EWCSpellOutFormatter formatterWithLocale:locale
+    maximumFractionDigits:2];
+
+  NSNumberFormatter *reference = [NSNumberFormatter new];
+  reference.maximumFractionDigits = 2;
+  reference.locale = locale;
+  [reference setNumberStyle:NSNumberFormatterSpellOutStyle];
+
+  for (NSString *str in @[ @"1.125", @"1.135", @"999.999", @"0.0004", @"-0.001" ]) {
+    NSDecimalNumber *value = [NSDecimalNumber decimalNumberWithString:str];
+    XCTAssertEqualObjects([speller stringFromDecimal:value.decimalValue minimumFractionDigits:0],
+      [reference stringFromNumber:value], @"%@", str);
+  }
+}
+
+- (void)testNotANumberFallsBack {
+  NSLocale *locale = [NSLocale localeWithLocaleIdentifier:@"en_US"];
+  EWCSpellOutFormatter *speller = [EWCSpellOutFormatter formatterWithLocale:locale
+    maximumFractionDigits:s_maximumDigits];
+
+  NSDecimalNumber *nan = [NSDecimalNumber notANumber];
+  XCTAssertEqualObjects([speller stringFromDecimal:nan.decimalValue minimumFractionDigits:0],
+    [[self referenceFormatterForLocale:locale minimumFractionDigits:0] stringFromNumber:nan] ?: @"");
+}
+
+- (void)testRepeatedValuesAreRemembered {
+  NSLocale *locale = [NSLocale localeWithLocaleIdentifier:@"en_US"];
+  EWCSpellOutFormatter *speller = [EWCSpellOutFormatter formatterWithLocale:locale
+    maximumFractionDigits:s_maximumDigits];
+
+  NSDecimal value = [NSDecimalNumber decimalNumberWithString:@"-1234.5"].decimalValue;
+  NSString *first = [speller stringFromDecimal:value minimumFractionDigits:0];
+  XCTAssertEqual([speller stringFromDecimal:value minimumFractionDigits:0], first);
+
+  // the forced fraction digits are part of what is remembered
+  NSDecimalNumber *number = [NSDecimalNumber decimalNumberWithDecimal:value];
+  XCTAssertEqualObjects([speller stringFromDecimal:value minimumFractionDigits:2],
+    [[self referenceFormatterForLocale:locale minimumFractionDigits:2] stringFromNumber:number]);
+  XCTAssertEqualObjects([speller stringFromDecimal:value minimumFractionDigits:0], first);
+}
+
+- (void)testRenderIntoBufferDoesNotNeedString {
+  EWCLocaleDescriptor *descriptor = [EWCLocaleDescriptor
+    descriptorForLocale:[NSLocale localeWithLocaleIdentifier:@"en_US"]];
+
+  char buffer[EWCSpellOutBufferSize];
+  NSDecimal value = [NSDecimalNumber decimalNumberWithString:@"21.05"].decimalValue;
+  NSUInteger length = EWCSpellOutRenderDecimal(descriptor.spellOutRules, value,
+    s_maximumDigits, 0,
+    buffer, EWCSpellOutBufferSize);
+
+  XCTAssertEqualObjects([[NSString alloc] initWithBytes:buffer length:length encoding:NSUTF8StringEncoding],
+    @"twenty-one point zero five");
+
+  // too small a buffer reports that it couldn't render
+  XCTAssertEqual(EWCSpellOutRenderDecimal(descriptor.spellOutRules, value,
+    s_maximumDigits, 0, buffer, 8), 0);
+}
+
+///-------------------------
+/// @name Performance Tests
+///-------------------------
+
+- (void)testPerformanceFormatterPath {
+  NSLocale *locale = [NSLocale localeWithLocaleIdentifier:@"en_US"];
+  NSDecimalNumber *value = [NSDecimalNumber decimalNumberWithString:@"-12345678.90125"];
+  NSNumberFormatter *formatter = [self referenceFormatterForLocale:locale minimumFractionDigits:0];
+
+  [self measureBlock:^{
+    for (int i = 0; i < s_benchmarkIterations; ++i) {
+      formatter.minimumFractionDigits = i % 3;
+      [formatter stringFromNumber:value];
+    }
+  }];
+}
+
+- (void)testPerformanceSpellerPath {
+  EWCLocaleDescriptor *descriptor = [EWCLocaleDescriptor
+    descriptorForLocale:[NSLocale localeWithLocaleIdentifier:@"en_US"]];
+  NSDecimal value = [NSDecimalNumber decimalNumberWithString:@"-12345678.90125"].decimalValue;
+
+  // render without the speller's cache, to time the spelling itself
+  [self measureBlock:^{
+    char buffer[EWCSpellOutBufferSize];
+    for (int i = 0; i < s_benchmarkIterations; ++i) {
+      EWCSpellOutRenderDecimal(descriptor.spellOutRules, value,
+        s_maximumDigits, i % 3,
+        buffer, EWCSpellOutBufferSize);
+    }
+  }];
+}
+
+@end
@@ -0,0 +1,226 @@
+//
+//  EWCTapeBatchTests.m
+//  EbbyCalcTests
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <XCTest/XCTest.h>
+#import "../EbbyCalc/EWCTapeBatchEvaluator.h"
+#import "../EbbyCalcTools/EWCFuzzGenerator.h"
+
+static const NSUInteger s_generatedLength = 32;
+static const NSUInteger s_benchmarkTapes = 1000;
+
+/**
+  Checks whether two values are the same, treating NaN as matching NaN.
+
+  @param a The first value.
+  @param b The second value.
+
+  @return YES if the values match.
+ */
+static BOOL EWCTapeBatchValuesMatch(NSDecimal a, NSDecimal b) {
+  BOOL aNaN = NSDecimalIsNotANumber(&a);
+  BOOL bNaN = NSDecimalIsNotANumber(&b);
+  if (aNaN || bNaN) {
+    return aNaN && bNaN;
+  }
+
+  return NSDecimalCompare(&a, &b) == NSOrderedSame;
+}
+
+@interface EWCTapeBatchTests : XCTestCase {
+  NSMutableArray<NSData *> *_tapes;  // the keys of each tape of the batch being built
+}
+
+@end
+
+@implementation EWCTapeBatchTests
+
+- (void)setUp {
+  _tapes = [NSMutableArray new];
+}
+
+- (void)addTape:(NSString *)str {
+  NSMutableData *tape = [NSMutableData dataWithLength:str.length * sizeof(EWCCalculatorKey)];
+  EWCCalculatorKey *keys = tape.mutableBytes;
+  for (NSUInteger i = 0; i < str.length; ++i) {
+    keys[i] = EWCCalculatorKeyFromCharacter([str characterAtIndex:i]);
+  }
+
+  [_tapes addObject:tape];
+}
+
+/**
+  Evaluates the tapes added so far as a batch, and checks each result against evaluating the tape on its own.
+
+  @param evaluator The evaluator to use for both.
+ */
+- (void)assertBatchMatchesIndependentWithEvaluator:(EWCTapeBatchEvaluator *)evaluator {
+  NSUInteger count = _tapes.count;
+  const EWCCalculatorKey *keys[count + 1];
+  NSUInteger counts[count + 1];
+  for (NSUInteger t = 0; t < count; ++t) {
+    keys[t] = _tapes[t].bytes;
+    counts[t] = _tapes[t].length / sizeof(EWCCalculatorKey);
+  }
+
+  EWCTapeResult results[count + 1];
+  [evaluator evaluateTapes:keys counts:counts count:count results:results];
+
+  for (NSUInteger t = 0; t < count; ++t) {
+    EWCTapeResult expected;
+    [evaluator evaluateKeys:keys[t] count:counts[t] result:&expected];
+
+    XCTAssertTrue(EWCTapeBatchValuesMatch(results[t].display, expected.display), @"display of tape %lu", (unsigned long)t);
+    XCTAssertTrue(EWCTapeBatchValuesMatch(results[t].memory, expected.memory), @"memory of tape %lu", (unsigned long)t);
+    XCTAssertTrue(EWCTapeBatchValuesMatch(results[t].taxRate, expected.taxRate), @"tax rate of tape %lu", (unsigned long)t);
+    XCTAssertEqual(results[t].hasMemory, expected.hasMemory, @"has memory of tape %lu", (unsigned long)t);
+    XCTAssertEqual(results[t].error, expected.error, @"error of tape %lu", (unsigned long)t);
+  }
+}
+
+- (void)testSharesPrefixesAndDuplicates {
+  [self addTape:@"12+3="];
+  [self addTape:@"12+4="];
+  [self addTape:@"12+3="];
+
+  EWCTapeBatchEvaluator *evaluator = [EWCTapeBatchEvaluator evaluatorWithMaximumDigits:12];
+  [self assertBatchMatchesIndependentWithEvaluator:evaluator];
+
+  XCTAssertEqual(evaluator.tapeCount, 3);
+  XCTAssertEqual(evaluator.uniqueTapeCount, 2);
+  XCTAssertEqual(evaluator.keyCount, 15);
+  XCTAssertEqual(evaluator.pressedKeyCount, 7);
+  XCTAssertEqual(evaluator.branchCount, 1);
+}
+
+- (void)testTapesEndingWithinOthers {
+  // tapes that are prefixes of other tapes, including the empty tape, are
+  // read part way down a path
+  [self addTape:@""];
+  [self addTape:@"8.25qw"];
+  [self addTape:@"8.25qw19.99*2=ws"];
+  [self addTape:@"8.25qw19.99*2=ws5.25ws"];
+  [self addTape:@"8.25qw19.99*2=wsa"];
+  [self addTape:@"8.25qw5.25ws"];
+  [self addTape:@"7qw19.99*2=wsa"];
+
+  EWCTapeBatchEvaluator *evaluator = [EWCTapeBatchEvaluator evaluatorWithMaximumDigits:16];
+  [self assertBatchMatchesIndependentWithEvaluator:evaluator];
+
+  XCTAssertEqual(evaluator.uniqueTapeCount, 7);
+}
+
+- (void)testBranchesAfterErrorAndMemory {
+  // the state restored at a branch must carry the error, memory, and tax
+  // rate of the prefix
+  [self addTape:@"5s1/0="];
+  [self addTape:@"5s1/0=c"];
+  [self addTape:@"5s1/0=c2+2="];
+  [self addTape:@"5s1/2="];
+  [self addTape:@"5s9qw100w"];
+  [self addTape:@"5s9qw100we"];
+
+  EWCTapeBatchEvaluator *evaluator = [EWCTapeBatchEvaluator evaluatorWithMaximumDigits:12];
+  evaluator.startingTaxRate = [NSDecimalNumber decimalNumberWithString:@"7.5"];
+  evaluator.startingMemory = [NSDecimalNumber decimalNumberWithString:@"3"];
+  [self assertBatchMatchesIndependentWithEvaluator:evaluator];
+}
+
+- (void)testMatchesIndependentOnGeneratedTapes {
+  EWCCalculatorKey keys[s_generatedLength];
+  EWCFuzzGenerator generator;
+  EWCFuzzGeneratorInit(&generator, 11, 12);
+
+  // variations of each generated tape, cut short or resubmitted, so that the
+  // batch has both shared prefixes and duplicates
+  for (NSUInteger tape = 0; tape < 100; ++tape) {
+    EWCFuzzGeneratorFill(&generator, keys, s_generatedLength);
+    for (NSUInteger length = s_generatedLength; length > 0; length -= 8) {
+      [_tapes addObject:[NSData dataWithBytes:keys length:length * sizeof(EWCCalculatorKey)]];
+    }
+    [_tapes addObject:[NSData dataWithBytes:keys length:s_generatedLength * sizeof(EWCCalculatorKey)]];
+  }
+
+  EWCTapeBatchEvaluator *evaluator = [EWCTapeBatchEvaluator evaluatorWithMaximumDigits:12];
+  evaluator.startingTaxRate = [NSDecimalNumber decimalNumberWithString:@"8.25"];
+  [self assertBatchMatchesIndependentWithEvaluator:evaluator];
+
+  XCTAssertLessThan(evaluator.uniqueTapeCount, evaluator.tapeCount);
+  XCTAssertLessThan(evaluator.pressedKeyCount, evaluator.keyCount);
+
+  // a second batch on the same evaluator starts afresh
+  [_tapes removeAllObjects];
+  [self addTape:@"2*3="];
+  [self assertBatchMatchesIndependentWithEvaluator:evaluator];
+  XCTAssertEqual(evaluator.pressedKeyCount, 4);
+}
+
+///------------------------
+/// @name Performance Tests
+///------------------------
+
+/**
+  Builds an audit batch for the benchmarks, each tape storing a tax rate, then keying a few of a small set of items.
+ */
+- (void)addBenchmarkTapes {
+  NSArray<NSString *> *items = @[ @"19.99*2=ws", @"5.25ws", @"100*3=ws", @"0.99*12=ws", @"42.50ws", @"7.77*4=ws" ];
+  for (NSUInteger t = 0; t < s_benchmarkTapes; ++t) {
+    NSMutableString *str = [NSMutableString stringWithString:(t % 4) ? @"8.25qw" : @"7qw"];
+    for (NSUInteger i = 0, n = t; i < 1 + t % 5; ++i, n /= 3) {
+      [str appendString:items[n % items.count]];
+    }
+    [str appendString:@"a"];
+    [self addTape:str];
+  }
+}
+
+- (void)testPerformanceIndependent {
+  [self addBenchmarkTapes];
+  EWCTapeBatchEvaluator *evaluator = [EWCTapeBatchEvaluator evaluatorWithMaximumDigits:16];
+
+  [self measureBlock:^{
+    for (NSData *tape in self->_tapes) {
+      EWCTapeResult result;
+      [evaluator evaluateKeys:tape.bytes count:tape.length / sizeof(EWCCalculatorKey) result:&result];
+    }
+  }];
+}
+
+- (void)testPerformanceBatch {
+  [self addBenchmarkTapes];
+  EWCTapeBatchEvaluator *evaluator = [EWCTapeBatchEvaluator evaluatorWithMaximumDigits:16];
+
+  NSUInteger count = _tapes.count;
+  NSMutableData *keyData = [NSMutableData dataWithLength:count * sizeof(EWCCalculatorKey *)];
+  NSMutableData *countData = [NSMutableData dataWithLength:count * sizeof(NSUInteger)];
+  NSMutableData *resultData = [NSMutableData dataWithLength:count * sizeof(EWCTapeResult)];
+  const EWCCalculatorKey **keys = keyData.mutableBytes;
+  NSUInteger *counts = countData.mutableBytes;
+  for (NSUInteger t = 0; t < count; ++t) {
+    keys[t] = _tapes[t].bytes;
+    counts[t] = _tapes[t].length / sizeof(EWCCalculatorKey);
+  }
+
+  [self measureBlock:^{
+    [evaluator evaluateTapes:keys counts:counts count:count results:resultData.mutableBytes];
+  }];
+}
+
+@end
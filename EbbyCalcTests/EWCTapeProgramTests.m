@@ -0,0 +1,264 @@
+//
+//  EWCTapeProgramTests.m
+//  EbbyCalcTests
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <XCTest/XCTest.h>
+#import "../EbbyCalc/EWCCalculator.h"
+#import "../EbbyCalc/EWCCalculatorMemoryData.h"
+#import "../EbbyCalc/EWCTapeCompiler.h"
+#import "../EbbyCalc/EWCTapeProgram.h"
+#import "../EbbyCalcTools/EWCFuzzGenerator.h"
+
+static NSString * const s_auditTape = @"19.99*2=ws5.25*4=ws100*1=wsa";
+static const NSUInteger s_generatedLength = 48;
+static const NSUInteger s_benchmarkVectors = 1000;
+
+/**
+  Checks whether two values are the same, treating NaN as matching NaN.
+
+  @param a The first value.
+  @param b The second value.
+
+  @return YES if the values match.
+ */
+static BOOL EWCTapeValuesMatch(NSDecimal a, NSDecimal b) {
+  BOOL aNaN = NSDecimalIsNotANumber(&a);
+  BOOL bNaN = NSDecimalIsNotANumber(&b);
+  if (aNaN || bNaN) {
+    return aNaN && bNaN;
+  }
+
+  return NSDecimalCompare(&a, &b) == NSOrderedSame;
+}
+
+@interface EWCTapeProgramTests : XCTestCase
+
+@end
+
+@implementation EWCTapeProgramTests
+
+- (EWCTapeProgram *)programForKeys:(NSString *)str maximumDigits:(NSInteger)maximumDigits {
+  EWCCalculatorKey keys[str.length];
+  for (NSUInteger i = 0; i < str.length; ++i) {
+    keys[i] = EWCCalculatorKeyFromCharacter([str characterAtIndex:i]);
+  }
+
+  return [[EWCTapeCompiler compilerWithMaximumDigits:maximumDigits] compileKeys:keys count:str.length];
+}
+
+- (NSDecimal)decimal:(NSString *)str {
+  return [NSDecimalNumber decimalNumberWithString:str].decimalValue;
+}
+
+- (void)assertResult:(const EWCTapeResult *)result
+  matchesResult:(const EWCTapeResult *)expected
+  message:(NSString *)message {
+
+  XCTAssertTrue(EWCTapeValuesMatch(result->display, expected->display), @"display %@", message);
+  XCTAssertTrue(EWCTapeValuesMatch(result->memory, expected->memory), @"memory %@", message);
+  XCTAssertTrue(EWCTapeValuesMatch(result->taxRate, expected->taxRate), @"tax rate %@", message);
+  XCTAssertEqual(result->hasMemory, expected->hasMemory, @"has memory %@", message);
+  XCTAssertEqual(result->error, expected->error, @"error %@", message);
+}
+
+- (void)testTemplateRunMatchesTape {
+  EWCTapeProgram *program = [self programForKeys:s_auditTape maximumDigits:16];
+  program.startingTaxRate = [NSDecimalNumber decimalNumberWithString:@"8"];
+
+  XCTAssertEqual(program.keyCount, s_auditTape.length);
+  XCTAssertEqual(program.slotCount, 6);
+  XCTAssertFalse(program.alwaysReplays);
+
+  NSDecimal inputs[6];
+  [program getTemplateInputs:inputs];
+  XCTAssertTrue(EWCTapeValuesMatch(inputs[0], [self decimal:@"19.99"]));
+  XCTAssertTrue(EWCTapeValuesMatch(inputs[5], [self decimal:@"1"]));
+
+  EWCTapeResult result;
+  [program runWithInputs:inputs result:&result];
+  XCTAssertFalse(result.replayed);
+  XCTAssertFalse(result.error);
+  XCTAssertTrue(result.hasMemory);
+  XCTAssertTrue(EWCTapeValuesMatch(result.display, [self decimal:@"173.8584"]));
+  XCTAssertTrue(EWCTapeValuesMatch(result.memory, [self decimal:@"173.8584"]));
+
+  // the same as pressing the keys
+  EWCCalculator *calculator = [EWCCalculator calculator];
+  calculator.maximumDigits = 16;
+  calculator.dataProvider = [EWCCalculatorMemoryData
+    dataWithTaxRate:[NSDecimalNumber decimalNumberWithString:@"8"]
+    memory:[NSDecimalNumber zero]];
+  for (NSUInteger i = 0; i < s_auditTape.length; ++i) {
+    [calculator pressKey:EWCCalculatorKeyFromCharacter([s_auditTape characterAtIndex:i])];
+  }
+  XCTAssertEqualObjects([NSDecimalNumber decimalNumberWithDecimal:result.display], calculator.displayValue);
+  XCTAssertEqualObjects([NSDecimalNumber decimalNumberWithDecimal:result.memory], calculator.memoryValue);
+}
+
+- (void)testRunsNewInputs {
+  EWCTapeProgram *program = [self programForKeys:s_auditTape maximumDigits:16];
+  program.startingTaxRate = [NSDecimalNumber decimalNumberWithString:@"8"];
+
+  NSDecimal inputs[] = {
+    [self decimal:@"10"], [self decimal:@"3"],
+    [self decimal:@"2.5"], [self decimal:@"2"],
+    [self decimal:@"0.5"], [self decimal:@"4"],
+  };
+
+  EWCTapeResult result;
+  [program runWithInputs:inputs result:&result];
+  XCTAssertFalse(result.replayed);
+  XCTAssertTrue(EWCTapeValuesMatch(result.memory, [self decimal:@"39.96"]));
+
+  EWCTapeResult replayed;
+  [program replayKeysWithInputs:inputs result:&replayed];
+  XCTAssertTrue(replayed.replayed);
+  [self assertResult:&result matchesResult:&replayed message:@"new inputs"];
+}
+
+- (void)testErrorFallsBackToKeys {
+  EWCTapeProgram *program = [self programForKeys:@"8/2=" maximumDigits:16];
+
+  NSDecimal inputs[] = { [self decimal:@"8"], [self decimal:@"4"] };
+  EWCTapeResult result;
+  [program runWithInputs:inputs result:&result];
+  XCTAssertFalse(result.replayed);
+  XCTAssertTrue(EWCTapeValuesMatch(result.display, [self decimal:@"2"]));
+
+  inputs[1] = [self decimal:@"0"];
+  [program runWithInputs:inputs result:&result];
+  XCTAssertTrue(result.replayed);
+  XCTAssertTrue(result.error);
+}
+
+- (void)testWideInputIsTypedAsCalculatorWould {
+  EWCTapeProgram *program = [self programForKeys:@"1+2=" maximumDigits:8];
+
+  NSDecimal inputs[] = { [self decimal:@"123456789"], [self decimal:@"-1"] };
+  EWCTapeResult result;
+  [program runWithInputs:inputs result:&result];
+  XCTAssertTrue(result.replayed);
+  XCTAssertTrue(EWCTapeValuesMatch(result.display, [self decimal:@"12345677"]));
+}
+
+- (void)testResolvesGrammarOnce {
+  // unary square, repeated equals, percent, and sign change of a result
+  EWCTapeProgram *program = [self programForKeys:@"3*==\\+10%=" maximumDigits:12];
+  XCTAssertEqual(program.slotCount, 2);
+
+  NSDecimal inputs[] = { [self decimal:@"5"], [self decimal:@"20"] };
+  EWCTapeResult result, replayed;
+  [program runWithInputs:inputs result:&result];
+  [program replayKeysWithInputs:inputs result:&replayed];
+  XCTAssertFalse(result.replayed);
+  [self assertResult:&result matchesResult:&replayed message:@"grammar"];
+}
+
+- (void)testMatchesKeyReplayOnGeneratedTapes {
+  EWCCalculatorKey keys[s_generatedLength];
+  EWCFuzzGenerator generator;
+  EWCFuzzGeneratorInit(&generator, 7, 12);
+
+  NSDecimal one = [NSDecimalNumber one].decimalValue;
+
+  for (NSUInteger tape = 0; tape < 200; ++tape) {
+    EWCFuzzGeneratorFill(&generator, keys, s_generatedLength);
+    EWCTapeProgram *program = [[EWCTapeCompiler compilerWithMaximumDigits:12]
+      compileKeys:keys
+      count:s_generatedLength];
+    program.startingTaxRate = [NSDecimalNumber decimalNumberWithString:@"7.5"];
+    program.startingMemory = [NSDecimalNumber decimalNumberWithString:@"3"];
+
+    NSDecimal inputs[program.slotCount + 1];
+    [program getTemplateInputs:inputs];
+
+    for (NSUInteger variation = 0; variation < 3; ++variation) {
+      EWCTapeResult result, replayed;
+      [program runWithInputs:inputs result:&result];
+      [program replayKeysWithInputs:inputs result:&replayed];
+      [self assertResult:&result
+        matchesResult:&replayed
+        message:[NSString stringWithFormat:@"tape %lu variation %lu", (unsigned long)tape, (unsigned long)variation]];
+
+      // move every input along for the next variation
+      for (NSUInteger i = 0; i < program.slotCount; ++i) {
+        NSDecimal value = inputs[i];
+        NSDecimalAdd(&inputs[i], &value, &one, NSRoundPlain);
+      }
+    }
+  }
+}
+
+///------------------------
+/// @name Performance Tests
+///------------------------
+
+/**
+  Builds the inputs for the benchmark, a different set of prices and quantities for each run of the audit tape.
+
+  @param program The compiled audit tape.
+
+  @return The inputs, `s_benchmarkVectors` sets of them.
+ */
+- (NSMutableData *)benchmarkInputsForProgram:(EWCTapeProgram *)program {
+  NSMutableData *data = [NSMutableData dataWithLength:s_benchmarkVectors * program.slotCount * sizeof(NSDecimal)];
+  NSDecimal *inputs = data.mutableBytes;
+
+  for (NSUInteger i = 0; i < s_benchmarkVectors * program.slotCount; ++i) {
+    BOOL quantity = (i % 2 == 1);
+    inputs[i] = quantity
+      ? [NSDecimalNumber decimalNumberWithMantissa:1 + i % 9 exponent:0 isNegative:NO].decimalValue
+      : [NSDecimalNumber decimalNumberWithMantissa:100 + (i * 7919) % 99900 exponent:-2 isNegative:NO].decimalValue;
+  }
+
+  return data;
+}
+
+- (void)testPerformanceKeyReplay {
+  EWCTapeProgram *program = [self programForKeys:s_auditTape maximumDigits:16];
+  program.startingTaxRate = [NSDecimalNumber decimalNumberWithString:@"8"];
+  NSMutableData *data = [self benchmarkInputsForProgram:program];
+  const NSDecimal *inputs = data.bytes;
+
+  [self measureBlock:^{
+    EWCTapeResult result;
+    for (NSUInteger i = 0; i < s_benchmarkVectors; ++i) {
+      @autoreleasepool {
+        [program replayKeysWithInputs:inputs + i * program.slotCount result:&result];
+      }
+    }
+  }];
+}
+
+- (void)testPerformanceCompiledProgram {
+  EWCTapeProgram *program = [self programForKeys:s_auditTape maximumDigits:16];
+  program.startingTaxRate = [NSDecimalNumber decimalNumberWithString:@"8"];
+  NSMutableData *data = [self benchmarkInputsForProgram:program];
+  const NSDecimal *inputs = data.bytes;
+  EWCTapeResult *results = malloc(s_benchmarkVectors * sizeof(EWCTapeResult));
+
+  [self measureBlock:^{
+    [program runWithInputVectors:inputs count:s_benchmarkVectors results:results];
+  }];
+
+  free(results);
+}
+
+@end
@@ -0,0 +1,186 @@
+//
+//  EWCTraceBufferTests.m
+//  EbbyCalcTests
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <XCTest/XCTest.h>
+#import "../EbbyCalc/EWCCalculator.h"
+#import "../EbbyCalc/EWCTraceBuffer.h"
+
+@interface EWCTraceBufferTests : XCTestCase {
+  EWCTraceBuffer _trace;
+}
+
+@end
+
+@implementation EWCTraceBufferTests
+
+- (void)setUp {
+  XCTAssertTrue(EWCTraceBufferInit(&_trace, 4));
+}
+
+- (void)tearDown {
+  EWCTraceBufferFree(&_trace);
+}
+
+- (void)pressKeys:(NSString *)keys on:(EWCCalculator *)calculator {
+  for (NSUInteger i = 0; i < keys.length; ++i) {
+    [calculator pressKey:EWCCalculatorKeyFromCharacter([keys characterAtIndex:i])];
+  }
+}
+
+/**
+  Collects the stages recorded for an input.
+ */
+- (NSSet<NSString *> *)stagesOfRecord:(const EWCTraceKeyRecord *)record {
+  NSMutableSet<NSString *> *stages = [NSMutableSet new];
+  for (uint16_t i = 0; i < record->spanCount; ++i) {
+    [stages addObject:@(EWCTraceStageName(record->spans[i].stage))];
+  }
+
+  return stages;
+}
+
+- (void)testKeepsLastKeys {
+  for (int32_t key = 0; key < 10; ++key) {
+    EWCTraceBufferBeginKey(&_trace, key, '0' + key);
+    EWCTraceBufferEndKey(&_trace);
+  }
+
+  XCTAssertEqual(EWCTraceBufferKeyCount(&_trace), 4);
+  XCTAssertEqual(EWCTraceBufferKeyAtIndex(&_trace, 0)->key, 6);
+  XCTAssertEqual(EWCTraceBufferKeyAtIndex(&_trace, 3)->key, 9);
+  XCTAssertEqual(EWCTraceBufferKeyAtIndex(&_trace, 3)->sequence, 9);
+  XCTAssertTrue(EWCTraceBufferKeyAtIndex(&_trace, 4) == NULL);
+}
+
+- (void)testSpansOutsideKeysGoToLatest {
+  // nothing to attach to yet
+  EWCTraceBufferAddSpan(&_trace, EWCTraceFormatStage, 1, 2);
+  XCTAssertEqual(EWCTraceBufferKeyCount(&_trace), 0);
+
+  EWCTraceBufferBeginKey(&_trace, 1, '1');
+  EWCTraceBufferEndKey(&_trace);
+  uint64_t start = EWCTraceBufferNow();
+  EWCTraceBufferAddSpan(&_trace, EWCTraceFormatStage, start, start + 10);
+
+  const EWCTraceKeyRecord *record = EWCTraceBufferKeyAtIndex(&_trace, 0);
+  XCTAssertEqual(record->spanCount, 1);
+  XCTAssertEqual(record->spans[0].duration, 10);
+}
+
+- (void)testCountsSpansWithoutRoom {
+  EWCTraceBufferBeginKey(&_trace, 1, '1');
+  for (int i = 0; i < EWCTraceMaxSpansPerKey + 5; ++i) {
+    EWCTraceBufferAddSpan(&_trace, EWCTraceParseStage, 0, 0);
+  }
+  EWCTraceBufferEndKey(&_trace);
+
+  const EWCTraceKeyRecord *record = EWCTraceBufferKeyAtIndex(&_trace, 0);
+  XCTAssertEqual(record->spanCount, EWCTraceMaxSpansPerKey);
+  XCTAssertEqual(record->droppedSpanCount, 5);
+}
+
+- (void)testSlowKeyFreezes {
+  EWCTraceBufferSetFreezeThreshold(&_trace, 1);
+
+  EWCTraceBufferBeginKey(&_trace, 1, '1');
+  EWCTraceBufferEndKey(&_trace);
+  XCTAssertTrue(_trace.frozen);
+
+  // later keys don't push the slow one out
+  EWCTraceBufferBeginKey(&_trace, 2, '2');
+  EWCTraceBufferEndKey(&_trace);
+  XCTAssertEqual(EWCTraceBufferKeyCount(&_trace), 1);
+  XCTAssertEqual(EWCTraceBufferKeyAtIndex(&_trace, 0)->key, 1);
+
+  EWCTraceBufferClear(&_trace);
+  XCTAssertFalse(_trace.frozen);
+  XCTAssertEqual(EWCTraceBufferKeyCount(&_trace), 0);
+}
+
+- (void)testCalculatorTracesStages {
+  EWCTraceBufferFree(&_trace);
+  XCTAssertTrue(EWCTraceBufferInit(&_trace, 8));
+
+  EWCCalculator *calculator = [EWCCalculator calculator];
+  calculator.maximumDigits = 12;
+  calculator.traceBuffer = &_trace;
+  __weak EWCCalculator *weakCalculator = calculator;
+  [calculator registerUpdateCallbackWithBlock:^{
+    (void)weakCalculator.displayContent;
+  }];
+
+  [self pressKeys:@"12+3=" on:calculator];
+  calculator.traceBuffer = NULL;
+
+  XCTAssertEqual(EWCTraceBufferKeyCount(&_trace), 5);
+
+  const EWCTraceKeyRecord *digit = EWCTraceBufferKeyAtIndex(&_trace, 0);
+  XCTAssertEqual(digit->label, '1');
+  XCTAssertTrue([[self stagesOfRecord:digit] isSupersetOfSet:
+    [NSSet setWithArray:@[ @"input", @"callback", @"format" ]]]);
+
+  const EWCTraceKeyRecord *equal = EWCTraceBufferKeyAtIndex(&_trace, 4);
+  XCTAssertEqual(equal->key, EWCCalculatorEqualKey);
+  XCTAssertTrue(equal->duration > 0);
+  XCTAssertTrue([[self stagesOfRecord:equal] isSupersetOfSet:
+    [NSSet setWithArray:@[ @"enqueue", @"parseQueue", @"arithmetic", @"setDisplay" ]]]);
+
+  // stages nest inside their input
+  for (uint16_t i = 0; i < equal->spanCount; ++i) {
+    XCTAssertTrue(equal->spans[i].start >= equal->start);
+    XCTAssertTrue(equal->spans[i].start + equal->spans[i].duration <= equal->start + equal->duration);
+  }
+}
+
+- (void)testWritesTraceEvents {
+  EWCCalculator *calculator = [EWCCalculator calculator];
+  calculator.maximumDigits = 12;
+  calculator.traceBuffer = &_trace;
+  [self pressKeys:@"7*\\=" on:calculator];
+  calculator.traceBuffer = NULL;
+
+  char *bytes = NULL;
+  size_t length = 0;
+  FILE *file = open_memstream(&bytes, &length);
+  XCTAssertTrue(EWCTraceBufferWriteJSON(&_trace, file));
+  fclose(file);
+
+  NSData *data = [NSData dataWithBytes:bytes length:length];
+  free(bytes);
+
+  NSDictionary *trace = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+  NSArray<NSDictionary *> *events = trace[@"traceEvents"];
+  XCTAssertNotNil(events);
+
+  NSArray<NSString *> *names = [events valueForKey:@"name"];
+  XCTAssertTrue([names containsObject:@"key 7"]);
+  XCTAssertTrue([names containsObject:@"key \\"]);
+  XCTAssertTrue([names containsObject:@"parseQueue"]);
+
+  for (NSDictionary *event in events) {
+    if ([event[@"ph"] isEqualToString:@"X"]) {
+      XCTAssertTrue([event[@"ts"] doubleValue] >= 0);
+      XCTAssertNotNil(event[@"dur"]);
+    }
+  }
+}
+
+@end
@@ -0,0 +1,231 @@
+//
+//  EWCBigDecimalBenchMain.c
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "EWCBigDecimal.h"
+
+// the digit counts measured when none is given
+static const int s_defaultDigits[] = { 40, 100, 1000 };
+
+#define EWCBigDecimalBenchDefaultCount (int)(sizeof(s_defaultDigits) / sizeof(s_defaultDigits[0]))
+
+/**
+  Gets the current time from a monotonic clock.
+
+  @return The time in seconds.
+ */
+static double EWCBigDecimalBenchNow(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+  Generates a pseudo-random number (xorshift64*).
+
+  @param state The generator state, which must not be zero.
+
+  @return The next number.
+ */
+static uint64_t EWCBigDecimalBenchRandom(uint64_t *state) {
+  uint64_t x = *state;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  *state = x;
+
+  return x * 2685821657736338717ULL;
+}
+
+/**
+  Sets a value to random digits, with about half of them after the decimal.
+
+  @param value Receives the value.
+  @param count The number of digits.
+  @param state The generator state.
+ */
+static void EWCBigDecimalBenchRandomValue(EWCBigDecimal *value, int count, uint64_t *state) {
+  uint8_t *digits = malloc((size_t)count);
+  for (int i = 0; i < count; ++i) {
+    digits[i] = (uint8_t)(EWCBigDecimalBenchRandom(state) % 10);
+  }
+  digits[0] = (uint8_t)(1 + digits[0] % 9);
+
+  EWCBigDecimalSetDigits(value, digits, count, -count / 2, EWCBigDecimalBenchRandom(state) & 1);
+  free(digits);
+}
+
+/**
+  Prints the command line usage.
+
+  @param name The name the tool was run as.
+ */
+static void EWCBigDecimalBenchUsage(const char *name) {
+  fprintf(stderr,
+    "usage: %s [-d digits] [-n operations] [-s seed]\n"
+    "  -d  digits per operand (default 40, 100, and 1000 in turn)\n"
+    "  -n  operations of each kind per digit count (default 2000)\n"
+    "  -s  random seed (default from the clock)\n",
+    name);
+}
+
+/**
+  Measures each operation at one digit count, checking the results as it goes.
+
+  @param digits The digits per operand.
+  @param count The operations of each kind.
+  @param state The generator state.
+
+  @return The number of results that failed their check.
+ */
+static long EWCBigDecimalBenchRun(int digits, long count, uint64_t *state) {
+  EWCBigDecimal *a = malloc(sizeof(EWCBigDecimal) * (size_t)count);
+  EWCBigDecimal *b = malloc(sizeof(EWCBigDecimal) * (size_t)count);
+  EWCBigDecimal result, check, absolute;
+  EWCBigDecimalInit(&result);
+  EWCBigDecimalInit(&check);
+  EWCBigDecimalInit(&absolute);
+  for (long i = 0; i < count; ++i) {
+    EWCBigDecimalInit(&a[i]);
+    EWCBigDecimalInit(&b[i]);
+    EWCBigDecimalBenchRandomValue(&a[i], digits, state);
+    EWCBigDecimalBenchRandomValue(&b[i], digits, state);
+  }
+
+  long failures = 0;
+  long checksum = 0;
+
+  double start = EWCBigDecimalBenchNow();
+  for (long i = 0; i < count; ++i) {
+    EWCBigDecimalAdd(&result, &a[i], &b[i]);
+    checksum += result.length;
+  }
+  double addTime = EWCBigDecimalBenchNow() - start;
+
+  start = EWCBigDecimalBenchNow();
+  for (long i = 0; i < count; ++i) {
+    EWCBigDecimalMultiplySchoolbook(&result, &a[i], &b[i]);
+    checksum += result.length;
+  }
+  double schoolbookTime = EWCBigDecimalBenchNow() - start;
+
+  start = EWCBigDecimalBenchNow();
+  for (long i = 0; i < count; ++i) {
+    EWCBigDecimalMultiply(&result, &a[i], &b[i]);
+    checksum += result.length;
+  }
+  double karatsubaTime = EWCBigDecimalBenchNow() - start;
+
+  start = EWCBigDecimalBenchNow();
+  for (long i = 0; i < count; ++i) {
+    EWCBigDecimalDivide(&result, &a[i], &b[i], digits);
+    checksum += result.length;
+  }
+  double divideTime = EWCBigDecimalBenchNow() - start;
+
+  start = EWCBigDecimalBenchNow();
+  for (long i = 0; i < count; ++i) {
+    EWCBigDecimalNegate(&absolute, &a[i]);
+    EWCBigDecimalSqrt(&result, a[i].negative ? &absolute : &a[i], digits);
+    checksum += result.length;
+  }
+  double sqrtTime = EWCBigDecimalBenchNow() - start;
+
+  // check outside of the timing: the two multiplications agree, and dividing
+  // a product by one factor gives back the other
+  for (long i = 0; i < count; ++i) {
+    EWCBigDecimalMultiplySchoolbook(&check, &a[i], &b[i]);
+    EWCBigDecimalMultiply(&result, &a[i], &b[i]);
+    if (EWCBigDecimalCompare(&check, &result) != 0) {
+      ++failures;
+      continue;
+    }
+
+    EWCBigDecimalDivide(&result, &check, &b[i], digits);
+    if (EWCBigDecimalCompare(&result, &a[i]) != 0) {
+      ++failures;
+    }
+  }
+
+  printf("digits %d (%d limbs), %ld operations each\n",
+    digits, (digits + EWCBigDecimalLimbDigits - 1) / EWCBigDecimalLimbDigits, count);
+  printf("  add:        %10.1f ns\n", addTime / count * 1e9);
+  printf("  schoolbook: %10.1f ns\n", schoolbookTime / count * 1e9);
+  printf("  karatsuba:  %10.1f ns  (%.2fx)\n", karatsubaTime / count * 1e9, schoolbookTime / karatsubaTime);
+  printf("  divide:     %10.1f ns\n", divideTime / count * 1e9);
+  printf("  sqrt:       %10.1f ns\n", sqrtTime / count * 1e9);
+  printf("  failures:   %ld  (checksum %ld)\n", failures, checksum);
+
+  for (long i = 0; i < count; ++i) {
+    EWCBigDecimalFree(&a[i]);
+    EWCBigDecimalFree(&b[i]);
+  }
+  free(a);
+  free(b);
+  EWCBigDecimalFree(&result);
+  EWCBigDecimalFree(&check);
+  EWCBigDecimalFree(&absolute);
+
+  return failures;
+}
+
+int main(int argc, char * argv[]) {
+  int digits = 0;
+  long count = 2000;
+  uint64_t seed = (uint64_t)time(NULL);
+
+  int option;
+  while ((option = getopt(argc, argv, "d:n:s:h")) != -1) {
+    switch (option) {
+      case 'd': digits = atoi(optarg); break;
+      case 'n': count = atol(optarg); break;
+      case 's': seed = strtoull(optarg, NULL, 10); break;
+      default:
+        EWCBigDecimalBenchUsage(argv[0]);
+        return (option == 'h') ? 0 : 2;
+    }
+  }
+
+  if (digits < 0 || count < 1) {
+    EWCBigDecimalBenchUsage(argv[0]);
+    return 2;
+  }
+
+  printf("seed: %llu\n", (unsigned long long)seed);
+  uint64_t state = seed ? seed : 1;
+
+  long failures = 0;
+  if (digits > 0) {
+    failures += EWCBigDecimalBenchRun(digits, count, &state);
+  } else {
+    for (int i = 0; i < EWCBigDecimalBenchDefaultCount; ++i) {
+      failures += EWCBigDecimalBenchRun(s_defaultDigits[i], count, &state);
+    }
+  }
+
+  return (failures > 0) ? 1 : 0;
+}
@@ -0,0 +1,55 @@
+//
+//  EWCFuzzGenerator.h
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import "EWCCalculatorKey.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCFuzzGenerator` produces random key sequences that follow the way the calculator is actually used, so that most of the keys exercise calculations rather than being ignored.
+
+  Sequences are built from phrases: entering a number (sometimes past the digit limit, sometimes with backspaces or sign changes), chaining binary operations, repeating equals, percent, square root, tax rate storage and recall, tax calculations, memory operations, dividing by zero, and clearing.  The same seed always produces the same keys.
+ */
+typedef struct {
+  uint64_t random;  // the xorshift state, never zero
+  NSInteger maximumDigits;  // the digit limit of the calculators being exercised
+} EWCFuzzGenerator;
+
+/**
+  Prepares a generator.
+
+  @param generator The generator to prepare.
+  @param seed The random seed.
+  @param maximumDigits The digit limit of the calculators being exercised, so numbers can be made to go just past it.
+ */
+void EWCFuzzGeneratorInit(EWCFuzzGenerator *generator, uint64_t seed, NSInteger maximumDigits);
+
+/**
+  Fills a buffer with a random key sequence.
+
+  @param generator The generator to draw from.
+  @param keys Receives the keys.
+  @param count The number of keys to generate.
+ */
+void EWCFuzzGeneratorFill(EWCFuzzGenerator *generator, EWCCalculatorKey *keys, NSUInteger count);
+
+NS_ASSUME_NONNULL_END
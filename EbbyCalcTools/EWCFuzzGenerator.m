@@ -0,0 +1,227 @@
+//
+//  EWCFuzzGenerator.m
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCFuzzGenerator.h"
+
+// the longest phrase that can be generated
+#define EWCFuzzMaxPhraseLength 128
+
+// the largest digit limit that numbers are generated for, so that a number
+// (with a backspace after every digit) and its operators fit in a phrase
+#define EWCFuzzMaxDigits 56
+
+/**
+  Advances the generator.
+
+  @param generator The generator to advance.
+
+  @return The next random value.
+ */
+static inline uint64_t EWCFuzzNext(EWCFuzzGenerator *generator) {
+  uint64_t x = generator->random;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  generator->random = x;
+
+  return x;
+}
+
+/**
+  Picks a random value below a limit.
+
+  @param generator The generator to draw from.
+  @param limit The exclusive upper bound.
+
+  @return The value.
+ */
+static inline NSUInteger EWCFuzzBelow(EWCFuzzGenerator *generator, NSUInteger limit) {
+  return (NSUInteger)((EWCFuzzNext(generator) >> 11) % limit);
+}
+
+/**
+  Appends the keys for entering a number.  Usually the number fits, but it is sometimes longer than the digit limit, and sometimes includes a decimal point, a sign change, or a correction with backspace.
+
+  @param generator The generator to draw from.
+  @param keys The phrase being built.
+  @param length The length of the phrase so far.
+
+  @return The new length of the phrase.
+ */
+static NSUInteger EWCFuzzAppendNumber(EWCFuzzGenerator *generator, EWCCalculatorKey *keys, NSUInteger length) {
+  NSUInteger roll = EWCFuzzBelow(generator, 16);
+  NSUInteger digits;
+  if (roll < 10) {
+    digits = 1 + EWCFuzzBelow(generator, 4);
+  } else if (roll < 14) {
+    digits = 1 + EWCFuzzBelow(generator, (NSUInteger)generator->maximumDigits);
+  } else {
+    // up to and past the limit
+    digits = (NSUInteger)generator->maximumDigits - 1 + EWCFuzzBelow(generator, 4);
+  }
+
+  NSUInteger point = EWCFuzzBelow(generator, 3) ? NSNotFound : EWCFuzzBelow(generator, digits + 1);
+  for (NSUInteger i = 0; i < digits; ++i) {
+    if (i == point) {
+      keys[length++] = EWCCalculatorDecimalKey;
+    }
+
+    // favor small digits and zeros, which find more edge cases than the rest
+    NSUInteger digit = EWCFuzzBelow(generator, 4) ? EWCFuzzBelow(generator, 10) : EWCFuzzBelow(generator, 2);
+    keys[length++] = (EWCCalculatorKey)(EWCCalculatorZeroKey + digit);
+
+    if (EWCFuzzBelow(generator, 24) == 0) {
+      keys[length++] = EWCCalculatorBackspaceKey;
+    }
+  }
+
+  if (point == digits) {
+    keys[length++] = EWCCalculatorDecimalKey;
+  }
+
+  if (EWCFuzzBelow(generator, 10) == 0) {
+    keys[length++] = EWCCalculatorSignKey;
+  }
+
+  return length;
+}
+
+/**
+  Appends one phrase of keys.
+
+  @param generator The generator to draw from.
+  @param keys Receives the phrase.  It must hold `EWCFuzzMaxPhraseLength` keys.
+
+  @return The length of the phrase.
+ */
+static NSUInteger EWCFuzzAppendPhrase(EWCFuzzGenerator *generator, EWCCalculatorKey *keys) {
+  static const EWCCalculatorKey s_binaryOps[] = {
+    EWCCalculatorAddKey, EWCCalculatorSubtractKey, EWCCalculatorMultiplyKey, EWCCalculatorDivideKey,
+  };
+  static const EWCCalculatorKey s_memoryKeys[] = {
+    EWCCalculatorMemoryKey, EWCCalculatorMemoryPlusKey, EWCCalculatorMemoryMinusKey,
+  };
+
+  NSUInteger length = 0;
+  switch (EWCFuzzBelow(generator, 20)) {
+    case 0: case 1: case 2: case 3: case 4: case 5:
+      // a binary operation, sometimes with the operator changed before the
+      // second operand
+      keys[length++] = s_binaryOps[EWCFuzzBelow(generator, 4)];
+      if (EWCFuzzBelow(generator, 8) == 0) {
+        keys[length++] = s_binaryOps[EWCFuzzBelow(generator, 4)];
+      }
+      length = EWCFuzzAppendNumber(generator, keys, length);
+      break;
+
+    case 6: case 7:
+      // equals, sometimes repeated to apply the constant operation again
+      keys[length++] = EWCCalculatorEqualKey;
+      while (length < 8 && EWCFuzzBelow(generator, 3) == 0) {
+        keys[length++] = EWCCalculatorEqualKey;
+      }
+      break;
+
+    case 8: case 9: case 10:
+      length = EWCFuzzAppendNumber(generator, keys, length);
+      break;
+
+    case 11:
+      // percent of the pending operation
+      keys[length++] = s_binaryOps[EWCFuzzBelow(generator, 4)];
+      length = EWCFuzzAppendNumber(generator, keys, length);
+      keys[length++] = EWCCalculatorPercentKey;
+      break;
+
+    case 12:
+      keys[length++] = EWCFuzzBelow(generator, 2) ? EWCCalculatorSqrtKey : EWCCalculatorSignKey;
+      break;
+
+    case 13:
+      // store a tax rate
+      keys[length++] = EWCCalculatorRateKey;
+      length = EWCFuzzAppendNumber(generator, keys, length);
+      keys[length++] = EWCCalculatorTaxPlusKey;
+      break;
+
+    case 14:
+      // recall the tax rate, or shift and change our minds
+      keys[length++] = EWCCalculatorRateKey;
+      keys[length++] = EWCFuzzBelow(generator, 2) ? EWCCalculatorTaxMinusKey : EWCCalculatorRateKey;
+      break;
+
+    case 15:
+      // a tax calculation, sometimes repeated to toggle the tax amount
+      keys[length++] = EWCFuzzBelow(generator, 2) ? EWCCalculatorTaxPlusKey : EWCCalculatorTaxMinusKey;
+      if (EWCFuzzBelow(generator, 3) == 0) {
+        keys[length] = keys[length - 1];
+        ++length;
+      }
+      break;
+
+    case 16: case 17:
+      keys[length++] = s_memoryKeys[EWCFuzzBelow(generator, 3)];
+      if (keys[length - 1] == EWCCalculatorMemoryKey && EWCFuzzBelow(generator, 2)) {
+        // a second mrc clears the memory
+        keys[length++] = EWCCalculatorMemoryKey;
+      }
+      break;
+
+    case 18:
+      // a division by zero, to reach the error state
+      keys[length++] = EWCCalculatorDivideKey;
+      keys[length++] = EWCCalculatorZeroKey;
+      keys[length++] = EWCCalculatorEqualKey;
+      break;
+
+    default:
+      keys[length++] = EWCCalculatorClearKey;
+      if (EWCFuzzBelow(generator, 2)) {
+        keys[length++] = EWCCalculatorClearKey;
+      }
+      break;
+  }
+
+  return length;
+}
+
+void EWCFuzzGeneratorInit(EWCFuzzGenerator *generator, uint64_t seed, NSInteger maximumDigits) {
+  // mix the seed so that nearby seeds don't start out correlated
+  uint64_t z = seed + 0x9e3779b97f4a7c15ull;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  z ^= z >> 31;
+
+  generator->random = z ? z : 1;
+  generator->maximumDigits = MIN(MAX(maximumDigits, 1), EWCFuzzMaxDigits);
+}
+
+void EWCFuzzGeneratorFill(EWCFuzzGenerator *generator, EWCCalculatorKey *keys, NSUInteger count) {
+  EWCCalculatorKey phrase[EWCFuzzMaxPhraseLength];
+
+  NSUInteger filled = 0;
+  while (filled < count) {
+    NSUInteger length = EWCFuzzAppendPhrase(generator, phrase);
+    NSUInteger copied = MIN(length, count - filled);
+    memcpy(keys + filled, phrase, copied * sizeof(EWCCalculatorKey));
+    filled += copied;
+  }
+}
@@ -0,0 +1,113 @@
+//
+//  EWCFuzzHarness.h
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import "EWCCalculatorKey.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCFuzzHarness` runs key sequences through both the optimized `EWCCalculator` and the original `EWCReferenceCalculator`, and reports where their results diverge.
+
+  After every key, the display value, the error and memory state, and each status indicator are compared.  The formatted display content is compared at the end of each sequence (or after every key if `comparesDisplayContentEveryKey` is set), since formatting it in the reference is slow.
+
+  A harness is not thread safe.  Use one per thread.
+ */
+@interface EWCFuzzHarness : NSObject
+
+/**
+  The locale both calculators use.
+ */
+@property (nonatomic, readonly) NSLocale *locale;
+
+/**
+  The digit limit of both calculators.
+ */
+@property (nonatomic, readonly) NSInteger maximumDigits;
+
+/**
+  Whether to compare the formatted display content after every key, rather than only at the end of a sequence.  Defaults to NO.
+ */
+@property (nonatomic) BOOL comparesDisplayContentEveryKey;
+
+/**
+  Creates a new harness.
+
+  @param locale The locale both calculators use.
+  @param maximumDigits The digit limit of both calculators.
+
+  @return The new harness.
+ */
++ (instancetype)harnessWithLocale:(NSLocale *)locale maximumDigits:(NSInteger)maximumDigits;
+
+/**
+  Initializes a harness.
+
+  @param locale The locale both calculators use.
+  @param maximumDigits The digit limit of both calculators.
+
+  @return The initialized instance.
+ */
+- (instancetype)initWithLocale:(NSLocale *)locale maximumDigits:(NSInteger)maximumDigits;
+
+/**
+  Runs a key sequence through new instances of both calculators.
+
+  @param keys The keys to press.
+  @param count The number of keys.
+
+  @return The index of the key after which the calculators first disagreed, or `NSNotFound` if they agreed throughout.
+ */
+- (NSUInteger)firstDivergenceInKeys:(const EWCCalculatorKey *)keys count:(NSUInteger)count;
+
+/**
+  Shrinks a diverging key sequence to a shorter one that still diverges, by removing ever smaller runs of keys while the divergence remains.
+
+  @param keys The diverging keys.  They are replaced by the shortened sequence.
+  @param count The number of keys.
+
+  @return The number of keys in the shortened sequence, or 0 if the sequence doesn't diverge.
+ */
+- (NSUInteger)minimizeKeys:(EWCCalculatorKey *)keys count:(NSUInteger)count;
+
+/**
+  Describes how the calculators disagree after a key sequence.
+
+  @param keys The keys to press.
+  @param count The number of keys.
+
+  @return A description of the keys and the results of both calculators after the first divergence, or nil if they agree.
+ */
+- (nullable NSString *)describeDivergenceInKeys:(const EWCCalculatorKey *)keys count:(NSUInteger)count;
+
+/**
+  Renders keys using their hardware keyboard characters, so that a sequence can be pasted into a test.
+
+  @param keys The keys.
+  @param count The number of keys.
+
+  @return The key characters.
+ */
++ (NSString *)stringFromKeys:(const EWCCalculatorKey *)keys count:(NSUInteger)count;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,245 @@
+//
+//  EWCFuzzHarness.m
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCFuzzHarness.h"
+#import "EWCCalculator.h"
+#import "EWCCalculatorPool.h"
+#import "EWCReferenceCalculator.h"
+
+@interface EWCFuzzHarness() {
+  EWCCalculatorPool *_pool;  // reuses the optimized calculators, which also checks that a reset calculator behaves as a new one
+  NSMutableData *_candidate;  // scratch space for the sequences tried while minimizing
+}
+
+@end
+
+/**
+  Checks whether two values are the same, treating NaN as matching NaN.
+
+  @param a The first value.
+  @param b The second value.
+
+  @return YES if the values match.
+ */
+static BOOL EWCFuzzValuesMatch(NSDecimalNumber *a, NSDecimalNumber *b) {
+  NSDecimal left = a.decimalValue;
+  NSDecimal right = b.decimalValue;
+
+  BOOL leftNaN = NSDecimalIsNotANumber(&left);
+  BOOL rightNaN = NSDecimalIsNotANumber(&right);
+  if (leftNaN || rightNaN) {
+    return leftNaN && rightNaN;
+  }
+
+  return NSDecimalCompare(&left, &right) == NSOrderedSame;
+}
+
+/**
+  Compares the results of the two calculators.
+
+  @param calculator The optimized calculator.
+  @param reference The reference calculator.
+  @param content Whether to also compare the formatted display content.
+
+  @return YES if the results match.
+ */
+static BOOL EWCFuzzResultsMatch(EWCCalculator *calculator, EWCReferenceCalculator *reference, BOOL content) {
+  return calculator.hasError == reference.hasError
+    && calculator.hasMemory == reference.hasMemory
+    && calculator.isTaxStatusVisible == reference.isTaxStatusVisible
+    && calculator.isTaxPlusStatusVisible == reference.isTaxPlusStatusVisible
+    && calculator.isTaxMinusStatusVisible == reference.isTaxMinusStatusVisible
+    && calculator.isTaxPercentStatusVisible == reference.isTaxPercentStatusVisible
+    && calculator.isRateShifted == reference.isRateShifted
+    && calculator.shouldMemoryClear == reference.shouldMemoryClear
+    && EWCFuzzValuesMatch(calculator.displayValue, reference.displayValue)
+    && (! content || [calculator.displayContent isEqualToString:reference.displayContent]);
+}
+
+@implementation EWCFuzzHarness
+
+///----------------------------------------------
+/// @name Construction and Initialization Methods
+///----------------------------------------------
+
++ (instancetype)harnessWithLocale:(NSLocale *)locale maximumDigits:(NSInteger)maximumDigits {
+  return [[EWCFuzzHarness alloc] initWithLocale:locale maximumDigits:maximumDigits];
+}
+
+- (instancetype)initWithLocale:(NSLocale *)locale maximumDigits:(NSInteger)maximumDigits {
+  self = [super init];
+  if (self) {
+    _locale = [locale copy];
+    _maximumDigits = maximumDigits;
+    _pool = [EWCCalculatorPool poolWithLocale:locale maximumDigits:maximumDigits];
+    _candidate = [NSMutableData new];
+  }
+
+  return self;
+}
+
+///----------------------
+/// @name Fuzzing Methods
+///----------------------
+
+- (NSUInteger)firstDivergenceInKeys:(const EWCCalculatorKey *)keys count:(NSUInteger)count {
+  return [self runKeys:keys count:count report:nil];
+}
+
+- (NSUInteger)minimizeKeys:(EWCCalculatorKey *)keys count:(NSUInteger)count {
+  NSUInteger divergence = [self firstDivergenceInKeys:keys count:count];
+  if (divergence == NSNotFound) {
+    return 0;
+  }
+
+  // nothing after the divergence is needed.  the content is only compared at
+  // the end, so this keeps it diverging either way.
+  count = divergence + 1;
+
+  _candidate.length = count * sizeof(EWCCalculatorKey);
+  EWCCalculatorKey *candidate = _candidate.mutableBytes;
+
+  // remove runs of keys, starting with halves, and moving to smaller runs
+  // once no run of the current size can be removed
+  NSUInteger chunks = 2;
+  while (count > 1) {
+    NSUInteger chunkLength = (count + chunks - 1) / chunks;
+    BOOL reduced = NO;
+
+    for (NSUInteger start = 0; start < count; start += chunkLength) {
+      NSUInteger end = MIN(start + chunkLength, count);
+      NSUInteger length = count - (end - start);
+      memcpy(candidate, keys, start * sizeof(EWCCalculatorKey));
+      memcpy(candidate + start, keys + end, (count - end) * sizeof(EWCCalculatorKey));
+
+      divergence = [self firstDivergenceInKeys:candidate count:length];
+      if (divergence != NSNotFound) {
+        count = divergence + 1;
+        memcpy(keys, candidate, count * sizeof(EWCCalculatorKey));
+        chunks = MAX(chunks - 1, 2);
+        reduced = YES;
+        break;
+      }
+    }
+
+    if (! reduced) {
+      if (chunks >= count) {
+        break;
+      }
+      chunks = MIN(chunks * 2, count);
+    }
+  }
+
+  return count;
+}
+
+- (NSString *)describeDivergenceInKeys:(const EWCCalculatorKey *)keys count:(NSUInteger)count {
+  NSMutableString *report = [NSMutableString new];
+  NSUInteger divergence = [self runKeys:keys count:count report:report];
+
+  return (divergence == NSNotFound) ? nil : report;
+}
+
++ (NSString *)stringFromKeys:(const EWCCalculatorKey *)keys count:(NSUInteger)count {
+  NSMutableString *str = [NSMutableString stringWithCapacity:count];
+  for (NSUInteger i = 0; i < count; ++i) {
+    unichar c = EWCCalculatorCharacterFromKey(keys[i]);
+    [str appendString:[NSString stringWithCharacters:&c length:1]];
+  }
+
+  return str;
+}
+
+///------------------------------
+/// @name Internal helper methods
+///------------------------------
+
+/**
+  Runs keys through new instances of both calculators, stopping at the first divergence.
+
+  @param keys The keys to press.
+  @param count The number of keys.
+  @param report If not nil, receives a description of the divergence.
+
+  @return The index of the key after which the calculators first disagreed, or `NSNotFound`.
+ */
+- (NSUInteger)runKeys:(const EWCCalculatorKey *)keys count:(NSUInteger)count report:(NSMutableString *)report {
+  EWCCalculator *calculator = [_pool acquireCalculator];
+  EWCReferenceCalculator *reference = [EWCReferenceCalculator calculator];
+  reference.locale = _locale;
+  reference.maximumDigits = _maximumDigits;
+
+  NSUInteger divergence = NSNotFound;
+  for (NSUInteger i = 0; i < count; ++i) {
+    [calculator pressKey:keys[i]];
+    [reference pressKey:keys[i]];
+
+    BOOL content = _comparesDisplayContentEveryKey || i + 1 == count;
+    if (! EWCFuzzResultsMatch(calculator, reference, content)) {
+      divergence = i;
+      break;
+    }
+  }
+
+  if (report && divergence != NSNotFound) {
+    [report appendFormat:@"keys: %@\n", [EWCFuzzHarness stringFromKeys:keys count:divergence + 1]];
+    [report appendFormat:@"  optimized: %@\n", [self describeCalculator:calculator]];
+    [report appendFormat:@"  reference: %@\n", [self describeReference:reference]];
+  }
+
+  [_pool releaseCalculator:calculator];
+
+  return divergence;
+}
+
+/**
+  Describes the results of the optimized calculator.
+
+  @param calculator The calculator to describe.
+
+  @return The description.
+ */
+- (NSString *)describeCalculator:(EWCCalculator *)calculator {
+  return [NSString stringWithFormat:@"display=%@ value=%@ error=%d memory=%d tax=%d tax+=%d tax-=%d tax%%=%d rate=%d mclear=%d",
+    calculator.displayContent, calculator.displayValue,
+    calculator.hasError, calculator.hasMemory,
+    calculator.isTaxStatusVisible, calculator.isTaxPlusStatusVisible,
+    calculator.isTaxMinusStatusVisible, calculator.isTaxPercentStatusVisible,
+    calculator.isRateShifted, calculator.shouldMemoryClear];
+}
+
+/**
+  Describes the results of the reference calculator.
+
+  @param reference The calculator to describe.
+
+  @return The description.
+ */
+- (NSString *)describeReference:(EWCReferenceCalculator *)reference {
+  return [NSString stringWithFormat:@"display=%@ value=%@ error=%d memory=%d tax=%d tax+=%d tax-=%d tax%%=%d rate=%d mclear=%d",
+    reference.displayContent, reference.displayValue,
+    reference.hasError, reference.hasMemory,
+    reference.isTaxStatusVisible, reference.isTaxPlusStatusVisible,
+    reference.isTaxMinusStatusVisible, reference.isTaxPercentStatusVisible,
+    reference.isRateShifted, reference.shouldMemoryClear];
+}
+
+@end
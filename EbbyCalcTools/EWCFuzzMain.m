@@ -0,0 +1,263 @@
+//
+//  EWCFuzzMain.m
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import <pthread.h>
+#import <stdatomic.h>
+#import <stdio.h>
+#import <stdlib.h>
+#import <time.h>
+#import <unistd.h>
+#import "EWCFuzzGenerator.h"
+#import "EWCFuzzHarness.h"
+
+/**
+  `EWCFuzzOptions` holds the command line settings of the fuzzer.
+ */
+typedef struct {
+  const char *localeIdentifier;  // the locale of both calculators
+  NSInteger maximumDigits;  // the digit limit of both calculators
+  NSUInteger length;  // the number of keys in each sequence
+  uint64_t cases;  // the number of sequences each worker runs, 0 for no limit
+  uint64_t seed;  // the seed the worker seeds are derived from
+  BOOL compareContent;  // whether to compare the display content after every key
+} EWCFuzzOptions;
+
+/**
+  `EWCFuzzWorker` holds the state of one fuzzing thread.
+ */
+typedef struct {
+  const EWCFuzzOptions *options;  // the shared settings
+  int index;  // which worker this is
+  atomic_uint_fast64_t cases;  // the number of sequences run, read by the main thread for progress
+} EWCFuzzWorker;
+
+// the total number of keys pressed (on each calculator) by all workers
+static atomic_uint_fast64_t s_keyCount = 0;
+
+// set to stop the workers, when the time is up or a divergence is found
+static atomic_int s_stopRequested = 0;
+
+// set by the first worker to find a divergence, so only one is reported
+static atomic_int s_divergenceFound = 0;
+
+/**
+  Gets the current time from a clock that doesn't jump.
+
+  @return The time in seconds.
+ */
+static double EWCFuzzNow(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+  Shrinks and reports a divergence.  Only the first worker to find a divergence reports it.
+
+  @param harness The harness that found the divergence.
+  @param keys The diverging sequence.
+  @param count The number of keys in the sequence.
+  @param worker The worker that found it.
+ */
+static void EWCFuzzReport(EWCFuzzHarness *harness, EWCCalculatorKey *keys, NSUInteger count, EWCFuzzWorker *worker) {
+  int expected = 0;
+  if (! atomic_compare_exchange_strong(&s_divergenceFound, &expected, 1)) {
+    return;
+  }
+  atomic_store(&s_stopRequested, 1);
+
+  fprintf(stderr, "worker %d diverged in case %llu, minimizing %lu keys\n",
+    worker->index, (unsigned long long)atomic_load(&worker->cases), (unsigned long)count);
+
+  NSUInteger minimized = [harness minimizeKeys:keys count:count];
+  NSString *report = [harness describeDivergenceInKeys:keys count:minimized];
+  fprintf(stdout, "DIVERGENCE (%lu keys)\n%s",
+    (unsigned long)minimized, report.UTF8String);
+}
+
+/**
+  Runs random sequences through both calculators until told to stop, the case limit is reached, or a divergence is found.
+
+  @param context The `EWCFuzzWorker`.
+
+  @return Unused.
+ */
+static void *EWCFuzzRunWorker(void *context) {
+  EWCFuzzWorker *worker = context;
+  const EWCFuzzOptions *options = worker->options;
+
+  @autoreleasepool {
+    NSLocale *locale = [NSLocale localeWithLocaleIdentifier:@(options->localeIdentifier)];
+    EWCFuzzHarness *harness = [EWCFuzzHarness harnessWithLocale:locale
+      maximumDigits:options->maximumDigits];
+    harness.comparesDisplayContentEveryKey = options->compareContent;
+
+    EWCFuzzGenerator generator;
+    EWCFuzzGeneratorInit(&generator, options->seed + (uint64_t)worker->index, options->maximumDigits);
+
+    NSMutableData *buffer = [NSMutableData dataWithLength:options->length * sizeof(EWCCalculatorKey)];
+    EWCCalculatorKey *keys = buffer.mutableBytes;
+
+    uint64_t cases = 0;
+    while (! atomic_load_explicit(&s_stopRequested, memory_order_relaxed)
+      && (options->cases == 0 || cases < options->cases)) {
+      @autoreleasepool {
+        EWCFuzzGeneratorFill(&generator, keys, options->length);
+        NSUInteger divergence = [harness firstDivergenceInKeys:keys count:options->length];
+        atomic_store_explicit(&worker->cases, ++cases, memory_order_relaxed);
+
+        NSUInteger pressed = (divergence == NSNotFound) ? options->length : divergence + 1;
+        atomic_fetch_add_explicit(&s_keyCount, pressed, memory_order_relaxed);
+
+        if (divergence != NSNotFound) {
+          EWCFuzzReport(harness, keys, options->length, worker);
+          break;
+        }
+      }
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Prints the command line usage.
+
+  @param name The name the tool was run as.
+ */
+static void EWCFuzzUsage(const char *name) {
+  fprintf(stderr,
+    "usage: %s [-j workers] [-t seconds] [-n cases] [-l length] [-s seed] [-d digits] [-L locale] [-c]\n"
+    "  -j  number of worker threads (default one per processor)\n"
+    "  -t  stop after this many seconds, 0 for no limit (default 0)\n"
+    "  -n  sequences each worker runs, 0 for no limit (default 0)\n"
+    "  -l  keys in each sequence (default 64)\n"
+    "  -s  random seed (default the current time)\n"
+    "  -d  maximum digits (default 16)\n"
+    "  -L  locale identifier (default en_US)\n"
+    "  -c  compare the formatted display after every key, rather than after each sequence\n",
+    name);
+}
+
+int main(int argc, char * argv[]) {
+  @autoreleasepool {
+    EWCFuzzOptions options = {
+      .localeIdentifier = "en_US",
+      .maximumDigits = 16,
+      .length = 64,
+      .cases = 0,
+      .seed = (uint64_t)time(NULL),
+      .compareContent = NO,
+    };
+    int workerCount = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    double timeLimit = 0;
+
+    int option;
+    while ((option = getopt(argc, argv, "j:t:n:l:s:d:L:ch")) != -1) {
+      switch (option) {
+        case 'j': workerCount = atoi(optarg); break;
+        case 't': timeLimit = atof(optarg); break;
+        case 'n': options.cases = strtoull(optarg, NULL, 10); break;
+        case 'l': options.length = (NSUInteger)atol(optarg); break;
+        case 's': options.seed = strtoull(optarg, NULL, 10); break;
+        case 'd': options.maximumDigits = atol(optarg); break;
+        case 'L': options.localeIdentifier = optarg; break;
+        case 'c': options.compareContent = YES; break;
+        default:
+          EWCFuzzUsage(argv[0]);
+          return (option == 'h') ? 0 : 2;
+      }
+    }
+
+    if (workerCount < 1 || options.length < 1) {
+      EWCFuzzUsage(argv[0]);
+      return 2;
+    }
+
+    // print the seed, so that a run can be repeated
+    fprintf(stderr, "seed %llu, %d workers, %lu keys per case\n",
+      (unsigned long long)options.seed, workerCount, (unsigned long)options.length);
+
+    EWCFuzzWorker *workers = calloc((size_t)workerCount, sizeof(EWCFuzzWorker));
+    pthread_t *threads = calloc((size_t)workerCount, sizeof(pthread_t));
+
+    double start = EWCFuzzNow();
+    for (int i = 0; i < workerCount; ++i) {
+      workers[i].options = &options;
+      workers[i].index = i;
+      pthread_create(&threads[i], NULL, EWCFuzzRunWorker, &workers[i]);
+    }
+
+    // report progress until the time is up, or every worker has finished
+    uint64_t lastCount = 0;
+    double lastTime = start;
+    while (! atomic_load(&s_stopRequested)) {
+      usleep(100000);
+
+      double now = EWCFuzzNow();
+      if (timeLimit > 0 && now - start >= timeLimit) {
+        atomic_store(&s_stopRequested, 1);
+      }
+
+      uint64_t cases = 0;
+      BOOL finished = (options.cases != 0);
+      for (int i = 0; i < workerCount; ++i) {
+        uint64_t workerCases = atomic_load(&workers[i].cases);
+        cases += workerCases;
+        finished = finished && workerCases >= options.cases;
+      }
+
+      if (now - lastTime >= 1) {
+        uint64_t count = atomic_load(&s_keyCount);
+        fprintf(stderr, "%.0f s: %llu cases, %llu keys (%.0f keys/s)\n",
+          now - start, (unsigned long long)cases, (unsigned long long)count,
+          (count - lastCount) / (now - lastTime));
+        lastCount = count;
+        lastTime = now;
+      }
+
+      if (finished) {
+        break;
+      }
+    }
+
+    for (int i = 0; i < workerCount; ++i) {
+      pthread_join(threads[i], NULL);
+    }
+
+    double elapsed = EWCFuzzNow() - start;
+    uint64_t cases = 0;
+    for (int i = 0; i < workerCount; ++i) {
+      cases += atomic_load(&workers[i].cases);
+    }
+    uint64_t count = atomic_load(&s_keyCount);
+    fprintf(stdout, "%llu cases, %llu keys in %.1f s (%.0f keys/s)\n",
+      (unsigned long long)cases, (unsigned long long)count, elapsed,
+      elapsed > 0 ? count / elapsed : 0.0);
+
+    free(threads);
+    free(workers);
+
+    return atomic_load(&s_divergenceFound) ? 1 : 0;
+  }
+}
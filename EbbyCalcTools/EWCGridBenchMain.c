@@ -0,0 +1,320 @@
+//
+//  EWCGridBenchMain.c
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "EWCGridHitMap.h"
+
+/**
+  `EWCGridBenchKey` places a key in one of the app's grid layouts.
+ */
+typedef struct {
+  int startRow;  // the first row spanned
+  int startColumn;  // the first column spanned
+  int endRow;  // the last row spanned
+  int endColumn;  // the last column spanned
+} EWCGridBenchKey;
+
+/**
+  `EWCGridBenchLayout` describes one of the app's grid layouts.
+ */
+typedef struct {
+  const char *name;  // the layout name, for reporting
+  int rows;  // the number of rows
+  int columns;  // the number of columns
+  double width;  // the grid width, in points
+  double height;  // the grid height, in points
+  double rowGutter;  // the row gutter, as a fraction of the height
+  double columnGutter;  // the column gutter, as a fraction of the width
+  const EWCGridBenchKey *keys;  // where each key is placed
+  int keyCount;  // the number of keys
+} EWCGridBenchLayout;
+
+// the tall layout, as placed by the view controller (the add key spans two rows)
+static const EWCGridBenchKey s_tallKeys[] = {
+  {8, 0, 8, 0}, {7, 0, 7, 0}, {7, 1, 7, 1}, {7, 2, 7, 2}, {6, 0, 6, 0},
+  {6, 1, 6, 1}, {6, 2, 6, 2}, {5, 0, 5, 0}, {5, 1, 5, 1}, {5, 2, 5, 2},
+  {2, 0, 2, 0}, {0, 0, 0, 0}, {0, 1, 0, 1}, {0, 2, 0, 2}, {1, 0, 1, 0},
+  {1, 1, 1, 1}, {1, 2, 1, 2}, {3, 2, 4, 2}, {4, 1, 4, 1}, {3, 1, 3, 1},
+  {3, 0, 3, 0}, {4, 0, 4, 0}, {8, 1, 8, 1}, {2, 1, 2, 1}, {2, 2, 2, 2},
+  {8, 2, 8, 2},
+};
+
+// the wide layout, as placed by the view controller
+static const EWCGridBenchKey s_wideKeys[] = {
+  {4, 1, 4, 1}, {3, 1, 3, 1}, {3, 2, 3, 2}, {3, 3, 3, 3}, {2, 1, 2, 1},
+  {2, 2, 2, 2}, {2, 3, 2, 3}, {1, 1, 1, 1}, {1, 2, 1, 2}, {1, 3, 1, 3},
+  {1, 0, 1, 0}, {0, 3, 0, 3}, {0, 4, 0, 4}, {0, 5, 0, 5}, {2, 5, 2, 5},
+  {4, 5, 4, 5}, {3, 5, 3, 5}, {3, 4, 4, 4}, {2, 4, 2, 4}, {1, 4, 1, 4},
+  {1, 5, 1, 5}, {2, 0, 2, 0}, {4, 2, 4, 2}, {3, 0, 3, 0}, {4, 0, 4, 0},
+  {4, 3, 4, 3},
+};
+
+static const EWCGridBenchLayout s_layouts[] = {
+  { "tall", 9, 3, 375, 560, 0.020, 0.020,
+    s_tallKeys, sizeof(s_tallKeys) / sizeof(s_tallKeys[0]) },
+  { "wide", 5, 6, 812, 300, 0.020, 0.030,
+    s_wideKeys, sizeof(s_wideKeys) / sizeof(s_wideKeys[0]) },
+};
+
+/**
+  Gets the current time from a monotonic clock.
+
+  @return The time in seconds.
+ */
+static double EWCGridBenchNow(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+  Generates a pseudo-random number (xorshift64*).
+
+  @param state The generator state, which must not be zero.
+
+  @return The next number.
+ */
+static uint64_t EWCGridBenchRandom(uint64_t *state) {
+  uint64_t x = *state;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  *state = x;
+
+  return x * 2685821657736338717ULL;
+}
+
+/**
+  Generates a pseudo-random number in a range.
+
+  @param state The generator state.
+  @param low The lowest value.
+  @param high The highest value (exclusive).
+
+  @return The number.
+ */
+static double EWCGridBenchUniform(uint64_t *state, double low, double high) {
+  return low + (high - low) * ((EWCGridBenchRandom(state) >> 11) * (1.0 / 9007199254740992.0));
+}
+
+/**
+  Calculates the frame of a key the way the grid layout view does, inset by half a gutter on each side.
+
+  @param layout The layout.
+  @param key The key placement.
+
+  @return The frame.
+ */
+static EWCGridHitRect EWCGridBenchFrame(const EWCGridBenchLayout *layout, const EWCGridBenchKey *key) {
+  double top = layout->height * ((double)key->startRow / layout->rows);
+  double height = layout->height * ((double)(key->endRow - key->startRow + 1) / layout->rows);
+  double left = layout->width * ((double)key->startColumn / layout->columns);
+  double width = layout->width * ((double)(key->endColumn - key->startColumn + 1) / layout->columns);
+
+  double gutterWidth = layout->columnGutter * layout->width / 2.0;
+  double gutterHeight = layout->rowGutter * layout->height / 2.0;
+
+  return (EWCGridHitRect){
+    left + gutterWidth, top + gutterHeight,
+    width - 2 * gutterWidth, height - 2 * gutterHeight };
+}
+
+/**
+  Builds the hit map of a layout.
+
+  @param map Receives the map.
+  @param layout The layout.
+ */
+static void EWCGridBenchBuild(EWCGridHitMap *map, const EWCGridBenchLayout *layout) {
+  EWCGridHitMapReset(map, layout->rows, layout->columns, layout->width, layout->height);
+  for (int i = 0; i < layout->keyCount; ++i) {
+    const EWCGridBenchKey *key = &layout->keys[i];
+    EWCGridHitMapAdd(map, key->startRow, key->startColumn, key->endRow, key->endColumn,
+      EWCGridBenchFrame(layout, key));
+  }
+}
+
+/**
+  Fills a list of points in and around a layout.  Most are spread across the grid (and a margin past it), and the rest are on the cell and frame edges, where rounding could put a point in the wrong cell.
+
+  @param map The map of the layout.
+  @param xs Receives the horizontal positions.
+  @param ys Receives the vertical positions.
+  @param count The number of points.
+  @param state The generator state.
+ */
+static void EWCGridBenchPoints(const EWCGridHitMap *map, double *xs, double *ys, int count, uint64_t *state) {
+  for (int i = 0; i < count; ++i) {
+    if (EWCGridBenchRandom(state) % 4 != 0) {
+      xs[i] = EWCGridBenchUniform(state, -0.1 * map->width, 1.1 * map->width);
+      ys[i] = EWCGridBenchUniform(state, -0.1 * map->height, 1.1 * map->height);
+      continue;
+    }
+
+    // pick an edge of a frame or of a cell
+    const EWCGridHitRect *frame = &map->frames[EWCGridBenchRandom(state) % (uint64_t)map->itemCount];
+    double cellX = map->cellWidth * (double)(EWCGridBenchRandom(state) % (uint64_t)(map->columns + 1));
+    double cellY = map->cellHeight * (double)(EWCGridBenchRandom(state) % (uint64_t)(map->rows + 1));
+    switch (EWCGridBenchRandom(state) % 3) {
+      case 0: xs[i] = frame->x; ys[i] = frame->y; break;
+      case 1: xs[i] = frame->x + frame->width; ys[i] = frame->y + frame->height; break;
+      default: xs[i] = cellX; ys[i] = cellY; break;
+    }
+  }
+}
+
+/**
+  Checks that randomly placed and sized items (overlapping, overhanging, and reaching past their spans) are found the same by the map as by scanning.
+
+  @param grids The number of random grids to check.
+  @param state The generator state.
+
+  @return The number of lookups that disagreed.
+ */
+static long EWCGridBenchCheckRandomGrids(int grids, uint64_t *state) {
+  static EWCGridHitMap map;
+  enum { pointCount = 2000 };
+  static double xs[pointCount], ys[pointCount];
+  long mismatches = 0;
+
+  for (int g = 0; g < grids; ++g) {
+    int rows = 1 + (int)(EWCGridBenchRandom(state) % 12);
+    int columns = 1 + (int)(EWCGridBenchRandom(state) % 12);
+    double width = EWCGridBenchUniform(state, 10, 2000);
+    double height = EWCGridBenchUniform(state, 10, 2000);
+    EWCGridHitMapReset(&map, rows, columns, width, height);
+
+    int items = 1 + (int)(EWCGridBenchRandom(state) % EWCGridHitMapMaxItems);
+    for (int i = 0; i < items; ++i) {
+      int startRow = (int)(EWCGridBenchRandom(state) % (uint64_t)rows);
+      int startColumn = (int)(EWCGridBenchRandom(state) % (uint64_t)columns);
+      int endRow = startRow + (int)(EWCGridBenchRandom(state) % (uint64_t)(rows - startRow));
+      int endColumn = startColumn + (int)(EWCGridBenchRandom(state) % (uint64_t)(columns - startColumn));
+      EWCGridHitRect frame = {
+        EWCGridBenchUniform(state, -0.2 * width, 1.1 * width),
+        EWCGridBenchUniform(state, -0.2 * height, 1.1 * height),
+        EWCGridBenchUniform(state, 0, 0.4 * width),
+        EWCGridBenchUniform(state, 0, 0.4 * height),
+      };
+      EWCGridHitMapAdd(&map, startRow, startColumn, endRow, endColumn, frame);
+    }
+
+    EWCGridBenchPoints(&map, xs, ys, pointCount, state);
+    for (int i = 0; i < pointCount; ++i) {
+      if (EWCGridHitMapFind(&map, xs[i], ys[i]) != EWCGridHitMapScan(&map, xs[i], ys[i])) {
+        ++mismatches;
+      }
+    }
+  }
+
+  return mismatches;
+}
+
+/**
+  Prints the command line usage.
+
+  @param name The name the tool was run as.
+ */
+static void EWCGridBenchUsage(const char *name) {
+  fprintf(stderr,
+    "usage: %s [-n lookups] [-r grids] [-s seed]\n"
+    "  -n  lookups timed per layout (default 10000000)\n"
+    "  -r  random grids checked against scanning (default 2000)\n"
+    "  -s  random seed (default from the clock)\n",
+    name);
+}
+
+int main(int argc, char * argv[]) {
+  long lookups = 10000000;
+  int grids = 2000;
+  uint64_t seed = (uint64_t)time(NULL);
+
+  int option;
+  while ((option = getopt(argc, argv, "n:r:s:h")) != -1) {
+    switch (option) {
+      case 'n': lookups = atol(optarg); break;
+      case 'r': grids = atoi(optarg); break;
+      case 's': seed = strtoull(optarg, NULL, 10); break;
+      default:
+        EWCGridBenchUsage(argv[0]);
+        return (option == 'h') ? 0 : 2;
+    }
+  }
+
+  if (lookups < 1 || grids < 0) {
+    EWCGridBenchUsage(argv[0]);
+    return 2;
+  }
+
+  printf("seed: %llu\n", (unsigned long long)seed);
+  uint64_t state = seed ? seed : 1;
+  long mismatches = 0;
+
+  // time the app's own layouts, looking up a fixed set of points repeatedly
+  enum { pointCount = 4096 };
+  static double xs[pointCount], ys[pointCount];
+  static EWCGridHitMap map;
+  for (size_t l = 0; l < sizeof(s_layouts) / sizeof(s_layouts[0]); ++l) {
+    const EWCGridBenchLayout *layout = &s_layouts[l];
+    EWCGridBenchBuild(&map, layout);
+    EWCGridBenchPoints(&map, xs, ys, pointCount, &state);
+
+    for (int i = 0; i < pointCount; ++i) {
+      if (EWCGridHitMapFind(&map, xs[i], ys[i]) != EWCGridHitMapScan(&map, xs[i], ys[i])) {
+        ++mismatches;
+      }
+    }
+
+    // sum the results so the lookups can't be optimized away
+    long sum = 0;
+    double start = EWCGridBenchNow();
+    for (long i = 0; i < lookups; ++i) {
+      sum += EWCGridHitMapScan(&map, xs[i % pointCount], ys[i % pointCount]);
+    }
+    double scanTime = EWCGridBenchNow() - start;
+
+    start = EWCGridBenchNow();
+    for (long i = 0; i < lookups; ++i) {
+      sum -= EWCGridHitMapFind(&map, xs[i % pointCount], ys[i % pointCount]);
+    }
+    double findTime = EWCGridBenchNow() - start;
+
+    printf("%s (%d keys): scan %.1f ns  table %.1f ns  (%.1fx)%s\n",
+      layout->name, layout->keyCount,
+      scanTime / lookups * 1e9, findTime / lookups * 1e9,
+      findTime > 0 ? scanTime / findTime : 0,
+      sum == 0 ? "" : "  results differ");
+    if (sum != 0) {
+      ++mismatches;
+    }
+  }
+
+  mismatches += EWCGridBenchCheckRandomGrids(grids, &state);
+  printf("random grids: %d  mismatches: %ld\n", grids, mismatches);
+
+  return (mismatches > 0) ? 1 : 0;
+}
@@ -0,0 +1,226 @@
+//
+//  EWCKeyMapBenchMain.m
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import <stdio.h>
+#import <stdlib.h>
+#import <time.h>
+#import <unistd.h>
+#import "EWCCalculatorKey.h"
+#import "EWCKeyMap.h"
+
+/**
+  Gets the current time from a clock that doesn't jump.
+
+  @return The time in seconds.
+ */
+static NSTimeInterval EWCKeyMapBenchNow(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+  Generates a pseudo-random number (xorshift64*).
+
+  @param state The generator state, which must not be zero.
+
+  @return The next number.
+ */
+static uint64_t EWCKeyMapBenchRandom(uint64_t *state) {
+  uint64_t x = *state;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  *state = x;
+
+  return x * 2685821657736338717ULL;
+}
+
+/**
+  Looks a character up the way `EWCCalculatorKeyFromCharacter` did before it was compiled to a table, as the baseline.
+
+  @param c The character.
+
+  @return The key, or `EWCCalculatorNoKey`.
+ */
+static EWCCalculatorKey EWCKeyMapBenchSwitch(unichar c) {
+  switch (c) {
+    case '0': return EWCCalculatorZeroKey;
+    case '1': return EWCCalculatorOneKey;
+    case '2': return EWCCalculatorTwoKey;
+    case '3': return EWCCalculatorThreeKey;
+    case '4': return EWCCalculatorFourKey;
+    case '5': return EWCCalculatorFiveKey;
+    case '6': return EWCCalculatorSixKey;
+    case '7': return EWCCalculatorSevenKey;
+    case '8': return EWCCalculatorEightKey;
+    case '9': return EWCCalculatorNineKey;
+    case 'c': case 'C': return EWCCalculatorClearKey;
+    case 'q': case 'Q': return EWCCalculatorRateKey;
+    case 'w': case 'W': return EWCCalculatorTaxPlusKey;
+    case 'e': case 'E': return EWCCalculatorTaxMinusKey;
+    case 'a': case 'A': return EWCCalculatorMemoryKey;
+    case 's': case 'S': return EWCCalculatorMemoryPlusKey;
+    case 'd': case 'D': return EWCCalculatorMemoryMinusKey;
+    case '+': return EWCCalculatorAddKey;
+    case '-': return EWCCalculatorSubtractKey;
+    case '*': return EWCCalculatorMultiplyKey;
+    case '/': return EWCCalculatorDivideKey;
+    case '\\': return EWCCalculatorSignKey;
+    case '.': return EWCCalculatorDecimalKey;
+    case '%': return EWCCalculatorPercentKey;
+    case 'y': case 'Y': return EWCCalculatorSqrtKey;
+    case '=': return EWCCalculatorEqualKey;
+    case '<': return EWCCalculatorBackspaceKey;
+
+    default:
+      return EWCCalculatorNoKey;
+  }
+}
+
+/**
+  Prints the command line usage.
+
+  @param name The name the tool was run as.
+ */
+static void EWCKeyMapBenchUsage(const char *name) {
+  fprintf(stderr,
+    "usage: %s [-n characters] [-u percent] [-s seed]\n"
+    "  -n  characters to translate (default 10000000)\n"
+    "  -u  percentage of characters that aren't keys (default 5)\n"
+    "  -s  random seed (default from the clock)\n",
+    name);
+}
+
+int main(int argc, char * argv[]) {
+  @autoreleasepool {
+    long count = 10000000;
+    long unmappedPercent = 5;
+    uint64_t seed = (uint64_t)time(NULL);
+
+    int option;
+    while ((option = getopt(argc, argv, "n:u:s:h")) != -1) {
+      switch (option) {
+        case 'n': count = atol(optarg); break;
+        case 'u': unmappedPercent = atol(optarg); break;
+        case 's': seed = strtoull(optarg, NULL, 10); break;
+        default:
+          EWCKeyMapBenchUsage(argv[0]);
+          return (option == 'h') ? 0 : 2;
+      }
+    }
+
+    if (count < 1 || unmappedPercent < 0 || unmappedPercent > 100) {
+      EWCKeyMapBenchUsage(argv[0]);
+      return 2;
+    }
+
+    printf("seed: %llu\n", (unsigned long long)seed);
+    uint64_t state = seed ? seed : 1;
+
+    // every character of the notation, in either case, and some that aren't
+    static const char s_keys[] = "0123456789cqweadCQWEAD+-*/\\.%yY=<";
+    static const char s_others[] = "xz!?:; ,()#@&^";
+    unichar *text = malloc(sizeof(unichar) * (size_t)count);
+    for (long i = 0; i < count; ++i) {
+      uint64_t r = EWCKeyMapBenchRandom(&state);
+      text[i] = ((long)(r % 100) < unmappedPercent)
+        ? s_others[(r >> 8) % (sizeof(s_others) - 1)]
+        : s_keys[(r >> 8) % (sizeof(s_keys) - 1)];
+    }
+
+    // the hardware key path looked each command's input string up in a
+    // dictionary, and unboxed the key
+    NSMutableDictionary<NSString *, NSNumber *> *dictionary = [NSMutableDictionary new];
+    NSString *strings[128];
+    for (unichar c = 0; c < 128; ++c) {
+      strings[c] = [NSString stringWithCharacters:&c length:1];
+      EWCCalculatorKey key = EWCKeyMapBenchSwitch(c);
+      if (key != EWCCalculatorNoKey) {
+        dictionary[strings[c]] = @(key);
+      }
+    }
+
+    const EWCKeyMap *map = EWCCalculatorKeyNotationMap();
+    long mismatches = 0;
+    long sums[3] = { 0, 0, 0 };
+
+    NSTimeInterval start = EWCKeyMapBenchNow();
+    for (long i = 0; i < count; ++i) {
+      NSNumber *number = dictionary[strings[text[i]]];
+      sums[0] += number ? number.intValue : EWCCalculatorNoKey;
+    }
+    NSTimeInterval dictionaryTime = EWCKeyMapBenchNow() - start;
+
+    start = EWCKeyMapBenchNow();
+    for (long i = 0; i < count; ++i) {
+      sums[1] += EWCKeyMapBenchSwitch(text[i]);
+    }
+    NSTimeInterval switchTime = EWCKeyMapBenchNow() - start;
+
+    start = EWCKeyMapBenchNow();
+    for (long i = 0; i < count; ++i) {
+      sums[2] += EWCKeyMapLookup(map, text[i]);
+    }
+    NSTimeInterval lookupTime = EWCKeyMapBenchNow() - start;
+
+    int *keys = malloc(sizeof(int) * (size_t)count);
+    size_t unmapped = 0;
+    start = EWCKeyMapBenchNow();
+    size_t translated = EWCKeyMapTranslate(map, text, (size_t)count, keys, &unmapped);
+    NSTimeInterval translateTime = EWCKeyMapBenchNow() - start;
+
+    // check that every path agrees on every character
+    size_t next = 0;
+    for (long i = 0; i < count; ++i) {
+      EWCCalculatorKey expected = EWCKeyMapBenchSwitch(text[i]);
+      if ((EWCCalculatorKey)EWCKeyMapLookup(map, text[i]) != expected
+        || EWCCalculatorKeyFromCharacter(text[i]) != expected) {
+        ++mismatches;
+      }
+      if (expected != EWCCalculatorNoKey) {
+        if (next >= translated || keys[next] != expected) {
+          ++mismatches;
+        }
+        ++next;
+      }
+    }
+    if (sums[0] != sums[1] || sums[1] != sums[2] || next != translated) {
+      ++mismatches;
+    }
+
+    printf("characters: %ld  (%ld%% not keys)  table: %u slots for %u characters\n",
+      count, unmappedPercent, EWCKeyMapTableSize(map), map->entryCount);
+    printf("dictionary: %.2f ns/char\n", dictionaryTime / count * 1e9);
+    printf("switch:     %.2f ns/char\n", switchTime / count * 1e9);
+    printf("table:      %.2f ns/char\n", lookupTime / count * 1e9);
+    printf("translate:  %.2f ns/char  (%zu keys, %zu skipped)\n",
+      translateTime / count * 1e9, translated, unmapped);
+    printf("mismatches: %ld\n", mismatches);
+
+    free(text);
+    free(keys);
+
+    return mismatches ? 1 : 0;
+  }
+}
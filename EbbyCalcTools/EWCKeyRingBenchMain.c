@@ -0,0 +1,304 @@
+//
+//  EWCKeyRingBenchMain.c
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "EWCKeyRing.h"
+
+// how long the consumer waits for a scheduled drain before deciding that the
+// keys left in the ring have been stranded
+#define EWCKeyRingBenchStallSeconds 5
+
+/**
+  `EWCKeyRingBenchRun` holds the state shared by the producer and consumer threads.
+ */
+typedef struct {
+  EWCKeyRing ring;  // the ring under test
+  sem_t scheduled;  // posted for each drain the producer schedules, standing in for the main queue
+  long keys;  // the number of keys to pass through the ring
+  long burst;  // the most keys pushed back to back before the producer pauses
+  long workNanos;  // the time the consumer spends evaluating each key
+  uint64_t seed;  // the producer's random seed
+
+  // producer results
+  long fullCount;  // the pushes refused by a full ring, and retried
+  long scheduleCount;  // the drains scheduled
+
+  // consumer results
+  long consumed;  // the keys taken from the ring
+  long batches;  // the consume calls that took at least one key
+  long largestBatch;  // the most keys taken by one consume call
+  long outOfOrder;  // the keys that weren't the next one expected
+  int stalled;  // whether the consumer gave up waiting with keys still due
+} EWCKeyRingBenchRun;
+
+/**
+  Gets the current time from a monotonic clock.
+
+  @return The time in seconds.
+ */
+static double EWCKeyRingBenchNow(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+  Generates a pseudo-random number (xorshift64*).
+
+  @param state The generator state, which must not be zero.
+
+  @return The next number.
+ */
+static uint64_t EWCKeyRingBenchRandom(uint64_t *state) {
+  uint64_t x = *state;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  *state = x;
+
+  return x * 2685821657736338717ULL;
+}
+
+/**
+  Busy waits, standing in for the time taken to evaluate a key.
+
+  @param nanos The time to wait.
+ */
+static void EWCKeyRingBenchSpin(long nanos) {
+  if (nanos <= 0) {
+    return;
+  }
+
+  double until = EWCKeyRingBenchNow() + nanos / 1e9;
+  while (EWCKeyRingBenchNow() < until) {
+  }
+}
+
+/**
+  The key pushed for a given position in the stream.  The keys are only checked for their order, so they needn't be valid calculator keys.
+
+  @param index The position.
+
+  @return The key.
+ */
+static int32_t EWCKeyRingBenchKey(long index) {
+  return (int32_t)(index & 0x7fffffff);
+}
+
+/**
+  Pushes the keys in random bursts, as autorepeat and rapid taps would, scheduling a drain whenever the ring asks for one.
+
+  @param context The run.
+
+  @return NULL.
+ */
+static void *EWCKeyRingBenchProduce(void *context) {
+  EWCKeyRingBenchRun *run = context;
+  uint64_t state = run->seed ? run->seed : 1;
+
+  long index = 0;
+  while (index < run->keys) {
+    long burst = 1 + (long)(EWCKeyRingBenchRandom(&state) % (uint64_t)run->burst);
+    for (long i = 0; i < burst && index < run->keys; ++i, ++index) {
+      // the app catches up on the spot when the ring is full, but another
+      // thread can't, so wait for the consumer
+      while (! EWCKeyRingPush(&run->ring, EWCKeyRingBenchKey(index))) {
+        ++run->fullCount;
+        sched_yield();
+      }
+
+      if (EWCKeyRingRequestDrain(&run->ring)) {
+        ++run->scheduleCount;
+        sem_post(&run->scheduled);
+      }
+    }
+
+    // leave a gap between bursts now and then
+    if (EWCKeyRingBenchRandom(&state) % 4 == 0) {
+      sched_yield();
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  `EWCKeyRingConsumer` that checks each key arrives in order, and spends the evaluation time on it.
+ */
+static void EWCKeyRingBenchConsumeKey(int32_t key, void *context) {
+  EWCKeyRingBenchRun *run = context;
+
+  if (key != EWCKeyRingBenchKey(run->consumed)) {
+    ++run->outOfOrder;
+  }
+  ++run->consumed;
+
+  EWCKeyRingBenchSpin(run->workNanos);
+}
+
+/**
+  Waits for scheduled drains, and takes every waiting key in each, until all the keys have arrived.
+
+  @param context The run.
+
+  @return NULL.
+ */
+static void *EWCKeyRingBenchConsume(void *context) {
+  EWCKeyRingBenchRun *run = context;
+
+  while (run->consumed < run->keys) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += EWCKeyRingBenchStallSeconds;
+
+    int waited;
+    while ((waited = sem_timedwait(&run->scheduled, &deadline)) == -1 && errno == EINTR) {
+    }
+    if (waited == -1) {
+      // a key was pushed without anyone scheduling a drain for it
+      run->stalled = 1;
+      return NULL;
+    }
+
+    do {
+      uint32_t taken = EWCKeyRingConsume(&run->ring, EWCKeyRingBenchConsumeKey, run);
+      if (taken > 0) {
+        ++run->batches;
+        run->largestBatch = (taken > run->largestBatch) ? taken : run->largestBatch;
+      }
+    } while (EWCKeyRingFinishDrain(&run->ring));
+  }
+
+  return NULL;
+}
+
+/**
+  Prints the command line usage.
+
+  @param name The name the tool was run as.
+ */
+static void EWCKeyRingBenchUsage(const char *name) {
+  fprintf(stderr,
+    "usage: %s [-n keys] [-b burst] [-w nanos] [-r runs] [-s seed]\n"
+    "  -n  keys per run (default 1000000)\n"
+    "  -b  most keys pushed in a burst (default 32)\n"
+    "  -w  nanoseconds spent evaluating each key (default 0)\n"
+    "  -r  runs (default 10)\n"
+    "  -s  random seed (default from the clock)\n",
+    name);
+}
+
+int main(int argc, char * argv[]) {
+  long keys = 1000000;
+  long burst = 32;
+  long workNanos = 0;
+  long runs = 10;
+  uint64_t seed = (uint64_t)time(NULL);
+
+  int option;
+  while ((option = getopt(argc, argv, "n:b:w:r:s:h")) != -1) {
+    switch (option) {
+      case 'n': keys = atol(optarg); break;
+      case 'b': burst = atol(optarg); break;
+      case 'w': workNanos = atol(optarg); break;
+      case 'r': runs = atol(optarg); break;
+      case 's': seed = strtoull(optarg, NULL, 10); break;
+      default:
+        EWCKeyRingBenchUsage(argv[0]);
+        return (option == 'h') ? 0 : 2;
+    }
+  }
+
+  if (keys < 1 || burst < 1 || workNanos < 0 || runs < 1) {
+    EWCKeyRingBenchUsage(argv[0]);
+    return 2;
+  }
+
+  printf("seed: %llu\n", (unsigned long long)seed);
+  uint64_t state = seed ? seed : 1;
+
+  int failed = 0;
+  long totalKeys = 0;
+  long totalBatches = 0;
+  long totalSchedules = 0;
+  long totalFull = 0;
+  long largestBatch = 0;
+  double elapsed = 0;
+  for (long r = 0; r < runs && ! failed; ++r) {
+    static EWCKeyRingBenchRun run;
+    EWCKeyRingInit(&run.ring);
+    sem_init(&run.scheduled, 0, 0);
+    run.keys = keys;
+    run.burst = burst;
+    run.workNanos = workNanos;
+    run.seed = EWCKeyRingBenchRandom(&state);
+    run.fullCount = 0;
+    run.scheduleCount = 0;
+    run.consumed = 0;
+    run.batches = 0;
+    run.largestBatch = 0;
+    run.outOfOrder = 0;
+    run.stalled = 0;
+
+    double start = EWCKeyRingBenchNow();
+    pthread_t producer;
+    pthread_t consumer;
+    pthread_create(&consumer, NULL, EWCKeyRingBenchConsume, &run);
+    pthread_create(&producer, NULL, EWCKeyRingBenchProduce, &run);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+    elapsed += EWCKeyRingBenchNow() - start;
+
+    if (run.stalled || run.outOfOrder || run.consumed != keys
+      || EWCKeyRingCount(&run.ring) != 0 || atomic_load(&run.ring.droppedCount) != (uint64_t)run.fullCount) {
+      printf("run %ld failed: consumed %ld of %ld, %ld out of order, %u left%s\n",
+        r, run.consumed, keys, run.outOfOrder, EWCKeyRingCount(&run.ring),
+        run.stalled ? ", stranded" : "");
+      failed = 1;
+    }
+
+    totalKeys += run.consumed;
+    totalBatches += run.batches;
+    totalSchedules += run.scheduleCount;
+    totalFull += run.fullCount;
+    largestBatch = (run.largestBatch > largestBatch) ? run.largestBatch : largestBatch;
+
+    sem_destroy(&run.scheduled);
+  }
+
+  printf("keys:       %ld in %ld runs  (burst %ld, %ld ns/key)\n", totalKeys, runs, burst, workNanos);
+  printf("throughput: %.1f ns/key\n", elapsed / totalKeys * 1e9);
+  printf("drains:     %ld scheduled  batches: %ld  (%.1f keys/update, largest %ld)\n",
+    totalSchedules, totalBatches, (double)totalKeys / (totalBatches ? totalBatches : 1), largestBatch);
+  printf("full:       %ld pushes retried\n", totalFull);
+  printf("%s\n", failed ? "FAILED" : "ok");
+
+  return failed ? 1 : 0;
+}
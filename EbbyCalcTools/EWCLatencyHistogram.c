@@ -0,0 +1,95 @@
+//
+//  EWCLatencyHistogram.c
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "EWCLatencyHistogram.h"
+#include <string.h>
+
+/**
+  Finds the bucket for a value.  Values below the sub-bucket count get a bucket each, and above that each power of two is split evenly.
+
+  @param value The value.
+
+  @return The bucket index.
+ */
+static inline int EWCLatencyHistogramBucket(uint64_t value) {
+  if (value < EWCLatencyHistogramSubBuckets) {
+    return (int)value;
+  }
+
+  // the position of the highest bit, and the three bits below it
+  int high = 63 - __builtin_clzll(value);
+  int sub = (int)((value >> (high - 3)) & (EWCLatencyHistogramSubBuckets - 1));
+
+  return (high - 2) * EWCLatencyHistogramSubBuckets + sub;
+}
+
+/**
+  Finds the largest value that falls in a bucket.
+
+  @param bucket The bucket index.
+
+  @return The upper bound of the bucket.
+ */
+static inline uint64_t EWCLatencyHistogramUpperBound(int bucket) {
+  if (bucket < EWCLatencyHistogramSubBuckets) {
+    return (uint64_t)bucket;
+  }
+
+  int high = bucket / EWCLatencyHistogramSubBuckets + 2;
+  uint64_t sub = (uint64_t)(bucket % EWCLatencyHistogramSubBuckets);
+  uint64_t lower = ((uint64_t)EWCLatencyHistogramSubBuckets + sub) << (high - 3);
+
+  return lower + ((uint64_t)1 << (high - 3)) - 1;
+}
+
+void EWCLatencyHistogramClear(EWCLatencyHistogram *histogram) {
+  memset(histogram, 0, sizeof(*histogram));
+}
+
+void EWCLatencyHistogramRecord(EWCLatencyHistogram *histogram, uint64_t value) {
+  ++histogram->counts[EWCLatencyHistogramBucket(value)];
+  ++histogram->total;
+  if (value > histogram->maximum) {
+    histogram->maximum = value;
+  }
+}
+
+uint64_t EWCLatencyHistogramPercentile(const EWCLatencyHistogram *histogram, double percentile) {
+  if (histogram->total == 0) {
+    return 0;
+  }
+
+  // the rank of the value at the percentile, counting from 1
+  uint64_t rank = (uint64_t)(percentile / 100.0 * (double)histogram->total + 0.5);
+  if (rank < 1) { rank = 1; }
+  if (rank > histogram->total) { rank = histogram->total; }
+
+  uint64_t seen = 0;
+  for (int i = 0; i < EWCLatencyHistogramBuckets; ++i) {
+    seen += histogram->counts[i];
+    if (seen >= rank) {
+      uint64_t bound = EWCLatencyHistogramUpperBound(i);
+      return (bound < histogram->maximum) ? bound : histogram->maximum;
+    }
+  }
+
+  return histogram->maximum;
+}
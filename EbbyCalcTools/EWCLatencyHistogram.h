@@ -0,0 +1,67 @@
+//
+//  EWCLatencyHistogram.h
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef EWCLatencyHistogram_h
+#define EWCLatencyHistogram_h
+
+#include <stdint.h>
+
+// the number of sub-buckets each power of two is divided into
+#define EWCLatencyHistogramSubBuckets 8
+
+// the total number of buckets, covering every 64 bit value
+#define EWCLatencyHistogramBuckets (64 * EWCLatencyHistogramSubBuckets)
+
+/**
+  `EWCLatencyHistogram` counts latencies in log-linear buckets (each power of two split into eight), so that percentiles can be read with bounded error (12.5%) in constant space no matter how many values are recorded.
+ */
+typedef struct {
+  uint64_t counts[EWCLatencyHistogramBuckets];  // the values recorded in each bucket
+  uint64_t total;  // the number of values recorded
+  uint64_t maximum;  // the largest value recorded
+} EWCLatencyHistogram;
+
+/**
+  Removes all recorded values.
+
+  @param histogram The histogram to clear.
+ */
+void EWCLatencyHistogramClear(EWCLatencyHistogram *histogram);
+
+/**
+  Records a value.
+
+  @param histogram The histogram to record into.
+  @param value The value, typically in nanoseconds.
+ */
+void EWCLatencyHistogramRecord(EWCLatencyHistogram *histogram, uint64_t value);
+
+/**
+  Gets the value at a percentile.
+
+  @param histogram The histogram to read.
+  @param percentile The percentile, from 0 to 100.
+
+  @return The upper bound of the bucket holding the percentile (capped at the largest value recorded), or 0 if nothing has been recorded.
+ */
+uint64_t EWCLatencyHistogramPercentile(const EWCLatencyHistogram *histogram, double percentile);
+
+#endif /* EWCLatencyHistogram_h */
@@ -0,0 +1,192 @@
+//
+//  EWCLayoutBenchMain.c
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "EWCLayoutSolver.h"
+
+/**
+  `EWCLayoutBenchOrientation` lists the widths the app snaps to in Split View and Slide Over for one orientation of an iPad.
+ */
+typedef struct {
+  double height;  // the app height
+  double widths[4];  // the app widths
+  int widthCount;  // the number of widths
+} EWCLayoutBenchOrientation;
+
+static const EWCLayoutBenchOrientation s_orientations[] = {
+  { 768, { 320, 507, 694, 1024 }, 4 },
+  { 1024, { 320, 438, 768 }, 3 },
+};
+
+/**
+  Gets the current time from a monotonic clock.
+
+  @return The time in seconds.
+ */
+static double EWCLayoutBenchNow(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+  Generates a pseudo-random number (xorshift64*).
+
+  @param state The generator state, which must not be zero.
+
+  @return The next number.
+ */
+static uint64_t EWCLayoutBenchRandom(uint64_t *state) {
+  uint64_t x = *state;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  *state = x;
+
+  return x * 2685821657736338717ULL;
+}
+
+/**
+  Compares two solutions.
+
+  @param a The first solution.
+  @param b The second solution.
+
+  @return Whether every dimension, size, and frame agrees.
+ */
+static int EWCLayoutBenchSame(const EWCLayoutSolution *a, const EWCLayoutSolution *b) {
+  if (a->mode != b->mode || a->grid != b->grid
+    || a->displayFontSize != b->displayFontSize || a->gridTopConstant != b->gridTopConstant
+    || a->textFontSize != b->textFontSize || a->digitFontSize != b->digitFontSize
+    || a->operatorFontSize != b->operatorFontSize || a->statusFontSize != b->statusFontSize
+    || a->statusInset != b->statusInset) {
+    return 0;
+  }
+
+  for (int i = 0; i < a->grid->placementCount; ++i) {
+    if (a->frames[i].x != b->frames[i].x || a->frames[i].y != b->frames[i].y
+      || a->frames[i].width != b->frames[i].width || a->frames[i].height != b->frames[i].height) {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+/**
+  Prints the command line usage.
+
+  @param name The name the tool was run as.
+ */
+static void EWCLayoutBenchUsage(const char *name) {
+  fprintf(stderr,
+    "usage: %s [-n events] [-s seed]\n"
+    "  -n  resize events (default 1000000)\n"
+    "  -s  random seed (default from the clock)\n",
+    name);
+}
+
+int main(int argc, char * argv[]) {
+  long events = 1000000;
+  uint64_t seed = (uint64_t)time(NULL);
+
+  int option;
+  while ((option = getopt(argc, argv, "n:s:h")) != -1) {
+    switch (option) {
+      case 'n': events = atol(optarg); break;
+      case 's': seed = strtoull(optarg, NULL, 10); break;
+      default:
+        EWCLayoutBenchUsage(argv[0]);
+        return (option == 'h') ? 0 : 2;
+    }
+  }
+
+  if (events < 1) {
+    EWCLayoutBenchUsage(argv[0]);
+    return 2;
+  }
+
+  printf("seed: %llu\n", (unsigned long long)seed);
+  uint64_t state = seed ? seed : 1;
+
+  // a resize mostly moves between a few snapped sizes, but sometimes passes
+  // through sizes that aren't seen again, as while dragging the divider
+  double *widths = malloc((size_t)events * sizeof(double));
+  double *heights = malloc((size_t)events * sizeof(double));
+  size_t orientationCount = sizeof(s_orientations) / sizeof(s_orientations[0]);
+  const EWCLayoutBenchOrientation *orientation = &s_orientations[0];
+  for (long i = 0; i < events; ++i) {
+    if (EWCLayoutBenchRandom(&state) % 64 == 0) {
+      orientation = &s_orientations[EWCLayoutBenchRandom(&state) % orientationCount];
+    }
+    heights[i] = orientation->height;
+    widths[i] = (EWCLayoutBenchRandom(&state) % 20 == 0)
+      ? 320 + (double)(EWCLayoutBenchRandom(&state) % 704)
+      : orientation->widths[EWCLayoutBenchRandom(&state) % (uint64_t)orientation->widthCount];
+  }
+
+  // sum a value from each solution, so that the solving can't be skipped
+  double solveSum = 0;
+  EWCLayoutSolution solution;
+  double start = EWCLayoutBenchNow();
+  for (long i = 0; i < events; ++i) {
+    EWCLayoutSolve(&solution, widths[i], heights[i], 20);
+    solveSum += solution.frames[5].x;
+  }
+  double solveTime = EWCLayoutBenchNow() - start;
+
+  static EWCLayoutCache cache;
+  EWCLayoutCacheClear(&cache);
+  double cacheSum = 0;
+  start = EWCLayoutBenchNow();
+  for (long i = 0; i < events; ++i) {
+    cacheSum += EWCLayoutCacheSolve(&cache, widths[i], heights[i], 20)->frames[5].x;
+  }
+  double cacheTime = EWCLayoutBenchNow() - start;
+
+  // every remembered solution must be the one solving would give
+  long mismatches = 0;
+  EWCLayoutCacheClear(&cache);
+  for (long i = 0; i < events; ++i) {
+    const EWCLayoutSolution *cached = EWCLayoutCacheSolve(&cache, widths[i], heights[i], 20);
+    EWCLayoutSolve(&solution, widths[i], heights[i], 20);
+    if (! EWCLayoutBenchSame(cached, &solution)) {
+      ++mismatches;
+    }
+  }
+
+  printf("events:     %ld  cache hits: %.1f%%\n", events,
+    100.0 * (double)cache.hits / (double)cache.lookups);
+  printf("solve:      %.1f ns/event\n", solveTime / events * 1e9);
+  printf("cached:     %.1f ns/event\n", cacheTime / events * 1e9);
+  printf("mismatches: %ld%s\n", mismatches, solveSum == cacheSum ? "" : "  (results differ)");
+
+  free(widths);
+  free(heights);
+
+  return (mismatches > 0 || solveSum != cacheSum) ? 1 : 0;
+}
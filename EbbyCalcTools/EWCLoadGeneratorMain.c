@@ -0,0 +1,391 @@
+//
+//  EWCLoadGeneratorMain.c
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+  `EWCLoadOptions` holds the command line settings of the load generator.
+ */
+typedef struct {
+  const char *socketPath;  // the service socket
+  int connections;  // the number of concurrent client connections
+  int requests;  // the number of requests each connection sends
+  int depth;  // the number of requests each connection keeps in flight
+  int sessions;  // the number of sessions each connection drives
+} EWCLoadOptions;
+
+/**
+  `EWCLoadWorker` holds the state and results of one client connection.
+ */
+typedef struct {
+  const EWCLoadOptions *options;  // the shared settings
+  int index;  // which connection this is
+  double *latencies;  // the latency of each request, in seconds
+  int completed;  // the number of requests that got a response
+  int errors;  // the number of ERR responses
+  int failed;  // set if the connection failed
+} EWCLoadWorker;
+
+// the requests cycled through by each connection.  %s is the session name.
+static const char *s_requestFormats[] = {
+  "KEYS %s 12+34=\n",
+  "STATE %s\n",
+  "KEYS %s *3=s\n",
+  "SNAPSHOT %s\n",
+  "KEYS %s c5.25/7=\n",
+  "KEYS %s ac\n",
+};
+
+#define EWCLoadRequestFormatCount (sizeof(s_requestFormats) / sizeof(s_requestFormats[0]))
+
+/**
+  Gets the current time from a clock that doesn't jump.
+
+  @return The time in seconds.
+ */
+static double EWCLoadNow(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+  Connects to the service.
+
+  @param path The service socket path.
+
+  @return The connected socket, or -1 on failure.
+ */
+static int EWCLoadConnect(const char *path) {
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return -1;
+  }
+
+  if (connect(fd, (struct sockaddr *)&address, sizeof(address)) < 0) {
+    close(fd);
+    return -1;
+  }
+
+  return fd;
+}
+
+/**
+  Writes a whole buffer to a blocking socket.
+
+  @param fd The socket.
+  @param bytes The bytes to write.
+  @param length The number of bytes.
+
+  @return 0 on success, -1 on failure.
+ */
+static int EWCLoadWriteAll(int fd, const char *bytes, size_t length) {
+  while (length > 0) {
+    ssize_t count = write(fd, bytes, length);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+
+    bytes += count;
+    length -= (size_t)count;
+  }
+
+  return 0;
+}
+
+/**
+  Sends one line and waits for its one line response, for the setup and teardown requests.
+
+  @param fd The socket.
+  @param request The request line, including the terminator.
+
+  @return 0 if the response was OK, -1 otherwise.
+ */
+static int EWCLoadExchange(int fd, const char *request) {
+  if (EWCLoadWriteAll(fd, request, strlen(request)) < 0) {
+    return -1;
+  }
+
+  char response[256];
+  size_t length = 0;
+  while (length < sizeof(response)) {
+    ssize_t count = read(fd, response + length, 1);
+    if (count <= 0) {
+      return -1;
+    }
+    if (response[length] == '\n') {
+      break;
+    }
+    ++length;
+  }
+
+  return (length >= 2 && strncmp(response, "OK", 2) == 0) ? 0 : -1;
+}
+
+/**
+  Runs one client connection, keeping up to the pipeline depth of requests in flight and timing each one from send to response.
+
+  @param context The `EWCLoadWorker` for the connection.
+
+  @return NULL.
+ */
+static void *EWCLoadRunWorker(void *context) {
+  EWCLoadWorker *worker = context;
+  const EWCLoadOptions *options = worker->options;
+
+  int fd = EWCLoadConnect(options->socketPath);
+  if (fd < 0) {
+    worker->failed = 1;
+    return NULL;
+  }
+
+  char name[64];
+  char request[128];
+  for (int s = 0; s < options->sessions; ++s) {
+    snprintf(name, sizeof(name), "load-%d-%d", worker->index, s);
+    snprintf(request, sizeof(request), "OPEN %s\n", name);
+    if (EWCLoadExchange(fd, request) < 0) {
+      worker->failed = 1;
+      close(fd);
+      return NULL;
+    }
+  }
+
+  // send times of the requests in flight.  responses arrive in request order,
+  // so this is a simple ring.
+  double *sent = calloc((size_t)options->depth, sizeof(double));
+  int sentCount = 0;
+  int inFlight = 0;
+  int head = 0;
+
+  char buffer[16384];
+  int responseIsError = -1;  // -1 at the start of a response line
+
+  while (worker->completed < options->requests) {
+    // top up the pipeline, sending the new requests in a single write
+    size_t batchLength = 0;
+    char batch[8192];
+    while (inFlight < options->depth && sentCount < options->requests
+      && batchLength + sizeof(request) < sizeof(batch)) {
+      snprintf(name, sizeof(name), "load-%d-%d", worker->index, sentCount % options->sessions);
+      int length = snprintf(batch + batchLength, sizeof(batch) - batchLength,
+        s_requestFormats[sentCount % EWCLoadRequestFormatCount], name);
+
+      batchLength += (size_t)length;
+      sent[(head + inFlight) % options->depth] = EWCLoadNow();
+      ++inFlight;
+      ++sentCount;
+    }
+
+    if (batchLength > 0 && EWCLoadWriteAll(fd, batch, batchLength) < 0) {
+      worker->failed = 1;
+      break;
+    }
+
+    ssize_t count = read(fd, buffer, sizeof(buffer));
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      worker->failed = 1;
+      break;
+    }
+
+    // each newline completes the oldest request in flight
+    double now = EWCLoadNow();
+    for (ssize_t i = 0; i < count; ++i) {
+      if (responseIsError < 0) {
+        responseIsError = (buffer[i] == 'E');
+      }
+
+      if (buffer[i] == '\n') {
+        worker->latencies[worker->completed++] = now - sent[head];
+        worker->errors += responseIsError;
+        head = (head + 1) % options->depth;
+        --inFlight;
+        responseIsError = -1;
+      }
+    }
+  }
+
+  free(sent);
+
+  if (! worker->failed) {
+    for (int s = 0; s < options->sessions; ++s) {
+      snprintf(request, sizeof(request), "CLOSE load-%d-%d\n", worker->index, s);
+      EWCLoadExchange(fd, request);
+    }
+  }
+
+  close(fd);
+
+  return NULL;
+}
+
+/**
+  Orders latencies for sorting.
+ */
+static int EWCLoadCompareLatencies(const void *a, const void *b) {
+  double x = *(const double *)a;
+  double y = *(const double *)b;
+
+  return (x > y) - (x < y);
+}
+
+/**
+  Gets a percentile from sorted values, using the nearest rank.
+
+  @param sorted The sorted values.
+  @param count The number of values.
+  @param percentile The percentile to get, from 0 to 100.
+
+  @return The value at the percentile.
+ */
+static double EWCLoadPercentile(const double *sorted, size_t count, double percentile) {
+  if (count == 0) {
+    return 0;
+  }
+
+  size_t rank = (size_t)((percentile / 100.0) * count + 0.5);
+  if (rank < 1) {
+    rank = 1;
+  }
+  if (rank > count) {
+    rank = count;
+  }
+
+  return sorted[rank - 1];
+}
+
+/**
+  Prints the command line usage.
+
+  @param name The name the tool was run as.
+ */
+static void EWCLoadUsage(const char *name) {
+  fprintf(stderr,
+    "usage: %s [-s socket] [-c connections] [-n requests] [-p depth] [-k sessions]\n"
+    "  -s  path of the service socket (default /tmp/ebbycalc.sock)\n"
+    "  -c  concurrent connections (default 8)\n"
+    "  -n  requests per connection (default 10000)\n"
+    "  -p  requests kept in flight per connection (default 16)\n"
+    "  -k  sessions per connection (default 4)\n",
+    name);
+}
+
+int main(int argc, char * argv[]) {
+  EWCLoadOptions options = {
+    .socketPath = "/tmp/ebbycalc.sock",
+    .connections = 8,
+    .requests = 10000,
+    .depth = 16,
+    .sessions = 4,
+  };
+
+  int option;
+  while ((option = getopt(argc, argv, "s:c:n:p:k:h")) != -1) {
+    switch (option) {
+      case 's': options.socketPath = optarg; break;
+      case 'c': options.connections = atoi(optarg); break;
+      case 'n': options.requests = atoi(optarg); break;
+      case 'p': options.depth = atoi(optarg); break;
+      case 'k': options.sessions = atoi(optarg); break;
+      default:
+        EWCLoadUsage(argv[0]);
+        return (option == 'h') ? 0 : 2;
+    }
+  }
+
+  if (options.connections < 1 || options.requests < 1 || options.depth < 1 || options.sessions < 1) {
+    EWCLoadUsage(argv[0]);
+    return 2;
+  }
+
+  EWCLoadWorker *workers = calloc((size_t)options.connections, sizeof(EWCLoadWorker));
+  pthread_t *threads = calloc((size_t)options.connections, sizeof(pthread_t));
+
+  for (int i = 0; i < options.connections; ++i) {
+    workers[i].options = &options;
+    workers[i].index = i;
+    workers[i].latencies = calloc((size_t)options.requests, sizeof(double));
+  }
+
+  double start = EWCLoadNow();
+  for (int i = 0; i < options.connections; ++i) {
+    pthread_create(&threads[i], NULL, EWCLoadRunWorker, &workers[i]);
+  }
+  for (int i = 0; i < options.connections; ++i) {
+    pthread_join(threads[i], NULL);
+  }
+  double elapsed = EWCLoadNow() - start;
+
+  // gather every latency for the percentiles
+  size_t total = 0;
+  int errors = 0;
+  int failed = 0;
+  for (int i = 0; i < options.connections; ++i) {
+    total += (size_t)workers[i].completed;
+    errors += workers[i].errors;
+    failed += workers[i].failed;
+  }
+
+  double *all = malloc((total ? total : 1) * sizeof(double));
+  size_t offset = 0;
+  for (int i = 0; i < options.connections; ++i) {
+    memcpy(all + offset, workers[i].latencies, (size_t)workers[i].completed * sizeof(double));
+    offset += (size_t)workers[i].completed;
+    free(workers[i].latencies);
+  }
+  qsort(all, total, sizeof(double), EWCLoadCompareLatencies);
+
+  printf("connections: %d  depth: %d  sessions: %d\n",
+    options.connections, options.depth, options.connections * options.sessions);
+  printf("requests:    %zu  errors: %d  failed connections: %d\n", total, errors, failed);
+  printf("elapsed:     %.3f s\n", elapsed);
+  printf("throughput:  %.0f requests/s\n", elapsed > 0 ? total / elapsed : 0);
+  printf("latency p50: %.1f us\n", EWCLoadPercentile(all, total, 50) * 1e6);
+  printf("latency p99: %.1f us\n", EWCLoadPercentile(all, total, 99) * 1e6);
+  printf("latency max: %.1f us\n", total ? all[total - 1] * 1e6 : 0);
+
+  free(all);
+  free(threads);
+  free(workers);
+
+  return (failed > 0) ? 1 : 0;
+}
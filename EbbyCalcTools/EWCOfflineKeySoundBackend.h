@@ -0,0 +1,106 @@
+//
+//  EWCOfflineKeySoundBackend.h
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import "EWCKeySoundBackendProtocol.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCOfflineKeySoundBackend` stands in for the audio output, mixing only when asked to render and keeping a summary of what it heard instead of playing it, so that the key sound engine can be exercised and measured without audio hardware.
+ */
+@interface EWCOfflineKeySoundBackend : NSObject<EWCKeySoundBackendProtocol>
+
+/**
+  Whether a render block has been started (and not stopped).
+ */
+@property (nonatomic, readonly, getter=isRunning) BOOL running;
+
+/**
+  The frames per second requested by the render block.
+ */
+@property (nonatomic, readonly) double sampleRate;
+
+/**
+  The number of frames in each buffer rendered, like the buffer size of real output.
+ */
+@property (nonatomic, readonly) uint32_t bufferFrameCount;
+
+/**
+  The number of frames rendered.
+ */
+@property (nonatomic, readonly) uint64_t renderedFrameCount;
+
+/**
+  The number of frames rendered in buffers with something playing.
+ */
+@property (nonatomic, readonly) uint64_t audibleFrameCount;
+
+/**
+  The largest absolute sample value rendered.
+ */
+@property (nonatomic, readonly) float peakLevel;
+
+/**
+  The sum of every sample value rendered, as a cheap fingerprint of the output.
+ */
+@property (nonatomic, readonly) double sampleSum;
+
+/**
+  Creates a new backend.
+
+  @param bufferFrameCount The number of frames in each buffer rendered.
+
+  @return The new backend.
+ */
++ (instancetype)backendWithBufferFrameCount:(uint32_t)bufferFrameCount;
+
+/**
+  Initializes a backend.
+
+  @param bufferFrameCount The number of frames in each buffer rendered.
+
+  @return The initialized instance.
+ */
+- (instancetype)initWithBufferFrameCount:(uint32_t)bufferFrameCount;
+
+/**
+  Renders a number of frames, a buffer at a time, as output would while that much time passed.  Does nothing if not running.
+
+  @param frameCount The number of frames to render.
+ */
+- (void)renderFrames:(uint64_t)frameCount;
+
+/**
+  Renders the frames that would play in an interval.
+
+  @param interval The time to render, in seconds.
+ */
+- (void)renderInterval:(NSTimeInterval)interval;
+
+/**
+  Clears the summary of what has been rendered.
+ */
+- (void)resetStatistics;
+
+@end
+
+NS_ASSUME_NONNULL_END
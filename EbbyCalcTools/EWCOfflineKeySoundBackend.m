@@ -0,0 +1,116 @@
+//
+//  EWCOfflineKeySoundBackend.m
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCOfflineKeySoundBackend.h"
+#include <math.h>
+
+@interface EWCOfflineKeySoundBackend() {
+  EWCKeySoundRenderBlock _renderBlock;  // the running render block, or nil
+  float *_buffer;  // receives each buffer of interleaved stereo frames
+}
+
+@end
+
+@implementation EWCOfflineKeySoundBackend
+
+///----------------------------------------------
+/// @name Construction and Initialization Methods
+///----------------------------------------------
+
++ (instancetype)backendWithBufferFrameCount:(uint32_t)bufferFrameCount {
+  return [[EWCOfflineKeySoundBackend alloc] initWithBufferFrameCount:bufferFrameCount];
+}
+
+- (instancetype)init {
+  return [self initWithBufferFrameCount:256];
+}
+
+- (instancetype)initWithBufferFrameCount:(uint32_t)bufferFrameCount {
+  self = [super init];
+  if (self) {
+    _bufferFrameCount = MAX(bufferFrameCount, 1);
+    _buffer = malloc(sizeof(float) * 2 * _bufferFrameCount);
+  }
+
+  return self;
+}
+
+- (void)dealloc {
+  free(_buffer);
+}
+
+///-----------------------------------------
+/// @name EWCKeySoundBackendProtocol Methods
+///-----------------------------------------
+
+- (BOOL)isRunning {
+  return _renderBlock != nil;
+}
+
+- (BOOL)startWithSampleRate:(double)sampleRate renderBlock:(EWCKeySoundRenderBlock)renderBlock {
+  _sampleRate = sampleRate;
+  _renderBlock = [renderBlock copy];
+  return YES;
+}
+
+- (void)stop {
+  _renderBlock = nil;
+}
+
+///------------------------
+/// @name Rendering Methods
+///------------------------
+
+- (void)renderFrames:(uint64_t)frameCount {
+  if (! _renderBlock) {
+    return;
+  }
+
+  while (frameCount > 0) {
+    uint32_t count = (frameCount < _bufferFrameCount) ? (uint32_t)frameCount : _bufferFrameCount;
+    BOOL audible = _renderBlock(_buffer, count);
+
+    if (audible) {
+      for (uint32_t i = 0; i < 2 * count; ++i) {
+        float value = _buffer[i];
+        _sampleSum += value;
+        _peakLevel = MAX(_peakLevel, fabsf(value));
+      }
+      _audibleFrameCount += count;
+    }
+
+    _renderedFrameCount += count;
+    frameCount -= count;
+  }
+}
+
+- (void)renderInterval:(NSTimeInterval)interval {
+  [self renderFrames:(uint64_t)llround(interval * _sampleRate)];
+}
+
+- (void)resetStatistics {
+  _renderedFrameCount = 0;
+  _audibleFrameCount = 0;
+  _peakLevel = 0;
+  _sampleSum = 0;
+}
+
+@end
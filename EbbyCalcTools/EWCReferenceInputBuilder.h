@@ -1,9 +1,9 @@
 //
-//  EWCDecimalInputBuilder.h
-//  EbbyCalc
+//  EWCReferenceInputBuilder.h
+//  EbbyCalcTools
 //
-//  Created by Ansel Rognlie on 11/24/19.
-//  Copyright © 2019 Ansel Rognlie. All rights reserved.
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
 //
 
 //  This program is free software: you can redistribute it and/or modify
@@ -24,7 +24,7 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
-@interface EWCDecimalInputBuilder : NSObject
+@interface EWCReferenceInputBuilder : NSObject
 
 /**
   The number of digits to allow in the value.
@@ -1,9 +1,9 @@
 //
-//  EWCDecimalInputBuilder.m
-//  EbbyCalc
+//  EWCReferenceInputBuilder.m
+//  EbbyCalcTools
 //
-//  Created by Ansel Rognlie on 11/24/19.
-//  Copyright © 2019 Ansel Rognlie. All rights reserved.
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
 //
 
 //  This program is free software: you can redistribute it and/or modify
@@ -19,20 +19,20 @@
 //  You should have received a copy of the GNU General Public License
 //  along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
-#import "EWCDecimalInputBuilder.h"
+#import "EWCReferenceInputBuilder.h"
 #import "NSDecimalNumber+EWCMathCategory.h"
 
 /**
-  `EWCCalculatorInputMode` tracks whether the input state is receiving digits that are part of the whole number, or the fraction.
+  `EWCReferenceInputMode` tracks whether the input state is receiving digits that are part of the whole number, or the fraction.
  */
-typedef NS_ENUM(NSInteger, EWCCalculatorInputMode) {
-  EWCCalculatorInputModeWhole = 1,
-  EWCCalculatorInputModeFraction,
+typedef NS_ENUM(NSInteger, EWCReferenceInputMode) {
+  EWCReferenceInputModeWhole = 1,
+  EWCReferenceInputModeFraction,
 };
 
-@interface EWCDecimalInputBuilder () {
+@interface EWCReferenceInputBuilder () {
   BOOL _editing;  // NO when user hasn't contributed to input yet
-  EWCCalculatorInputMode _inputMode;  // track whether input digits are for the whole or fractional part of a number
+  EWCReferenceInputMode _inputMode;  // track whether input digits are for the whole or fractional part of a number
   short _fractionPower;  // power of the fractional digit being added.  ranges from 0 to more negative values.  treated as the power of ten of the next fraction digit
   short _sign;  // the sign of the number being built up in the display
   short _numDigits;  // the number of digits accumulated in the input display
@@ -41,7 +41,7 @@ typedef NS_ENUM(NSInteger, EWCCalculatorInputMode) {
 
 @end
 
-@implementation EWCDecimalInputBuilder
+@implementation EWCReferenceInputBuilder
 
 ///-------------------
 /// @name Initializers
@@ -79,7 +79,7 @@ typedef NS_ENUM(NSInteger, EWCCalculatorInputMode) {
 ///---------------------
 
 - (void)clear {
-  _inputMode = EWCCalculatorInputModeWhole;
+  _inputMode = EWCReferenceInputModeWhole;
   _fractionPower = 0;
   _sign = 1;
   _numDigits = 0;
@@ -138,7 +138,7 @@ typedef NS_ENUM(NSInteger, EWCCalculatorInputMode) {
   }
 
   switch (_inputMode) {
-    case EWCCalculatorInputModeWhole: {
+    case EWCReferenceInputModeWhole: {
       // add to the whole number part by decimal left shifting the number we have so far
       NSDecimalNumber *decimalDigit = [[NSDecimalNumber alloc] initWithInt:digit];
       NSDecimalNumber *tmp = [_value decimalNumberByMultiplyingByPowerOf10:1];
@@ -146,7 +146,7 @@ typedef NS_ENUM(NSInteger, EWCCalculatorInputMode) {
     }
     break;
 
-    case EWCCalculatorInputModeFraction: {
+    case EWCReferenceInputModeFraction: {
       // if we had no digits, then this is the first, so increment again, as we
       // must have a leading zero
       if (! _numDigits) {
@@ -187,9 +187,9 @@ typedef NS_ENUM(NSInteger, EWCCalculatorInputMode) {
   }
 
   // do we already have a decimal
-  if (_inputMode != EWCCalculatorInputModeWhole) { return; }
+  if (_inputMode != EWCReferenceInputModeWhole) { return; }
 
-  _inputMode = EWCCalculatorInputModeFraction;
+  _inputMode = EWCReferenceInputModeFraction;
   _fractionPower = 0;
 }
 
@@ -223,7 +223,7 @@ typedef NS_ENUM(NSInteger, EWCCalculatorInputMode) {
   }
 
   switch (_inputMode) {
-    case EWCCalculatorInputModeWhole: {
+    case EWCReferenceInputModeWhole: {
       // shift down by a power of ten then round away the decimal
       value = [value decimalNumberByMultiplyingByPowerOf10:-1];
 
@@ -242,7 +242,7 @@ typedef NS_ENUM(NSInteger, EWCCalculatorInputMode) {
     }
     break;
 
-    case EWCCalculatorInputModeFraction: {
+    case EWCReferenceInputModeFraction: {
       _fractionPower++;
 
       // remove the final digit by rounding down the final power
@@ -258,7 +258,7 @@ typedef NS_ENUM(NSInteger, EWCCalculatorInputMode) {
       value = [value decimalNumberByRoundingAccordingToBehavior:formatter];
 
       if (_fractionPower == 0) {
-        _inputMode = EWCCalculatorInputModeWhole;
+        _inputMode = EWCReferenceInputModeWhole;
 
         // numDigits can be off if there was no whole part, so do a hard check for zero here
         if ([value compare:[NSDecimalNumber zero]] == NSOrderedSame) {
@@ -1,9 +1,9 @@
 //
-//  EWCNumericField.h
-//  EbbyCalc
+//  EWCReferenceNumericField.h
+//  EbbyCalcTools
 //
-//  Created by Ansel Rognlie on 11/4/19.
-//  Copyright © 2019 Ansel Rognlie. All rights reserved.
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
 //
 
 //  This program is free software: you can redistribute it and/or modify
@@ -24,11 +24,11 @@
 NS_ASSUME_NONNULL_BEGIN
 
 /**
-  `EWCNumericField` represents a storage area in the calculator for a numeric value.
+  `EWCReferenceNumericField` represents a storage area in the calculator for a numeric value.
 
   In practice, this idea was under-developed, but it's not bad enough to rip out.
  */
-@interface EWCNumericField : NSObject
+@interface EWCReferenceNumericField : NSObject
 
 /**
   Whether the field is empty.  If the field reports itself as empty, the value must be ignored.
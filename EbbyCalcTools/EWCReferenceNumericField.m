@@ -1,9 +1,9 @@
 //
-//  EWCNumericField.m
-//  EbbyCalc
+//  EWCReferenceNumericField.m
+//  EbbyCalcTools
 //
-//  Created by Ansel Rognlie on 11/4/19.
-//  Copyright © 2019 Ansel Rognlie. All rights reserved.
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
 //
 
 //  This program is free software: you can redistribute it and/or modify
@@ -19,9 +19,9 @@
 //  You should have received a copy of the GNU General Public License
 //  along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
-#import "EWCNumericField.h"
+#import "EWCReferenceNumericField.h"
 
-@implementation EWCNumericField
+@implementation EWCReferenceNumericField
 
 - (instancetype)init {
   self = [super init];
@@ -1,9 +1,9 @@
 //
-//  EWCCalculatorToken.h
-//  EbbyCalc
+//  EWCReferenceToken.h
+//  EbbyCalcTools
 //
-//  Created by Ansel Rognlie on 11/5/19.
-//  Copyright © 2019 Ansel Rognlie. All rights reserved.
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
 //
 
 //  This program is free software: you can redistribute it and/or modify
@@ -26,19 +26,19 @@
 NS_ASSUME_NONNULL_BEGIN
 
 /**
-  `EWCCalculatorTokenType` categorizes the type of data stored in a `EWCCalculatorToken`.
+  `EWCReferenceTokenType` categorizes the type of data stored in a `EWCReferenceToken`.
  */
-typedef NS_ENUM(NSInteger, EWCCalculatorTokenType) {
-  EWCCalculatorEmptyTokenType = 0,
-  EWCCalculatorBinOpTokenType,
-  EWCCalculatorDataTokenType,
-  EWCCalculatorEqualTokenType,
+typedef NS_ENUM(NSInteger, EWCReferenceTokenType) {
+  EWCReferenceEmptyTokenType = 0,
+  EWCReferenceBinOpTokenType,
+  EWCReferenceDataTokenType,
+  EWCReferenceEqualTokenType,
 };
 
 /**
-  `EWCCalculatorToken` represents an input in the calculator's operation key.
+  `EWCReferenceToken` represents an input in the calculator's operation key.
  */
-@interface EWCCalculatorToken : NSObject
+@interface EWCReferenceToken : NSObject
 
 ///-----------------
 /// @name Properties
@@ -47,7 +47,7 @@ typedef NS_ENUM(NSInteger, EWCCalculatorTokenType) {
 /**
   The type of token content
  */
-@property (nonatomic, readonly) EWCCalculatorTokenType tokenType;
+@property (nonatomic, readonly) EWCReferenceTokenType tokenType;
 
 /**
   The numeric value for a token holding data.
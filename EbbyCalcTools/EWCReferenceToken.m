@@ -1,9 +1,9 @@
 //
-//  EWCCalculatorToken.m
-//  EbbyCalc
+//  EWCReferenceToken.m
+//  EbbyCalcTools
 //
-//  Created by Ansel Rognlie on 11/5/19.
-//  Copyright © 2019 Ansel Rognlie. All rights reserved.
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
 //
 
 //  This program is free software: you can redistribute it and/or modify
@@ -19,21 +19,21 @@
 //  You should have received a copy of the GNU General Public License
 //  along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
-#import "EWCCalculatorToken.h"
+#import "EWCReferenceToken.h"
 
-@interface EWCCalculatorToken ()
+@interface EWCReferenceToken ()
 
 // redeclare readonly properties as writable for internal access
-@property (nonatomic, readwrite) EWCCalculatorTokenType tokenType;
+@property (nonatomic, readwrite) EWCReferenceTokenType tokenType;
 @property (nonatomic, readwrite) NSDecimalNumber *data;
 @property (nonatomic, readwrite) EWCCalculatorOpcode opcode;
 
 @end
 
 // holds a shared static instance of an empty token
-static EWCCalculatorToken *s_empty = nil;
+static EWCReferenceToken *s_empty = nil;
 
-@implementation EWCCalculatorToken
+@implementation EWCReferenceToken
 
 ///-------------------------
 /// @name Static initializer
@@ -43,7 +43,7 @@ static EWCCalculatorToken *s_empty = nil;
   Called the first time a message is sent to this class (more or less).  Initialize statics.
  */
 + (void)initialize {
-  s_empty = [EWCCalculatorToken new];
+  s_empty = [EWCReferenceToken new];
 }
 
 
@@ -52,15 +52,15 @@ static EWCCalculatorToken *s_empty = nil;
 ///---------------------------------------------------------------------------
 
 + (instancetype)tokenWithData:(NSDecimalNumber *)data {
-  return [[EWCCalculatorToken alloc] initWithData:data];
+  return [[EWCReferenceToken alloc] initWithData:data];
 }
 
 + (instancetype)tokenWithBinOp:(EWCCalculatorOpcode)opcode {
-  return [[EWCCalculatorToken alloc] initWithBinOp:opcode];
+  return [[EWCReferenceToken alloc] initWithBinOp:opcode];
 }
 
 + (instancetype)tokenWithEqual:(EWCCalculatorOpcode)opcode {
-  return [[EWCCalculatorToken alloc] initWithEqual:opcode];
+  return [[EWCReferenceToken alloc] initWithEqual:opcode];
 }
 
 + (instancetype)empty {
@@ -70,7 +70,7 @@ static EWCCalculatorToken *s_empty = nil;
 - (instancetype)init {
   self = [super init];
   if (self) {
-    self.tokenType = EWCCalculatorEmptyTokenType;
+    self.tokenType = EWCReferenceEmptyTokenType;
   }
   return self;
 }
@@ -78,7 +78,7 @@ static EWCCalculatorToken *s_empty = nil;
 - (instancetype)initWithData:(NSDecimalNumber *)data {
   self = [super init];
   if (self) {
-    self.tokenType = EWCCalculatorDataTokenType;
+    self.tokenType = EWCReferenceDataTokenType;
     self.data = data;
   }
   return self;
@@ -87,7 +87,7 @@ static EWCCalculatorToken *s_empty = nil;
 - (instancetype)initWithBinOp:(EWCCalculatorOpcode)opcode {
   self = [super init];
   if (self) {
-    self.tokenType = EWCCalculatorBinOpTokenType;
+    self.tokenType = EWCReferenceBinOpTokenType;
     self.opcode = opcode;
   }
   return self;
@@ -96,7 +96,7 @@ static EWCCalculatorToken *s_empty = nil;
 - (instancetype)initWithEqual:(EWCCalculatorOpcode)opcode {
   self = [super init];
   if (self) {
-    self.tokenType = EWCCalculatorEqualTokenType;
+    self.tokenType = EWCReferenceEqualTokenType;
     self.opcode = opcode;
   }
   return self;
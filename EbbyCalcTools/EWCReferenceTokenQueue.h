@@ -1,9 +1,9 @@
 //
-//  EWCTokenQueue.h
-//  EbbyCalc
+//  EWCReferenceTokenQueue.h
+//  EbbyCalcTools
 //
-//  Created by Ansel Rognlie on 11/22/19.
-//  Copyright © 2019 Ansel Rognlie. All rights reserved.
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
 //
 
 //  This program is free software: you can redistribute it and/or modify
@@ -20,11 +20,11 @@
 //  along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #import <Foundation/Foundation.h>
-#import "EWCCalculatorToken.h"
+#import "EWCReferenceToken.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
-@interface EWCTokenQueue : NSObject
+@interface EWCReferenceTokenQueue : NSObject
 
 /**
   Whether there was a change to the queue since the last time this property was checked.
@@ -64,14 +64,14 @@ NS_ASSUME_NONNULL_BEGIN
 
   @return The next token in the queue, if it matches the requested type.  Returns nil if there is no token, or the type does not match.
  */
-- (EWCCalculatorToken *)nextTokenAs:(EWCCalculatorTokenType)tokenType;
+- (EWCReferenceToken *)nextTokenAs:(EWCReferenceTokenType)tokenType;
 
 /**
   Returns the next token in the operation, auto-advancing the instruction pointer to the next token in the process.
 
   @return The token at the current instruction pointer.  This is logically removed from the queue, but still present until commited.  A subsequent pushback would return it to the head of the queue.
  */
-- (EWCCalculatorToken *)nextToken;
+- (EWCReferenceToken *)nextToken;
 
 /**
   Removes the token at the current instruction pointer from the operation queue entirely, returning it.
@@ -80,7 +80,7 @@ NS_ASSUME_NONNULL_BEGIN
 
   @return The token at the current instruction pointer (now removed from the queue), or nil if the queue is empty or the instruction pointer is at the end of the queue.
  */
-- (EWCCalculatorToken *)popToken;
+- (EWCReferenceToken *)popToken;
 
 /**
   Prior to committing a parse, this will "pushback" the last read by moving the instruction pointer towards the front of the queue.
@@ -121,7 +121,7 @@ NS_ASSUME_NONNULL_BEGIN
 
   @return The token at the end of the operation queue, or nil if empty.
  */
-- (EWCCalculatorToken *)getLastToken;
+- (EWCReferenceToken *)getLastToken;
 
 /**
   Removes the final token from the end of the operation queue.
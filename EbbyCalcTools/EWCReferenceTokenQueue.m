@@ -1,9 +1,9 @@
 //
-//  EWCTokenQueue.m
-//  EbbyCalc
+//  EWCReferenceTokenQueue.m
+//  EbbyCalcTools
 //
-//  Created by Ansel Rognlie on 11/22/19.
-//  Copyright © 2019 Ansel Rognlie. All rights reserved.
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
 //
 
 //  This program is free software: you can redistribute it and/or modify
@@ -19,17 +19,17 @@
 //  You should have received a copy of the GNU General Public License
 //  along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
-#import "EWCTokenQueue.h"
+#import "EWCReferenceTokenQueue.h"
 
-@interface EWCTokenQueue () {
-  NSMutableArray<EWCCalculatorToken *> *_queue;  // queue of tokens to be interpreted as calculator operations
+@interface EWCReferenceTokenQueue () {
+  NSMutableArray<EWCReferenceToken *> *_queue;  // queue of tokens to be interpreted as calculator operations
   short _ip;  // an instruction pointer for looking into the token queue.  used for cleaning up tokens we have used
   BOOL _didChange;  // whether the queue has changed since it was last inspected for tokens
 }
 
 @end
 
-@implementation EWCTokenQueue
+@implementation EWCReferenceTokenQueue
 
 /**
   Designated initializer.
@@ -37,7 +37,7 @@
 - (instancetype)init {
   self = [super init];
   if (self) {
-    _queue = [NSMutableArray<EWCCalculatorToken *> new];
+    _queue = [NSMutableArray<EWCReferenceToken *> new];
     _ip = 0;
     _didChange = NO;
     _hasError = NO;
@@ -66,10 +66,10 @@
   _ip = 0;
 }
 
-- (EWCCalculatorToken *)nextTokenAs:(EWCCalculatorTokenType)tokenType {
+- (EWCReferenceToken *)nextTokenAs:(EWCReferenceTokenType)tokenType {
   if (_queue.count == 0 || _ip >= _queue.count) { return nil; }
 
-  EWCCalculatorToken *token = _queue[_ip];
+  EWCReferenceToken *token = _queue[_ip];
   if (token.tokenType == tokenType) {
     ++_ip;
   } else {
@@ -79,20 +79,20 @@
   return token;
 }
 
-- (EWCCalculatorToken *)nextToken {
+- (EWCReferenceToken *)nextToken {
   if (_queue.count == 0 || _ip >= _queue.count) { return nil; }
 
-  EWCCalculatorToken *token = _queue[_ip];
+  EWCReferenceToken *token = _queue[_ip];
   ++_ip;
 
   return token;
 }
 
-- (EWCCalculatorToken *)popToken {
+- (EWCReferenceToken *)popToken {
   if (_queue.count == 0 || _ip >= _queue.count) { return nil; }
 
   // get the token, then remove it from the queue
-  EWCCalculatorToken *token = _queue[_ip];
+  EWCReferenceToken *token = _queue[_ip];
   [_queue removeObjectAtIndex:_ip];
 
   // return *without* advancing the ip
@@ -110,15 +110,15 @@
   // just replace it (user changed mind about operator)
   BOOL replaced = NO;
   if (_queue.count > 0) {
-    EWCCalculatorToken *last = _queue[_queue.count - 1];
-    if (last.tokenType == EWCCalculatorBinOpTokenType) {
-      _queue[_queue.count - 1] = [EWCCalculatorToken tokenWithBinOp:op];
+    EWCReferenceToken *last = _queue[_queue.count - 1];
+    if (last.tokenType == EWCReferenceBinOpTokenType) {
+      _queue[_queue.count - 1] = [EWCReferenceToken tokenWithBinOp:op];
       replaced = YES;
     }
   }
 
   if (! replaced) {
-    [_queue addObject:[EWCCalculatorToken tokenWithBinOp:op]];
+    [_queue addObject:[EWCReferenceToken tokenWithBinOp:op]];
   }
 
   _didChange = YES;
@@ -129,14 +129,14 @@
   // should not allow back to back equal tokens
   // they get removed due to processing, so a back to back equal is strange
   if (_queue.count > 0) {
-    EWCCalculatorToken *last = _queue[_queue.count - 1];
-    if (last.tokenType == EWCCalculatorEqualTokenType) {
+    EWCReferenceToken *last = _queue[_queue.count - 1];
+    if (last.tokenType == EWCReferenceEqualTokenType) {
       _hasError = YES;
       return;
     }
   }
 
-  [_queue addObject:[EWCCalculatorToken tokenWithEqual:op]];
+  [_queue addObject:[EWCReferenceToken tokenWithEqual:op]];
 
   _didChange = YES;
 }
@@ -147,21 +147,21 @@
   // just replace it (user could have been working with memory or rate)
   BOOL replaced = NO;
   if (_queue.count > 0) {
-    EWCCalculatorToken *last = _queue[_queue.count - 1];
-    if (last.tokenType == EWCCalculatorDataTokenType) {
-      _queue[_queue.count - 1] = [EWCCalculatorToken tokenWithData:data];
+    EWCReferenceToken *last = _queue[_queue.count - 1];
+    if (last.tokenType == EWCReferenceDataTokenType) {
+      _queue[_queue.count - 1] = [EWCReferenceToken tokenWithData:data];
       replaced = YES;
     }
   }
 
   if (! replaced) {
-    [_queue addObject:[EWCCalculatorToken tokenWithData:data]];
+    [_queue addObject:[EWCReferenceToken tokenWithData:data]];
   }
 
   _didChange = YES;
 }
 
-- (EWCCalculatorToken *)getLastToken {
+- (EWCReferenceToken *)getLastToken {
   if (_queue.count > 0) {
     return _queue[_queue.count - 1];
   }
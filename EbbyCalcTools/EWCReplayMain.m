@@ -0,0 +1,283 @@
+//
+//  EWCReplayMain.m
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import <stdio.h>
+#import <stdlib.h>
+#import <time.h>
+#import <unistd.h>
+#import "EWCCalculator.h"
+#import "EWCKeyStreamRecorder.h"
+#import "EWCKeyStreamReplayer.h"
+
+// the keys per second a recording is meant to be processed at, which the
+// measured rate is reported against
+#define EWCReplayTargetRate 10000000
+
+/**
+  Gets the current time from a clock that doesn't jump.
+
+  @return The time in seconds.
+ */
+static NSTimeInterval EWCReplayNow(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+  Advances a xorshift generator, so that generated recordings are repeatable from a seed.
+
+  @param state The generator state.  Must not be zero.
+
+  @return The next value.
+ */
+static uint64_t EWCReplayNextRandom(uint64_t *state) {
+  uint64_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  *state = x;
+
+  return x;
+}
+
+/**
+  Records a calculator pressing random keys, weighted towards digits so that the inputs resemble real use.
+
+  @param path The file to receive the recording.
+  @param keyCount The number of keys to press.
+  @param seed The random seed.
+  @param maximumDigits The maximum digits of the calculator.
+
+  @return YES if the recording was written.
+ */
+static BOOL EWCReplayGenerate(const char *path, NSUInteger keyCount, uint64_t seed, NSInteger maximumDigits) {
+  static const EWCCalculatorKey s_operators[] = {
+    EWCCalculatorAddKey, EWCCalculatorSubtractKey, EWCCalculatorMultiplyKey,
+    EWCCalculatorDivideKey, EWCCalculatorEqualKey, EWCCalculatorDecimalKey,
+    EWCCalculatorSignKey, EWCCalculatorPercentKey, EWCCalculatorSqrtKey,
+    EWCCalculatorMemoryPlusKey, EWCCalculatorMemoryKey, EWCCalculatorBackspaceKey,
+    EWCCalculatorTaxPlusKey, EWCCalculatorClearKey,
+  };
+  static const NSUInteger s_operatorCount = sizeof(s_operators) / sizeof(s_operators[0]);
+
+  EWCCalculator *calculator = [EWCCalculator calculator];
+  calculator.maximumDigits = maximumDigits;
+
+  NSOutputStream *stream = [NSOutputStream outputStreamToFileAtPath:@(path) append:NO];
+  EWCKeyStreamRecorder *recorder = [EWCKeyStreamRecorder recorderWithOutputStream:stream];
+
+  // a steady simulated typing rate, so that the output depends only on the seed
+  __block uint64_t time = 0;
+  recorder.clock = ^{
+    return time;
+  };
+
+  if (! [recorder startRecordingCalculator:calculator]) {
+    return NO;
+  }
+
+  uint64_t state = seed ? seed : 1;
+  for (NSUInteger i = 0; i < keyCount; ++i) {
+    uint64_t r = EWCReplayNextRandom(&state);
+    time += 80 + (r >> 32) % 200;
+
+    EWCCalculatorKey key = (r % 3)
+      ? (EWCCalculatorKey)((r >> 8) % 10)
+      : s_operators[(r >> 8) % s_operatorCount];
+    [calculator pressKey:key];
+  }
+
+  BOOL finished = [recorder finish];
+  fprintf(stdout, "wrote %lu keys in %lu bytes (%.2f bytes per key)\n",
+    (unsigned long)recorder.keyCount,
+    (unsigned long)recorder.bytesWritten,
+    recorder.keyCount ? (double)recorder.bytesWritten / recorder.keyCount : 0.0);
+
+  return finished;
+}
+
+/**
+  Writes the inputs held by a trace buffer to a file, as trace event JSON.
+
+  @param buffer The buffer.
+  @param path The file to write.
+
+  @return YES if the trace was written.
+ */
+static BOOL EWCReplayWriteTrace(const EWCTraceBuffer *buffer, const char *path) {
+  FILE *file = fopen(path, "w");
+  if (! file) {
+    perror(path);
+    return NO;
+  }
+
+  BOOL written = EWCTraceBufferWriteJSON(buffer, file);
+  written = (fclose(file) == 0) && written;
+  if (! written) {
+    fprintf(stderr, "can't write the trace to %s\n", path);
+  }
+
+  return written;
+}
+
+/**
+  Prints the command line usage.
+
+  @param name The name the tool was run as.
+ */
+static void EWCReplayUsage(const char *name) {
+  fprintf(stderr,
+    "usage: %s [-x] [-p passes] [-m rate] [-t trace [-k keys] [-l micros]] file\n"
+    "       %s -g keys [-s seed] [-d digits] file\n"
+    "  -x  only decode the recording, without replaying it through a calculator\n"
+    "  -p  number of times to run through the recording (default 1)\n"
+    "  -m  fail if fewer keys than this are processed per second, rather than only reporting against %d\n"
+    "  -t  write a timeline of the last keys replayed to this file, as trace event JSON\n"
+    "  -k  number of keys the timeline keeps (default 256)\n"
+    "  -l  stop the timeline at the first key slower than this, in microseconds\n"
+    "  -g  generate a recording of random keys instead of replaying\n"
+    "  -s  random seed for generating (default 1)\n"
+    "  -d  maximum digits for generating (default 16)\n",
+    name, name, EWCReplayTargetRate);
+}
+
+int main(int argc, char * argv[]) {
+  @autoreleasepool {
+    BOOL decodeOnly = NO;
+    NSUInteger passes = 1;
+    NSUInteger generateCount = 0;
+    uint64_t seed = 1;
+    NSInteger maximumDigits = 16;
+    const char *tracePath = NULL;
+    long traceKeys = 256;
+    double slowMicros = 0;
+    double minimumRate = 0;
+
+    int option;
+    while ((option = getopt(argc, argv, "xp:m:g:s:d:t:k:l:h")) != -1) {
+      switch (option) {
+        case 'x': decodeOnly = YES; break;
+        case 'p': passes = (NSUInteger)atol(optarg); break;
+        case 'm': minimumRate = atof(optarg); break;
+        case 'g': generateCount = (NSUInteger)atol(optarg); break;
+        case 's': seed = strtoull(optarg, NULL, 10); break;
+        case 'd': maximumDigits = atol(optarg); break;
+        case 't': tracePath = optarg; break;
+        case 'k': traceKeys = atol(optarg); break;
+        case 'l': slowMicros = atof(optarg); break;
+        default:
+          EWCReplayUsage(argv[0]);
+          return (option == 'h') ? 0 : 2;
+      }
+    }
+
+    if (optind != argc - 1 || traceKeys < 1 || slowMicros < 0 || minimumRate < 0 || (tracePath && decodeOnly)) {
+      EWCReplayUsage(argv[0]);
+      return 2;
+    }
+
+    const char *path = argv[optind];
+
+    if (generateCount) {
+      return EWCReplayGenerate(path, generateCount, seed, maximumDigits) ? 0 : 1;
+    }
+
+    NSData *data = [NSData dataWithContentsOfFile:@(path)];
+    if (! data) {
+      perror(path);
+      return 1;
+    }
+
+    EWCKeyStreamReplayer *replayer = [EWCKeyStreamReplayer replayerWithData:data];
+
+    // the buffer carries on across passes, so that it holds the last keys
+    // replayed, or the keys leading up to the first slow one
+    EWCTraceBuffer trace;
+    if (tracePath) {
+      if (! EWCTraceBufferInit(&trace, (uint32_t)traceKeys)) {
+        fprintf(stderr, "can't allocate a trace of %ld keys\n", traceKeys);
+        return 1;
+      }
+      EWCTraceBufferSetFreezeThreshold(&trace, (uint64_t)(slowMicros * 1000));
+      replayer.traceBuffer = &trace;
+    }
+
+    BOOL succeeded = YES;
+    NSTimeInterval start = EWCReplayNow();
+    for (NSUInteger i = 0; i < passes; ++i) {
+      @autoreleasepool {
+        succeeded = decodeOnly ? [replayer decode] : [replayer replay];
+      }
+    }
+    NSTimeInterval elapsed = EWCReplayNow() - start;
+
+    NSUInteger keys = replayer.keyCount * passes;
+    double rate = elapsed > 0 ? keys / elapsed : 0.0;
+    fprintf(stdout, "%lu keys, %lu inputs, %lu checkpoints, %.1f s recorded\n",
+      (unsigned long)replayer.keyCount,
+      (unsigned long)replayer.inputCount,
+      (unsigned long)replayer.checkpointCount,
+      replayer.recordedDuration / 1000.0);
+    fprintf(stdout, "%s %lu keys in %.3f s (%.0f keys/s)\n",
+      decodeOnly ? "decoded" : "replayed",
+      (unsigned long)keys, elapsed, rate);
+
+    // a replay runs every key through the calculator, and is reported
+    // against the same target as decoding, so a shortfall is plain to see
+    double target = (minimumRate > 0) ? minimumRate : EWCReplayTargetRate;
+    BOOL met = (rate >= target);
+    fprintf(stdout, "%s the target of %.0f keys/s (%.2fx)\n",
+      met ? "met" : "missed", target, rate / target);
+    if (minimumRate > 0 && ! met) {
+      succeeded = NO;
+    }
+
+    if (tracePath) {
+      fprintf(stdout, "slowest key %llu took %.1f us%s\n",
+        (unsigned long long)trace.slowestSequence,
+        trace.slowestDuration / 1000.0,
+        trace.frozen ? ", and stopped the trace" : "");
+      if (EWCReplayWriteTrace(&trace, tracePath)) {
+        fprintf(stdout, "wrote a trace of %u keys to %s\n", EWCTraceBufferKeyCount(&trace), tracePath);
+      } else {
+        succeeded = NO;
+      }
+
+      replayer.calculator.traceBuffer = NULL;
+      replayer.traceBuffer = NULL;
+      EWCTraceBufferFree(&trace);
+    }
+
+    if (replayer.isCorrupt) {
+      fprintf(stderr, "recording is damaged after key %lu\n", (unsigned long)replayer.keyCount);
+    }
+    if (replayer.failedCheckpointCount) {
+      fprintf(stderr, "%lu checkpoints failed, first after key %lu\n",
+        (unsigned long)replayer.failedCheckpointCount,
+        (unsigned long)replayer.firstFailedKeyIndex);
+    }
+
+    return succeeded ? 0 : 1;
+  }
+}
@@ -0,0 +1,288 @@
+//
+//  EWCResultsBenchMain.m
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import <stdio.h>
+#import <stdlib.h>
+#import <time.h>
+#import <unistd.h>
+#import "EWCCalculator.h"
+#import "EWCFuzzGenerator.h"
+#import "EWCResultColumnReader.h"
+#import "EWCResultColumnWriter.h"
+
+/**
+  Gets the current time from a clock that doesn't jump.
+
+  @return The time in seconds.
+ */
+static NSTimeInterval EWCResultsBenchNow(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+  Checks whether two values are the same, treating NaN as matching NaN.
+
+  @param a The first value.
+  @param b The second value.
+
+  @return YES if the values match.
+ */
+static BOOL EWCResultsBenchValuesMatch(NSDecimal a, NSDecimal b) {
+  BOOL aNaN = NSDecimalIsNotANumber(&a);
+  BOOL bNaN = NSDecimalIsNotANumber(&b);
+  if (aNaN || bNaN) {
+    return aNaN && bNaN;
+  }
+
+  return NSDecimalCompare(&a, &b) == NSOrderedSame;
+}
+
+/**
+  Checks whether a row read back holds what was written.
+
+  @param a The row read.
+  @param b The row written.
+
+  @return YES if the rows match.
+ */
+static BOOL EWCResultsBenchRowsMatch(const EWCResultRow *a, const EWCResultRow *b) {
+  return a->sessionID == b->sessionID
+    && a->keyCount == b->keyCount
+    && EWCResultsBenchValuesMatch(a->display, b->display)
+    && EWCResultsBenchValuesMatch(a->memory, b->memory)
+    && a->error == b->error
+    && a->status == b->status;
+}
+
+/**
+  Gets the size of a file.
+
+  @param path The path of the file.
+
+  @return The size in bytes, or 0 if the file can't be found.
+ */
+static unsigned long long EWCResultsBenchFileSize(NSString *path) {
+  return [[NSFileManager defaultManager] attributesOfItemAtPath:path error:NULL].fileSize;
+}
+
+/**
+  Prints the command line usage.
+
+  @param name The name the tool was run as.
+ */
+static void EWCResultsBenchUsage(const char *name) {
+  fprintf(stderr,
+    "usage: %s [-n sessions] [-k keys] [-b rows] [-s seed] [-d digits] [-o file]\n"
+    "  -n  number of sessions (default 100000)\n"
+    "  -k  keys pressed in each session (default 32)\n"
+    "  -b  rows per block of the columnar results (default 4096)\n"
+    "  -s  random seed for the keys (default 1)\n"
+    "  -d  maximum digits (default 16)\n"
+    "  -o  keep the columnar results in this file (default a temporary file)\n",
+    name);
+}
+
+int main(int argc, char * argv[]) {
+  @autoreleasepool {
+    NSUInteger sessionCount = 100000;
+    NSUInteger keysPerSession = 32;
+    uint32_t rowsPerBlock = 4096;
+    uint64_t seed = 1;
+    NSInteger maximumDigits = 16;
+    const char *outputPath = NULL;
+
+    int option;
+    while ((option = getopt(argc, argv, "n:k:b:s:d:o:h")) != -1) {
+      switch (option) {
+        case 'n': sessionCount = (NSUInteger)atol(optarg); break;
+        case 'k': keysPerSession = (NSUInteger)atol(optarg); break;
+        case 'b': rowsPerBlock = (uint32_t)atol(optarg); break;
+        case 's': seed = strtoull(optarg, NULL, 10); break;
+        case 'd': maximumDigits = atol(optarg); break;
+        case 'o': outputPath = optarg; break;
+        default:
+          EWCResultsBenchUsage(argv[0]);
+          return (option == 'h') ? 0 : 2;
+      }
+    }
+
+    if (optind != argc || sessionCount == 0 || keysPerSession == 0 || rowsPerBlock == 0) {
+      EWCResultsBenchUsage(argv[0]);
+      return 2;
+    }
+
+    printf("seed: %llu\n", (unsigned long long)seed);
+
+    NSString *temporary = [NSTemporaryDirectory() stringByAppendingPathComponent:
+      [NSString stringWithFormat:@"ebbycalc-results-%d", getpid()]];
+    NSString *textPath = [temporary stringByAppendingPathExtension:@"txt"];
+    NSString *columnPath = outputPath ? @(outputPath) : [temporary stringByAppendingPathExtension:@"ewcr"];
+
+    FILE *text = fopen(textPath.fileSystemRepresentation, "w");
+    EWCResultColumnWriter *writer = [EWCResultColumnWriter
+      writerWithOutputStream:[NSOutputStream outputStreamToFileAtPath:columnPath append:NO]
+      rowsPerBlock:rowsPerBlock];
+    if (! text) {
+      fprintf(stderr, "can't write %s\n", textPath.fileSystemRepresentation);
+      return 1;
+    }
+
+    EWCCalculator *calculator = [EWCCalculator calculator];
+    calculator.maximumDigits = maximumDigits;
+
+    EWCFuzzGenerator generator;
+    EWCFuzzGeneratorInit(&generator, seed, maximumDigits);
+
+    NSMutableData *keyData = [NSMutableData dataWithLength:keysPerSession * sizeof(EWCCalculatorKey)];
+    EWCCalculatorKey *keys = keyData.mutableBytes;
+    NSMutableData *expectedData = [NSMutableData dataWithLength:sessionCount * sizeof(EWCResultRow)];
+    EWCResultRow *expected = expectedData.mutableBytes;
+
+    // each session's results are written both ways, timing only the writing
+    NSTimeInterval textTime = 0;
+    NSTimeInterval columnTime = 0;
+    BOOL writeFailed = NO;
+    for (NSUInteger s = 0; s < sessionCount; ++s) {
+      @autoreleasepool {
+        EWCFuzzGeneratorFill(&generator, keys, keysPerSession);
+        [calculator reset];
+        for (NSUInteger i = 0; i < keysPerSession; ++i) {
+          [calculator pressKey:keys[i]];
+        }
+
+        NSTimeInterval start = EWCResultsBenchNow();
+        fprintf(text, "%lu\t%s\t%s\t%d\t%d%d%d%d%d%d\t%lu\n",
+          (unsigned long)s,
+          calculator.displayContent.UTF8String,
+          calculator.memoryValue.description.UTF8String,
+          calculator.hasError,
+          calculator.hasMemory,
+          calculator.isTaxStatusVisible,
+          calculator.isTaxPlusStatusVisible,
+          calculator.isTaxMinusStatusVisible,
+          calculator.isTaxPercentStatusVisible,
+          calculator.isRateShifted,
+          (unsigned long)keysPerSession);
+        NSTimeInterval middle = EWCResultsBenchNow();
+        writeFailed |= ! [writer appendSessionID:s keyCount:keysPerSession calculator:calculator];
+        NSTimeInterval end = EWCResultsBenchNow();
+
+        textTime += middle - start;
+        columnTime += end - middle;
+      }
+    }
+
+    NSTimeInterval start = EWCResultsBenchNow();
+    writeFailed |= (fclose(text) != 0);
+    NSTimeInterval middle = EWCResultsBenchNow();
+    writeFailed |= ! [writer finish];
+    NSTimeInterval end = EWCResultsBenchNow();
+    textTime += middle - start;
+    columnTime += end - middle;
+
+    // the expected rows are gathered by running the sessions again, so that
+    // gathering them isn't part of either output's time
+    EWCResultColumnReader *reader = [EWCResultColumnReader readerWithContentsOfFile:columnPath];
+    NSUInteger mismatches = 0;
+    NSTimeInterval readTime = 0;
+    NSTimeInterval scanTime = 0;
+    NSUInteger scannedErrors = 0;
+    if (! reader || ! reader.isFinished || reader.rowCount != sessionCount) {
+      fprintf(stderr, "results file has %lu rows, expected %lu\n",
+        (unsigned long)reader.rowCount, (unsigned long)sessionCount);
+      mismatches = sessionCount;
+    } else {
+      EWCFuzzGeneratorInit(&generator, seed, maximumDigits);
+      for (NSUInteger s = 0; s < sessionCount; ++s) {
+        @autoreleasepool {
+          EWCFuzzGeneratorFill(&generator, keys, keysPerSession);
+          [calculator reset];
+          for (NSUInteger i = 0; i < keysPerSession; ++i) {
+            [calculator pressKey:keys[i]];
+          }
+
+          EWCResultRowFromCalculator(&expected[s], s, keysPerSession, calculator);
+        }
+      }
+
+      start = EWCResultsBenchNow();
+      for (NSUInteger s = 0; s < sessionCount; ++s) {
+        EWCResultRow row;
+        if (! [reader getRow:&row atIndex:s] || ! EWCResultsBenchRowsMatch(&row, &expected[s])) {
+          if (mismatches == 0) {
+            fprintf(stderr, "row %lu doesn't match session %lu\n", (unsigned long)s, (unsigned long)s);
+          }
+          ++mismatches;
+        }
+      }
+      readTime = EWCResultsBenchNow() - start;
+
+      // a downstream scan of a single column, counting the errors
+      start = EWCResultsBenchNow();
+      for (NSUInteger b = 0; b < reader.blockCount; ++b) {
+        uint32_t rowCount;
+        const uint8_t *errors = [reader bytesOfColumn:EWCResultErrorColumn inBlock:b rowCount:&rowCount];
+        for (uint32_t i = 0; errors && i < rowCount; ++i) {
+          scannedErrors += errors[i];
+        }
+      }
+      scanTime = EWCResultsBenchNow() - start;
+
+      if (scannedErrors != reader.errorCount) {
+        fprintf(stderr, "error column has %lu errors, the index %lu\n",
+          (unsigned long)scannedErrors, (unsigned long)reader.errorCount);
+        ++mismatches;
+      }
+    }
+
+    unsigned long long textSize = EWCResultsBenchFileSize(textPath);
+    unsigned long long columnSize = EWCResultsBenchFileSize(columnPath);
+
+    printf("sessions: %lu of %lu keys, %lu ended in error\n",
+      (unsigned long)sessionCount, (unsigned long)keysPerSession, (unsigned long)scannedErrors);
+    printf("text:     %.1f MB in %.3f s (%.2f us per session)\n",
+      textSize / 1e6, textTime, textTime * 1e6 / sessionCount);
+    printf("columnar: %.1f MB in %.3f s (%.2f us per session, %.1fx), %lu blocks of %u rows\n",
+      columnSize / 1e6, columnTime, columnTime * 1e6 / sessionCount,
+      columnTime > 0 ? textTime / columnTime : 0.0,
+      (unsigned long)writer.blockCount, writer.rowsPerBlock);
+    printf("read:     %lu rows in %.3f s (%.2f us per row), error column in %.2f ms\n",
+      (unsigned long)sessionCount, readTime, readTime * 1e6 / sessionCount, scanTime * 1e3);
+
+    [[NSFileManager defaultManager] removeItemAtPath:textPath error:NULL];
+    if (! outputPath) {
+      [[NSFileManager defaultManager] removeItemAtPath:columnPath error:NULL];
+    }
+
+    if (writeFailed) {
+      fprintf(stderr, "couldn't write the results\n");
+    }
+
+    BOOL failed = writeFailed || mismatches > 0;
+    printf("%s\n", failed ? "FAILED" : "ok");
+
+    return failed ? 1 : 0;
+  }
+}
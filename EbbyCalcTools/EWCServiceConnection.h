@@ -0,0 +1,100 @@
+//
+//  EWCServiceConnection.h
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+
+@class EWCServiceProtocol;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCServiceConnection` buffers the requests and responses of one client connection to the calculator service.
+
+  Clients may pipeline requests, sending many before reading any responses.  Every complete line read is performed in order, and the responses are queued in the same order, to be written as the socket accepts them.
+ */
+@interface EWCServiceConnection : NSObject
+
+/**
+  The non-blocking socket of the connection.
+ */
+@property (nonatomic, readonly) int fileDescriptor;
+
+/**
+  Whether there are queued responses that haven't been written.
+ */
+@property (nonatomic, readonly) BOOL hasPendingOutput;
+
+/**
+  Whether the connection will read more requests.  It stops while too many responses are waiting to be written, and the socket shouldn't be polled for input until they drain.
+ */
+@property (nonatomic, readonly) BOOL acceptsInput;
+
+/**
+  The number of bytes held in the output buffer, including any already written that haven't been reclaimed yet.
+ */
+@property (nonatomic, readonly) NSUInteger bufferedOutputLength;
+
+/**
+  Creates a new connection.
+
+  @param fileDescriptor The non-blocking socket of the connection.  The connection takes ownership of it.
+  @param protocol The interpreter that performs the requests.
+
+  @return The new connection.
+ */
++ (instancetype)connectionWithFileDescriptor:(int)fileDescriptor
+  protocol:(EWCServiceProtocol *)protocol;
+
+/**
+  Initializes a new connection.
+
+  @param fileDescriptor The non-blocking socket of the connection.  The connection takes ownership of it.
+  @param protocol The interpreter that performs the requests.
+
+  @return The initialized connection.
+ */
+- (instancetype)initWithFileDescriptor:(int)fileDescriptor
+  protocol:(EWCServiceProtocol *)protocol;
+
+/**
+  Reads what is available from the socket, up to a few reads at a time, performs every complete request, and tries to write the responses.
+
+  @param now The current time.
+
+  @return NO if the client has disconnected or the socket failed, in which case the connection should be closed.
+ */
+- (BOOL)readAvailableAtTime:(NSTimeInterval)now;
+
+/**
+  Writes as much of the queued responses as the socket will accept.
+
+  @return NO if the socket failed, in which case the connection should be closed.
+ */
+- (BOOL)writePending;
+
+/**
+  Closes the socket.
+ */
+- (void)close;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,231 @@
+//
+//  EWCServiceConnection.m
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCServiceConnection.h"
+#import "EWCServiceProtocol.h"
+#import <errno.h>
+#import <unistd.h>
+
+// the size of each read from the socket
+#define EWCServiceReadSize 16384
+
+// the most reads made for one connection each time poll wakes, so that one
+// busy client can't starve the others
+#define EWCServiceReadsPerWake 4
+
+// the longest request line accepted, to bound the memory a client can consume
+static const NSUInteger s_maximumRequestLength = 65536;
+
+// the most unwritten response bytes before the connection stops reading, so
+// that a client that pipelines without reading can't grow the output forever
+static const NSUInteger s_maximumPendingOutput = 1048576;
+
+// how much written output is kept before it is dropped from the front of the
+// buffer, so that a client that never lets the output drain completely can't
+// grow it with responses it has already read
+static const NSUInteger s_outputCompactionThreshold = 65536;
+
+@interface EWCServiceConnection () {
+  EWCServiceProtocol *_protocol;  // performs the requests
+  NSMutableData *_input;  // bytes read but not yet performed
+  NSMutableData *_output;  // responses not yet written
+  NSUInteger _outputOffset;  // how much of the output has been written
+}
+
+@end
+
+@implementation EWCServiceConnection
+
+///-------------------------------------
+/// @name Constructors and Initializers.
+///-------------------------------------
+
++ (instancetype)connectionWithFileDescriptor:(int)fileDescriptor
+  protocol:(EWCServiceProtocol *)protocol {
+  return [[EWCServiceConnection alloc] initWithFileDescriptor:fileDescriptor protocol:protocol];
+}
+
+- (instancetype)initWithFileDescriptor:(int)fileDescriptor
+  protocol:(EWCServiceProtocol *)protocol {
+  self = [super init];
+  if (self) {
+    _fileDescriptor = fileDescriptor;
+    _protocol = protocol;
+    _input = [NSMutableData new];
+    _output = [NSMutableData new];
+    _outputOffset = 0;
+  }
+
+  return self;
+}
+
+- (void)dealloc {
+  [self close];
+}
+
+///------------------------------
+/// @name Custom Property Methods
+///------------------------------
+
+- (BOOL)hasPendingOutput {
+  return _outputOffset < _output.length;
+}
+
+- (BOOL)acceptsInput {
+  return _output.length - _outputOffset < s_maximumPendingOutput;
+}
+
+- (NSUInteger)bufferedOutputLength {
+  return _output.length;
+}
+
+///---------------------------------------------------------------
+/// @name Public Properties and Methods (documented in the header)
+///---------------------------------------------------------------
+
+- (BOOL)readAvailableAtTime:(NSTimeInterval)now {
+  uint8_t buffer[EWCServiceReadSize];
+  int reads = 0;
+
+  // anything left unread is picked up the next time poll wakes
+  while (reads < EWCServiceReadsPerWake && self.acceptsInput) {
+    ssize_t count = read(_fileDescriptor, buffer, sizeof(buffer));
+    if (count > 0) {
+      ++reads;
+      [_input appendBytes:buffer length:(NSUInteger)count];
+
+      // perform each read as it arrives, so that an overlong request is
+      // caught before the next read adds to it
+      if (! [self performRequestsAtTime:now]) {
+        return NO;
+      }
+      continue;
+    }
+
+    if (count == 0) {
+      // the client closed its end, but still perform what it sent
+      [self performRequestsAtTime:now];
+      [self writePending];
+      return NO;
+    }
+
+    if (errno == EINTR) {
+      continue;
+    }
+
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      break;
+    }
+
+    return NO;
+  }
+
+  return [self writePending];
+}
+
+- (BOOL)writePending {
+  while (self.hasPendingOutput) {
+    const uint8_t *bytes = (const uint8_t *)_output.bytes + _outputOffset;
+    ssize_t count = write(_fileDescriptor, bytes, _output.length - _outputOffset);
+    if (count > 0) {
+      _outputOffset += (NSUInteger)count;
+      continue;
+    }
+
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+
+    if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      break;
+    }
+
+    return NO;
+  }
+
+  // reclaim the buffer once everything has been written, or the written
+  // part once there is enough of it to be worth moving the rest down
+  if (! self.hasPendingOutput) {
+    _output.length = 0;
+    _outputOffset = 0;
+  } else if (_outputOffset >= s_outputCompactionThreshold) {
+    [_output replaceBytesInRange:NSMakeRange(0, _outputOffset) withBytes:NULL length:0];
+    _outputOffset = 0;
+  }
+
+  return YES;
+}
+
+- (void)close {
+  if (_fileDescriptor >= 0) {
+    close(_fileDescriptor);
+    _fileDescriptor = -1;
+  }
+}
+
+///-------------------------
+/// @name Request Processing
+///-------------------------
+
+/**
+  Performs each complete request line in the input buffer, queueing the responses.
+
+  @param now The current time.
+
+  @return NO if the client sent a request that is too long.
+ */
+- (BOOL)performRequestsAtTime:(NSTimeInterval)now {
+  const uint8_t *bytes = _input.bytes;
+  NSUInteger length = _input.length;
+  NSUInteger start = 0;
+
+  for (NSUInteger i = 0; i < length; ++i) {
+    if (bytes[i] != '\n') {
+      continue;
+    }
+
+    // tolerate clients that send CRLF
+    NSUInteger end = (i > start && bytes[i - 1] == '\r') ? i - 1 : i;
+
+    @autoreleasepool {
+      NSString *request = [[NSString alloc] initWithBytes:bytes + start
+        length:end - start
+        encoding:NSUTF8StringEncoding];
+
+      NSString *response = (request)
+        ? [_protocol responseToRequest:request atTime:now]
+        : @"ERR request is not UTF-8";
+
+      NSData *encoded = [response dataUsingEncoding:NSUTF8StringEncoding];
+      [_output appendData:encoded];
+      [_output appendBytes:"\n" length:1];
+    }
+
+    start = i + 1;
+  }
+
+  // keep any partial request for the next read
+  [_input replaceBytesInRange:NSMakeRange(0, start) withBytes:NULL length:0];
+
+  return _input.length <= s_maximumRequestLength;
+}
+
+@end
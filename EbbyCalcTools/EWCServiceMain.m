@@ -0,0 +1,291 @@
+//
+//  EWCServiceMain.m
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import <errno.h>
+#import <fcntl.h>
+#import <poll.h>
+#import <signal.h>
+#import <stdio.h>
+#import <stdlib.h>
+#import <string.h>
+#import <sys/socket.h>
+#import <sys/un.h>
+#import <time.h>
+#import <unistd.h>
+#import "EWCServiceConnection.h"
+#import "EWCServiceProtocol.h"
+#import "EWCSessionManager.h"
+
+// how often (in seconds) to look for idle sessions
+static const NSTimeInterval s_evictionInterval = 1;
+
+// how often (in seconds) to flush the session slab
+static const NSTimeInterval s_syncInterval = 1;
+
+// set by the signal handler to stop the event loop
+static volatile sig_atomic_t s_stopRequested = 0;
+
+/**
+  Requests that the event loop stop.
+
+  @param signal The signal received.  Ignored.
+ */
+static void EWCServiceHandleStopSignal(int signal) {
+  s_stopRequested = 1;
+}
+
+/**
+  Gets the current time from a clock that doesn't jump.
+
+  @return The time in seconds.
+ */
+static NSTimeInterval EWCServiceNow(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+  Switches a socket to non-blocking mode.
+
+  @param fd The socket.
+
+  @return YES if successful.
+ */
+static BOOL EWCServiceSetNonBlocking(int fd) {
+  int flags = fcntl(fd, F_GETFL, 0);
+  return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+/**
+  Creates the listening socket.
+
+  @param path The filesystem path of the socket.  Any existing file at the path is replaced.
+
+  @return The socket, or -1 on failure.
+ */
+static int EWCServiceListen(const char *path) {
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (strlen(path) >= sizeof(address.sun_path)) {
+    fprintf(stderr, "socket path too long: %s\n", path);
+    return -1;
+  }
+  strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    perror("socket");
+    return -1;
+  }
+
+  unlink(path);
+  if (bind(fd, (struct sockaddr *)&address, sizeof(address)) < 0
+    || listen(fd, SOMAXCONN) < 0
+    || ! EWCServiceSetNonBlocking(fd)) {
+    perror(path);
+    close(fd);
+    return -1;
+  }
+
+  return fd;
+}
+
+/**
+  Prints the command line usage.
+
+  @param name The name the tool was run as.
+ */
+static void EWCServiceUsage(const char *name) {
+  fprintf(stderr,
+    "usage: %s [-s socket] [-i idle-seconds] [-l locale] [-d digits] [-p pool-size] [-f slab-file] [-c slab-sessions]\n"
+    "  -s  path of the Unix domain socket (default /tmp/ebbycalc.sock)\n"
+    "  -i  seconds a session may be idle before it is evicted, 0 for never (default 300)\n"
+    "  -l  locale identifier for display formatting (default en_US)\n"
+    "  -d  maximum digits (default 16)\n"
+    "  -p  maximum idle calculators kept for reuse (default 1024)\n"
+    "  -f  file to persist the sessions in, reattaching to those already in it (default none)\n"
+    "  -c  sessions a new slab file can hold (default 65536)\n",
+    name);
+}
+
+int main(int argc, char * argv[]) {
+  @autoreleasepool {
+    const char *socketPath = "/tmp/ebbycalc.sock";
+    NSTimeInterval idleTimeout = 300;
+    const char *localeIdentifier = "en_US";
+    NSInteger maximumDigits = 16;
+    NSUInteger poolSize = 1024;
+    const char *slabPath = NULL;
+    NSUInteger slabCapacity = 65536;
+
+    int option;
+    while ((option = getopt(argc, argv, "s:i:l:d:p:f:c:h")) != -1) {
+      switch (option) {
+        case 's': socketPath = optarg; break;
+        case 'i': idleTimeout = atof(optarg); break;
+        case 'l': localeIdentifier = optarg; break;
+        case 'd': maximumDigits = atol(optarg); break;
+        case 'p': poolSize = (NSUInteger)atol(optarg); break;
+        case 'f': slabPath = optarg; break;
+        case 'c': slabCapacity = (NSUInteger)atol(optarg); break;
+        default:
+          EWCServiceUsage(argv[0]);
+          return (option == 'h') ? 0 : 2;
+      }
+    }
+
+    NSLocale *locale = [NSLocale localeWithLocaleIdentifier:@(localeIdentifier)];
+    EWCSessionManager *manager = [EWCSessionManager managerWithLocale:locale
+      maximumDigits:maximumDigits];
+    manager.idleTimeout = idleTimeout;
+    manager.maximumPoolSize = poolSize;
+    EWCServiceProtocol *protocol = [EWCServiceProtocol protocolWithSessionManager:manager];
+
+    if (slabPath) {
+      NSTimeInterval start = EWCServiceNow();
+      int error = [manager attachSlabAtPath:@(slabPath) capacity:slabCapacity atTime:start];
+      if (error) {
+        fprintf(stderr, "%s: %s\n", slabPath, strerror(error));
+        return 1;
+      }
+
+      fprintf(stderr, "reattached %lu sessions from %s in %.2f ms\n",
+        (unsigned long)manager.sessionCount, slabPath, (EWCServiceNow() - start) * 1e3);
+    }
+
+    int listener = EWCServiceListen(socketPath);
+    if (listener < 0) {
+      return 1;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, EWCServiceHandleStopSignal);
+    signal(SIGTERM, EWCServiceHandleStopSignal);
+
+    fprintf(stderr, "listening on %s\n", socketPath);
+
+    NSMutableArray<EWCServiceConnection *> *connections = [NSMutableArray new];
+    NSMutableData *pollData = [NSMutableData new];
+    NSTimeInterval nextEviction = EWCServiceNow() + s_evictionInterval;
+    NSTimeInterval nextSync = EWCServiceNow() + s_syncInterval;
+
+    while (! s_stopRequested) {
+      @autoreleasepool {
+        // the listener is always the first entry, followed by the connections
+        // in the same order as the array
+        NSUInteger count = connections.count + 1;
+        pollData.length = count * sizeof(struct pollfd);
+        struct pollfd *fds = pollData.mutableBytes;
+
+        fds[0] = (struct pollfd){ .fd = listener, .events = POLLIN };
+        for (NSUInteger i = 0; i < connections.count; ++i) {
+          EWCServiceConnection *connection = connections[i];
+          // stop listening to a client that isn't reading its responses
+          short events = (connection.acceptsInput) ? POLLIN : 0;
+          if (connection.hasPendingOutput) {
+            events |= POLLOUT;
+          }
+          fds[i + 1] = (struct pollfd){ .fd = connection.fileDescriptor, .events = events };
+        }
+
+        int timeout = (int)(s_evictionInterval * 1000);
+        int ready = poll(fds, (nfds_t)count, timeout);
+        if (ready < 0 && errno != EINTR) {
+          perror("poll");
+          break;
+        }
+
+        NSTimeInterval now = EWCServiceNow();
+
+        // service the existing connections, collecting the ones that closed
+        NSMutableIndexSet *closed = [NSMutableIndexSet new];
+        for (NSUInteger i = 0; ready > 0 && i < connections.count; ++i) {
+          short revents = fds[i + 1].revents;
+          if (! revents) {
+            continue;
+          }
+
+          EWCServiceConnection *connection = connections[i];
+          BOOL open = YES;
+          if (revents & (POLLIN | POLLHUP | POLLERR)) {
+            open = [connection readAvailableAtTime:now];
+          }
+          if (open && (revents & POLLOUT)) {
+            open = [connection writePending];
+          }
+
+          if (! open) {
+            [connection close];
+            [closed addIndex:i];
+          }
+        }
+        [connections removeObjectsAtIndexes:closed];
+
+        // accept any new connections
+        if (ready > 0 && (fds[0].revents & POLLIN)) {
+          while (YES) {
+            int fd = accept(listener, NULL, NULL);
+            if (fd < 0) {
+              break;
+            }
+
+            if (! EWCServiceSetNonBlocking(fd)) {
+              close(fd);
+              continue;
+            }
+
+            [connections addObject:[EWCServiceConnection
+              connectionWithFileDescriptor:fd
+              protocol:protocol]];
+          }
+        }
+
+        if (now >= nextEviction) {
+          [manager evictIdleSessionsAtTime:now];
+          nextEviction = now + s_evictionInterval;
+        }
+
+        if (now >= nextSync) {
+          int error = [manager syncSlab];
+          if (error) {
+            fprintf(stderr, "sync: %s\n", strerror(error));
+          }
+          nextSync = now + s_syncInterval;
+        }
+      }
+    }
+
+    for (EWCServiceConnection *connection in connections) {
+      [connection close];
+    }
+
+    close(listener);
+    unlink(socketPath);
+
+    [manager detachSlab];
+  }
+
+  return 0;
+}
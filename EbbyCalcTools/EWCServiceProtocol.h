@@ -0,0 +1,77 @@
+//
+//  EWCServiceProtocol.h
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+
+@class EWCSessionManager;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCServiceProtocol` interprets the line-delimited request protocol of the calculator service, independent of the transport.
+
+  Each request is a single line of space separated words, and produces a single line response starting with `OK` or `ERR`.
+
+  | Request | Response |
+  | --- | --- |
+  | `OPEN <session>` | `OK` (opens the session, or reuses an open one), or `ERR` if the name is longer than 63 bytes of UTF-8 |
+  | `KEYS <session> <keys>` | `OK <display>` after pressing the keys (see `EWCCalculatorKeyFromCharacter`) |
+  | `STATE <session>` | `OK display=<display>` followed by the status flags |
+  | `SNAPSHOT <session>` | `OK value=<raw value> memory=<raw memory> display=<display>` followed by the status flags |
+  | `CLOSE <session>` | `OK` |
+  | `STATS` | `OK sessions=<count> pooled=<count> evicted=<count>` |
+  | `PING` | `OK` |
+
+  The status flags are written as `error=`, `hasmemory=`, `mclear=`, `tax=`, `taxplus=`, `taxminus=`, `taxpercent=`, and `shifted=`, each followed by 0 or 1.
+ */
+@interface EWCServiceProtocol : NSObject
+
+/**
+  Creates a new protocol interpreter.
+
+  @param manager The sessions that requests act on.
+
+  @return The new protocol interpreter.
+ */
++ (instancetype)protocolWithSessionManager:(EWCSessionManager *)manager;
+
+/**
+  Initializes a new protocol interpreter.
+
+  @param manager The sessions that requests act on.
+
+  @return The initialized protocol interpreter.
+ */
+- (instancetype)initWithSessionManager:(EWCSessionManager *)manager;
+
+/**
+  Performs a request.
+
+  @param request The request line, without the line terminator.
+  @param now The current time, used to track session activity.
+
+  @return The response line, without the line terminator.
+ */
+- (NSString *)responseToRequest:(NSString *)request atTime:(NSTimeInterval)now;
+
+@end
+
+NS_ASSUME_NONNULL_END
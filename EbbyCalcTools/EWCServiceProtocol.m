@@ -0,0 +1,218 @@
+//
+//  EWCServiceProtocol.m
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCServiceProtocol.h"
+#import "EWCSessionManager.h"
+#import "../EbbyCalc/EWCCalculator.h"
+#import <objc/runtime.h>
+
+// the number of keys in a request that can be handled without allocating
+#define EWCServiceKeyBufferSize 256
+
+@interface EWCServiceProtocol () {
+  EWCSessionManager *_manager;  // the sessions that requests act on
+}
+
+@end
+
+@implementation EWCServiceProtocol
+
+///-------------------------------------
+/// @name Constructors and Initializers.
+///-------------------------------------
+
++ (instancetype)protocolWithSessionManager:(EWCSessionManager *)manager {
+  return [[EWCServiceProtocol alloc] initWithSessionManager:manager];
+}
+
+- (instancetype)initWithSessionManager:(EWCSessionManager *)manager {
+  self = [super init];
+  if (self) {
+    _manager = manager;
+  }
+
+  return self;
+}
+
+///---------------------------------------------------------------
+/// @name Public Properties and Methods (documented in the header)
+///---------------------------------------------------------------
+
+- (NSString *)responseToRequest:(NSString *)request atTime:(NSTimeInterval)now {
+  NSArray<NSString *> *words = [self wordsFromRequest:request];
+  if (words.count == 0) {
+    return @"ERR empty request";
+  }
+
+  NSString *command = words[0].uppercaseString;
+
+  if ([command isEqualToString:@"PING"]) {
+    return @"OK";
+  }
+
+  if ([command isEqualToString:@"STATS"]) {
+    // an idle session is just its calculator, which holds all of its
+    // calculation state inline
+    return [NSString stringWithFormat:@"OK sessions=%lu pooled=%lu evicted=%lu persisted=%lu unpersisted=%lu session_bytes=%lu",
+      (unsigned long)_manager.sessionCount,
+      (unsigned long)_manager.pooledCount,
+      (unsigned long)_manager.evictedCount,
+      (unsigned long)_manager.persistedCount,
+      (unsigned long)_manager.unpersistedCount,
+      (unsigned long)class_getInstanceSize([EWCCalculator class])];
+  }
+
+  // everything else acts on a session
+  if (words.count < 2) {
+    return [NSString stringWithFormat:@"ERR %@ requires a session", command];
+  }
+
+  NSString *name = words[1];
+
+  if ([command isEqualToString:@"OPEN"]) {
+    return ([_manager openSessionNamed:name atTime:now])
+      ? @"OK"
+      : [NSString stringWithFormat:@"ERR bad session name %@", name];
+  }
+
+  if ([command isEqualToString:@"CLOSE"]) {
+    return ([_manager closeSessionNamed:name])
+      ? @"OK"
+      : [NSString stringWithFormat:@"ERR no session %@", name];
+  }
+
+  EWCCalculator *calculator = [_manager sessionNamed:name atTime:now];
+  if (! calculator) {
+    return [NSString stringWithFormat:@"ERR no session %@", name];
+  }
+
+  if ([command isEqualToString:@"KEYS"]) {
+    if (words.count < 3) {
+      return @"ERR KEYS requires keys";
+    }
+
+    NSString *response = [self responseToKeys:words[2] forCalculator:calculator];
+
+    // the keys of a request are stored together, since the client only learns
+    // of them through the response
+    [_manager storeSessionNamed:name];
+
+    return response;
+  }
+
+  if ([command isEqualToString:@"STATE"]) {
+    return [NSString stringWithFormat:@"OK display=%@ %@",
+      calculator.displayContent,
+      [self flagsForCalculator:calculator]];
+  }
+
+  if ([command isEqualToString:@"SNAPSHOT"]) {
+    return [NSString stringWithFormat:@"OK value=%@ memory=%@ display=%@ %@",
+      calculator.displayValue.stringValue,
+      calculator.memoryValue.stringValue,
+      calculator.displayContent,
+      [self flagsForCalculator:calculator]];
+  }
+
+  return [NSString stringWithFormat:@"ERR unknown command %@", command];
+}
+
+///-------------------------
+/// @name Request Processing
+///-------------------------
+
+/**
+  Splits a request into its non-empty words.
+
+  @param request The request line.
+
+  @return The words of the request.
+ */
+- (NSArray<NSString *> *)wordsFromRequest:(NSString *)request {
+  NSMutableArray<NSString *> *words = [NSMutableArray new];
+  for (NSString *word in [request componentsSeparatedByString:@" "]) {
+    if (word.length > 0) {
+      [words addObject:word];
+    }
+  }
+
+  return words;
+}
+
+/**
+  Presses a sequence of keys, as a single batch of changes.
+
+  @param keys The keys in plain text key notation.
+  @param calculator The calculator to press the keys on.
+
+  @return The response to the request.
+ */
+- (NSString *)responseToKeys:(NSString *)keys forCalculator:(EWCCalculator *)calculator {
+  NSUInteger length = keys.length;
+
+  // typical requests fit on the stack, but allow for long ones
+  unichar stackBuffer[EWCServiceKeyBufferSize];
+  NSMutableData *heapBuffer = nil;
+  unichar *characters = stackBuffer;
+  if (length > EWCServiceKeyBufferSize) {
+    heapBuffer = [NSMutableData dataWithLength:length * sizeof(unichar)];
+    characters = heapBuffer.mutableBytes;
+  }
+
+  [keys getCharacters:characters range:NSMakeRange(0, length)];
+
+  // validate everything before pressing anything, so a bad request has no
+  // effect
+  for (NSUInteger i = 0; i < length; ++i) {
+    if (EWCCalculatorKeyFromCharacter(characters[i]) == EWCCalculatorNoKey) {
+      return [NSString stringWithFormat:@"ERR bad key %C", characters[i]];
+    }
+  }
+
+  [calculator performBatchUpdates:^{
+    for (NSUInteger i = 0; i < length; ++i) {
+      [calculator pressKey:EWCCalculatorKeyFromCharacter(characters[i])];
+    }
+  }];
+
+  return [NSString stringWithFormat:@"OK %@", calculator.displayContent];
+}
+
+/**
+  Formats the status flags of a calculator.
+
+  @param calculator The calculator to describe.
+
+  @return The flags as space separated name=value pairs.
+ */
+- (NSString *)flagsForCalculator:(EWCCalculator *)calculator {
+  return [NSString stringWithFormat:@"error=%d hasmemory=%d mclear=%d tax=%d taxplus=%d taxminus=%d taxpercent=%d shifted=%d",
+    calculator.hasError,
+    calculator.hasMemory,
+    calculator.shouldMemoryClear,
+    calculator.isTaxStatusVisible,
+    calculator.isTaxPlusStatusVisible,
+    calculator.isTaxMinusStatusVisible,
+    calculator.isTaxPercentStatusVisible,
+    calculator.isRateShifted];
+}
+
+@end
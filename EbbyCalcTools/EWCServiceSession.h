@@ -0,0 +1,81 @@
+//
+//  EWCServiceSession.h
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+
+@class EWCCalculator;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCServiceSession` records a named calculator session hosted by the calculator service.
+ */
+@interface EWCServiceSession : NSObject
+
+/**
+  The session name.
+ */
+@property (nonatomic, readonly) NSString *name;
+
+/**
+  The calculator backing the session.
+ */
+@property (nonatomic, readonly) EWCCalculator *calculator;
+
+/**
+  The last time the session was used.
+ */
+@property (nonatomic) NSTimeInterval lastUsed;
+
+/**
+  The record in the session slab holding the session's state, or `EWCSessionSlabNoSlot` if it isn't persisted.
+ */
+@property (nonatomic) uint32_t slot;
+
+/**
+  Creates a new session record.
+
+  @param name The session name.
+  @param calculator The calculator backing the session.
+  @param now The time the session was opened.
+
+  @return The new session record.
+ */
++ (instancetype)sessionWithName:(NSString *)name
+  calculator:(EWCCalculator *)calculator
+  atTime:(NSTimeInterval)now;
+
+/**
+  Initializes a new session record.
+
+  @param name The session name.
+  @param calculator The calculator backing the session.
+  @param now The time the session was opened.
+
+  @return The initialized session record.
+ */
+- (instancetype)initWithName:(NSString *)name
+  calculator:(EWCCalculator *)calculator
+  atTime:(NSTimeInterval)now;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,51 @@
+//
+//  EWCServiceSession.m
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCServiceSession.h"
+#import "EWCSessionSlab.h"
+
+@implementation EWCServiceSession
+
+///-------------------------------------
+/// @name Constructors and Initializers.
+///-------------------------------------
+
++ (instancetype)sessionWithName:(NSString *)name
+  calculator:(EWCCalculator *)calculator
+  atTime:(NSTimeInterval)now {
+  return [[EWCServiceSession alloc] initWithName:name calculator:calculator atTime:now];
+}
+
+- (instancetype)initWithName:(NSString *)name
+  calculator:(EWCCalculator *)calculator
+  atTime:(NSTimeInterval)now {
+  self = [super init];
+  if (self) {
+    _name = [name copy];
+    _calculator = calculator;
+    _lastUsed = now;
+    _slot = EWCSessionSlabNoSlot;
+  }
+
+  return self;
+}
+
+@end
@@ -0,0 +1,175 @@
+//
+//  EWCSessionManager.h
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+
+@class EWCCalculator;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCSessionManager` hosts named calculator sessions for the calculator service.
+
+  Sessions are backed by `EWCCalculator` instances drawn from an `EWCCalculatorPool`, so that opening and closing sessions doesn't allocate a new calculator each time.  Sessions that haven't been used for longer than the idle timeout can be evicted, returning their calculators to the pool.
+
+  Sessions can be persisted in a session slab (see `EWCSessionSlab`), a memory mapped file holding the complete engine state of every session, so that a restarted service reattaches to its sessions instead of losing them.
+
+  Times are supplied by the caller (in seconds, from any monotonic clock) so that eviction can be tested without waiting.  The manager is not thread safe, and is meant to be driven from the service event loop.
+ */
+@interface EWCSessionManager : NSObject
+
+/**
+  How long (in seconds) a session may go unused before it is evicted.  Zero disables eviction.
+ */
+@property (nonatomic) NSTimeInterval idleTimeout;
+
+/**
+  The maximum number of idle calculators kept in the pool.  Calculators released beyond this are discarded.
+ */
+@property (nonatomic) NSUInteger maximumPoolSize;
+
+/**
+  The number of open sessions.
+ */
+@property (nonatomic, readonly) NSUInteger sessionCount;
+
+/**
+  The number of idle calculators in the pool.
+ */
+@property (nonatomic, readonly) NSUInteger pooledCount;
+
+/**
+  The number of sessions evicted for being idle since the manager was created.
+ */
+@property (nonatomic, readonly) NSUInteger evictedCount;
+
+/**
+  The number of sessions whose state is held in the session slab.
+ */
+@property (nonatomic, readonly) NSUInteger persistedCount;
+
+/**
+  The number of sessions opened that couldn't be persisted because the session slab was full.
+ */
+@property (nonatomic, readonly) NSUInteger unpersistedCount;
+
+/**
+  Creates a new session manager.
+
+  @param locale The locale that session calculators format their display for.
+  @param maximumDigits The digit limit of the session calculators.
+
+  @return The new session manager.
+ */
++ (instancetype)managerWithLocale:(NSLocale *)locale maximumDigits:(NSInteger)maximumDigits;
+
+/**
+  Initializes a new session manager.
+
+  @param locale The locale that session calculators format their display for.
+  @param maximumDigits The digit limit of the session calculators.
+
+  @return The initialized session manager.
+ */
+- (instancetype)initWithLocale:(NSLocale *)locale maximumDigits:(NSInteger)maximumDigits;
+
+/**
+  Checks whether a session may have a name.  A name must fit in a session slab record (less than `EWCSessionSlabNameSize` bytes of UTF-8, without any NUL characters), so that a persisted session reattaches under exactly the same name.
+
+  @param name The session name.
+
+  @return YES if the name may be used.
+ */
++ (BOOL)isValidSessionName:(NSString *)name;
+
+/**
+  Opens a session, or returns the existing session with the same name.
+
+  @param name The session name.
+  @param now The current time.
+
+  @return The calculator backing the session, or nil if the name isn't valid.
+ */
+- (nullable EWCCalculator *)openSessionNamed:(NSString *)name atTime:(NSTimeInterval)now;
+
+/**
+  Looks up an open session, marking it as used.
+
+  @param name The session name.
+  @param now The current time.
+
+  @return The calculator backing the session, or nil if there is no such session.
+ */
+- (nullable EWCCalculator *)sessionNamed:(NSString *)name atTime:(NSTimeInterval)now;
+
+/**
+  Closes a session, returning its calculator to the pool.
+
+  @param name The session name.
+
+  @return YES if the session existed.
+ */
+- (BOOL)closeSessionNamed:(NSString *)name;
+
+/**
+  Evicts the sessions that have been idle for longer than the idle timeout.
+
+  @param now The current time.
+
+  @return The number of sessions evicted.
+ */
+- (NSUInteger)evictIdleSessionsAtTime:(NSTimeInterval)now;
+
+/**
+  Persists sessions in a session slab file, reopening every session stored in it.  Sessions opened from then on are stored in the slab, and those closed are removed from it.
+
+  This must be done before any session is opened.  Sessions that don't fit in the slab are still opened, but aren't persisted, and are counted in `unpersistedCount`.  Stored records whose names can't be read back are freed.
+
+  @param path The path of the slab file, which is created if it doesn't exist.
+  @param capacity The number of sessions a new slab file can hold.  An existing file keeps its own capacity.
+  @param now The current time, which reopened sessions are marked as used at.
+
+  @return 0 if successful, otherwise the errno value of the failure (as from `EWCSessionSlabOpen`, or EBUSY if a slab is already attached or sessions are open).
+ */
+- (int)attachSlabAtPath:(NSString *)path capacity:(NSUInteger)capacity atTime:(NSTimeInterval)now;
+
+/**
+  Stores the current state of a session in the session slab, in place.  Call this after pressing keys on the session's calculator.
+
+  @param name The session name.
+ */
+- (void)storeSessionNamed:(NSString *)name;
+
+/**
+  Schedules the states stored since the last sync to be written to the slab file.  Call this periodically.
+
+  @return 0 if successful (or there is no slab), otherwise the errno value of the failure.
+ */
+- (int)syncSlab;
+
+/**
+  Flushes the session slab and closes it.  The sessions stay open, but are no longer persisted.
+ */
+- (void)detachSlab;
+
+@end
+
+NS_ASSUME_NONNULL_END
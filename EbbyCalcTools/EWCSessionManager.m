@@ -0,0 +1,250 @@
+//
+//  EWCSessionManager.m
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <errno.h>
+#import <string.h>
+#import "EWCSessionManager.h"
+#import "EWCServiceSession.h"
+#import "EWCSessionSlab.h"
+#import "../EbbyCalc/EWCCalculator.h"
+#import "../EbbyCalc/EWCCalculatorPool.h"
+
+@interface EWCSessionManager () {
+  NSMutableDictionary<NSString *, EWCServiceSession *> *_sessions;  // the open sessions by name
+  EWCCalculatorPool *_pool;  // idle calculators ready for reuse
+  EWCSessionSlab _slab;  // persists the session states
+  BOOL _slabAttached;  // whether the slab is open
+}
+
+@end
+
+@implementation EWCSessionManager
+
+///-------------------------------------
+/// @name Constructors and Initializers.
+///-------------------------------------
+
++ (instancetype)managerWithLocale:(NSLocale *)locale maximumDigits:(NSInteger)maximumDigits {
+  return [[EWCSessionManager alloc] initWithLocale:locale maximumDigits:maximumDigits];
+}
+
+- (instancetype)initWithLocale:(NSLocale *)locale maximumDigits:(NSInteger)maximumDigits {
+  self = [super init];
+  if (self) {
+    _idleTimeout = 0;
+    _evictedCount = 0;
+    _unpersistedCount = 0;
+    _sessions = [NSMutableDictionary new];
+    _pool = [EWCCalculatorPool poolWithLocale:locale maximumDigits:maximumDigits];
+    _slabAttached = NO;
+  }
+
+  return self;
+}
+
+- (void)dealloc {
+  [self detachSlab];
+}
+
+///------------------------------
+/// @name Custom Property Methods
+///------------------------------
+
+- (NSUInteger)sessionCount {
+  return _sessions.count;
+}
+
+- (NSUInteger)pooledCount {
+  return _pool.count;
+}
+
+- (NSUInteger)persistedCount {
+  return _slabAttached ? _slab.liveCount : 0;
+}
+
+- (NSUInteger)maximumPoolSize {
+  return _pool.maximumSize;
+}
+
+- (void)setMaximumPoolSize:(NSUInteger)maximumPoolSize {
+  _pool.maximumSize = maximumPoolSize;
+}
+
+///---------------------------------------------------------------
+/// @name Public Properties and Methods (documented in the header)
+///---------------------------------------------------------------
+
++ (BOOL)isValidSessionName:(NSString *)name {
+  return name.length > 0
+    && [name lengthOfBytesUsingEncoding:NSUTF8StringEncoding] < EWCSessionSlabNameSize
+    && [name rangeOfCharacterFromSet:[NSCharacterSet characterSetWithRange:NSMakeRange(0, 1)]].location == NSNotFound;
+}
+
+- (EWCCalculator *)openSessionNamed:(NSString *)name atTime:(NSTimeInterval)now {
+  EWCServiceSession *session = _sessions[name];
+  if (! session) {
+    if (! [EWCSessionManager isValidSessionName:name]) {
+      return nil;
+    }
+
+    session = [EWCServiceSession sessionWithName:name
+      calculator:[_pool acquireCalculator]
+      atTime:now];
+    _sessions[session.name] = session;
+
+    if (_slabAttached) {
+      EWCCalculatorState state;
+      [session.calculator getState:&state];
+      session.slot = EWCSessionSlabAllocate(&_slab, session.name.UTF8String, &state);
+      if (session.slot == EWCSessionSlabNoSlot) {
+        ++_unpersistedCount;
+      }
+    }
+  }
+
+  session.lastUsed = now;
+
+  return session.calculator;
+}
+
+- (EWCCalculator *)sessionNamed:(NSString *)name atTime:(NSTimeInterval)now {
+  EWCServiceSession *session = _sessions[name];
+  session.lastUsed = now;
+
+  return session.calculator;
+}
+
+- (BOOL)closeSessionNamed:(NSString *)name {
+  EWCServiceSession *session = _sessions[name];
+  if (! session) {
+    return NO;
+  }
+
+  if (_slabAttached) {
+    EWCSessionSlabRelease(&_slab, session.slot);
+  }
+
+  [_sessions removeObjectForKey:name];
+  [_pool releaseCalculator:session.calculator];
+
+  return YES;
+}
+
+- (NSUInteger)evictIdleSessionsAtTime:(NSTimeInterval)now {
+  if (_idleTimeout <= 0) {
+    return 0;
+  }
+
+  NSMutableArray<NSString *> *idle = [NSMutableArray new];
+  for (EWCServiceSession *session in _sessions.objectEnumerator) {
+    if (now - session.lastUsed > _idleTimeout) {
+      [idle addObject:session.name];
+    }
+  }
+
+  for (NSString *name in idle) {
+    [self closeSessionNamed:name];
+  }
+
+  _evictedCount += idle.count;
+
+  return idle.count;
+}
+
+- (int)attachSlabAtPath:(NSString *)path capacity:(NSUInteger)capacity atTime:(NSTimeInterval)now {
+  if (_slabAttached || _sessions.count > 0) {
+    return EBUSY;
+  }
+
+  int error = EWCSessionSlabOpen(&_slab, path.fileSystemRepresentation,
+    (uint32_t)MIN(capacity, (NSUInteger)EWCSessionSlabNoSlot - 1),
+    sizeof(EWCCalculatorState), EWCCalculatorStateVersion);
+  if (error) {
+    return error;
+  }
+
+  _slabAttached = YES;
+
+  // reopen the stored sessions, restoring each state into a pooled calculator
+  EWCCalculatorState state;
+  for (uint32_t slot = 0; slot < _slab.capacity; ++slot) {
+    if (! EWCSessionSlabLoad(&_slab, slot, &state)) {
+      continue;
+    }
+
+    // names are checked when sessions are opened, so one that doesn't read
+    // back (or is a duplicate) means the file was edited or damaged, and the
+    // first good record of a name is kept
+    const char *bytes = EWCSessionSlabName(&_slab, slot);
+    NSString *name = [[NSString alloc] initWithBytes:bytes
+      length:strnlen(bytes, EWCSessionSlabNameSize - 1)
+      encoding:NSUTF8StringEncoding];
+    if (! name || ! [EWCSessionManager isValidSessionName:name] || _sessions[name]) {
+      EWCSessionSlabRelease(&_slab, slot);
+      continue;
+    }
+
+    EWCCalculator *calculator = [_pool acquireCalculator];
+    [calculator restoreState:&state];
+
+    EWCServiceSession *session = [EWCServiceSession sessionWithName:name
+      calculator:calculator
+      atTime:now];
+    session.slot = slot;
+    _sessions[session.name] = session;
+  }
+
+  return 0;
+}
+
+- (void)storeSessionNamed:(NSString *)name {
+  if (! _slabAttached) {
+    return;
+  }
+
+  EWCServiceSession *session = _sessions[name];
+  if (! session) {
+    return;
+  }
+
+  EWCCalculatorState state;
+  [session.calculator getState:&state];
+  EWCSessionSlabStore(&_slab, session.slot, &state);
+}
+
+- (int)syncSlab {
+  return _slabAttached ? EWCSessionSlabSync(&_slab, NO) : 0;
+}
+
+- (void)detachSlab {
+  if (! _slabAttached) {
+    return;
+  }
+
+  EWCSessionSlabClose(&_slab);
+  _slabAttached = NO;
+
+  for (EWCServiceSession *session in _sessions.objectEnumerator) {
+    session.slot = EWCSessionSlabNoSlot;
+  }
+}
+
+@end
@@ -0,0 +1,412 @@
+//
+//  EWCSessionSlab.c
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "EWCSessionSlab.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// identifies a slab file
+static const char s_magic[8] = "EWCSLAB";
+
+// records are laid out on cache line boundaries
+#define EWCSessionSlabAlignment 64
+
+/**
+  Rounds a size up to a multiple of an alignment.
+
+  @param size The size.
+  @param alignment The alignment, a power of two.
+
+  @return The rounded size.
+ */
+static uint32_t EWCSessionSlabAlign(uint32_t size, uint32_t alignment) {
+  return (size + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+  Gets a record.
+
+  @param slab The slab.
+  @param slot The record index.
+
+  @return The start of the record, which is its name.
+ */
+static inline uint8_t *EWCSessionSlabRecord(const EWCSessionSlab *slab, uint32_t slot) {
+  return slab->base + sizeof(EWCSessionSlabHeader) + (size_t)slot * slab->recordSize;
+}
+
+/**
+  Gets one of the two state copies of a record.
+
+  @param slab The slab.
+  @param slot The record index.
+  @param which The copy, 0 or 1.
+
+  @return The header of the copy, which the state follows.
+ */
+static inline EWCSessionSlabCopyHeader *EWCSessionSlabCopy(const EWCSessionSlab *slab,
+  uint32_t slot, uint64_t which) {
+  return (EWCSessionSlabCopyHeader *)(EWCSessionSlabRecord(slab, slot)
+    + EWCSessionSlabNameSize + (which & 1) * slab->copySize);
+}
+
+/**
+  Mixes bytes into a checksum, eight at a time where possible (FNV-1a over words).
+
+  @param hash The checksum so far.
+  @param bytes The bytes.
+  @param length The number of bytes.
+
+  @return The updated checksum.
+ */
+static uint64_t EWCSessionSlabMix(uint64_t hash, const uint8_t *bytes, size_t length) {
+  size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    uint64_t word;
+    memcpy(&word, bytes + i, 8);
+    hash = (hash ^ word) * 0x100000001b3ULL;
+  }
+  for (; i < length; ++i) {
+    hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+  }
+
+  return hash;
+}
+
+/**
+  Computes the checksum of a state copy.
+
+  @param slab The slab.
+  @param name The record's name.
+  @param copy The copy.
+
+  @return The checksum.  Never 0, so that a zeroed copy is never valid.
+ */
+static uint64_t EWCSessionSlabChecksum(const EWCSessionSlab *slab,
+  const uint8_t *name, const EWCSessionSlabCopyHeader *copy) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  hash = EWCSessionSlabMix(hash, name, EWCSessionSlabNameSize);
+  hash = EWCSessionSlabMix(hash, (const uint8_t *)&copy->sequence, sizeof(copy->sequence));
+  hash = EWCSessionSlabMix(hash, (const uint8_t *)(copy + 1), slab->stateSize);
+
+  // finish with a final avalanche so that every input bit reaches every output bit
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+
+  return hash ? hash : 1;
+}
+
+/**
+  Gets whether a state copy was completely written.
+
+  @param slab The slab.
+  @param name The record's name.
+  @param copy The copy.
+
+  @return true if the copy holds a stored state.
+ */
+static bool EWCSessionSlabCopyIsValid(const EWCSessionSlab *slab,
+  const uint8_t *name, const EWCSessionSlabCopyHeader *copy) {
+  return copy->sequence != 0 && copy->checksum == EWCSessionSlabChecksum(slab, name, copy);
+}
+
+/**
+  Writes a state into a copy, publishing it by writing its checksum last.
+
+  @param slab The slab.
+  @param name The record's name.
+  @param copy The copy.
+  @param sequence The sequence of the store.
+  @param state The state.
+ */
+static void EWCSessionSlabWriteCopy(const EWCSessionSlab *slab, const uint8_t *name,
+  EWCSessionSlabCopyHeader *copy, uint64_t sequence, const void *state) {
+  memcpy(copy + 1, state, slab->stateSize);
+  copy->sequence = sequence;
+  uint64_t checksum = EWCSessionSlabChecksum(slab, name, copy);
+
+  // the checksum must not reach memory before the state it covers
+  atomic_thread_fence(memory_order_release);
+  copy->checksum = checksum;
+}
+
+/**
+  Clears a record, making it free.  The copies are invalidated before the name is cleared, so that a record is never left with a name and a stale copy that would validate.
+
+  @param slab The slab.
+  @param slot The record index.
+ */
+static void EWCSessionSlabClearRecord(EWCSessionSlab *slab, uint32_t slot) {
+  for (uint64_t which = 0; which < 2; ++which) {
+    EWCSessionSlabCopyHeader *copy = EWCSessionSlabCopy(slab, slot, which);
+    copy->checksum = 0;
+    copy->sequence = 0;
+  }
+
+  atomic_thread_fence(memory_order_release);
+  memset(EWCSessionSlabRecord(slab, slot), 0, EWCSessionSlabNameSize);
+}
+
+/**
+  Finds the live records of a newly mapped file, building the free list and freeing any record that was torn by a crash before its first state was stored.
+
+  @param slab The slab.
+ */
+static void EWCSessionSlabScan(EWCSessionSlab *slab) {
+  slab->freeCount = 0;
+  slab->liveCount = 0;
+  slab->repairedCount = 0;
+
+  // push the free records in reverse, so that records are reused lowest first
+  for (uint32_t slot = slab->capacity; slot-- > 0; ) {
+    const uint8_t *name = EWCSessionSlabRecord(slab, slot);
+    uint64_t newest = 0;
+
+    if (name[0] != '\0') {
+      for (uint64_t which = 0; which < 2; ++which) {
+        const EWCSessionSlabCopyHeader *copy = EWCSessionSlabCopy(slab, slot, which);
+        if (copy->sequence > newest && EWCSessionSlabCopyIsValid(slab, name, copy)) {
+          newest = copy->sequence;
+        }
+      }
+
+      if (newest == 0) {
+        EWCSessionSlabClearRecord(slab, slot);
+        ++slab->repairedCount;
+      }
+    }
+
+    slab->sequences[slot] = newest;
+    if (newest) {
+      ++slab->liveCount;
+    } else {
+      slab->freeSlots[slab->freeCount++] = slot;
+    }
+  }
+}
+
+int EWCSessionSlabOpen(EWCSessionSlab *slab, const char *path,
+  uint32_t capacity, uint32_t stateSize, uint32_t stateVersion) {
+
+  memset(slab, 0, sizeof(*slab));
+  slab->fd = -1;
+
+  int fd = open(path, O_RDWR | O_CREAT, 0644);
+  if (fd < 0) {
+    return errno;
+  }
+
+  // a second process attached to the same file would corrupt it
+  if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+    int error = errno;
+    close(fd);
+    return error;
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    int error = errno;
+    close(fd);
+    return error;
+  }
+
+  EWCSessionSlabHeader header;
+  memset(&header, 0, sizeof(header));
+  if (info.st_size >= (off_t)sizeof(header) && pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header)) {
+    int error = errno;
+    close(fd);
+    return error;
+  }
+
+  uint32_t copySize = EWCSessionSlabAlign((uint32_t)sizeof(EWCSessionSlabCopyHeader) + stateSize, 8);
+  uint32_t recordSize = EWCSessionSlabAlign(EWCSessionSlabNameSize + 2 * copySize, EWCSessionSlabAlignment);
+
+  // a file that never got its header is as good as new
+  static const char s_empty[8];
+  bool create = (memcmp(header.magic, s_empty, sizeof(s_empty)) == 0);
+  if (create) {
+    if (capacity == 0) {
+      close(fd);
+      return EINVAL;
+    }
+
+    header.version = EWCSessionSlabVersion;
+    header.stateVersion = stateVersion;
+    header.stateSize = stateSize;
+    header.recordSize = recordSize;
+    header.capacity = capacity;
+  } else if (memcmp(header.magic, s_magic, sizeof(s_magic)) != 0
+    || header.version != EWCSessionSlabVersion
+    || header.stateVersion != stateVersion
+    || header.stateSize != stateSize
+    || header.recordSize != recordSize
+    || header.capacity == 0) {
+    close(fd);
+    return EINVAL;
+  }
+
+  size_t length = sizeof(header) + (size_t)header.capacity * recordSize;
+  if ((off_t)length > info.st_size && ftruncate(fd, (off_t)length) != 0) {
+    int error = errno;
+    close(fd);
+    return error;
+  }
+
+  void *base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (base == MAP_FAILED) {
+    int error = errno;
+    close(fd);
+    return error;
+  }
+
+  slab->fd = fd;
+  slab->base = base;
+  slab->length = length;
+  slab->capacity = header.capacity;
+  slab->stateSize = stateSize;
+  slab->copySize = copySize;
+  slab->recordSize = recordSize;
+  slab->sequences = calloc(header.capacity, sizeof(uint64_t));
+  slab->freeSlots = calloc(header.capacity, sizeof(uint32_t));
+  if (! slab->sequences || ! slab->freeSlots) {
+    EWCSessionSlabClose(slab);
+    return ENOMEM;
+  }
+
+  if (create) {
+    // the records are already zero, which is free.  the magic goes in last,
+    // once the rest of the header is in place
+    memcpy(slab->base, &header, sizeof(header));
+    atomic_thread_fence(memory_order_release);
+    memcpy(slab->base, s_magic, sizeof(s_magic));
+    msync(slab->base, sizeof(header), MS_SYNC);
+  }
+
+  EWCSessionSlabScan(slab);
+
+  return 0;
+}
+
+void EWCSessionSlabClose(EWCSessionSlab *slab) {
+  if (slab->base) {
+    msync(slab->base, slab->length, MS_SYNC);
+    munmap(slab->base, slab->length);
+  }
+  if (slab->fd >= 0) {
+    close(slab->fd);
+  }
+
+  free(slab->sequences);
+  free(slab->freeSlots);
+  memset(slab, 0, sizeof(*slab));
+  slab->fd = -1;
+}
+
+uint32_t EWCSessionSlabAllocate(EWCSessionSlab *slab, const char *name, const void *state) {
+  // a name is never truncated, since that could give two sessions the same
+  // name when they are reattached
+  size_t length = strlen(name);
+  if (slab->freeCount == 0 || length >= EWCSessionSlabNameSize) {
+    return EWCSessionSlabNoSlot;
+  }
+
+  uint32_t slot = slab->freeSlots[--slab->freeCount];
+  uint8_t *record = EWCSessionSlabRecord(slab, slot);
+
+  // the whole name field is checksummed, so the bytes after the name are zeroed
+  memset(record, 0, EWCSessionSlabNameSize);
+  memcpy(record, name, length);
+
+  EWCSessionSlabWriteCopy(slab, record, EWCSessionSlabCopy(slab, slot, 1), 1, state);
+  slab->sequences[slot] = 1;
+  ++slab->liveCount;
+  ++slab->storeCount;
+
+  return slot;
+}
+
+void EWCSessionSlabStore(EWCSessionSlab *slab, uint32_t slot, const void *state) {
+  if (! EWCSessionSlabIsLive(slab, slot)) {
+    return;
+  }
+
+  // write over the older copy, leaving the newest intact until this one is
+  // complete
+  uint64_t sequence = slab->sequences[slot] + 1;
+  EWCSessionSlabWriteCopy(slab, EWCSessionSlabRecord(slab, slot),
+    EWCSessionSlabCopy(slab, slot, sequence), sequence, state);
+  slab->sequences[slot] = sequence;
+  ++slab->storeCount;
+}
+
+bool EWCSessionSlabLoad(const EWCSessionSlab *slab, uint32_t slot, void *state) {
+  if (! EWCSessionSlabIsLive(slab, slot)) {
+    return false;
+  }
+
+  const EWCSessionSlabCopyHeader *copy = EWCSessionSlabCopy(slab, slot, slab->sequences[slot]);
+  memcpy(state, copy + 1, slab->stateSize);
+
+  return true;
+}
+
+void EWCSessionSlabRelease(EWCSessionSlab *slab, uint32_t slot) {
+  if (! EWCSessionSlabIsLive(slab, slot)) {
+    return;
+  }
+
+  EWCSessionSlabClearRecord(slab, slot);
+  slab->sequences[slot] = 0;
+  slab->freeSlots[slab->freeCount++] = slot;
+  --slab->liveCount;
+  ++slab->storeCount;
+}
+
+const char *EWCSessionSlabName(const EWCSessionSlab *slab, uint32_t slot) {
+  if (! EWCSessionSlabIsLive(slab, slot)) {
+    return NULL;
+  }
+
+  return (const char *)EWCSessionSlabRecord(slab, slot);
+}
+
+int EWCSessionSlabSync(EWCSessionSlab *slab, bool wait) {
+  if (slab->storeCount == 0) {
+    return 0;
+  }
+
+  if (msync(slab->base, slab->length, wait ? MS_SYNC : MS_ASYNC) != 0) {
+    return errno;
+  }
+
+  slab->storeCount = 0;
+
+  return 0;
+}
@@ -0,0 +1,174 @@
+//
+//  EWCSessionSlab.h
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef EWCSessionSlab_h
+#define EWCSessionSlab_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// the bytes set aside for a session name, including the terminator
+#define EWCSessionSlabNameSize 64
+
+// the version of the file layout
+#define EWCSessionSlabVersion 1
+
+// returned when there is no free record for a session
+#define EWCSessionSlabNoSlot UINT32_MAX
+
+/**
+  `EWCSessionSlabHeader` begins a slab file, describing the records that follow it.
+ */
+typedef struct {
+  char magic[8];  // identifies the file as a session slab
+  uint32_t version;  // the file layout version
+  uint32_t stateVersion;  // the layout version of the session state, as given by the caller
+  uint32_t stateSize;  // the size of each session state
+  uint32_t recordSize;  // the distance between records
+  uint32_t capacity;  // the number of records
+  uint32_t reserved[9];  // pads the header to a cache line
+} EWCSessionSlabHeader;
+
+/**
+  `EWCSessionSlabCopyHeader` precedes each of the two copies of a session state in its record.
+
+  A record is live when its name is set and at least one copy's checksum matches.  Each update is written to the copy not holding the newest state, with its checksum written last, so a process that dies (or a machine that loses power before the pages reach the disk) part way through an update leaves the previous state intact in the other copy.
+ */
+typedef struct {
+  uint64_t checksum;  // covers the name, the sequence, and the state
+  uint64_t sequence;  // the number of times the session has been stored, 0 if never
+} EWCSessionSlabCopyHeader;
+
+/**
+  `EWCSessionSlab` keeps the complete state of many sessions in a memory mapped file of fixed size records, so that a restarted process can reattach to them by mapping the file rather than replaying anything.
+
+  States are opaque fixed size blobs, stored in place.  The mapping is flushed to the file by `EWCSessionSlabSync`, which the owner calls periodically.  A slab is not thread safe, and a file can only be open in one slab at a time.
+ */
+typedef struct {
+  int fd;  // the slab file
+  uint8_t *base;  // the mapped file
+  size_t length;  // the length of the mapping
+  uint32_t capacity;  // the number of records
+  uint32_t stateSize;  // the size of each session state
+  uint32_t copySize;  // the distance between the two copies in a record
+  uint32_t recordSize;  // the distance between records
+  uint64_t *sequences;  // the newest sequence stored for each record, 0 for free records
+  uint32_t *freeSlots;  // the free records, as a stack
+  uint32_t freeCount;  // the number of free records
+  uint32_t liveCount;  // the number of live records
+  uint32_t repairedCount;  // the records found torn (and freed) when the file was opened
+  uint64_t storeCount;  // the stores since the slab was last synced
+} EWCSessionSlab;
+
+/**
+  Opens a slab file, creating it if it doesn't exist, and reattaches to the sessions stored in it.
+
+  @param slab The slab to open.
+  @param path The path of the file.
+  @param capacity The number of records in a new file.  An existing file keeps its own capacity.
+  @param stateSize The size of each session state.
+  @param stateVersion The layout version of the session state, which must match that of an existing file.
+
+  @return 0 if the slab was opened, or an errno value: EINVAL if an existing file isn't a slab or has a different layout, EWOULDBLOCK if the file is open in another slab, or the error of a failed system call.
+ */
+int EWCSessionSlabOpen(EWCSessionSlab *slab, const char *path,
+  uint32_t capacity, uint32_t stateSize, uint32_t stateVersion);
+
+/**
+  Flushes and closes a slab.
+
+  @param slab The slab to close.
+ */
+void EWCSessionSlabClose(EWCSessionSlab *slab);
+
+/**
+  Claims a free record for a session, storing its first state.
+
+  @param slab The slab.
+  @param name The session name, which must be shorter than `EWCSessionSlabNameSize` bytes.
+  @param state The state to store.
+
+  @return The record, or `EWCSessionSlabNoSlot` if the slab is full or the name doesn't fit.
+ */
+uint32_t EWCSessionSlabAllocate(EWCSessionSlab *slab, const char *name, const void *state);
+
+/**
+  Stores the state of a session in place.
+
+  @param slab The slab.
+  @param slot The session's record.
+  @param state The state to store.
+ */
+void EWCSessionSlabStore(EWCSessionSlab *slab, uint32_t slot, const void *state);
+
+/**
+  Reads the newest state of a session.
+
+  @param slab The slab.
+  @param slot The session's record.
+  @param state Receives the state.
+
+  @return true if the record is live, otherwise false (and nothing is read).
+ */
+bool EWCSessionSlabLoad(const EWCSessionSlab *slab, uint32_t slot, void *state);
+
+/**
+  Frees the record of a session.
+
+  @param slab The slab.
+  @param slot The session's record.
+ */
+void EWCSessionSlabRelease(EWCSessionSlab *slab, uint32_t slot);
+
+/**
+  Gets the name of the session in a record.
+
+  @param slab The slab.
+  @param slot The record.
+
+  @return The name, or NULL if the record is free.  A name read from a damaged file may not be terminated within `EWCSessionSlabNameSize` bytes, or be valid UTF-8.
+ */
+const char *EWCSessionSlabName(const EWCSessionSlab *slab, uint32_t slot);
+
+/**
+  Flushes the stores made since the last sync to the file.
+
+  @param slab The slab.
+  @param wait Whether to wait for the pages to be written, rather than only scheduling them.
+
+  @return 0 if successful (or there was nothing to flush), otherwise the errno value of the failure.
+ */
+int EWCSessionSlabSync(EWCSessionSlab *slab, bool wait);
+
+/**
+  Gets whether a record holds a session.
+
+  @param slab The slab.
+  @param slot The record.
+
+  @return true if the record is live.
+ */
+static inline bool EWCSessionSlabIsLive(const EWCSessionSlab *slab, uint32_t slot) {
+  return slot < slab->capacity && slab->sequences[slot] != 0;
+}
+
+#endif /* EWCSessionSlab_h */
@@ -0,0 +1,388 @@
+//
+//  EWCSessionSlabCrashMain.c
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <errno.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "EWCSessionSlab.h"
+
+// the layout version of the test states
+#define EWCSlabCrashStateVersion 1
+
+// marks that the writer isn't in the middle of an operation
+#define EWCSlabCrashIdle UINT32_MAX
+
+/**
+  `EWCSlabCrashProgress` is shared with the writer process, which publishes each operation it completes, so that the checker knows which states must have survived the writer being killed.
+ */
+typedef struct {
+  _Atomic uint32_t busy;  // the record being changed, or `EWCSlabCrashIdle`
+  _Atomic uint64_t operations;  // the operations completed
+  _Atomic uint64_t versions[];  // the version last stored in each record, 0 for free records
+} EWCSlabCrashProgress;
+
+/**
+  Gets the current time from a monotonic clock.
+
+  @return The time in seconds.
+ */
+static double EWCSlabCrashNow(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+  Generates a pseudo-random number (xorshift64*).
+
+  @param state The generator state, which must not be zero.
+
+  @return The next number.
+ */
+static uint64_t EWCSlabCrashRandom(uint64_t *state) {
+  uint64_t x = *state;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  *state = x;
+
+  return x * 2685821657736338717ULL;
+}
+
+/**
+  Fills a state with the contents expected for a version of a record, so that a state holding any other bytes (torn, or from another record) is detected.
+
+  @param state The state to fill.
+  @param size The size of the state, at least 8.
+  @param slot The record.
+  @param version The version.
+ */
+static void EWCSlabCrashFill(uint8_t *state, uint32_t size, uint32_t slot, uint64_t version) {
+  memcpy(state, &version, sizeof(version));
+
+  uint64_t x = (version * 0x9e3779b97f4a7c15ULL) ^ ((uint64_t)slot << 32) ^ 0x5bd1e995;
+  for (uint32_t i = sizeof(version); i < size; ++i) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    state[i] = (uint8_t)x;
+  }
+}
+
+/**
+  Formats the name of the session kept in a record.
+
+  @param name Receives the name.
+  @param slot The record.
+ */
+static void EWCSlabCrashName(char name[EWCSessionSlabNameSize], uint32_t slot) {
+  snprintf(name, EWCSessionSlabNameSize, "session-%u", slot);
+}
+
+/**
+  Opens, closes, and stores sessions as fast as it can until it is killed, publishing each completed operation.  Runs in the writer process.
+
+  @param path The slab file.
+  @param sessions The number of records.
+  @param stateSize The size of each state.
+  @param progress The shared progress.
+  @param seed The random seed.
+ */
+static void EWCSlabCrashWrite(const char *path, uint32_t sessions, uint32_t stateSize,
+  EWCSlabCrashProgress *progress, uint64_t seed) {
+
+  EWCSessionSlab slab;
+  int error = EWCSessionSlabOpen(&slab, path, sessions, stateSize, EWCSlabCrashStateVersion);
+  if (error) {
+    fprintf(stderr, "writer: %s: %s\n", path, strerror(error));
+    _exit(1);
+  }
+
+  uint8_t *state = malloc(stateSize);
+  char name[EWCSessionSlabNameSize];
+  uint64_t random = seed ? seed : 1;
+
+  while (1) {
+    uint32_t slot = (uint32_t)(EWCSlabCrashRandom(&random) % sessions);
+    uint64_t version = atomic_load(&progress->versions[slot]);
+
+    atomic_store(&progress->busy, slot);
+
+    if (version == 0) {
+      // the free list hands out the lowest record, so the session opened may
+      // not be the one picked
+      uint32_t lowest = slab.freeSlots[slab.freeCount - 1];
+      atomic_store(&progress->busy, lowest);
+      EWCSlabCrashName(name, lowest);
+      EWCSlabCrashFill(state, stateSize, lowest, 1);
+      EWCSessionSlabAllocate(&slab, name, state);
+      slot = lowest;
+      version = 1;
+    } else if (EWCSlabCrashRandom(&random) % 16 == 0) {
+      EWCSessionSlabRelease(&slab, slot);
+      version = 0;
+    } else {
+      ++version;
+      EWCSlabCrashFill(state, stateSize, slot, version);
+      EWCSessionSlabStore(&slab, slot, state);
+    }
+
+    atomic_store(&progress->versions[slot], version);
+    atomic_store(&progress->busy, EWCSlabCrashIdle);
+    atomic_fetch_add(&progress->operations, 1);
+  }
+}
+
+/**
+  Reattaches to the slab left by a killed writer, and checks that every record holds what the writer last completed (or, for the record it was changing, what it was about to store).  The progress is then updated to what was found, for the next writer.
+
+  @param path The slab file.
+  @param sessions The number of records.
+  @param stateSize The size of each state.
+  @param progress The shared progress.
+  @param attachSeconds Receives the time taken to open the slab.
+  @param repaired Receives the number of records found torn.
+
+  @return The number of records that didn't hold what they should.
+ */
+static long EWCSlabCrashCheck(const char *path, uint32_t sessions, uint32_t stateSize,
+  EWCSlabCrashProgress *progress, double *attachSeconds, uint32_t *repaired) {
+
+  double start = EWCSlabCrashNow();
+  EWCSessionSlab slab;
+  int error = EWCSessionSlabOpen(&slab, path, sessions, stateSize, EWCSlabCrashStateVersion);
+  *attachSeconds = EWCSlabCrashNow() - start;
+  if (error) {
+    fprintf(stderr, "checker: %s: %s\n", path, strerror(error));
+    return sessions;
+  }
+  *repaired = slab.repairedCount;
+
+  uint8_t *state = malloc(stateSize);
+  uint8_t *expected = malloc(stateSize);
+  char name[EWCSessionSlabNameSize];
+  uint32_t busy = atomic_load(&progress->busy);
+
+  long bad = 0;
+  for (uint32_t slot = 0; slot < sessions; ++slot) {
+    uint64_t completed = atomic_load(&progress->versions[slot]);
+    uint64_t found = 0;
+
+    if (EWCSessionSlabLoad(&slab, slot, state)) {
+      memcpy(&found, state, sizeof(found));
+      EWCSlabCrashFill(expected, stateSize, slot, found);
+      EWCSlabCrashName(name, slot);
+      if (found == 0 || memcmp(state, expected, stateSize) != 0
+        || strcmp(EWCSessionSlabName(&slab, slot), name) != 0) {
+        printf("record %u holds a damaged state\n", slot);
+        ++bad;
+        continue;
+      }
+    }
+
+    // the record being changed may hold the state before or after the change
+    // (opening from free, or closing, or one more store)
+    bool ok = (found == completed)
+      || (slot == busy && (found == completed + 1 || found == 0));
+    if (! ok) {
+      printf("record %u holds version %llu, expected %llu%s\n", slot,
+        (unsigned long long)found, (unsigned long long)completed,
+        (slot == busy) ? " (busy)" : "");
+      ++bad;
+    }
+
+    atomic_store(&progress->versions[slot], found);
+  }
+
+  atomic_store(&progress->busy, EWCSlabCrashIdle);
+  free(state);
+  free(expected);
+  EWCSessionSlabClose(&slab);
+
+  return bad;
+}
+
+/**
+  Times reattaching to a slab with every record live.
+
+  @param path The slab file, which is replaced.
+  @param sessions The number of records.
+  @param stateSize The size of each state.
+  @param attachSeconds Receives the time taken to open the slab.
+
+  @return 0 if successful, otherwise an errno value.
+ */
+static int EWCSlabCrashTimeAttach(const char *path, uint32_t sessions, uint32_t stateSize,
+  double *attachSeconds) {
+
+  unlink(path);
+
+  EWCSessionSlab slab;
+  int error = EWCSessionSlabOpen(&slab, path, sessions, stateSize, EWCSlabCrashStateVersion);
+  if (error) {
+    return error;
+  }
+
+  uint8_t *state = malloc(stateSize);
+  char name[EWCSessionSlabNameSize];
+  for (uint32_t slot = 0; slot < sessions; ++slot) {
+    EWCSlabCrashName(name, slot);
+    EWCSlabCrashFill(state, stateSize, slot, 1);
+    EWCSessionSlabAllocate(&slab, name, state);
+  }
+  free(state);
+  EWCSessionSlabClose(&slab);
+
+  double start = EWCSlabCrashNow();
+  error = EWCSessionSlabOpen(&slab, path, sessions, stateSize, EWCSlabCrashStateVersion);
+  *attachSeconds = EWCSlabCrashNow() - start;
+  if (! error) {
+    error = (slab.liveCount == sessions) ? 0 : EINVAL;
+    EWCSessionSlabClose(&slab);
+  }
+
+  return error;
+}
+
+/**
+  Prints the command line usage.
+
+  @param name The name the tool was run as.
+ */
+static void EWCSlabCrashUsage(const char *name) {
+  fprintf(stderr,
+    "usage: %s [-f file] [-n sessions] [-b state-bytes] [-r rounds] [-w max-micros] [-s seed]\n"
+    "  -f  slab file, replaced (default /tmp/ebbycalc-slab.bin)\n"
+    "  -n  sessions in the slab (default 4096)\n"
+    "  -b  bytes of state per session (default 512)\n"
+    "  -r  times the writer is killed (default 50)\n"
+    "  -w  most microseconds the writer runs before it is killed (default 20000)\n"
+    "  -s  random seed (default from the clock)\n",
+    name);
+}
+
+int main(int argc, char * argv[]) {
+  const char *path = "/tmp/ebbycalc-slab.bin";
+  long sessions = 4096;
+  long stateSize = 512;
+  long rounds = 50;
+  long maxMicros = 20000;
+  uint64_t seed = (uint64_t)time(NULL);
+
+  int option;
+  while ((option = getopt(argc, argv, "f:n:b:r:w:s:h")) != -1) {
+    switch (option) {
+      case 'f': path = optarg; break;
+      case 'n': sessions = atol(optarg); break;
+      case 'b': stateSize = atol(optarg); break;
+      case 'r': rounds = atol(optarg); break;
+      case 'w': maxMicros = atol(optarg); break;
+      case 's': seed = strtoull(optarg, NULL, 10); break;
+      default:
+        EWCSlabCrashUsage(argv[0]);
+        return (option == 'h') ? 0 : 2;
+    }
+  }
+
+  if (sessions < 1 || sessions >= EWCSessionSlabNoSlot || stateSize < 8 || rounds < 0 || maxMicros < 1) {
+    EWCSlabCrashUsage(argv[0]);
+    return 2;
+  }
+
+  printf("seed: %llu\n", (unsigned long long)seed);
+  uint64_t random = seed ? seed : 1;
+
+  size_t progressSize = sizeof(EWCSlabCrashProgress) + (size_t)sessions * sizeof(uint64_t);
+  EWCSlabCrashProgress *progress = mmap(NULL, progressSize, PROT_READ | PROT_WRITE,
+    MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (progress == MAP_FAILED) {
+    perror("mmap");
+    return 1;
+  }
+  atomic_store(&progress->busy, EWCSlabCrashIdle);
+
+  unlink(path);
+
+  long bad = 0;
+  uint64_t operations = 0;
+  uint32_t repaired = 0;
+  uint32_t roundRepaired = 0;
+  double slowestAttach = 0;
+  for (long r = 0; r < rounds && bad == 0; ++r) {
+    uint64_t writerSeed = EWCSlabCrashRandom(&random);
+    pid_t writer = fork();
+    if (writer < 0) {
+      perror("fork");
+      return 1;
+    }
+    if (writer == 0) {
+      EWCSlabCrashWrite(path, (uint32_t)sessions, (uint32_t)stateSize, progress, writerSeed);
+      _exit(0);
+    }
+
+    // give the writer time to open the slab before killing it mid-operation
+    uint64_t before = atomic_load(&progress->operations);
+    usleep((useconds_t)(1 + EWCSlabCrashRandom(&random) % (uint64_t)maxMicros));
+    while (atomic_load(&progress->operations) == before) {
+      int status;
+      if (waitpid(writer, &status, WNOHANG) == writer) {
+        printf("writer exited early\n");
+        return 1;
+      }
+      sched_yield();
+    }
+
+    kill(writer, SIGKILL);
+    waitpid(writer, NULL, 0);
+
+    double attach;
+    bad += EWCSlabCrashCheck(path, (uint32_t)sessions, (uint32_t)stateSize, progress, &attach, &roundRepaired);
+    repaired += roundRepaired;
+    slowestAttach = (attach > slowestAttach) ? attach : slowestAttach;
+  }
+  operations = atomic_load(&progress->operations);
+
+  double attach = 0;
+  int error = EWCSlabCrashTimeAttach(path, (uint32_t)sessions, (uint32_t)stateSize, &attach);
+  if (error) {
+    fprintf(stderr, "%s: %s\n", path, strerror(error));
+    bad += 1;
+  }
+  unlink(path);
+
+  printf("crashes:    %ld writers killed after %llu operations\n", rounds, (unsigned long long)operations);
+  printf("recovered:  %u torn records freed, slowest reattach %.2f ms\n", repaired, slowestAttach * 1e3);
+  printf("reattach:   %ld live sessions of %ld bytes in %.2f ms\n", sessions, stateSize, attach * 1e3);
+  printf("%s\n", bad ? "FAILED" : "ok");
+
+  return bad ? 1 : 0;
+}
@@ -0,0 +1,63 @@
+//
+//  EWCSimulatedAnnouncementClock.h
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import "../EbbyCalc/EWCAnnouncementClockProtocol.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCSimulatedAnnouncementClock` keeps time only when told to, running the blocks scheduled on it as time is advanced past them, so that announcement timing can be played out without waiting.
+ */
+@interface EWCSimulatedAnnouncementClock : NSObject<EWCAnnouncementClockProtocol>
+
+/**
+  The current simulated time in seconds, starting at 0.
+ */
+@property (nonatomic, readonly) NSTimeInterval now;
+
+/**
+  The number of blocks scheduled that haven't run or been cancelled.
+ */
+@property (nonatomic, readonly) NSUInteger pendingCount;
+
+/**
+  The most blocks that have been pending at once.
+ */
+@property (nonatomic, readonly) NSUInteger peakPendingCount;
+
+/**
+  Creates a new clock.
+
+  @return The new clock.
+ */
++ (instancetype)clock;
+
+/**
+  Moves time forward, running each block that comes due, in the order they come due, with the time set to when each was due.
+
+  @param interval How far to move time forward, in seconds.
+ */
+- (void)advanceBy:(NSTimeInterval)interval;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,124 @@
+//
+//  EWCSimulatedAnnouncementClock.m
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCSimulatedAnnouncementClock.h"
+
+/**
+  `EWCSimulatedScheduledBlock` is a block waiting for the simulated time to reach it.  It also serves as the token for cancelling it.
+ */
+@interface EWCSimulatedScheduledBlock : NSObject
+
+@property (nonatomic) NSTimeInterval dueTime;
+@property (nonatomic) NSUInteger sequence;
+@property (nonatomic, copy) dispatch_block_t block;
+
+@end
+
+@implementation EWCSimulatedScheduledBlock
+
+@end
+
+@interface EWCSimulatedAnnouncementClock() {
+  NSMutableArray<EWCSimulatedScheduledBlock *> *_scheduled;  // the blocks that haven't run or been cancelled
+  NSUInteger _sequence;  // orders blocks due at the same time by when they were scheduled
+}
+
+@end
+
+@implementation EWCSimulatedAnnouncementClock
+
+///----------------------------------------------
+/// @name Construction and Initialization Methods
+///----------------------------------------------
+
++ (instancetype)clock {
+  return [EWCSimulatedAnnouncementClock new];
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _now = 0;
+    _scheduled = [NSMutableArray array];
+  }
+
+  return self;
+}
+
+///------------------------------
+/// @name Custom Property Methods
+///------------------------------
+
+- (NSUInteger)pendingCount {
+  return _scheduled.count;
+}
+
+///-----------------------------------
+/// @name EWCAnnouncementClock Methods
+///-----------------------------------
+
+- (id)scheduleBlock:(dispatch_block_t)block afterDelay:(NSTimeInterval)delay {
+  EWCSimulatedScheduledBlock *scheduled = [EWCSimulatedScheduledBlock new];
+  scheduled.dueTime = _now + MAX(0, delay);
+  scheduled.sequence = _sequence++;
+  scheduled.block = block;
+  [_scheduled addObject:scheduled];
+
+  _peakPendingCount = MAX(_peakPendingCount, _scheduled.count);
+
+  return scheduled;
+}
+
+- (void)cancelScheduledBlock:(id)token {
+  [_scheduled removeObjectIdenticalTo:token];
+}
+
+///-------------------
+/// @name Time Methods
+///-------------------
+
+- (void)advanceBy:(NSTimeInterval)interval {
+  NSTimeInterval end = _now + interval;
+
+  while (YES) {
+    // find the next block due by the end (blocks may schedule more as they run)
+    EWCSimulatedScheduledBlock *next = nil;
+    for (EWCSimulatedScheduledBlock *scheduled in _scheduled) {
+      if (scheduled.dueTime <= end
+        && (! next || scheduled.dueTime < next.dueTime
+          || (scheduled.dueTime == next.dueTime && scheduled.sequence < next.sequence))) {
+        next = scheduled;
+      }
+    }
+
+    if (! next) {
+      break;
+    }
+
+    [_scheduled removeObjectIdenticalTo:next];
+    _now = MAX(_now, next.dueTime);
+    next.block();
+  }
+
+  _now = end;
+}
+
+@end
@@ -0,0 +1,208 @@
+//
+//  EWCSoakMain.m
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import <stdio.h>
+#import <stdlib.h>
+#import <time.h>
+#import <unistd.h>
+#import "EWCCalculator.h"
+#import "EWCFuzzGenerator.h"
+#import "EWCKeySoundEngine.h"
+#import "EWCLatencyHistogram.h"
+#import "EWCOfflineKeySoundBackend.h"
+#import "EWCSoakMonitor.h"
+
+// the number of keys generated at a time
+#define EWCSoakChunkSize 4096
+
+// the key sounds, in the order of the EWCKeySound values
+static const char * const s_soundNames[] = {
+  "key_press_click.wav",
+  "key_press_delete.wav",
+  "key_press_modifier.wav",
+};
+
+/**
+  Gets the current time from a clock that doesn't jump.
+
+  @return The time in nanoseconds.
+ */
+static inline uint64_t EWCSoakNow(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+/**
+  Prints the command line usage.
+
+  @param name The name the tool was run as.
+ */
+static void EWCSoakUsage(const char *name) {
+  fprintf(stderr,
+    "usage: %s [-n keys] [-i interval] [-w warmup] [-m bytes] [-o voices] [-p ns] [-s seed] [-d digits] [-L locale] [-a dir]\n"
+    "  -n  keys to press (default 200000000)\n"
+    "  -i  keys between samples (default 1000000)\n"
+    "  -w  initial samples left out of the growth slopes (default 3)\n"
+    "  -m  most resident memory growth allowed, in bytes per million keys (default 65536)\n"
+    "  -o  most playing voice growth allowed, per million keys (default 1)\n"
+    "  -p  most p99 latency growth allowed, in ns per million keys (default 100)\n"
+    "  -s  random seed (default 1)\n"
+    "  -d  maximum digits (default 16)\n"
+    "  -L  locale identifier (default en_US)\n"
+    "  -a  directory holding the key sound WAV files (default ../EbbyCalc/Resources/audio)\n",
+    name);
+}
+
+int main(int argc, char * argv[]) {
+  @autoreleasepool {
+    uint64_t keyLimit = 200000000;
+    uint64_t interval = 1000000;
+    uint64_t seed = 1;
+    NSInteger maximumDigits = 16;
+    const char *localeIdentifier = "en_US";
+    const char *soundDirectory = "../EbbyCalc/Resources/audio";
+    EWCSoakMonitor *monitor = [EWCSoakMonitor monitor];
+
+    int option;
+    while ((option = getopt(argc, argv, "n:i:w:m:o:p:s:d:L:a:h")) != -1) {
+      switch (option) {
+        case 'n': keyLimit = strtoull(optarg, NULL, 10); break;
+        case 'i': interval = strtoull(optarg, NULL, 10); break;
+        case 'w': monitor.warmupSamples = (NSUInteger)atol(optarg); break;
+        case 'm': monitor.maximumResidentSlope = atof(optarg); break;
+        case 'o': monitor.maximumObjectSlope = atof(optarg); break;
+        case 'p': monitor.maximumLatencySlope = atof(optarg); break;
+        case 's': seed = strtoull(optarg, NULL, 10); break;
+        case 'd': maximumDigits = atol(optarg); break;
+        case 'L': localeIdentifier = optarg; break;
+        case 'a': soundDirectory = optarg; break;
+        default:
+          EWCSoakUsage(argv[0]);
+          return (option == 'h') ? 0 : 2;
+      }
+    }
+
+    if (interval == 0) {
+      EWCSoakUsage(argv[0]);
+      return 2;
+    }
+
+    EWCCalculator *calculator = [EWCCalculator calculator];
+    calculator.locale = [NSLocale localeWithLocaleIdentifier:@(localeIdentifier)];
+    calculator.maximumDigits = maximumDigits;
+
+    NSMutableArray<NSData *> *soundData = [NSMutableArray array];
+    for (size_t i = 0; i < sizeof(s_soundNames) / sizeof(s_soundNames[0]); ++i) {
+      NSString *path = [NSString stringWithFormat:@"%s/%s", soundDirectory, s_soundNames[i]];
+      NSData *sound = [NSData dataWithContentsOfFile:path];
+      if (! sound) {
+        fprintf(stderr, "couldn't read %s\n", path.UTF8String);
+        return 1;
+      }
+      [soundData addObject:sound];
+    }
+
+    // the sounds are played through the same engine the app uses, on an
+    // output that only mixes when asked to
+    EWCOfflineKeySoundBackend *backend = [EWCOfflineKeySoundBackend backendWithBufferFrameCount:256];
+    EWCKeySoundEngine *engine = [EWCKeySoundEngine engineWithSoundData:soundData backend:backend];
+    if (! engine || ! [engine start]) {
+      fprintf(stderr, "couldn't start the key sounds from %s\n", soundDirectory);
+      return 1;
+    }
+
+    EWCFuzzGenerator generator;
+    EWCFuzzGeneratorInit(&generator, seed, maximumDigits);
+    EWCCalculatorKey keys[EWCSoakChunkSize];
+
+    EWCLatencyHistogram *histogram = malloc(sizeof(EWCLatencyHistogram));
+    EWCLatencyHistogramClear(histogram);
+
+    fprintf(stdout, "%12s %8s %12s %8s %8s %8s %8s\n",
+      "keys", "seconds", "rss", "voices", "p50", "p99", "p99.9");
+
+    uint64_t start = EWCSoakNow();
+    uint64_t pressed = 0;
+    uint64_t nextSample = interval;
+    while (pressed < keyLimit) {
+      @autoreleasepool {
+        NSUInteger count = (NSUInteger)MIN((uint64_t)EWCSoakChunkSize, keyLimit - pressed);
+        EWCFuzzGeneratorFill(&generator, keys, count);
+
+        for (NSUInteger i = 0; i < count; ++i) {
+          // a key press in the app plays the click, processes the key, and
+          // then reads the display
+          uint64_t before = EWCSoakNow();
+          [engine playSoundForKey:keys[i]];
+          [calculator pressKey:keys[i]];
+          (void)calculator.displayContent;
+          EWCLatencyHistogramRecord(histogram, EWCSoakNow() - before);
+
+          // keys are simulated as pressed every 5ms, faster than a click
+          // finishes, so that voices overlap.  The audio thread renders in
+          // the app, so it isn't timed.
+          [backend renderInterval:0.005];
+        }
+
+        pressed += count;
+      }
+
+      if (pressed >= nextSample || pressed == keyLimit) {
+        EWCSoakSample sample = {
+          .keyCount = pressed,
+          .elapsed = (EWCSoakNow() - start) / 1e9,
+          .residentBytes = EWCSoakResidentBytes(),
+          .liveObjects = engine.activeVoiceCount,
+          .p50 = EWCLatencyHistogramPercentile(histogram, 50),
+          .p99 = EWCLatencyHistogramPercentile(histogram, 99),
+          .p999 = EWCLatencyHistogramPercentile(histogram, 99.9),
+        };
+        [monitor addSample:&sample];
+        EWCLatencyHistogramClear(histogram);
+
+        fprintf(stdout, "%12llu %8.1f %12llu %8lu %8llu %8llu %8llu\n",
+          (unsigned long long)sample.keyCount, sample.elapsed,
+          (unsigned long long)sample.residentBytes, (unsigned long)sample.liveObjects,
+          (unsigned long long)sample.p50, (unsigned long long)sample.p99,
+          (unsigned long long)sample.p999);
+        fflush(stdout);
+
+        nextSample = pressed + interval;
+      }
+    }
+
+    free(histogram);
+
+    fprintf(stdout, "growth per million keys: rss %.0f bytes, voices %.2f, p99 %.1f ns (stolen %lu, dropped %lu)\n",
+      monitor.residentSlope, monitor.objectSlope, monitor.latencySlope,
+      (unsigned long)engine.stolenCount, (unsigned long)engine.droppedCount);
+
+    NSArray<NSString *> *failures = [monitor failures];
+    for (NSString *failure in failures) {
+      fprintf(stderr, "FAILED: %s\n", failure.UTF8String);
+    }
+
+    return failures.count ? 1 : 0;
+  }
+}
@@ -0,0 +1,116 @@
+//
+//  EWCSoakMonitor.h
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+  `EWCSoakSample` is one measurement taken during a soak run.
+ */
+typedef struct {
+  uint64_t keyCount;  // the keys pressed when the sample was taken
+  double elapsed;  // the seconds since the run started
+  uint64_t residentBytes;  // the resident memory of the process
+  NSUInteger liveObjects;  // the number of tracked objects still alive
+  uint64_t p50;  // the median key latency since the previous sample, in nanoseconds
+  uint64_t p99;  // the 99th percentile key latency since the previous sample
+  uint64_t p999;  // the 99.9th percentile key latency since the previous sample
+} EWCSoakSample;
+
+/**
+  Gets the resident memory of the current process.
+
+  @return The resident size in bytes, or 0 if it can't be read.
+ */
+uint64_t EWCSoakResidentBytes(void);
+
+/**
+  `EWCSoakMonitor` collects the samples from a soak run and decides whether memory, live objects, or latency are growing with use.
+
+  Growth is measured as the least squares slope of each quantity against the number of keys pressed (per million keys), ignoring the first `warmupSamples` samples while caches and pools fill.  A run fails if any slope is above its limit.
+ */
+@interface EWCSoakMonitor : NSObject
+
+/**
+  The number of initial samples left out of the slopes.  Defaults to 3.
+ */
+@property (nonatomic) NSUInteger warmupSamples;
+
+/**
+  The most resident memory growth allowed, in bytes per million keys.  Defaults to 64 KiB.
+ */
+@property (nonatomic) double maximumResidentSlope;
+
+/**
+  The most live object growth allowed, in objects per million keys.  Defaults to 1.
+ */
+@property (nonatomic) double maximumObjectSlope;
+
+/**
+  The most 99th percentile latency growth allowed, in nanoseconds per million keys.  Defaults to 100.
+ */
+@property (nonatomic) double maximumLatencySlope;
+
+/**
+  The number of samples collected.
+ */
+@property (nonatomic, readonly) NSUInteger sampleCount;
+
+/**
+  The resident memory growth, in bytes per million keys.
+ */
+@property (nonatomic, readonly) double residentSlope;
+
+/**
+  The live object growth, in objects per million keys.
+ */
+@property (nonatomic, readonly) double objectSlope;
+
+/**
+  The 99th percentile latency growth, in nanoseconds per million keys.
+ */
+@property (nonatomic, readonly) double latencySlope;
+
+/**
+  Creates a new monitor with the default limits.
+
+  @return The new monitor.
+ */
++ (instancetype)monitor;
+
+/**
+  Adds a sample.  Samples must be added in the order taken.
+
+  @param sample The sample to add.
+ */
+- (void)addSample:(const EWCSoakSample *)sample;
+
+/**
+  Describes each quantity whose growth is over its limit.
+
+  @return The descriptions, empty if the run passed.
+ */
+- (NSArray<NSString *> *)failures;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,184 @@
+//
+//  EWCSoakMonitor.m
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import "EWCSoakMonitor.h"
+#if defined(__APPLE__)
+#import <mach/mach.h>
+#else
+#import <unistd.h>
+#endif
+
+uint64_t EWCSoakResidentBytes(void) {
+#if defined(__APPLE__)
+  mach_task_basic_info_data_t info;
+  mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+  if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) != KERN_SUCCESS) {
+    return 0;
+  }
+
+  return info.resident_size;
+#else
+  // the second field is the resident page count
+  FILE *file = fopen("/proc/self/statm", "r");
+  if (! file) {
+    return 0;
+  }
+
+  unsigned long long size = 0;
+  unsigned long long resident = 0;
+  int fields = fscanf(file, "%llu %llu", &size, &resident);
+  fclose(file);
+
+  return (fields == 2) ? resident * (uint64_t)sysconf(_SC_PAGESIZE) : 0;
+#endif
+}
+
+@interface EWCSoakMonitor() {
+  NSMutableData *_samples;  // the EWCSoakSample values collected
+}
+
+@end
+
+@implementation EWCSoakMonitor
+
+///----------------------------------------------
+/// @name Construction and Initialization Methods
+///----------------------------------------------
+
++ (instancetype)monitor {
+  return [EWCSoakMonitor new];
+}
+
+/**
+  Implementation of the empty init method.  Sets the default limits.
+
+  @return The initialized instance.
+ */
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _samples = [NSMutableData new];
+    _warmupSamples = 3;
+    _maximumResidentSlope = 64 * 1024;
+    _maximumObjectSlope = 1;
+    _maximumLatencySlope = 100;
+  }
+
+  return self;
+}
+
+///------------------------------
+/// @name Custom Property Methods
+///------------------------------
+
+- (NSUInteger)sampleCount {
+  return _samples.length / sizeof(EWCSoakSample);
+}
+
+- (double)residentSlope {
+  return [self slopeOfValue:^(const EWCSoakSample *sample) {
+    return (double)sample->residentBytes;
+  }];
+}
+
+- (double)objectSlope {
+  return [self slopeOfValue:^(const EWCSoakSample *sample) {
+    return (double)sample->liveObjects;
+  }];
+}
+
+- (double)latencySlope {
+  return [self slopeOfValue:^(const EWCSoakSample *sample) {
+    return (double)sample->p99;
+  }];
+}
+
+///---------------------
+/// @name Sample Methods
+///---------------------
+
+- (void)addSample:(const EWCSoakSample *)sample {
+  [_samples appendBytes:sample length:sizeof(EWCSoakSample)];
+}
+
+- (NSArray<NSString *> *)failures {
+  NSMutableArray<NSString *> *failures = [NSMutableArray new];
+
+  double resident = self.residentSlope;
+  if (resident > _maximumResidentSlope) {
+    [failures addObject:[NSString stringWithFormat:@"resident memory grew %.0f bytes per million keys (limit %.0f)",
+      resident, _maximumResidentSlope]];
+  }
+
+  double objects = self.objectSlope;
+  if (objects > _maximumObjectSlope) {
+    [failures addObject:[NSString stringWithFormat:@"live objects grew %.2f per million keys (limit %.2f)",
+      objects, _maximumObjectSlope]];
+  }
+
+  double latency = self.latencySlope;
+  if (latency > _maximumLatencySlope) {
+    [failures addObject:[NSString stringWithFormat:@"p99 latency grew %.1f ns per million keys (limit %.1f)",
+      latency, _maximumLatencySlope]];
+  }
+
+  return failures;
+}
+
+///------------------------------
+/// @name Internal helper methods
+///------------------------------
+
+/**
+  Computes the least squares slope of one sample quantity against the keys pressed, leaving out the warmup samples.
+
+  @param value Reads the quantity from a sample.
+
+  @return The slope per million keys, or 0 if there are fewer than two samples after the warmup.
+ */
+- (double)slopeOfValue:(NS_NOESCAPE double(^)(const EWCSoakSample *sample))value {
+  const EWCSoakSample *samples = _samples.bytes;
+  NSUInteger count = self.sampleCount;
+  if (count < _warmupSamples + 2) {
+    return 0;
+  }
+
+  double n = 0, sumX = 0, sumY = 0, sumXX = 0, sumXY = 0;
+  for (NSUInteger i = _warmupSamples; i < count; ++i) {
+    double x = samples[i].keyCount / 1e6;
+    double y = value(&samples[i]);
+
+    n += 1;
+    sumX += x;
+    sumY += y;
+    sumXX += x * x;
+    sumXY += x * y;
+  }
+
+  double denominator = n * sumXX - sumX * sumX;
+  if (denominator == 0) {
+    return 0;
+  }
+
+  return (n * sumXY - sumX * sumY) / denominator;
+}
+
+@end
@@ -0,0 +1,315 @@
+//
+//  EWCTapeBatchMain.m
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import <stdio.h>
+#import <stdlib.h>
+#import <time.h>
+#import <unistd.h>
+#import "EWCResultColumnWriter.h"
+#import "EWCTapeBatchEvaluator.h"
+
+/**
+  The tax rates an audit tape opens by storing, the most common first.
+ */
+static const char * const s_taxRates[] = { "8.25", "7.5", "6", "9.125", "10" };
+
+/**
+  Gets the current time from a clock that doesn't jump.
+
+  @return The time in seconds.
+ */
+static NSTimeInterval EWCTapeBatchNow(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+  Advances a xorshift generator, so that the corpus is repeatable from a seed.
+
+  @param state The generator state.  Must not be zero.
+
+  @return The next value.
+ */
+static uint64_t EWCTapeBatchNextRandom(uint64_t *state) {
+  uint64_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  *state = x;
+
+  return x;
+}
+
+/**
+  Picks an index with the low indexes much more likely than the high, as a few common items make up most of an audit.
+
+  @param count The number of indexes to pick from.
+  @param state The generator state.
+
+  @return The index, less than `count`.
+ */
+static NSUInteger EWCTapeBatchSkewedIndex(NSUInteger count, uint64_t *state) {
+  double r = (EWCTapeBatchNextRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+
+  return (NSUInteger)(r * r * r * count);
+}
+
+/**
+  Appends the keys typed as characters to a tape.
+
+  @param tape The keys of the tape.
+  @param str The hardware keyboard characters of the keys.
+ */
+static void EWCTapeBatchAppendKeys(NSMutableData *tape, const char *str) {
+  for (const char *c = str; *c; ++c) {
+    EWCCalculatorKey key = EWCCalculatorKeyFromCharacter(*c);
+    [tape appendBytes:&key length:sizeof(key)];
+  }
+}
+
+/**
+  Checks whether two values are the same, treating NaN as matching NaN.
+
+  @param a The first value.
+  @param b The second value.
+
+  @return YES if the values match.
+ */
+static BOOL EWCTapeBatchValuesMatch(NSDecimal a, NSDecimal b) {
+  BOOL aNaN = NSDecimalIsNotANumber(&a);
+  BOOL bNaN = NSDecimalIsNotANumber(&b);
+  if (aNaN || bNaN) {
+    return aNaN && bNaN;
+  }
+
+  return NSDecimalCompare(&a, &b) == NSOrderedSame;
+}
+
+/**
+  Checks whether two evaluations reached the same results.
+
+  @param a The first results.
+  @param b The second results.
+
+  @return YES if the results match.
+ */
+static BOOL EWCTapeBatchResultsMatch(const EWCTapeResult *a, const EWCTapeResult *b) {
+  return EWCTapeBatchValuesMatch(a->display, b->display)
+    && EWCTapeBatchValuesMatch(a->memory, b->memory)
+    && EWCTapeBatchValuesMatch(a->taxRate, b->taxRate)
+    && a->hasMemory == b->hasMemory
+    && a->error == b->error;
+}
+
+/**
+  Prints the command line usage.
+
+  @param name The name the tool was run as.
+ */
+static void EWCTapeBatchUsage(const char *name) {
+  fprintf(stderr,
+    "usage: %s [-n tapes] [-i items] [-l length] [-u percent] [-s seed] [-d digits] [-o file]\n"
+    "  -n  number of tapes in the batch (default 100000)\n"
+    "  -i  number of different items the tapes are keyed from (default 64)\n"
+    "  -l  most items on a tape (default 8)\n"
+    "  -u  percent of tapes that resubmit an earlier tape (default 25)\n"
+    "  -s  random seed for the corpus (default 1)\n"
+    "  -d  maximum digits (default 16)\n"
+    "  -o  write the batch results to this file, in columns\n",
+    name);
+}
+
+int main(int argc, char * argv[]) {
+  @autoreleasepool {
+    NSUInteger tapeCount = 100000;
+    NSUInteger itemCount = 64;
+    NSUInteger maximumItems = 8;
+    NSUInteger resubmitPercent = 25;
+    uint64_t seed = 1;
+    NSInteger maximumDigits = 16;
+    const char *outputPath = NULL;
+
+    int option;
+    while ((option = getopt(argc, argv, "n:i:l:u:s:d:o:h")) != -1) {
+      switch (option) {
+        case 'n': tapeCount = (NSUInteger)atol(optarg); break;
+        case 'i': itemCount = (NSUInteger)atol(optarg); break;
+        case 'l': maximumItems = (NSUInteger)atol(optarg); break;
+        case 'u': resubmitPercent = (NSUInteger)atol(optarg); break;
+        case 's': seed = strtoull(optarg, NULL, 10); break;
+        case 'd': maximumDigits = atol(optarg); break;
+        case 'o': outputPath = optarg; break;
+        default:
+          EWCTapeBatchUsage(argv[0]);
+          return (option == 'h') ? 0 : 2;
+      }
+    }
+
+    if (optind != argc || tapeCount == 0 || itemCount == 0 || maximumItems == 0 || resubmitPercent > 100) {
+      EWCTapeBatchUsage(argv[0]);
+      return 2;
+    }
+
+    printf("seed: %llu\n", (unsigned long long)seed);
+    uint64_t state = seed ? seed : 1;
+
+    // the catalog of items, each keyed as a price and quantity, taxed, and
+    // added into memory
+    NSMutableArray<NSData *> *items = [NSMutableArray arrayWithCapacity:itemCount];
+    for (NSUInteger i = 0; i < itemCount; ++i) {
+      unsigned long cents = 100 + EWCTapeBatchNextRandom(&state) % 99900;
+      unsigned long quantity = 1 + EWCTapeBatchNextRandom(&state) % 12;
+
+      char str[64];
+      if (quantity == 1) {
+        snprintf(str, sizeof(str), "%lu.%02luws", cents / 100, cents % 100);
+      } else {
+        snprintf(str, sizeof(str), "%lu.%02lu*%lu=ws", cents / 100, cents % 100, quantity);
+      }
+
+      NSMutableData *item = [NSMutableData new];
+      EWCTapeBatchAppendKeys(item, str);
+      [items addObject:item];
+    }
+
+    // each tape stores a tax rate with Rate and Tax+, keys its items, and
+    // recalls the memory total.  the common items come first, so tapes share
+    // long openings, and some tapes are resubmitted whole.
+    NSMutableArray<NSData *> *tapes = [NSMutableArray arrayWithCapacity:tapeCount];
+    NSUInteger rateCount = sizeof(s_taxRates) / sizeof(s_taxRates[0]);
+    for (NSUInteger t = 0; t < tapeCount; ++t) {
+      if (t > 0 && EWCTapeBatchNextRandom(&state) % 100 < resubmitPercent) {
+        [tapes addObject:tapes[EWCTapeBatchNextRandom(&state) % t]];
+        continue;
+      }
+
+      NSMutableData *tape = [NSMutableData new];
+      char opening[32];
+      snprintf(opening, sizeof(opening), "%sqw", s_taxRates[EWCTapeBatchSkewedIndex(rateCount, &state)]);
+      EWCTapeBatchAppendKeys(tape, opening);
+
+      NSUInteger length = 1 + EWCTapeBatchNextRandom(&state) % maximumItems;
+      for (NSUInteger i = 0; i < length; ++i) {
+        [tape appendData:items[EWCTapeBatchSkewedIndex(itemCount, &state)]];
+      }
+
+      EWCTapeBatchAppendKeys(tape, "a");
+      [tapes addObject:tape];
+    }
+
+    NSMutableData *keyData = [NSMutableData dataWithLength:tapeCount * sizeof(EWCCalculatorKey *)];
+    NSMutableData *countData = [NSMutableData dataWithLength:tapeCount * sizeof(NSUInteger)];
+    const EWCCalculatorKey **keys = keyData.mutableBytes;
+    NSUInteger *counts = countData.mutableBytes;
+    for (NSUInteger t = 0; t < tapeCount; ++t) {
+      keys[t] = tapes[t].bytes;
+      counts[t] = tapes[t].length / sizeof(EWCCalculatorKey);
+    }
+
+    NSMutableData *independentData = [NSMutableData dataWithLength:tapeCount * sizeof(EWCTapeResult)];
+    NSMutableData *batchData = [NSMutableData dataWithLength:tapeCount * sizeof(EWCTapeResult)];
+    EWCTapeResult *independentResults = independentData.mutableBytes;
+    EWCTapeResult *batchResults = batchData.mutableBytes;
+
+    EWCTapeBatchEvaluator *evaluator = [EWCTapeBatchEvaluator evaluatorWithMaximumDigits:maximumDigits];
+
+    // the baseline, pressing every key of every tape
+    NSTimeInterval start = EWCTapeBatchNow();
+    for (NSUInteger t = 0; t < tapeCount; ++t) {
+      @autoreleasepool {
+        [evaluator evaluateKeys:keys[t] count:counts[t] result:&independentResults[t]];
+      }
+    }
+    NSTimeInterval independentTime = EWCTapeBatchNow() - start;
+
+    start = EWCTapeBatchNow();
+    [evaluator evaluateTapes:keys counts:counts count:tapeCount results:batchResults];
+    NSTimeInterval batchTime = EWCTapeBatchNow() - start;
+
+    NSUInteger mismatches = 0;
+    for (NSUInteger t = 0; t < tapeCount; ++t) {
+      if (! EWCTapeBatchResultsMatch(&batchResults[t], &independentResults[t])) {
+        if (mismatches == 0) {
+          fprintf(stderr, "tape %lu: batch %s, independent %s\n",
+            (unsigned long)t,
+            [NSDecimalNumber decimalNumberWithDecimal:batchResults[t].display].description.UTF8String,
+            [NSDecimalNumber decimalNumberWithDecimal:independentResults[t].display].description.UTF8String);
+        }
+        ++mismatches;
+      }
+    }
+
+    NSUInteger uniqueCount = evaluator.uniqueTapeCount;
+    NSUInteger pressedCount = evaluator.pressedKeyCount;
+    printf("corpus:      %lu tapes, %lu keys (%lu items, up to %lu per tape)\n",
+      (unsigned long)tapeCount, (unsigned long)evaluator.keyCount,
+      (unsigned long)itemCount, (unsigned long)maximumItems);
+    printf("unique:      %lu tapes (%.2fx dedupe)\n",
+      (unsigned long)uniqueCount, (double)tapeCount / uniqueCount);
+    printf("trie:        %lu keys pressed (%.2fx fewer), %lu branch points\n",
+      (unsigned long)pressedCount,
+      pressedCount ? (double)evaluator.keyCount / pressedCount : 0.0,
+      (unsigned long)evaluator.branchCount);
+    printf("independent: %.3f s (%.2f us per tape)\n",
+      independentTime, independentTime * 1e6 / tapeCount);
+    printf("batch:       %.3f s (%.2f us per tape, %.1fx)\n",
+      batchTime, batchTime * 1e6 / tapeCount,
+      batchTime > 0 ? independentTime / batchTime : 0.0);
+
+    BOOL writeFailed = NO;
+    if (outputPath) {
+      EWCResultColumnWriter *writer = [EWCResultColumnWriter
+        writerWithOutputStream:[NSOutputStream outputStreamToFileAtPath:@(outputPath) append:NO]
+        rowsPerBlock:4096];
+
+      for (NSUInteger t = 0; t < tapeCount; ++t) {
+        EWCResultRow row;
+        row.sessionID = t;
+        row.keyCount = counts[t];
+        row.display = batchResults[t].display;
+        row.memory = batchResults[t].memory;
+        row.error = batchResults[t].error;
+        row.status = batchResults[t].hasMemory ? EWCResultMemoryStatus : EWCResultNoStatus;
+        [writer appendRow:&row];
+      }
+
+      writeFailed = ! [writer finish];
+      if (writeFailed) {
+        fprintf(stderr, "can't write the results to %s\n", outputPath);
+      } else {
+        printf("results:     %lu rows written to %s (%lu bytes)\n",
+          (unsigned long)writer.rowCount, outputPath, (unsigned long)writer.bytesWritten);
+      }
+    }
+
+    if (mismatches) {
+      fprintf(stderr, "%lu tapes gave different results\n", (unsigned long)mismatches);
+    }
+
+    BOOL failed = writeFailed || mismatches > 0;
+    printf("%s\n", failed ? "FAILED" : "ok");
+
+    return failed ? 1 : 0;
+  }
+}
@@ -0,0 +1,256 @@
+//
+//  EWCTapeMain.m
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#import <Foundation/Foundation.h>
+#import <stdio.h>
+#import <stdlib.h>
+#import <time.h>
+#import <unistd.h>
+#import "EWCDecimalDigits.h"
+#import "EWCTapeCompiler.h"
+#import "EWCTapeProgram.h"
+
+/**
+  Gets the current time from a clock that doesn't jump.
+
+  @return The time in seconds.
+ */
+static NSTimeInterval EWCTapeNow(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+  Advances a xorshift generator, so that the inputs are repeatable from a seed.
+
+  @param state The generator state.  Must not be zero.
+
+  @return The next value.
+ */
+static uint64_t EWCTapeNextRandom(uint64_t *state) {
+  uint64_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  *state = x;
+
+  return x;
+}
+
+/**
+  Makes a random input shaped like a number entered on the tape, with the same count of digits, the same sign, and the decimal in the same place.
+
+  @param templateValue The number entered on the tape.
+  @param state The generator state.
+
+  @return The random input.
+ */
+static NSDecimal EWCTapeRandomInput(NSDecimal templateValue, uint64_t *state) {
+  EWCDecimalDigits digits;
+  if (! EWCDecimalDigitsFromDecimal(&templateValue, &digits)) {
+    return templateValue;
+  }
+
+  for (short i = 0; i < digits.count; ++i) {
+    uint64_t r = EWCTapeNextRandom(state);
+
+    // keep the leading digit non-zero, so that the value keeps its width
+    digits.digits[i] = (i == 0 && digits.count > 1) ? 1 + r % 9 : r % 10;
+  }
+
+  NSDecimal value;
+  EWCDecimalFromDigits(&digits, &value);
+
+  return value;
+}
+
+/**
+  Checks whether two values are the same, treating NaN as matching NaN.
+
+  @param a The first value.
+  @param b The second value.
+
+  @return YES if the values match.
+ */
+static BOOL EWCTapeValuesMatch(NSDecimal a, NSDecimal b) {
+  BOOL aNaN = NSDecimalIsNotANumber(&a);
+  BOOL bNaN = NSDecimalIsNotANumber(&b);
+  if (aNaN || bNaN) {
+    return aNaN && bNaN;
+  }
+
+  return NSDecimalCompare(&a, &b) == NSOrderedSame;
+}
+
+/**
+  Checks whether two runs reached the same results.
+
+  @param a The first results.
+  @param b The second results.
+
+  @return YES if the results match.
+ */
+static BOOL EWCTapeResultsMatch(const EWCTapeResult *a, const EWCTapeResult *b) {
+  return EWCTapeValuesMatch(a->display, b->display)
+    && EWCTapeValuesMatch(a->memory, b->memory)
+    && EWCTapeValuesMatch(a->taxRate, b->taxRate)
+    && a->hasMemory == b->hasMemory
+    && a->error == b->error;
+}
+
+/**
+  Prints the command line usage.
+
+  @param name The name the tool was run as.
+ */
+static void EWCTapeUsage(const char *name) {
+  fprintf(stderr,
+    "usage: %s [-n vectors] [-s seed] [-d digits] [-r rate] [-m memory] keys\n"
+    "  -n  number of input vectors to run (default 10000)\n"
+    "  -s  random seed for the inputs (default 1)\n"
+    "  -d  maximum digits (default 16)\n"
+    "  -r  starting tax rate (default 0)\n"
+    "  -m  starting memory (default 0)\n"
+    "  keys are the hardware keyboard characters, for example 19.99*2=ws5.25*4=wsa\n",
+    name);
+}
+
+int main(int argc, char * argv[]) {
+  @autoreleasepool {
+    NSUInteger vectorCount = 10000;
+    uint64_t seed = 1;
+    NSInteger maximumDigits = 16;
+    NSDecimalNumber *taxRate = [NSDecimalNumber zero];
+    NSDecimalNumber *memory = [NSDecimalNumber zero];
+
+    int option;
+    while ((option = getopt(argc, argv, "n:s:d:r:m:h")) != -1) {
+      switch (option) {
+        case 'n': vectorCount = (NSUInteger)atol(optarg); break;
+        case 's': seed = strtoull(optarg, NULL, 10); break;
+        case 'd': maximumDigits = atol(optarg); break;
+        case 'r': taxRate = [NSDecimalNumber decimalNumberWithString:@(optarg)]; break;
+        case 'm': memory = [NSDecimalNumber decimalNumberWithString:@(optarg)]; break;
+        default:
+          EWCTapeUsage(argv[0]);
+          return (option == 'h') ? 0 : 2;
+      }
+    }
+
+    if (optind != argc - 1 || vectorCount == 0) {
+      EWCTapeUsage(argv[0]);
+      return 2;
+    }
+
+    NSString *str = @(argv[optind]);
+    NSMutableData *keyData = [NSMutableData dataWithLength:str.length * sizeof(EWCCalculatorKey)];
+    EWCCalculatorKey *keys = keyData.mutableBytes;
+    for (NSUInteger i = 0; i < str.length; ++i) {
+      keys[i] = EWCCalculatorKeyFromCharacter([str characterAtIndex:i]);
+      if (keys[i] == EWCCalculatorNoKey) {
+        fprintf(stderr, "unknown key '%c'\n", (char)[str characterAtIndex:i]);
+        return 2;
+      }
+    }
+
+    NSTimeInterval start = EWCTapeNow();
+    EWCTapeProgram *program = [[EWCTapeCompiler compilerWithMaximumDigits:maximumDigits]
+      compileKeys:keys
+      count:str.length];
+    NSTimeInterval compileTime = EWCTapeNow() - start;
+
+    program.startingTaxRate = taxRate;
+    program.startingMemory = memory;
+
+    fprintf(stdout, "%lu keys compiled to %lu instructions with %lu inputs in %.1f us%s\n",
+      (unsigned long)program.keyCount,
+      (unsigned long)program.instructionCount,
+      (unsigned long)program.slotCount,
+      compileTime * 1e6,
+      program.alwaysReplays ? " (always ends in error, so every run replays)" : "");
+
+    // random inputs shaped like the tape's own numbers
+    NSUInteger slotCount = program.slotCount;
+    NSMutableData *templateData = [NSMutableData dataWithLength:(slotCount + 1) * sizeof(NSDecimal)];
+    NSDecimal *templateInputs = templateData.mutableBytes;
+    [program getTemplateInputs:templateInputs];
+
+    NSMutableData *inputData = [NSMutableData dataWithLength:(vectorCount * slotCount + 1) * sizeof(NSDecimal)];
+    NSDecimal *inputs = inputData.mutableBytes;
+    uint64_t state = seed ? seed : 1;
+    for (NSUInteger v = 0; v < vectorCount; ++v) {
+      for (NSUInteger i = 0; i < slotCount; ++i) {
+        inputs[v * slotCount + i] = EWCTapeRandomInput(templateInputs[i], &state);
+      }
+    }
+
+    NSMutableData *replayData = [NSMutableData dataWithLength:vectorCount * sizeof(EWCTapeResult)];
+    NSMutableData *runData = [NSMutableData dataWithLength:vectorCount * sizeof(EWCTapeResult)];
+    EWCTapeResult *replayResults = replayData.mutableBytes;
+    EWCTapeResult *runResults = runData.mutableBytes;
+
+    // the baseline, typing each vector's numbers and pressing the keys
+    start = EWCTapeNow();
+    for (NSUInteger v = 0; v < vectorCount; ++v) {
+      @autoreleasepool {
+        [program replayKeysWithInputs:inputs + v * slotCount result:&replayResults[v]];
+      }
+    }
+    NSTimeInterval replayTime = EWCTapeNow() - start;
+
+    start = EWCTapeNow();
+    [program runWithInputVectors:inputs count:vectorCount results:runResults];
+    NSTimeInterval runTime = EWCTapeNow() - start;
+
+    NSUInteger mismatches = 0;
+    NSUInteger fallbacks = 0;
+    for (NSUInteger v = 0; v < vectorCount; ++v) {
+      if (runResults[v].replayed) {
+        ++fallbacks;
+      }
+      if (! EWCTapeResultsMatch(&runResults[v], &replayResults[v])) {
+        if (mismatches == 0) {
+          fprintf(stderr, "vector %lu: compiled %s, replayed %s\n",
+            (unsigned long)v,
+            [NSDecimalNumber decimalNumberWithDecimal:runResults[v].display].description.UTF8String,
+            [NSDecimalNumber decimalNumberWithDecimal:replayResults[v].display].description.UTF8String);
+        }
+        ++mismatches;
+      }
+    }
+
+    fprintf(stdout, "replayed keys: %lu vectors in %.3f s (%.2f us each)\n",
+      (unsigned long)vectorCount, replayTime, replayTime * 1e6 / vectorCount);
+    fprintf(stdout, "compiled:      %lu vectors in %.3f s (%.2f us each, %.1fx), %lu fell back to keys\n",
+      (unsigned long)vectorCount, runTime, runTime * 1e6 / vectorCount,
+      runTime > 0 ? replayTime / runTime : 0.0,
+      (unsigned long)fallbacks);
+
+    if (mismatches) {
+      fprintf(stderr, "%lu vectors gave different results\n", (unsigned long)mismatches);
+      return 1;
+    }
+
+    return 0;
+  }
+}
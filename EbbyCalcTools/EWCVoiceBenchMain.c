@@ -0,0 +1,259 @@
+//
+//  EWCVoiceBenchMain.c
+//  EbbyCalcTools
+//
+//  Created by Ansel Rognlie on 10/19/26.
+//  Copyright © 2026 Ansel Rognlie. All rights reserved.
+//
+
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "EWCKeySoundSample.h"
+#include "EWCKeyVoicePool.h"
+
+// the key sounds, in the order of the EWCKeySound values
+static const char * const s_soundNames[] = {
+  "key_press_click.wav",
+  "key_press_delete.wav",
+  "key_press_modifier.wav",
+};
+
+#define EWCVoiceBenchSoundCount (int)(sizeof(s_soundNames) / sizeof(s_soundNames[0]))
+
+/**
+  Gets the current time from a monotonic clock.
+
+  @return The time in seconds.
+ */
+static double EWCVoiceBenchNow(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+  Generates a pseudo-random number (xorshift64*).
+
+  @param state The generator state, which must not be zero.
+
+  @return The next number.
+ */
+static uint64_t EWCVoiceBenchRandom(uint64_t *state) {
+  uint64_t x = *state;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  *state = x;
+
+  return x * 2685821657736338717ULL;
+}
+
+/**
+  Reads a whole file.
+
+  @param path The path of the file.
+  @param length Receives the length of the contents.
+
+  @return The contents, which the caller must free, or NULL if the file couldn't be read.
+ */
+static void *EWCVoiceBenchRead(const char *path, size_t *length) {
+  FILE *file = fopen(path, "rb");
+  if (! file) {
+    return NULL;
+  }
+
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  void *bytes = (size > 0) ? malloc((size_t)size) : NULL;
+  if (bytes && fread(bytes, 1, (size_t)size, file) != (size_t)size) {
+    free(bytes);
+    bytes = NULL;
+  }
+  fclose(file);
+
+  *length = (size_t)size;
+  return bytes;
+}
+
+/**
+  Prints the command line usage.
+
+  @param name The name the tool was run as.
+ */
+static void EWCVoiceBenchUsage(const char *name) {
+  fprintf(stderr,
+    "usage: %s [-d dir] [-n keys] [-r rate] [-b frames] [-s seed]\n"
+    "  -d  directory holding the key sound WAV files (default ../EbbyCalc/Resources/audio)\n"
+    "  -n  key presses (default 1000000)\n"
+    "  -r  average key presses per second (default 12)\n"
+    "  -b  frames per output buffer (default 256)\n"
+    "  -s  random seed (default from the clock)\n",
+    name);
+}
+
+int main(int argc, char * argv[]) {
+  const char *dir = "../EbbyCalc/Resources/audio";
+  long keys = 1000000;
+  double rate = 12;
+  long bufferFrames = 256;
+  uint64_t seed = (uint64_t)time(NULL);
+
+  int option;
+  while ((option = getopt(argc, argv, "d:n:r:b:s:h")) != -1) {
+    switch (option) {
+      case 'd': dir = optarg; break;
+      case 'n': keys = atol(optarg); break;
+      case 'r': rate = atof(optarg); break;
+      case 'b': bufferFrames = atol(optarg); break;
+      case 's': seed = strtoull(optarg, NULL, 10); break;
+      default:
+        EWCVoiceBenchUsage(argv[0]);
+        return (option == 'h') ? 0 : 2;
+    }
+  }
+
+  if (keys < 1 || rate <= 0 || bufferFrames < 1 || bufferFrames > 8192) {
+    EWCVoiceBenchUsage(argv[0]);
+    return 2;
+  }
+
+  printf("seed: %llu\n", (unsigned long long)seed);
+  uint64_t state = seed ? seed : 1;
+
+  // read the files once; the baseline decodes them again for every key
+  void *files[EWCVoiceBenchSoundCount];
+  size_t lengths[EWCVoiceBenchSoundCount];
+  EWCKeySoundSample samples[EWCVoiceBenchSoundCount];
+  const EWCKeySoundSample *sounds[EWCVoiceBenchSoundCount];
+  for (int i = 0; i < EWCVoiceBenchSoundCount; ++i) {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s", dir, s_soundNames[i]);
+    files[i] = EWCVoiceBenchRead(path, &lengths[i]);
+    if (! files[i] || ! EWCKeySoundSampleDecodeWav(files[i], lengths[i], &samples[i])) {
+      fprintf(stderr, "can't decode %s\n", path);
+      return 1;
+    }
+    sounds[i] = &samples[i];
+  }
+
+  // the sound of each key press, weighted towards the digit clicks, and the
+  // number of frames from the previous key press
+  int *keySounds = malloc((size_t)keys * sizeof(int));
+  uint32_t *gaps = malloc((size_t)keys * sizeof(uint32_t));
+  double meanGap = samples[0].sampleRate / rate;
+  for (long i = 0; i < keys; ++i) {
+    uint64_t r = EWCVoiceBenchRandom(&state) % 20;
+    keySounds[i] = (r < 16) ? 0 : (r < 19) ? 1 : 2;
+    gaps[i] = (uint32_t)(meanGap * (0.25 + 1.5 * (double)(EWCVoiceBenchRandom(&state) % 1000) / 1000.0));
+  }
+
+  // the old tap path made a player, decoding the sound, for every key press.
+  // decoding alone is a lower bound on what that cost.
+  double decodeSum = 0;
+  double start = EWCVoiceBenchNow();
+  for (long i = 0; i < keys; ++i) {
+    EWCKeySoundSample sample;
+    EWCKeySoundSampleDecodeWav(files[keySounds[i]], lengths[keySounds[i]], &sample);
+    decodeSum += sample.frames[sample.frameCount / 2];
+    EWCKeySoundSampleFree(&sample);
+  }
+  double decodeTime = EWCVoiceBenchNow() - start;
+
+  // the pool only posts a request on the tap path
+  static EWCKeyVoicePool pool;
+  EWCKeyVoicePoolInit(&pool, sounds, EWCVoiceBenchSoundCount);
+  start = EWCVoiceBenchNow();
+  for (long i = 0; i < keys; ++i) {
+    EWCKeyVoicePoolTrigger(&pool, keySounds[i], 0.8f);
+
+    // drain the ring now and then, as the audio thread would
+    if ((i & 7) == 7) {
+      atomic_store(&pool.triggerTail, atomic_load(&pool.triggerHead));
+    }
+  }
+  double triggerTime = EWCVoiceBenchNow() - start;
+
+  // play the key presses through the pool in time, a buffer at a time
+  EWCKeyVoicePoolInit(&pool, sounds, EWCVoiceBenchSoundCount);
+  float *buffer = malloc(sizeof(float) * 2 * (size_t)bufferFrames);
+  uint64_t frame = 0;
+  uint64_t nextKeyFrame = gaps[0];
+  long nextKey = 0;
+  long buffers = 0;
+  long audibleBuffers = 0;
+  int peakActive = 0;
+  double renderTime = 0;
+  double outputSum = 0;
+  while (nextKey < keys || EWCKeyVoicePoolActiveCount(&pool) > 0) {
+    // keys land at the start of the buffer after they are pressed
+    while (nextKey < keys && nextKeyFrame < frame + (uint64_t)bufferFrames) {
+      EWCKeyVoicePoolTrigger(&pool, keySounds[nextKey], 0.8f);
+      if (++nextKey < keys) {
+        nextKeyFrame += gaps[nextKey];
+      }
+    }
+
+    // the voices this buffer plays are those still going and those starting
+    int active = EWCKeyVoicePoolActiveCount(&pool)
+      + (int)(atomic_load(&pool.triggerHead) - atomic_load(&pool.triggerTail));
+    active = (active < EWCKeyVoicePoolVoiceCount) ? active : EWCKeyVoicePoolVoiceCount;
+    peakActive = (active > peakActive) ? active : peakActive;
+
+    start = EWCVoiceBenchNow();
+    if (EWCKeyVoicePoolRender(&pool, buffer, (uint32_t)bufferFrames)) {
+      ++audibleBuffers;
+      outputSum += buffer[0];
+    }
+    renderTime += EWCVoiceBenchNow() - start;
+
+    frame += (uint64_t)bufferFrames;
+    ++buffers;
+  }
+
+  double bufferSeconds = bufferFrames / samples[0].sampleRate;
+  printf("keys:       %ld at %.1f/s  sound frames: %u\n", keys, rate, samples[0].frameCount);
+  printf("decode/key: %.1f ns  (the old per key cost, at least)\n", decodeTime / keys * 1e9);
+  printf("trigger:    %.1f ns/key\n", triggerTime / keys * 1e9);
+  printf("render:     %.1f ns/buffer  (%.4f%% of the %.1f ms buffer)\n",
+    renderTime / buffers * 1e9, 100.0 * renderTime / buffers / bufferSeconds, bufferSeconds * 1e3);
+  printf("buffers:    %ld  audible: %ld  peak voices: %d\n", buffers, audibleBuffers, peakActive);
+  printf("started:    %llu  stolen: %llu  dropped: %llu\n",
+    (unsigned long long)pool.startedCount,
+    (unsigned long long)pool.stolenCount,
+    (unsigned long long)atomic_load(&pool.droppedCount));
+
+  // keep the sums alive, so that the work can't be skipped
+  if (decodeSum == outputSum * 1e300) {
+    printf("\n");
+  }
+
+  for (int i = 0; i < EWCVoiceBenchSoundCount; ++i) {
+    EWCKeySoundSampleFree(&samples[i]);
+    free(files[i]);
+  }
+  free(keySounds);
+  free(gaps);
+  free(buffer);
+
+  return (pool.startedCount != (uint64_t)keys) ? 1 : 0;
+}